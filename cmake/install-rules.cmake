@@ -33,9 +33,15 @@ set(
 
 mark_as_advanced(tomlplusplus_INSTALL_CMAKEDIR)
 
+configure_file(
+    "${PROJECT_SOURCE_DIR}/cmake/tomlplusplusConfig.cmake.in"
+    "${PROJECT_BINARY_DIR}/tomlplusplusConfig.cmake"
+    @ONLY
+)
+
 install(
     FILES
-    "${PROJECT_SOURCE_DIR}/cmake/tomlplusplusConfig.cmake"
+    "${PROJECT_BINARY_DIR}/tomlplusplusConfig.cmake"
     "${PROJECT_BINARY_DIR}/tomlplusplusConfigVersion.cmake"
     DESTINATION "${tomlplusplus_INSTALL_CMAKEDIR}"
     COMPONENT tomlplusplus_Development
@@ -1 +0,0 @@
-include(${CMAKE_CURRENT_LIST_DIR}/tomlplusplusTargets.cmake)
@@ -0,0 +1,115 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+// This example is a benchmark of parsing one large document on multiple threads (see toml::parse_options::threads).
+// It generates a document of about 32 MB made up of [[records]] sections and parses it with 1, 2, 4, 8 and (if
+// there are more) as many threads as the hardware has, reporting the throughput and the speedup over one thread.
+//
+// It then does the same with a copy of the document that can't be split up: it starts with a [late.b.c] header and
+// ends with a [late] table that adds to late.b with a dotted key. That's only noticed once every section has been
+// parsed, at which point the whole document gets parsed again on the calling thread, so it's slower with threads
+// than without them.
+//
+// Only numbers from a machine with a single hardware thread have been recorded so far, and they show the overhead
+// of the threads rather than any speedup (1 thread 2.13 s, 2-8 threads 1.94-2.08 s; with the late collision,
+// 1 thread 1.74 s and 2-8 threads 3.2-3.7 s). How well it scales still needs measuring on a machine with at least
+// 8 cores before parse_options::threads is recommended for anything.
+
+#ifndef TOML_ENABLE_THREADS
+#define TOML_ENABLE_THREADS 1
+#endif
+#include "examples.hpp"
+#include <toml++/toml.hpp>
+#include <thread>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace
+{
+	constexpr size_t target_bytes = 32u * 1024u * 1024u;
+	constexpr size_t iterations	  = 3u;
+
+	volatile size_t sink;
+
+	std::string make_document()
+	{
+		std::string doc = "title = \"parallel parse benchmark\"\n"s;
+		for (size_t i = 0; doc.length() < target_bytes; i++)
+		{
+			const auto n = std::to_string(i);
+			doc.append("\n[[records]]\nid = "sv).append(n);
+			doc.append("\nname = \"record "sv).append(n).append("\"\n"sv);
+			doc.append("tags = [ \"alpha\", \"beta\", \"gamma\" ]\n"sv);
+			doc.append("point = { x = "sv).append(n).append(", y = -"sv).append(n).append(", z = 0.5 }\n"sv);
+			doc.append("enabled = "sv).append(i % 2u ? "true"sv : "false"sv);
+			doc.append("\n\n[records.meta]\ncreated = 1979-05-27T07:32:00Z\nratio = 0."sv).append(n);
+			doc.append("\nnotes = '''\nlines that look like [headers]\n[[but.are.not]]\n'''\n"sv);
+		}
+		return doc;
+	}
+
+	// returns the best of a few runs, in seconds
+	double measure(const std::string& doc, size_t threads)
+	{
+		toml::parse_options options;
+		options.threads = threads;
+
+		double best = 0.0;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			{
+				auto tbl = toml::parse(doc, options);
+				sink	 = static_cast<toml::table&>(tbl).size();
+			}
+			const auto sec =
+				std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start)
+					.count();
+			if (!i || sec < best)
+				best = sec;
+		}
+		return best;
+	}
+
+	void run_benchmark(std::string_view name, const std::string& doc, const std::vector<size_t>& thread_counts)
+	{
+		const auto megabytes = static_cast<double>(doc.length()) / (1024.0 * 1024.0);
+		std::cout << name << " ("sv << megabytes << " MB):\n"sv;
+
+		double single = 0.0;
+		for (auto threads : thread_counts)
+		{
+			const auto sec = measure(doc, threads);
+			if (threads == 1u)
+				single = sec;
+
+			std::cout << "  "sv << threads << (threads == 1u ? " thread:  "sv : " threads: "sv) << sec << " s, "sv
+					  << megabytes / sec << " MB/s, "sv << single / sec << "x\n"sv;
+		}
+	}
+}
+
+int main()
+{
+	std::vector<size_t> thread_counts{ 1u, 2u, 4u, 8u };
+	const size_t hardware_threads = std::thread::hardware_concurrency();
+	if (hardware_threads > thread_counts.back())
+		thread_counts.push_back(hardware_threads);
+	std::cout << "Hardware threads: "sv << hardware_threads << "\n"sv;
+	if (hardware_threads < 8u)
+		std::cout << "(fewer than 8, so this measures the overhead of the threads more than how well they scale)\n"sv;
+	std::cout << "\n"sv;
+
+	const auto doc = make_document();
+	run_benchmark("Generated document"sv, doc, thread_counts);
+
+	std::cout << "\n"sv;
+	run_benchmark("Generated document with a late collision"sv,
+				  "[late.b.c]\nx = 1\n\n"s + doc + "\n[late]\nb.d = 2\n"s,
+				  thread_counts);
+
+	return 0;
+}
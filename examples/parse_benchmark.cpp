@@ -4,33 +4,117 @@
 // SPDX-License-Identifier: MIT
 
 // This example is just a short-n-shiny benchmark.
+// By default it runs over three corpora: benchmark_data.toml (mostly ASCII), benchmark_data_unicode.toml
+// (localized strings, about half of it multi-byte UTF-8), and a much larger generated document.
+//
+// Each is parsed into a toml::table (with and without an arena, if TOML_ENABLE_ARENA is set), through a
+// toml::sax_handler (which builds nothing), into a toml::lazy_document that then has one value looked up, and into a
+// toml::table with toml::parse_options that keep just that one value. The timings include destroying whatever was
+// parsed, and the number of heap allocations per parse is reported alongside them.
 
 #include "examples.hpp"
 #include <toml++/toml.hpp>
+#include <new>
 
 using namespace std::string_view_literals;
 
-static constexpr size_t iterations = 10000;
+static size_t allocations = 0;
 
-int main(int argc, char** argv)
+// (gcc mistakes the std::free() calls below for frees of memory from the default operator new)
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+	allocations++;
+	if (void* ptr = std::malloc(size ? size : 1u))
+		return ptr;
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
 {
-	const auto file_path = std::string(argc > 1 ? std::string_view{ argv[1] } : "benchmark_data.toml"sv);
+	std::free(ptr);
+}
 
-	// read the file into a string first to remove file I/O from the benchmark
-	std::string file_content;
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace
+{
+	// counts events so the optimizer can't throw any of the work away
+	struct event_counter final : toml::sax_handler
+	{
+		size_t events = 0;
+
+		void on_table_header(const toml::key*, size_t, bool) override
+		{
+			events++;
+		}
+
+		void on_key(const toml::key*, size_t) override
+		{
+			events++;
+		}
+
+		void on_value(const toml::node&) override
+		{
+			events++;
+		}
+	};
+
+	template <typename Func>
+	void measure(std::string_view name, size_t iterations, Func&& func)
+	{
+		const auto start_allocations = allocations;
+		const auto start			 = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+			func();
+		const auto cumulative_sec =
+			std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "  "sv << name << ":\n"sv
+				  << "           total: "sv << cumulative_sec << " s\n"sv
+				  << "            mean: "sv << cumulative_sec / static_cast<double>(iterations) << " s\n"sv
+				  << "    allocs/parse: "sv << (allocations - start_allocations) / iterations << "\n"sv;
+	}
+
+	// a big synthetic document with a bit of everything in it
+	std::string make_large_corpus(size_t records)
+	{
+		std::string doc = "title = \"generated\"\n";
+		for (size_t i = 0; i < records; i++)
+		{
+			const auto n = std::to_string(i);
+			doc += "\n[[records]]\nid = " + n + "\nname = \"record #" + n + "\"\nscore = " + n + ".25\n";
+			doc += i % 2u ? "enabled = true\n"sv : "enabled = false\n"sv;
+			doc += "tags = [ \"alpha\", \"beta\", \"gamma\" ]\nmatrix = [ [ 1, 2 ], [ 3, 4 ] ]\n";
+			doc += "point = { x = " + n + ", y = -" + n + ", label = \"p" + n + "\" }\n";
+			doc += "created = 1979-05-27T07:32:00Z\n";
+			doc += "description = \"\"\"\na longer, multi-line string\nthat needs a heap allocation of its own\"\"\"\n";
+			doc += "[records.meta]\nowner.name = \"someone\"\nowner.id = 0x" + n + "\n";
+		}
+		return doc;
+	}
+
+	// reads the file into a string first to remove file I/O from the benchmark
+	bool read_file(const std::string& file_path, std::string& file_content)
 	{
 		std::ifstream file(file_path, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
 		if (!file)
 		{
 			std::cerr << "File '"sv << file_path << "'could not be opened for reading\n"sv;
-			return -1;
+			return false;
 		}
 
 		const auto file_size = file.tellg();
 		if (file_size == -1)
 		{
 			std::cerr << "File '"sv << file_path << "' could not be opened for reading\n"sv;
-			return -1;
+			return false;
 		}
 		file.seekg(0, std::ifstream::beg);
 
@@ -39,10 +123,14 @@ int main(int argc, char** argv)
 		if (!file.eof() && !file)
 		{
 			std::cerr << "Failed to read contents of file '"sv << file_path << "'\n"sv;
-			return -1;
+			return false;
 		}
+		return true;
 	}
+}
 
+static int run_benchmark(const std::string& file_path, const std::string& file_content, size_t iterations)
+{
 	// parse once to make sure it isn't garbage
 	{
 #if TOML_EXCEPTIONS
@@ -68,14 +156,77 @@ int main(int argc, char** argv)
 	// run the benchmark
 	std::cout << "Parsing '"sv << file_path << "' "sv << iterations << " times...\n"sv;
 
-	const auto start = std::chrono::steady_clock::now();
-	for (size_t i = 0; i < iterations; i++)
-		std::ignore = toml::parse(file_content, file_path);
-	const auto cumulative_sec =
-		std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count();
-	const auto mean_sec = cumulative_sec / static_cast<double>(iterations);
-	std::cout << "  total: "sv << cumulative_sec << " s\n"sv
-			  << "   mean: "sv << mean_sec << " s\n"sv;
+	measure("toml::parse()"sv, iterations, [&]() { std::ignore = toml::parse(file_content, file_path); });
+
+#if TOML_ENABLE_ARENA
+	toml::parse_options arena_options;
+	arena_options.use_arena = true;
+	measure("toml::parse() with an arena"sv,
+			iterations,
+			[&]() { std::ignore = toml::parse(file_content, arena_options, file_path); });
+#endif
+
+	event_counter counter;
+	measure("toml::parse() with a toml::sax_handler"sv,
+			iterations,
+			[&]() { static_cast<void>(toml::parse(file_content, counter, file_path)); });
+
+	// (looks up the last leaf value in the document)
+	std::string last_value;
+	{
+		const auto tbl		  = toml::parse(file_content, file_path);
+		const toml::node* nde = &static_cast<const toml::node&>(tbl);
+		while (true)
+		{
+			if (auto child_tbl = nde->as_table(); child_tbl && !child_tbl->empty())
+			{
+				last_value.append(last_value.empty() ? ""sv : "."sv).append(std::prev(child_tbl->end())->first.str());
+				nde = &std::prev(child_tbl->end())->second;
+			}
+			else if (auto child_arr = nde->as_array(); child_arr && !child_arr->empty())
+			{
+				last_value.append("["sv).append(std::to_string(child_arr->size() - 1u)).append("]"sv);
+				nde = &child_arr->back();
+			}
+			else
+				break;
+		}
+	}
+	measure("toml::lazy_document with one lookup"sv,
+			iterations,
+			[&]()
+			{
+				toml::lazy_document doc{ file_content, file_path };
+				static_cast<void>(doc.at_path(last_value));
+			});
+
+	toml::parse_options options;
+	options.keep_paths.emplace_back(last_value);
+	measure("toml::parse() keeping just that value"sv,
+			iterations,
+			[&]() { std::ignore = toml::parse(file_content, options, file_path); });
 
 	return 0;
 }
+
+int main(int argc, char** argv)
+{
+	std::string file_content;
+	if (argc > 1)
+	{
+		if (!read_file(argv[1], file_content))
+			return -1;
+		return run_benchmark(argv[1], file_content, 10000u);
+	}
+
+	for (auto file_path : { "benchmark_data.toml"sv, "benchmark_data_unicode.toml"sv })
+	{
+		if (!read_file(std::string(file_path), file_content))
+			return -1;
+		if (const auto ret = run_benchmark(std::string(file_path), file_content, 10000u))
+			return ret;
+	}
+
+	// (about 100x the size of the others)
+	return run_benchmark("<generated>", make_large_corpus(5000u), 100u);
+}
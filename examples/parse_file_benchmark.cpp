@@ -0,0 +1,125 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+// This example benchmarks the different ways of getting a TOML file from disk into the parser:
+//  - toml::parse_file() (memory-mapped when TOML_ENABLE_MMAP is enabled)
+//  - toml::parse() with a std::ifstream
+//  - reading the file into a std::string and calling toml::parse() on that
+//
+// Each is measured with a warm page cache and (on Linux) a cold one. Pass a large file to see
+// the difference; the toml_generator example is handy for making one.
+
+#include "examples.hpp"
+#include <toml++/toml.hpp>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std::string_view_literals;
+
+namespace
+{
+	bool evict_from_page_cache([[maybe_unused]] const std::string& file_path)
+	{
+#ifdef __linux__
+		const int fd = open(file_path.c_str(), O_RDONLY);
+		if (fd == -1)
+			return false;
+		fsync(fd);
+		const bool ok = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+		close(fd);
+		return ok;
+#else
+		return false;
+#endif
+	}
+
+	toml::parse_result parse_with_ifstream(const std::string& file_path)
+	{
+		std::ifstream file(file_path, std::ifstream::in | std::ifstream::binary);
+		return toml::parse(file, file_path);
+	}
+
+	toml::parse_result parse_with_string(const std::string& file_path)
+	{
+		std::ifstream file(file_path, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+		std::string file_content;
+		file_content.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0, std::ifstream::beg);
+		file.read(file_content.data(), static_cast<std::streamsize>(file_content.size()));
+		return toml::parse(file_content, file_path);
+	}
+
+	toml::parse_result parse_with_parse_file(const std::string& file_path)
+	{
+		return toml::parse_file(file_path);
+	}
+
+	template <typename Func>
+	void run(std::string_view name, Func&& func, const std::string& file_path, size_t iterations, bool cold)
+	{
+		double cumulative_sec = 0.0;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			if (cold)
+				evict_from_page_cache(file_path);
+
+			const auto start = std::chrono::steady_clock::now();
+			std::ignore		 = func(file_path);
+			cumulative_sec +=
+				std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start)
+					.count();
+		}
+		std::cout << "  "sv << name << (cold ? " (cold): "sv : " (warm): "sv)
+				  << (cumulative_sec / static_cast<double>(iterations)) << " s\n"sv;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const auto file_path  = std::string(argc > 1 ? std::string_view{ argv[1] } : "benchmark_data.toml"sv);
+	const auto iterations = argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : size_t{ 100 };
+
+	// parse once to make sure it isn't garbage (and to warm the page cache)
+	{
+#if TOML_EXCEPTIONS
+		try
+		{
+			const auto result = toml::parse_file(file_path);
+		}
+		catch (const toml::parse_error& err)
+		{
+			std::cerr << err << "\n";
+			return 1;
+		}
+#else
+		const auto result = toml::parse_file(file_path);
+		if (!result)
+		{
+			std::cerr << result.error() << "\n";
+			return 1;
+		}
+#endif
+	}
+
+	std::cout << "Parsing '"sv << file_path << "' "sv << iterations << " times...\n"sv;
+
+	run("parse_file          "sv, parse_with_parse_file, file_path, iterations, false);
+	run("parse(std::ifstream)"sv, parse_with_ifstream, file_path, iterations, false);
+	run("parse(std::string)  "sv, parse_with_string, file_path, iterations, false);
+
+	if (!evict_from_page_cache(file_path))
+	{
+		std::cout << "(cold-cache runs are not supported on this platform)\n"sv;
+		return 0;
+	}
+
+	run("parse_file          "sv, parse_with_parse_file, file_path, iterations, true);
+	run("parse(std::ifstream)"sv, parse_with_ifstream, file_path, iterations, true);
+	run("parse(std::string)  "sv, parse_with_string, file_path, iterations, true);
+
+	return 0;
+}
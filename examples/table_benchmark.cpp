@@ -0,0 +1,119 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+// This example is a benchmark of toml::table's storage. It builds tables of 4, 64, 4096 and 1048576 integer values,
+// then looks every key up (in a random order) and iterates over them. Build it with and without TOML_FLAT_TABLES
+// to compare the two (the meson build does both; see table_benchmark_flat).
+//
+// Tables are built with their keys inserted in order, as they would be from a sorted document, and (for the
+// smaller ones) in a random order.
+
+#include "examples.hpp"
+#include <toml++/toml.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+	// takes at least this many operations for each measurement so the small tables aren't all noise
+	constexpr size_t min_operations = 4000000u;
+
+	// (building a flat table in a random order is quadratic)
+	constexpr size_t max_random_build_size = 4096u;
+
+	volatile int64_t sink;
+
+	template <typename Func>
+	void measure(std::string_view name, size_t size, Func&& func)
+	{
+		const size_t iterations = (std::max)(min_operations / size, size_t{ 1 });
+
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+			func();
+		const auto cumulative_ns =
+			std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(std::chrono::steady_clock::now() - start)
+				.count();
+
+		std::cout << "    "sv << name << ": "sv << cumulative_ns / static_cast<double>(iterations * size)
+				  << " ns per key\n"sv;
+	}
+
+	void run_benchmark(size_t size)
+	{
+		std::vector<std::string> keys;
+		keys.reserve(size);
+		for (size_t i = 0; i < size; i++)
+		{
+			auto n = std::to_string(i);
+			keys.push_back("key_" + std::string(7u - (std::min)(n.length(), size_t{ 7 }), '0') + n);
+		}
+
+		std::vector<std::string> shuffled_keys = keys;
+		std::shuffle(shuffled_keys.begin(), shuffled_keys.end(), std::mt19937{ 42u });
+
+		std::cout << "  "sv << size << " keys:\n"sv;
+
+		measure("build (in order)"sv,
+				size,
+				[&]()
+				{
+					toml::table tbl;
+					for (size_t i = 0; i < size; i++)
+						tbl.insert(keys[i], static_cast<int64_t>(i));
+					sink = static_cast<int64_t>(tbl.size());
+				});
+
+		if (size <= max_random_build_size)
+		{
+			measure("build (random order)"sv,
+					size,
+					[&]()
+					{
+						toml::table tbl;
+						for (size_t i = 0; i < size; i++)
+							tbl.insert(shuffled_keys[i], static_cast<int64_t>(i));
+						sink = static_cast<int64_t>(tbl.size());
+					});
+		}
+
+		toml::table tbl;
+		for (size_t i = 0; i < size; i++)
+			tbl.insert(keys[i], static_cast<int64_t>(i));
+
+		measure("lookup"sv,
+				size,
+				[&]()
+				{
+					int64_t sum = {};
+					for (const auto& key : shuffled_keys)
+						sum += tbl.get(key)->ref<int64_t>();
+					sink = sum;
+				});
+
+		measure("iteration"sv,
+				size,
+				[&]()
+				{
+					int64_t sum = {};
+					for (auto&& [key, value] : tbl)
+						sum += static_cast<int64_t>(key.str().length()) + value.ref<int64_t>();
+					sink = sum;
+				});
+	}
+}
+
+int main()
+{
+	std::cout << "Tables stored in "sv << (TOML_FLAT_TABLES ? "sorted vectors"sv : "std::maps"sv)
+			  << " (TOML_FLAT_TABLES = "sv << TOML_FLAT_TABLES << "):\n"sv;
+
+	for (size_t size : { 4u, 64u, 4096u, 1048576u })
+		run_benchmark(size);
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+// This example is a benchmark of the parser's bookkeeping for tables it has to revisit. It generates documents with
+// 1000, 10000 and 100000 sibling subtables that are each visited twice:
+//
+// - implicit tables: every [parent.tN.child] header, then every [parent.tN] header (defining the implicit tables);
+// - dotted keys: every tN.a = 1 key-value pair, then every tN.b = 2 (extending the dotted key tables);
+// - table arrays: every [[parent.tN]] header, twice (appending to the table arrays).
+//
+// The time per subtable should stay (roughly) the same as the documents get bigger.
+
+#include "examples.hpp"
+#include <toml++/toml.hpp>
+
+using namespace std::string_view_literals;
+
+namespace
+{
+	// takes at least this many subtables' worth of parsing for each measurement so the small documents aren't all noise
+	constexpr size_t min_subtables = 400000u;
+
+	volatile size_t sink;
+
+	void measure(std::string_view name, size_t subtables, const std::string& doc)
+	{
+		const size_t iterations = min_subtables / subtables > 1u ? min_subtables / subtables : 1u;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+		{
+			auto tbl = toml::parse(doc);
+			sink	 = static_cast<toml::table&>(tbl).size();
+		}
+		const auto cumulative_ns =
+			std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(std::chrono::steady_clock::now() - start)
+				.count();
+
+		std::cout << "    "sv << name << ": "sv << cumulative_ns / static_cast<double>(iterations * subtables)
+				  << " ns per subtable\n"sv;
+	}
+
+	void run_benchmark(size_t subtables)
+	{
+		std::cout << "  "sv << subtables << " subtables:\n"sv;
+
+		std::string doc;
+		for (size_t i = 0; i < subtables; i++)
+			doc.append("[parent.t"sv).append(std::to_string(i)).append(".child]\n"sv);
+		for (size_t i = 0; i < subtables; i++)
+			doc.append("[parent.t"sv).append(std::to_string(i)).append("]\n"sv);
+		measure("implicit tables"sv, subtables, doc);
+
+		doc = "[parent]\n"sv;
+		for (size_t i = 0; i < subtables; i++)
+			doc.append("t"sv).append(std::to_string(i)).append(".a = 1\n"sv);
+		for (size_t i = 0; i < subtables; i++)
+			doc.append("t"sv).append(std::to_string(i)).append(".b = 2\n"sv);
+		measure("dotted keys"sv, subtables, doc);
+
+		doc.clear();
+		for (size_t i = 0; i < subtables * 2u; i++)
+			doc.append("[[parent.t"sv).append(std::to_string(i % subtables)).append("]]\n"sv);
+		measure("table arrays"sv, subtables, doc);
+	}
+}
+
+int main()
+{
+	std::cout << "Parsing sibling subtables that are each visited twice:\n"sv;
+
+	for (size_t subtables : { 1000u, 10000u, 100000u })
+		run_benchmark(subtables);
+
+	return 0;
+}
@@ -34,6 +34,8 @@
 /// \cond
 TOML_IMPL_NAMESPACE_START
 {
+	using array_vector = std::vector<node_ptr, node_allocator<node_ptr>>;
+
 	template <bool IsConst>
 	class TOML_TRIVIAL_ABI array_iterator
 	{
@@ -41,8 +43,8 @@ TOML_IMPL_NAMESPACE_START
 		template <bool>
 		friend class array_iterator;
 
-		using mutable_vector_iterator = std::vector<node_ptr>::iterator;
-		using const_vector_iterator	  = std::vector<node_ptr>::const_iterator;
+		using mutable_vector_iterator = array_vector::iterator;
+		using const_vector_iterator	  = array_vector::const_iterator;
 		using vector_iterator		  = std::conditional_t<IsConst, const_vector_iterator, mutable_vector_iterator>;
 
 		mutable vector_iterator iter_;
@@ -231,6 +233,9 @@ TOML_NAMESPACE_START
 	/// \brief A RandomAccessIterator for iterating over const elements in a toml::array.
 	using const_array_iterator = POXY_IMPLEMENTATION_DETAIL(impl::array_iterator<true>);
 
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenaarr, heaparr);
+
 	/// \brief	A TOML array.
 	///
 	/// \detail The interface of this type is modeled after std::vector, with some
@@ -286,7 +291,7 @@ TOML_NAMESPACE_START
 	  private:
 		/// \cond
 
-		using vector_type			= std::vector<impl::node_ptr>;
+		using vector_type			= impl::array_vector;
 		using vector_iterator		= typename vector_type::iterator;
 		using const_vector_iterator = typename vector_type::const_iterator;
 		vector_type elems_;
@@ -1787,6 +1792,9 @@ TOML_NAMESPACE_START
 
 #endif
 	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_ARENA
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
 }
 TOML_NAMESPACE_END;
 
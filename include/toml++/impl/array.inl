@@ -27,6 +27,13 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	array::~array() noexcept
 	{
+#if TOML_ENABLE_ARENA
+		{
+			const impl::node_free_batch batch;
+			const auto contents = std::move(elems_);
+		}
+#endif
+
 #if TOML_LIFETIME_HOOKS
 		TOML_ARRAY_DESTROYED;
 #endif
@@ -106,6 +113,9 @@ TOML_NAMESPACE_START
 		if (&rhs != this)
 		{
 			node::operator=(std::move(rhs));
+#if TOML_ENABLE_ARENA
+			const impl::node_free_batch batch;
+#endif
 			elems_ = std::move(rhs.elems_);
 		}
 		return *this;
@@ -350,6 +360,9 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	void array::clear() noexcept
 	{
+#if TOML_ENABLE_ARENA
+		const impl::node_free_batch batch;
+#endif
 		elems_.clear();
 	}
 
@@ -0,0 +1,888 @@
+//# This file is a part of toml++ and is subject to the the terms of the MIT license.
+//# Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+//# See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+//# {{
+#include "preprocessor.hpp"
+#if !TOML_IMPLEMENTATION
+#error This is an implementation-only header.
+#endif
+//# }}
+#if TOML_ENABLE_PARSER
+
+#include "forward_declarations.hpp"
+TOML_DISABLE_WARNINGS;
+#include <cfloat>
+#include <cstring>
+#if TOML_MSVC && TOML_ARCH_AMD64
+#include <intrin.h>
+#endif
+TOML_ENABLE_WARNINGS;
+#include "header_start.hpp"
+
+// decimal -> double conversion using the Eisel-Lemire algorithm (https://arxiv.org/abs/2101.11408), as popularized by
+// fast_float. it's exact for everything with 19 or fewer significant digits, save for a handful of inputs it can't
+// decide (halfway cases outside the exactly-representable range, subnormals, overflow), which are handed back to the
+// caller to convert the slow way.
+
+TOML_ANON_NAMESPACE_START
+{
+	// the 128 most significant bits of 5^q for q in [-342, 308], normalized so the top bit is set (and rounded up for
+	// negative q). generated with:
+	//
+	//	for q in range(-342, 0):
+	//		z = (5 ** -q).bit_length()
+	//		c = 2 ** ((z + 127) if q >= -27 else (2 * z + 128)) // 5 ** -q + 1
+	//		while c >= 1 << 128: c //= 2
+	//	for q in range(0, 309):
+	//		c = 5 ** q
+	//		while c < 1 << 127: c *= 2
+	//		while c >= 1 << 128: c //= 2
+	TOML_INTERNAL_LINKAGE
+	constexpr uint64_t powers_of_five[651][2] = {
+		{ 0xEEF453D6923BD65Au, 0x113FAA2906A13B3Fu },
+		{ 0x9558B4661B6565F8u, 0x4AC7CA59A424C507u },
+		{ 0xBAAEE17FA23EBF76u, 0x5D79BCF00D2DF649u },
+		{ 0xE95A99DF8ACE6F53u, 0xF4D82C2C107973DCu },
+		{ 0x91D8A02BB6C10594u, 0x79071B9B8A4BE869u },
+		{ 0xB64EC836A47146F9u, 0x9748E2826CDEE284u },
+		{ 0xE3E27A444D8D98B7u, 0xFD1B1B2308169B25u },
+		{ 0x8E6D8C6AB0787F72u, 0xFE30F0F5E50E20F7u },
+		{ 0xB208EF855C969F4Fu, 0xBDBD2D335E51A935u },
+		{ 0xDE8B2B66B3BC4723u, 0xAD2C788035E61382u },
+		{ 0x8B16FB203055AC76u, 0x4C3BCB5021AFCC31u },
+		{ 0xADDCB9E83C6B1793u, 0xDF4ABE242A1BBF3Du },
+		{ 0xD953E8624B85DD78u, 0xD71D6DAD34A2AF0Du },
+		{ 0x87D4713D6F33AA6Bu, 0x8672648C40E5AD68u },
+		{ 0xA9C98D8CCB009506u, 0x680EFDAF511F18C2u },
+		{ 0xD43BF0EFFDC0BA48u, 0x0212BD1B2566DEF2u },
+		{ 0x84A57695FE98746Du, 0x014BB630F7604B57u },
+		{ 0xA5CED43B7E3E9188u, 0x419EA3BD35385E2Du },
+		{ 0xCF42894A5DCE35EAu, 0x52064CAC828675B9u },
+		{ 0x818995CE7AA0E1B2u, 0x7343EFEBD1940993u },
+		{ 0xA1EBFB4219491A1Fu, 0x1014EBE6C5F90BF8u },
+		{ 0xCA66FA129F9B60A6u, 0xD41A26E077774EF6u },
+		{ 0xFD00B897478238D0u, 0x8920B098955522B4u },
+		{ 0x9E20735E8CB16382u, 0x55B46E5F5D5535B0u },
+		{ 0xC5A890362FDDBC62u, 0xEB2189F734AA831Du },
+		{ 0xF712B443BBD52B7Bu, 0xA5E9EC7501D523E4u },
+		{ 0x9A6BB0AA55653B2Du, 0x47B233C92125366Eu },
+		{ 0xC1069CD4EABE89F8u, 0x999EC0BB696E840Au },
+		{ 0xF148440A256E2C76u, 0xC00670EA43CA250Du },
+		{ 0x96CD2A865764DBCAu, 0x380406926A5E5728u },
+		{ 0xBC807527ED3E12BCu, 0xC605083704F5ECF2u },
+		{ 0xEBA09271E88D976Bu, 0xF7864A44C633682Eu },
+		{ 0x93445B8731587EA3u, 0x7AB3EE6AFBE0211Du },
+		{ 0xB8157268FDAE9E4Cu, 0x5960EA05BAD82964u },
+		{ 0xE61ACF033D1A45DFu, 0x6FB92487298E33BDu },
+		{ 0x8FD0C16206306BABu, 0xA5D3B6D479F8E056u },
+		{ 0xB3C4F1BA87BC8696u, 0x8F48A4899877186Cu },
+		{ 0xE0B62E2929ABA83Cu, 0x331ACDABFE94DE87u },
+		{ 0x8C71DCD9BA0B4925u, 0x9FF0C08B7F1D0B14u },
+		{ 0xAF8E5410288E1B6Fu, 0x07ECF0AE5EE44DD9u },
+		{ 0xDB71E91432B1A24Au, 0xC9E82CD9F69D6150u },
+		{ 0x892731AC9FAF056Eu, 0xBE311C083A225CD2u },
+		{ 0xAB70FE17C79AC6CAu, 0x6DBD630A48AAF406u },
+		{ 0xD64D3D9DB981787Du, 0x092CBBCCDAD5B108u },
+		{ 0x85F0468293F0EB4Eu, 0x25BBF56008C58EA5u },
+		{ 0xA76C582338ED2621u, 0xAF2AF2B80AF6F24Eu },
+		{ 0xD1476E2C07286FAAu, 0x1AF5AF660DB4AEE1u },
+		{ 0x82CCA4DB847945CAu, 0x50D98D9FC890ED4Du },
+		{ 0xA37FCE126597973Cu, 0xE50FF107BAB528A0u },
+		{ 0xCC5FC196FEFD7D0Cu, 0x1E53ED49A96272C8u },
+		{ 0xFF77B1FCBEBCDC4Fu, 0x25E8E89C13BB0F7Au },
+		{ 0x9FAACF3DF73609B1u, 0x77B191618C54E9ACu },
+		{ 0xC795830D75038C1Du, 0xD59DF5B9EF6A2417u },
+		{ 0xF97AE3D0D2446F25u, 0x4B0573286B44AD1Du },
+		{ 0x9BECCE62836AC577u, 0x4EE367F9430AEC32u },
+		{ 0xC2E801FB244576D5u, 0x229C41F793CDA73Fu },
+		{ 0xF3A20279ED56D48Au, 0x6B43527578C1110Fu },
+		{ 0x9845418C345644D6u, 0x830A13896B78AAA9u },
+		{ 0xBE5691EF416BD60Cu, 0x23CC986BC656D553u },
+		{ 0xEDEC366B11C6CB8Fu, 0x2CBFBE86B7EC8AA8u },
+		{ 0x94B3A202EB1C3F39u, 0x7BF7D71432F3D6A9u },
+		{ 0xB9E08A83A5E34F07u, 0xDAF5CCD93FB0CC53u },
+		{ 0xE858AD248F5C22C9u, 0xD1B3400F8F9CFF68u },
+		{ 0x91376C36D99995BEu, 0x23100809B9C21FA1u },
+		{ 0xB58547448FFFFB2Du, 0xABD40A0C2832A78Au },
+		{ 0xE2E69915B3FFF9F9u, 0x16C90C8F323F516Cu },
+		{ 0x8DD01FAD907FFC3Bu, 0xAE3DA7D97F6792E3u },
+		{ 0xB1442798F49FFB4Au, 0x99CD11CFDF41779Cu },
+		{ 0xDD95317F31C7FA1Du, 0x40405643D711D583u },
+		{ 0x8A7D3EEF7F1CFC52u, 0x482835EA666B2572u },
+		{ 0xAD1C8EAB5EE43B66u, 0xDA3243650005EECFu },
+		{ 0xD863B256369D4A40u, 0x90BED43E40076A82u },
+		{ 0x873E4F75E2224E68u, 0x5A7744A6E804A291u },
+		{ 0xA90DE3535AAAE202u, 0x711515D0A205CB36u },
+		{ 0xD3515C2831559A83u, 0x0D5A5B44CA873E03u },
+		{ 0x8412D9991ED58091u, 0xE858790AFE9486C2u },
+		{ 0xA5178FFF668AE0B6u, 0x626E974DBE39A872u },
+		{ 0xCE5D73FF402D98E3u, 0xFB0A3D212DC8128Fu },
+		{ 0x80FA687F881C7F8Eu, 0x7CE66634BC9D0B99u },
+		{ 0xA139029F6A239F72u, 0x1C1FFFC1EBC44E80u },
+		{ 0xC987434744AC874Eu, 0xA327FFB266B56220u },
+		{ 0xFBE9141915D7A922u, 0x4BF1FF9F0062BAA8u },
+		{ 0x9D71AC8FADA6C9B5u, 0x6F773FC3603DB4A9u },
+		{ 0xC4CE17B399107C22u, 0xCB550FB4384D21D3u },
+		{ 0xF6019DA07F549B2Bu, 0x7E2A53A146606A48u },
+		{ 0x99C102844F94E0FBu, 0x2EDA7444CBFC426Du },
+		{ 0xC0314325637A1939u, 0xFA911155FEFB5308u },
+		{ 0xF03D93EEBC589F88u, 0x793555AB7EBA27CAu },
+		{ 0x96267C7535B763B5u, 0x4BC1558B2F3458DEu },
+		{ 0xBBB01B9283253CA2u, 0x9EB1AAEDFB016F16u },
+		{ 0xEA9C227723EE8BCBu, 0x465E15A979C1CADCu },
+		{ 0x92A1958A7675175Fu, 0x0BFACD89EC191EC9u },
+		{ 0xB749FAED14125D36u, 0xCEF980EC671F667Bu },
+		{ 0xE51C79A85916F484u, 0x82B7E12780E7401Au },
+		{ 0x8F31CC0937AE58D2u, 0xD1B2ECB8B0908810u },
+		{ 0xB2FE3F0B8599EF07u, 0x861FA7E6DCB4AA15u },
+		{ 0xDFBDCECE67006AC9u, 0x67A791E093E1D49Au },
+		{ 0x8BD6A141006042BDu, 0xE0C8BB2C5C6D24E0u },
+		{ 0xAECC49914078536Du, 0x58FAE9F773886E18u },
+		{ 0xDA7F5BF590966848u, 0xAF39A475506A899Eu },
+		{ 0x888F99797A5E012Du, 0x6D8406C952429603u },
+		{ 0xAAB37FD7D8F58178u, 0xC8E5087BA6D33B83u },
+		{ 0xD5605FCDCF32E1D6u, 0xFB1E4A9A90880A64u },
+		{ 0x855C3BE0A17FCD26u, 0x5CF2EEA09A55067Fu },
+		{ 0xA6B34AD8C9DFC06Fu, 0xF42FAA48C0EA481Eu },
+		{ 0xD0601D8EFC57B08Bu, 0xF13B94DAF124DA26u },
+		{ 0x823C12795DB6CE57u, 0x76C53D08D6B70858u },
+		{ 0xA2CB1717B52481EDu, 0x54768C4B0C64CA6Eu },
+		{ 0xCB7DDCDDA26DA268u, 0xA9942F5DCF7DFD09u },
+		{ 0xFE5D54150B090B02u, 0xD3F93B35435D7C4Cu },
+		{ 0x9EFA548D26E5A6E1u, 0xC47BC5014A1A6DAFu },
+		{ 0xC6B8E9B0709F109Au, 0x359AB6419CA1091Bu },
+		{ 0xF867241C8CC6D4C0u, 0xC30163D203C94B62u },
+		{ 0x9B407691D7FC44F8u, 0x79E0DE63425DCF1Du },
+		{ 0xC21094364DFB5636u, 0x985915FC12F542E4u },
+		{ 0xF294B943E17A2BC4u, 0x3E6F5B7B17B2939Du },
+		{ 0x979CF3CA6CEC5B5Au, 0xA705992CEECF9C42u },
+		{ 0xBD8430BD08277231u, 0x50C6FF782A838353u },
+		{ 0xECE53CEC4A314EBDu, 0xA4F8BF5635246428u },
+		{ 0x940F4613AE5ED136u, 0x871B7795E136BE99u },
+		{ 0xB913179899F68584u, 0x28E2557B59846E3Fu },
+		{ 0xE757DD7EC07426E5u, 0x331AEADA2FE589CFu },
+		{ 0x9096EA6F3848984Fu, 0x3FF0D2C85DEF7621u },
+		{ 0xB4BCA50B065ABE63u, 0x0FED077A756B53A9u },
+		{ 0xE1EBCE4DC7F16DFBu, 0xD3E8495912C62894u },
+		{ 0x8D3360F09CF6E4BDu, 0x64712DD7ABBBD95Cu },
+		{ 0xB080392CC4349DECu, 0xBD8D794D96AACFB3u },
+		{ 0xDCA04777F541C567u, 0xECF0D7A0FC5583A0u },
+		{ 0x89E42CAAF9491B60u, 0xF41686C49DB57244u },
+		{ 0xAC5D37D5B79B6239u, 0x311C2875C522CED5u },
+		{ 0xD77485CB25823AC7u, 0x7D633293366B828Bu },
+		{ 0x86A8D39EF77164BCu, 0xAE5DFF9C02033197u },
+		{ 0xA8530886B54DBDEBu, 0xD9F57F830283FDFCu },
+		{ 0xD267CAA862A12D66u, 0xD072DF63C324FD7Bu },
+		{ 0x8380DEA93DA4BC60u, 0x4247CB9E59F71E6Du },
+		{ 0xA46116538D0DEB78u, 0x52D9BE85F074E608u },
+		{ 0xCD795BE870516656u, 0x67902E276C921F8Bu },
+		{ 0x806BD9714632DFF6u, 0x00BA1CD8A3DB53B6u },
+		{ 0xA086CFCD97BF97F3u, 0x80E8A40ECCD228A4u },
+		{ 0xC8A883C0FDAF7DF0u, 0x6122CD128006B2CDu },
+		{ 0xFAD2A4B13D1B5D6Cu, 0x796B805720085F81u },
+		{ 0x9CC3A6EEC6311A63u, 0xCBE3303674053BB0u },
+		{ 0xC3F490AA77BD60FCu, 0xBEDBFC4411068A9Cu },
+		{ 0xF4F1B4D515ACB93Bu, 0xEE92FB5515482D44u },
+		{ 0x991711052D8BF3C5u, 0x751BDD152D4D1C4Au },
+		{ 0xBF5CD54678EEF0B6u, 0xD262D45A78A0635Du },
+		{ 0xEF340A98172AACE4u, 0x86FB897116C87C34u },
+		{ 0x9580869F0E7AAC0Eu, 0xD45D35E6AE3D4DA0u },
+		{ 0xBAE0A846D2195712u, 0x8974836059CCA109u },
+		{ 0xE998D258869FACD7u, 0x2BD1A438703FC94Bu },
+		{ 0x91FF83775423CC06u, 0x7B6306A34627DDCFu },
+		{ 0xB67F6455292CBF08u, 0x1A3BC84C17B1D542u },
+		{ 0xE41F3D6A7377EECAu, 0x20CABA5F1D9E4A93u },
+		{ 0x8E938662882AF53Eu, 0x547EB47B7282EE9Cu },
+		{ 0xB23867FB2A35B28Du, 0xE99E619A4F23AA43u },
+		{ 0xDEC681F9F4C31F31u, 0x6405FA00E2EC94D4u },
+		{ 0x8B3C113C38F9F37Eu, 0xDE83BC408DD3DD04u },
+		{ 0xAE0B158B4738705Eu, 0x9624AB50B148D445u },
+		{ 0xD98DDAEE19068C76u, 0x3BADD624DD9B0957u },
+		{ 0x87F8A8D4CFA417C9u, 0xE54CA5D70A80E5D6u },
+		{ 0xA9F6D30A038D1DBCu, 0x5E9FCF4CCD211F4Cu },
+		{ 0xD47487CC8470652Bu, 0x7647C3200069671Fu },
+		{ 0x84C8D4DFD2C63F3Bu, 0x29ECD9F40041E073u },
+		{ 0xA5FB0A17C777CF09u, 0xF468107100525890u },
+		{ 0xCF79CC9DB955C2CCu, 0x7182148D4066EEB4u },
+		{ 0x81AC1FE293D599BFu, 0xC6F14CD848405530u },
+		{ 0xA21727DB38CB002Fu, 0xB8ADA00E5A506A7Cu },
+		{ 0xCA9CF1D206FDC03Bu, 0xA6D90811F0E4851Cu },
+		{ 0xFD442E4688BD304Au, 0x908F4A166D1DA663u },
+		{ 0x9E4A9CEC15763E2Eu, 0x9A598E4E043287FEu },
+		{ 0xC5DD44271AD3CDBAu, 0x40EFF1E1853F29FDu },
+		{ 0xF7549530E188C128u, 0xD12BEE59E68EF47Cu },
+		{ 0x9A94DD3E8CF578B9u, 0x82BB74F8301958CEu },
+		{ 0xC13A148E3032D6E7u, 0xE36A52363C1FAF01u },
+		{ 0xF18899B1BC3F8CA1u, 0xDC44E6C3CB279AC1u },
+		{ 0x96F5600F15A7B7E5u, 0x29AB103A5EF8C0B9u },
+		{ 0xBCB2B812DB11A5DEu, 0x7415D448F6B6F0E7u },
+		{ 0xEBDF661791D60F56u, 0x111B495B3464AD21u },
+		{ 0x936B9FCEBB25C995u, 0xCAB10DD900BEEC34u },
+		{ 0xB84687C269EF3BFBu, 0x3D5D514F40EEA742u },
+		{ 0xE65829B3046B0AFAu, 0x0CB4A5A3112A5112u },
+		{ 0x8FF71A0FE2C2E6DCu, 0x47F0E785EABA72ABu },
+		{ 0xB3F4E093DB73A093u, 0x59ED216765690F56u },
+		{ 0xE0F218B8D25088B8u, 0x306869C13EC3532Cu },
+		{ 0x8C974F7383725573u, 0x1E414218C73A13FBu },
+		{ 0xAFBD2350644EEACFu, 0xE5D1929EF90898FAu },
+		{ 0xDBAC6C247D62A583u, 0xDF45F746B74ABF39u },
+		{ 0x894BC396CE5DA772u, 0x6B8BBA8C328EB783u },
+		{ 0xAB9EB47C81F5114Fu, 0x066EA92F3F326564u },
+		{ 0xD686619BA27255A2u, 0xC80A537B0EFEFEBDu },
+		{ 0x8613FD0145877585u, 0xBD06742CE95F5F36u },
+		{ 0xA798FC4196E952E7u, 0x2C48113823B73704u },
+		{ 0xD17F3B51FCA3A7A0u, 0xF75A15862CA504C5u },
+		{ 0x82EF85133DE648C4u, 0x9A984D73DBE722FBu },
+		{ 0xA3AB66580D5FDAF5u, 0xC13E60D0D2E0EBBAu },
+		{ 0xCC963FEE10B7D1B3u, 0x318DF905079926A8u },
+		{ 0xFFBBCFE994E5C61Fu, 0xFDF17746497F7052u },
+		{ 0x9FD561F1FD0F9BD3u, 0xFEB6EA8BEDEFA633u },
+		{ 0xC7CABA6E7C5382C8u, 0xFE64A52EE96B8FC0u },
+		{ 0xF9BD690A1B68637Bu, 0x3DFDCE7AA3C673B0u },
+		{ 0x9C1661A651213E2Du, 0x06BEA10CA65C084Eu },
+		{ 0xC31BFA0FE5698DB8u, 0x486E494FCFF30A62u },
+		{ 0xF3E2F893DEC3F126u, 0x5A89DBA3C3EFCCFAu },
+		{ 0x986DDB5C6B3A76B7u, 0xF89629465A75E01Cu },
+		{ 0xBE89523386091465u, 0xF6BBB397F1135823u },
+		{ 0xEE2BA6C0678B597Fu, 0x746AA07DED582E2Cu },
+		{ 0x94DB483840B717EFu, 0xA8C2A44EB4571CDCu },
+		{ 0xBA121A4650E4DDEBu, 0x92F34D62616CE413u },
+		{ 0xE896A0D7E51E1566u, 0x77B020BAF9C81D17u },
+		{ 0x915E2486EF32CD60u, 0x0ACE1474DC1D122Eu },
+		{ 0xB5B5ADA8AAFF80B8u, 0x0D819992132456BAu },
+		{ 0xE3231912D5BF60E6u, 0x10E1FFF697ED6C69u },
+		{ 0x8DF5EFABC5979C8Fu, 0xCA8D3FFA1EF463C1u },
+		{ 0xB1736B96B6FD83B3u, 0xBD308FF8A6B17CB2u },
+		{ 0xDDD0467C64BCE4A0u, 0xAC7CB3F6D05DDBDEu },
+		{ 0x8AA22C0DBEF60EE4u, 0x6BCDF07A423AA96Bu },
+		{ 0xAD4AB7112EB3929Du, 0x86C16C98D2C953C6u },
+		{ 0xD89D64D57A607744u, 0xE871C7BF077BA8B7u },
+		{ 0x87625F056C7C4A8Bu, 0x11471CD764AD4972u },
+		{ 0xA93AF6C6C79B5D2Du, 0xD598E40D3DD89BCFu },
+		{ 0xD389B47879823479u, 0x4AFF1D108D4EC2C3u },
+		{ 0x843610CB4BF160CBu, 0xCEDF722A585139BAu },
+		{ 0xA54394FE1EEDB8FEu, 0xC2974EB4EE658828u },
+		{ 0xCE947A3DA6A9273Eu, 0x733D226229FEEA32u },
+		{ 0x811CCC668829B887u, 0x0806357D5A3F525Fu },
+		{ 0xA163FF802A3426A8u, 0xCA07C2DCB0CF26F7u },
+		{ 0xC9BCFF6034C13052u, 0xFC89B393DD02F0B5u },
+		{ 0xFC2C3F3841F17C67u, 0xBBAC2078D443ACE2u },
+		{ 0x9D9BA7832936EDC0u, 0xD54B944B84AA4C0Du },
+		{ 0xC5029163F384A931u, 0x0A9E795E65D4DF11u },
+		{ 0xF64335BCF065D37Du, 0x4D4617B5FF4A16D5u },
+		{ 0x99EA0196163FA42Eu, 0x504BCED1BF8E4E45u },
+		{ 0xC06481FB9BCF8D39u, 0xE45EC2862F71E1D6u },
+		{ 0xF07DA27A82C37088u, 0x5D767327BB4E5A4Cu },
+		{ 0x964E858C91BA2655u, 0x3A6A07F8D510F86Fu },
+		{ 0xBBE226EFB628AFEAu, 0x890489F70A55368Bu },
+		{ 0xEADAB0ABA3B2DBE5u, 0x2B45AC74CCEA842Eu },
+		{ 0x92C8AE6B464FC96Fu, 0x3B0B8BC90012929Du },
+		{ 0xB77ADA0617E3BBCBu, 0x09CE6EBB40173744u },
+		{ 0xE55990879DDCAABDu, 0xCC420A6A101D0515u },
+		{ 0x8F57FA54C2A9EAB6u, 0x9FA946824A12232Du },
+		{ 0xB32DF8E9F3546564u, 0x47939822DC96ABF9u },
+		{ 0xDFF9772470297EBDu, 0x59787E2B93BC56F7u },
+		{ 0x8BFBEA76C619EF36u, 0x57EB4EDB3C55B65Au },
+		{ 0xAEFAE51477A06B03u, 0xEDE622920B6B23F1u },
+		{ 0xDAB99E59958885C4u, 0xE95FAB368E45ECEDu },
+		{ 0x88B402F7FD75539Bu, 0x11DBCB0218EBB414u },
+		{ 0xAAE103B5FCD2A881u, 0xD652BDC29F26A119u },
+		{ 0xD59944A37C0752A2u, 0x4BE76D3346F0495Fu },
+		{ 0x857FCAE62D8493A5u, 0x6F70A4400C562DDBu },
+		{ 0xA6DFBD9FB8E5B88Eu, 0xCB4CCD500F6BB952u },
+		{ 0xD097AD07A71F26B2u, 0x7E2000A41346A7A7u },
+		{ 0x825ECC24C873782Fu, 0x8ED400668C0C28C8u },
+		{ 0xA2F67F2DFA90563Bu, 0x728900802F0F32FAu },
+		{ 0xCBB41EF979346BCAu, 0x4F2B40A03AD2FFB9u },
+		{ 0xFEA126B7D78186BCu, 0xE2F610C84987BFA8u },
+		{ 0x9F24B832E6B0F436u, 0x0DD9CA7D2DF4D7C9u },
+		{ 0xC6EDE63FA05D3143u, 0x91503D1C79720DBBu },
+		{ 0xF8A95FCF88747D94u, 0x75A44C6397CE912Au },
+		{ 0x9B69DBE1B548CE7Cu, 0xC986AFBE3EE11ABAu },
+		{ 0xC24452DA229B021Bu, 0xFBE85BADCE996168u },
+		{ 0xF2D56790AB41C2A2u, 0xFAE27299423FB9C3u },
+		{ 0x97C560BA6B0919A5u, 0xDCCD879FC967D41Au },
+		{ 0xBDB6B8E905CB600Fu, 0x5400E987BBC1C920u },
+		{ 0xED246723473E3813u, 0x290123E9AAB23B68u },
+		{ 0x9436C0760C86E30Bu, 0xF9A0B6720AAF6521u },
+		{ 0xB94470938FA89BCEu, 0xF808E40E8D5B3E69u },
+		{ 0xE7958CB87392C2C2u, 0xB60B1D1230B20E04u },
+		{ 0x90BD77F3483BB9B9u, 0xB1C6F22B5E6F48C2u },
+		{ 0xB4ECD5F01A4AA828u, 0x1E38AEB6360B1AF3u },
+		{ 0xE2280B6C20DD5232u, 0x25C6DA63C38DE1B0u },
+		{ 0x8D590723948A535Fu, 0x579C487E5A38AD0Eu },
+		{ 0xB0AF48EC79ACE837u, 0x2D835A9DF0C6D851u },
+		{ 0xDCDB1B2798182244u, 0xF8E431456CF88E65u },
+		{ 0x8A08F0F8BF0F156Bu, 0x1B8E9ECB641B58FFu },
+		{ 0xAC8B2D36EED2DAC5u, 0xE272467E3D222F3Fu },
+		{ 0xD7ADF884AA879177u, 0x5B0ED81DCC6ABB0Fu },
+		{ 0x86CCBB52EA94BAEAu, 0x98E947129FC2B4E9u },
+		{ 0xA87FEA27A539E9A5u, 0x3F2398D747B36224u },
+		{ 0xD29FE4B18E88640Eu, 0x8EEC7F0D19A03AADu },
+		{ 0x83A3EEEEF9153E89u, 0x1953CF68300424ACu },
+		{ 0xA48CEAAAB75A8E2Bu, 0x5FA8C3423C052DD7u },
+		{ 0xCDB02555653131B6u, 0x3792F412CB06794Du },
+		{ 0x808E17555F3EBF11u, 0xE2BBD88BBEE40BD0u },
+		{ 0xA0B19D2AB70E6ED6u, 0x5B6ACEAEAE9D0EC4u },
+		{ 0xC8DE047564D20A8Bu, 0xF245825A5A445275u },
+		{ 0xFB158592BE068D2Eu, 0xEED6E2F0F0D56712u },
+		{ 0x9CED737BB6C4183Du, 0x55464DD69685606Bu },
+		{ 0xC428D05AA4751E4Cu, 0xAA97E14C3C26B886u },
+		{ 0xF53304714D9265DFu, 0xD53DD99F4B3066A8u },
+		{ 0x993FE2C6D07B7FABu, 0xE546A8038EFE4029u },
+		{ 0xBF8FDB78849A5F96u, 0xDE98520472BDD033u },
+		{ 0xEF73D256A5C0F77Cu, 0x963E66858F6D4440u },
+		{ 0x95A8637627989AADu, 0xDDE7001379A44AA8u },
+		{ 0xBB127C53B17EC159u, 0x5560C018580D5D52u },
+		{ 0xE9D71B689DDE71AFu, 0xAAB8F01E6E10B4A6u },
+		{ 0x9226712162AB070Du, 0xCAB3961304CA70E8u },
+		{ 0xB6B00D69BB55C8D1u, 0x3D607B97C5FD0D22u },
+		{ 0xE45C10C42A2B3B05u, 0x8CB89A7DB77C506Au },
+		{ 0x8EB98A7A9A5B04E3u, 0x77F3608E92ADB242u },
+		{ 0xB267ED1940F1C61Cu, 0x55F038B237591ED3u },
+		{ 0xDF01E85F912E37A3u, 0x6B6C46DEC52F6688u },
+		{ 0x8B61313BBABCE2C6u, 0x2323AC4B3B3DA015u },
+		{ 0xAE397D8AA96C1B77u, 0xABEC975E0A0D081Au },
+		{ 0xD9C7DCED53C72255u, 0x96E7BD358C904A21u },
+		{ 0x881CEA14545C7575u, 0x7E50D64177DA2E54u },
+		{ 0xAA242499697392D2u, 0xDDE50BD1D5D0B9E9u },
+		{ 0xD4AD2DBFC3D07787u, 0x955E4EC64B44E864u },
+		{ 0x84EC3C97DA624AB4u, 0xBD5AF13BEF0B113Eu },
+		{ 0xA6274BBDD0FADD61u, 0xECB1AD8AEACDD58Eu },
+		{ 0xCFB11EAD453994BAu, 0x67DE18EDA5814AF2u },
+		{ 0x81CEB32C4B43FCF4u, 0x80EACF948770CED7u },
+		{ 0xA2425FF75E14FC31u, 0xA1258379A94D028Du },
+		{ 0xCAD2F7F5359A3B3Eu, 0x096EE45813A04330u },
+		{ 0xFD87B5F28300CA0Du, 0x8BCA9D6E188853FCu },
+		{ 0x9E74D1B791E07E48u, 0x775EA264CF55347Eu },
+		{ 0xC612062576589DDAu, 0x95364AFE032A819Eu },
+		{ 0xF79687AED3EEC551u, 0x3A83DDBD83F52205u },
+		{ 0x9ABE14CD44753B52u, 0xC4926A9672793543u },
+		{ 0xC16D9A0095928A27u, 0x75B7053C0F178294u },
+		{ 0xF1C90080BAF72CB1u, 0x5324C68B12DD6339u },
+		{ 0x971DA05074DA7BEEu, 0xD3F6FC16EBCA5E04u },
+		{ 0xBCE5086492111AEAu, 0x88F4BB1CA6BCF585u },
+		{ 0xEC1E4A7DB69561A5u, 0x2B31E9E3D06C32E6u },
+		{ 0x9392EE8E921D5D07u, 0x3AFF322E62439FD0u },
+		{ 0xB877AA3236A4B449u, 0x09BEFEB9FAD487C3u },
+		{ 0xE69594BEC44DE15Bu, 0x4C2EBE687989A9B4u },
+		{ 0x901D7CF73AB0ACD9u, 0x0F9D37014BF60A11u },
+		{ 0xB424DC35095CD80Fu, 0x538484C19EF38C95u },
+		{ 0xE12E13424BB40E13u, 0x2865A5F206B06FBAu },
+		{ 0x8CBCCC096F5088CBu, 0xF93F87B7442E45D4u },
+		{ 0xAFEBFF0BCB24AAFEu, 0xF78F69A51539D749u },
+		{ 0xDBE6FECEBDEDD5BEu, 0xB573440E5A884D1Cu },
+		{ 0x89705F4136B4A597u, 0x31680A88F8953031u },
+		{ 0xABCC77118461CEFCu, 0xFDC20D2B36BA7C3Eu },
+		{ 0xD6BF94D5E57A42BCu, 0x3D32907604691B4Du },
+		{ 0x8637BD05AF6C69B5u, 0xA63F9A49C2C1B110u },
+		{ 0xA7C5AC471B478423u, 0x0FCF80DC33721D54u },
+		{ 0xD1B71758E219652Bu, 0xD3C36113404EA4A9u },
+		{ 0x83126E978D4FDF3Bu, 0x645A1CAC083126EAu },
+		{ 0xA3D70A3D70A3D70Au, 0x3D70A3D70A3D70A4u },
+		{ 0xCCCCCCCCCCCCCCCCu, 0xCCCCCCCCCCCCCCCDu },
+		{ 0x8000000000000000u, 0x0000000000000000u },
+		{ 0xA000000000000000u, 0x0000000000000000u },
+		{ 0xC800000000000000u, 0x0000000000000000u },
+		{ 0xFA00000000000000u, 0x0000000000000000u },
+		{ 0x9C40000000000000u, 0x0000000000000000u },
+		{ 0xC350000000000000u, 0x0000000000000000u },
+		{ 0xF424000000000000u, 0x0000000000000000u },
+		{ 0x9896800000000000u, 0x0000000000000000u },
+		{ 0xBEBC200000000000u, 0x0000000000000000u },
+		{ 0xEE6B280000000000u, 0x0000000000000000u },
+		{ 0x9502F90000000000u, 0x0000000000000000u },
+		{ 0xBA43B74000000000u, 0x0000000000000000u },
+		{ 0xE8D4A51000000000u, 0x0000000000000000u },
+		{ 0x9184E72A00000000u, 0x0000000000000000u },
+		{ 0xB5E620F480000000u, 0x0000000000000000u },
+		{ 0xE35FA931A0000000u, 0x0000000000000000u },
+		{ 0x8E1BC9BF04000000u, 0x0000000000000000u },
+		{ 0xB1A2BC2EC5000000u, 0x0000000000000000u },
+		{ 0xDE0B6B3A76400000u, 0x0000000000000000u },
+		{ 0x8AC7230489E80000u, 0x0000000000000000u },
+		{ 0xAD78EBC5AC620000u, 0x0000000000000000u },
+		{ 0xD8D726B7177A8000u, 0x0000000000000000u },
+		{ 0x878678326EAC9000u, 0x0000000000000000u },
+		{ 0xA968163F0A57B400u, 0x0000000000000000u },
+		{ 0xD3C21BCECCEDA100u, 0x0000000000000000u },
+		{ 0x84595161401484A0u, 0x0000000000000000u },
+		{ 0xA56FA5B99019A5C8u, 0x0000000000000000u },
+		{ 0xCECB8F27F4200F3Au, 0x0000000000000000u },
+		{ 0x813F3978F8940984u, 0x4000000000000000u },
+		{ 0xA18F07D736B90BE5u, 0x5000000000000000u },
+		{ 0xC9F2C9CD04674EDEu, 0xA400000000000000u },
+		{ 0xFC6F7C4045812296u, 0x4D00000000000000u },
+		{ 0x9DC5ADA82B70B59Du, 0xF020000000000000u },
+		{ 0xC5371912364CE305u, 0x6C28000000000000u },
+		{ 0xF684DF56C3E01BC6u, 0xC732000000000000u },
+		{ 0x9A130B963A6C115Cu, 0x3C7F400000000000u },
+		{ 0xC097CE7BC90715B3u, 0x4B9F100000000000u },
+		{ 0xF0BDC21ABB48DB20u, 0x1E86D40000000000u },
+		{ 0x96769950B50D88F4u, 0x1314448000000000u },
+		{ 0xBC143FA4E250EB31u, 0x17D955A000000000u },
+		{ 0xEB194F8E1AE525FDu, 0x5DCFAB0800000000u },
+		{ 0x92EFD1B8D0CF37BEu, 0x5AA1CAE500000000u },
+		{ 0xB7ABC627050305ADu, 0xF14A3D9E40000000u },
+		{ 0xE596B7B0C643C719u, 0x6D9CCD05D0000000u },
+		{ 0x8F7E32CE7BEA5C6Fu, 0xE4820023A2000000u },
+		{ 0xB35DBF821AE4F38Bu, 0xDDA2802C8A800000u },
+		{ 0xE0352F62A19E306Eu, 0xD50B2037AD200000u },
+		{ 0x8C213D9DA502DE45u, 0x4526F422CC340000u },
+		{ 0xAF298D050E4395D6u, 0x9670B12B7F410000u },
+		{ 0xDAF3F04651D47B4Cu, 0x3C0CDD765F114000u },
+		{ 0x88D8762BF324CD0Fu, 0xA5880A69FB6AC800u },
+		{ 0xAB0E93B6EFEE0053u, 0x8EEA0D047A457A00u },
+		{ 0xD5D238A4ABE98068u, 0x72A4904598D6D880u },
+		{ 0x85A36366EB71F041u, 0x47A6DA2B7F864750u },
+		{ 0xA70C3C40A64E6C51u, 0x999090B65F67D924u },
+		{ 0xD0CF4B50CFE20765u, 0xFFF4B4E3F741CF6Du },
+		{ 0x82818F1281ED449Fu, 0xBFF8F10E7A8921A4u },
+		{ 0xA321F2D7226895C7u, 0xAFF72D52192B6A0Du },
+		{ 0xCBEA6F8CEB02BB39u, 0x9BF4F8A69F764490u },
+		{ 0xFEE50B7025C36A08u, 0x02F236D04753D5B4u },
+		{ 0x9F4F2726179A2245u, 0x01D762422C946590u },
+		{ 0xC722F0EF9D80AAD6u, 0x424D3AD2B7B97EF5u },
+		{ 0xF8EBAD2B84E0D58Bu, 0xD2E0898765A7DEB2u },
+		{ 0x9B934C3B330C8577u, 0x63CC55F49F88EB2Fu },
+		{ 0xC2781F49FFCFA6D5u, 0x3CBF6B71C76B25FBu },
+		{ 0xF316271C7FC3908Au, 0x8BEF464E3945EF7Au },
+		{ 0x97EDD871CFDA3A56u, 0x97758BF0E3CBB5ACu },
+		{ 0xBDE94E8E43D0C8ECu, 0x3D52EEED1CBEA317u },
+		{ 0xED63A231D4C4FB27u, 0x4CA7AAA863EE4BDDu },
+		{ 0x945E455F24FB1CF8u, 0x8FE8CAA93E74EF6Au },
+		{ 0xB975D6B6EE39E436u, 0xB3E2FD538E122B44u },
+		{ 0xE7D34C64A9C85D44u, 0x60DBBCA87196B616u },
+		{ 0x90E40FBEEA1D3A4Au, 0xBC8955E946FE31CDu },
+		{ 0xB51D13AEA4A488DDu, 0x6BABAB6398BDBE41u },
+		{ 0xE264589A4DCDAB14u, 0xC696963C7EED2DD1u },
+		{ 0x8D7EB76070A08AECu, 0xFC1E1DE5CF543CA2u },
+		{ 0xB0DE65388CC8ADA8u, 0x3B25A55F43294BCBu },
+		{ 0xDD15FE86AFFAD912u, 0x49EF0EB713F39EBEu },
+		{ 0x8A2DBF142DFCC7ABu, 0x6E3569326C784337u },
+		{ 0xACB92ED9397BF996u, 0x49C2C37F07965404u },
+		{ 0xD7E77A8F87DAF7FBu, 0xDC33745EC97BE906u },
+		{ 0x86F0AC99B4E8DAFDu, 0x69A028BB3DED71A3u },
+		{ 0xA8ACD7C0222311BCu, 0xC40832EA0D68CE0Cu },
+		{ 0xD2D80DB02AABD62Bu, 0xF50A3FA490C30190u },
+		{ 0x83C7088E1AAB65DBu, 0x792667C6DA79E0FAu },
+		{ 0xA4B8CAB1A1563F52u, 0x577001B891185938u },
+		{ 0xCDE6FD5E09ABCF26u, 0xED4C0226B55E6F86u },
+		{ 0x80B05E5AC60B6178u, 0x544F8158315B05B4u },
+		{ 0xA0DC75F1778E39D6u, 0x696361AE3DB1C721u },
+		{ 0xC913936DD571C84Cu, 0x03BC3A19CD1E38E9u },
+		{ 0xFB5878494ACE3A5Fu, 0x04AB48A04065C723u },
+		{ 0x9D174B2DCEC0E47Bu, 0x62EB0D64283F9C76u },
+		{ 0xC45D1DF942711D9Au, 0x3BA5D0BD324F8394u },
+		{ 0xF5746577930D6500u, 0xCA8F44EC7EE36479u },
+		{ 0x9968BF6ABBE85F20u, 0x7E998B13CF4E1ECBu },
+		{ 0xBFC2EF456AE276E8u, 0x9E3FEDD8C321A67Eu },
+		{ 0xEFB3AB16C59B14A2u, 0xC5CFE94EF3EA101Eu },
+		{ 0x95D04AEE3B80ECE5u, 0xBBA1F1D158724A12u },
+		{ 0xBB445DA9CA61281Fu, 0x2A8A6E45AE8EDC97u },
+		{ 0xEA1575143CF97226u, 0xF52D09D71A3293BDu },
+		{ 0x924D692CA61BE758u, 0x593C2626705F9C56u },
+		{ 0xB6E0C377CFA2E12Eu, 0x6F8B2FB00C77836Cu },
+		{ 0xE498F455C38B997Au, 0x0B6DFB9C0F956447u },
+		{ 0x8EDF98B59A373FECu, 0x4724BD4189BD5EACu },
+		{ 0xB2977EE300C50FE7u, 0x58EDEC91EC2CB657u },
+		{ 0xDF3D5E9BC0F653E1u, 0x2F2967B66737E3EDu },
+		{ 0x8B865B215899F46Cu, 0xBD79E0D20082EE74u },
+		{ 0xAE67F1E9AEC07187u, 0xECD8590680A3AA11u },
+		{ 0xDA01EE641A708DE9u, 0xE80E6F4820CC9495u },
+		{ 0x884134FE908658B2u, 0x3109058D147FDCDDu },
+		{ 0xAA51823E34A7EEDEu, 0xBD4B46F0599FD415u },
+		{ 0xD4E5E2CDC1D1EA96u, 0x6C9E18AC7007C91Au },
+		{ 0x850FADC09923329Eu, 0x03E2CF6BC604DDB0u },
+		{ 0xA6539930BF6BFF45u, 0x84DB8346B786151Cu },
+		{ 0xCFE87F7CEF46FF16u, 0xE612641865679A63u },
+		{ 0x81F14FAE158C5F6Eu, 0x4FCB7E8F3F60C07Eu },
+		{ 0xA26DA3999AEF7749u, 0xE3BE5E330F38F09Du },
+		{ 0xCB090C8001AB551Cu, 0x5CADF5BFD3072CC5u },
+		{ 0xFDCB4FA002162A63u, 0x73D9732FC7C8F7F6u },
+		{ 0x9E9F11C4014DDA7Eu, 0x2867E7FDDCDD9AFAu },
+		{ 0xC646D63501A1511Du, 0xB281E1FD541501B8u },
+		{ 0xF7D88BC24209A565u, 0x1F225A7CA91A4226u },
+		{ 0x9AE757596946075Fu, 0x3375788DE9B06958u },
+		{ 0xC1A12D2FC3978937u, 0x0052D6B1641C83AEu },
+		{ 0xF209787BB47D6B84u, 0xC0678C5DBD23A49Au },
+		{ 0x9745EB4D50CE6332u, 0xF840B7BA963646E0u },
+		{ 0xBD176620A501FBFFu, 0xB650E5A93BC3D898u },
+		{ 0xEC5D3FA8CE427AFFu, 0xA3E51F138AB4CEBEu },
+		{ 0x93BA47C980E98CDFu, 0xC66F336C36B10137u },
+		{ 0xB8A8D9BBE123F017u, 0xB80B0047445D4184u },
+		{ 0xE6D3102AD96CEC1Du, 0xA60DC059157491E5u },
+		{ 0x9043EA1AC7E41392u, 0x87C89837AD68DB2Fu },
+		{ 0xB454E4A179DD1877u, 0x29BABE4598C311FBu },
+		{ 0xE16A1DC9D8545E94u, 0xF4296DD6FEF3D67Au },
+		{ 0x8CE2529E2734BB1Du, 0x1899E4A65F58660Cu },
+		{ 0xB01AE745B101E9E4u, 0x5EC05DCFF72E7F8Fu },
+		{ 0xDC21A1171D42645Du, 0x76707543F4FA1F73u },
+		{ 0x899504AE72497EBAu, 0x6A06494A791C53A8u },
+		{ 0xABFA45DA0EDBDE69u, 0x0487DB9D17636892u },
+		{ 0xD6F8D7509292D603u, 0x45A9D2845D3C42B6u },
+		{ 0x865B86925B9BC5C2u, 0x0B8A2392BA45A9B2u },
+		{ 0xA7F26836F282B732u, 0x8E6CAC7768D7141Eu },
+		{ 0xD1EF0244AF2364FFu, 0x3207D795430CD926u },
+		{ 0x8335616AED761F1Fu, 0x7F44E6BD49E807B8u },
+		{ 0xA402B9C5A8D3A6E7u, 0x5F16206C9C6209A6u },
+		{ 0xCD036837130890A1u, 0x36DBA887C37A8C0Fu },
+		{ 0x802221226BE55A64u, 0xC2494954DA2C9789u },
+		{ 0xA02AA96B06DEB0FDu, 0xF2DB9BAA10B7BD6Cu },
+		{ 0xC83553C5C8965D3Du, 0x6F92829494E5ACC7u },
+		{ 0xFA42A8B73ABBF48Cu, 0xCB772339BA1F17F9u },
+		{ 0x9C69A97284B578D7u, 0xFF2A760414536EFBu },
+		{ 0xC38413CF25E2D70Du, 0xFEF5138519684ABAu },
+		{ 0xF46518C2EF5B8CD1u, 0x7EB258665FC25D69u },
+		{ 0x98BF2F79D5993802u, 0xEF2F773FFBD97A61u },
+		{ 0xBEEEFB584AFF8603u, 0xAAFB550FFACFD8FAu },
+		{ 0xEEAABA2E5DBF6784u, 0x95BA2A53F983CF38u },
+		{ 0x952AB45CFA97A0B2u, 0xDD945A747BF26183u },
+		{ 0xBA756174393D88DFu, 0x94F971119AEEF9E4u },
+		{ 0xE912B9D1478CEB17u, 0x7A37CD5601AAB85Du },
+		{ 0x91ABB422CCB812EEu, 0xAC62E055C10AB33Au },
+		{ 0xB616A12B7FE617AAu, 0x577B986B314D6009u },
+		{ 0xE39C49765FDF9D94u, 0xED5A7E85FDA0B80Bu },
+		{ 0x8E41ADE9FBEBC27Du, 0x14588F13BE847307u },
+		{ 0xB1D219647AE6B31Cu, 0x596EB2D8AE258FC8u },
+		{ 0xDE469FBD99A05FE3u, 0x6FCA5F8ED9AEF3BBu },
+		{ 0x8AEC23D680043BEEu, 0x25DE7BB9480D5854u },
+		{ 0xADA72CCC20054AE9u, 0xAF561AA79A10AE6Au },
+		{ 0xD910F7FF28069DA4u, 0x1B2BA1518094DA04u },
+		{ 0x87AA9AFF79042286u, 0x90FB44D2F05D0842u },
+		{ 0xA99541BF57452B28u, 0x353A1607AC744A53u },
+		{ 0xD3FA922F2D1675F2u, 0x42889B8997915CE8u },
+		{ 0x847C9B5D7C2E09B7u, 0x69956135FEBADA11u },
+		{ 0xA59BC234DB398C25u, 0x43FAB9837E699095u },
+		{ 0xCF02B2C21207EF2Eu, 0x94F967E45E03F4BBu },
+		{ 0x8161AFB94B44F57Du, 0x1D1BE0EEBAC278F5u },
+		{ 0xA1BA1BA79E1632DCu, 0x6462D92A69731732u },
+		{ 0xCA28A291859BBF93u, 0x7D7B8F7503CFDCFEu },
+		{ 0xFCB2CB35E702AF78u, 0x5CDA735244C3D43Eu },
+		{ 0x9DEFBF01B061ADABu, 0x3A0888136AFA64A7u },
+		{ 0xC56BAEC21C7A1916u, 0x088AAA1845B8FDD0u },
+		{ 0xF6C69A72A3989F5Bu, 0x8AAD549E57273D45u },
+		{ 0x9A3C2087A63F6399u, 0x36AC54E2F678864Bu },
+		{ 0xC0CB28A98FCF3C7Fu, 0x84576A1BB416A7DDu },
+		{ 0xF0FDF2D3F3C30B9Fu, 0x656D44A2A11C51D5u },
+		{ 0x969EB7C47859E743u, 0x9F644AE5A4B1B325u },
+		{ 0xBC4665B596706114u, 0x873D5D9F0DDE1FEEu },
+		{ 0xEB57FF22FC0C7959u, 0xA90CB506D155A7EAu },
+		{ 0x9316FF75DD87CBD8u, 0x09A7F12442D588F2u },
+		{ 0xB7DCBF5354E9BECEu, 0x0C11ED6D538AEB2Fu },
+		{ 0xE5D3EF282A242E81u, 0x8F1668C8A86DA5FAu },
+		{ 0x8FA475791A569D10u, 0xF96E017D694487BCu },
+		{ 0xB38D92D760EC4455u, 0x37C981DCC395A9ACu },
+		{ 0xE070F78D3927556Au, 0x85BBE253F47B1417u },
+		{ 0x8C469AB843B89562u, 0x93956D7478CCEC8Eu },
+		{ 0xAF58416654A6BABBu, 0x387AC8D1970027B2u },
+		{ 0xDB2E51BFE9D0696Au, 0x06997B05FCC0319Eu },
+		{ 0x88FCF317F22241E2u, 0x441FECE3BDF81F03u },
+		{ 0xAB3C2FDDEEAAD25Au, 0xD527E81CAD7626C3u },
+		{ 0xD60B3BD56A5586F1u, 0x8A71E223D8D3B074u },
+		{ 0x85C7056562757456u, 0xF6872D5667844E49u },
+		{ 0xA738C6BEBB12D16Cu, 0xB428F8AC016561DBu },
+		{ 0xD106F86E69D785C7u, 0xE13336D701BEBA52u },
+		{ 0x82A45B450226B39Cu, 0xECC0024661173473u },
+		{ 0xA34D721642B06084u, 0x27F002D7F95D0190u },
+		{ 0xCC20CE9BD35C78A5u, 0x31EC038DF7B441F4u },
+		{ 0xFF290242C83396CEu, 0x7E67047175A15271u },
+		{ 0x9F79A169BD203E41u, 0x0F0062C6E984D386u },
+		{ 0xC75809C42C684DD1u, 0x52C07B78A3E60868u },
+		{ 0xF92E0C3537826145u, 0xA7709A56CCDF8A82u },
+		{ 0x9BBCC7A142B17CCBu, 0x88A66076400BB691u },
+		{ 0xC2ABF989935DDBFEu, 0x6ACFF893D00EA435u },
+		{ 0xF356F7EBF83552FEu, 0x0583F6B8C4124D43u },
+		{ 0x98165AF37B2153DEu, 0xC3727A337A8B704Au },
+		{ 0xBE1BF1B059E9A8D6u, 0x744F18C0592E4C5Cu },
+		{ 0xEDA2EE1C7064130Cu, 0x1162DEF06F79DF73u },
+		{ 0x9485D4D1C63E8BE7u, 0x8ADDCB5645AC2BA8u },
+		{ 0xB9A74A0637CE2EE1u, 0x6D953E2BD7173692u },
+		{ 0xE8111C87C5C1BA99u, 0xC8FA8DB6CCDD0437u },
+		{ 0x910AB1D4DB9914A0u, 0x1D9C9892400A22A2u },
+		{ 0xB54D5E4A127F59C8u, 0x2503BEB6D00CAB4Bu },
+		{ 0xE2A0B5DC971F303Au, 0x2E44AE64840FD61Du },
+		{ 0x8DA471A9DE737E24u, 0x5CEAECFED289E5D2u },
+		{ 0xB10D8E1456105DADu, 0x7425A83E872C5F47u },
+		{ 0xDD50F1996B947518u, 0xD12F124E28F77719u },
+		{ 0x8A5296FFE33CC92Fu, 0x82BD6B70D99AAA6Fu },
+		{ 0xACE73CBFDC0BFB7Bu, 0x636CC64D1001550Bu },
+		{ 0xD8210BEFD30EFA5Au, 0x3C47F7E05401AA4Eu },
+		{ 0x8714A775E3E95C78u, 0x65ACFAEC34810A71u },
+		{ 0xA8D9D1535CE3B396u, 0x7F1839A741A14D0Du },
+		{ 0xD31045A8341CA07Cu, 0x1EDE48111209A050u },
+		{ 0x83EA2B892091E44Du, 0x934AED0AAB460432u },
+		{ 0xA4E4B66B68B65D60u, 0xF81DA84D5617853Fu },
+		{ 0xCE1DE40642E3F4B9u, 0x36251260AB9D668Eu },
+		{ 0x80D2AE83E9CE78F3u, 0xC1D72B7C6B426019u },
+		{ 0xA1075A24E4421730u, 0xB24CF65B8612F81Fu },
+		{ 0xC94930AE1D529CFCu, 0xDEE033F26797B627u },
+		{ 0xFB9B7CD9A4A7443Cu, 0x169840EF017DA3B1u },
+		{ 0x9D412E0806E88AA5u, 0x8E1F289560EE864Eu },
+		{ 0xC491798A08A2AD4Eu, 0xF1A6F2BAB92A27E2u },
+		{ 0xF5B5D7EC8ACB58A2u, 0xAE10AF696774B1DBu },
+		{ 0x9991A6F3D6BF1765u, 0xACCA6DA1E0A8EF29u },
+		{ 0xBFF610B0CC6EDD3Fu, 0x17FD090A58D32AF3u },
+		{ 0xEFF394DCFF8A948Eu, 0xDDFC4B4CEF07F5B0u },
+		{ 0x95F83D0A1FB69CD9u, 0x4ABDAF101564F98Eu },
+		{ 0xBB764C4CA7A4440Fu, 0x9D6D1AD41ABE37F1u },
+		{ 0xEA53DF5FD18D5513u, 0x84C86189216DC5EDu },
+		{ 0x92746B9BE2F8552Cu, 0x32FD3CF5B4E49BB4u },
+		{ 0xB7118682DBB66A77u, 0x3FBC8C33221DC2A1u },
+		{ 0xE4D5E82392A40515u, 0x0FABAF3FEAA5334Au },
+		{ 0x8F05B1163BA6832Du, 0x29CB4D87F2A7400Eu },
+		{ 0xB2C71D5BCA9023F8u, 0x743E20E9EF511012u },
+		{ 0xDF78E4B2BD342CF6u, 0x914DA9246B255416u },
+		{ 0x8BAB8EEFB6409C1Au, 0x1AD089B6C2F7548Eu },
+		{ 0xAE9672ABA3D0C320u, 0xA184AC2473B529B1u },
+		{ 0xDA3C0F568CC4F3E8u, 0xC9E5D72D90A2741Eu },
+		{ 0x8865899617FB1871u, 0x7E2FA67C7A658892u },
+		{ 0xAA7EEBFB9DF9DE8Du, 0xDDBB901B98FEEAB7u },
+		{ 0xD51EA6FA85785631u, 0x552A74227F3EA565u },
+		{ 0x8533285C936B35DEu, 0xD53A88958F87275Fu },
+		{ 0xA67FF273B8460356u, 0x8A892ABAF368F137u },
+		{ 0xD01FEF10A657842Cu, 0x2D2B7569B0432D85u },
+		{ 0x8213F56A67F6B29Bu, 0x9C3B29620E29FC73u },
+		{ 0xA298F2C501F45F42u, 0x8349F3BA91B47B8Fu },
+		{ 0xCB3F2F7642717713u, 0x241C70A936219A73u },
+		{ 0xFE0EFB53D30DD4D7u, 0xED238CD383AA0110u },
+		{ 0x9EC95D1463E8A506u, 0xF4363804324A40AAu },
+		{ 0xC67BB4597CE2CE48u, 0xB143C6053EDCD0D5u },
+		{ 0xF81AA16FDC1B81DAu, 0xDD94B7868E94050Au },
+		{ 0x9B10A4E5E9913128u, 0xCA7CF2B4191C8326u },
+		{ 0xC1D4CE1F63F57D72u, 0xFD1C2F611F63A3F0u },
+		{ 0xF24A01A73CF2DCCFu, 0xBC633B39673C8CECu },
+		{ 0x976E41088617CA01u, 0xD5BE0503E085D813u },
+		{ 0xBD49D14AA79DBC82u, 0x4B2D8644D8A74E18u },
+		{ 0xEC9C459D51852BA2u, 0xDDF8E7D60ED1219Eu },
+		{ 0x93E1AB8252F33B45u, 0xCABB90E5C942B503u },
+		{ 0xB8DA1662E7B00A17u, 0x3D6A751F3B936243u },
+		{ 0xE7109BFBA19C0C9Du, 0x0CC512670A783AD4u },
+		{ 0x906A617D450187E2u, 0x27FB2B80668B24C5u },
+		{ 0xB484F9DC9641E9DAu, 0xB1F9F660802DEDF6u },
+		{ 0xE1A63853BBD26451u, 0x5E7873F8A0396973u },
+		{ 0x8D07E33455637EB2u, 0xDB0B487B6423E1E8u },
+		{ 0xB049DC016ABC5E5Fu, 0x91CE1A9A3D2CDA62u },
+		{ 0xDC5C5301C56B75F7u, 0x7641A140CC7810FBu },
+		{ 0x89B9B3E11B6329BAu, 0xA9E904C87FCB0A9Du },
+		{ 0xAC2820D9623BF429u, 0x546345FA9FBDCD44u },
+		{ 0xD732290FBACAF133u, 0xA97C177947AD4095u },
+		{ 0x867F59A9D4BED6C0u, 0x49ED8EABCCCC485Du },
+		{ 0xA81F301449EE8C70u, 0x5C68F256BFFF5A74u },
+		{ 0xD226FC195C6A2F8Cu, 0x73832EEC6FFF3111u },
+		{ 0x83585D8FD9C25DB7u, 0xC831FD53C5FF7EABu },
+		{ 0xA42E74F3D032F525u, 0xBA3E7CA8B77F5E55u },
+		{ 0xCD3A1230C43FB26Fu, 0x28CE1BD2E55F35EBu },
+		{ 0x80444B5E7AA7CF85u, 0x7980D163CF5B81B3u },
+		{ 0xA0555E361951C366u, 0xD7E105BCC332621Fu },
+		{ 0xC86AB5C39FA63440u, 0x8DD9472BF3FEFAA7u },
+		{ 0xFA856334878FC150u, 0xB14F98F6F0FEB951u },
+		{ 0x9C935E00D4B9D8D2u, 0x6ED1BF9A569F33D3u },
+		{ 0xC3B8358109E84F07u, 0x0A862F80EC4700C8u },
+		{ 0xF4A642E14C6262C8u, 0xCD27BB612758C0FAu },
+		{ 0x98E7E9CCCFBD7DBDu, 0x8038D51CB897789Cu },
+		{ 0xBF21E44003ACDD2Cu, 0xE0470A63E6BD56C3u },
+		{ 0xEEEA5D5004981478u, 0x1858CCFCE06CAC74u },
+		{ 0x95527A5202DF0CCBu, 0x0F37801E0C43EBC8u },
+		{ 0xBAA718E68396CFFDu, 0xD30560258F54E6BAu },
+		{ 0xE950DF20247C83FDu, 0x47C6B82EF32A2069u },
+		{ 0x91D28B7416CDD27Eu, 0x4CDC331D57FA5441u },
+		{ 0xB6472E511C81471Du, 0xE0133FE4ADF8E952u },
+		{ 0xE3D8F9E563A198E5u, 0x58180FDDD97723A6u },
+		{ 0x8E679C2F5E44FF8Fu, 0x570F09EAA7EA7648u },
+	};
+
+	struct uint128_parts
+	{
+		uint64_t low;
+		uint64_t high;
+	};
+
+	TOML_CONST_INLINE_GETTER
+	uint128_parts multiply_full(uint64_t a, uint64_t b) noexcept
+	{
+#ifdef TOML_UINT128
+		const auto product = static_cast<TOML_UINT128>(a) * b;
+		return { static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64) };
+#elif TOML_MSVC && TOML_ARCH_AMD64
+		uint128_parts result;
+		result.low = _umul128(a, b, &result.high);
+		return result;
+#else
+		const uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+		const uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+		const uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+		const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+		return { (cross << 32) | (lo_lo & 0xFFFFFFFFu), (hi_lo >> 32) + (cross >> 32) + hi_hi };
+#endif
+	}
+
+	TOML_CONST_INLINE_GETTER
+	int leading_zeroes(uint64_t val) noexcept
+	{
+		TOML_ASSERT_ASSUME(val);
+#if TOML_MSVC && TOML_ARCH_AMD64
+		unsigned long idx;
+		_BitScanReverse64(&idx, val);
+		return 63 - static_cast<int>(idx);
+#elif TOML_MSVC
+		int count = 0;
+		while (!(val & 0x8000000000000000u))
+		{
+			val <<= 1;
+			count++;
+		}
+		return count;
+#else
+		return __builtin_clzll(val);
+#endif
+	}
+
+	// w * 10^q, or false if it can't be computed exactly this way.
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	bool eisel_lemire(uint64_t w, int64_t q, double& result) noexcept
+	{
+		constexpr int mantissa_bits = 52;
+
+		if (!w)
+		{
+			result = 0.0;
+			return true;
+		}
+		if (q < -342 || q > 308)
+			return false;
+
+		const int lz = leading_zeroes(w);
+		w <<= lz;
+
+		// only the top 55 bits of the product matter; the second half of the power of five is only needed if the
+		// bits below them are all set (and a carry out of them is possible)
+		const auto& power			 = powers_of_five[q + 342];
+		auto product				 = multiply_full(w, power[0]);
+		constexpr uint64_t low_bits = 0xFFFFFFFFFFFFFFFFu >> (mantissa_bits + 3);
+		if ((product.high & low_bits) == low_bits)
+		{
+			const auto second = multiply_full(w, power[1]);
+			product.low += second.high;
+			if (second.high > product.low)
+				product.high++;
+
+			if (product.low == 0xFFFFFFFFFFFFFFFFu && (q < -27 || q > 55))
+				return false;
+		}
+
+		const int upper_bit = static_cast<int>(product.high >> 63);
+		const int shift		= upper_bit + 64 - mantissa_bits - 3;
+		uint64_t mantissa	= product.high >> shift;
+
+		// floor(log2(10^q)) + 63, give or take the normalization above
+		int64_t exponent = ((((152170 + 65536) * q) >> 16) + 63) + upper_bit - lz + 1023;
+		if (exponent <= 0) // subnormal
+			return false;
+
+		// exact halfway cases are only possible when 10^q is exactly representable; those round to even
+		if (product.low <= 1 && q >= -4 && q <= 23 && (mantissa & 3u) == 1u && (mantissa << shift) == product.high)
+			mantissa &= ~uint64_t{ 1 };
+
+		mantissa += mantissa & 1u;
+		mantissa >>= 1;
+		if (mantissa >= (uint64_t{ 2 } << mantissa_bits))
+		{
+			mantissa = uint64_t{ 1 } << mantissa_bits;
+			exponent++;
+		}
+		mantissa &= ~(uint64_t{ 1 } << mantissa_bits);
+		if (exponent >= 0x7FF) // overflow
+			return false;
+
+		const uint64_t bits = mantissa | (static_cast<uint64_t>(exponent) << mantissa_bits);
+		static_assert(sizeof(bits) == sizeof(result));
+		std::memcpy(&result, &bits, sizeof(result));
+		return true;
+	}
+
+	// converts the digits of a TOML float (already validated, sign and underscores removed) to a double, or returns
+	// false if the caller needs to do it some other way.
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	bool decimal_to_double(const char* str, const char* end, double& result) noexcept
+	{
+		uint64_t w			= {};
+		int64_t q			= {};
+		int digits			= {}; // significant digits accumulated in w
+		bool truncated		= false;
+		bool seen_decimal	= false;
+		for (; str != end && *str != 'e' && *str != 'E'; str++)
+		{
+			if (*str == '.')
+			{
+				seen_decimal = true;
+				continue;
+			}
+
+			const auto digit = static_cast<unsigned>(*str - '0');
+			if (digits < 19)
+			{
+				w = w * 10u + digit;
+				if (w)
+					digits++;
+				if (seen_decimal)
+					q--;
+			}
+			else
+			{
+				truncated = truncated || digit;
+				if (!seen_decimal)
+					q++;
+			}
+		}
+
+		if (str != end)
+		{
+			str++;
+			const bool negative = *str == '-';
+			if (*str == '+' || *str == '-')
+				str++;
+
+			int64_t exponent = {};
+			for (; str != end; str++)
+				if (exponent < 100000)
+					exponent = exponent * 10 + (*str - '0');
+			q += negative ? -exponent : exponent;
+		}
+
+		// clinger's fast path: when both w and 10^q are exactly representable, so is the result of one IEEE operation
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+		if (!truncated && w <= (uint64_t{ 1 } << 53) && q >= -22 && q <= 22)
+		{
+			constexpr double exact_powers[] = { 1e0,  1e1,	1e2,  1e3,	1e4,  1e5,	1e6,  1e7,	1e8,  1e9,	1e10, 1e11,
+												1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+			result = static_cast<double>(w);
+			if (q < 0)
+				result /= exact_powers[-q];
+			else
+				result *= exact_powers[q];
+			return true;
+		}
+#endif
+
+		if (!eisel_lemire(w, q, result))
+			return false;
+
+		// the real value lies somewhere in [w, w + 1) * 10^q; if both ends round the same way, so does it
+		if (truncated)
+		{
+			double upper;
+			return eisel_lemire(w + 1u, q, upper) && upper == result;
+		}
+		return true;
+	}
+}
+TOML_ANON_NAMESPACE_END;
+
+#include "header_end.hpp"
+#endif // TOML_ENABLE_PARSER
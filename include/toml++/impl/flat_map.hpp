@@ -0,0 +1,179 @@
+//# This file is a part of toml++ and is subject to the the terms of the MIT license.
+//# Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+//# See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "std_utility.hpp"
+#include "std_vector.hpp"
+#include "std_string.hpp"
+#include "header_start.hpp"
+/// \cond
+
+TOML_IMPL_NAMESPACE_START
+{
+	// a std::map lookalike that keeps its entries sorted in one contiguous block (see TOML_FLAT_TABLES).
+	// it only implements what toml::table needs, and keys are anything that converts to a std::string_view.
+	//
+	// unlike std::map, inserting and erasing invalidates iterators and references to the entries that follow
+	// (and all of them if the storage has to grow). inserting anywhere but the end costs O(n).
+	template <typename Key, typename T, typename Allocator>
+	class flat_map
+	{
+	  public:
+		using key_type		 = Key;
+		using mapped_type	 = T;
+		using value_type	 = std::pair<Key, T>;
+		using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+
+	  private:
+		using storage_type = std::vector<value_type, allocator_type>;
+		storage_type entries_;
+
+	  public:
+		using size_type		 = typename storage_type::size_type;
+		using iterator		 = typename storage_type::iterator;
+		using const_iterator = typename storage_type::const_iterator;
+
+		TOML_PURE_INLINE_GETTER
+		iterator begin() noexcept
+		{
+			return entries_.begin();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const_iterator begin() const noexcept
+		{
+			return entries_.begin();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const_iterator cbegin() const noexcept
+		{
+			return entries_.cbegin();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		iterator end() noexcept
+		{
+			return entries_.end();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const_iterator end() const noexcept
+		{
+			return entries_.end();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const_iterator cend() const noexcept
+		{
+			return entries_.cend();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		bool empty() const noexcept
+		{
+			return entries_.empty();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		size_type size() const noexcept
+		{
+			return entries_.size();
+		}
+
+		void clear() noexcept
+		{
+			entries_.clear();
+		}
+
+		TOML_PURE_GETTER
+		iterator lower_bound(std::string_view key) noexcept
+		{
+			// (a binary search with three-way comparisons, so it can stop as soon as it finds the key)
+			size_type first = {};
+			size_type count = entries_.size();
+			while (count)
+			{
+				const size_type half = count / 2u;
+				const int cmp		 = std::string_view{ entries_[first + half].first }.compare(key);
+				if (cmp < 0)
+				{
+					first += half + 1u;
+					count -= half + 1u;
+				}
+				else if (cmp > 0)
+					count = half;
+				else
+				{
+					first += half;
+					break;
+				}
+			}
+			return entries_.begin() + static_cast<typename storage_type::difference_type>(first);
+		}
+
+		TOML_PURE_GETTER
+		const_iterator lower_bound(std::string_view key) const noexcept
+		{
+			return const_cast<flat_map&>(*this).lower_bound(key);
+		}
+
+		TOML_PURE_GETTER
+		iterator find(std::string_view key) noexcept
+		{
+			const auto it = lower_bound(key);
+			return it != entries_.end() && std::string_view{ it->first } == key ? it : entries_.end();
+		}
+
+		TOML_PURE_GETTER
+		const_iterator find(std::string_view key) const noexcept
+		{
+			return const_cast<flat_map&>(*this).find(key);
+		}
+
+		// inserts the entry at the hint if that's where it belongs, otherwise wherever it does belong (if the key
+		// isn't already there; if it is, nothing is inserted and the existing entry is returned).
+		template <typename K>
+		iterator emplace_hint(const_iterator hint, K&& key, T&& value)
+		{
+			const auto key_view = std::string_view{ key };
+			if ((hint == entries_.cbegin() || std::string_view{ (hint - 1)->first } < key_view)
+				&& (hint == entries_.cend() || key_view < std::string_view{ hint->first }))
+				return entries_.emplace(hint, static_cast<K&&>(key), std::move(value));
+
+			const auto it = lower_bound(key_view);
+			if (it != entries_.end() && std::string_view{ it->first } == key_view)
+				return it;
+			return entries_.emplace(it, static_cast<K&&>(key), std::move(value));
+		}
+
+		template <typename K>
+		std::pair<iterator, bool> insert_or_assign(K&& key, T&& value)
+		{
+			const auto key_view = std::string_view{ key };
+			const auto it		= lower_bound(key_view);
+			if (it != entries_.end() && std::string_view{ it->first } == key_view)
+			{
+				it->second = std::move(value);
+				return { it, false };
+			}
+			return { entries_.emplace(it, static_cast<K&&>(key), std::move(value)), true };
+		}
+
+		iterator erase(const_iterator pos) noexcept
+		{
+			return entries_.erase(pos);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) noexcept
+		{
+			return entries_.erase(first, last);
+		}
+	};
+}
+TOML_IMPL_NAMESPACE_END;
+
+/// \endcond
+#include "header_end.hpp"
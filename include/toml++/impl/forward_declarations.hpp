@@ -88,16 +88,31 @@ TOML_NAMESPACE_START
 	struct source_position;
 	struct source_region;
 
-	class node;
 	template <typename>
 	class node_view;
 
+	class key_pool;
+
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+
+	class node;
 	class key;
+
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenaarr, heaparr);
 	class array;
+	TOML_ABI_NAMESPACE_END;
+
+	TOML_ABI_NAMESPACE_BOOL(TOML_FLAT_TABLES, flattbl, stdtbl);
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenatbl, heaptbl);
 	class table;
+	TOML_ABI_NAMESPACE_END;
+	TOML_ABI_NAMESPACE_END;
+
 	template <typename>
 	class value;
 
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
+
 	class path;
 
 	class toml_formatter;
@@ -5,12 +5,271 @@
 #pragma once
 
 #include "source_region.hpp"
+#include "node_arena.hpp"
 #include "std_utility.hpp"
+#include "std_new.hpp"
+#include "std_atomic.hpp"
 #include "print_to_stream.hpp"
 #include "header_start.hpp"
 
+/// \cond
+TOML_IMPL_NAMESPACE_START
+{
+	// the characters of a key too long to be stored inline, shared by all the copies of that key (and, if it was
+	// interned, by every other key with the same text; see toml::key_pool).
+	// they're allocated like nodes are, so they come from the parser's arena (or a memory_resource_scope's) if one
+	// is active on the thread that creates them.
+	struct shared_key_chars
+	{
+		std::atomic<size_t> refs;
+		size_t length;
+
+		TOML_NODISCARD_CTOR
+		explicit shared_key_chars(size_t len) noexcept //
+			: refs{ 1u },
+			  length{ len }
+		{}
+
+		TOML_PURE_INLINE_GETTER
+		char* data() noexcept
+		{
+			return reinterpret_cast<char*>(this + 1);
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const char* data() const noexcept
+		{
+			return reinterpret_cast<const char*>(this + 1);
+		}
+
+		TOML_PURE_INLINE_GETTER
+		std::string_view view() const noexcept
+		{
+			return std::string_view{ data(), length };
+		}
+
+		TOML_CONST_INLINE_GETTER
+		static constexpr size_t allocation_size(size_t len) noexcept
+		{
+			return sizeof(shared_key_chars) + len + 1u;
+		}
+
+		TOML_NODISCARD
+		static shared_key_chars* create(std::string_view str)
+		{
+			const auto chars = ::new (node_allocate(allocation_size(str.length()))) shared_key_chars{ str.length() };
+			std::memcpy(chars->data(), str.data(), str.length());
+			chars->data()[str.length()] = '\0';
+			return chars;
+		}
+
+		void add_ref() noexcept
+		{
+			refs.fetch_add(1u, std::memory_order_relaxed);
+		}
+
+		void release() noexcept
+		{
+			if (refs.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+			{
+				const auto size = allocation_size(length);
+				this->~shared_key_chars();
+				node_deallocate(this, size);
+			}
+		}
+	};
+
+	// the string of a toml::key. short strings are stored inline, and longer ones in a shared_key_chars, so copying
+	// a key never allocates and every key is only 16 bytes. either way the string is null-terminated.
+	class key_string
+	{
+	  public:
+		static constexpr size_t max_inline_length = 15u;
+
+	  private:
+		static constexpr unsigned char shared_tag = 0xFFu;
+
+		// the last byte is max_inline_length minus the length of an inline string (so it doubles as the terminator of
+		// one that fills the whole buffer), or shared_tag if the buffer starts with a shared_key_chars*.
+		// unused bytes are always zero so two key_strings can be compared bytewise.
+		alignas(void*) unsigned char bytes_[max_inline_length + 1u];
+
+		TOML_PURE_INLINE_GETTER
+		unsigned char tag() const noexcept
+		{
+			return bytes_[max_inline_length];
+		}
+
+		TOML_PURE_INLINE_GETTER
+		shared_key_chars* shared() const noexcept
+		{
+			TOML_ASSERT_ASSUME(tag() == shared_tag);
+
+			shared_key_chars* chars;
+			std::memcpy(&chars, bytes_, sizeof(chars));
+			return chars;
+		}
+
+		void reset() noexcept
+		{
+			std::memset(bytes_, 0, sizeof(bytes_));
+			bytes_[max_inline_length] = static_cast<unsigned char>(max_inline_length);
+		}
+
+		void release() noexcept
+		{
+			if (tag() == shared_tag)
+				shared()->release();
+		}
+
+	  public:
+		TOML_NODISCARD_CTOR
+		key_string() noexcept
+		{
+			reset();
+		}
+
+		TOML_NODISCARD_CTOR
+		explicit key_string(std::string_view str)
+		{
+			reset();
+			if (str.length() <= max_inline_length)
+			{
+				if (!str.empty())
+					std::memcpy(bytes_, str.data(), str.length());
+				bytes_[max_inline_length] = static_cast<unsigned char>(max_inline_length - str.length());
+			}
+			else
+				*this = key_string{ shared_key_chars::create(str) };
+		}
+
+		// takes over a reference to the chars
+		TOML_NODISCARD_CTOR
+		explicit key_string(shared_key_chars* chars) noexcept
+		{
+			TOML_ASSERT_ASSUME(chars);
+			TOML_ASSERT(chars->length > max_inline_length);
+
+			reset();
+			std::memcpy(bytes_, &chars, sizeof(chars));
+			bytes_[max_inline_length] = shared_tag;
+		}
+
+		TOML_NODISCARD_CTOR
+		key_string(const key_string& other) noexcept
+		{
+			std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+			if (tag() == shared_tag)
+				shared()->add_ref();
+		}
+
+		TOML_NODISCARD_CTOR
+		key_string(key_string&& other) noexcept
+		{
+			std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+			other.reset();
+		}
+
+		key_string& operator=(const key_string& rhs) noexcept
+		{
+			if (&rhs != this)
+			{
+				if (rhs.tag() == shared_tag)
+					rhs.shared()->add_ref();
+				release();
+				std::memcpy(bytes_, rhs.bytes_, sizeof(bytes_));
+			}
+			return *this;
+		}
+
+		key_string& operator=(key_string&& rhs) noexcept
+		{
+			if (&rhs != this)
+			{
+				release();
+				std::memcpy(bytes_, rhs.bytes_, sizeof(bytes_));
+				rhs.reset();
+			}
+			return *this;
+		}
+
+		~key_string() noexcept
+		{
+			release();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		std::string_view view() const noexcept
+		{
+			if (tag() == shared_tag)
+				return shared()->view();
+			return std::string_view{ reinterpret_cast<const char*>(bytes_), max_inline_length - tag() };
+		}
+
+		TOML_PURE_INLINE_GETTER
+		bool empty() const noexcept
+		{
+			return tag() == max_inline_length;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		friend bool operator==(const key_string& lhs, const key_string& rhs) noexcept
+		{
+			// identical bytes are either identical inline strings or the same shared chars (e.g. two keys interned from
+			// the same pool); otherwise they can only be equal if they're both shared, since short strings never are
+			if (std::memcmp(lhs.bytes_, rhs.bytes_, sizeof(bytes_)) == 0)
+				return true;
+			return lhs.tag() == shared_tag && rhs.tag() == shared_tag && lhs.view() == rhs.view();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		friend bool operator!=(const key_string& lhs, const key_string& rhs) noexcept
+		{
+			return !(lhs == rhs);
+		}
+	};
+	static_assert(sizeof(key_string) == 16u);
+
+	// where a key was defined. keys inherit it so that it takes up no space at all when they don't record one
+	// (see TOML_ENABLE_SOURCES).
+	struct key_source
+	{
+#if TOML_ENABLE_SOURCES
+
+		source_region source_;
+
+		TOML_NODISCARD_CTOR
+		key_source() noexcept = default;
+
+		TOML_NODISCARD_CTOR
+		key_source(source_region&& src) noexcept //
+			: source_{ std::move(src) }
+		{}
+
+		TOML_NODISCARD_CTOR
+		key_source(const source_region& src) noexcept //
+			: source_{ src }
+		{}
+
+#else
+
+		TOML_NODISCARD_CTOR
+		key_source() noexcept = default;
+
+		TOML_NODISCARD_CTOR
+		key_source(const source_region&) noexcept
+		{}
+
+#endif
+	};
+}
+TOML_IMPL_NAMESPACE_END;
+/// \endcond
+
 TOML_NAMESPACE_START
 {
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+
 	/// \brief A key parsed from a TOML document.
 	///
 	/// \detail These are used as the internal keys for a toml::table: \cpp
@@ -28,11 +287,10 @@ TOML_NAMESPACE_START
 	/// key 'b' defined at line 3, column 7
 	/// key 'c' defined at line 4, column 9
 	/// \eout
-	class key
+	class TOML_EMPTY_BASES key : impl::key_source
 	{
 	  private:
-		std::string key_;
-		source_region source_;
+		impl::key_string key_;
 
 	  public:
 		/// \brief	Default constructor.
@@ -42,43 +300,47 @@ TOML_NAMESPACE_START
 		/// \brief	Constructs a key from a string view and source region.
 		TOML_NODISCARD_CTOR
 		explicit key(std::string_view k, source_region&& src = {}) //
-			: key_{ k },
-			  source_{ std::move(src) }
+			: impl::key_source{ std::move(src) },
+			  key_{ k }
 		{}
 
 		/// \brief	Constructs a key from a string view and source region.
 		TOML_NODISCARD_CTOR
 		explicit key(std::string_view k, const source_region& src) //
-			: key_{ k },
-			  source_{ src }
+			: impl::key_source{ src },
+			  key_{ k }
 		{}
 
 		/// \brief	Constructs a key from a string and source region.
 		TOML_NODISCARD_CTOR
-		explicit key(std::string&& k, source_region&& src = {}) noexcept //
-			: key_{ std::move(k) },
-			  source_{ std::move(src) }
-		{}
+		explicit key(std::string&& k, source_region&& src = {}) //
+			: impl::key_source{ std::move(src) },
+			  key_{ std::string_view{ k } }
+		{
+			k.clear(); // (as if it had been moved from)
+		}
 
 		/// \brief	Constructs a key from a string and source region.
 		TOML_NODISCARD_CTOR
-		explicit key(std::string&& k, const source_region& src) noexcept //
-			: key_{ std::move(k) },
-			  source_{ src }
-		{}
+		explicit key(std::string&& k, const source_region& src) //
+			: impl::key_source{ src },
+			  key_{ std::string_view{ k } }
+		{
+			k.clear(); // (as if it had been moved from)
+		}
 
 		/// \brief	Constructs a key from a c-string and source region.
 		TOML_NODISCARD_CTOR
 		explicit key(const char* k, source_region&& src = {}) //
-			: key_{ k },
-			  source_{ std::move(src) }
+			: impl::key_source{ std::move(src) },
+			  key_{ std::string_view{ k } }
 		{}
 
 		/// \brief	Constructs a key from a c-string view and source region.
 		TOML_NODISCARD_CTOR
 		explicit key(const char* k, const source_region& src) //
-			: key_{ k },
-			  source_{ src }
+			: impl::key_source{ src },
+			  key_{ std::string_view{ k } }
 		{}
 
 #if TOML_ENABLE_WINDOWS_COMPAT
@@ -88,8 +350,8 @@ TOML_NAMESPACE_START
 		/// \availability This constructor is only available when #TOML_ENABLE_WINDOWS_COMPAT is enabled.
 		TOML_NODISCARD_CTOR
 		explicit key(std::wstring_view k, source_region&& src = {}) //
-			: key_{ impl::narrow(k) },
-			  source_{ std::move(src) }
+			: impl::key_source{ std::move(src) },
+			  key_{ std::string_view{ impl::narrow(k) } }
 		{}
 
 		/// \brief	Constructs a key from a wide string and source region.
@@ -97,12 +359,22 @@ TOML_NAMESPACE_START
 		/// \availability This constructor is only available when #TOML_ENABLE_WINDOWS_COMPAT is enabled.
 		TOML_NODISCARD_CTOR
 		explicit key(std::wstring_view k, const source_region& src) //
-			: key_{ impl::narrow(k) },
-			  source_{ src }
+			: impl::key_source{ src },
+			  key_{ std::string_view{ impl::narrow(k) } }
 		{}
 
 #endif
 
+		/// \cond
+
+		TOML_NODISCARD_CTOR
+		explicit key(impl::key_string&& k, source_region&& src) noexcept //
+			: impl::key_source{ std::move(src) },
+			  key_{ std::move(k) }
+		{}
+
+		/// \endcond
+
 		/// \name String operations
 		/// @{
 
@@ -110,7 +382,7 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		std::string_view str() const noexcept
 		{
-			return std::string_view{ key_ };
+			return key_.view();
 		}
 
 		/// \brief	Returns a view of the key's underlying string.
@@ -131,14 +403,14 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		const char* data() const noexcept
 		{
-			return key_.data();
+			return key_.view().data();
 		}
 
 		/// \brief	Returns the length of the key's underlying string.
 		TOML_PURE_INLINE_GETTER
 		size_t length() const noexcept
 		{
-			return key_.length();
+			return key_.view().length();
 		}
 
 		/// @}
@@ -147,10 +419,16 @@ TOML_NAMESPACE_START
 		/// @{
 
 		/// \brief	Returns the source region responsible for specifying this key during parsing.
+		///
+		/// \remarks This is always empty if #TOML_ENABLE_SOURCES is `0`.
 		TOML_PURE_INLINE_GETTER
 		const source_region& source() const noexcept
 		{
+#if TOML_ENABLE_SOURCES
 			return source_;
+#else
+			return impl::empty_source_region();
+#endif
 		}
 
 		/// @}
@@ -177,112 +455,112 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<(const key& lhs, const key& rhs) noexcept
 		{
-			return lhs.key_ < rhs.key_;
+			return lhs.str() < rhs.str();
 		}
 
 		/// \brief	Returns true if `lhs.str() <= rhs.str()`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<=(const key& lhs, const key& rhs) noexcept
 		{
-			return lhs.key_ <= rhs.key_;
+			return lhs.str() <= rhs.str();
 		}
 
 		/// \brief	Returns true if `lhs.str() > rhs.str()`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>(const key& lhs, const key& rhs) noexcept
 		{
-			return lhs.key_ > rhs.key_;
+			return lhs.str() > rhs.str();
 		}
 
 		/// \brief	Returns true if `lhs.str() >= rhs.str()`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>=(const key& lhs, const key& rhs) noexcept
 		{
-			return lhs.key_ >= rhs.key_;
+			return lhs.str() >= rhs.str();
 		}
 
 		/// \brief	Returns true if `lhs.str() == rhs`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator==(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ == rhs;
+			return lhs.str() == rhs;
 		}
 
 		/// \brief	Returns true if `lhs.str() != rhs`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator!=(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ != rhs;
+			return lhs.str() != rhs;
 		}
 
 		/// \brief	Returns true if `lhs.str() < rhs`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ < rhs;
+			return lhs.str() < rhs;
 		}
 
 		/// \brief	Returns true if `lhs.str() <= rhs`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<=(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ <= rhs;
+			return lhs.str() <= rhs;
 		}
 
 		/// \brief	Returns true if `lhs.str() > rhs`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ > rhs;
+			return lhs.str() > rhs;
 		}
 
 		/// \brief	Returns true if `lhs.str() >= rhs`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>=(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ >= rhs;
+			return lhs.str() >= rhs;
 		}
 
 		/// \brief	Returns true if `lhs == rhs.str()`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator==(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs == rhs.key_;
+			return lhs == rhs.str();
 		}
 
 		/// \brief	Returns true if `lhs != rhs.str()`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator!=(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs != rhs.key_;
+			return lhs != rhs.str();
 		}
 
 		/// \brief	Returns true if `lhs < rhs.str()`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs < rhs.key_;
+			return lhs < rhs.str();
 		}
 
 		/// \brief	Returns true if `lhs <= rhs.str()`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<=(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs <= rhs.key_;
+			return lhs <= rhs.str();
 		}
 
 		/// \brief	Returns true if `lhs > rhs.str()`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs > rhs.key_;
+			return lhs > rhs.str();
 		}
 
 		/// \brief	Returns true if `lhs >= rhs.str()`.
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>=(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs >= rhs.key_;
+			return lhs >= rhs.str();
 		}
 
 		/// @}
@@ -300,14 +578,14 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		const_iterator begin() const noexcept
 		{
-			return key_.data();
+			return data();
 		}
 
 		/// \brief Returns an iterator to one-past-the-last character in the key's backing string.
 		TOML_PURE_INLINE_GETTER
 		const_iterator end() const noexcept
 		{
-			return key_.data() + key_.length();
+			return data() + length();
 		}
 
 		/// @}
@@ -315,11 +593,13 @@ TOML_NAMESPACE_START
 		/// \brief	Prints the key's underlying string out to the stream.
 		friend std::ostream& operator<<(std::ostream& lhs, const key& rhs)
 		{
-			impl::print_to_stream(lhs, rhs.key_);
+			impl::print_to_stream(lhs, rhs.str());
 			return lhs;
 		}
 	};
 
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
+
 	/// \brief	Metafunction for determining if a type is, or is a reference to, a toml::key.
 	template <typename T>
 	inline constexpr bool is_key = std::is_same_v<impl::remove_cvref<T>, toml::key>;
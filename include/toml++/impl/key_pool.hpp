@@ -0,0 +1,85 @@
+//# This file is a part of toml++ and is subject to the the terms of the MIT license.
+//# Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+//# See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "key.hpp"
+#include "header_start.hpp"
+
+/// \cond
+TOML_IMPL_NAMESPACE_START
+{
+	struct key_pool_state;
+}
+TOML_IMPL_NAMESPACE_END;
+/// \endcond
+
+TOML_NAMESPACE_START
+{
+	/// \brief	A pool of interned key strings, for sharing the storage of identical keys between documents.
+	///
+	/// \detail Keys longer than 15 characters need heap storage of their own, and in documents with lots of similar
+	///			tables (e.g. arrays of tables) the same ones turn up over and over again. The parser already shares
+	///			the storage of identical keys within a document; give it a key_pool (see
+	///			toml::parse_options::interned_keys) to share it between documents too: \cpp
+	/// toml::key_pool pool;
+	///
+	/// toml::parse_options options;
+	/// options.interned_keys = &pool;
+	///
+	/// auto a = toml::parse(R"(product_description = "left")"sv, options);
+	/// auto b = toml::parse(R"(product_description = "right")"sv, options);
+	///
+	/// std::cout << (a.begin()->first.data() == b.begin()->first.data()) << "\n";
+	/// \ecpp
+	/// \out
+	/// true
+	/// \eout
+	///
+	/// \remarks A key_pool may be used by any number of threads at once; its strings are spread over several
+	///			separately-locked sets, and the parser only asks it for each distinct key once per document.
+	///			Keys made from one don't depend on it; they stay valid (and keep sharing their storage with each
+	///			other) after it has been cleared or destroyed. Each string is freed once neither the pool nor any key
+	///			still refers to it. The pool's own storage always comes from the global heap.
+	class TOML_EXPORTED_CLASS key_pool
+	{
+	  private:
+		/// \cond
+		friend class TOML_PARSER_TYPENAME;
+		/// \endcond
+
+		impl::key_pool_state* state_;
+
+	  public:
+		/// \brief	Default constructor.
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		key_pool();
+
+		/// \brief	Destructor.
+		TOML_EXPORTED_MEMBER_FUNCTION
+		~key_pool() noexcept;
+
+		TOML_DELETE_DEFAULTS(key_pool);
+
+		/// \brief	Makes a key, sharing its storage with every other key made from this pool with the same string.
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		key intern(std::string_view k, source_region&& src = {});
+
+		/// \brief	Returns the number of strings in the pool.
+		///
+		/// \remarks Keys short enough to be stored inline aren't counted, since they're never pooled.
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		size_t size() const noexcept;
+
+		/// \brief	Removes all the strings from the pool.
+		TOML_EXPORTED_MEMBER_FUNCTION
+		void clear() noexcept;
+	};
+}
+TOML_NAMESPACE_END;
+
+#include "header_end.hpp"
@@ -0,0 +1,211 @@
+//# This file is a part of toml++ and is subject to the the terms of the MIT license.
+//# Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+//# See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+//# {{
+#include "preprocessor.hpp"
+#if !TOML_IMPLEMENTATION
+#error This is an implementation-only header.
+#endif
+//# }}
+
+#include "key_pool.hpp"
+#include "node_arena.inl"
+#include "linear_probing.inl"
+#include "std_vector.hpp"
+TOML_DISABLE_WARNINGS;
+#include <climits>
+#include <mutex>
+TOML_ENABLE_WARNINGS;
+#include "header_start.hpp"
+
+TOML_IMPL_NAMESPACE_START
+{
+	// a set of shared_key_chars (each holding a reference), with open addressing and linear probing.
+	// used directly by the parser to intern the keys of a document (with its buffer_allocator), and by toml::key_pool.
+	template <typename Allocator>
+	class key_set
+	{
+	  private:
+		using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<shared_key_chars*>;
+
+		struct slot_traits
+		{
+			TOML_PURE_INLINE_GETTER
+			static bool empty(const shared_key_chars* chars) noexcept
+			{
+				return !chars;
+			}
+
+			TOML_PURE_INLINE_GETTER
+			static size_t hash(const shared_key_chars* chars) noexcept
+			{
+				return key_set::hash(chars->view());
+			}
+		};
+		using probing = linear_probing<shared_key_chars*, slot_traits>;
+
+		std::vector<shared_key_chars*, slot_allocator> slots_;
+		size_t size_ = {};
+
+		void grow()
+		{
+			std::vector<shared_key_chars*, slot_allocator> slots(probing::grown_capacity(slots_.size()),
+																 nullptr,
+																 slots_.get_allocator());
+			probing::rehash(slots_.data(), slots_.size(), slots.data(), slots.size() - 1u);
+			slots_ = std::move(slots);
+		}
+
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit key_set(const Allocator& alloc = {}) noexcept //
+			: slots_(slot_allocator{ alloc })
+		{}
+
+		~key_set() noexcept
+		{
+			clear();
+		}
+
+		TOML_DELETE_DEFAULTS(key_set);
+
+		TOML_PURE_INLINE_GETTER
+		static size_t hash(std::string_view str) noexcept
+		{
+			return std::hash<std::string_view>{}(str);
+		}
+
+		// returns the string's shared_key_chars (with a new reference), calling create(str) to make one (with a
+		// reference for the set) if it isn't in the set yet. str must be too long to be stored inline.
+		template <typename Create>
+		TOML_NODISCARD
+		shared_key_chars* intern(std::string_view str, size_t str_hash, Create&& create)
+		{
+			TOML_ASSERT_ASSUME(str.length() > key_string::max_inline_length);
+
+			if (probing::needs_growth(size_, slots_.size()))
+				grow();
+
+			auto& slot = probing::find(slots_.data(),
+									   slots_.size() - 1u,
+									   str_hash,
+									   [=](const shared_key_chars* chars) noexcept { return chars->view() == str; });
+			if (!slot)
+			{
+				slot = static_cast<Create&&>(create)(str);
+				size_++;
+			}
+
+			slot->add_ref();
+			return slot;
+		}
+
+		TOML_NODISCARD
+		key_string intern(std::string_view str)
+		{
+			if (str.length() <= key_string::max_inline_length)
+				return key_string{ str };
+
+			return key_string{ intern(str, hash(str), shared_key_chars::create) };
+		}
+
+		TOML_PURE_INLINE_GETTER
+		size_t size() const noexcept
+		{
+			return size_;
+		}
+
+		void clear() noexcept
+		{
+			for (const auto chars : slots_)
+				if (chars)
+					chars->release();
+			slots_.clear();
+			size_ = {};
+		}
+	};
+
+	// a key_pool's strings are spread over a number of separately-locked sets, so threads parsing different documents
+	// with the same pool don't all queue up behind one mutex.
+	struct key_pool_state
+	{
+		static constexpr size_t shard_count = 16u;
+
+		struct shard
+		{
+			mutable std::mutex mutex;
+			key_set<std::allocator<char>> keys;
+		};
+		shard shards[shard_count];
+
+		// (the sets use the low bits of the hash, so the shard is picked with the high ones)
+		TOML_PURE_INLINE_GETTER
+		shard& shard_for(size_t hash) noexcept
+		{
+			return shards[(hash >> (sizeof(size_t) * CHAR_BIT - 4u)) % shard_count];
+		}
+
+		// see key_set::intern()
+		// (the pool's strings outlive the documents that intern them, so they never come from a document's arena)
+		TOML_NODISCARD
+		shared_key_chars* intern(std::string_view str, size_t hash)
+		{
+			auto& s = shard_for(hash);
+			std::lock_guard<std::mutex> lock{ s.mutex };
+			const node_heap_scope heap;
+			return s.keys.intern(str, hash, shared_key_chars::create);
+		}
+	};
+}
+TOML_IMPL_NAMESPACE_END;
+
+TOML_NAMESPACE_START
+{
+	TOML_EXTERNAL_LINKAGE
+	key_pool::key_pool() //
+		: state_{ new impl::key_pool_state }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	key_pool::~key_pool() noexcept
+	{
+		delete state_;
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	key key_pool::intern(std::string_view k, source_region&& src)
+	{
+		if (k.length() <= impl::key_string::max_inline_length)
+			return key{ k, std::move(src) };
+
+		return key{ impl::key_string{ state_->intern(k, impl::key_set<std::allocator<char>>::hash(k)) }, std::move(src) };
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	size_t key_pool::size() const noexcept
+	{
+		size_t total = {};
+		for (auto& s : state_->shards)
+		{
+			std::lock_guard<std::mutex> lock{ s.mutex };
+			total += s.keys.size();
+		}
+		return total;
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	void key_pool::clear() noexcept
+	{
+		for (auto& s : state_->shards)
+		{
+			std::lock_guard<std::mutex> lock{ s.mutex };
+			s.keys.clear();
+		}
+	}
+}
+TOML_NAMESPACE_END;
+
+#include "header_end.hpp"
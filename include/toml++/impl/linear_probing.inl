@@ -0,0 +1,104 @@
+//# This file is a part of toml++ and is subject to the the terms of the MIT license.
+//# Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+//# See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+//# {{
+#include "preprocessor.hpp"
+#if !TOML_IMPLEMENTATION
+#error This is an implementation-only header.
+#endif
+//# }}
+
+#include "forward_declarations.hpp"
+#include "header_start.hpp"
+
+TOML_IMPL_NAMESPACE_START
+{
+	// the probing, growth and deletion logic of the library's open-addressing hash sets (impl::key_set,
+	// impl::table_index and the parser's node_set and value_key_set). each of them owns its own power-of-two array of
+	// slots (allocated however suits it), and describes those slots with a Traits type:
+	//
+	//	static bool empty(const Slot&) noexcept;	// whether the slot is unused (a value-initialized Slot must be)
+	//	static size_t hash(const Slot&) noexcept;	// the hash the slot's contents were placed with
+	template <typename Slot, typename Traits>
+	struct linear_probing
+	{
+		static constexpr size_t min_capacity = 16u;
+
+		// (sets are kept at most half full)
+		TOML_CONST_INLINE_GETTER
+		static constexpr bool needs_growth(size_t count, size_t capacity) noexcept
+		{
+			return (count + 1u) * 2u > capacity;
+		}
+
+		TOML_CONST_INLINE_GETTER
+		static constexpr size_t grown_capacity(size_t capacity) noexcept
+		{
+			return capacity ? capacity * 2u : min_capacity;
+		}
+
+		// the capacity needed to hold count slots without growing
+		TOML_CONST_GETTER
+		static constexpr size_t capacity_for(size_t count) noexcept
+		{
+			size_t capacity = min_capacity;
+			while (capacity < count * 2u)
+				capacity *= 2u;
+			return capacity;
+		}
+
+		// the first slot along the probe sequence of hash h for which is_match returns true, or the empty slot that
+		// ends the sequence if it never does
+		template <typename Match>
+		TOML_NODISCARD
+		static Slot& find(Slot* slots, size_t mask, size_t h, Match&& is_match) noexcept
+		{
+			for (size_t i = h & mask;; i = (i + 1u) & mask)
+				if (Traits::empty(slots[i]) || static_cast<Match&&>(is_match)(static_cast<const Slot&>(slots[i])))
+					return slots[i];
+		}
+
+		// puts something that isn't in the set yet into the first empty slot along its probe sequence
+		static Slot& place(Slot* slots, size_t mask, Slot&& s) noexcept
+		{
+			size_t i = Traits::hash(s) & mask;
+			while (!Traits::empty(slots[i]))
+				i = (i + 1u) & mask;
+			slots[i] = static_cast<Slot&&>(s);
+			return slots[i];
+		}
+
+		// moves everything from one array of slots into another (empty) one
+		static void rehash(Slot* from, size_t from_capacity, Slot* to, size_t to_mask) noexcept
+		{
+			for (size_t i = 0; i < from_capacity; i++)
+				if (!Traits::empty(from[i]))
+					place(to, to_mask, static_cast<Slot&&>(from[i]));
+		}
+
+		// empties an occupied slot. rather than leaving a tombstone, anything after it that could no longer be found
+		// is shifted back, so lookups always stop at the first empty slot.
+		static void erase(Slot* slots, size_t mask, Slot& erased) noexcept
+		{
+			TOML_ASSERT_ASSUME(!Traits::empty(erased));
+
+			auto i = static_cast<size_t>(&erased - slots);
+			for (size_t j = (i + 1u) & mask; !Traits::empty(slots[j]); j = (j + 1u) & mask)
+			{
+				// (slots[j] can fill the gap unless its home slot lies (cyclically) after the gap)
+				if (((j - (Traits::hash(slots[j]) & mask)) & mask) >= ((j - i) & mask))
+				{
+					slots[i] = static_cast<Slot&&>(slots[j]);
+					i		 = j;
+				}
+			}
+			slots[i] = Slot{};
+		}
+	};
+}
+TOML_IMPL_NAMESPACE_END;
+
+#include "header_end.hpp"
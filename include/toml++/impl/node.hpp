@@ -7,6 +7,7 @@
 #include "std_utility.hpp"
 #include "forward_declarations.hpp"
 #include "source_region.hpp"
+#include "node_arena.hpp"
 #include "header_start.hpp"
 
 // workaround for this: https://github.com/marzer/tomlplusplus/issues/220
@@ -21,6 +22,8 @@
 
 TOML_NAMESPACE_START
 {
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+
 	/// \brief	A TOML node.
 	///
 	/// \detail A parsed TOML document forms a tree made up of tables, arrays and values.
@@ -31,7 +34,9 @@ TOML_NAMESPACE_START
 		/// \cond
 
 		friend class TOML_PARSER_TYPENAME;
+#if TOML_ENABLE_SOURCES
 		source_region source_{};
+#endif
 
 		template <typename T>
 		TOML_NODISCARD
@@ -146,6 +151,31 @@ TOML_NAMESPACE_START
 		TOML_EXPORTED_MEMBER_FUNCTION
 		virtual ~node() noexcept;
 
+		/// \cond
+
+		// (see parse_options::use_arena)
+		TOML_NODISCARD
+		static void* operator new(size_t size)
+		{
+			return impl::node_allocate(size);
+		}
+
+		static void operator delete(void* ptr, size_t size) noexcept
+		{
+			impl::node_deallocate(ptr, size);
+		}
+
+		TOML_NODISCARD
+		static void* operator new(size_t, void* ptr) noexcept
+		{
+			return ptr;
+		}
+
+		static void operator delete(void*, void*) noexcept
+		{}
+
+		/// \endcond
+
 		/// \name Type checks
 		/// @{
 
@@ -736,10 +766,16 @@ TOML_NAMESPACE_START
 		/// @{
 
 		/// \brief	Returns the source region responsible for generating this node during parsing.
+		///
+		/// \remarks This is always empty if #TOML_ENABLE_SOURCES is `0`.
 		TOML_PURE_INLINE_GETTER
 		const source_region& source() const noexcept
 		{
+#if TOML_ENABLE_SOURCES
 			return source_;
+#else
+			return impl::empty_source_region();
+#endif
 		}
 
 		/// @}
@@ -1115,6 +1151,8 @@ TOML_NAMESPACE_START
 
 		/// @}
 	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
 }
 TOML_NAMESPACE_END;
 
@@ -29,8 +29,15 @@ TOML_NAMESPACE_START
 
 	TOML_EXTERNAL_LINKAGE
 	node::node(node && other) noexcept //
-		: source_{ std::exchange(other.source_, {}) }
-	{}
+	{
+#if TOML_ENABLE_SOURCES
+		// (copied rather than moved so the path is owned again if it was borrowed from the document other was in)
+		source_		  = other.source_;
+		other.source_ = {};
+#else
+		TOML_UNUSED(other);
+#endif
+	}
 
 	TOML_EXTERNAL_LINKAGE
 	node::node(const node& /*other*/) noexcept
@@ -47,15 +54,25 @@ TOML_NAMESPACE_START
 		//
 		// see https://github.com/marzer/tomlplusplus/issues/49#issuecomment-665089577
 
+#if TOML_ENABLE_SOURCES
 		source_ = {};
+#endif
 		return *this;
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	node& node::operator=(node&& rhs) noexcept
 	{
+#if TOML_ENABLE_SOURCES
 		if (&rhs != this)
-			source_ = std::exchange(rhs.source_, {});
+		{
+			// (see the move constructor)
+			source_		= rhs.source_;
+			rhs.source_ = {};
+		}
+#else
+		TOML_UNUSED(rhs);
+#endif
 		return *this;
 	}
 
@@ -0,0 +1,130 @@
+//# This file is a part of toml++ and is subject to the the terms of the MIT license.
+//# Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+//# See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "forward_declarations.hpp"
+#include "std_memory_resource.hpp"
+#include "header_start.hpp"
+/// \cond
+
+TOML_IMPL_NAMESPACE_START
+{
+	// (nodes allocated with and without arenas can't be freed by each other's node_deallocate)
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenas, noarenas);
+
+	class node_arena;
+
+	// nodes, and the storage of tables and arrays, are allocated with these. while the parser has an arena active on
+	// the current thread (see parse_options::use_arena) they come from that; otherwise from the global heap.
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	void* TOML_CALLCONV node_allocate(size_t size);
+
+	TOML_EXPORTED_FREE_FUNCTION
+	void TOML_CALLCONV node_deallocate(void* ptr, size_t size) noexcept;
+
+	template <typename T>
+	struct node_allocator
+	{
+		static_assert(alignof(T) <= 8u, "node_allocator can only allocate types with an alignment of 8 or less");
+
+		using value_type = T;
+
+		node_allocator() noexcept = default;
+
+		template <typename U>
+		constexpr node_allocator(const node_allocator<U>&) noexcept
+		{}
+
+		TOML_NODISCARD
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(node_allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T* ptr, size_t n) noexcept
+		{
+			node_deallocate(ptr, n * sizeof(T));
+		}
+
+		template <typename U>
+		TOML_CONST_INLINE_GETTER
+		friend constexpr bool operator==(node_allocator, node_allocator<U>) noexcept
+		{
+			return true;
+		}
+
+		template <typename U>
+		TOML_CONST_INLINE_GETTER
+		friend constexpr bool operator!=(node_allocator, node_allocator<U>) noexcept
+		{
+			return false;
+		}
+	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_ARENA
+}
+TOML_IMPL_NAMESPACE_END;
+
+/// \endcond
+
+#if TOML_HAS_MEMORY_RESOURCE
+
+TOML_NAMESPACE_START
+{
+	/// \brief	Makes a `std::pmr::memory_resource` the source of new nodes on the current thread.
+	///
+	/// \detail While one of these is alive, nodes created on the thread that created it (along with the storage of
+	///			any tables and arrays they're put in) are allocated from an arena that gets its memory from the
+	///			resource. That includes documents parsed on that thread, unless their toml::parse_options say otherwise.
+	///
+	/// \cpp
+	/// std::pmr::monotonic_buffer_resource resource;
+	/// {
+	/// 	toml::memory_resource_scope scope{ &resource };
+	///
+	/// 	toml::table tbl{ { "a", 1 }, { "b", toml::array{ 2, 3 } } };
+	/// 	tbl.insert("c", toml::parse("d = 4"sv)); // (a table from the document is moved into tbl)
+	/// 	std::cout << tbl << "\n";
+	/// }
+	/// \ecpp
+	///
+	/// \out
+	/// a = 1
+	/// b = [ 2, 3 ]
+	///
+	/// [c]
+	/// d = 4
+	/// \eout
+	///
+	/// \remarks Scopes must be destroyed on the thread that created them, in the reverse order they were created.
+	///			The resource must outlive every node allocated from it, and be thread-safe if any of them are destroyed
+	///			on other threads. Keys long enough to need storage of their own come from the resource too
+	///			(unless they're interned in a toml::key_pool), but strings that long are allocated as usual.
+	///			Has no effect if #TOML_ENABLE_ARENA is `0` (the default).
+	class TOML_EXPORTED_CLASS memory_resource_scope
+	{
+	  private:
+		impl::node_arena* arena_;
+		impl::node_arena* prev_;
+
+	  public:
+		/// \brief	Starts allocating nodes on the current thread from a memory resource.
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		explicit memory_resource_scope(std::pmr::memory_resource* resource);
+
+		/// \brief	Goes back to allocating nodes the way they were before the scope was created.
+		TOML_EXPORTED_MEMBER_FUNCTION
+		~memory_resource_scope() noexcept;
+
+		TOML_DELETE_DEFAULTS(memory_resource_scope);
+	};
+}
+TOML_NAMESPACE_END;
+
+#endif // TOML_HAS_MEMORY_RESOURCE
+
+#include "header_end.hpp"
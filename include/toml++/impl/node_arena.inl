@@ -0,0 +1,374 @@
+//# This file is a part of toml++ and is subject to the the terms of the MIT license.
+//# Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+//# See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+//# {{
+#include "preprocessor.hpp"
+#if !TOML_IMPLEMENTATION
+#error This is an implementation-only header.
+#endif
+//# }}
+
+#include "node_arena.hpp"
+TOML_DISABLE_WARNINGS;
+#include <atomic>
+TOML_ENABLE_WARNINGS;
+#include "header_start.hpp"
+
+TOML_ANON_NAMESPACE_START
+{
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	impl::node_arena*& active_node_arena() noexcept
+	{
+		static thread_local impl::node_arena* arena = {};
+		return arena;
+	}
+
+	// frees counted by a node_free_batch on the current thread that haven't been settled with their arena yet
+	struct pending_node_frees
+	{
+		impl::node_arena* arena;
+		size_t count;
+		size_t batches;
+	};
+
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	pending_node_frees& pending_frees() noexcept
+	{
+		static thread_local pending_node_frees frees = {};
+		return frees;
+	}
+}
+TOML_ANON_NAMESPACE_END;
+
+TOML_IMPL_NAMESPACE_START
+{
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenas, noarenas);
+
+	// a monotonic arena owned by a parser (or a memory_resource_scope). allocations are pointer-bumps out of large
+	// blocks, and rather than being freed one at a time the blocks are all released together once the owner is done
+	// with the arena and everything allocated from it has been freed (by whichever thread gets there last).
+	//
+	// every allocation (including those from the global heap) starts with a header holding a pointer to the arena it
+	// came from, or null if it didn't come from one. that way it can all be freed without knowing where it came from,
+	// which means nodes can be moved freely between documents (or out of them entirely).
+	class node_arena
+	{
+	  private:
+		struct block
+		{
+			block* next;
+			size_t size;
+		};
+
+		// (a pointer, padded to keep allocations 8-byte aligned on 32-bit targets)
+		static constexpr size_t header_size		 = 8u;
+		static constexpr size_t first_block_size = 16u * 1024u;
+		static constexpr size_t max_block_size	 = 1024u * 1024u;
+		static_assert(sizeof(node_arena*) <= header_size);
+		static_assert(sizeof(block) % 8u == 0u);
+
+		// the owner's allocations aren't counted atomically; instead this is added to the balance up front, and
+		// swapped for the real count once the owner is done allocating.
+		static constexpr ptrdiff_t owner_bias = (std::numeric_limits<ptrdiff_t>::max)() / 2;
+
+		block* blocks_			= {};
+		char* pos_				= {};
+		char* end_				= {};
+		size_t next_block_size_ = first_block_size;
+		size_t allocations_		= {};
+		std::atomic<ptrdiff_t> balance_{ owner_bias };
+#if TOML_HAS_MEMORY_RESOURCE
+		std::pmr::memory_resource* upstream_ = {};
+#endif
+
+		node_arena() noexcept = default;
+
+		TOML_NODISCARD
+		void* allocate_upstream(size_t size)
+		{
+#if TOML_HAS_MEMORY_RESOURCE
+			if (upstream_)
+				return upstream_->allocate(size, alignof(std::max_align_t));
+#endif
+			return ::operator new(size);
+		}
+
+		void deallocate_upstream(void* ptr, size_t size) noexcept
+		{
+#if TOML_HAS_MEMORY_RESOURCE
+			if (upstream_)
+				return upstream_->deallocate(ptr, size, alignof(std::max_align_t));
+#endif
+			TOML_UNUSED(size);
+			::operator delete(ptr);
+		}
+
+		void destroy() noexcept
+		{
+			while (blocks_)
+			{
+				const auto blk = std::exchange(blocks_, blocks_->next);
+				deallocate_upstream(blk, blk->size);
+			}
+
+#if TOML_HAS_MEMORY_RESOURCE
+			if (const auto upstream = upstream_)
+			{
+				this->~node_arena();
+				upstream->deallocate(this, sizeof(node_arena), alignof(node_arena));
+				return;
+			}
+#endif
+			delete this;
+		}
+
+		TOML_NEVER_INLINE
+		char* allocate_block(size_t size)
+		{
+			// big allocations get a block of their own so the rest of the current one isn't wasted
+			const bool dedicated	= size > next_block_size_ / 4u;
+			const size_t block_size = dedicated ? sizeof(block) + size : next_block_size_;
+
+			blocks_		= ::new (allocate_upstream(block_size)) block{ blocks_, block_size };
+			const auto data = reinterpret_cast<char*>(blocks_ + 1);
+			if (dedicated)
+				return data;
+
+			pos_ = data + size;
+			end_ = reinterpret_cast<char*>(blocks_) + block_size;
+			if (next_block_size_ < max_block_size)
+				next_block_size_ *= 2u;
+			return data;
+		}
+
+	  public:
+		TOML_DELETE_DEFAULTS(node_arena);
+
+		TOML_NODISCARD
+		static node_arena* create()
+		{
+			return new node_arena;
+		}
+
+#if TOML_HAS_MEMORY_RESOURCE
+
+		// (the arena itself comes from the resource too)
+		TOML_NODISCARD
+		static node_arena* create(std::pmr::memory_resource* upstream)
+		{
+			if (!upstream)
+				return create();
+
+			const auto arena = ::new (upstream->allocate(sizeof(node_arena), alignof(node_arena))) node_arena;
+			arena->upstream_ = upstream;
+			return arena;
+		}
+
+#endif
+
+		// a new arena getting its memory from the same place as this one
+		TOML_NODISCARD
+		node_arena* create_next() const
+		{
+#if TOML_HAS_MEMORY_RESOURCE
+			return create(upstream_);
+#else
+			return create();
+#endif
+		}
+
+		// takes count frees off the balance (destroying the arena if that was the last of its allocations)
+		void settle(size_t count) noexcept
+		{
+			const auto frees = static_cast<ptrdiff_t>(count);
+			if (balance_.fetch_sub(frees, std::memory_order_acq_rel) == frees)
+				destroy();
+		}
+
+		// called by the owner once it's done allocating
+		void release() noexcept
+		{
+			const auto delta = static_cast<ptrdiff_t>(allocations_) - owner_bias;
+			if (balance_.fetch_add(delta, std::memory_order_acq_rel) + delta == 0)
+				destroy();
+		}
+
+		TOML_NODISCARD
+		void* allocate(size_t size)
+		{
+			size = (header_size + size + 7u) & ~size_t{ 7u };
+
+			char* ptr;
+			if (size <= static_cast<size_t>(end_ - pos_))
+			{
+				ptr = pos_;
+				pos_ += size;
+			}
+			else
+				ptr = allocate_block(size);
+
+			allocations_++;
+			::new (static_cast<void*>(ptr)) node_arena*{ this };
+			return ptr + header_size;
+		}
+
+		TOML_NODISCARD
+		static void* allocate_heap(size_t size)
+		{
+			const auto ptr = static_cast<char*>(::operator new(header_size + size));
+			::new (static_cast<void*>(ptr)) node_arena*{ nullptr };
+			return ptr + header_size;
+		}
+
+		// frees something from allocate() or allocate_heap()
+		static void deallocate(void* ptr) noexcept
+		{
+			const auto base	 = static_cast<char*>(ptr) - header_size;
+			const auto arena = *static_cast<node_arena**>(static_cast<void*>(base));
+			if (!arena)
+			{
+				::operator delete(base);
+				return;
+			}
+
+			// inside a node_free_batch the free is just counted, and settled with the arena once the batch ends
+			// (or another arena's allocation is freed in it)
+			auto& pending = TOML_ANON_NAMESPACE::pending_frees();
+			if (pending.batches)
+			{
+				if (pending.arena != arena)
+				{
+					if (pending.arena)
+						pending.arena->settle(pending.count);
+					pending.arena = arena;
+					pending.count = {};
+				}
+				pending.count++;
+				return;
+			}
+
+			arena->settle(1u);
+		}
+	};
+
+	// while one of these is alive, frees of arena allocations on the current thread don't touch the arena's atomic
+	// balance one at a time; they're settled together when the outermost batch ends. tables and arrays free their
+	// contents inside one, so tearing down a document costs a single atomic operation rather than one per node.
+	class node_free_batch
+	{
+	  public:
+		TOML_NODISCARD_CTOR
+		node_free_batch() noexcept
+		{
+			TOML_ANON_NAMESPACE::pending_frees().batches++;
+		}
+
+		~node_free_batch() noexcept
+		{
+			auto& pending = TOML_ANON_NAMESPACE::pending_frees();
+			if (--pending.batches || !pending.arena)
+				return;
+
+			std::exchange(pending.arena, nullptr)->settle(std::exchange(pending.count, size_t{}));
+		}
+
+		TOML_DELETE_DEFAULTS(node_free_batch);
+	};
+
+	// makes an arena the source of new nodes on the current thread (or leaves things as they are if it's null)
+	class node_arena_scope
+	{
+	  private:
+		node_arena* prev_;
+
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit node_arena_scope(node_arena* arena) noexcept //
+			: prev_{ TOML_ANON_NAMESPACE::active_node_arena() }
+		{
+			if (arena)
+				TOML_ANON_NAMESPACE::active_node_arena() = arena;
+		}
+
+		~node_arena_scope() noexcept
+		{
+			TOML_ANON_NAMESPACE::active_node_arena() = prev_;
+		}
+
+		TOML_DELETE_DEFAULTS(node_arena_scope);
+	};
+
+	// makes the global heap the source of new nodes on the current thread, whether or not an arena was active
+	// (e.g. for the keys of a key_pool, which outlive the documents that intern them)
+	class node_heap_scope
+	{
+	  private:
+		node_arena* prev_;
+
+	  public:
+		TOML_NODISCARD_CTOR
+		node_heap_scope() noexcept //
+			: prev_{ std::exchange(TOML_ANON_NAMESPACE::active_node_arena(), nullptr) }
+		{}
+
+		~node_heap_scope() noexcept
+		{
+			TOML_ANON_NAMESPACE::active_node_arena() = prev_;
+		}
+
+		TOML_DELETE_DEFAULTS(node_heap_scope);
+	};
+
+	TOML_EXTERNAL_LINKAGE
+	void* TOML_CALLCONV node_allocate(size_t size)
+	{
+#if TOML_ENABLE_ARENA
+		if (const auto arena = TOML_ANON_NAMESPACE::active_node_arena())
+			return arena->allocate(size);
+		return node_arena::allocate_heap(size);
+#else
+		return ::operator new(size);
+#endif
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	void TOML_CALLCONV node_deallocate(void* ptr, size_t /*size*/) noexcept
+	{
+#if TOML_ENABLE_ARENA
+		node_arena::deallocate(ptr);
+#else
+		::operator delete(ptr);
+#endif
+	}
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_ARENA
+}
+TOML_IMPL_NAMESPACE_END;
+
+#if TOML_HAS_MEMORY_RESOURCE
+
+TOML_NAMESPACE_START
+{
+	TOML_EXTERNAL_LINKAGE
+	memory_resource_scope::memory_resource_scope(std::pmr::memory_resource* resource) //
+		: arena_{ impl::node_arena::create(resource) },
+		  prev_{ std::exchange(TOML_ANON_NAMESPACE::active_node_arena(), arena_) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	memory_resource_scope::~memory_resource_scope() noexcept
+	{
+		TOML_ANON_NAMESPACE::active_node_arena() = prev_;
+		arena_->release();
+	}
+}
+TOML_NAMESPACE_END;
+
+#endif // TOML_HAS_MEMORY_RESOURCE
+
+#include "header_end.hpp"
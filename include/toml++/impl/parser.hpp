@@ -8,11 +8,260 @@
 #if TOML_ENABLE_PARSER
 
 #include "table.hpp"
+#include "key_pool.hpp"
+#include "path.hpp"
 #include "parse_result.hpp"
 #include "header_start.hpp"
 
+/// \cond
+TOML_IMPL_NAMESPACE_START
+{
+	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, impl_ex, impl_noex);
+
+	class incremental_parser_state;
+	class lazy_document_state;
+
+	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
+}
+TOML_IMPL_NAMESPACE_END;
+/// \endcond
+
 TOML_NAMESPACE_START
 {
+	/// \brief	Receives the contents of a TOML document as a stream of events, for parsing without building a tree.
+	///
+	/// \detail Pass one to the overloads of toml::parse() and toml::parse_file() that take a handler, and override
+	///			whichever of the callbacks you're interested in (the defaults do nothing). \cpp
+	/// struct port_finder : toml::sax_handler
+	/// {
+	///		bool in_server = false, is_port = false;
+	///		int64_t port   = 0;
+	///
+	///		void on_table_header(const toml::key* keys, size_t count, bool) override
+	///		{
+	///			in_server = count == 1u && keys[0] == "server"sv;
+	///		}
+	///
+	///		void on_key(const toml::key* keys, size_t count) override
+	///		{
+	///			is_port = in_server && count == 1u && keys[0] == "port"sv;
+	///		}
+	///
+	///		void on_value(const toml::node& val) override
+	///		{
+	///			if (is_port)
+	///				port = val.value_or(int64_t{});
+	///			is_port = false;
+	///		}
+	/// };
+	///
+	/// port_finder finder;
+	/// toml::parse("[server]\nhost = 'example.com'\nport = 8080"sv, finder);
+	/// std::cout << finder.port << "\n";
+	/// \ecpp
+	///
+	/// \out
+	/// 8080
+	/// \eout
+	///
+	/// For each key-value pair the handler sees on_key() followed by either on_value() or the begin/end events of an
+	/// array or inline table, with the events of its contents in between. Array elements and the key-value pairs
+	/// of inline tables are reported the same way, so the document `a = [ 1, { b = 2 } ]` produces:
+	/// - `on_key(a)`
+	/// - `on_array_begin()`
+	/// - `on_value(1)`
+	/// - `on_inline_table_begin()`
+	/// - `on_key(b)`
+	/// - `on_value(2)`
+	/// - `on_inline_table_end()`
+	/// - `on_array_end()`
+	///
+	/// \remarks Documents are validated exactly as they are by the tree-building overloads of toml::parse(),
+	///			and fail with the same errors. Events are emitted as the document is parsed, so a handler may already
+	///			have seen part of a malformed document by the time the error is reported.
+	class sax_handler
+	{
+	  public:
+		/// \brief	Destructor.
+		virtual ~sax_handler() noexcept = default;
+
+		/// \brief	Called for each `[table]` and `[[array-of-tables]]` header.
+		///
+		/// \param 	keys				The header's key path (e.g. `a`, `b` and `c` for `[a.b.c]`).
+		///							Only valid for the duration of the call.
+		/// \param 	count				The number of keys in the path.
+		/// \param 	is_array_of_tables	True for `[[array-of-tables]]` headers.
+		virtual void on_table_header([[maybe_unused]] const key* keys,
+									 [[maybe_unused]] size_t count,
+									 [[maybe_unused]] bool is_array_of_tables)
+		{}
+
+		/// \brief	Called for the key of each key-value pair.
+		///
+		/// \param 	keys	The key, split into its segments if it was dotted (e.g. `a` and `b` for `a.b = 1`).
+		///					Only valid for the duration of the call.
+		/// \param 	count	The number of segments.
+		virtual void on_key([[maybe_unused]] const key* keys, [[maybe_unused]] size_t count)
+		{}
+
+		/// \brief	Called for each value that isn't an array or inline table.
+		///
+		/// \param 	val		A toml::value containing the value, with its flags and source region set.
+		///					It belongs to the parser and is only valid for the duration of the call.
+		virtual void on_value([[maybe_unused]] const node& val)
+		{}
+
+		/// \brief	Called after the opening `[` of an array value.
+		virtual void on_array_begin()
+		{}
+
+		/// \brief	Called after the closing `]` of an array value.
+		virtual void on_array_end()
+		{}
+
+		/// \brief	Called after the opening `{` of an inline table.
+		virtual void on_inline_table_begin()
+		{}
+
+		/// \brief	Called after the closing `}` of an inline table.
+		virtual void on_inline_table_end()
+		{}
+	};
+
+	/// \brief	Options for the overloads of toml::parse() and toml::parse_file() that take them.
+	///
+	/// \detail \cpp
+	/// toml::parse_options options;
+	/// options.keep_paths = { toml::path{ "database" }, toml::path{ "service.limits" } };
+	///
+	/// auto tbl = toml::parse(R"(
+	///		[database]
+	///		host = "db.example.com"
+	///
+	///		[service]
+	///		name = "frontend"
+	///
+	///		[service.limits]
+	///		requests = 1000
+	///
+	///		[logging]
+	///		level = "debug"
+	/// )"sv, options);
+	/// std::cout << tbl << "\n";
+	/// \ecpp
+	///
+	/// \out
+	/// [database]
+	/// host = 'db.example.com'
+	///
+	/// [service.limits]
+	/// requests = 1000
+	/// \eout
+	struct parse_options
+	{
+		/// \brief	The parts of the document to keep.
+		///
+		/// \detail Tables and key-value pairs at or beneath one of these paths are kept, as are the tables leading to
+		///			them. Everything else is still checked for syntax errors but is otherwise skipped without being
+		///			added to the tree. Leave it empty to keep the whole document.
+		///
+		/// \remarks Filtering happens at the level of table headers and key-value pairs, so a path into the middle
+		///			of a value (e.g. `ports[1]`, or a key inside an inline table) keeps the whole value.
+		///			Index components select elements of arrays-of-tables; the elements that aren't selected
+		///			are left empty so the selected ones keep their indices.
+		///			Redefinitions are diagnosed just as they would be without keep_paths, except for those of the
+		///			contents of skipped tables, since skipped tables are never created.
+		std::vector<toml::path> keep_paths;
+
+		/// \brief	How many threads to parse with (including the calling one). `0` means one per hardware thread.
+		///
+		/// \detail Large documents are split at their top-level table headers and the sections in between are parsed
+		///			concurrently, then merged in document order. The result (including any error) is always the same
+		///			as a single-threaded parse; if the sections can't be parsed independently (e.g. because a later
+		///			section redefines something from an earlier one) the whole document is simply parsed again on
+		///			the calling thread.
+		///
+		///			For toml::parse_many() and toml::parse_files() it's how many documents are parsed at once instead.
+		///
+		/// \remarks Documents are only split up when they're parsed from strings and files, without any keep_paths,
+		///			and are big enough to give each thread at least #min_bytes_per_thread of them. This option has no
+		///			effect if #TOML_ENABLE_THREADS is `0`. How much faster it is depends heavily on the machine, so
+		///			measure it there first (examples/parallel_parse_benchmark.cpp does just that).
+		///
+		/// \warning Falling back to a single-threaded parse only happens once the sections have all been parsed, so
+		///			a document that needs it (including any document with an error in it) takes as long as parsing
+		///			it with threads <i>and</i> parsing it without them.
+		size_t threads = 1;
+
+		/// \brief	The least amount of the document worth giving to a thread when parsing with #threads.
+		///
+		/// \detail Documents smaller than this are parsed on the calling thread, and bigger ones use no more threads
+		///			than they have multiples of it. Defaults to `TOML_PARALLEL_PARSE_MIN_BYTES` (64 KB).
+		size_t min_bytes_per_thread = TOML_PARALLEL_PARSE_MIN_BYTES;
+
+		/// \brief	Allocates the document's nodes (and the storage of its tables and arrays) from an arena.
+		///
+		/// \detail Creating a node is then just a pointer-bump, and rather than being freed one at a time the
+		///			arena's memory is released all at once when the last of them is destroyed. Nodes allocated this
+		///			way can be used like any others (e.g. moved into a different table, or outlive the document);
+		///			nodes added to the document afterwards come from the global heap as usual.
+		///
+		///			Destroying the document still runs the destructor of each of its nodes, but their frees are only
+		///			counted on the destroying thread and settled with the arena in one atomic operation once the
+		///			root table is gone, so documents can be destroyed on several threads at once without contending.
+		///
+		/// \remarks Since memory is only reclaimed once every node from the arena has been destroyed, holding on to
+		///			a single node (or key) keeps the whole document's worth of memory alive. Keys long enough to
+		///			need storage of their own come from the arena too, unless they're #interned_keys, but strings
+		///			that long are allocated as usual. This option has no effect if #TOML_ENABLE_ARENA is `0` (the
+		///			default), or when parsing with a toml::sax_handler.
+		bool use_arena = false;
+
+		/// \brief	A pool to intern the document's keys in, so they share their storage with those of other documents.
+		///
+		/// \detail The parser always shares the storage of identical keys within a document; this extends that to
+		///			every document parsed with the same pool (see toml::key_pool).
+		key_pool* interned_keys = nullptr;
+
+		/// \brief	Leaves the source regions of the document's nodes and keys empty.
+		///
+		/// \detail Every node and key normally records where it was defined, which is work the parser can skip if
+		///			nothing is going to look at them once the document has been parsed.
+		///
+		/// \remarks Parse errors still report exactly where they occurred. The document's nodes and keys take up
+		///			the same amount of memory either way; to leave their source regions out of them altogether,
+		///			set #TOML_ENABLE_SOURCES to `0` instead.
+		bool omit_sources = false;
+
+#if TOML_HAS_MEMORY_RESOURCE && TOML_ENABLE_ARENA
+
+		/// \brief	A memory resource to parse the document with.
+		///
+		/// \detail Implies #use_arena, with the arena getting its memory from the resource. The parser's own working
+		///			buffers (for keys, strings and the like) are allocated from it too.
+		///
+		/// \availability This is only available when #TOML_ENABLE_ARENA is `1` (without an arena, the document's
+		///			nodes would all come from the global heap regardless).
+		///
+		/// \remarks The resource must outlive every node parsed with it, and be thread-safe if #threads is not `1`
+		///			or nodes are destroyed on other threads. Strings long enough to need heap storage of their own,
+		///			the document's source path, (when parsing files) the file's contents and the storage of any
+		///			#interned_keys pool are still allocated from the global heap.
+		///			See also toml::memory_resource_scope.
+		std::pmr::memory_resource* memory_resource = nullptr;
+
+#endif
+	};
+
+	/// \brief	The type of toml::borrow_document.
+	struct borrow_document_t
+	{
+		explicit borrow_document_t() = default;
+	};
+
+	/// \brief	Tag for loading a toml::lazy_document that reads from the caller's buffer instead of copying it.
+	inline constexpr borrow_document_t borrow_document{};
+
 	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, ex, noex);
 
 	/// \brief	Parses a TOML document from a string view.
@@ -78,6 +327,10 @@ TOML_NAMESPACE_START
 	///				A toml::table.
 	/// 			\conditional_return{Without exceptions}
 	///				A toml::parse_result.
+	///
+	/// \remarks	When #TOML_ENABLE_MMAP is enabled the file is memory-mapped and parsed in-place rather than being
+	///				copied into an intermediate buffer. As with any memory-mapped I/O, the file must not be truncated
+	///				by another process while it is being parsed; doing so raises `SIGBUS` rather than a parse error.
 	TOML_NODISCARD
 	TOML_EXPORTED_FREE_FUNCTION
 	parse_result TOML_CALLCONV parse_file(std::string_view file_path);
@@ -317,6 +570,557 @@ TOML_NAMESPACE_START
 	TOML_EXPORTED_FREE_FUNCTION
 	parse_result TOML_CALLCONV parse(std::istream & doc, std::string && source_path);
 
+	/// \brief	A push-style parser that accepts a TOML document in arbitrarily-sized chunks.
+	///
+	/// \detail Useful when a document arrives piecemeal (e.g. from a non-blocking socket) and there's nothing
+	///			to block on or read from. Complete top-level lines are parsed as soon as they arrive, so only the
+	///			trailing incomplete line (or multi-line value) is ever buffered. \cpp
+	/// toml::incremental_parser parser;
+	/// parser.feed("a = 1\nb = [\n"sv);
+	/// parser.feed("  2, 3 ]\nc = \"fo"sv);
+	/// parser.feed("o\""sv);
+	///
+	/// auto tbl = parser.finish();
+	/// std::cout << tbl << "\n";
+	/// \ecpp
+	///
+	/// \out
+	/// a = 1
+	/// b = [ 2, 3 ]
+	/// c = 'foo'
+	/// \eout
+	///
+	/// \remarks Chunks may be split anywhere, including in the middle of a UTF-8 sequence. A document is accepted
+	///			or rejected exactly as it would be by toml::parse(), with the error reported at the same location.
+	///			The one exception is a document with more than one error, where an invalid UTF-8 sequence
+	///			follows another error closely enough (in the same 32-byte block) that toml::parse() validates it,
+	///			and so reports it, first; the incremental parser can't read ahead of what it's been given.
+	class TOML_EXPORTED_CLASS incremental_parser
+	{
+	  private:
+		/// \cond
+
+		std::unique_ptr<impl::incremental_parser_state> state_;
+
+		/// \endcond
+
+	  public:
+		/// \brief	Constructs an incremental parser.
+		///
+		/// \param 	source_path		The path used to initialize each node's `source().path`.
+		/// 						If you don't have a path (or you have no intention of using paths in diagnostics)
+		/// 						then this parameter can safely be left blank.
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		explicit incremental_parser(std::string_view source_path = {});
+
+		/// \brief	Constructs an incremental parser.
+		///
+		/// \param 	source_path		The path used to initialize each node's `source().path`.
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		explicit incremental_parser(std::string && source_path);
+
+		/// \brief	Move constructor.
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		incremental_parser(incremental_parser && other) noexcept;
+
+		/// \brief	Move-assignment operator.
+		TOML_EXPORTED_MEMBER_FUNCTION
+		incremental_parser& operator=(incremental_parser&& rhs) noexcept;
+
+		/// \brief	Destructor.
+		TOML_EXPORTED_MEMBER_FUNCTION
+		~incremental_parser() noexcept;
+
+		/// \brief	Feeds the next chunk of the document to the parser.
+		///
+		/// \detail Any complete top-level lines are parsed right away; the rest is held on to until the next call.
+		///			Once the parser has failed, subsequent chunks are ignored.
+		///
+		/// \param 	chunk	The next chunk of the document. Must be valid UTF-8 (though it may begin or end partway
+		///					through a UTF-8 sequence). The parser does not keep a reference to it.
+		///
+		/// \remarks With exceptions enabled, a toml::parse_error is thrown as soon as an error is encountered.
+		///			Without exceptions, the error is returned by finish().
+		TOML_EXPORTED_MEMBER_FUNCTION
+		void feed(std::string_view chunk);
+
+		/// \brief	Returns true if the parser has encountered an error.
+		TOML_PURE_GETTER
+		TOML_EXPORTED_MEMBER_FUNCTION
+		bool failed() const noexcept;
+
+		/// \brief	Parses whatever remains of the document and returns the result.
+		///
+		/// \detail The parser is reset afterwards, ready to parse a new document.
+		///
+		/// \returns	\conditional_return{With exceptions}
+		///				A toml::table.
+		/// 			\conditional_return{Without exceptions}
+		///				A toml::parse_result.
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		parse_result finish();
+	};
+
+	/// \brief	A TOML document that's only parsed as far as it needs to be.
+	///
+	/// \detail Loading a lazy document just indexes its structure: only its tables are built, and the rest of its
+	///			values are skipped over, with just their keys and where they begin and end being recorded. They're
+	///			parsed (and added to the tables) the first time they're looked up. Large documents that are only
+	///			sparsely read load quickly, and only use memory for their tables and the values that are actually
+	///			read. \cpp
+	/// toml::lazy_document doc{ R"(
+	///		[server]
+	///		host = "example.com"
+	///		ports = [ 8000, 8001, 8002 ]
+	///		motd = '''
+	///		a long string that's never read
+	///		'''
+	/// )"sv };
+	///
+	/// std::cout << doc.at_path("server.host") << "\n";
+	/// std::cout << doc.at_path("server.ports[1]") << "\n";
+	/// \ecpp
+	///
+	/// \out
+	/// 'example.com'
+	/// 8001
+	/// \eout
+	///
+	/// Looking up a node returns a toml::node_view of it, with everything beneath it parsed, so the view can be used
+	/// like any other (e.g. to look up the node's children).
+	///
+	/// \remarks Errors are reported in two stages:
+	///			- Everything other than the skipped values is validated when the document is loaded, exactly as it
+	///			  is by toml::parse(). This includes keys, table headers, redefinitions, and skipped values that
+	///			  aren't terminated properly (e.g. a string or array missing its closing delimiter). Values that are
+	///			  malformed enough that where they end or what type they are isn't clear (including any malformed
+	///			  integer or boolean) aren't skipped at all, so their errors are reported then too.
+	///			- Errors inside a skipped value (e.g. an invalid escape sequence, an out-of-range date or a
+	///			  malformed element of an array) are only reported when the value is first looked up, either
+	///			  directly or as part of a table or array containing it. Call table() to parse everything that's
+	///			  left and so validate the whole document.
+	///
+	///			With exceptions enabled, errors at either stage are reported by throwing a toml::parse_error.
+	///			Without them, failed() returns true and error() returns the (first) error. A lookup that failed
+	///			returns an empty view, but the rest of the document can still be read.
+	class TOML_EXPORTED_CLASS lazy_document
+	{
+	  private:
+		/// \cond
+
+		std::unique_ptr<impl::lazy_document_state> state_;
+
+		/// \endcond
+
+	  public:
+		/// \brief	Loads a lazy document.
+		///
+		/// \param 	doc				The TOML document. Must be valid UTF-8. A copy is kept (the skipped values are
+		///							parsed from it), so it doesn't need to outlive the lazy document. See the
+		///							toml::borrow_document overload to avoid the copy.
+		/// \param 	source_path		The path used to initialize each node's `source().path`.
+		/// 						If you don't have a path (or you have no intention of using paths in diagnostics)
+		/// 						then this parameter can safely be left blank.
+		///
+		/// \remarks With exceptions enabled, a toml::parse_error is thrown if the document's structure is malformed.
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		explicit lazy_document(std::string_view doc, std::string_view source_path = {});
+
+		/// \brief	Loads a lazy document without copying it, reading the skipped values from the caller's buffer.
+		///
+		/// \detail \cpp
+		/// const std::string text = read_whole_file("config.toml"); // or a memory-mapped file, etc.
+		/// toml::lazy_document doc{ toml::borrow_document, text };
+		///
+		/// if (auto host = doc.string_at("server.host")) // a view into `text`
+		///		connect(*host);
+		/// \ecpp
+		///
+		/// \param 	doc				The TOML document. Must be valid UTF-8, and must outlive the lazy document
+		///							and every view returned by string_at().
+		/// \param 	source_path		The path used to initialize each node's `source().path`.
+		///
+		/// \remarks With exceptions enabled, a toml::parse_error is thrown if the document's structure is malformed.
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		lazy_document(borrow_document_t, std::string_view doc, std::string_view source_path = {});
+
+		/// \brief	Move constructor.
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		lazy_document(lazy_document && other) noexcept;
+
+		/// \brief	Move-assignment operator.
+		TOML_EXPORTED_MEMBER_FUNCTION
+		lazy_document& operator=(lazy_document&& rhs) noexcept;
+
+		/// \brief	Destructor.
+		TOML_EXPORTED_MEMBER_FUNCTION
+		~lazy_document() noexcept;
+
+		/// \brief	Returns true if an error has been encountered, either while loading the document or while
+		///			parsing one of its values.
+		TOML_PURE_GETTER
+		TOML_EXPORTED_MEMBER_FUNCTION
+		bool failed() const noexcept;
+
+#if !TOML_EXCEPTIONS
+
+		/// \brief	Returns the first error encountered.
+		///
+		/// \availability This function is only available when exceptions are disabled.
+		///
+		/// \warning It is undefined behaviour to call this unless failed() returns true.
+		TOML_PURE_GETTER
+		TOML_EXPORTED_MEMBER_FUNCTION
+		const parse_error& error() const noexcept;
+
+#endif
+
+		/// \brief	Gets a node_view for the selected key-value pair at the root of the document,
+		///			parsing it (and anything beneath it) if necessary.
+		///
+		/// \param 	key The key used for the lookup.
+		///
+		/// \returns	A view of the value at the given key if one existed, or an empty node view.
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		node_view<node> operator[](std::string_view key);
+
+		/// \brief	Gets a node_view for the node at the given path, parsing it (and anything beneath it) if necessary.
+		///
+		/// \param 	path	The "TOML path" to traverse (e.g. `"server.ports[1]"`; see toml::at_path()).
+		///
+		/// \returns	A view of the node at the given path if one existed, or an empty node view.
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		node_view<node> at_path(std::string_view path);
+
+		/// \brief	Gets a node_view for the node at the given path, parsing it (and anything beneath it) if necessary.
+		///
+		/// \param 	path	The path to traverse.
+		///
+		/// \returns	A view of the node at the given path if one existed, or an empty node view.
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		node_view<node> at_path(const toml::path& path);
+
+		/// \brief	Gets a view of the string at the given path without copying it, if it can be helped.
+		///
+		/// \detail Strings that haven't been looked up yet and don't need any parsing (i.e. ones without escape
+		///			sequences or line breaks that need normalizing, which is most of them) are returned as views of the
+		///			document's text, and aren't added to the tree. Anything else is parsed as usual and a view of the
+		///			resulting toml::value<std::string> is returned.
+		///
+		/// \param 	path	The "TOML path" to traverse (e.g. `"server.host"`; see toml::at_path()).
+		///
+		/// \returns	A view of the string at the given path, or an empty optional if there isn't a string there
+		///				(or, without exceptions, it was malformed).
+		///
+		/// \warning The view is only valid for as long as the lazy document and (when loaded with
+		///			toml::borrow_document) the buffer it was loaded from are.
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		optional<std::string_view> string_at(std::string_view path);
+
+		/// \brief	Gets a view of the string at the given path without copying it, if it can be helped.
+		///
+		/// \param 	path	The path to traverse.
+		///
+		/// \returns	A view of the string at the given path, or an empty optional if there isn't a string there
+		///				(or, without exceptions, it was malformed).
+		///
+		/// \see string_at(std::string_view)
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		optional<std::string_view> string_at(const toml::path& path);
+
+		/// \brief	Parses everything that hasn't been parsed yet and returns the whole document.
+		///
+		/// \remarks Without exceptions, check failed() afterwards; any values that were malformed are left in the
+		///			table as default-constructed values of the same type (which later lookups will find).
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		toml::table& table();
+	};
+
+#if TOML_EXCEPTIONS
+
+	/// \brief	Parses a TOML document from a string view, reporting its contents to a toml::sax_handler
+	///			instead of building a tree.
+	///
+	/// \param 	doc				The TOML document to parse. Must be valid UTF-8.
+	/// \param 	handler			The handler to receive the document's contents.
+	/// \param 	source_path		The path used to initialize the `source().path` of the keys and values passed to
+	///							the handler.
+	///
+	/// \returns	\conditional_return{With exceptions}
+	///				Nothing; a toml::parse_error is thrown if the document is malformed.
+	/// 			\conditional_return{Without exceptions}
+	///				The toml::parse_error if the document was malformed, otherwise an empty optional.
+	TOML_EXPORTED_FREE_FUNCTION
+	void TOML_CALLCONV parse(std::string_view doc, sax_handler & handler, std::string_view source_path = {});
+
+	/// \brief	Parses a TOML document from a stream, reporting its contents to a toml::sax_handler
+	///			instead of building a tree.
+	///
+	/// \param 	doc				The TOML document to parse. Must be valid UTF-8.
+	/// \param 	handler			The handler to receive the document's contents.
+	/// \param 	source_path		The path used to initialize the `source().path` of the keys and values passed to
+	///							the handler.
+	///
+	/// \returns	\conditional_return{With exceptions}
+	///				Nothing; a toml::parse_error is thrown if the document is malformed.
+	/// 			\conditional_return{Without exceptions}
+	///				The toml::parse_error if the document was malformed, otherwise an empty optional.
+	TOML_EXPORTED_FREE_FUNCTION
+	void TOML_CALLCONV parse(std::istream & doc, sax_handler & handler, std::string_view source_path = {});
+
+	/// \brief	Parses a TOML document from a file, reporting its contents to a toml::sax_handler
+	///			instead of building a tree.
+	///
+	/// \param 	file_path		The TOML document to parse. Must be valid UTF-8.
+	/// \param 	handler			The handler to receive the document's contents.
+	///
+	/// \returns	\conditional_return{With exceptions}
+	///				Nothing; a toml::parse_error is thrown if the document is malformed.
+	/// 			\conditional_return{Without exceptions}
+	///				The toml::parse_error if the document was malformed, otherwise an empty optional.
+	TOML_EXPORTED_FREE_FUNCTION
+	void TOML_CALLCONV parse_file(std::string_view file_path, sax_handler & handler);
+
+#else
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	optional<parse_error> TOML_CALLCONV parse(std::string_view doc,
+											  sax_handler & handler,
+											  std::string_view source_path = {});
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	optional<parse_error> TOML_CALLCONV parse(std::istream & doc,
+											  sax_handler & handler,
+											  std::string_view source_path = {});
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	optional<parse_error> TOML_CALLCONV parse_file(std::string_view file_path, sax_handler & handler);
+
+#endif
+
+	/// \brief	Parses a TOML document from a string view, keeping only the parts selected by the given options.
+	///
+	/// \param 	doc				The TOML document to parse. Must be valid UTF-8.
+	/// \param 	options			The options to parse with (see toml::parse_options).
+	/// \param 	source_path		The path used to initialize each node's `source().path`.
+	///
+	/// \returns	\conditional_return{With exceptions}
+	///				A toml::table.
+	/// 			\conditional_return{Without exceptions}
+	///				A toml::parse_result.
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	parse_result TOML_CALLCONV parse(std::string_view doc,
+									 const parse_options& options,
+									 std::string_view source_path = {});
+
+	/// \brief	Parses a TOML document from a stream, keeping only the parts selected by the given options.
+	///
+	/// \param 	doc				The TOML document to parse. Must be valid UTF-8.
+	/// \param 	options			The options to parse with (see toml::parse_options).
+	/// \param 	source_path		The path used to initialize each node's `source().path`.
+	///
+	/// \returns	\conditional_return{With exceptions}
+	///				A toml::table.
+	/// 			\conditional_return{Without exceptions}
+	///				A toml::parse_result.
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	parse_result TOML_CALLCONV parse(std::istream & doc,
+									 const parse_options& options,
+									 std::string_view source_path = {});
+
+	/// \brief	Parses a TOML document from a file, keeping only the parts selected by the given options.
+	///
+	/// \param 	file_path		The TOML document to parse. Must be valid UTF-8.
+	/// \param 	options			The options to parse with (see toml::parse_options).
+	///
+	/// \returns	\conditional_return{With exceptions}
+	///				A toml::table.
+	/// 			\conditional_return{Without exceptions}
+	///				A toml::parse_result.
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	parse_result TOML_CALLCONV parse_file(std::string_view file_path, const parse_options& options);
+
+	/// \brief	Parses a batch of TOML documents from string views.
+	///
+	/// \detail \cpp
+	/// toml::parse_options options;
+	/// options.threads = 0; // one per hardware thread
+	///
+	/// std::string_view docs[] = { "a = 1"sv, "b = 2"sv, "c = 3"sv };
+	/// auto results = toml::parse_many(std::begin(docs), std::end(docs), options);
+	/// std::cout << results[1]["b"] << "\n";
+	/// \ecpp
+	///
+	/// \out
+	/// 2
+	/// \eout
+	///
+	/// \param 	first			The first of the TOML documents to parse. Must be valid UTF-8.
+	/// \param 	last			One past the last of the TOML documents to parse.
+	/// \param 	options			The options to parse each of them with. parse_options::threads is how many of them
+	///							are parsed at once (each of them is parsed on one thread).
+	///
+	/// \returns	\conditional_return{With exceptions}
+	///				A std::vector of toml::table, in the same order as the documents. If any of them failed to parse,
+	///				the first such error is thrown once they've all been parsed (use the overload that collects errors
+	///				to keep the documents that didn't fail).
+	/// 			\conditional_return{Without exceptions}
+	///				A std::vector of toml::parse_result, in the same order as the documents.
+	///
+	/// \remarks	This is the same as calling toml::parse() for each document, only faster: aside from being spread
+	///				over multiple threads, each thread's parser (and the memory it allocates along the way) is reused
+	///				for several documents.
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::string_view* first,
+													   const std::string_view* last,
+													   const parse_options& options = {});
+
+	/// \brief	Parses a batch of TOML documents from string views, collecting any errors instead of throwing them.
+	///
+	/// \detail \cpp
+	/// std::vector<toml::optional<toml::parse_error>> errors;
+	/// auto results = toml::parse_many(docs.data(), docs.data() + docs.size(), errors);
+	/// for (size_t i = 0; i < results.size(); i++)
+	/// {
+	///		if (errors[i])
+	///			std::cerr << "document " << i << ": " << *errors[i] << "\n";
+	///		else
+	///			use(results[i]);
+	/// }
+	/// \ecpp
+	///
+	/// \param 	first			The first of the TOML documents to parse. Must be valid UTF-8.
+	/// \param 	last			One past the last of the TOML documents to parse.
+	/// \param 	errors			Replaced with one entry per document, in the same order: the error it failed to parse
+	///							with, or an empty optional if it didn't.
+	/// \param 	options			The options to parse each of them with (see above).
+	///
+	/// \returns	A std::vector of toml::parse_result, in the same order as the documents. Those that failed to parse
+	///				are empty tables (with exceptions) or failed results (without them).
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::string_view* first,
+													   const std::string_view* last,
+													   std::vector<optional<parse_error>>& errors,
+													   const parse_options& options = {});
+
+	/// \brief	Parses a batch of TOML documents from string views.
+	///
+	/// \see parse_many(const std::string_view*, const std::string_view*, const parse_options&)
+	TOML_NODISCARD
+	TOML_ALWAYS_INLINE
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::vector<std::string_view>& docs,
+													   const parse_options& options = {})
+	{
+		return parse_many(docs.data(), docs.data() + docs.size(), options);
+	}
+
+	/// \brief	Parses a batch of TOML documents from string views, collecting any errors instead of throwing them.
+	///
+	/// \see parse_many(const std::string_view*, const std::string_view*, std::vector<optional<parse_error>>&,
+	///		const parse_options&)
+	TOML_NODISCARD
+	TOML_ALWAYS_INLINE
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::vector<std::string_view>& docs,
+													   std::vector<optional<parse_error>>& errors,
+													   const parse_options& options = {})
+	{
+		return parse_many(docs.data(), docs.data() + docs.size(), errors, options);
+	}
+
+	/// \brief	Parses a batch of TOML documents from files.
+	///
+	/// \detail \cpp
+	/// toml::parse_options options;
+	/// options.threads = 0; // one per hardware thread
+	///
+	/// std::vector<std::string_view> paths{ "tenants/a.toml"sv, "tenants/b.toml"sv };
+	/// for (auto& result : toml::parse_files(paths.data(), paths.data() + paths.size(), options))
+	///		std::cout << result["name"] << "\n";
+	/// \ecpp
+	///
+	/// \param 	first			The path of the first of the TOML documents to parse. Must be valid UTF-8.
+	/// \param 	last			One past the last of the paths.
+	/// \param 	options			The options to parse each of them with. parse_options::threads is how many of them
+	///							are parsed at once (each of them is parsed on one thread).
+	///
+	/// \returns	\conditional_return{With exceptions}
+	///				A std::vector of toml::table, in the same order as the paths. If any of them failed to parse
+	///				(or couldn't be read), the first such error is thrown once they've all been parsed (use the
+	///				overload that collects errors to keep the files that didn't fail).
+	/// 			\conditional_return{Without exceptions}
+	///				A std::vector of toml::parse_result, in the same order as the paths.
+	///
+	/// \remarks	This is the same as calling toml::parse_file() for each file, only faster: aside from being spread
+	///				over multiple threads, each thread's parser (and the memory it allocates along the way) is reused
+	///				for several files.
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::string_view* first,
+														const std::string_view* last,
+														const parse_options& options = {});
+
+	/// \brief	Parses a batch of TOML documents from files, collecting any errors instead of throwing them.
+	///
+	/// \param 	first			The path of the first of the TOML documents to parse. Must be valid UTF-8.
+	/// \param 	last			One past the last of the paths.
+	/// \param 	errors			Replaced with one entry per file, in the same order: the error it failed to parse
+	///							(or be read) with, or an empty optional if it didn't.
+	/// \param 	options			The options to parse each of them with (see above).
+	///
+	/// \returns	A std::vector of toml::parse_result, in the same order as the paths. Those that failed are empty
+	///				tables (with exceptions) or failed results (without them).
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::string_view* first,
+														const std::string_view* last,
+														std::vector<optional<parse_error>>& errors,
+														const parse_options& options = {});
+
+	/// \brief	Parses a batch of TOML documents from files.
+	///
+	/// \see parse_files(const std::string_view*, const std::string_view*, const parse_options&)
+	TOML_NODISCARD
+	TOML_ALWAYS_INLINE
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::vector<std::string_view>& file_paths,
+														const parse_options& options = {})
+	{
+		return parse_files(file_paths.data(), file_paths.data() + file_paths.size(), options);
+	}
+
+	/// \brief	Parses a batch of TOML documents from files, collecting any errors instead of throwing them.
+	///
+	/// \see parse_files(const std::string_view*, const std::string_view*, std::vector<optional<parse_error>>&,
+	///		const parse_options&)
+	TOML_NODISCARD
+	TOML_ALWAYS_INLINE
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::vector<std::string_view>& file_paths,
+														std::vector<optional<parse_error>>& errors,
+														const parse_options& options = {})
+	{
+		return parse_files(file_paths.data(), file_paths.data() + file_paths.size(), errors, options);
+	}
+
 	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
 
 	inline namespace literals
@@ -21,6 +21,8 @@
 #include "array.hpp"
 #include "table.hpp"
 #include "unicode.hpp"
+#include "decimal_to_double.inl"
+#include "linear_probing.inl"
 TOML_DISABLE_WARNINGS;
 #include <istream>
 #include <fstream>
@@ -33,7 +35,56 @@ TOML_DISABLE_WARNINGS;
 #if !TOML_INT_CHARCONV
 #include <iomanip>
 #endif
+#if TOML_ENABLE_MMAP && !TOML_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <atomic>
+#if TOML_ENABLE_THREADS
+#include <thread>
+#endif
 TOML_ENABLE_WARNINGS;
+
+#if TOML_ENABLE_MMAP && TOML_WINDOWS
+#ifndef _WINDOWS_
+#if TOML_INCLUDE_WINDOWS_H
+#include <Windows.h>
+#else
+
+struct _SECURITY_ATTRIBUTES;
+
+extern "C" __declspec(dllimport) void* __stdcall CreateFileW(const wchar_t* lpFileName,
+															  unsigned long dwDesiredAccess,
+															  unsigned long dwShareMode,
+															  _SECURITY_ATTRIBUTES* lpSecurityAttributes,
+															  unsigned long dwCreationDisposition,
+															  unsigned long dwFlagsAndAttributes,
+															  void* hTemplateFile);
+
+extern "C" __declspec(dllimport) unsigned long __stdcall GetFileSize(void* hFile, unsigned long* lpFileSizeHigh);
+
+extern "C" __declspec(dllimport) void* __stdcall CreateFileMappingW(void* hFile,
+																	 _SECURITY_ATTRIBUTES* lpFileMappingAttributes,
+																	 unsigned long flProtect,
+																	 unsigned long dwMaximumSizeHigh,
+																	 unsigned long dwMaximumSizeLow,
+																	 const wchar_t* lpName);
+
+extern "C" __declspec(dllimport) void* __stdcall MapViewOfFile(void* hFileMappingObject,
+																unsigned long dwDesiredAccess,
+																unsigned long dwFileOffsetHigh,
+																unsigned long dwFileOffsetLow,
+																size_t dwNumberOfBytesToMap);
+
+extern "C" __declspec(dllimport) int __stdcall UnmapViewOfFile(const void* lpBaseAddress);
+
+extern "C" __declspec(dllimport) int __stdcall CloseHandle(void* hObject);
+
+#endif // TOML_INCLUDE_WINDOWS_H
+#endif // _WINDOWS_
+#endif // TOML_ENABLE_MMAP && TOML_WINDOWS
 #include "header_start.hpp"
 
 //#---------------------------------------------------------------------------------------------------------------------
@@ -102,6 +153,12 @@ TOML_ANON_NAMESPACE_START
 			position_ += num;
 			return num;
 		}
+
+		TOML_PURE_INLINE_GETTER
+		std::string_view contiguous() const noexcept
+		{
+			return { reinterpret_cast<const char*>(source_.data()) + position_, source_.length() - position_ };
+		}
 	};
 
 	template <>
@@ -161,6 +218,12 @@ TOML_ANON_NAMESPACE_START
 			source_->read(static_cast<char*>(dest), static_cast<std::streamsize>(num));
 			return static_cast<size_t>(source_->gcount());
 		}
+
+		TOML_CONST_INLINE_GETTER
+		constexpr std::string_view contiguous() const noexcept
+		{
+			return {};
+		}
 	};
 
 	struct utf8_codepoint
@@ -185,6 +248,29 @@ TOML_ANON_NAMESPACE_START
 	static_assert(std::is_trivially_default_constructible_v<utf8_codepoint> && std::is_trivially_copyable_v<utf8_codepoint>);
 	static_assert(std::is_standard_layout_v<utf8_codepoint>);
 
+	// decodes a utf-8 sequence that's already known to be valid and complete, without going through the state machine
+	TOML_ATTR(nonnull)
+	TOML_ALWAYS_INLINE
+	void decode_validated_utf8(utf8_codepoint& cp, const char* src) noexcept
+	{
+		const auto lead = static_cast<unsigned char>(*src);
+		if TOML_LIKELY(lead < 0x80u)
+		{
+			cp.value	= static_cast<char32_t>(lead);
+			cp.bytes[0] = *src;
+			cp.count	= 1u;
+			return;
+		}
+
+		cp.count = lead >= 0xF0u ? 4u : (lead >= 0xE0u ? 3u : 2u);
+		std::memcpy(cp.bytes, src, cp.count);
+
+		auto value = static_cast<uint_least32_t>(lead & (0x7Fu >> cp.count));
+		for (size_t i = 1; i < cp.count; i++)
+			value = (value << 6) | (static_cast<unsigned char>(src[i]) & 0x3Fu);
+		cp.value = static_cast<char32_t>(value);
+	}
+
 	struct TOML_ABSTRACT_INTERFACE utf8_reader_interface
 	{
 		TOML_NODISCARD
@@ -196,6 +282,9 @@ TOML_ANON_NAMESPACE_START
 		TOML_NODISCARD
 		virtual bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) = 0;
 
+		TOML_NODISCARD
+		virtual std::string_view contiguous() const noexcept = 0;
+
 #if !TOML_EXCEPTIONS
 
 		TOML_NODISCARD
@@ -358,7 +447,21 @@ TOML_ANON_NAMESPACE_START
 					return codepoints_.count ? codepoints_.buffer[codepoints_.count - 1u].position : next_pos_;
 				};
 
-				for (size_t i = 0; i < raw_bytes_read; i++)
+				// validate the block in bulk first; the complete sequences at the front of it (usually all of it)
+				// can then be decoded directly, leaving only the tail of the block for the state machine
+				size_t i = 0;
+				if (!decoder_.needs_more_input())
+				{
+					const auto valid_end = impl::simd().find_invalid_utf8(raw_bytes, raw_bytes + raw_bytes_read);
+					while (raw_bytes + i < valid_end)
+					{
+						auto& cp = codepoints_.buffer[codepoints_.count++];
+						decode_validated_utf8(cp, raw_bytes + i);
+						i += cp.count;
+					}
+				}
+
+				for (; i < raw_bytes_read; i++)
 				{
 					decoder_(static_cast<uint8_t>(raw_bytes[i]));
 					if TOML_UNLIKELY(decoder_.error())
@@ -425,7 +528,7 @@ TOML_ANON_NAMESPACE_START
 			codepoints_.count	= {};
 
 			if (!source_path.empty())
-				source_path_ = std::make_shared<const std::string>(static_cast<String&&>(source_path));
+				source_path_ = source_path_ptr{ static_cast<String&&>(source_path) };
 		}
 
 		TOML_PURE_INLINE_GETTER
@@ -459,6 +562,12 @@ TOML_ANON_NAMESPACE_START
 			return stream_.peek_eof();
 		}
 
+		TOML_NODISCARD
+		std::string_view contiguous() const noexcept final
+		{
+			return stream_.contiguous();
+		}
+
 #if !TOML_EXCEPTIONS
 
 		TOML_NODISCARD
@@ -485,7 +594,7 @@ TOML_ANON_NAMESPACE_START
 #define utf8_buffered_reader_error_check(...)                                                                          \
 	do                                                                                                                 \
 	{                                                                                                                  \
-		if TOML_UNLIKELY(reader_.error())                                                                              \
+		if TOML_UNLIKELY(error())                                                                                      \
 			return __VA_ARGS__;                                                                                        \
 	}                                                                                                                  \
 	while (false)
@@ -499,6 +608,7 @@ TOML_ANON_NAMESPACE_START
 
 	  private:
 		static constexpr size_t history_buffer_size = max_history_length - 1; //'head' is stored in the reader
+		static constexpr size_t block_capacity		= 32;					  // must match utf8_reader
 		utf8_reader_interface& reader_;
 		struct
 		{
@@ -508,23 +618,219 @@ TOML_ANON_NAMESPACE_START
 		const utf8_codepoint* head_ = {};
 		size_t negative_offset_		= {};
 
-	  public:
-		TOML_NODISCARD_CTOR
-		explicit utf8_buffered_reader(utf8_reader_interface& reader) noexcept //
-			: reader_{ reader }
-		{}
+		// contiguous inputs skip the reader and the history buffer entirely; codepoints are decoded in-place
+		// straight out of the source buffer, and stepping back just moves the read pointer.
+		//
+		// validation still happens in blocks of the same size (and from the same offsets) as utf8_reader
+		// so encoding errors are reported in exactly the same way they would be for a stream.
+		struct
+		{
+			const char* begin;
+			const char* end;
+			const char* pos;		  // first byte of the head codepoint (end at EOF)
+			const char* block_end;	  // end of the last validated block
+			const char* complete_end; // end of the last complete codepoint in the validated blocks
+			const char* valid_end;	  // end of the leading span that was validated in bulk up-front
+			source_position position; // position of the head codepoint (one-past-the-end at EOF)
+			impl::utf8_decoder decoder;
+			utf8_codepoint heads[4]; // callers may hold on to the previous codepoint for a little while
+			size_t next_head;
+			size_t block_phase;			   // how far into one of the document's blocks `begin` is (see restart())
+			source_position lead_position; // position of the codepoint before `begin` (if block_phase isn't zero)
+		} direct_ = {};
+		bool is_direct_;
 
-		TOML_PURE_INLINE_GETTER
-		const source_path_ptr& source_path() const noexcept
+#if !TOML_EXCEPTIONS
+		optional<parse_error> err_;
+#endif
+
+		TOML_NODISCARD
+		source_position direct_position_of(const char* target) const noexcept
 		{
-			return reader_.source_path();
+			TOML_ASSERT_ASSUME(target >= direct_.pos);
+
+			auto pos = direct_.position;
+			for (auto c = direct_.pos; c < target; c++)
+			{
+				if (*c == '\n')
+				{
+					pos.line++;
+					pos.column = source_index{ 1 };
+				}
+				else if ((static_cast<unsigned char>(*c) & 0xC0u) != 0x80u)
+					pos.column++;
+			}
+			return pos;
+		}
+
+		TOML_NEVER_INLINE
+		bool direct_validate_next_block() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			auto& d = direct_;
+			TOML_ASSERT_ASSUME(d.block_end < d.end);
+
+			// the input is almost always entirely valid, in which case there's nothing left to do
+			if TOML_LIKELY(d.valid_end == d.end)
+			{
+				d.block_end	   = d.end;
+				d.complete_end = d.end;
+				return true;
+			}
+
+			// otherwise the blocks before the one containing the first error can be skipped over, as long as the
+			// decoder is left in the same state it would have been in had they been validated one at a time
+			const auto valid_block = (static_cast<size_t>(d.valid_end - d.begin) + d.block_phase) / block_capacity;
+			if (valid_block * block_capacity > d.block_phase
+				&& d.begin + (valid_block * block_capacity - d.block_phase) > d.block_end)
+			{
+				d.block_end = d.begin + (valid_block * block_capacity - d.block_phase);
+
+				auto seq = d.block_end;
+				while (seq > d.begin && (static_cast<unsigned char>(seq[-1]) & 0xC0u) == 0x80u)
+					seq--;
+				if (seq > d.begin && static_cast<unsigned char>(seq[-1]) >= 0xC0u)
+					seq--;
+
+				d.complete_end = seq;
+				d.decoder.reset();
+				for (; seq < d.block_end; seq++)
+				{
+					d.decoder(*seq);
+					if (d.decoder.has_code_point())
+						d.complete_end = seq + 1;
+				}
+				return true;
+			}
+
+			// (the first block is cut short if the input began part-way through one)
+			const auto block_begin = d.block_end;
+			const auto block_size  = block_begin == d.begin ? block_capacity - d.block_phase : block_capacity;
+			d.block_end			   = block_begin + impl::min(block_size, static_cast<size_t>(d.end - block_begin));
+
+			if (!d.decoder.needs_more_input()
+				&& impl::is_ascii(block_begin, static_cast<size_t>(d.block_end - block_begin)))
+			{
+				d.complete_end = d.block_end;
+				return true;
+			}
+
+			// mirrors the error locations of utf8_reader::read_next_block()
+			const char* last_complete = {};
+			const auto error_pos	  = [&]() noexcept
+			{
+				if (!last_complete && block_begin == d.begin && d.block_phase)
+					return d.lead_position; // (the block's last complete codepoint came before the input)
+				return direct_position_of(last_complete ? last_complete : d.complete_end);
+			};
+
+			for (auto c = block_begin; c < d.block_end; c++)
+			{
+				d.decoder(*c);
+				if TOML_UNLIKELY(d.decoder.error())
+				{
+					utf8_reader_error("Encountered invalid utf-8 sequence", error_pos(), reader_.source_path());
+					utf8_reader_return_after_error(false);
+				}
+
+				if (d.decoder.has_code_point())
+				{
+					last_complete  = d.complete_end;
+					d.complete_end = c + 1;
+				}
+			}
+
+			if TOML_UNLIKELY(d.decoder.needs_more_input() && d.block_end == d.end)
+			{
+				utf8_reader_error("Encountered EOF during incomplete utf-8 code point sequence",
+								  error_pos(),
+								  reader_.source_path());
+				utf8_reader_return_after_error(false);
+			}
+
+			return true;
 		}
 
 		TOML_NODISCARD
-		const utf8_codepoint* read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		const utf8_codepoint* direct_decode() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
 		{
-			utf8_buffered_reader_error_check({});
+			auto& d = direct_;
+
+			if (d.pos == d.end)
+				return head_ = nullptr;
+
+			while (d.pos >= d.complete_end)
+			{
+				if TOML_UNLIKELY(!direct_validate_next_block())
+					return head_ = nullptr;
+			}
+
+			auto& cp	= d.heads[d.next_head++ % 4u];
+			cp.position = d.position;
+			decode_validated_utf8(cp, d.pos);
+
+			return head_ = &cp;
+		}
+
+		TOML_NODISCARD
+		TOML_ALWAYS_INLINE
+		const utf8_codepoint* direct_read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			auto& d = direct_;
+
+			if (head_)
+			{
+				d.pos += head_->count;
+				if (head_->value == U'\n')
+				{
+					d.position.line++;
+					d.position.column = source_index{ 1 };
+				}
+				else
+					d.position.column++;
+			}
+			else if (d.pos == d.end)
+				return nullptr;
+
+			return direct_decode();
+		}
+
+		TOML_NODISCARD
+		const utf8_codepoint* direct_step_back(size_t count) noexcept
+		{
+			auto& d = direct_;
+
+			for (; count; count--)
+			{
+				TOML_ASSERT_ASSUME(d.pos > d.begin);
+
+				do
+					d.pos--;
+				while ((static_cast<unsigned char>(*d.pos) & 0xC0u) == 0x80u);
+
+				if (*d.pos != '\n')
+				{
+					d.position.column--;
+					continue;
+				}
+
+				// stepped back over a line break; the column has to be recounted from the start of the line
+				d.position.line--;
+				d.position.column = source_index{ 1 };
+				for (auto c = d.pos; c > d.begin && c[-1] != '\n'; c--)
+				{
+					if ((static_cast<unsigned char>(c[-1]) & 0xC0u) != 0x80u)
+						d.position.column++;
+				}
+			}
+
+			// everything behind the read pointer has already been validated, so this can't fail
+			return direct_decode();
+		}
 
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		const utf8_codepoint* buffered_read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
 			if (negative_offset_)
 			{
 				negative_offset_--;
@@ -559,11 +865,92 @@ TOML_ANON_NAMESPACE_START
 			}
 		}
 
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit utf8_buffered_reader(utf8_reader_interface& reader) noexcept //
+			: reader_{ reader }
+		{
+			const auto source = reader_.contiguous();
+			is_direct_		  = !source.empty();
+			if (is_direct_)
+			{
+				direct_.begin		 = source.data();
+				direct_.end			 = source.data() + source.length();
+				direct_.pos			 = direct_.begin;
+				direct_.block_end	 = direct_.begin;
+				direct_.complete_end = direct_.begin;
+				direct_.valid_end	 = impl::simd().find_invalid_utf8(direct_.begin, direct_.end);
+				direct_.position	 = { 1, 1 };
+			}
+		}
+
+		// starts reading the (new) contents of a contiguous source from the beginning, carrying on from the position
+		// the previous contents ended at. used by the incremental parser to move on to the next batch of lines.
+		//
+		// the blocks it's validated in stay aligned with the ones the whole document would have been validated in,
+		// so encoding errors are reported at the same positions as they would be if it had been read all at once.
+		void restart() noexcept
+		{
+			if (!is_direct_)
+			{
+				restart(source_position{ 1, 1 });
+				return;
+			}
+
+			// (the previous contents are gone by now, so only the pointers themselves and the codepoints that were
+			// copied out of them can be used)
+			const auto length = static_cast<size_t>(direct_.end - direct_.begin);
+			const auto phase  = (direct_.block_phase + length) % block_capacity;
+			const auto lead	  = direct_.heads[(direct_.next_head + 3u) % 4u].position;
+			restart(direct_.position);
+			direct_.block_phase	  = phase;
+			direct_.lead_position = lead;
+		}
+
+		// as above, but starting from a specific position (and with blocks aligned to the start of the contents).
+		// used by lazy documents to parse values in isolation.
+		void restart(source_position position) noexcept
+		{
+			const auto source = reader_.contiguous();
+			TOML_ASSERT_ASSUME(!source.empty());
+
+			direct_				 = {};
+			direct_.begin		 = source.data();
+			direct_.end			 = source.data() + source.length();
+			direct_.pos			 = direct_.begin;
+			direct_.block_end	 = direct_.begin;
+			direct_.complete_end = direct_.begin;
+			direct_.valid_end	 = impl::simd().find_invalid_utf8(direct_.begin, direct_.end);
+			direct_.position	 = position;
+			is_direct_			 = true;
+			head_				 = nullptr;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const source_path_ptr& source_path() const noexcept
+		{
+			return reader_.source_path();
+		}
+
+		TOML_NODISCARD
+		TOML_ALWAYS_INLINE
+		const utf8_codepoint* read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			utf8_buffered_reader_error_check({});
+
+			if (is_direct_)
+				return direct_read_next();
+			return buffered_read_next();
+		}
+
 		TOML_NODISCARD
 		const utf8_codepoint* step_back(size_t count) noexcept
 		{
 			utf8_buffered_reader_error_check({});
 
+			if (is_direct_)
+				return direct_step_back(count);
+
 			TOML_ASSERT_ASSUME(history_.count);
 			TOML_ASSERT_ASSUME(negative_offset_ + count <= history_.count);
 
@@ -574,9 +961,96 @@ TOML_ANON_NAMESPACE_START
 					 : head_;
 		}
 
+		// the raw source bytes from the head codepoint onwards; empty unless the input is contiguous.
+		// anything beyond the head hasn't necessarily been validated yet.
+		TOML_PURE_INLINE_GETTER
+		std::string_view raw_span() const noexcept
+		{
+			if (!is_direct_ || !head_)
+				return {};
+			return { direct_.pos, static_cast<size_t>(direct_.end - direct_.pos) };
+		}
+
+		// validates the first `count` bytes of raw_span() without moving the head, so any encoding error amongst them
+		// is reported just as it would have been had they been read.
+		TOML_NODISCARD
+		bool validate_ahead(size_t count) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			utf8_buffered_reader_error_check(false);
+			TOML_ASSERT_ASSUME(is_direct_);
+			TOML_ASSERT_ASSUME(count <= static_cast<size_t>(direct_.end - direct_.pos));
+
+			auto& d			  = direct_;
+			const auto target = d.pos + count;
+			while (target > d.complete_end && d.block_end < d.end)
+			{
+				if TOML_UNLIKELY(!direct_validate_next_block())
+					return false;
+			}
+			return true;
+		}
+
+		// steps over the first `count` bytes of raw_span() in one go.
+		// the bytes must be complete utf-8 sequences with no line breaks.
+		TOML_NODISCARD
+		const utf8_codepoint* skip(size_t count) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			utf8_buffered_reader_error_check({});
+			TOML_ASSERT_ASSUME(is_direct_);
+			TOML_ASSERT_ASSUME(head_);
+			TOML_ASSERT_ASSUME(count && count <= static_cast<size_t>(direct_.end - direct_.pos));
+
+			// validate everything up to the target first so error locations are calculated from the current head
+			if TOML_UNLIKELY(!validate_ahead(count))
+				return head_ = nullptr;
+
+			auto& d			  = direct_;
+			const auto target = d.pos + count;
+			for (; d.pos < target; d.pos++)
+			{
+				TOML_ASSERT(*d.pos != '\n');
+				if ((static_cast<unsigned char>(*d.pos) & 0xC0u) != 0x80u)
+					d.position.column++;
+			}
+
+			return direct_decode();
+		}
+
+		// as skip(), but the bytes may also contain line breaks.
+		TOML_NODISCARD
+		const utf8_codepoint* skip_lines(size_t count) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			utf8_buffered_reader_error_check({});
+			TOML_ASSERT_ASSUME(is_direct_);
+			TOML_ASSERT_ASSUME(head_);
+			TOML_ASSERT_ASSUME(count && count <= static_cast<size_t>(direct_.end - direct_.pos));
+
+			auto& d			  = direct_;
+			const auto target = d.pos + count;
+
+			while (target > d.complete_end && d.block_end < d.end)
+			{
+				if TOML_UNLIKELY(!direct_validate_next_block())
+					return head_ = nullptr;
+			}
+
+			d.position = direct_position_of(target);
+			d.pos	   = target;
+			return direct_decode();
+		}
+
+		// position of the head codepoint (or one-past-the-end at EOF); only meaningful for contiguous inputs.
+		TOML_PURE_INLINE_GETTER
+		const source_position& position() const noexcept
+		{
+			return direct_.position;
+		}
+
 		TOML_NODISCARD
 		bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
 		{
+			if (is_direct_)
+				return direct_.pos == direct_.end;
 			return reader_.peek_eof();
 		}
 
@@ -585,6 +1059,8 @@ TOML_ANON_NAMESPACE_START
 		TOML_NODISCARD
 		optional<parse_error>&& error() noexcept
 		{
+			if (is_direct_)
+				return std::move(err_);
 			return reader_.error();
 		}
 
@@ -659,6 +1135,69 @@ TOML_ANON_NAMESPACE_START
 		static constexpr auto full_prefix	   = "0x"sv;
 	};
 
+	// the eight bytes starting at str, first byte lowest (i.e. a little-endian load regardless of platform;
+	// compilers turn this into a single load where they can)
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	uint64_t load_eight_bytes(const char* str) noexcept
+	{
+		const auto byte = [=](unsigned i) noexcept
+		{ return static_cast<uint64_t>(static_cast<unsigned char>(str[i])) << (i * 8u); };
+		return byte(0) | byte(1) | byte(2) | byte(3) | byte(4) | byte(5) | byte(6) | byte(7);
+	}
+
+	// the value of the eight (already validated) digits starting at str, computed all at once: the digits are
+	// combined into pairs, the pairs into quads and the quads into the result with one multiply each.
+	template <uint64_t base>
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	uint64_t parse_eight_digits(const char* str) noexcept
+	{
+		uint64_t val = load_eight_bytes(str);
+		if constexpr (base == 16)
+			val = (val & 0x0F0F0F0F0F0F0F0Fu) + ((val >> 6) & 0x0101010101010101u) * 9u; // 'a'-'f' and 'A'-'F'
+		else
+			val &= 0x0F0F0F0F0F0F0F0Fu;
+
+		val = ((val * (base * 0x100u + 1u)) >> 8) & 0x00FF00FF00FF00FFu;
+		val = ((val * (base * base * 0x10000u + 1u)) >> 16) & 0x0000FFFF0000FFFFu;
+		return (val * ((base * base * base * base << 32) + 1u)) >> 32;
+	}
+
+	// whether the eight bytes in val (see load_eight_bytes()) are all decimal digits, save for the ones selected by
+	// punct_mask, which must match those in punct exactly. used to check fixed-width date and time fields in one go.
+	TOML_CONST_INLINE_GETTER
+	bool matches_digit_pattern(uint64_t val, uint64_t punct, uint64_t punct_mask) noexcept
+	{
+		// (a byte is a digit if its high nibble is 3, and still is after adding 6 to it)
+		constexpr uint64_t zeroes	   = 0x3030303030303030u;
+		const uint64_t digit_nibbles = 0xF0F0F0F0F0F0F0F0u & ~punct_mask;
+		return (val & punct_mask) == punct												//
+			&& (val & digit_nibbles) == (zeroes & digit_nibbles)						//
+			&& ((val + 0x0606060606060606u) & digit_nibbles) == (zeroes & digit_nibbles);
+	}
+
+	// whether str starts with a valid "+HH:MM" or "-HH:MM" time offset
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_fixed_width_offset(std::string_view str) noexcept
+	{
+		if (str.length() < 6u || (str[0] != '+' && str[0] != '-') || str[3] != ':')
+			return false;
+		for (size_t i : { 1u, 2u, 4u, 5u })
+			if (!impl::is_decimal_digit(static_cast<unsigned char>(str[i])))
+				return false;
+		return (str[1] < '2' || (str[1] == '2' && str[2] <= '3')) && str[4] <= '5';
+	}
+
+	TOML_CONST_INLINE_GETTER
+	uint32_t max_days_in_month(uint32_t year, uint32_t month) noexcept
+	{
+		if (month == 2u)
+			return (year % 4u == 0u) && ((year % 100u != 0u) || (year % 400u == 0u)) ? 29u : 28u;
+		return month == 4u || month == 6u || month == 9u || month == 11u ? 30u : 31u;
+	}
+
 	TOML_PURE_GETTER
 	TOML_INTERNAL_LINKAGE
 	std::string_view to_sv(node_type val) noexcept
@@ -666,6 +1205,19 @@ TOML_ANON_NAMESPACE_START
 		return impl::node_type_friendly_names[impl::unwrap_enum(val)];
 	}
 
+	// the parser's working buffers (see parse_options::memory_resource)
+#if TOML_HAS_MEMORY_RESOURCE
+	using buffer_allocator = std::pmr::polymorphic_allocator<char>;
+	using buffer_string	   = std::pmr::string;
+	template <typename T>
+	using buffer_vector = std::pmr::vector<T>;
+#else
+	using buffer_allocator = std::allocator<char>;
+	using buffer_string	   = std::string;
+	template <typename T>
+	using buffer_vector = std::vector<T>;
+#endif
+
 	TOML_PURE_GETTER
 	TOML_INTERNAL_LINKAGE
 	std::string_view to_sv(const std::string& str) noexcept
@@ -673,6 +1225,17 @@ TOML_ANON_NAMESPACE_START
 		return std::string_view{ str };
 	}
 
+#if TOML_HAS_MEMORY_RESOURCE
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	std::string_view to_sv(const buffer_string& str) noexcept
+	{
+		return std::string_view{ str };
+	}
+
+#endif
+
 	TOML_CONST_GETTER
 	TOML_INTERNAL_LINKAGE
 	std::string_view to_sv(bool val) noexcept
@@ -859,10 +1422,18 @@ TOML_ANON_NAMESPACE_START
 
 	struct parse_key_buffer
 	{
-		std::string buffer;
-		std::vector<std::pair<size_t, size_t>> segments;
-		std::vector<source_position> starts;
-		std::vector<source_position> ends;
+		buffer_string buffer;
+		buffer_vector<std::pair<size_t, size_t>> segments;
+		buffer_vector<source_position> starts;
+		buffer_vector<source_position> ends;
+
+		TOML_NODISCARD_CTOR
+		explicit parse_key_buffer(const buffer_allocator& alloc) //
+			: buffer(alloc),
+			  segments(alloc),
+			  starts(alloc),
+			  ends(alloc)
+		{}
 
 		void clear() noexcept
 		{
@@ -930,2902 +1501,5923 @@ TOML_ANON_NAMESPACE_START
 		bool was_multi_line;
 	};
 
-	struct table_vector_scope
+	// the result of parser::parse_value(): a new node when building a tree, or (when emitting events to a
+	// sax_handler) usually one of the parser's scratch_values.
+	struct parsed_value
 	{
-		std::vector<table*>& tables;
+		impl::node_ptr owned;
+		node* ptr = {};
 
 		TOML_NODISCARD_CTOR
-		explicit table_vector_scope(std::vector<table*>& tables_, table& tbl) //
-			: tables{ tables_ }
-		{
-			tables.push_back(&tbl);
-		}
+		parsed_value() noexcept = default;
 
-		~table_vector_scope() noexcept
-		{
-			tables.pop_back();
-		}
+		TOML_NODISCARD_CTOR
+		explicit parsed_value(impl::node_ptr&& nde) noexcept //
+			: owned{ std::move(nde) },
+			  ptr{ owned.get() }
+		{}
 
-		TOML_DELETE_DEFAULTS(table_vector_scope);
-	};
-}
-TOML_ANON_NAMESPACE_END;
+		TOML_NODISCARD_CTOR
+		explicit parsed_value(node& nde) noexcept //
+			: ptr{ &nde }
+		{}
 
-#if 1 // parser helper macros
+		TOML_PURE_INLINE_GETTER
+		explicit operator bool() const noexcept
+		{
+			return ptr != nullptr;
+		}
 
-// Q: "what the fuck is this? MACROS????"
-// A: The parser needs to work in exceptionless mode (returning error objects directly)
-//    and exception mode (reporting parse failures by throwing). Two totally different control flows.
-//    These macros encapsulate the differences between the two modes so I can write code code
-//    as though I was only targeting one mode and not want yeet myself into the sun.
-//    They're all #undef'd at the bottom of the parser's implementation so they should be harmless outside
-//    of toml++.
+		TOML_PURE_INLINE_GETTER
+		node* operator->() const noexcept
+		{
+			return ptr;
+		}
+	};
 
-#define is_eof()		 !cp
-#define assert_not_eof() TOML_ASSERT_ASSUME(cp != nullptr)
-#define return_if_eof(...)                                                                                             \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if TOML_UNLIKELY(is_eof())                                                                                     \
-			return __VA_ARGS__;                                                                                        \
-	}                                                                                                                  \
-	while (false)
+	// values are parsed into these instead of new nodes when emitting events, so they never touch the heap
+	struct scratch_values
+	{
+		value<std::string> strings;
+		value<int64_t> integers;
+		value<double> floats;
+		value<bool> booleans;
+		value<toml::date> dates;
+		value<toml::time> times;
+		value<toml::date_time> date_times;
+		array arrays; // only ever empty; the elements are emitted as they're parsed
 
-#if TOML_EXCEPTIONS
-#define is_error()					false
-#define return_after_error(...)		TOML_UNREACHABLE
-#define assert_not_error()			static_assert(true)
-#define return_if_error(...)		static_assert(true)
-#define return_if_error_or_eof(...) return_if_eof(__VA_ARGS__)
-#else
-#define is_error()				!!err
-#define return_after_error(...) return __VA_ARGS__
-#define assert_not_error()		TOML_ASSERT(!is_error())
-#define return_if_error(...)                                                                                           \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if TOML_UNLIKELY(is_error())                                                                                   \
-			return __VA_ARGS__;                                                                                        \
-	}                                                                                                                  \
-	while (false)
-#define return_if_error_or_eof(...)                                                                                    \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if TOML_UNLIKELY(is_eof() || is_error())                                                                       \
-			return __VA_ARGS__;                                                                                        \
-	}                                                                                                                  \
-	while (false)
-#endif
+		template <typename T>
+		TOML_PURE_INLINE_GETTER
+		value<T>& get() noexcept
+		{
+			if constexpr (std::is_same_v<T, std::string>)
+				return strings;
+			else if constexpr (std::is_same_v<T, int64_t>)
+				return integers;
+			else if constexpr (std::is_same_v<T, double>)
+				return floats;
+			else if constexpr (std::is_same_v<T, bool>)
+				return booleans;
+			else if constexpr (std::is_same_v<T, toml::date>)
+				return dates;
+			else if constexpr (std::is_same_v<T, toml::time>)
+				return times;
+			else
+			{
+				static_assert(std::is_same_v<T, toml::date_time>);
+				return date_times;
+			}
+		}
+	};
 
-#if defined(TOML_BREAK_AT_PARSE_ERRORS) && TOML_BREAK_AT_PARSE_ERRORS
-#if defined(__has_builtin)
-#if __has_builtin(__builtin_debugtrap)
-#define parse_error_break() __builtin_debugtrap()
-#elif __has_builtin(__debugbreak)
-#define parse_error_break() __debugbreak()
-#endif
-#endif
-#ifndef parse_error_break
-#if TOML_MSVC || TOML_ICC
-#define parse_error_break() __debugbreak()
-#else
-#define parse_error_break() TOML_ASSERT(false)
-#endif
-#endif
-#else
-#define parse_error_break() static_assert(true)
-#endif
+	// lazy documents: the length of the string beginning at `begin` (including the delimiters),
+	// or zero if it isn't terminated properly.
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	size_t skim_string(const char* begin, const char* end) noexcept
+	{
+		TOML_ASSERT_ASSUME(begin < end);
+		TOML_ASSERT_ASSUME(*begin == '"' || *begin == '\'');
 
-#define set_error_and_return(ret, ...)                                                                                 \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if (!is_error())                                                                                               \
-			set_error(__VA_ARGS__);                                                                                    \
-		return_after_error(ret);                                                                                       \
-	}                                                                                                                  \
-	while (false)
+		const auto delimiter = *begin;
+		const auto escape	 = delimiter == '"' ? '\\' : delimiter; // (literal strings don't have escapes)
+		const auto& kernels	 = impl::simd();
 
-#define set_error_and_return_default(...) set_error_and_return({}, __VA_ARGS__)
+		// single-line
+		if (end - begin < 3 || begin[1] != delimiter || begin[2] != delimiter)
+		{
+			for (auto c = begin + 1;;)
+			{
+				c = kernels.find_string_terminator(c, end, delimiter, escape);
+				if (c == end || *c == '\n')
+					return {};
+				if (*c == delimiter)
+					return static_cast<size_t>(c + 1 - begin);
+				if (*c == escape)
+				{
+					if (c + 1 == end || c[1] == '\n')
+						return {};
+					c += 2;
+				}
+				else
+					c++; // some other control character; the value's parser will complain about it
+			}
+		}
 
-#define set_error_and_return_if_eof(...)                                                                               \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if TOML_UNLIKELY(is_eof())                                                                                     \
-			set_error_and_return(__VA_ARGS__, "encountered end-of-file"sv);                                            \
-	}                                                                                                                  \
-	while (false)
+		// multi-line
+		for (auto c = begin + 3;;)
+		{
+			c = kernels.find_string_terminator(c, end, delimiter, escape);
+			if (c == end)
+				return {};
+			if (*c == delimiter)
+			{
+				auto run_end = c;
+				while (run_end < end && *run_end == delimiter)
+					run_end++;
+				if (run_end - c >= 3) // the closing delimiter (possibly preceded by one or two quotes)
+					return run_end - c <= 5 ? static_cast<size_t>(run_end - begin) : 0u;
+				c = run_end;
+			}
+			else if (*c == escape)
+			{
+				if (c + 1 == end)
+					return {};
+				c += 2;
+			}
+			else
+				c++; // line breaks etc.
+		}
+	}
 
-#define advance_and_return_if_error(...)                                                                               \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		assert_not_eof();                                                                                              \
-		advance();                                                                                                     \
-		return_if_error(__VA_ARGS__);                                                                                  \
-	}                                                                                                                  \
-	while (false)
+	// lazy documents: the contents of a string skimmed by skim_string(), if they're exactly what it would be parsed
+	// as (i.e. there are no escape sequences, line endings that need normalizing or characters that aren't allowed).
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	optional<std::string_view> plain_string_contents(std::string_view str) noexcept
+	{
+		TOML_ASSERT_ASSUME(str.length() >= 2u);
 
-#define advance_and_return_if_error_or_eof(...)                                                                        \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		assert_not_eof();                                                                                              \
-		advance();                                                                                                     \
-		return_if_error(__VA_ARGS__);                                                                                  \
-		set_error_and_return_if_eof(__VA_ARGS__);                                                                      \
-	}                                                                                                                  \
-	while (false)
+		const auto delimiter  = str[0];
+		const bool multi_line = str.length() > 2u && str[1] == delimiter; // (the empty single-line string is just "")
 
-#endif // parser helper macros
+		auto contents = multi_line ? str.substr(3u, str.length() - 6u) : str.substr(1u, str.length() - 2u);
+		if (multi_line && !contents.empty() && contents[0] == '\n')
+			contents.remove_prefix(1u); // (a line break right after the opening delimiter is trimmed)
 
-TOML_IMPL_NAMESPACE_START
-{
-	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, impl_ex, impl_noex);
+		for (const char c : contents)
+		{
+			const auto u = static_cast<unsigned char>(c);
+			if ((u < 0x20u && c != '\t' && (c != '\n' || !multi_line)) || u == 0x7Fu)
+				return {};
+			if (c == '\\' && delimiter == '"')
+				return {};
+		}
+		return contents;
+	}
 
-	class parser
+	// lazy documents: the length of the array or inline table beginning at `begin` (including the brackets),
+	// or zero if it isn't closed properly.
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	size_t skim_container(const char* begin, const char* end) noexcept
 	{
-	  private:
-		static constexpr size_t max_nested_values	  = TOML_MAX_NESTED_VALUES;
-		static constexpr size_t max_dotted_keys_depth = TOML_MAX_DOTTED_KEYS_DEPTH;
-
-		utf8_buffered_reader reader;
-		table root;
-		source_position prev_pos = { 1, 1 };
-		const utf8_codepoint* cp = {};
-		std::vector<table*> implicit_tables;
-		std::vector<table*> dotted_key_tables;
-		std::vector<table*> open_inline_tables;
-		std::vector<array*> table_arrays;
-		parse_key_buffer key_buffer;
-		std::string string_buffer;
-		std::string recording_buffer; // for diagnostics
-		bool recording = false, recording_whitespace = true;
-		std::string_view current_scope;
-		size_t nested_values = {};
-#if !TOML_EXCEPTIONS
-		mutable optional<parse_error> err;
-#endif
+		TOML_ASSERT_ASSUME(begin < end);
+		TOML_ASSERT_ASSUME(*begin == '[' || *begin == '{');
 
-		TOML_NODISCARD
-		source_position current_position(source_index fallback_offset = 0) const noexcept
+		size_t depth = {};
+		for (auto c = begin; c < end; c++)
 		{
-			if (!is_eof())
-				return cp->position;
-			return { prev_pos.line, static_cast<source_index>(prev_pos.column + fallback_offset) };
-		}
+			switch (*c)
+			{
+				case '[': [[fallthrough]];
+				case '{': depth++; break;
 
-		template <typename... T>
-		TOML_RETURNS_BY_THROWING
-		TOML_NEVER_INLINE
-		void set_error_at(source_position pos, const T&... reason) const
-		{
-			static_assert(sizeof...(T) > 0);
-			return_if_error();
+				case ']': [[fallthrough]];
+				case '}':
+					if (!--depth)
+						return static_cast<size_t>(c + 1 - begin);
+					break;
 
-			error_builder builder{ current_scope };
-			(builder.append(reason), ...);
+				case '"': [[fallthrough]];
+				case '\'':
+				{
+					const auto len = skim_string(c, end);
+					if (!len)
+						return {};
+					c += len - 1u;
+					break;
+				}
 
-			parse_error_break();
+				case '#':
+					do
+						c = impl::simd().find_comment_terminator(c + 1, end);
+					while (c < end && *c != '\n');
+					if (c == end)
+						return {};
+					break;
 
-#if TOML_EXCEPTIONS
-			builder.finish(pos, reader.source_path());
-#else
-			err.emplace(builder.finish(pos, reader.source_path()));
-#endif
+				default: break;
+			}
 		}
+		return {};
+	}
 
-		template <typename... T>
-		TOML_RETURNS_BY_THROWING
-		void set_error(const T&... reason) const
+	struct deferred_extent
+	{
+		size_t length;
+		node_type type;
+	};
+
+	// lazy documents: the length and type of the value beginning at `begin` if it can be deferred, or a length of
+	// zero if it should just be parsed as normal. that's anything malformed enough that its extent or type is unclear
+	// (so the usual error is reported), and integers that are malformed or might not fit in an int64_t.
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	deferred_extent skim_value(const char* begin, const char* end) noexcept
+	{
+		TOML_ASSERT_ASSUME(begin < end);
+
+		switch (*begin)
 		{
-			set_error_at(current_position(1), reason...);
+			case '"': [[fallthrough]];
+			case '\'': return { skim_string(begin, end), node_type::string };
+			case '[': return { skim_container(begin, end), node_type::array };
+			case '{': return { skim_container(begin, end), node_type::table };
+			default: break;
 		}
 
-		void go_back(size_t count = 1) noexcept
+		const auto is_digit = [](char c) noexcept { return c >= '0' && c <= '9'; };
+		if (!is_digit(*begin) && *begin != '+' && *begin != '-' && *begin != 't' && *begin != 'f')
+			return {};
+
+		// the rest of a bare value; nullptr if it runs into anything that isn't a value-terminator or plain ASCII
+		const auto find_token_end = [=](const char* c) noexcept -> const char*
 		{
-			return_if_error();
-			TOML_ASSERT_ASSUME(count);
+			for (; c < end; c++)
+			{
+				switch (*c)
+				{
+					case ' ': [[fallthrough]];
+					case '\t': [[fallthrough]];
+					case '\n': [[fallthrough]];
+					case '\r': [[fallthrough]];
+					case ',': [[fallthrough]];
+					case ']': [[fallthrough]];
+					case '}': [[fallthrough]];
+					case '#': return c;
+
+					default:
+						if (static_cast<unsigned char>(*c) <= 0x20u || static_cast<unsigned char>(*c) >= 0x7Fu)
+							return nullptr;
+				}
+			}
+			return c;
+		};
+		const auto token_end = find_token_end(begin);
+		if (!token_end)
+			return {};
+		const auto len = static_cast<size_t>(token_end - begin);
 
-			cp		 = reader.step_back(count);
-			prev_pos = cp->position;
+		// booleans
+		if (*begin == 't' || *begin == 'f')
+		{
+			const auto token = std::string_view{ begin, len };
+			return { token == "true"sv || token == "false"sv ? len : 0u, node_type::boolean };
 		}
 
-		void advance()
+		// dates and date-times
+		if (len >= 10u && is_digit(*begin) && begin[4] == '-' && begin[7] == '-')
 		{
-			return_if_error();
-			assert_not_eof();
-
-			prev_pos = cp->position;
-			cp		 = reader.read_next();
+			if (len > 10u)
+				return { len, node_type::date_time };
 
-#if !TOML_EXCEPTIONS
-			if (reader.error())
+			// date-times with a space instead of a 'T'
+			if (end - token_end >= 3 && token_end[0] == ' ' && is_digit(token_end[1])
+				&& is_digit(token_end[2]))
 			{
-				err = std::move(reader.error());
-				return;
+				if (const auto time_end = find_token_end(token_end + 1))
+					return { static_cast<size_t>(time_end - begin), node_type::date_time };
+				return {};
 			}
-#endif
 
-			if (recording && !is_eof())
-			{
-				if (recording_whitespace || !is_whitespace(*cp))
-					recording_buffer.append(cp->bytes, cp->count);
-			}
+			return { len, node_type::date };
 		}
 
-		void start_recording(bool include_current = true) noexcept
-		{
-			return_if_error();
+		// times
+		if (std::memchr(begin, ':', len))
+			return { is_digit(*begin) ? len : 0u, node_type::time };
 
-			recording			 = true;
-			recording_whitespace = true;
-			recording_buffer.clear();
-			if (include_current && !is_eof())
-				recording_buffer.append(cp->bytes, cp->count);
+		// floats
+		const auto digits = begin + (*begin == '+' || *begin == '-' ? 1 : 0);
+		if (digits == token_end)
+			return {};
+		for (auto c = digits; c < token_end; c++)
+		{
+			if (*c == '.' || *c == 'e' || *c == 'E')
+				return { len, node_type::floating_point };
 		}
 
-		void stop_recording(size_t pop_bytes = 0) noexcept
+		// integers (digits with single underscores between them, and at most as many as are sure to fit)
+		const auto skim_integer = [=](const char* c, auto&& is_valid_digit, size_t max_digits) noexcept -> bool
 		{
-			return_if_error();
-
-			recording = false;
-			if (pop_bytes)
+			size_t count = {};
+			for (bool prev_digit = false; c < token_end; c++)
 			{
-				if (pop_bytes >= recording_buffer.length())
-					recording_buffer.clear();
-				else if (pop_bytes == 1u)
-					recording_buffer.pop_back();
-				else
-					recording_buffer.erase(recording_buffer.begin()
-											   + static_cast<ptrdiff_t>(recording_buffer.length() - pop_bytes),
-										   recording_buffer.end());
+				if (*c == '_')
+				{
+					if (!prev_digit)
+						return false;
+					prev_digit = false;
+					continue;
+				}
+				if (!is_valid_digit(*c) || ++count > max_digits)
+					return false;
+				prev_digit = true;
 			}
-		}
-
-		bool consume_leading_whitespace()
+			return count && token_end[-1] != '_';
+		};
+		bool valid;
+		if (token_end - digits >= 2 && *digits == '0' && (digits[1] == 'x' || digits[1] == 'o' || digits[1] == 'b'))
 		{
-			return_if_error_or_eof({});
-
-			bool consumed = false;
-			while (!is_eof() && is_horizontal_whitespace(*cp))
+			// (no sign allowed)
+			if (digits != begin)
+				return {};
+			switch (digits[1])
 			{
-				if TOML_UNLIKELY(!is_ascii_horizontal_whitespace(*cp))
-					set_error_and_return_default("expected space or tab, saw '"sv, escaped_codepoint{ *cp }, "'"sv);
-
-				consumed = true;
-				advance_and_return_if_error({});
+				case 'x':
+					valid = skim_integer(
+						digits + 2,
+						[](char c) noexcept
+						{ return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); },
+						15u);
+					break;
+				case 'o': valid = skim_integer(digits + 2, [](char c) noexcept { return c >= '0' && c <= '7'; }, 21u); break;
+				default: valid = skim_integer(digits + 2, [](char c) noexcept { return c == '0' || c == '1'; }, 63u); break;
 			}
-			return consumed;
 		}
+		else
+			valid = (*digits != '0' || token_end - digits == 1) && skim_integer(digits, is_digit, 18u);
+		return { valid ? len : 0u, node_type::integer };
+	}
 
-		bool consume_line_break()
+	struct table_vector_scope
+	{
+		buffer_vector<table*>& tables;
+
+		TOML_NODISCARD_CTOR
+		explicit table_vector_scope(buffer_vector<table*>& tables_, table& tbl) //
+			: tables{ tables_ }
 		{
-			return_if_error_or_eof({});
+			tables.push_back(&tbl);
+		}
 
-			if TOML_UNLIKELY(is_match(*cp, U'\v', U'\f'))
-				set_error_and_return_default(
-					R"(vertical tabs '\v' and form-feeds '\f' are not legal line breaks in TOML)"sv);
+		~table_vector_scope() noexcept
+		{
+			tables.pop_back();
+		}
 
-			if (*cp == U'\r')
-			{
-				advance_and_return_if_error({}); // skip \r
+		TOML_DELETE_DEFAULTS(table_vector_scope);
+	};
 
-				if TOML_UNLIKELY(is_eof())
-					set_error_and_return_default("expected '\\n' after '\\r', saw EOF"sv);
+	// nodes (and tables) are heap-allocated so the low bits of their addresses are mostly zeroes; this mixes them
+	// with the rest so they can be hashed.
+	TOML_CONST_GETTER
+	TOML_INTERNAL_LINKAGE
+	size_t hash_pointer(const void* ptr) noexcept
+	{
+		auto h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDull;
+		h ^= h >> 33;
+		return static_cast<size_t>(h);
+	}
 
-				if TOML_UNLIKELY(*cp != U'\n')
-					set_error_and_return_default("expected '\\n' after '\\r', saw '"sv,
-												 escaped_codepoint{ *cp },
-												 "'"sv);
+	// a set of node pointers, with open addressing and linear probing.
+	// used by the parser to keep track of which tables and arrays it created implicitly or as table arrays.
+	template <typename T>
+	class node_set
+	{
+	  private:
+		struct slot_traits
+		{
+			TOML_CONST_INLINE_GETTER
+			static bool empty(const T* ptr) noexcept
+			{
+				return !ptr;
 			}
-			else if (*cp != U'\n')
-				return false;
 
-			advance_and_return_if_error({}); // skip \n
-			return true;
+			TOML_CONST_INLINE_GETTER
+			static size_t hash(const T* ptr) noexcept
+			{
+				return hash_pointer(ptr);
+			}
+		};
+		using probing = impl::linear_probing<T*, slot_traits>;
+
+		buffer_vector<T*> slots_;
+		size_t size_ = {};
+
+		TOML_NODISCARD
+		T*& find(const T* ptr) noexcept
+		{
+			return probing::find(slots_.data(),
+								 slots_.size() - 1u,
+								 slot_traits::hash(ptr),
+								 [=](const T* slot) noexcept { return slot == ptr; });
 		}
 
-		bool consume_rest_of_line()
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit node_set(const buffer_allocator& alloc) noexcept //
+			: slots_(alloc)
+		{}
+
+		TOML_PURE_GETTER
+		bool contains(const T* ptr) const noexcept
 		{
-			return_if_error_or_eof({});
+			return size_ && const_cast<node_set&>(*this).find(ptr);
+		}
 
-			do
+		void insert(T* ptr)
+		{
+			if (probing::needs_growth(size_, slots_.size()))
 			{
-				if (is_ascii_vertical_whitespace(*cp))
-					return consume_line_break();
-				else
-					advance();
-				return_if_error({});
+				buffer_vector<T*> slots(probing::grown_capacity(slots_.size()), nullptr, slots_.get_allocator());
+				probing::rehash(slots_.data(), slots_.size(), slots.data(), slots.size() - 1u);
+				slots_ = std::move(slots);
 			}
-			while (!is_eof());
 
-			return true;
+			if (auto& slot = find(ptr); !slot)
+			{
+				slot = ptr;
+				size_++;
+			}
 		}
 
-		bool consume_comment()
+		bool erase(const T* ptr) noexcept
 		{
-			return_if_error_or_eof({});
-
-			if (*cp != U'#')
+			if (!size_)
 				return false;
 
-			push_parse_scope("comment"sv);
-
-			advance_and_return_if_error({}); // skip the '#'
+			auto& slot = find(ptr);
+			if (!slot)
+				return false;
 
-			while (!is_eof())
-			{
-				if (consume_line_break())
-					return true;
-				return_if_error({});
+			probing::erase(slots_.data(), slots_.size() - 1u, slot);
+			size_--;
+			return true;
+		}
 
-#if TOML_LANG_AT_LEAST(1, 0, 0)
+		TOML_PURE_INLINE_GETTER
+		size_t size() const noexcept
+		{
+			return size_;
+		}
 
-				// toml/issues/567 (disallow non-TAB control characters in comments)
-				if TOML_UNLIKELY(is_nontab_control_character(*cp))
-					set_error_and_return_default(
-						"control characters other than TAB (U+0009) are explicitly prohibited in comments"sv);
+		TOML_PURE_INLINE_GETTER
+		bool empty() const noexcept
+		{
+			return !size_;
+		}
 
-				// toml/pull/720 (disallow surrogates in comments)
-				else if TOML_UNLIKELY(is_unicode_surrogate(*cp))
-					set_error_and_return_default(
-						"unicode surrogates (U+D800 to U+DFFF) are explicitly prohibited in comments"sv);
-#endif
+		void clear() noexcept
+		{
+			if (!size_)
+				return;
+			for (auto& ptr : slots_)
+				ptr = nullptr;
+			size_ = {};
+		}
+	};
 
-				advance_and_return_if_error({});
-			}
+	// the keys of the values in each table, along with their types. used by the parser in place of the values
+	// themselves when emitting events, so redefinitions can still be diagnosed (see parser::insert_parsed_value()),
+	// and by lazy documents as an index of the values they skipped over (see parser::skip_value()).
+	// entries are kept in the order they were added so the most recent ones can be forgotten again.
+	//
+	// the root table is moved out of the parser once it's done, so values in it have a null parent.
+	class value_key_set
+	{
+	  public:
+		struct entry
+		{
+			table* parent;
+			key k;
+			node_type type;
+			std::string_view source; // lazy documents: the value's text (empty once it's been parsed)
+			source_position position;
+		};
 
-			return true;
-		}
+	  private:
+		struct slot
+		{
+			size_t hash;
+			size_t index; // (into entries_, plus one; zero if the slot is empty)
+		};
 
-		TOML_NODISCARD
-		bool consume_expected_sequence(std::u32string_view seq)
+		struct slot_traits
 		{
-			return_if_error({});
-			TOML_ASSERT(!seq.empty());
+			TOML_CONST_INLINE_GETTER
+			static bool empty(const slot& s) noexcept
+			{
+				return !s.index;
+			}
 
-			for (auto c : seq)
+			TOML_CONST_INLINE_GETTER
+			static size_t hash(const slot& s) noexcept
 			{
-				set_error_and_return_if_eof({});
-				if (*cp != c)
-					return false;
-				advance_and_return_if_error({});
+				return s.hash;
 			}
-			return true;
+		};
+		using probing = impl::linear_probing<slot, slot_traits>;
+
+		buffer_vector<entry> entries_;
+		buffer_vector<slot> slots_;
+
+		TOML_PURE_GETTER
+		static size_t hash(const table* parent, std::string_view k) noexcept
+		{
+			return hash_pointer(parent) ^ std::hash<std::string_view>{}(k);
 		}
 
-		template <typename T>
 		TOML_NODISCARD
-		bool consume_digit_sequence(T* digits, size_t len)
+		slot& find_slot(size_t h, const table* parent, std::string_view k) noexcept
 		{
-			return_if_error({});
-			TOML_ASSERT_ASSUME(digits);
-			TOML_ASSERT_ASSUME(len);
+			return probing::find(slots_.data(),
+								 slots_.size() - 1u,
+								 h,
+								 [&](const slot& s) noexcept
+								 {
+									 const auto& e = entries_[s.index - 1u];
+									 return s.hash == h && e.parent == parent && e.k.str() == k;
+								 });
+		}
 
-			for (size_t i = 0; i < len; i++)
-			{
-				set_error_and_return_if_eof({});
-				if (!is_decimal_digit(*cp))
-					return false;
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit value_key_set(const buffer_allocator& alloc) noexcept //
+			: entries_(alloc),
+			  slots_(alloc)
+		{}
 
-				digits[i] = static_cast<T>(*cp - U'0');
-				advance_and_return_if_error({});
-			}
-			return true;
+		// the entry for the value with the given key in a table, or nullptr if there isn't one
+		TOML_PURE_GETTER
+		entry* find(const table* parent, std::string_view k) noexcept
+		{
+			if (entries_.empty())
+				return nullptr;
+
+			const auto& s = find_slot(hash(parent, k), parent, k);
+			return slot_traits::empty(s) ? nullptr : &entries_[s.index - 1u];
 		}
 
-		template <typename T>
-		TOML_NODISCARD
-		size_t consume_variable_length_digit_sequence(T* buffer, size_t max_len)
+		// (the key mustn't already be in the table)
+		void insert(table* parent, key&& k, node_type type, std::string_view source = {}, source_position position = {})
 		{
-			return_if_error({});
-			TOML_ASSERT_ASSUME(buffer);
-			TOML_ASSERT_ASSUME(max_len);
-
-			size_t i = {};
-			for (; i < max_len; i++)
+			if (probing::needs_growth(entries_.size(), slots_.size()))
 			{
-				if (is_eof() || !is_decimal_digit(*cp))
-					break;
-
-				buffer[i] = static_cast<T>(*cp - U'0');
-				advance_and_return_if_error({});
+				buffer_vector<slot> slots(probing::grown_capacity(slots_.size()), slot{}, slots_.get_allocator());
+				probing::rehash(slots_.data(), slots_.size(), slots.data(), slots.size() - 1u);
+				slots_ = std::move(slots);
 			}
-			return i;
+
+			const auto h = hash(parent, k.str());
+			entries_.push_back(entry{ parent, std::move(k), type, source, position });
+			probing::place(slots_.data(), slots_.size() - 1u, slot{ h, entries_.size() });
 		}
 
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		std::string_view parse_basic_string(bool multi_line)
+		TOML_PURE_INLINE_GETTER
+		size_t size() const noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(*cp == U'"');
-			push_parse_scope("string"sv);
+			return entries_.size();
+		}
 
-			// skip the '"'
-			advance_and_return_if_error_or_eof({});
+		TOML_PURE_INLINE_GETTER
+		entry* begin() noexcept
+		{
+			return entries_.data();
+		}
 
-			// multi-line strings ignore a single line ending right at the beginning
-			if (multi_line)
-			{
-				consume_line_break();
-				return_if_error({});
-				set_error_and_return_if_eof({});
-			}
+		TOML_PURE_INLINE_GETTER
+		entry* end() noexcept
+		{
+			return entries_.data() + entries_.size();
+		}
 
-			auto& str = string_buffer;
-			str.clear();
-			bool escaped			 = false;
-			bool skipping_whitespace = false;
-			do
+		// forgets everything added since there were `count` entries
+		void truncate(size_t count) noexcept
+		{
+			while (entries_.size() > count)
 			{
-				if (escaped)
-				{
-					escaped = false;
+				const auto& last = entries_.back();
+				const auto index = entries_.size();
+
+				auto& s = probing::find(slots_.data(),
+										slots_.size() - 1u,
+										hash(last.parent, last.k.str()),
+										[=](const slot& candidate) noexcept { return candidate.index == index; });
+				probing::erase(slots_.data(), slots_.size() - 1u, s);
+				entries_.pop_back();
+			}
+		}
 
-					// handle 'line ending slashes' in multi-line mode
-					if (multi_line && is_whitespace(*cp))
-					{
-						consume_leading_whitespace();
+		void clear() noexcept
+		{
+			if (entries_.empty())
+				return;
+			entries_.clear();
+			for (auto& s : slots_)
+				s = slot{};
+		}
+	};
+}
+TOML_ANON_NAMESPACE_END;
 
-						if TOML_UNLIKELY(!consume_line_break())
-							set_error_and_return_default(
-								"line-ending backslashes must be the last non-whitespace character on the line"sv);
+#if 1 // parser helper macros
 
-						skipping_whitespace = true;
-						return_if_error({});
-						continue;
-					}
+// Q: "what the fuck is this? MACROS????"
+// A: The parser needs to work in exceptionless mode (returning error objects directly)
+//    and exception mode (reporting parse failures by throwing). Two totally different control flows.
+//    These macros encapsulate the differences between the two modes so I can write code code
+//    as though I was only targeting one mode and not want yeet myself into the sun.
+//    They're all #undef'd at the bottom of the parser's implementation so they should be harmless outside
+//    of toml++.
 
-					bool skip_escaped_codepoint = true;
-					assert_not_eof();
-					switch (const auto escaped_codepoint = *cp)
-					{
-						// 'regular' escape codes
-						case U'b': str += '\b'; break;
-						case U'f': str += '\f'; break;
-						case U'n': str += '\n'; break;
-						case U'r': str += '\r'; break;
-						case U't': str += '\t'; break;
-						case U'"': str += '"'; break;
-						case U'\\': str += '\\'; break;
+#define is_eof()		 !cp
+#define assert_not_eof() TOML_ASSERT_ASSUME(cp != nullptr)
+#define return_if_eof(...)                                                                                             \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if TOML_UNLIKELY(is_eof())                                                                                     \
+			return __VA_ARGS__;                                                                                        \
+	}                                                                                                                  \
+	while (false)
 
-#if TOML_LANG_UNRELEASED // toml/pull/790 (\e shorthand for \x1B)
-						case U'e': str += '\x1B'; break;
+#if TOML_EXCEPTIONS
+#define is_error()					false
+#define return_after_error(...)		TOML_UNREACHABLE
+#define assert_not_error()			static_assert(true)
+#define return_if_error(...)		static_assert(true)
+#define return_if_error_or_eof(...) return_if_eof(__VA_ARGS__)
 #else
-						case U'e':
-							set_error_and_return_default(
-								"escape sequence '\\e' is not supported in TOML 1.0.0 and earlier"sv);
+#define is_error()				!!err
+#define return_after_error(...) return __VA_ARGS__
+#define assert_not_error()		TOML_ASSERT(!is_error())
+#define return_if_error(...)                                                                                           \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if TOML_UNLIKELY(is_error())                                                                                   \
+			return __VA_ARGS__;                                                                                        \
+	}                                                                                                                  \
+	while (false)
+#define return_if_error_or_eof(...)                                                                                    \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if TOML_UNLIKELY(is_eof() || is_error())                                                                       \
+			return __VA_ARGS__;                                                                                        \
+	}                                                                                                                  \
+	while (false)
 #endif
 
-#if TOML_LANG_UNRELEASED // toml/pull/796 (\xHH unicode scalar sequences)
-						case U'x': [[fallthrough]];
+#if defined(TOML_BREAK_AT_PARSE_ERRORS) && TOML_BREAK_AT_PARSE_ERRORS
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_debugtrap)
+#define parse_error_break() __builtin_debugtrap()
+#elif __has_builtin(__debugbreak)
+#define parse_error_break() __debugbreak()
+#endif
+#endif
+#ifndef parse_error_break
+#if TOML_MSVC || TOML_ICC
+#define parse_error_break() __debugbreak()
 #else
-						case U'x':
-							set_error_and_return_default(
-								"escape sequence '\\x' is not supported in TOML 1.0.0 and earlier"sv);
+#define parse_error_break() TOML_ASSERT(false)
+#endif
+#endif
+#else
+#define parse_error_break() static_assert(true)
 #endif
 
-						// unicode scalar sequences
-						case U'u': [[fallthrough]];
-						case U'U':
-						{
-							push_parse_scope("unicode scalar sequence"sv);
-							advance_and_return_if_error_or_eof({});
-							skip_escaped_codepoint = false;
-
-							uint32_t place_value =
-								escaped_codepoint == U'U' ? 0x10000000u : (escaped_codepoint == U'u' ? 0x1000u : 0x10u);
-							uint32_t sequence_value{};
-							while (place_value)
-							{
-								set_error_and_return_if_eof({});
+#define set_error_and_return(ret, ...)                                                                                 \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if (!is_error())                                                                                               \
+			set_error(__VA_ARGS__);                                                                                    \
+		return_after_error(ret);                                                                                       \
+	}                                                                                                                  \
+	while (false)
 
-								if TOML_UNLIKELY(!is_hexadecimal_digit(*cp))
-									set_error_and_return_default("expected hex digit, saw '"sv, to_sv(*cp), "'"sv);
+#define set_error_and_return_default(...) set_error_and_return({}, __VA_ARGS__)
 
-								sequence_value += place_value * hex_to_dec(*cp);
-								place_value /= 16u;
-								advance_and_return_if_error({});
-							}
+#define set_error_and_return_if_eof(...)                                                                               \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if TOML_UNLIKELY(is_eof())                                                                                     \
+			set_error_and_return(__VA_ARGS__, "encountered end-of-file"sv);                                            \
+	}                                                                                                                  \
+	while (false)
 
-							if TOML_UNLIKELY(is_unicode_surrogate(sequence_value))
-								set_error_and_return_default(
-									"unicode surrogates (U+D800 - U+DFFF) are explicitly prohibited"sv);
-							else if TOML_UNLIKELY(sequence_value > 0x10FFFFu)
-								set_error_and_return_default("values greater than U+10FFFF are invalid"sv);
+#define advance_and_return_if_error(...)                                                                               \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		assert_not_eof();                                                                                              \
+		advance();                                                                                                     \
+		return_if_error(__VA_ARGS__);                                                                                  \
+	}                                                                                                                  \
+	while (false)
 
-							if (sequence_value < 0x80)
-							{
-								str += static_cast<char>(sequence_value);
-							}
-							else if (sequence_value < 0x800u)
-							{
-								str += static_cast<char>((sequence_value >> 6) | 0xC0u);
-								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
-							}
-							else if (sequence_value < 0x10000u)
-							{
-								str += static_cast<char>((sequence_value >> 12) | 0xE0u);
-								str += static_cast<char>(((sequence_value >> 6) & 0x3Fu) | 0x80u);
-								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
-							}
-							else if (sequence_value < 0x110000u)
-							{
-								str += static_cast<char>((sequence_value >> 18) | 0xF0u);
-								str += static_cast<char>(((sequence_value >> 12) & 0x3Fu) | 0x80u);
-								str += static_cast<char>(((sequence_value >> 6) & 0x3Fu) | 0x80u);
-								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
-							}
-							break;
-						}
+#define advance_and_return_if_error_or_eof(...)                                                                        \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		assert_not_eof();                                                                                              \
+		advance();                                                                                                     \
+		return_if_error(__VA_ARGS__);                                                                                  \
+		set_error_and_return_if_eof(__VA_ARGS__);                                                                      \
+	}                                                                                                                  \
+	while (false)
 
-							// ???
-							TOML_UNLIKELY_CASE
-						default: set_error_and_return_default("unknown escape sequence '\\"sv, to_sv(*cp), "'"sv);
-					}
+#endif // parser helper macros
 
-					if (skip_escaped_codepoint)
-						advance_and_return_if_error_or_eof({});
-				}
-				else
-				{
-					// handle closing delimiters
-					if (*cp == U'"')
-					{
-						if (multi_line)
-						{
-							size_t lookaheads			  = {};
-							size_t consecutive_delimiters = 1;
-							do
-							{
-								advance_and_return_if_error({});
-								lookaheads++;
-								if (!is_eof() && *cp == U'"')
-									consecutive_delimiters++;
-								else
-									break;
-							}
-							while (lookaheads < 4u);
+TOML_IMPL_NAMESPACE_START
+{
+	// path-filtered parsing: a table put in the tree by a key-value pair outside of keep_paths
+	// (see parser::prune_discarded_tables()).
+	struct discarded_table
+	{
+		table* parent;
+		key k;
+	};
 
-							switch (consecutive_delimiters)
-							{
-								// """ " (one quote somewhere in a ML string)
-								case 1:
-									str += '"';
-									skipping_whitespace = false;
-									continue;
+	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, impl_ex, impl_noex);
 
-								// """ "" (two quotes somewhere in a ML string)
-								case 2:
-									str.append("\"\""sv);
-									skipping_whitespace = false;
-									continue;
+	class parser
+	{
+	  private:
+		static constexpr size_t max_nested_values	  = TOML_MAX_NESTED_VALUES;
+		static constexpr size_t max_dotted_keys_depth = TOML_MAX_DOTTED_KEYS_DEPTH;
 
-								// """ """ (the end of the string)
-								case 3: return str;
+		utf8_buffered_reader reader;
+		table root;
+		table* current_table = {};
+		sax_handler* events = {};
+		bool discarding_values = false; // when emitting events, or skipping values outside of keep_paths
+		scratch_values scratch;
+		buffer_vector<key> event_keys;
+		value_key_set discarded_value_keys;
+		value_key_set* value_keys;	  // the values that aren't in the tree (see add_value_key())
+		bool skipping_values = false; // loading a lazy document (see skip_value())
+		const std::vector<toml::path>* keep_paths = {};
+		buffer_vector<size_t> filter_depths; // how much of each of keep_paths the current table has matched
+		bool filter_keep_all = true;	   // the current table is at or beneath one of keep_paths
+		source_position prev_pos = { 1, 1 };
+		const utf8_codepoint* cp = {};
+		bool more_batches		 = false; // incremental parsing: the document carries on past the current batch
+		node_set<table> implicit_tables;
+		node_set<table> dotted_key_tables;
+		buffer_vector<discarded_table> discarded_tables; // see prune_discarded_tables()
+		buffer_vector<table*> open_inline_tables;
+		node_set<array> table_arrays;
+		parse_key_buffer key_buffer;
+		buffer_string string_buffer;
+		buffer_string recording_buffer; // for diagnostics
+		bool recording = false, recording_whitespace = true;
+		std::string_view current_scope;
+		size_t nested_values = {};
+		node_arena* arena	 = {}; // see parse_options::use_arena
+#if TOML_ENABLE_SOURCES
+		bool track_sources = true; // see parse_options::omit_sources
+#else
+		static constexpr bool track_sources = false; // see TOML_ENABLE_SOURCES
+#endif
+		source_path_ptr region_path;	 // see init_source_path()
+		key_set<buffer_allocator> document_keys;
+		key_pool* interned_keys = {}; // see parse_options::interned_keys
+#if !TOML_EXCEPTIONS
+		mutable optional<parse_error> err;
+#endif
 
-								// """ """" (one at the end of the string)
-								case 4: str += '"'; return str;
+		TOML_NODISCARD
+		source_position current_position(source_index fallback_offset = 0) const noexcept
+		{
+			if (!is_eof())
+				return cp->position;
+			if (more_batches)
+				return reader.position(); // (where the next batch begins, i.e. where cp would be in one big batch)
+			return { prev_pos.line, static_cast<source_index>(prev_pos.column + fallback_offset) };
+		}
 
-								// """ """"" (two quotes at the end of the string)
-								case 5:
-									str.append("\"\""sv);
-									advance_and_return_if_error({}); // skip the last '"'
-									return str;
+		template <typename... T>
+		TOML_RETURNS_BY_THROWING
+		TOML_NEVER_INLINE
+		void set_error_at(source_position pos, const T&... reason) const
+		{
+			static_assert(sizeof...(T) > 0);
+			return_if_error();
 
-								default: TOML_UNREACHABLE;
-							}
-						}
-						else
-						{
-							advance_and_return_if_error({}); // skip the closing delimiter
-							return str;
-						}
-					}
+			error_builder builder{ current_scope };
+			(builder.append(reason), ...);
 
-					// handle escapes
-					else if (*cp == U'\\')
-					{
-						advance_and_return_if_error_or_eof({}); // skip the '\'
-						skipping_whitespace = false;
-						escaped				= true;
-						continue;
-					}
+			parse_error_break();
 
-					// handle line endings in multi-line mode
-					if (multi_line && is_ascii_vertical_whitespace(*cp))
-					{
-						consume_line_break();
-						return_if_error({});
-						if (!skipping_whitespace)
-							str += '\n';
-						continue;
-					}
+#if TOML_EXCEPTIONS
+			builder.finish(pos, reader.source_path());
+#else
+			err.emplace(builder.finish(pos, reader.source_path()));
+#endif
+		}
 
-					// handle control characters
-					if TOML_UNLIKELY(is_nontab_control_character(*cp))
-						set_error_and_return_default(
-							"unescaped control characters other than TAB (U+0009) are explicitly prohibited"sv);
+		template <typename... T>
+		TOML_RETURNS_BY_THROWING
+		void set_error(const T&... reason) const
+		{
+			set_error_at(current_position(1), reason...);
+		}
 
-#if TOML_LANG_AT_LEAST(1, 0, 0)
+		void go_back(size_t count = 1) noexcept
+		{
+			return_if_error();
+			TOML_ASSERT_ASSUME(count);
 
-					// handle surrogates in strings
-					if TOML_UNLIKELY(is_unicode_surrogate(*cp))
-						set_error_and_return_default(
-							"unescaped unicode surrogates (U+D800 to U+DFFF) are explicitly prohibited"sv);
+			cp		 = reader.step_back(count);
+			prev_pos = cp->position;
+		}
+
+		void advance()
+		{
+			return_if_error();
+			assert_not_eof();
+
+			prev_pos = cp->position;
+			cp		 = reader.read_next();
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
+			{
+				err = std::move(reader.error());
+				return;
+			}
 #endif
 
-					if (multi_line)
+			if (recording && !is_eof())
+			{
+				if (recording_whitespace || !is_whitespace(*cp))
+					recording_buffer.append(cp->bytes, cp->count);
+			}
+		}
+
+		// consumes the first `count` bytes of reader.raw_span() as if advance() had been called once per codepoint.
+		// the bytes must be complete utf-8 sequences with no line breaks (see utf8_buffered_reader::skip()).
+		void advance_raw(size_t count)
+		{
+			return_if_error();
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(count);
+
+			const auto span		  = reader.raw_span();
+			const auto head_count = cp->count;
+			TOML_ASSERT_ASSUME(count <= span.length());
+
+			// whitespace needs to be filtered out of the recording one codepoint at a time
+			if (recording && !recording_whitespace)
+			{
+				for (size_t i = head_count; i < count; i++)
+				{
+					const auto c = static_cast<unsigned char>(span[i]);
+					if (c <= 0x20u || c >= 0x80u)
 					{
-						if (!skipping_whitespace || !is_horizontal_whitespace(*cp))
-						{
-							skipping_whitespace = false;
-							str.append(cp->bytes, cp->count);
-						}
+						while (!is_eof() && !is_error() && reader.raw_span().data() < span.data() + count)
+							advance();
+						return;
 					}
-					else
-						str.append(cp->bytes, cp->count);
+				}
+			}
 
-					advance_and_return_if_error({});
+			cp = reader.skip(count);
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
+			{
+				err = std::move(reader.error());
+				return;
+			}
+#endif
+
+			prev_pos = reader.position();
+			prev_pos.column--;
+
+			if (recording)
+			{
+				recording_buffer.append(span.data() + head_count, count - head_count);
+				if (!is_eof() && (recording_whitespace || !is_whitespace(*cp)))
+					recording_buffer.append(cp->bytes, cp->count);
+			}
+		}
+
+		void start_recording(bool include_current = true) noexcept
+		{
+			return_if_error();
+
+			recording			 = true;
+			recording_whitespace = true;
+			recording_buffer.clear();
+			if (include_current && !is_eof())
+				recording_buffer.append(cp->bytes, cp->count);
+		}
+
+		void stop_recording(size_t pop_bytes = 0) noexcept
+		{
+			return_if_error();
+
+			recording = false;
+			if (pop_bytes)
+			{
+				if (pop_bytes >= recording_buffer.length())
+					recording_buffer.clear();
+				else if (pop_bytes == 1u)
+					recording_buffer.pop_back();
+				else
+					recording_buffer.erase(recording_buffer.begin()
+											   + static_cast<ptrdiff_t>(recording_buffer.length() - pop_bytes),
+										   recording_buffer.end());
+			}
+		}
+
+		bool consume_leading_whitespace()
+		{
+			return_if_error_or_eof({});
+
+			bool consumed = false;
+
+			// contiguous input: take the run of spaces and tabs in one go
+			if (const auto raw = reader.raw_span(); !raw.empty())
+			{
+				const auto len = static_cast<size_t>(
+					impl::simd().find_non_whitespace(raw.data(), raw.data() + raw.length()) - raw.data());
+				if (len)
+				{
+					consumed = true;
+					advance_raw(len);
+					return_if_error({});
 				}
 			}
-			while (!is_eof());
 
-			set_error_and_return_default("encountered end-of-file"sv);
+			while (!is_eof() && is_horizontal_whitespace(*cp))
+			{
+				if TOML_UNLIKELY(!is_ascii_horizontal_whitespace(*cp))
+					set_error_and_return_default("expected space or tab, saw '"sv, escaped_codepoint{ *cp }, "'"sv);
+
+				consumed = true;
+				advance_and_return_if_error({});
+			}
+			return consumed;
 		}
 
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		std::string_view parse_literal_string(bool multi_line)
+		bool consume_line_break()
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(*cp == U'\'');
-			push_parse_scope("literal string"sv);
+			return_if_error_or_eof({});
 
-			// skip the delimiter
-			advance_and_return_if_error_or_eof({});
+			if TOML_UNLIKELY(is_match(*cp, U'\v', U'\f'))
+				set_error_and_return_default(
+					R"(vertical tabs '\v' and form-feeds '\f' are not legal line breaks in TOML)"sv);
 
-			// multi-line strings ignore a single line ending right at the beginning
-			if (multi_line)
+			if (*cp == U'\r')
 			{
-				consume_line_break();
-				return_if_error({});
-				set_error_and_return_if_eof({});
+				advance_and_return_if_error({}); // skip \r
+
+				if TOML_UNLIKELY(is_eof())
+					set_error_and_return_default("expected '\\n' after '\\r', saw EOF"sv);
+
+				if TOML_UNLIKELY(*cp != U'\n')
+					set_error_and_return_default("expected '\\n' after '\\r', saw '"sv,
+												 escaped_codepoint{ *cp },
+												 "'"sv);
 			}
+			else if (*cp != U'\n')
+				return false;
+
+			advance_and_return_if_error({}); // skip \n
+			return true;
+		}
+
+		bool consume_rest_of_line()
+		{
+			return_if_error_or_eof({});
 
-			auto& str = string_buffer;
-			str.clear();
 			do
 			{
+				if (is_ascii_vertical_whitespace(*cp))
+					return consume_line_break();
+				else
+					advance();
 				return_if_error({});
+			}
+			while (!is_eof());
 
-				// handle closing delimiters
-				if (*cp == U'\'')
-				{
-					if (multi_line)
-					{
-						size_t lookaheads			  = {};
-						size_t consecutive_delimiters = 1;
-						do
-						{
-							advance_and_return_if_error({});
-							lookaheads++;
-							if (!is_eof() && *cp == U'\'')
-								consecutive_delimiters++;
-							else
-								break;
-						}
-						while (lookaheads < 4u);
-
-						switch (consecutive_delimiters)
-						{
-							// ''' ' (one quote somewhere in a ML string)
-							case 1: str += '\''; continue;
+			return true;
+		}
 
-							// ''' '' (two quotes somewhere in a ML string)
-							case 2: str.append("''"sv); continue;
+		bool consume_comment()
+		{
+			return_if_error_or_eof({});
 
-							// ''' ''' (the end of the string)
-							case 3: return str;
+			if (*cp != U'#')
+				return false;
 
-							// ''' '''' (one at the end of the string)
-							case 4: str += '\''; return str;
+			push_parse_scope("comment"sv);
 
-							// ''' ''''' (two quotes at the end of the string)
-							case 5:
-								str.append("''"sv);
-								advance_and_return_if_error({}); // skip the last '
-								return str;
+			advance_and_return_if_error({}); // skip the '#'
 
-							default: TOML_UNREACHABLE;
-						}
-					}
-					else
+			while (!is_eof())
+			{
+				// contiguous input: take everything up to the next line break or control character in one go
+				if (const auto raw = reader.raw_span(); !raw.empty())
+				{
+					const auto len = static_cast<size_t>(
+						impl::simd().find_comment_terminator(raw.data(), raw.data() + raw.length()) - raw.data());
+					if (len)
 					{
-						advance_and_return_if_error({}); // skip the closing delimiter
-						return str;
+						advance_raw(len);
+						return_if_error({});
+						if (is_eof())
+							break;
 					}
 				}
 
-				// handle line endings in multi-line mode
-				if (multi_line && is_ascii_vertical_whitespace(*cp))
-				{
-					consume_line_break();
-					return_if_error({});
-					str += '\n';
-					continue;
+				if (consume_line_break())
+					return true;
+				return_if_error({});
+
+#if TOML_LANG_AT_LEAST(1, 0, 0)
+
+				// toml/issues/567 (disallow non-TAB control characters in comments)
+				if TOML_UNLIKELY(is_nontab_control_character(*cp))
+					set_error_and_return_default(
+						"control characters other than TAB (U+0009) are explicitly prohibited in comments"sv);
+
+				// toml/pull/720 (disallow surrogates in comments)
+				else if TOML_UNLIKELY(is_unicode_surrogate(*cp))
+					set_error_and_return_default(
+						"unicode surrogates (U+D800 to U+DFFF) are explicitly prohibited in comments"sv);
+#endif
+
+				advance_and_return_if_error({});
+			}
+
+			return true;
+		}
+
+		TOML_NODISCARD
+		bool consume_expected_sequence(std::u32string_view seq)
+		{
+			return_if_error({});
+			TOML_ASSERT(!seq.empty());
+
+			for (auto c : seq)
+			{
+				set_error_and_return_if_eof({});
+				if (*cp != c)
+					return false;
+				advance_and_return_if_error({});
+			}
+			return true;
+		}
+
+		template <typename T>
+		TOML_NODISCARD
+		bool consume_digit_sequence(T* digits, size_t len)
+		{
+			return_if_error({});
+			TOML_ASSERT_ASSUME(digits);
+			TOML_ASSERT_ASSUME(len);
+
+			for (size_t i = 0; i < len; i++)
+			{
+				set_error_and_return_if_eof({});
+				if (!is_decimal_digit(*cp))
+					return false;
+
+				digits[i] = static_cast<T>(*cp - U'0');
+				advance_and_return_if_error({});
+			}
+			return true;
+		}
+
+		template <typename T>
+		TOML_NODISCARD
+		size_t consume_variable_length_digit_sequence(T* buffer, size_t max_len)
+		{
+			return_if_error({});
+			TOML_ASSERT_ASSUME(buffer);
+			TOML_ASSERT_ASSUME(max_len);
+
+			size_t i = {};
+			for (; i < max_len; i++)
+			{
+				if (is_eof() || !is_decimal_digit(*cp))
+					break;
+
+				buffer[i] = static_cast<T>(*cp - U'0');
+				advance_and_return_if_error({});
+			}
+			return i;
+		}
+
+		// contiguous input: appends the run of plain string characters at the head to the string buffer in one go,
+		// stopping at the first delimiter, escape character, line break or other control character.
+		// returns false if there wasn't one to append (including when the input isn't contiguous).
+		TOML_NODISCARD
+		bool append_string_run(char delimiter, char escape)
+		{
+			const auto raw = reader.raw_span();
+			if (raw.empty())
+				return false;
+
+			const auto len = static_cast<size_t>(
+				impl::simd().find_string_terminator(raw.data(), raw.data() + raw.length(), delimiter, escape)
+				- raw.data());
+			if (!len)
+				return false;
+
+			string_buffer.append(raw.data(), len);
+			advance_raw(len);
+			return true;
+		}
+
+		// contiguous input: if the string at the head is a single-line one with nothing in it that needs special
+		// handling (i.e. most of them), consumes it (up to and including the closing delimiter) and sets str to a view
+		// of it in the source, so it doesn't have to be copied into the string buffer first.
+		// returns false without consuming anything otherwise.
+		TOML_NODISCARD
+		bool read_plain_string(char delimiter, char escape, std::string_view& str)
+		{
+			const auto raw = reader.raw_span();
+			if (raw.empty())
+				return false;
+
+			const auto len = static_cast<size_t>(
+				impl::simd().find_string_terminator(raw.data(), raw.data() + raw.length(), delimiter, escape)
+				- raw.data());
+			if (len == raw.length() || raw[len] != delimiter)
+				return false;
+
+			if (len)
+			{
+				advance_raw(len);
+				return_if_error(true);
+			}
+			advance_and_return_if_error(true); // skip the closing delimiter
+
+			str = raw.substr(0u, len);
+			return true;
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		std::string_view parse_basic_string(bool multi_line)
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(*cp == U'"');
+			push_parse_scope("string"sv);
+
+			// skip the '"'
+			advance_and_return_if_error_or_eof({});
+
+			// multi-line strings ignore a single line ending right at the beginning
+			if (multi_line)
+			{
+				consume_line_break();
+				return_if_error({});
+				set_error_and_return_if_eof({});
+			}
+			else if (std::string_view plain; read_plain_string('"', '\\', plain))
+				return plain;
+
+			auto& str = string_buffer;
+			str.clear();
+			bool escaped			 = false;
+			bool skipping_whitespace = false;
+			do
+			{
+				if (escaped)
+				{
+					escaped = false;
+
+					// handle 'line ending slashes' in multi-line mode
+					if (multi_line && is_whitespace(*cp))
+					{
+						consume_leading_whitespace();
+
+						if TOML_UNLIKELY(!consume_line_break())
+							set_error_and_return_default(
+								"line-ending backslashes must be the last non-whitespace character on the line"sv);
+
+						skipping_whitespace = true;
+						return_if_error({});
+						continue;
+					}
+
+					bool skip_escaped_codepoint = true;
+					assert_not_eof();
+					switch (const auto escaped_codepoint = *cp)
+					{
+						// 'regular' escape codes
+						case U'b': str += '\b'; break;
+						case U'f': str += '\f'; break;
+						case U'n': str += '\n'; break;
+						case U'r': str += '\r'; break;
+						case U't': str += '\t'; break;
+						case U'"': str += '"'; break;
+						case U'\\': str += '\\'; break;
+
+#if TOML_LANG_UNRELEASED // toml/pull/790 (\e shorthand for \x1B)
+						case U'e': str += '\x1B'; break;
+#else
+						case U'e':
+							set_error_and_return_default(
+								"escape sequence '\\e' is not supported in TOML 1.0.0 and earlier"sv);
+#endif
+
+#if TOML_LANG_UNRELEASED // toml/pull/796 (\xHH unicode scalar sequences)
+						case U'x': [[fallthrough]];
+#else
+						case U'x':
+							set_error_and_return_default(
+								"escape sequence '\\x' is not supported in TOML 1.0.0 and earlier"sv);
+#endif
+
+						// unicode scalar sequences
+						case U'u': [[fallthrough]];
+						case U'U':
+						{
+							push_parse_scope("unicode scalar sequence"sv);
+							advance_and_return_if_error_or_eof({});
+							skip_escaped_codepoint = false;
+
+							uint32_t place_value =
+								escaped_codepoint == U'U' ? 0x10000000u : (escaped_codepoint == U'u' ? 0x1000u : 0x10u);
+							uint32_t sequence_value{};
+							while (place_value)
+							{
+								set_error_and_return_if_eof({});
+
+								if TOML_UNLIKELY(!is_hexadecimal_digit(*cp))
+									set_error_and_return_default("expected hex digit, saw '"sv, to_sv(*cp), "'"sv);
+
+								sequence_value += place_value * hex_to_dec(*cp);
+								place_value /= 16u;
+								advance_and_return_if_error({});
+							}
+
+							if TOML_UNLIKELY(is_unicode_surrogate(sequence_value))
+								set_error_and_return_default(
+									"unicode surrogates (U+D800 - U+DFFF) are explicitly prohibited"sv);
+							else if TOML_UNLIKELY(sequence_value > 0x10FFFFu)
+								set_error_and_return_default("values greater than U+10FFFF are invalid"sv);
+
+							if (sequence_value < 0x80)
+							{
+								str += static_cast<char>(sequence_value);
+							}
+							else if (sequence_value < 0x800u)
+							{
+								str += static_cast<char>((sequence_value >> 6) | 0xC0u);
+								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
+							}
+							else if (sequence_value < 0x10000u)
+							{
+								str += static_cast<char>((sequence_value >> 12) | 0xE0u);
+								str += static_cast<char>(((sequence_value >> 6) & 0x3Fu) | 0x80u);
+								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
+							}
+							else if (sequence_value < 0x110000u)
+							{
+								str += static_cast<char>((sequence_value >> 18) | 0xF0u);
+								str += static_cast<char>(((sequence_value >> 12) & 0x3Fu) | 0x80u);
+								str += static_cast<char>(((sequence_value >> 6) & 0x3Fu) | 0x80u);
+								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
+							}
+							break;
+						}
+
+							// ???
+							TOML_UNLIKELY_CASE
+						default: set_error_and_return_default("unknown escape sequence '\\"sv, to_sv(*cp), "'"sv);
+					}
+
+					if (skip_escaped_codepoint)
+						advance_and_return_if_error_or_eof({});
+				}
+				else
+				{
+					// take runs of plain characters in bulk
+					if ((!multi_line || !skipping_whitespace) && append_string_run('"', '\\'))
+					{
+						return_if_error({});
+						continue;
+					}
+
+					// handle closing delimiters
+					if (*cp == U'"')
+					{
+						if (multi_line)
+						{
+							size_t lookaheads			  = {};
+							size_t consecutive_delimiters = 1;
+							do
+							{
+								advance_and_return_if_error({});
+								lookaheads++;
+								if (!is_eof() && *cp == U'"')
+									consecutive_delimiters++;
+								else
+									break;
+							}
+							while (lookaheads < 4u);
+
+							switch (consecutive_delimiters)
+							{
+								// """ " (one quote somewhere in a ML string)
+								case 1:
+									str += '"';
+									skipping_whitespace = false;
+									continue;
+
+								// """ "" (two quotes somewhere in a ML string)
+								case 2:
+									str.append("\"\""sv);
+									skipping_whitespace = false;
+									continue;
+
+								// """ """ (the end of the string)
+								case 3: return str;
+
+								// """ """" (one at the end of the string)
+								case 4: str += '"'; return str;
+
+								// """ """"" (two quotes at the end of the string)
+								case 5:
+									str.append("\"\""sv);
+									advance_and_return_if_error({}); // skip the last '"'
+									return str;
+
+								default: TOML_UNREACHABLE;
+							}
+						}
+						else
+						{
+							advance_and_return_if_error({}); // skip the closing delimiter
+							return str;
+						}
+					}
+
+					// handle escapes
+					else if (*cp == U'\\')
+					{
+						advance_and_return_if_error_or_eof({}); // skip the '\'
+						skipping_whitespace = false;
+						escaped				= true;
+						continue;
+					}
+
+					// handle line endings in multi-line mode
+					if (multi_line && is_ascii_vertical_whitespace(*cp))
+					{
+						consume_line_break();
+						return_if_error({});
+						if (!skipping_whitespace)
+							str += '\n';
+						continue;
+					}
+
+					// handle control characters
+					if TOML_UNLIKELY(is_nontab_control_character(*cp))
+						set_error_and_return_default(
+							"unescaped control characters other than TAB (U+0009) are explicitly prohibited"sv);
+
+#if TOML_LANG_AT_LEAST(1, 0, 0)
+
+					// handle surrogates in strings
+					if TOML_UNLIKELY(is_unicode_surrogate(*cp))
+						set_error_and_return_default(
+							"unescaped unicode surrogates (U+D800 to U+DFFF) are explicitly prohibited"sv);
+#endif
+
+					if (multi_line)
+					{
+						if (!skipping_whitespace || !is_horizontal_whitespace(*cp))
+						{
+							skipping_whitespace = false;
+							str.append(cp->bytes, cp->count);
+						}
+					}
+					else
+						str.append(cp->bytes, cp->count);
+
+					advance_and_return_if_error({});
+				}
+			}
+			while (!is_eof());
+
+			set_error_and_return_default("encountered end-of-file"sv);
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		std::string_view parse_literal_string(bool multi_line)
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(*cp == U'\'');
+			push_parse_scope("literal string"sv);
+
+			// skip the delimiter
+			advance_and_return_if_error_or_eof({});
+
+			// multi-line strings ignore a single line ending right at the beginning
+			if (multi_line)
+			{
+				consume_line_break();
+				return_if_error({});
+				set_error_and_return_if_eof({});
+			}
+			else if (std::string_view plain; read_plain_string('\'', '\'', plain))
+				return plain;
+
+			auto& str = string_buffer;
+			str.clear();
+			do
+			{
+				return_if_error({});
+
+				// take runs of plain characters in bulk
+				if (append_string_run('\'', '\''))
+				{
+					return_if_error({});
+					continue;
+				}
+
+				// handle closing delimiters
+				if (*cp == U'\'')
+				{
+					if (multi_line)
+					{
+						size_t lookaheads			  = {};
+						size_t consecutive_delimiters = 1;
+						do
+						{
+							advance_and_return_if_error({});
+							lookaheads++;
+							if (!is_eof() && *cp == U'\'')
+								consecutive_delimiters++;
+							else
+								break;
+						}
+						while (lookaheads < 4u);
+
+						switch (consecutive_delimiters)
+						{
+							// ''' ' (one quote somewhere in a ML string)
+							case 1: str += '\''; continue;
+
+							// ''' '' (two quotes somewhere in a ML string)
+							case 2: str.append("''"sv); continue;
+
+							// ''' ''' (the end of the string)
+							case 3: return str;
+
+							// ''' '''' (one at the end of the string)
+							case 4: str += '\''; return str;
+
+							// ''' ''''' (two quotes at the end of the string)
+							case 5:
+								str.append("''"sv);
+								advance_and_return_if_error({}); // skip the last '
+								return str;
+
+							default: TOML_UNREACHABLE;
+						}
+					}
+					else
+					{
+						advance_and_return_if_error({}); // skip the closing delimiter
+						return str;
+					}
+				}
+
+				// handle line endings in multi-line mode
+				if (multi_line && is_ascii_vertical_whitespace(*cp))
+				{
+					consume_line_break();
+					return_if_error({});
+					str += '\n';
+					continue;
+				}
+
+				// handle control characters
+				if TOML_UNLIKELY(is_nontab_control_character(*cp))
+					set_error_and_return_default(
+						"control characters other than TAB (U+0009) are explicitly prohibited"sv);
+
+#if TOML_LANG_AT_LEAST(1, 0, 0)
+
+				// handle surrogates in strings
+				if TOML_UNLIKELY(is_unicode_surrogate(*cp))
+					set_error_and_return_default("unicode surrogates (U+D800 - U+DFFF) are explicitly prohibited"sv);
+#endif
+
+				str.append(cp->bytes, cp->count);
+				advance_and_return_if_error({});
+			}
+			while (!is_eof());
+
+			set_error_and_return_default("encountered end-of-file"sv);
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		parsed_string parse_string()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_string_delimiter(*cp));
+			push_parse_scope("string"sv);
+
+			// snapshot length so the recording buffer can be rewound alongside go_back(2u) below
+			const auto recording_buffer_rollback_size = recording_buffer.length();
+
+			// get the first three characters to determine the string type
+			const auto first = cp->value;
+			advance_and_return_if_error_or_eof({});
+			const auto second = cp->value;
+			advance_and_return_if_error({});
+			const auto third = cp ? cp->value : U'\0';
+
+			// if we were eof at the third character then first and second need to be
+			// the same string character (otherwise it's an unterminated string).
+			// (when that's just the end of a batch the document carries on, so it's a regular string like any other)
+			if (is_eof() && (second == first || !more_batches))
+			{
+				if (second == first)
+					return {};
+
+				set_error_and_return_default("encountered end-of-file"sv);
+			}
+
+			// if the first three characters are all the same string delimiter then
+			// it's a multi-line string.
+			else if (first == second && first == third)
+			{
+				return { first == U'\'' ? parse_literal_string(true) : parse_basic_string(true), true };
+			}
+
+			// otherwise it's just a regular string.
+			else
+			{
+				// step back two characters so that the current
+				// character is the string delimiter
+				go_back(2u);
+				if (recording)
+					recording_buffer.resize(recording_buffer_rollback_size);
+
+				return { first == U'\'' ? parse_literal_string(false) : parse_basic_string(false), false };
+			}
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		std::string_view parse_bare_key_segment()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_bare_key_character(*cp));
+
+			string_buffer.clear();
+
+			// contiguous input: take the ascii run in one go
+			if (const auto raw = reader.raw_span(); !raw.empty())
+			{
+				size_t len = {};
+				while (len < raw.length() && is_ascii_bare_key_character(static_cast<unsigned char>(raw[len])))
+					len++;
+
+				if (len)
+				{
+					advance_raw(len);
+					return_if_error({});
+
+					// (if that was the whole segment it can be used straight from the source)
+					if (len == raw.length() || static_cast<unsigned char>(raw[len]) < 0x80u)
+						return raw.substr(0u, len);
+					string_buffer.append(raw.data(), len);
+				}
+			}
+
+			while (!is_eof())
+			{
+				if (!is_bare_key_character(*cp))
+					break;
+
+				string_buffer.append(cp->bytes, cp->count);
+				advance_and_return_if_error({});
+			}
+
+			return string_buffer;
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		bool parse_boolean()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_match(*cp, U't', U'f', U'T', U'F'));
+			push_parse_scope("boolean"sv);
+
+			start_recording(true);
+			auto result = is_match(*cp, U't', U'T');
+			if (!consume_expected_sequence(result ? U"true"sv : U"false"sv))
+				set_error_and_return_default("expected '"sv,
+											 to_sv(result),
+											 "', saw '"sv,
+											 to_sv(recording_buffer),
+											 "'"sv);
+			stop_recording();
+
+			if (cp && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			return result;
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		double parse_inf_or_nan()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_match(*cp, U'i', U'n', U'I', U'N', U'+', U'-'));
+			push_parse_scope("floating-point"sv);
+
+			start_recording(true);
+			const bool negative = *cp == U'-';
+			if (negative || *cp == U'+')
+				advance_and_return_if_error_or_eof({});
+
+			const bool inf = is_match(*cp, U'i', U'I');
+			if (!consume_expected_sequence(inf ? U"inf"sv : U"nan"sv))
+				set_error_and_return_default("expected '"sv,
+											 inf ? "inf"sv : "nan"sv,
+											 "', saw '"sv,
+											 to_sv(recording_buffer),
+											 "'"sv);
+			stop_recording();
+
+			if (cp && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			return inf ? (negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity())
+					   : std::numeric_limits<double>::quiet_NaN();
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		double parse_float()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_match(*cp, U'+', U'-', U'.') || is_decimal_digit(*cp));
+			push_parse_scope("floating-point"sv);
+
+			// sign
+			const int sign = *cp == U'-' ? -1 : 1;
+			if (is_match(*cp, U'+', U'-'))
+				advance_and_return_if_error_or_eof({});
+
+			// consume value chars
+			char chars[utf8_buffered_reader::max_history_length];
+			size_t length			   = {};
+			const utf8_codepoint* prev = {};
+			bool seen_decimal = false, seen_exponent = false;
+			char first_integer_part = '\0';
+			while (!is_eof() && !is_value_terminator(*cp))
+			{
+				if (*cp == U'_')
+				{
+					if (!prev || !is_decimal_digit(*prev))
+						set_error_and_return_default("underscores may only follow digits"sv);
+
+					prev = cp;
+					advance_and_return_if_error_or_eof({});
+					continue;
+				}
+				else if TOML_UNLIKELY(prev && *prev == U'_' && !is_decimal_digit(*cp))
+					set_error_and_return_default("underscores must be followed by digits"sv);
+				else if TOML_UNLIKELY(length == sizeof(chars))
+					set_error_and_return_default("exceeds length limit of "sv,
+												 sizeof(chars),
+												 " digits"sv,
+												 (seen_exponent ? ""sv : " (consider using exponent notation)"sv));
+				else if (*cp == U'.')
+				{
+					// .1
+					// -.1
+					// +.1 (no integer part)
+					if (!first_integer_part)
+						set_error_and_return_default("expected decimal digit, saw '.'"sv);
+
+					// 1.0e+.10 (exponent cannot have '.')
+					else if (seen_exponent)
+						set_error_and_return_default("expected exponent decimal digit or sign, saw '.'"sv);
+
+					// 1.0.e+.10
+					// 1..0
+					// (multiple '.')
+					else if (seen_decimal)
+						set_error_and_return_default("expected decimal digit or exponent, saw '.'"sv);
+
+					seen_decimal = true;
+				}
+				else if (is_match(*cp, U'e', U'E'))
+				{
+					if (prev && !is_decimal_digit(*prev))
+						set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+
+					// 1.0ee+10 (multiple 'e')
+					else if (seen_exponent)
+						set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+
+					seen_decimal  = true; // implied
+					seen_exponent = true;
+				}
+				else if (is_match(*cp, U'+', U'-'))
+				{
+					// 1.-0 (sign in mantissa)
+					if (!seen_exponent)
+						set_error_and_return_default("expected decimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
+
+					// 1.0e1-0 (misplaced exponent sign)
+					else if (!is_match(*prev, U'e', U'E'))
+						set_error_and_return_default("expected exponent digit, saw '"sv, to_sv(*cp), "'"sv);
+				}
+				else if (is_decimal_digit(*cp))
+				{
+					if (!seen_decimal)
+					{
+						if (!first_integer_part)
+							first_integer_part = static_cast<char>(cp->bytes[0]);
+						else if (first_integer_part == '0')
+							set_error_and_return_default("leading zeroes are prohibited"sv);
+					}
+				}
+				else
+					set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+
+				chars[length++] = static_cast<char>(cp->bytes[0]);
+				prev			= cp;
+				advance_and_return_if_error({});
+			}
+
+			// sanity-check ending state
+			if (prev)
+			{
+				if (*prev == U'_')
+				{
+					set_error_and_return_if_eof({});
+					set_error_and_return_default("underscores must be followed by digits"sv);
+				}
+				else if (is_match(*prev, U'e', U'E', U'+', U'-', U'.'))
+				{
+					set_error_and_return_if_eof({});
+					set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+				}
+			}
+
+			// convert to double
+			double result;
+			if TOML_LIKELY(decimal_to_double(chars, chars + length, result))
+				return result * sign;
+
+			// (only the rare inputs the fast path can't decide get this far, as do the ones that over/underflow)
+#if TOML_FLOAT_CHARCONV
+			{
+				auto fc_result = std::from_chars(chars, chars + length, result);
+				switch (fc_result.ec)
+				{
+					TOML_LIKELY_CASE
+					case std::errc{}: // ok
+						return result * sign;
+
+					case std::errc::invalid_argument:
+						set_error_and_return_default("'"sv,
+													 std::string_view{ chars, length },
+													 "' could not be interpreted as a value"sv);
+						break;
+
+					case std::errc::result_out_of_range:
+						set_error_and_return_default("'"sv,
+													 std::string_view{ chars, length },
+													 "' is not representable in 64 bits"sv);
+						break;
+
+					default: //??
+						set_error_and_return_default("an unspecified error occurred while trying to interpret '"sv,
+													 std::string_view{ chars, length },
+													 "' as a value"sv);
+				}
+			}
+#else
+			{
+				std::stringstream ss;
+				ss.imbue(std::locale::classic());
+				ss.write(chars, static_cast<std::streamsize>(length));
+				if ((ss >> result))
+					return result * sign;
+				else
+					set_error_and_return_default("'"sv,
+												 std::string_view{ chars, length },
+												 "' could not be interpreted as a value"sv);
+			}
+#endif
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		double parse_hex_float()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_match(*cp, U'0', U'+', U'-'));
+			push_parse_scope("hexadecimal floating-point"sv);
+
+#if TOML_LANG_UNRELEASED // toml/issues/562 (hexfloats)
+
+			// sign
+			const int sign = *cp == U'-' ? -1 : 1;
+			if (is_match(*cp, U'+', U'-'))
+				advance_and_return_if_error_or_eof({});
+
+			// '0'
+			if (*cp != U'0')
+				set_error_and_return_default(" expected '0', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// 'x' or 'X'
+			if (!is_match(*cp, U'x', U'X'))
+				set_error_and_return_default("expected 'x' or 'X', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// <HEX DIGITS> ([.]<HEX DIGITS>)? [pP] [+-]? <DEC DIGITS>
+
+			// consume value fragments
+			struct fragment
+			{
+				char chars[24];
+				size_t length;
+				double value;
+			};
+			fragment fragments[] = {
+				{}, // mantissa, whole part
+				{}, // mantissa, fractional part
+				{}	// exponent
+			};
+			fragment* current_fragment = fragments;
+			const utf8_codepoint* prev = {};
+			int exponent_sign		   = 1;
+			while (!is_eof() && !is_value_terminator(*cp))
+			{
+				if (*cp == U'_')
+				{
+					if (!prev || !is_hexadecimal_digit(*prev))
+						set_error_and_return_default("underscores may only follow digits"sv);
+
+					prev = cp;
+					advance_and_return_if_error_or_eof({});
+					continue;
+				}
+				else if (prev && *prev == U'_' && !is_hexadecimal_digit(*cp))
+					set_error_and_return_default("underscores must be followed by digits"sv);
+				else if (*cp == U'.')
+				{
+					// 0x10.0p-.0 (exponent cannot have '.')
+					if (current_fragment == fragments + 2)
+						set_error_and_return_default("expected exponent digit or sign, saw '.'"sv);
+
+					// 0x10.0.p-0 (multiple '.')
+					else if (current_fragment == fragments + 1)
+						set_error_and_return_default("expected hexadecimal digit or exponent, saw '.'"sv);
+
+					else
+						current_fragment++;
+				}
+				else if (is_match(*cp, U'p', U'P'))
+				{
+					// 0x10.0pp-0 (multiple 'p')
+					if (current_fragment == fragments + 2)
+						set_error_and_return_default("expected exponent digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+
+					// 0x.p-0 (mantissa is just '.')
+					else if (fragments[0].length == 0u && fragments[1].length == 0u)
+						set_error_and_return_default("expected hexadecimal digit, saw '"sv, to_sv(*cp), "'"sv);
+
+					else
+						current_fragment = fragments + 2;
+				}
+				else if (is_match(*cp, U'+', U'-'))
+				{
+					// 0x-10.0p-0 (sign in mantissa)
+					if (current_fragment != fragments + 2)
+						set_error_and_return_default("expected hexadecimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
+
+					// 0x10.0p0- (misplaced exponent sign)
+					else if (!is_match(*prev, U'p', U'P'))
+						set_error_and_return_default("expected exponent digit, saw '"sv, to_sv(*cp), "'"sv);
+
+					else
+						exponent_sign = *cp == U'-' ? -1 : 1;
+				}
+				else if (current_fragment < fragments + 2 && !is_hexadecimal_digit(*cp))
+					set_error_and_return_default("expected hexadecimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
+				else if (current_fragment == fragments + 2 && !is_decimal_digit(*cp))
+					set_error_and_return_default("expected exponent digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+				else if (current_fragment->length == sizeof(fragment::chars))
+					set_error_and_return_default("fragment exceeeds maximum length of "sv,
+												 sizeof(fragment::chars),
+												 " characters"sv);
+				else
+					current_fragment->chars[current_fragment->length++] = static_cast<char>(cp->bytes[0]);
+
+				prev = cp;
+				advance_and_return_if_error({});
+			}
+
+			// sanity-check ending state
+			if (current_fragment != fragments + 2 || current_fragment->length == 0u)
+			{
+				set_error_and_return_if_eof({});
+				set_error_and_return_default("missing exponent"sv);
+			}
+			else if (prev && *prev == U'_')
+			{
+				set_error_and_return_if_eof({});
+				set_error_and_return_default("underscores must be followed by digits"sv);
+			}
+
+			// calculate values for the three fragments
+			for (int fragment_idx = 0; fragment_idx < 3; fragment_idx++)
+			{
+				auto& f				= fragments[fragment_idx];
+				const uint32_t base = fragment_idx == 2 ? 10u : 16u;
+
+				// left-trim zeroes
+				const char* c = f.chars;
+				size_t sig	  = {};
+				while (f.length && *c == '0')
+				{
+					f.length--;
+					c++;
+					sig++;
+				}
+				if (!f.length)
+					continue;
+
+				// calculate value
+				auto place = 1u;
+				for (size_t i = 0; i < f.length - 1u; i++)
+					place *= base;
+				uint32_t val{};
+				while (place)
+				{
+					if (base == 16)
+						val += place * hex_to_dec(*c);
+					else
+						val += place * static_cast<uint32_t>(*c - '0');
+					if (fragment_idx == 1)
+						sig++;
+					c++;
+					place /= base;
+				}
+				f.value = static_cast<double>(val);
+
+				// shift the fractional part
+				if (fragment_idx == 1)
+				{
+					while (sig--)
+						f.value /= base;
+				}
+			}
+
+			return (fragments[0].value + fragments[1].value) * pow(2.0, fragments[2].value * exponent_sign) * sign;
+
+#else // !TOML_LANG_UNRELEASED
+
+			set_error_and_return_default("hexadecimal floating-point values are not supported "
+										 "in TOML 1.0.0 and earlier"sv);
+
+#endif // !TOML_LANG_UNRELEASED
+		}
+
+		template <uint64_t base>
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		int64_t parse_integer()
+		{
+			return_if_error({});
+			assert_not_eof();
+			using traits = parse_integer_traits<base>;
+			push_parse_scope(traits::scope_qualifier);
+
+			[[maybe_unused]] int64_t sign = 1;
+			if constexpr (traits::is_signed)
+			{
+				sign = *cp == U'-' ? -1 : 1;
+				if (is_match(*cp, U'+', U'-'))
+					advance_and_return_if_error_or_eof({});
+			}
+
+			if constexpr (base == 10)
+			{
+				if (!traits::is_digit(*cp))
+					set_error_and_return_default("expected expected digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+			}
+			else
+			{
+				// '0'
+				if (*cp != U'0')
+					set_error_and_return_default("expected '0', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				// 'b', 'o', 'x'
+				if (*cp != traits::prefix_codepoint)
+					set_error_and_return_default("expected '"sv, traits::prefix, "', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				if (!traits::is_digit(*cp))
+					set_error_and_return_default("expected digit, saw '"sv, to_sv(*cp), "'"sv);
+			}
+
+			// consume digits
+			char digits[utf8_buffered_reader::max_history_length];
+			const char* digit_chars = digits;
+			size_t length			= {};
+			char32_t prev			= {};
+
+			// contiguous input: take the run of digits (and any underscores between them) in one go, using the
+			// digits straight from the source if there weren't any underscores
+			if (const auto raw = reader.raw_span(); !raw.empty())
+			{
+				const auto digit_at = [&](size_t i) noexcept
+				{ return i < raw.length() && traits::is_digit(static_cast<unsigned char>(raw[i])); };
+
+				size_t len		 = {};
+				bool underscores = false;
+				while (len < sizeof(digits))
+				{
+					while (digit_at(len))
+						len++;
+					if (!digit_at(len + 1u) || raw[len] != '_')
+						break;
+					underscores = true;
+					len++;
+				}
+
+				// (longer runs are left to the loop below to report)
+				if (len <= sizeof(digits))
+				{
+					if (underscores)
+					{
+						for (size_t i = 0; i < len; i++)
+							if (raw[i] != '_')
+								digits[length++] = raw[i];
+					}
+					else
+					{
+						digit_chars = raw.data();
+						length		= len;
+					}
+
+					advance_raw(len);
+					return_if_error({});
+					prev = static_cast<unsigned char>(raw[len - 1u]);
+				}
+			}
+
+			while (!is_eof() && !is_value_terminator(*cp))
+			{
+				if (*cp == U'_')
+				{
+					if (!traits::is_digit(prev))
+						set_error_and_return_default("underscores may only follow digits"sv);
+
+					prev = *cp;
+					advance_and_return_if_error_or_eof({});
+					continue;
+				}
+				else if TOML_UNLIKELY(prev == U'_' && !traits::is_digit(*cp))
+					set_error_and_return_default("underscores must be followed by digits"sv);
+				else if TOML_UNLIKELY(!traits::is_digit(*cp))
+					set_error_and_return_default("expected digit, saw '"sv, to_sv(*cp), "'"sv);
+				else if TOML_UNLIKELY(length == sizeof(digits))
+					set_error_and_return_default("exceeds length limit of "sv, sizeof(digits), " digits"sv);
+				else
+				{
+					// (the contiguous path above takes every digit it can see, so anything here is a fresh run)
+					TOML_ASSERT_ASSUME(digit_chars == digits);
+					digits[length++] = static_cast<char>(cp->bytes[0]);
+				}
+
+				prev = *cp;
+				advance_and_return_if_error({});
+			}
+
+			// sanity check ending state
+			if (prev == U'_')
+			{
+				set_error_and_return_if_eof({});
+				set_error_and_return_default("underscores must be followed by digits"sv);
+			}
+
+			// single digits can be converted trivially
+			if (length == 1u)
+			{
+				int64_t result;
+
+				if constexpr (base == 16)
+					result = static_cast<int64_t>(hex_to_dec(digit_chars[0]));
+				else
+					result = static_cast<int64_t>(digit_chars[0] - '0');
+
+				if constexpr (traits::is_signed)
+					result *= sign;
+
+				return result;
+			}
+
+			// bin, oct and hex allow leading zeroes so trim them first
+			const char* end = digit_chars + length;
+			const char* msd = digit_chars;
+			if constexpr (base != 10)
+			{
+				while (msd < end && *msd == '0')
+					msd++;
+				if (msd == end)
+					return 0ll;
+			}
+
+			// decimal integers do not allow leading zeroes
+			else
+			{
+				if TOML_UNLIKELY(digit_chars[0] == '0')
+					set_error_and_return_default("leading zeroes are prohibited"sv);
+			}
+
+			// range check
+			if TOML_UNLIKELY(static_cast<size_t>(end - msd) > traits::max_digits)
+				set_error_and_return_default("'"sv,
+											 traits::full_prefix,
+											 std::string_view{ digit_chars, length },
+											 "' is not representable as a signed 64-bit integer"sv);
+
+			// do the thing
+			{
+				// (max_digits is low enough that none of this can wrap around)
+				uint64_t result = {};
+				for (auto count = static_cast<size_t>(end - msd) % 8u; count; count--, msd++)
+				{
+					if constexpr (base == 16)
+						result = result * base + hex_to_dec(*msd);
+					else
+						result = result * base + static_cast<uint64_t>(*msd - '0');
+				}
+				for (; msd < end; msd += 8)
+					result = result * (base * base * base * base * base * base * base * base)
+						   + parse_eight_digits<base>(msd);
+
+				// range check
+				static constexpr auto i64_max = static_cast<uint64_t>((std::numeric_limits<int64_t>::max)());
+				if TOML_UNLIKELY(result > i64_max + (sign < 0 ? 1u : 0u))
+					set_error_and_return_default("'"sv,
+												 traits::full_prefix,
+												 std::string_view{ digit_chars, length },
+												 "' is not representable as a signed 64-bit integer"sv);
+
+				if constexpr (traits::is_signed)
+				{
+					// avoid signed multiply UB when parsing INT64_MIN
+					if TOML_UNLIKELY(sign < 0 && result == i64_max + 1u)
+						return (std::numeric_limits<int64_t>::min)();
+
+					return static_cast<int64_t>(result) * sign;
+				}
+				else
+					return static_cast<int64_t>(result);
+			}
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		date parse_date(bool part_of_datetime = false)
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
+			push_parse_scope("date"sv);
+
+			// contiguous input: "YYYY-MM-DD" all at once
+			// (anything out of the ordinary is left to the field-by-field version below so it can be reported)
+			if (const auto raw = reader.raw_span(); raw.length() >= 10u
+				&& matches_digit_pattern(load_eight_bytes(raw.data()), 0x2D00002D00000000u, 0xFF0000FF00000000u)
+				&& is_decimal_digit(static_cast<unsigned char>(raw[8]))
+				&& is_decimal_digit(static_cast<unsigned char>(raw[9])))
+			{
+				const auto digit = [&](size_t i) noexcept { return static_cast<uint32_t>(raw[i] - '0'); };
+				const auto year	 = digit(0) * 1000u + digit(1) * 100u + digit(2) * 10u + digit(3);
+				const auto month = digit(5) * 10u + digit(6);
+				const auto day	 = digit(8) * 10u + digit(9);
+				if (month && month <= 12u && day && day <= max_days_in_month(year, month))
+				{
+					advance_raw(10u);
+					return_if_error({});
+
+					if (!part_of_datetime && !is_eof() && !is_value_terminator(*cp))
+						set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+					return { year, month, day };
+				}
+			}
+
+			// "YYYY"
+			uint32_t digits[4];
+			if (!consume_digit_sequence(digits, 4u))
+				set_error_and_return_default("expected 4-digit year, saw '"sv, to_sv(cp), "'"sv);
+			const auto year = digits[3] + digits[2] * 10u + digits[1] * 100u + digits[0] * 1000u;
+			set_error_and_return_if_eof({});
+
+			// '-'
+			if (*cp != U'-')
+				set_error_and_return_default("expected '-', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// "MM"
+			if (!consume_digit_sequence(digits, 2u))
+				set_error_and_return_default("expected 2-digit month, saw '"sv, to_sv(cp), "'"sv);
+			const auto month = digits[1] + digits[0] * 10u;
+			if (month == 0u || month > 12u)
+				set_error_and_return_default("expected month between 1 and 12 (inclusive), saw "sv, month);
+			const auto max_days = max_days_in_month(year, month);
+			set_error_and_return_if_eof({});
+
+			// '-'
+			if (*cp != U'-')
+				set_error_and_return_default("expected '-', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// "DD"
+			if (!consume_digit_sequence(digits, 2u))
+				set_error_and_return_default("expected 2-digit day, saw '"sv, to_sv(cp), "'"sv);
+			const auto day = digits[1] + digits[0] * 10u;
+			if (day == 0u || day > max_days)
+				set_error_and_return_default("expected day between 1 and "sv, max_days, " (inclusive), saw "sv, day);
+
+			if (!part_of_datetime && !is_eof() && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			return { year, month, day };
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		time parse_time(bool part_of_datetime = false)
+		{
+			return_if_error({});
+			assert_not_eof();
+			push_parse_scope("time"sv); // (not necessarily a digit here; date-times only check the date part up front)
+
+			static constexpr size_t max_digits = 64; // far more than necessary but needed to allow fractional
+													 // millisecond truncation per the spec
+			uint32_t digits[max_digits];
+			auto time = toml::time{};
+
+			// contiguous input: "HH:MM:SS" all at once
+			// (anything out of the ordinary is left to the field-by-field version below so it can be reported)
+			bool read_fixed_fields = false;
+			if (const auto raw = reader.raw_span(); raw.length() >= 8u
+				&& matches_digit_pattern(load_eight_bytes(raw.data()), 0x00003A00003A0000u, 0x0000FF0000FF0000u))
+			{
+				const auto digit  = [&](size_t i) noexcept { return static_cast<uint32_t>(raw[i] - '0'); };
+				const auto hour	  = digit(0) * 10u + digit(1);
+				const auto minute = digit(3) * 10u + digit(4);
+				const auto second = digit(6) * 10u + digit(7);
+				if (hour <= 23u && minute <= 59u && second <= 59u)
+				{
+					advance_raw(8u);
+					return_if_error({});
+					time			  = toml::time{ hour, minute, second };
+					read_fixed_fields = true;
+				}
+			}
+
+			if (!read_fixed_fields)
+			{
+				// "HH"
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit hour, saw '"sv, to_sv(cp), "'"sv);
+				const auto hour = digits[1] + digits[0] * 10u;
+				if (hour > 23u)
+					set_error_and_return_default("expected hour between 0 to 59 (inclusive), saw "sv, hour);
+				set_error_and_return_if_eof({});
+
+				// ':'
+				if (*cp != U':')
+					set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				// "MM"
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit minute, saw '"sv, to_sv(cp), "'"sv);
+				const auto minute = digits[1] + digits[0] * 10u;
+				if (minute > 59u)
+					set_error_and_return_default("expected minute between 0 and 59 (inclusive), saw "sv, minute);
+				time = toml::time{ hour, minute };
+
+				// ':'
+				if constexpr (TOML_LANG_UNRELEASED) // toml/issues/671 (allow omission of seconds)
+				{
+					if (is_eof() || is_value_terminator(*cp)
+						|| (part_of_datetime && is_match(*cp, U'+', U'-', U'Z', U'z')))
+						return time;
+				}
+				else
+					set_error_and_return_if_eof({});
+				if (*cp != U':')
+					set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				// "SS"
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit second, saw '"sv, to_sv(cp), "'"sv);
+				const auto second = digits[1] + digits[0] * 10u;
+				if (second > 59u)
+					set_error_and_return_default("expected second between 0 and 59 (inclusive), saw "sv, second);
+				time.second = static_cast<decltype(time.second)>(second);
+			}
+
+			// '.' (early-exiting is allowed; fractional is optional)
+			if (is_eof() || is_value_terminator(*cp) || (part_of_datetime && is_match(*cp, U'+', U'-', U'Z', U'z')))
+				return time;
+			if (*cp != U'.')
+				set_error_and_return_default("expected '.', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// "FFFFFFFFF"
+			size_t digit_count = {};
+			uint32_t value	   = {};
+
+			// contiguous input: the digits all at once (only the first nine matter)
+			if (const auto raw = reader.raw_span(); !raw.empty())
+			{
+				while (digit_count < raw.length() && digit_count <= max_digits
+					   && is_decimal_digit(static_cast<unsigned char>(raw[digit_count])))
+					digit_count++;
+
+				if (digit_count && digit_count <= max_digits)
+				{
+					size_t i = {};
+					if (digit_count >= 8u)
+					{
+						value = static_cast<uint32_t>(parse_eight_digits<10>(raw.data()));
+						i	  = 8u;
+					}
+					for (; i < digit_count && i < 9u; i++)
+						value = value * 10u + static_cast<uint32_t>(raw[i] - '0');
+					for (; i < 9u; i++) // implicit zeros
+						value *= 10u;
+
+					advance_raw(digit_count);
+					return_if_error({});
+				}
+				else
+					digit_count = {};
+			}
+
+			if (!digit_count)
+			{
+				digit_count = consume_variable_length_digit_sequence(digits, max_digits);
+				if (!digit_count)
+				{
+					set_error_and_return_if_eof({});
+					set_error_and_return_default("expected fractional digits, saw '"sv, to_sv(*cp), "'"sv);
+				}
+				else if (!is_eof() && digit_count == max_digits && is_decimal_digit(*cp))
+					set_error_and_return_default("fractional component exceeds maximum precision of "sv, max_digits);
+
+				uint32_t place = 1u;
+				for (auto i = impl::min<size_t>(digit_count, 9u); i-- > 0u;)
+				{
+					value += digits[i] * place;
+					place *= 10u;
+				}
+				for (auto i = digit_count; i < 9u; i++) // implicit zeros
+					value *= 10u;
+			}
+
+			if (!part_of_datetime && !is_eof() && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			time.nanosecond = value;
+			return time;
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		date_time parse_date_time()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
+			push_parse_scope("date-time"sv);
+
+			// "YYYY-MM-DD"
+			auto date = parse_date(true);
+			set_error_and_return_if_eof({});
+
+			// ' ', 'T' or 't'
+			if (!is_match(*cp, U' ', U'T', U't'))
+				set_error_and_return_default("expected space, 'T' or 't', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// "HH:MM:SS.FFFFFFFFF"
+			auto time = parse_time(true);
+			return_if_error({});
+
+			// no offset
+			if (is_eof() || is_value_terminator(*cp))
+				return { date, time };
+
+			// zero offset ('Z' or 'z')
+			time_offset offset{};
+			if (is_match(*cp, U'Z', U'z'))
+				advance_and_return_if_error({});
+
+			// explicit offset ("+/-HH:MM"), all at once from contiguous input
+			// (anything out of the ordinary is left to the field-by-field version below so it can be reported)
+			else if (const auto raw = reader.raw_span(); is_fixed_width_offset(raw))
+			{
+				const auto digit = [&](size_t i) noexcept { return raw[i] - '0'; };
+				const int sign	 = raw[0] == '-' ? -1 : 1;
+				offset.minutes	 = static_cast<decltype(offset.minutes)>(
+					  ((digit(1) * 10 + digit(2)) * 60 + digit(4) * 10 + digit(5)) * sign);
+				advance_raw(6u);
+				return_if_error({});
+			}
+
+			// explicit offset ("+/-HH:MM")
+			else if (is_match(*cp, U'+', U'-'))
+			{
+				push_parse_scope("date-time offset"sv);
+
+				// sign
+				int sign = *cp == U'-' ? -1 : 1;
+				advance_and_return_if_error_or_eof({});
+
+				// "HH"
+				int digits[2];
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit hour, saw '"sv, to_sv(cp), "'"sv);
+				const auto hour = digits[1] + digits[0] * 10;
+				if (hour > 23)
+					set_error_and_return_default("expected hour between 0 and 23 (inclusive), saw "sv, hour);
+				set_error_and_return_if_eof({});
+
+				// ':'
+				if (*cp != U':')
+					set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				// "MM"
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit minute, saw '"sv, to_sv(cp), "'"sv);
+				const auto minute = digits[1] + digits[0] * 10;
+				if (minute > 59)
+					set_error_and_return_default("expected minute between 0 and 59 (inclusive), saw "sv, minute);
+				offset.minutes = static_cast<decltype(offset.minutes)>((hour * 60 + minute) * sign);
+			}
+
+			if (!is_eof() && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			return { date, time, offset };
+		}
+
+		template <typename T>
+		TOML_NODISCARD
+		parsed_value make_value(T&& val)
+		{
+			if (!discarding_values)
+				return parsed_value{ node_ptr{ new value{ static_cast<T&&>(val) } } };
+
+			auto& scratch_val = scratch.get<native_type_of<T>>();
+			scratch_val		  = static_cast<T&&>(val);
+			scratch_val.flags(value_flags::none);
+			return parsed_value{ scratch_val };
+		}
+
+		TOML_NODISCARD
+		parsed_value parse_array();
+
+		TOML_NODISCARD
+		parsed_value parse_inline_table();
+
+		// forgets the dotted key tables in a table (and beneath them), e.g. once the inline table they were in ends.
+		void forget_dotted_key_tables(const table& tbl) noexcept
+		{
+			for (auto&& [_, child] : tbl)
+			{
+				if (auto child_tbl = child.as_table(); child_tbl && dotted_key_tables.erase(child_tbl))
+					forget_dotted_key_tables(*child_tbl);
+			}
+		}
+
+		// lazy documents: skips over the value if it can be deferred (see skim_value()), adding its key and the span
+		// of its text to value_keys instead of putting it in the tree. returns false if it should be parsed as normal.
+		bool skip_value(table& tbl, key& k)
+		{
+			return_if_error(true);
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(skipping_values);
+			TOML_ASSERT_ASSUME(!recording);
+
+			const auto raw	  = reader.raw_span();
+			const auto extent = raw.empty() ? deferred_extent{} : skim_value(raw.data(), raw.data() + raw.length());
+			if (!extent.length)
+				return false;
+
+			const auto begin_pos = cp->position;
+			cp					 = reader.skip_lines(extent.length);
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
+			{
+				err = std::move(reader.error());
+				return true;
+			}
+#endif
+
+			prev_pos = reader.position();
+			prev_pos.column--;
+
+			add_value_key(tbl, std::move(k), extent.type, raw.substr(0, extent.length), begin_pos);
+			return true;
+		}
+
+		TOML_NODISCARD
+		parsed_value parse_value_known_prefixes()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(!is_control_character(*cp));
+			TOML_ASSERT_ASSUME(*cp != U'_');
+
+			switch (cp->value)
+			{
+				// arrays
+				case U'[': return parse_array();
+
+				// inline tables
+				case U'{': return parse_inline_table();
+
+				// floats beginning with '.'
+				case U'.': return make_value(parse_float());
+
+				// strings
+				case U'"': [[fallthrough]];
+				case U'\'': return make_value(parse_string().value);
+
+				default:
+				{
+					const auto cp_upper = static_cast<uint_least32_t>(cp->value) & ~0x20u;
+
+					// bools
+					if (cp_upper == 70u || cp_upper == 84u) // F or T
+						return make_value(parse_boolean());
+
+					// inf/nan
+					else if (cp_upper == 73u || cp_upper == 78u) // I or N
+						return make_value(parse_inf_or_nan());
+
+					else
+						return {};
+				}
+			}
+			TOML_UNREACHABLE;
+		}
+
+		TOML_NODISCARD
+		parsed_value parse_value()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(!is_value_terminator(*cp));
+			push_parse_scope("value"sv);
+
+			const depth_counter_scope depth_counter{ nested_values };
+			if TOML_UNLIKELY(nested_values > max_nested_values)
+				set_error_and_return_default("exceeded maximum nested value depth of "sv,
+											 max_nested_values,
+											 " (TOML_MAX_NESTED_VALUES)"sv);
+
+			// check if it begins with some control character
+			// (note that this will also fail for whitespace but we're assuming we've
+			// called consume_leading_whitespace() before calling parse_value())
+			if TOML_UNLIKELY(is_control_character(*cp))
+				set_error_and_return_default("unexpected control character"sv);
+
+			// underscores at the beginning
+			else if (*cp == U'_')
+				set_error_and_return_default("values may not begin with underscores"sv);
+
+			const auto begin_pos = cp->position;
+			parsed_value val;
+
+			do
+			{
+				TOML_ASSERT_ASSUME(!is_control_character(*cp));
+				TOML_ASSERT_ASSUME(*cp != U'_');
+
+				// detect the value type and parse accordingly,
+				// starting with value types that can be detected
+				// unambiguously from just one character.
+
+				val = parse_value_known_prefixes();
+				return_if_error({});
+				if (val)
+					break;
+
+				// value types from here down require more than one character to unambiguously identify
+				// so scan ahead and collect a set of value 'traits'.
+				enum TOML_CLOSED_FLAGS_ENUM value_traits : int
+				{
+					has_nothing	 = 0,
+					has_digits	 = 1,
+					has_b		 = 1 << 1, // as second char only (0b)
+					has_e		 = 1 << 2, // only float exponents
+					has_o		 = 1 << 3, // as second char only (0o)
+					has_p		 = 1 << 4, // only hexfloat exponents
+					has_t		 = 1 << 5,
+					has_x		 = 1 << 6, // as second or third char only (0x, -0x, +0x)
+					has_z		 = 1 << 7,
+					has_colon	 = 1 << 8,
+					has_plus	 = 1 << 9,
+					has_minus	 = 1 << 10,
+					has_dot		 = 1 << 11,
+					begins_sign	 = 1 << 12,
+					begins_digit = 1 << 13,
+					begins_zero	 = 1 << 14,
+
+					signs_msk  = has_plus | has_minus,
+					bdigit_msk = has_digits | begins_digit,
+					bzero_msk  = bdigit_msk | begins_zero,
+				};
+				value_traits traits	 = has_nothing;
+				const auto has_any	 = [&](auto t) noexcept { return (traits & t) != has_nothing; };
+				const auto has_none	 = [&](auto t) noexcept { return (traits & t) == has_nothing; };
+				const auto add_trait = [&](auto t) noexcept { traits = static_cast<value_traits>(traits | t); };
+
+				// examine the first character to get the 'begins with' traits
+				// (good fail-fast opportunity; all the remaining types begin with numeric digits or signs)
+				if (is_decimal_digit(*cp))
+				{
+					add_trait(begins_digit);
+					if (*cp == U'0')
+						add_trait(begins_zero);
+				}
+				else if (is_match(*cp, U'+', U'-'))
+					add_trait(begins_sign);
+				else
+					break;
+
+				// scan the rest of the value to determine the remaining traits
+				// (only the first few characters are needed verbatim; the rest just contribute traits)
+				char32_t chars[16];
+				size_t char_count = {}, advance_count = {};
+				bool eof_while_scanning = false;
+				const auto examine		= [&](char32_t c) noexcept
+				{
+					if (c == U'_')
+						return;
+
+					if (char_count < sizeof(chars) / sizeof(chars[0]))
+						chars[char_count] = c;
+					char_count++;
+
+					if (is_decimal_digit(c))
+						add_trait(has_digits);
+					else if (is_ascii_letter(c))
+					{
+						TOML_ASSERT_ASSUME((c >= U'a' && c <= U'z') || (c >= U'A' && c <= U'Z'));
+						switch (static_cast<char32_t>(c | 32u))
+						{
+							case U'b':
+								if (char_count == 2u && has_any(begins_zero))
+									add_trait(has_b);
+								break;
+
+							case U'e':
+								if (char_count > 1u && has_none(has_b | has_o | has_p | has_t | has_x | has_z | has_colon)
+									&& (has_none(has_plus | has_minus) || has_any(begins_sign)))
+									add_trait(has_e);
+								break;
+
+							case U'o':
+								if (char_count == 2u && has_any(begins_zero))
+									add_trait(has_o);
+								break;
+
+							case U'p':
+								if (has_any(has_x))
+									add_trait(has_p);
+								break;
+
+							case U'x':
+								if ((char_count == 2u && has_any(begins_zero))
+									|| (char_count == 3u && has_any(begins_sign) && chars[1] == U'0'))
+									add_trait(has_x);
+								break;
+
+							case U't': add_trait(has_t); break;
+							case U'z': add_trait(has_z); break;
+						}
+					}
+					else if (c <= U':')
+					{
+						TOML_ASSERT_ASSUME(c < U'0' || c > U'9');
+						switch (c)
+						{
+							case U'+': add_trait(has_plus); break;
+							case U'-': add_trait(has_minus); break;
+							case U'.': add_trait(has_dot); break;
+							case U':': add_trait(has_colon); break;
+						}
+					}
+				};
+
+				// a date followed by a space could be a date-time with a space instead of a T.
+				const auto could_be_spaced_date_time = [&]() noexcept
+				{
+					return char_count == 10u								 //
+						&& (traits | begins_zero) == (bzero_msk | has_minus) //
+						&& chars[4] == U'-'									 //
+						&& chars[7] == U'-';
+				};
+
+				// when the whole document is in memory the value can be classified straight from the source without
+				// moving the reader, so there's nothing to rewind afterwards (and no limit on how far ahead we can look).
+				// anything that isn't plain ascii is left to the codepoint-by-codepoint scan below.
+				const auto begin_traits = traits;
+				const auto raw			= reader.raw_span();
+				const auto scan_raw		= [&](size_t& pos) noexcept
+				{
+					for (; pos < raw.length(); pos++)
+					{
+						const auto c = static_cast<unsigned char>(raw[pos]);
+						if (c >= 0x80u)
+							return false;
+						if (is_value_terminator(static_cast<char32_t>(c)))
+							break;
+						examine(static_cast<char32_t>(c));
+					}
+					return true;
+				};
+				bool classified = false;
+				if (size_t pos = {}; !raw.empty() && scan_raw(pos))
+				{
+					classified		   = true;
+					eof_while_scanning = pos == raw.length();
+
+					// (how far the scan below would have read, terminator included)
+					size_t read_end = impl::min(pos + 1u, raw.length());
+
+					// force further scanning if this could have been a date-time with a space instead of a T
+					if (could_be_spaced_date_time() && pos < raw.length() && raw[pos] == ' ')
+					{
+						read_end = impl::min(pos + 2u, raw.length());
+						if (read_end - pos == 2u && raw[pos + 1u] >= '0' && raw[pos + 1u] <= '9')
+						{
+							const auto pre_scan_traits = traits;
+							chars[char_count++]		   = U' ';
+							chars[char_count++]		   = static_cast<char32_t>(raw[pos + 1u]);
+							add_trait(has_t);
+
+							pos += 2u;
+							classified = scan_raw(pos);
+							read_end   = impl::min(pos + 1u, raw.length());
+							if (classified && char_count == 12u)
+							{
+								traits	   = pre_scan_traits;
+								char_count = 10u;
+							}
+							else if (classified)
+								eof_while_scanning = pos == raw.length();
+						}
+					}
+
+					if (!classified)
+					{
+						traits	   = begin_traits;
+						char_count = {};
+					}
+
+					// nothing's been read, but an encoding error in what would have been still needs reporting first
+					else if TOML_UNLIKELY(!reader.validate_ahead(read_end))
+					{
+#if !TOML_EXCEPTIONS
+						err = std::move(reader.error());
+#endif
+						return {};
+					}
+				}
+
+				if (!classified)
+				{
+					const auto scan = [&]() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+					{
+						while (advance_count < (utf8_buffered_reader::max_history_length - 1u) && !is_eof()
+							   && !is_value_terminator(*cp))
+						{
+							examine(**cp);
+
+							advance_and_return_if_error();
+							advance_count++;
+							eof_while_scanning = is_eof();
+						}
+					};
+					scan();
+					return_if_error({});
+
+					// force further scanning if this could have been a date-time with a space instead of a T
+					if (could_be_spaced_date_time() && !is_eof() && *cp == U' ')
+					{
+						const auto pre_advance_count = advance_count;
+						const auto pre_scan_traits	 = traits;
+						chars[char_count++]			 = *cp;
+						add_trait(has_t);
+
+						const auto backpedal = [&]() noexcept
+						{
+							go_back(advance_count - pre_advance_count);
+							advance_count = pre_advance_count;
+							traits		  = pre_scan_traits;
+							char_count	  = 10u;
+						};
+
+						advance_and_return_if_error({});
+						advance_count++;
+
+						if (is_eof() || !is_decimal_digit(*cp))
+							backpedal();
+						else
+						{
+							chars[char_count++] = *cp;
+
+							advance_and_return_if_error({});
+							advance_count++;
+
+							scan();
+							return_if_error({});
+
+							if (char_count == 12u)
+								backpedal();
+						}
+					}
+
+					// set the reader back to where we started
+					go_back(advance_count);
+				}
+
+				// if after scanning ahead we still only have one value character,
+				// the only valid value type is an integer.
+				if (char_count == 1u)
+				{
+					if (has_any(begins_digit))
+					{
+						val = make_value(static_cast<int64_t>(chars[0] - U'0'));
+						advance(); // skip the digit
+						break;
+					}
+
+					// anything else would be ambiguous.
+					else
+						set_error_and_return_default(eof_while_scanning ? "encountered end-of-file"sv
+																		: "could not determine value type"sv);
+				}
+
+				// now things that can be identified from two or more characters
+				return_if_error({});
+				TOML_ASSERT_ASSUME(char_count >= 2u);
+
+				// do some 'fuzzy matching' where there's no ambiguity, since that allows the specific
+				// typed parse functions to take over and show better diagnostics if there's an issue
+				// (as opposed to the fallback "could not determine type" message)
+				if (has_any(has_p))
+					val = make_value(parse_hex_float());
+				else if (has_any(has_x | has_o | has_b))
+				{
+					int64_t i;
+					value_flags flags;
+					if (has_any(has_x))
+					{
+						i	  = parse_integer<16>();
+						flags = value_flags::format_as_hexadecimal;
+					}
+					else if (has_any(has_o))
+					{
+						i	  = parse_integer<8>();
+						flags = value_flags::format_as_octal;
+					}
+					else // has_b
+					{
+						i	  = parse_integer<2>();
+						flags = value_flags::format_as_binary;
+					}
+					return_if_error({});
+
+					val = make_value(i);
+					val->ref_cast<int64_t>().flags(flags);
+				}
+				else if (has_any(has_e) || (has_any(begins_digit) && chars[1] == U'.'))
+					val = make_value(parse_float());
+				else if (has_any(begins_sign))
+				{
+					// single-digit signed integers
+					if (char_count == 2u && has_any(has_digits))
+					{
+						val = make_value(static_cast<int64_t>(chars[1] - U'0') * (chars[0] == U'-' ? -1LL : 1LL));
+						advance(); // skip the sign
+						advance(); // skip the digit
+						break;
+					}
+
+					// simple signed floats (e.g. +1.0)
+					if (is_decimal_digit(chars[1]) && chars[2] == U'.')
+						val = make_value(parse_float());
+
+					// signed infinity or nan
+					else if (is_match(chars[1], U'i', U'n', U'I', U'N'))
+						val = make_value(parse_inf_or_nan());
+				}
+
+				return_if_error({});
+				if (val)
+					break;
+
+				// match trait masks against what they can match exclusively.
+				// all correct value parses will come out of this list, so doing this as a switch is likely to
+				// be a better friend to the optimizer on the success path (failure path can be slow but that
+				// doesn't matter much).
+				switch (unwrap_enum(traits))
+				{
+					// binary integers
+					// 0b10
+					case bzero_msk | has_b:
+						val = make_value(parse_integer<2>());
+						val->ref_cast<int64_t>().flags(value_flags::format_as_binary);
+						break;
+
+					// octal integers
+					// 0o10
+					case bzero_msk | has_o:
+						val = make_value(parse_integer<8>());
+						val->ref_cast<int64_t>().flags(value_flags::format_as_octal);
+						break;
+
+					// decimal integers
+					// 00
+					// 10
+					// +10
+					// -10
+					case bzero_msk: [[fallthrough]];
+					case bdigit_msk: [[fallthrough]];
+					case begins_sign | has_digits | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_plus:
+					{
+						// if the value was so long we exhausted the history buffer it's reasonable to assume
+						// there was more and the value's actual type is impossible to identify without making the
+						// buffer bigger (since it could have actually been a float), so emit an error.
+						//
+						// (this will likely only come up during fuzzing and similar scenarios)
+						static constexpr size_t max_numeric_value_length =
+							utf8_buffered_reader::max_history_length - 2u;
+						if TOML_UNLIKELY(!eof_while_scanning && advance_count > max_numeric_value_length)
+							set_error_and_return_default("numeric value too long to identify type - cannot exceed "sv,
+														 max_numeric_value_length,
+														 " characters"sv);
+
+						val = make_value(parse_integer<10>());
+						break;
+					}
+
+					// hexadecimal integers
+					// 0x10
+					case bzero_msk | has_x:
+						val = make_value(parse_integer<16>());
+						val->ref_cast<int64_t>().flags(value_flags::format_as_hexadecimal);
+						break;
+
+					// decimal floats
+					// 0e1
+					// 0e-1
+					// 0e+1
+					// 0.0
+					// 0.0e1
+					// 0.0e-1
+					// 0.0e+1
+					case bzero_msk | has_e: [[fallthrough]];
+					case bzero_msk | has_e | has_minus: [[fallthrough]];
+					case bzero_msk | has_e | has_plus: [[fallthrough]];
+					case bzero_msk | has_dot: [[fallthrough]];
+					case bzero_msk | has_dot | has_e: [[fallthrough]];
+					case bzero_msk | has_dot | has_e | has_minus: [[fallthrough]];
+					case bzero_msk | has_dot | has_e | has_plus: [[fallthrough]];
+					// 1e1
+					// 1e-1
+					// 1e+1
+					// 1.0
+					// 1.0e1
+					// 1.0e-1
+					// 1.0e+1
+					case bdigit_msk | has_e: [[fallthrough]];
+					case bdigit_msk | has_e | has_minus: [[fallthrough]];
+					case bdigit_msk | has_e | has_plus: [[fallthrough]];
+					case bdigit_msk | has_dot: [[fallthrough]];
+					case bdigit_msk | has_dot | has_e: [[fallthrough]];
+					case bdigit_msk | has_dot | has_e | has_minus: [[fallthrough]];
+					case bdigit_msk | has_dot | has_e | has_plus: [[fallthrough]];
+					// +1e1
+					// +1.0
+					// +1.0e1
+					// +1.0e+1
+					// +1.0e-1
+					// -1.0e+1
+					case begins_sign | has_digits | has_e | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_e | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_e | signs_msk: [[fallthrough]];
+					// -1e1
+					// -1e+1
+					// +1e-1
+					// -1.0
+					// -1.0e1
+					// -1.0e-1
+					case begins_sign | has_digits | has_e | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_e | signs_msk: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_e | has_minus:
+						val = make_value(parse_float());
+						break;
+
+					// hexadecimal floats
+					// 0x10p0
+					// 0x10p-0
+					// 0x10p+0
+					case bzero_msk | has_x | has_p: [[fallthrough]];
+					case bzero_msk | has_x | has_p | has_minus: [[fallthrough]];
+					case bzero_msk | has_x | has_p | has_plus: [[fallthrough]];
+					// -0x10p0
+					// -0x10p-0
+					// +0x10p0
+					// +0x10p+0
+					// -0x10p+0
+					// +0x10p-0
+					case begins_sign | has_digits | has_x | has_p | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_x | has_p | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_x | has_p | signs_msk: [[fallthrough]];
+					// 0x10.1p0
+					// 0x10.1p-0
+					// 0x10.1p+0
+					case bzero_msk | has_x | has_dot | has_p: [[fallthrough]];
+					case bzero_msk | has_x | has_dot | has_p | has_minus: [[fallthrough]];
+					case bzero_msk | has_x | has_dot | has_p | has_plus: [[fallthrough]];
+					// -0x10.1p0
+					// -0x10.1p-0
+					// +0x10.1p0
+					// +0x10.1p+0
+					// -0x10.1p+0
+					// +0x10.1p-0
+					case begins_sign | has_digits | has_x | has_dot | has_p | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_x | has_dot | has_p | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_x | has_dot | has_p | signs_msk:
+						val = make_value(parse_hex_float());
+						break;
+
+					// times
+					// HH:MM
+					// HH:MM:SS
+					// HH:MM:SS.FFFFFF
+					case bzero_msk | has_colon: [[fallthrough]];
+					case bzero_msk | has_colon | has_dot: [[fallthrough]];
+					case bdigit_msk | has_colon: [[fallthrough]];
+					case bdigit_msk | has_colon | has_dot: val = make_value(parse_time()); break;
+
+					// local dates
+					// YYYY-MM-DD
+					case bzero_msk | has_minus: [[fallthrough]];
+					case bdigit_msk | has_minus: val = make_value(parse_date()); break;
+
+					// date-times
+					// YYYY-MM-DDTHH:MM
+					// YYYY-MM-DDTHH:MM-HH:MM
+					// YYYY-MM-DDTHH:MM+HH:MM
+					// YYYY-MM-DD HH:MM
+					// YYYY-MM-DD HH:MM-HH:MM
+					// YYYY-MM-DD HH:MM+HH:MM
+					// YYYY-MM-DDTHH:MM:SS
+					// YYYY-MM-DDTHH:MM:SS-HH:MM
+					// YYYY-MM-DDTHH:MM:SS+HH:MM
+					// YYYY-MM-DD HH:MM:SS
+					// YYYY-MM-DD HH:MM:SS-HH:MM
+					// YYYY-MM-DD HH:MM:SS+HH:MM
+					case bzero_msk | has_minus | has_colon | has_t: [[fallthrough]];
+					case bzero_msk | signs_msk | has_colon | has_t: [[fallthrough]];
+					case bdigit_msk | has_minus | has_colon | has_t: [[fallthrough]];
+					case bdigit_msk | signs_msk | has_colon | has_t: [[fallthrough]];
+					// YYYY-MM-DDTHH:MM:SS.FFFFFF
+					// YYYY-MM-DDTHH:MM:SS.FFFFFF-HH:MM
+					// YYYY-MM-DDTHH:MM:SS.FFFFFF+HH:MM
+					// YYYY-MM-DD HH:MM:SS.FFFFFF
+					// YYYY-MM-DD HH:MM:SS.FFFFFF-HH:MM
+					// YYYY-MM-DD HH:MM:SS.FFFFFF+HH:MM
+					case bzero_msk | has_minus | has_colon | has_dot | has_t: [[fallthrough]];
+					case bzero_msk | signs_msk | has_colon | has_dot | has_t: [[fallthrough]];
+					case bdigit_msk | has_minus | has_colon | has_dot | has_t: [[fallthrough]];
+					case bdigit_msk | signs_msk | has_colon | has_dot | has_t: [[fallthrough]];
+					// YYYY-MM-DDTHH:MMZ
+					// YYYY-MM-DD HH:MMZ
+					// YYYY-MM-DDTHH:MM:SSZ
+					// YYYY-MM-DD HH:MM:SSZ
+					// YYYY-MM-DDTHH:MM:SS.FFFFFFZ
+					// YYYY-MM-DD HH:MM:SS.FFFFFFZ
+					case bzero_msk | has_minus | has_colon | has_z | has_t: [[fallthrough]];
+					case bzero_msk | has_minus | has_colon | has_dot | has_z | has_t: [[fallthrough]];
+					case bdigit_msk | has_minus | has_colon | has_z | has_t: [[fallthrough]];
+					case bdigit_msk | has_minus | has_colon | has_dot | has_z | has_t:
+						val = make_value(parse_date_time());
+						break;
 				}
+			}
+			while (false);
 
-				// handle control characters
-				if TOML_UNLIKELY(is_nontab_control_character(*cp))
-					set_error_and_return_default(
-						"control characters other than TAB (U+0009) are explicitly prohibited"sv);
-
-#if TOML_LANG_AT_LEAST(1, 0, 0)
+			if (!val)
+			{
+				set_error_at(begin_pos, "could not determine value type"sv);
+				return_after_error({});
+			}
 
-				// handle surrogates in strings
-				if TOML_UNLIKELY(is_unicode_surrogate(*cp))
-					set_error_and_return_default("unicode surrogates (U+D800 - U+DFFF) are explicitly prohibited"sv);
-#endif
+			set_region(*val.ptr, begin_pos, current_position(1));
 
-				str.append(cp->bytes, cp->count);
-				advance_and_return_if_error({});
-			}
-			while (!is_eof());
+			// (arrays and inline tables emit their own events as they're parsed)
+			if (events && val->is_value())
+				events->on_value(*val.ptr);
 
-			set_error_and_return_default("encountered end-of-file"sv);
+			return val;
 		}
 
-		TOML_NODISCARD
 		TOML_NEVER_INLINE
-		parsed_string parse_string()
+		bool parse_key()
 		{
 			return_if_error({});
 			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_string_delimiter(*cp));
-			push_parse_scope("string"sv);
-
-			// snapshot length so the recording buffer can be rewound alongside go_back(2u) below
-			const auto recording_buffer_rollback_size = recording_buffer.length();
+			TOML_ASSERT_ASSUME(is_bare_key_character(*cp) || is_string_delimiter(*cp));
+			push_parse_scope("key"sv);
 
-			// get the first three characters to determine the string type
-			const auto first = cp->value;
-			advance_and_return_if_error_or_eof({});
-			const auto second = cp->value;
-			advance_and_return_if_error({});
-			const auto third = cp ? cp->value : U'\0';
+			key_buffer.clear();
+			recording_whitespace = false;
 
-			// if we were eof at the third character then first and second need to be
-			// the same string character (otherwise it's an unterminated string)
-			if (is_eof())
+			while (!is_error())
 			{
-				if (second == first)
-					return {};
+				std::string_view key_segment;
+				const auto key_begin = current_position();
 
-				set_error_and_return_default("encountered end-of-file"sv);
-			}
+				// bare_key_segment
+				if (is_bare_key_character(*cp))
+					key_segment = parse_bare_key_segment();
 
-			// if the first three characters are all the same string delimiter then
-			// it's a multi-line string.
-			else if (first == second && first == third)
-			{
-				return { first == U'\'' ? parse_literal_string(true) : parse_basic_string(true), true };
-			}
+				// "quoted key segment"
+				else if (is_string_delimiter(*cp))
+				{
+					const auto begin_pos = cp->position;
 
-			// otherwise it's just a regular string.
-			else
-			{
-				// step back two characters so that the current
-				// character is the string delimiter
-				go_back(2u);
-				if (recording)
-					recording_buffer.resize(recording_buffer_rollback_size);
+					recording_whitespace = true;
+					parsed_string str	 = parse_string();
+					recording_whitespace = false;
+					return_if_error({});
 
-				return { first == U'\'' ? parse_literal_string(false) : parse_basic_string(false), false };
-			}
-		}
+					if (str.was_multi_line)
+					{
+						set_error_at(begin_pos,
+									 "multi-line strings are prohibited in "sv,
+									 key_buffer.empty() ? ""sv : "dotted "sv,
+									 "keys"sv);
+						return_after_error({});
+					}
+					else
+						key_segment = str.value;
+				}
 
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		std::string_view parse_bare_key_segment()
-		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_bare_key_character(*cp));
+				// ???
+				else
+					set_error_and_return_default("expected bare key starting character or string delimiter, saw '"sv,
+												 to_sv(*cp),
+												 "'"sv);
 
-			string_buffer.clear();
+				const auto key_end = current_position();
 
-			while (!is_eof())
-			{
-				if (!is_bare_key_character(*cp))
+				// whitespace following the key segment
+				consume_leading_whitespace();
+
+				// store segment
+				key_buffer.push_back(key_segment, key_begin, key_end);
+
+				if TOML_UNLIKELY(key_buffer.size() > max_dotted_keys_depth)
+					set_error_and_return_default("exceeded maximum dotted keys depth of "sv,
+												 max_dotted_keys_depth,
+												 " (TOML_MAX_DOTTED_KEYS_DEPTH)"sv);
+
+				// eof or no more key to come
+				if (is_eof() || *cp != U'.')
 					break;
 
-				string_buffer.append(cp->bytes, cp->count);
-				advance_and_return_if_error({});
+				// was a dotted key - go around again
+				advance_and_return_if_error_or_eof({});
+				consume_leading_whitespace();
+				set_error_and_return_if_eof({});
 			}
+			return_if_error({});
 
-			return string_buffer;
+			return true;
 		}
 
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		bool parse_boolean()
+		// the source path is owned by the root table; everything else in the document borrows it, so nodes and keys
+		// can be created and destroyed without touching its reference count (see source_path_ptr). sax_handlers may
+		// hang on to the keys and values they're given, so they get regions that own it.
+		void init_source_path()
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_match(*cp, U't', U'f', U'T', U'F'));
-			push_parse_scope("boolean"sv);
+			const auto& path = reader.source_path();
+			region_path		 = path;
 
-			start_recording(true);
-			auto result = is_match(*cp, U't', U'T');
-			if (!consume_expected_sequence(result ? U"true"sv : U"false"sv))
-				set_error_and_return_default("expected '"sv,
-											 to_sv(result),
-											 "', saw '"sv,
-											 to_sv(recording_buffer),
-											 "'"sv);
-			stop_recording();
+#if TOML_ENABLE_SOURCES
+			root.source_ = {};
+			if (track_sources)
+				root.source_ = { prev_pos, prev_pos, path };
+#endif
+		}
 
-			if (cp && !is_value_terminator(*cp))
-				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+		// the source region of a node or key (or an empty one if they aren't being tracked)
+		TOML_NODISCARD
+		source_region make_region(source_position begin, source_position end) const
+		{
+			if (!track_sources)
+				return {};
+			if (events)
+				return { begin, end, region_path };
+			return { begin, end, source_path_ptr{ impl::borrow_source_path_t{}, region_path } };
+		}
 
-			return result;
+		void set_region(node& nde, source_position begin, source_position end) const
+		{
+#if TOML_ENABLE_SOURCES
+			nde.source_ = make_region(begin, end);
+#else
+			TOML_UNUSED(nde);
+			TOML_UNUSED(begin);
+			TOML_UNUSED(end);
+#endif
 		}
 
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		double parse_inf_or_nan()
+		key make_key(size_t segment_index)
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_match(*cp, U'i', U'n', U'I', U'N', U'+', U'-'));
-			push_parse_scope("floating-point"sv);
-
-			start_recording(true);
-			const bool negative = *cp == U'-';
-			if (negative || *cp == U'+')
-				advance_and_return_if_error_or_eof({});
+			TOML_ASSERT(key_buffer.size() > segment_index);
 
-			const bool inf = is_match(*cp, U'i', U'I');
-			if (!consume_expected_sequence(inf ? U"inf"sv : U"nan"sv))
-				set_error_and_return_default("expected '"sv,
-											 inf ? "inf"sv : "nan"sv,
-											 "', saw '"sv,
-											 to_sv(recording_buffer),
-											 "'"sv);
-			stop_recording();
+			const auto str = key_buffer[segment_index];
+			auto src	   = make_region(key_buffer.starts[segment_index], key_buffer.ends[segment_index]);
 
-			if (cp && !is_value_terminator(*cp))
-				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+			// keys too long to be stored inline are interned, so tables with the same keys share their storage
+			if (str.length() <= key_string::max_inline_length)
+				return key{ str, std::move(src) };
 
-			return inf ? (negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity())
-					   : std::numeric_limits<double>::quiet_NaN();
+			// (a key_pool is shared with other threads, so it's only asked for keys the document hasn't seen yet)
+			const auto hash = decltype(document_keys)::hash(str);
+			if (interned_keys)
+			{
+				return key{ key_string{ document_keys.intern(str,
+															 hash,
+															 [&](std::string_view s)
+															 { return interned_keys->state_->intern(s, hash); }) },
+							std::move(src) };
+			}
+			return key{ key_string{ document_keys.intern(str, hash, shared_key_chars::create) }, std::move(src) };
 		}
 
+		// the key buffer as a list of keys for sax_handler::on_key() and sax_handler::on_table_header()
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		double parse_float()
+		buffer_vector<key>& make_event_keys()
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_match(*cp, U'+', U'-', U'.') || is_decimal_digit(*cp));
-			push_parse_scope("floating-point"sv);
+			event_keys.clear();
+			for (size_t i = 0; i < key_buffer.size(); i++)
+				event_keys.push_back(make_key(i));
+			return event_keys;
+		}
 
-			// sign
-			const int sign = *cp == U'-' ? -1 : 1;
-			if (is_match(*cp, U'+', U'-'))
-				advance_and_return_if_error_or_eof({});
+		// records a value that isn't going in the tree (see insert_parsed_value() and skip_value())
+		void add_value_key(table& tbl,
+						   key&& k,
+						   node_type type,
+						   std::string_view source = {},
+						   source_position position = {})
+		{
+			// (an implicit table given a value can't be defined by a header any more, which leaves it no different
+			// to a dotted key table; see parse_table_header())
+			if (!implicit_tables.empty() && implicit_tables.erase(&tbl))
+				dotted_key_tables.insert(&tbl);
 
-			// consume value chars
-			char chars[utf8_buffered_reader::max_history_length];
-			size_t length			   = {};
-			const utf8_codepoint* prev = {};
-			bool seen_decimal = false, seen_exponent = false;
-			char first_integer_part = '\0';
-			while (!is_eof() && !is_value_terminator(*cp))
+			value_keys->insert(&tbl == &root ? nullptr : &tbl, std::move(k), type, source, position);
+		}
+
+		// the tree is still needed when emitting events (or discarding values outside of keep_paths) so redefinitions
+		// etc. are diagnosed exactly as they would be otherwise, but only the tables go in it; everything else is
+		// parsed into a scratch value and just has its key and type added to value_keys.
+		void insert_parsed_value(table& tbl, table::const_iterator hint, key&& k, parsed_value&& val)
+		{
+			if (!discarding_values || val.owned)
 			{
-				if (*cp == U'_')
-				{
-					if (!prev || !is_decimal_digit(*prev))
-						set_error_and_return_default("underscores may only follow digits"sv);
+				tbl.emplace_hint<node_ptr>(hint, std::move(k), std::move(val.owned));
+				return;
+			}
 
-					prev = cp;
-					advance_and_return_if_error_or_eof({});
-					continue;
-				}
-				else if TOML_UNLIKELY(prev && *prev == U'_' && !is_decimal_digit(*cp))
-					set_error_and_return_default("underscores must be followed by digits"sv);
-				else if TOML_UNLIKELY(length == sizeof(chars))
-					set_error_and_return_default("exceeds length limit of "sv,
-												 sizeof(chars),
-												 " digits"sv,
-												 (seen_exponent ? ""sv : " (consider using exponent notation)"sv));
-				else if (*cp == U'.')
-				{
-					// .1
-					// -.1
-					// +.1 (no integer part)
-					if (!first_integer_part)
-						set_error_and_return_default("expected decimal digit, saw '.'"sv);
+			add_value_key(tbl, std::move(k), val->type());
+		}
 
-					// 1.0e+.10 (exponent cannot have '.')
-					else if (seen_exponent)
-						set_error_and_return_default("expected exponent decimal digit or sign, saw '.'"sv);
+		// the type of the value with the given key in a table if it isn't in the tree (see add_value_key()),
+		// or node_type::none if there isn't one
+		TOML_PURE_GETTER
+		node_type find_value_key(const table& tbl, std::string_view k) noexcept
+		{
+			const auto val = value_keys->find(&tbl == &root ? nullptr : &tbl, k);
+			return val ? val->type : node_type::none;
+		}
 
-					// 1.0.e+.10
-					// 1..0
-					// (multiple '.')
-					else if (seen_decimal)
-						set_error_and_return_default("expected decimal digit or exponent, saw '.'"sv);
+		// emits sax_handler::on_key() and returns the last segment (already copied for the handler)
+		TOML_NODISCARD
+		key key_parsed()
+		{
+			auto& keys = make_event_keys();
+			events->on_key(keys.data(), keys.size());
+			return std::move(keys.back());
+		}
 
-					seen_decimal = true;
-				}
-				else if (is_match(*cp, U'e', U'E'))
-				{
-					if (prev && !is_decimal_digit(*prev))
-						set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+		static constexpr size_t filter_diverged = static_cast<size_t>(-1);
 
-					// 1.0ee+10 (multiple 'e')
-					else if (seen_exponent)
-						set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+		// path-filtered parsing: advances filter_depths past the next component of a table header's path
+		// (a key, or the index of an element in an array-of-tables).
+		// returns true if the table there (and everything beneath it) is to be kept regardless.
+		template <typename T>
+		bool filter_advance(const T& component) noexcept
+		{
+			TOML_ASSERT(keep_paths);
+
+			for (size_t i = 0; i < keep_paths->size(); i++)
+			{
+				auto& depth = filter_depths[i];
+				if (depth == filter_diverged)
+					continue;
 
-					seen_decimal  = true; // implied
-					seen_exponent = true;
-				}
-				else if (is_match(*cp, U'+', U'-'))
+				const auto& path = (*keep_paths)[i];
+				TOML_ASSERT(depth < path.size());
+				if constexpr (std::is_same_v<T, size_t>)
 				{
-					// 1.-0 (sign in mantissa)
-					if (!seen_exponent)
-						set_error_and_return_default("expected decimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
-
-					// 1.0e1-0 (misplaced exponent sign)
-					else if (!is_match(*prev, U'e', U'E'))
-						set_error_and_return_default("expected exponent digit, saw '"sv, to_sv(*cp), "'"sv);
+					if (path[depth].type() != path_component_type::array_index || path[depth].index() != component)
+						depth = filter_diverged;
 				}
-				else if (is_decimal_digit(*cp))
+				else
 				{
-					if (!seen_decimal)
-					{
-						if (!first_integer_part)
-							first_integer_part = static_cast<char>(cp->bytes[0]);
-						else if (first_integer_part == '0')
-							set_error_and_return_default("leading zeroes are prohibited"sv);
-					}
+					if (path[depth].type() != path_component_type::key || path[depth].key() != component)
+						depth = filter_diverged;
 				}
-				else
-					set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
 
-				chars[length++] = static_cast<char>(cp->bytes[0]);
-				prev			= cp;
-				advance_and_return_if_error({});
+				if (depth != filter_diverged && ++depth == path.size())
+					filter_keep_all = true;
 			}
+			return filter_keep_all;
+		}
 
-			// sanity-check ending state
-			if (prev)
+		// path-filtered parsing: goes back to matching keep_paths from the root.
+		void reset_filter() noexcept
+		{
+			TOML_ASSERT(keep_paths);
+
+			filter_keep_all = false;
+			for (size_t i = 0; i < keep_paths->size(); i++)
 			{
-				if (*prev == U'_')
-				{
-					set_error_and_return_if_eof({});
-					set_error_and_return_default("underscores must be followed by digits"sv);
-				}
-				else if (is_match(*prev, U'e', U'E', U'+', U'-', U'.'))
+				filter_depths[i] = 0u;
+				filter_keep_all	 = filter_keep_all || (*keep_paths)[i].empty();
+			}
+		}
+
+		// path-filtered parsing: true if none of keep_paths lead through the current table header any more.
+		TOML_PURE_GETTER
+		bool filter_diverged_everywhere() const noexcept
+		{
+			for (auto depth : filter_depths)
+				if (depth != filter_diverged)
+					return false;
+			return true;
+		}
+
+		enum class header_filter : unsigned char
+		{
+			keep,
+			skip_contents, // (the array-of-tables element still gets created so the others keep their indices)
+			skip
+		};
+
+		// path-filtered parsing: matches the table header in the key buffer against keep_paths.
+		// this happens before anything is created so skipped tables are never added to the tree.
+		TOML_NODISCARD
+		header_filter filter_table_header(bool is_arr) noexcept
+		{
+			TOML_ASSERT(keep_paths);
+			TOML_ASSERT(!key_buffer.empty());
+
+			reset_filter();
+			if (filter_keep_all)
+				return header_filter::keep;
+
+			const table* parent = &root;
+			for (size_t i = 0, e = key_buffer.size(); i < e; i++)
+			{
+				const bool last = i + 1u == e;
+				if (filter_advance(key_buffer[i]))
+					return header_filter::keep;
+				if (filter_diverged_everywhere())
+					return header_filter::skip;
+
+				// (anything that doesn't exist yet will be an implicit table, or the header's table itself)
+				const node* child = parent ? parent->get(key_buffer[i]) : nullptr;
+				const array* arr  = child ? child->as_array() : nullptr;
+				if (arr && !table_arrays.contains(arr))
+					arr = nullptr;
+
+				if (arr || (last && is_arr))
 				{
-					set_error_and_return_if_eof({});
-					set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+					const size_t count = arr ? arr->size() : 0u;
+					if (filter_advance(last && is_arr ? count : count - 1u))
+						return header_filter::keep;
+					if (filter_diverged_everywhere())
+						return last ? header_filter::skip_contents : header_filter::skip;
 				}
+
+				parent = arr && !last ? arr->back().as_table() : (child ? child->as_table() : nullptr);
 			}
 
-			// convert to double
-			double result;
-#if TOML_FLOAT_CHARCONV
+			// the header leads to one or more of the kept paths, so it's only their subtrees that get kept
+			return header_filter::keep;
+		}
+
+		// path-filtered parsing: true if the key-value pair in the key buffer is at, above or beneath one of
+		// keep_paths (relative to the current table).
+		TOML_PURE_GETTER
+		bool filter_keeps_key() const noexcept
+		{
+			TOML_ASSERT(keep_paths);
+
+			if (filter_keep_all)
+				return true;
+
+			for (size_t i = 0; i < keep_paths->size(); i++)
 			{
-				auto fc_result = std::from_chars(chars, chars + length, result);
-				switch (fc_result.ec)
-				{
-					TOML_LIKELY_CASE
-					case std::errc{}: // ok
-						return result * sign;
+				auto depth = filter_depths[i];
+				if (depth == filter_diverged)
+					continue;
 
-					case std::errc::invalid_argument:
-						set_error_and_return_default("'"sv,
-													 std::string_view{ chars, length },
-													 "' could not be interpreted as a value"sv);
-						break;
+				const auto& path = (*keep_paths)[i];
+				bool matched	 = true;
+				for (size_t k = 0; matched && k < key_buffer.size() && depth < path.size(); k++, depth++)
+					matched = path[depth].type() == path_component_type::key && path[depth].key() == key_buffer[k];
+				if (matched)
+					return true;
+			}
+			return false;
+		}
 
-					case std::errc::result_out_of_range:
-						set_error_and_return_default("'"sv,
-													 std::string_view{ chars, length },
-													 "' is not representable in 64 bits"sv);
-						break;
+		// path-filtered parsing: a skipped table header doesn't add anything to the tree, but it still can't redefine
+		// anything that's already there (or a value that was discarded), so its path is checked for as far as it goes.
+		void check_skipped_table_header(bool is_arr, source_position header_begin_pos)
+		{
+			const table* parent = &root;
+			for (size_t i = 0, e = key_buffer.size(); i < e; i++)
+			{
+				const bool last				   = i + 1u == e;
+				const std::string_view segment = key_buffer[i];
+				const node* child			   = parent->get(segment);
+				const auto type				   = child ? child->type() : find_value_key(*parent, segment);
 
-					default: //??
-						set_error_and_return_default("an unspecified error occurred while trying to interpret '"sv,
-													 std::string_view{ chars, length },
-													 "' as a value"sv);
+				// (nothing beneath a table that doesn't exist yet can be a redefinition)
+				if (type == node_type::none)
+					return;
+
+				if (auto tbl = child ? child->as_table() : nullptr)
+				{
+					if (!last)
+					{
+						if (tbl->is_inline())
+						{
+							set_error("cannot insert '"sv, to_sv(recording_buffer), "' into existing inline table"sv);
+							return;
+						}
+						parent = tbl;
+						continue;
+					}
+
+					// (see the promotion of implicit tables in parse_table_header())
+					if (!is_arr && implicit_tables.contains(tbl))
+					{
+						bool ok = true;
+						for (auto& [_, grandchild] : *tbl)
+							ok = ok && (grandchild.is_table() || grandchild.is_array_of_tables());
+						if (ok)
+							return;
+					}
+				}
+				else if (auto arr = child ? child->as_array() : nullptr; arr && table_arrays.contains(arr))
+				{
+					if (!last)
+					{
+						parent = &arr->back().ref_cast<table>();
+						continue;
+					}
+					if (is_arr)
+						return;
 				}
+
+				const auto pos = last ? header_begin_pos : current_position(1);
+				if (last && !is_arr && type == node_type::table && child)
+					set_error_at(pos, "cannot redefine existing table '"sv, to_sv(recording_buffer), "'"sv);
+				else
+					set_error_at(pos,
+								 "cannot redefine existing "sv,
+								 to_sv(type),
+								 " '"sv,
+								 to_sv(recording_buffer),
+								 "' as "sv,
+								 is_arr ? "array-of-tables"sv : "table"sv);
+				return;
 			}
-#else
+		}
+
+		TOML_NODISCARD
+		table* table_header_parsed(table* tbl, bool is_arr)
+		{
+			if (events)
 			{
-				std::stringstream ss;
-				ss.imbue(std::locale::classic());
-				ss.write(chars, static_cast<std::streamsize>(length));
-				if ((ss >> result))
-					return result * sign;
-				else
-					set_error_and_return_default("'"sv,
-												 std::string_view{ chars, length },
-												 "' could not be interpreted as a value"sv);
+				const auto& keys = make_event_keys();
+				events->on_table_header(keys.data(), keys.size(), is_arr);
 			}
-#endif
+			return tbl;
 		}
 
 		TOML_NODISCARD
 		TOML_NEVER_INLINE
-		double parse_hex_float()
+		table* parse_table_header()
 		{
 			return_if_error({});
 			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_match(*cp, U'0', U'+', U'-'));
-			push_parse_scope("hexadecimal floating-point"sv);
+			TOML_ASSERT_ASSUME(*cp == U'[');
+			push_parse_scope("table header"sv);
 
-#if TOML_LANG_UNRELEASED // toml/issues/562 (hexfloats)
+			const source_position header_begin_pos = cp->position;
+			source_position header_end_pos;
+			bool is_arr = false;
 
-			// sign
-			const int sign = *cp == U'-' ? -1 : 1;
-			if (is_match(*cp, U'+', U'-'))
+			// parse header
+			{
+				// skip first '['
 				advance_and_return_if_error_or_eof({});
 
-			// '0'
-			if (*cp != U'0')
-				set_error_and_return_default(" expected '0', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+				// skip past any whitespace that followed the '['
+				const bool had_leading_whitespace = consume_leading_whitespace();
+				set_error_and_return_if_eof({});
 
-			// 'x' or 'X'
-			if (!is_match(*cp, U'x', U'X'))
-				set_error_and_return_default("expected 'x' or 'X', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+				// skip second '[' (if present)
+				if (*cp == U'[')
+				{
+					if (had_leading_whitespace)
+						set_error_and_return_default(
+							"[[array-of-table]] brackets must be contiguous (i.e. [ [ this ] ] is prohibited)"sv);
 
-			// <HEX DIGITS> ([.]<HEX DIGITS>)? [pP] [+-]? <DEC DIGITS>
+					is_arr = true;
+					advance_and_return_if_error_or_eof({});
 
-			// consume value fragments
-			struct fragment
-			{
-				char chars[24];
-				size_t length;
-				double value;
-			};
-			fragment fragments[] = {
-				{}, // mantissa, whole part
-				{}, // mantissa, fractional part
-				{}	// exponent
-			};
-			fragment* current_fragment = fragments;
-			const utf8_codepoint* prev = {};
-			int exponent_sign		   = 1;
-			while (!is_eof() && !is_value_terminator(*cp))
-			{
-				if (*cp == U'_')
-				{
-					if (!prev || !is_hexadecimal_digit(*prev))
-						set_error_and_return_default("underscores may only follow digits"sv);
+					// skip past any whitespace that followed the '['
+					consume_leading_whitespace();
+					set_error_and_return_if_eof({});
+				}
 
-					prev = cp;
+				// check for a premature closing ']'
+				if (*cp == U']')
+					set_error_and_return_default("tables with blank bare keys are explicitly prohibited"sv);
+
+				if (!is_bare_key_character(*cp) && !is_string_delimiter(*cp))
+					set_error_and_return_default("expected bare key starting character or string delimiter, saw '"sv,
+												 to_sv(*cp),
+												 "'"sv);
+
+				// get the actual key
+				start_recording();
+				parse_key();
+				stop_recording(1u);
+				return_if_error({});
+
+				// skip past any whitespace that followed the key
+				consume_leading_whitespace();
+				return_if_error({});
+				set_error_and_return_if_eof({});
+
+				// consume the closing ']'
+				if (*cp != U']')
+					set_error_and_return_default("expected ']', saw '"sv, to_sv(*cp), "'"sv);
+				if (is_arr)
+				{
 					advance_and_return_if_error_or_eof({});
-					continue;
+					if (*cp != U']')
+						set_error_and_return_default("expected ']', saw '"sv, to_sv(*cp), "'"sv);
 				}
-				else if (prev && *prev == U'_' && !is_hexadecimal_digit(*cp))
-					set_error_and_return_default("underscores must be followed by digits"sv);
-				else if (*cp == U'.')
+				advance_and_return_if_error({});
+				header_end_pos = current_position(1);
+
+				// handle the rest of the line after the header
+				consume_leading_whitespace();
+				if (!is_eof() && !consume_comment() && !consume_line_break())
+					set_error_and_return_default("expected a comment or whitespace, saw '"sv, to_sv(cp), "'"sv);
+			}
+			TOML_ASSERT(!key_buffer.empty());
+
+			// path-filtered parsing: tables outside of keep_paths aren't created at all
+			// (their contents are still parsed, just not kept)
+			bool keep_contents = true;
+			if (keep_paths)
+			{
+				const auto filtered = filter_table_header(is_arr);
+				if (filtered == header_filter::skip)
+				{
+					check_skipped_table_header(is_arr, header_begin_pos);
+					return nullptr;
+				}
+				keep_contents = filtered == header_filter::keep;
+			}
+
+			// check if each parent is a table/table array, or can be created implicitly as a table.
+			table* parent = &root;
+			for (size_t i = 0, e = key_buffer.size() - 1u; i < e; i++)
+			{
+				const std::string_view segment = key_buffer[i];
+				auto pit					   = parent->lower_bound(segment);
+
+				// parent already existed
+				if (pit != parent->end() && pit->first == segment)
 				{
-					// 0x10.0p-.0 (exponent cannot have '.')
-					if (current_fragment == fragments + 2)
-						set_error_and_return_default("expected exponent digit or sign, saw '.'"sv);
+					node& p = pit->second;
 
-					// 0x10.0.p-0 (multiple '.')
-					else if (current_fragment == fragments + 1)
-						set_error_and_return_default("expected hexadecimal digit or exponent, saw '.'"sv);
+					if (auto tbl = p.as_table())
+					{
+						// adding to closed inline tables is illegal
+						if (tbl->is_inline() && !impl::find(open_inline_tables.begin(), open_inline_tables.end(), tbl))
+							set_error_and_return_default("cannot insert '"sv,
+														 to_sv(recording_buffer),
+														 "' into existing inline table"sv);
 
+						parent = tbl;
+					}
+					else if (auto arr = p.as_array(); arr && table_arrays.contains(arr))
+					{
+						// table arrays are a special case;
+						// the spec dictates we select the most recently declared element in the array.
+						TOML_ASSERT(!arr->empty());
+						TOML_ASSERT(arr->back().is_table());
+						parent = &arr->back().ref_cast<table>();
+					}
 					else
-						current_fragment++;
+					{
+						if (!is_arr && p.type() == node_type::table)
+							set_error_and_return_default("cannot redefine existing table '"sv,
+														 to_sv(recording_buffer),
+														 "'"sv);
+						else
+							set_error_and_return_default("cannot redefine existing "sv,
+														 to_sv(p.type()),
+														 " '"sv,
+														 to_sv(recording_buffer),
+														 "' as "sv,
+														 is_arr ? "array-of-tables"sv : "table"sv);
+					}
 				}
-				else if (is_match(*cp, U'p', U'P'))
+
+				// parent was a value (when emitting events)
+				else if (const auto type = find_value_key(*parent, segment); type != node_type::none)
 				{
-					// 0x10.0pp-0 (multiple 'p')
-					if (current_fragment == fragments + 2)
-						set_error_and_return_default("expected exponent digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+					set_error_and_return_default("cannot redefine existing "sv,
+												 to_sv(type),
+												 " '"sv,
+												 to_sv(recording_buffer),
+												 "' as "sv,
+												 is_arr ? "array-of-tables"sv : "table"sv);
+				}
 
-					// 0x.p-0 (mantissa is just '.')
-					else if (fragments[0].length == 0u && fragments[1].length == 0u)
-						set_error_and_return_default("expected hexadecimal digit, saw '"sv, to_sv(*cp), "'"sv);
+				// need to create a new implicit table
+				else
+				{
+					pit		  = parent->emplace_hint<table>(pit, make_key(i));
+					table& p = pit->second.ref_cast<table>();
+					set_region(p, header_begin_pos, header_end_pos);
 
-					else
-						current_fragment = fragments + 2;
+					implicit_tables.insert(&p);
+					parent = &p;
 				}
-				else if (is_match(*cp, U'+', U'-'))
+			}
+
+			const auto last_segment = key_buffer.back();
+			auto it					= parent->lower_bound(last_segment);
+
+			// if there was already a matching node some sanity checking is necessary;
+			// this is ok if we're making an array and the existing element is already an array (new element)
+			// or if we're making a table and the existing element is an implicitly-created table (promote it),
+			// otherwise this is a redefinition error.
+			if (it != parent->end() && it->first == last_segment)
+			{
+				node& matching_node = it->second;
+				if (auto arr = matching_node.as_array(); is_arr && arr && table_arrays.contains(arr))
 				{
-					// 0x-10.0p-0 (sign in mantissa)
-					if (current_fragment != fragments + 2)
-						set_error_and_return_default("expected hexadecimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
+					table& tbl = arr->emplace_back<table>();
+					set_region(tbl, header_begin_pos, header_end_pos);
+					return table_header_parsed(keep_contents ? &tbl : nullptr, is_arr);
+				}
 
-					// 0x10.0p0- (misplaced exponent sign)
-					else if (!is_match(*prev, U'p', U'P'))
-						set_error_and_return_default("expected exponent digit, saw '"sv, to_sv(*cp), "'"sv);
+				else if (auto tbl = matching_node.as_table(); !is_arr && tbl && !implicit_tables.empty())
+				{
+					if (implicit_tables.contains(tbl))
+					{
+						bool ok = true;
+						if (!tbl->empty())
+						{
+							for (auto& [_, child] : *tbl)
+							{
+								if (!child.is_table() && !child.is_array_of_tables())
+								{
+									ok = false;
+									break;
+								}
+							}
+						}
 
-					else
-						exponent_sign = *cp == U'-' ? -1 : 1;
+						if (ok)
+						{
+							implicit_tables.erase(tbl);
+#if TOML_ENABLE_SOURCES
+							if (track_sources)
+							{
+								tbl->source_.begin = header_begin_pos;
+								tbl->source_.end   = header_end_pos;
+							}
+#endif
+							return table_header_parsed(tbl, is_arr);
+						}
+					}
 				}
-				else if (current_fragment < fragments + 2 && !is_hexadecimal_digit(*cp))
-					set_error_and_return_default("expected hexadecimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
-				else if (current_fragment == fragments + 2 && !is_decimal_digit(*cp))
-					set_error_and_return_default("expected exponent digit or sign, saw '"sv, to_sv(*cp), "'"sv);
-				else if (current_fragment->length == sizeof(fragment::chars))
-					set_error_and_return_default("fragment exceeeds maximum length of "sv,
-												 sizeof(fragment::chars),
-												 " characters"sv);
-				else
-					current_fragment->chars[current_fragment->length++] = static_cast<char>(cp->bytes[0]);
 
-				prev = cp;
-				advance_and_return_if_error({});
+				// if we get here it's a redefinition error.
+				if (!is_arr && matching_node.type() == node_type::table)
+				{
+					set_error_at(header_begin_pos,
+								 "cannot redefine existing table '"sv,
+								 to_sv(recording_buffer),
+								 "'"sv);
+					return_after_error({});
+				}
+				else
+				{
+					set_error_at(header_begin_pos,
+								 "cannot redefine existing "sv,
+								 to_sv(matching_node.type()),
+								 " '"sv,
+								 to_sv(recording_buffer),
+								 "' as "sv,
+								 is_arr ? "array-of-tables"sv : "table"sv);
+					return_after_error({});
+				}
 			}
 
-			// sanity-check ending state
-			if (current_fragment != fragments + 2 || current_fragment->length == 0u)
-			{
-				set_error_and_return_if_eof({});
-				set_error_and_return_default("missing exponent"sv);
-			}
-			else if (prev && *prev == U'_')
+			// likewise if there was a matching value (when emitting events)
+			else if (const auto type = find_value_key(*parent, last_segment); type != node_type::none)
 			{
-				set_error_and_return_if_eof({});
-				set_error_and_return_default("underscores must be followed by digits"sv);
+				set_error_at(header_begin_pos,
+							 "cannot redefine existing "sv,
+							 to_sv(type),
+							 " '"sv,
+							 to_sv(recording_buffer),
+							 "' as "sv,
+							 is_arr ? "array-of-tables"sv : "table"sv);
+				return_after_error({});
 			}
 
-			// calculate values for the three fragments
-			for (int fragment_idx = 0; fragment_idx < 3; fragment_idx++)
+			// there was no matching node, sweet - we can freely instantiate a new table/table array.
+			else
 			{
-				auto& f				= fragments[fragment_idx];
-				const uint32_t base = fragment_idx == 2 ? 10u : 16u;
+				auto last_key = make_key(key_buffer.size() - 1u);
 
-				// left-trim zeroes
-				const char* c = f.chars;
-				size_t sig	  = {};
-				while (f.length && *c == '0')
+				// if it's an array we need to make the array and it's first table element,
+				// set the starting regions, and return the table element
+				if (is_arr)
 				{
-					f.length--;
-					c++;
-					sig++;
-				}
-				if (!f.length)
-					continue;
+					it			   = parent->emplace_hint<array>(it, std::move(last_key));
+					array& tbl_arr = it->second.ref_cast<array>();
+					table_arrays.insert(&tbl_arr);
+					set_region(tbl_arr, header_begin_pos, header_end_pos);
 
-				// calculate value
-				auto place = 1u;
-				for (size_t i = 0; i < f.length - 1u; i++)
-					place *= base;
-				uint32_t val{};
-				while (place)
-				{
-					if (base == 16)
-						val += place * hex_to_dec(*c);
-					else
-						val += place * static_cast<uint32_t>(*c - '0');
-					if (fragment_idx == 1)
-						sig++;
-					c++;
-					place /= base;
+					table& tbl = tbl_arr.emplace_back<table>();
+					set_region(tbl, header_begin_pos, header_end_pos);
+					return table_header_parsed(keep_contents ? &tbl : nullptr, is_arr);
 				}
-				f.value = static_cast<double>(val);
 
-				// shift the fractional part
-				if (fragment_idx == 1)
+				// otherwise we're just making a table
+				else
 				{
-					while (sig--)
-						f.value /= base;
+					it		   = parent->emplace_hint<table>(it, std::move(last_key));
+					table& tbl = it->second.ref_cast<table>();
+					set_region(tbl, header_begin_pos, header_end_pos);
+					return table_header_parsed(&tbl, is_arr);
 				}
 			}
+		}
 
-			return (fragments[0].value + fragments[1].value) * pow(2.0, fragments[2].value * exponent_sign) * sign;
+		// path-filtered parsing: parses a value just to check it for errors, without keeping it.
+		bool discard_value()
+		{
+			TOML_ASSERT(!events);
 
-#else // !TOML_LANG_UNRELEASED
+			discarding_values = true;
+			static_cast<void>(parse_value());
+			discarding_values = false;
+			return_if_error({});
+			return true;
+		}
 
-			set_error_and_return_default("hexadecimal floating-point values are not supported "
-										 "in TOML 1.0.0 and earlier"sv);
+		TOML_NEVER_INLINE
+		bool parse_key_value_pair_and_insert(table* tbl)
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_string_delimiter(*cp) || is_bare_key_character(*cp));
+			push_parse_scope("key-value pair"sv);
 
-#endif // !TOML_LANG_UNRELEASED
-		}
+			// read the key into the key buffer
+			start_recording();
+			parse_key();
+			stop_recording(1u);
+			return_if_error({});
+			TOML_ASSERT(key_buffer.size() >= 1u);
+
+			// skip past any whitespace that followed the key
+			consume_leading_whitespace();
+			set_error_and_return_if_eof({});
+
+			// '='
+			if (*cp != U'=')
+				set_error_and_return_default("expected '=', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// skip past any whitespace that followed the '='
+			consume_leading_whitespace();
+			return_if_error({});
+			set_error_and_return_if_eof({});
+
+			// check that the next character could actually be a value
+			if (is_value_terminator(*cp))
+				set_error_and_return_default("expected value, saw '"sv, to_sv(*cp), "'"sv);
+
+			// path-filtered parsing: key-value pairs in tables that were skipped are just checked for errors.
+			// those outside of keep_paths in tables that weren't go through the same checks as everything else,
+			// but their values are discarded like when emitting events (see insert_parsed_value())
+			if (!tbl)
+				return discard_value();
+			const bool discard = keep_paths && open_inline_tables.empty() && !filter_keeps_key();
+
+			// if it's a dotted kvp we need to spawn the parent sub-tables if necessary,
+			// and set the target table to the second-to-last one in the chain
+			if (key_buffer.size() > 1u)
+			{
+				for (size_t i = 0; i < key_buffer.size() - 1u; i++)
+				{
+					const std::string_view segment = key_buffer[i];
+					auto pit					   = tbl->lower_bound(segment);
+
+					// parent already existed
+					if (pit != tbl->end() && pit->first == segment)
+					{
+						table* p = pit->second.as_table();
+
+						// redefinition
+						if TOML_UNLIKELY(!p || !(dotted_key_tables.contains(p) || implicit_tables.contains(p)))
+						{
+							set_error_at(key_buffer.starts[i],
+										 "cannot redefine existing "sv,
+										 to_sv(pit->second.type()),
+										 " as dotted key-value pair"sv);
+							return_after_error({});
+						}
+
+						tbl = p;
+					}
+
+					// parent was a value (when emitting events)
+					else if (const auto type = find_value_key(*tbl, segment); type != node_type::none)
+					{
+						set_error_at(key_buffer.starts[i],
+									 "cannot redefine existing "sv,
+									 to_sv(type),
+									 " as dotted key-value pair"sv);
+						return_after_error({});
+					}
 
-		template <uint64_t base>
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		int64_t parse_integer()
-		{
-			return_if_error({});
-			assert_not_eof();
-			using traits = parse_integer_traits<base>;
-			push_parse_scope(traits::scope_qualifier);
+					// need to create a new implicit table
+					else
+					{
+						pit		  = tbl->emplace_hint<table>(pit, make_key(i));
+						table& p = pit->second.ref_cast<table>();
+						set_region(p, pit->first.source().begin, pit->first.source().end);
 
-			[[maybe_unused]] int64_t sign = 1;
-			if constexpr (traits::is_signed)
-			{
-				sign = *cp == U'-' ? -1 : 1;
-				if (is_match(*cp, U'+', U'-'))
-					advance_and_return_if_error_or_eof({});
+						dotted_key_tables.insert(&p);
+						if (discard)
+							discarded_tables.push_back({ tbl, pit->first });
+						tbl = &p;
+					}
+				}
 			}
 
-			if constexpr (base == 10)
+			// ensure this isn't a redefinition
+			const std::string_view last_segment = key_buffer.back();
+			auto it								= tbl->lower_bound(last_segment);
+			auto existing_type = it != tbl->end() && it->first == last_segment ? it->second.type() : node_type::none;
+			if (existing_type == node_type::none)
+				existing_type = find_value_key(*tbl, last_segment);
+			if (existing_type != node_type::none)
 			{
-				if (!traits::is_digit(*cp))
-					set_error_and_return_default("expected expected digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+				set_error("cannot redefine existing "sv, to_sv(existing_type), " '"sv, to_sv(recording_buffer), "'"sv);
+				return_after_error({});
 			}
-			else
-			{
-				// '0'
-				if (*cp != U'0')
-					set_error_and_return_default("expected '0', saw '"sv, to_sv(*cp), "'"sv);
-				advance_and_return_if_error_or_eof({});
 
-				// 'b', 'o', 'x'
-				if (*cp != traits::prefix_codepoint)
-					set_error_and_return_default("expected '"sv, traits::prefix, "', saw '"sv, to_sv(*cp), "'"sv);
-				advance_and_return_if_error_or_eof({});
+			// create the key first since the key buffer will likely get overwritten during value parsing (inline
+			// tables)
+			auto last_key = events ? key_parsed() : make_key(key_buffer.size() - 1u);
 
-				if (!traits::is_digit(*cp))
-					set_error_and_return_default("expected digit, saw '"sv, to_sv(*cp), "'"sv);
+			// now we can actually parse the value
+			// (or not, for lazy documents; the inline tables they do parse are parsed in their entirety)
+			if (skipping_values && open_inline_tables.empty() && skip_value(*tbl, last_key))
+			{
+				return_if_error({});
+				return true;
 			}
 
-			// consume digits
-			char digits[utf8_buffered_reader::max_history_length];
-			size_t length			   = {};
-			const utf8_codepoint* prev = {};
-			while (!is_eof() && !is_value_terminator(*cp))
-			{
-				if (*cp == U'_')
-				{
-					if (!prev || !traits::is_digit(*prev))
-						set_error_and_return_default("underscores may only follow digits"sv);
+			const bool was_discarding = discarding_values;
+			discarding_values		  = was_discarding || discard;
+			parsed_value val		  = parse_value();
+			return_if_error({});
 
-					prev = cp;
-					advance_and_return_if_error_or_eof({});
-					continue;
-				}
-				else if TOML_UNLIKELY(prev && *prev == U'_' && !traits::is_digit(*cp))
-					set_error_and_return_default("underscores must be followed by digits"sv);
-				else if TOML_UNLIKELY(!traits::is_digit(*cp))
-					set_error_and_return_default("expected digit, saw '"sv, to_sv(*cp), "'"sv);
-				else if TOML_UNLIKELY(length == sizeof(digits))
-					set_error_and_return_default("exceeds length limit of "sv, sizeof(digits), " digits"sv);
-				else
-					digits[length++] = static_cast<char>(cp->bytes[0]);
+			// (discarded inline tables still go in the tree; see discarded_tables)
+			if (discard && val.owned)
+				discarded_tables.push_back({ tbl, last_key });
 
-				prev = cp;
-				advance_and_return_if_error({});
-			}
+			insert_parsed_value(*tbl, it, std::move(last_key), std::move(val));
+			discarding_values = was_discarding;
+			return true;
+		}
 
-			// sanity check ending state
-			if (prev && *prev == U'_')
-			{
-				set_error_and_return_if_eof({});
-				set_error_and_return_default("underscores must be followed by digits"sv);
-			}
+		void parse_document()
+		{
+			assert_not_error();
+			assert_not_eof();
+			push_parse_scope("root table"sv);
 
-			// single digits can be converted trivially
-			if (length == 1u)
+			if (!current_table)
+				current_table = &root;
+
+			do
 			{
-				int64_t result;
+				return_if_error();
 
-				if constexpr (base == 16)
-					result = static_cast<int64_t>(hex_to_dec(digits[0]));
-				else
-					result = static_cast<int64_t>(digits[0] - '0');
+				// leading whitespace, line endings, comments
+				if (consume_leading_whitespace() || consume_line_break() || consume_comment())
+					continue;
+				return_if_error();
 
-				if constexpr (traits::is_signed)
-					result *= sign;
+				// [tables]
+				// [[table array]]
+				if (*cp == U'[')
+					current_table = parse_table_header();
 
-				return result;
-			}
+				// bare_keys
+				// dotted.keys
+				// "quoted keys"
+				else if (is_bare_key_character(*cp) || is_string_delimiter(*cp))
+				{
+					push_parse_scope("key-value pair"sv);
 
-			// bin, oct and hex allow leading zeroes so trim them first
-			const char* end = digits + length;
-			const char* msd = digits;
-			if constexpr (base != 10)
-			{
-				while (msd < end && *msd == '0')
-					msd++;
-				if (msd == end)
-					return 0ll;
-			}
+					parse_key_value_pair_and_insert(current_table);
 
-			// decimal integers do not allow leading zeroes
-			else
-			{
-				if TOML_UNLIKELY(digits[0] == '0')
-					set_error_and_return_default("leading zeroes are prohibited"sv);
+					// handle the rest of the line after the kvp
+					// (this is not done in parse_key_value_pair() because that is also used for inline tables)
+					consume_leading_whitespace();
+					return_if_error();
+					if (!is_eof() && !consume_comment() && !consume_line_break())
+						set_error("expected a comment or whitespace, saw '"sv, to_sv(cp), "'"sv);
+				}
+
+				else // ??
+					set_error("expected keys, tables, whitespace or comments, saw '"sv, to_sv(cp), "'"sv);
 			}
+			while (!is_eof());
+		}
 
-			// range check
-			if TOML_UNLIKELY(static_cast<size_t>(end - msd) > traits::max_digits)
-				set_error_and_return_default("'"sv,
-											 traits::full_prefix,
-											 std::string_view{ digits, length },
-											 "' is not representable as a signed 64-bit integer"sv);
+		static void update_region_ends(node& nde) noexcept
+		{
+#if TOML_ENABLE_SOURCES
+			const auto type = nde.type();
+			if (type > node_type::array)
+				return;
 
-			// do the thing
+			if (type == node_type::table)
 			{
-				uint64_t result = {};
-				{
-					uint64_t power = 1;
-					while (--end >= msd)
-					{
-						if constexpr (base == 16)
-							result += power * hex_to_dec(*end);
-						else
-							result += power * static_cast<uint64_t>(*end - '0');
+				auto& tbl = nde.ref_cast<table>();
+				if (tbl.is_inline()) // inline tables (and all their inline descendants) are already correctly
+									 // terminated
+					return;
 
-						power *= base;
-					}
+				auto end = nde.source_.end;
+				for (auto&& [k, v] : tbl)
+				{
+					TOML_UNUSED(k);
+					update_region_ends(v);
+					if (end < v.source_.end)
+						end = v.source_.end;
 				}
-
-				// range check
-				static constexpr auto i64_max = static_cast<uint64_t>((std::numeric_limits<int64_t>::max)());
-				if TOML_UNLIKELY(result > i64_max + (sign < 0 ? 1u : 0u))
-					set_error_and_return_default("'"sv,
-												 traits::full_prefix,
-												 std::string_view{ digits, length },
-												 "' is not representable as a signed 64-bit integer"sv);
-
-				if constexpr (traits::is_signed)
+			}
+			else // arrays
+			{
+				auto& arr = nde.ref_cast<array>();
+				auto end  = nde.source_.end;
+				for (auto&& v : arr)
 				{
-					// avoid signed multiply UB when parsing INT64_MIN
-					if TOML_UNLIKELY(sign < 0 && result == i64_max + 1u)
-						return (std::numeric_limits<int64_t>::min)();
-
-					return static_cast<int64_t>(result) * sign;
+					update_region_ends(v);
+					if (end < v.source_.end)
+						end = v.source_.end;
 				}
-				else
-					return static_cast<int64_t>(result);
+				nde.source_.end = end;
 			}
+#else
+			TOML_UNUSED(nde);
+#endif
 		}
 
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		date parse_date(bool part_of_datetime = false)
+		static buffer_allocator get_buffer_allocator(const parse_options* options) noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
-			push_parse_scope("date"sv);
+#if TOML_HAS_MEMORY_RESOURCE && TOML_ENABLE_ARENA
+			if (options && options->memory_resource)
+				return buffer_allocator{ options->memory_resource };
+#else
+			TOML_UNUSED(options);
+#endif
+			return buffer_allocator{};
+		}
 
-			// "YYYY"
-			uint32_t digits[4];
-			if (!consume_digit_sequence(digits, 4u))
-				set_error_and_return_default("expected 4-digit year, saw '"sv, to_sv(cp), "'"sv);
-			const auto year			= digits[3] + digits[2] * 10u + digits[1] * 100u + digits[0] * 1000u;
-			const auto is_leap_year = (year % 4u == 0u) && ((year % 100u != 0u) || (year % 400u == 0u));
-			set_error_and_return_if_eof({});
+	  public:
+		// incremental parsing: nothing is read until parse_batch() is called
+		explicit parser(utf8_reader_interface& reader_,
+						sax_handler* handler					= nullptr,
+						value_key_set* skipped_values			= nullptr,
+						const parse_options* options			= nullptr) //
+			: reader{ reader_ },
+			  events{ handler },
+			  discarding_values{ handler != nullptr },
+			  event_keys(get_buffer_allocator(options)),
+			  discarded_value_keys(get_buffer_allocator(options)),
+			  value_keys{ skipped_values ? skipped_values : &discarded_value_keys },
+			  skipping_values{ skipped_values != nullptr },
+			  filter_depths(get_buffer_allocator(options)),
+			  implicit_tables(get_buffer_allocator(options)),
+			  dotted_key_tables(get_buffer_allocator(options)),
+			  discarded_tables(get_buffer_allocator(options)),
+			  open_inline_tables(get_buffer_allocator(options)),
+			  table_arrays(get_buffer_allocator(options)),
+			  key_buffer(get_buffer_allocator(options)),
+			  string_buffer(get_buffer_allocator(options)),
+			  recording_buffer(get_buffer_allocator(options)),
+			  document_keys(get_buffer_allocator(options))
+		{
+			if (options)
+			{
+				interned_keys = options->interned_keys;
+#if TOML_ENABLE_SOURCES
+				track_sources = !options->omit_sources;
+#endif
+			}
 
-			// '-'
-			if (*cp != U'-')
-				set_error_and_return_default("expected '-', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+			if (options && !options->keep_paths.empty())
+			{
+				keep_paths = &options->keep_paths;
+				filter_depths.resize(keep_paths->size());
+				reset_filter();
+			}
 
-			// "MM"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit month, saw '"sv, to_sv(cp), "'"sv);
-			const auto month = digits[1] + digits[0] * 10u;
-			if (month == 0u || month > 12u)
-				set_error_and_return_default("expected month between 1 and 12 (inclusive), saw "sv, month);
-			const auto max_days_in_month = month == 2u
-											 ? (is_leap_year ? 29u : 28u)
-											 : (month == 4u || month == 6u || month == 9u || month == 11u ? 30u : 31u);
-			set_error_and_return_if_eof({});
+#if TOML_ENABLE_ARENA && TOML_HAS_MEMORY_RESOURCE
+			if (options && (options->use_arena || options->memory_resource) && !handler)
+				arena = node_arena::create(options->memory_resource);
+#elif TOML_ENABLE_ARENA
+			if (options && options->use_arena && !handler)
+				arena = node_arena::create();
+#endif
 
-			// '-'
-			if (*cp != U'-')
-				set_error_and_return_default("expected '-', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+			init_source_path();
+		}
 
-			// "DD"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit day, saw '"sv, to_sv(cp), "'"sv);
-			const auto day = digits[1] + digits[0] * 10u;
-			if (day == 0u || day > max_days_in_month)
-				set_error_and_return_default("expected day between 1 and "sv,
-											 max_days_in_month,
-											 " (inclusive), saw "sv,
-											 day);
+		parser(utf8_reader_interface&& reader_,
+			   sax_handler* handler					   = nullptr,
+			   value_key_set* skipped_values		   = nullptr,
+			   const parse_options* options			   = nullptr) //
+			: parser{ reader_, handler, skipped_values, options }
+		{
+			const node_arena_scope arena_scope{ arena };
 
-			if (!part_of_datetime && !is_eof() && !is_value_terminator(*cp))
-				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+			if (!reader.peek_eof())
+			{
+				cp = reader.read_next();
 
-			return { year, month, day };
-		}
+#if !TOML_EXCEPTIONS
+				if (reader.error())
+				{
+					err = std::move(reader.error());
+					return;
+				}
+#endif
 
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		time parse_time(bool part_of_datetime = false)
-		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
-			push_parse_scope("time"sv);
+				if (cp)
+					parse_document();
+			}
 
-			static constexpr size_t max_digits = 64; // far more than necessary but needed to allow fractional
-													 // millisecond truncation per the spec
-			uint32_t digits[max_digits];
+			finish_document();
+		}
 
-			// "HH"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit hour, saw '"sv, to_sv(cp), "'"sv);
-			const auto hour = digits[1] + digits[0] * 10u;
-			if (hour > 23u)
-				set_error_and_return_default("expected hour between 0 to 59 (inclusive), saw "sv, hour);
-			set_error_and_return_if_eof({});
+		~parser() noexcept
+		{
+			if (arena)
+				arena->release();
+		}
 
-			// ':'
-			if (*cp != U':')
-				set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+		// incremental parsing: parses the reader's current contents (one or more complete top-level lines)
+		// as a continuation of the previous batch.
+		void parse_batch(bool final_batch)
+		{
+			return_if_error();
 
-			// "MM"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit minute, saw '"sv, to_sv(cp), "'"sv);
-			const auto minute = digits[1] + digits[0] * 10u;
-			if (minute > 59u)
-				set_error_and_return_default("expected minute between 0 and 59 (inclusive), saw "sv, minute);
-			auto time = toml::time{ hour, minute };
+			more_batches = !final_batch;
+			const node_arena_scope arena_scope{ arena };
+			reader.restart();
+			cp = reader.read_next();
 
-			// ':'
-			if constexpr (TOML_LANG_UNRELEASED) // toml/issues/671 (allow omission of seconds)
+#if !TOML_EXCEPTIONS
+			if (reader.error())
 			{
-				if (is_eof() || is_value_terminator(*cp) || (part_of_datetime && is_match(*cp, U'+', U'-', U'Z', U'z')))
-					return time;
+				err = std::move(reader.error());
+				return;
 			}
-			else
-				set_error_and_return_if_eof({});
-			if (*cp != U':')
-				set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+#endif
 
-			// "SS"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit second, saw '"sv, to_sv(cp), "'"sv);
-			const auto second = digits[1] + digits[0] * 10u;
-			if (second > 59u)
-				set_error_and_return_default("expected second between 0 and 59 (inclusive), saw "sv, second);
-			time.second = static_cast<decltype(time.second)>(second);
+			if (cp)
+				parse_document();
+		}
 
-			// '.' (early-exiting is allowed; fractional is optional)
-			if (is_eof() || is_value_terminator(*cp) || (part_of_datetime && is_match(*cp, U'+', U'-', U'Z', U'z')))
-				return time;
-			if (*cp != U'.')
-				set_error_and_return_default("expected '.', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+		// parallel parsing: as above, but for batches parsed out of order (independent chunks of a document, or the
+		// table headers between them), so the position of the batch within the document needs to be given.
+		void parse_batch(source_position position)
+		{
+			return_if_error();
 
-			// "FFFFFFFFF"
-			size_t digit_count = consume_variable_length_digit_sequence(digits, max_digits);
-			if (!digit_count)
+			const node_arena_scope arena_scope{ arena };
+			reader.restart(position);
+			cp = reader.read_next();
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
 			{
-				set_error_and_return_if_eof({});
-				set_error_and_return_default("expected fractional digits, saw '"sv, to_sv(*cp), "'"sv);
+				err = std::move(reader.error());
+				return;
 			}
-			else if (!is_eof())
+#endif
+
+			if (cp)
+				parse_document();
+		}
+
+		// parallel parsing: moves the key-value pairs parsed from a chunk into the current table.
+		// returns false if any of them collide with what's already there, since the chunk then might not have been
+		// valid in context (e.g. a dotted key-value pair extending an implicitly-created table).
+		TOML_NODISCARD
+		bool merge_chunk(table& chunk)
+		{
+			if (!current_table)
+				current_table = &root;
+
+			current_table->drop_index();
+			chunk.drop_index();
+
+			auto& map = current_table->map_;
+#if TOML_FLAT_TABLES
+			for (auto& [k, v] : chunk.map_)
 			{
-				if (digit_count == max_digits && is_decimal_digit(*cp))
-					set_error_and_return_default("fractional component exceeds maximum precision of "sv, max_digits);
-				else if (!part_of_datetime && !is_value_terminator(*cp))
-					set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+				const auto it = map.lower_bound(k);
+				if (it != map.end() && it->first == k)
+					return false;
+				map.emplace_hint(it, std::move(k), std::move(v));
 			}
-			uint32_t value = 0u;
-			uint32_t place = 1u;
-			for (auto i = impl::min<size_t>(digit_count, 9u); i-- > 0u;)
+			chunk.map_.clear();
+#else
+			while (!chunk.map_.empty())
 			{
-				value += digits[i] * place;
-				place *= 10u;
+				auto kvp	  = chunk.map_.extract(chunk.map_.begin());
+				const auto it = map.lower_bound(kvp.key());
+				if (it != map.end() && it->first == kvp.key())
+					return false;
+				map.insert(it, std::move(kvp));
 			}
-			for (auto i = digit_count; i < 9u; i++) // implicit zeros
-				value *= 10u;
-			time.nanosecond = value;
-			return time;
+#endif
+			return true;
 		}
 
+		// parallel parsing: where the input ended (see finish_document()).
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		date_time parse_date_time()
+		source_position end_position() const noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
-			push_parse_scope("date-time"sv);
+			return current_position(1);
+		}
 
-			// "YYYY-MM-DD"
-			auto date = parse_date(true);
-			set_error_and_return_if_eof({});
+		// parallel parsing: hands over the parsed chunk (or the finished document), leaving the parser ready for
+		// another chunk.
+		TOML_NODISCARD
+		table release_root() noexcept
+		{
+			table tbl{ std::move(root) };
+			root.clear();
+			current_table = {};
+			dotted_key_tables.clear();
+			value_keys->clear();
+			return tbl;
+		}
 
-			// ' ', 'T' or 't'
-			if (!is_match(*cp, U' ', U'T', U't'))
-				set_error_and_return_default("expected space, 'T' or 't', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+		// batch parsing: gets ready to parse a whole new document from the reader (which may have a different
+		// source path now), holding on to everything that's been allocated so far (other than the arena, since
+		// each document gets its own). not valid after an error.
+		void reset()
+		{
+			assert_not_error();
 
-			// "HH:MM:SS.FFFFFFFFF"
-			auto time = parse_time(true);
+			if (arena)
+			{
+				const auto next = arena->create_next();
+				arena->release();
+				arena = next;
+			}
+
+			prev_pos	  = { 1, 1 };
+			cp			  = {};
+			current_table = {};
+			root.clear();
+			init_source_path();
+			dotted_key_tables.clear();
+			implicit_tables.clear();
+			discarded_tables.clear();
+			table_arrays.clear();
+			value_keys->clear();
+			if (keep_paths)
+				reset_filter();
+		}
+
+		// lazy documents: parses a value skipped over by skip_value(), which must be the whole of the reader's contents.
+		TOML_NODISCARD
+		node_ptr parse_deferred_value(source_position position)
+		{
+			const node_arena_scope arena_scope{ arena };
+			reader.restart(position);
+			cp = reader.read_next();
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
+			{
+				err = std::move(reader.error());
+				return {};
+			}
+#endif
+
+			parsed_value val = parse_value();
 			return_if_error({});
+			if (!is_eof())
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
 
-			// no offset
-			if (is_eof() || is_value_terminator(*cp))
-				return { date, time };
+			update_region_ends(*val.ptr);
+			return std::move(val.owned);
+		}
 
-			// zero offset ('Z' or 'z')
-			time_offset offset{};
-			if (is_match(*cp, U'Z', U'z'))
-				advance_and_return_if_error({});
+		// closes off the source regions once all of the input has been parsed.
+		void finish_document() noexcept
+		{
+			more_batches = false; // (whatever the last batch was, there's nothing after it)
+			finish_document(current_position(1));
+		}
 
-			// explicit offset ("+/-HH:MM")
-			else if (is_match(*cp, U'+', U'-'))
+		// path-filtered parsing: takes the tables put in the tree by key-value pairs outside of keep_paths back out
+		// again, i.e. their inline tables and any dotted key tables that nothing that was kept went in.
+		// (they're only there so redefinitions are diagnosed the same way they would be without keep_paths)
+		void prune_discarded_tables() noexcept
+		{
+			for (auto i = discarded_tables.size(); i-- > 0u;)
 			{
-				push_parse_scope("date-time offset"sv);
+				auto& discarded = discarded_tables[i];
+				auto it			= discarded.parent->find(discarded.k.str());
+				TOML_ASSERT(it != discarded.parent->end());
 
-				// sign
-				int sign = *cp == U'-' ? -1 : 1;
-				advance_and_return_if_error_or_eof({});
+				auto& tbl = it->second.ref_cast<table>();
+				if (tbl.is_inline() || tbl.empty())
+				{
+					dotted_key_tables.erase(&tbl);
+					discarded.parent->erase(it);
+				}
+			}
+			discarded_tables.clear();
+		}
 
-				// "HH"
-				int digits[2];
-				if (!consume_digit_sequence(digits, 2u))
-					set_error_and_return_default("expected 2-digit hour, saw '"sv, to_sv(cp), "'"sv);
-				const auto hour = digits[1] + digits[0] * 10;
-				if (hour > 23)
-					set_error_and_return_default("expected hour between 0 and 23 (inclusive), saw "sv, hour);
-				set_error_and_return_if_eof({});
+		void finish_document(source_position eof_pos) noexcept
+		{
+			if (!is_error() && !discarded_tables.empty())
+				prune_discarded_tables();
 
-				// ':'
-				if (*cp != U':')
-					set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
-				advance_and_return_if_error_or_eof({});
+#if TOML_ENABLE_SOURCES
+			if (!is_error() && track_sources)
+			{
+				root.source_.end = eof_pos;
 
-				// "MM"
-				if (!consume_digit_sequence(digits, 2u))
-					set_error_and_return_default("expected 2-digit minute, saw '"sv, to_sv(cp), "'"sv);
-				const auto minute = digits[1] + digits[0] * 10;
-				if (minute > 59)
-					set_error_and_return_default("expected minute between 0 and 59 (inclusive), saw "sv, minute);
-				offset.minutes = static_cast<decltype(offset.minutes)>((hour * 60 + minute) * sign);
+				// (current_table is only set once parse_document() has been reached, and is cleared again by
+				// headers the path filter skips)
+				if (current_table && current_table != &root
+					&& current_table->source_.end <= current_table->source_.begin)
+					current_table->source_.end = eof_pos;
 			}
 
-			if (!is_eof() && !is_value_terminator(*cp))
-				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+#else
+			TOML_UNUSED(eof_pos);
+#endif
 
-			return { date, time, offset };
+			// (nobody gets to see the tree when emitting events)
+			if (!events && track_sources)
+				update_region_ends(root);
 		}
 
-		TOML_NODISCARD
-		node_ptr parse_array();
+#if !TOML_EXCEPTIONS
+
+		TOML_PURE_INLINE_GETTER
+		bool failed() const noexcept
+		{
+			return !!err;
+		}
 
 		TOML_NODISCARD
-		node_ptr parse_inline_table();
+		optional<parse_error>&& error() noexcept
+		{
+			return std::move(err);
+		}
+
+#endif
 
 		TOML_NODISCARD
-		node_ptr parse_value_known_prefixes()
+		operator parse_result() && noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(!is_control_character(*cp));
-			TOML_ASSERT_ASSUME(*cp != U'_');
+#if TOML_EXCEPTIONS
 
-			switch (cp->value)
-			{
-				// arrays
-				case U'[': return parse_array();
+			return { std::move(root) };
 
-				// inline tables
-				case U'{': return parse_inline_table();
+#else
 
-				// floats beginning with '.'
-				case U'.': return node_ptr{ new value{ parse_float() } };
+			if (err)
+				return parse_result{ *std::move(err) };
+			else
+				return parse_result{ std::move(root) };
 
-				// strings
-				case U'"': [[fallthrough]];
-				case U'\'': return node_ptr{ new value{ parse_string().value } };
+#endif
+		}
+	};
 
-				default:
-				{
-					const auto cp_upper = static_cast<uint_least32_t>(cp->value) & ~0x20u;
+	TOML_EXTERNAL_LINKAGE
+	parsed_value parser::parse_array()
+	{
+		return_if_error({});
+		assert_not_eof();
+		TOML_ASSERT_ASSUME(*cp == U'[');
+		push_parse_scope("array"sv);
 
-					// bools
-					if (cp_upper == 70u || cp_upper == 84u) // F or T
-						return node_ptr{ new value{ parse_boolean() } };
+		// skip opening '['
+		advance_and_return_if_error_or_eof({});
 
-					// inf/nan
-					else if (cp_upper == 73u || cp_upper == 78u) // I or N
-						return node_ptr{ new value{ parse_inf_or_nan() } };
+		// when emitting events (or skipping the value) the elements aren't kept, so there's nothing to allocate
+		parsed_value arr_val =
+			discarding_values ? parsed_value{ scratch.arrays } : parsed_value{ node_ptr{ new array{} } };
+		array& arr			 = arr_val->ref_cast<array>();
+		if (events)
+			events->on_array_begin();
+		enum class TOML_CLOSED_ENUM parse_type : int
+		{
+			none,
+			comma,
+			val
+		};
+		parse_type prev = parse_type::none;
 
-					else
-						return nullptr;
+		while (!is_error())
+		{
+			while (consume_leading_whitespace() || consume_line_break() || consume_comment())
+				continue;
+			set_error_and_return_if_eof({});
+
+			// commas - only legal after a value
+			if (*cp == U',')
+			{
+				if (prev == parse_type::val)
+				{
+					prev = parse_type::comma;
+					advance_and_return_if_error_or_eof({});
+					continue;
 				}
+				set_error_and_return_default("expected value or closing ']', saw comma"sv);
 			}
-			TOML_UNREACHABLE;
-		}
 
-		TOML_NODISCARD
-		node_ptr parse_value()
-		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(!is_value_terminator(*cp));
-			push_parse_scope("value"sv);
+			// closing ']'
+			else if (*cp == U']')
+			{
+				advance_and_return_if_error({});
+				break;
+			}
 
-			const depth_counter_scope depth_counter{ nested_values };
-			if TOML_UNLIKELY(nested_values > max_nested_values)
-				set_error_and_return_default("exceeded maximum nested value depth of "sv,
-											 max_nested_values,
-											 " (TOML_MAX_NESTED_VALUES)"sv);
+			// must be a value
+			else
+			{
+				if (prev == parse_type::val)
+				{
+					set_error_and_return_default("expected comma or closing ']', saw '"sv, to_sv(*cp), "'"sv);
+					continue;
+				}
+				prev = parse_type::val;
 
-			// check if it begins with some control character
-			// (note that this will also fail for whitespace but we're assuming we've
-			// called consume_leading_whitespace() before calling parse_value())
-			if TOML_UNLIKELY(is_control_character(*cp))
-				set_error_and_return_default("unexpected control character"sv);
+				auto val = parse_value();
+				return_if_error({});
 
-			// underscores at the beginning
-			else if (*cp == U'_')
-				set_error_and_return_default("values may not begin with underscores"sv);
+				if (discarding_values)
+					continue;
 
-			const auto begin_pos = cp->position;
-			node_ptr val;
+				if (!arr.capacity())
+					arr.reserve(4u);
+				arr.emplace_back<node_ptr>(std::move(val.owned));
+			}
+		}
 
-			do
-			{
-				TOML_ASSERT_ASSUME(!is_control_character(*cp));
-				TOML_ASSERT_ASSUME(*cp != U'_');
+		return_if_error({});
+		if (events)
+			events->on_array_end();
+		return arr_val;
+	}
 
-				// detect the value type and parse accordingly,
-				// starting with value types that can be detected
-				// unambiguously from just one character.
+	TOML_EXTERNAL_LINKAGE
+	parsed_value parser::parse_inline_table()
+	{
+		return_if_error({});
+		assert_not_eof();
+		TOML_ASSERT_ASSUME(*cp == U'{');
+		push_parse_scope("inline table"sv);
 
-				val = parse_value_known_prefixes();
-				return_if_error({});
-				if (val)
-					break;
+		// skip opening '{'
+		advance_and_return_if_error_or_eof({});
 
-				// value types from here down require more than one character to unambiguously identify
-				// so scan ahead and collect a set of value 'traits'.
-				enum TOML_CLOSED_FLAGS_ENUM value_traits : int
-				{
-					has_nothing	 = 0,
-					has_digits	 = 1,
-					has_b		 = 1 << 1, // as second char only (0b)
-					has_e		 = 1 << 2, // only float exponents
-					has_o		 = 1 << 3, // as second char only (0o)
-					has_p		 = 1 << 4, // only hexfloat exponents
-					has_t		 = 1 << 5,
-					has_x		 = 1 << 6, // as second or third char only (0x, -0x, +0x)
-					has_z		 = 1 << 7,
-					has_colon	 = 1 << 8,
-					has_plus	 = 1 << 9,
-					has_minus	 = 1 << 10,
-					has_dot		 = 1 << 11,
-					begins_sign	 = 1 << 12,
-					begins_digit = 1 << 13,
-					begins_zero	 = 1 << 14,
+		node_ptr tbl_ptr{ new table{} };
+		table& tbl = tbl_ptr->ref_cast<table>();
+		tbl.is_inline(true);
+		table_vector_scope table_scope{ open_inline_tables, tbl };
+		const auto dotted_key_tables_count = dotted_key_tables.size();
+		const auto value_keys_count		   = value_keys->size();
+		if (events)
+			events->on_inline_table_begin();
 
-					signs_msk  = has_plus | has_minus,
-					bdigit_msk = has_digits | begins_digit,
-					bzero_msk  = bdigit_msk | begins_zero,
-				};
-				value_traits traits	 = has_nothing;
-				const auto has_any	 = [&](auto t) noexcept { return (traits & t) != has_nothing; };
-				const auto has_none	 = [&](auto t) noexcept { return (traits & t) == has_nothing; };
-				const auto add_trait = [&](auto t) noexcept { traits = static_cast<value_traits>(traits | t); };
+		enum class TOML_CLOSED_ENUM parse_type : int
+		{
+			none,
+			comma,
+			kvp
+		};
+		parse_type prev = parse_type::none;
+		while (!is_error())
+		{
+			if constexpr (TOML_LANG_UNRELEASED) // toml/issues/516 (newlines/trailing commas in inline tables)
+			{
+				while (consume_leading_whitespace() || consume_line_break() || consume_comment())
+					continue;
+			}
+			else
+			{
+				while (consume_leading_whitespace())
+					continue;
+			}
+			return_if_error({});
+			set_error_and_return_if_eof({});
 
-				// examine the first character to get the 'begins with' traits
-				// (good fail-fast opportunity; all the remaining types begin with numeric digits or signs)
-				if (is_decimal_digit(*cp))
+			// commas - only legal after a key-value pair
+			if (*cp == U',')
+			{
+				if (prev == parse_type::kvp)
 				{
-					add_trait(begins_digit);
-					if (*cp == U'0')
-						add_trait(begins_zero);
+					prev = parse_type::comma;
+					advance_and_return_if_error_or_eof({});
 				}
-				else if (is_match(*cp, U'+', U'-'))
-					add_trait(begins_sign);
 				else
-					break;
+					set_error_and_return_default("expected key-value pair or closing '}', saw comma"sv);
+			}
 
-				// scan the rest of the value to determine the remaining traits
-				char32_t chars[utf8_buffered_reader::max_history_length];
-				size_t char_count = {}, advance_count = {};
-				bool eof_while_scanning = false;
-				const auto scan			= [&]() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+			// closing '}'
+			else if (*cp == U'}')
+			{
+				if constexpr (!TOML_LANG_UNRELEASED) // toml/issues/516 (newlines/trailing commas in inline tables)
 				{
-					if (is_eof())
-						return;
-					TOML_ASSERT_ASSUME(!is_value_terminator(*cp));
-
-					do
+					if (prev == parse_type::comma)
 					{
-						if (const auto c = **cp; c != U'_')
-						{
-							chars[char_count++] = c;
-
-							if (is_decimal_digit(c))
-								add_trait(has_digits);
-							else if (is_ascii_letter(c))
-							{
-								TOML_ASSERT_ASSUME((c >= U'a' && c <= U'z') || (c >= U'A' && c <= U'Z'));
-								switch (static_cast<char32_t>(c | 32u))
-								{
-									case U'b':
-										if (char_count == 2u && has_any(begins_zero))
-											add_trait(has_b);
-										break;
-
-									case U'e':
-										if (char_count > 1u
-											&& has_none(has_b | has_o | has_p | has_t | has_x | has_z | has_colon)
-											&& (has_none(has_plus | has_minus) || has_any(begins_sign)))
-											add_trait(has_e);
-										break;
-
-									case U'o':
-										if (char_count == 2u && has_any(begins_zero))
-											add_trait(has_o);
-										break;
-
-									case U'p':
-										if (has_any(has_x))
-											add_trait(has_p);
-										break;
-
-									case U'x':
-										if ((char_count == 2u && has_any(begins_zero))
-											|| (char_count == 3u && has_any(begins_sign) && chars[1] == U'0'))
-											add_trait(has_x);
-										break;
-
-									case U't': add_trait(has_t); break;
-									case U'z': add_trait(has_z); break;
-								}
-							}
-							else if (c <= U':')
-							{
-								TOML_ASSERT_ASSUME(c < U'0' || c > U'9');
-								switch (c)
-								{
-									case U'+': add_trait(has_plus); break;
-									case U'-': add_trait(has_minus); break;
-									case U'.': add_trait(has_dot); break;
-									case U':': add_trait(has_colon); break;
-								}
-							}
-						}
-
-						advance_and_return_if_error();
-						advance_count++;
-						eof_while_scanning = is_eof();
+						set_error_and_return_default("expected key-value pair, saw closing '}' (dangling comma)"sv);
+						continue;
 					}
-					while (advance_count < (utf8_buffered_reader::max_history_length - 1u) && !is_eof()
-						   && !is_value_terminator(*cp));
-				};
-				scan();
-				return_if_error({});
+				}
+				advance_and_return_if_error({});
+				break;
+			}
 
-				// force further scanning if this could have been a date-time with a space instead of a T
-				if (char_count == 10u									 //
-					&& (traits | begins_zero) == (bzero_msk | has_minus) //
-					&& chars[4] == U'-'									 //
-					&& chars[7] == U'-'									 //
-					&& !is_eof()										 //
-					&& *cp == U' ')
+			// key-value pair
+			else if (is_string_delimiter(*cp) || is_bare_key_character(*cp))
+			{
+				if (prev == parse_type::kvp)
+					set_error_and_return_default("expected comma or closing '}', saw '"sv, to_sv(*cp), "'"sv);
+				else
 				{
-					const auto pre_advance_count = advance_count;
-					const auto pre_scan_traits	 = traits;
-					chars[char_count++]			 = *cp;
-					add_trait(has_t);
+					prev = parse_type::kvp;
+					parse_key_value_pair_and_insert(&tbl);
+				}
+			}
 
-					const auto backpedal = [&]() noexcept
-					{
-						go_back(advance_count - pre_advance_count);
-						advance_count = pre_advance_count;
-						traits		  = pre_scan_traits;
-						char_count	  = 10u;
-					};
+			/// ???
+			else
+				set_error_and_return_default("expected key or closing '}', saw '"sv, to_sv(*cp), "'"sv);
+		}
 
-					advance_and_return_if_error({});
-					advance_count++;
+		return_if_error({});
 
-					if (is_eof() || !is_decimal_digit(*cp))
-						backpedal();
-					else
-					{
-						chars[char_count++] = *cp;
+		// inline tables are closed once they end, so any dotted key tables created in this one can be forgotten, as
+		// can the keys of its values when emitting events (it may even be thrown away, e.g. if it was in an array).
+		if (dotted_key_tables.size() != dotted_key_tables_count)
+			forget_dotted_key_tables(tbl);
+		value_keys->truncate(value_keys_count);
 
-						advance_and_return_if_error({});
-						advance_count++;
+		if (events)
+			events->on_inline_table_end();
+		return parsed_value{ std::move(tbl_ptr) };
+	}
 
-						scan();
-						return_if_error({});
+	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
+}
+TOML_IMPL_NAMESPACE_END;
 
-						if (char_count == 12u)
-							backpedal();
-					}
-				}
+#undef TOML_RETURNS_BY_THROWING
+#undef advance_and_return_if_error
+#undef advance_and_return_if_error_or_eof
+#undef assert_not_eof
+#undef assert_not_error
+#undef is_eof
+#undef is_error
+#undef parse_error_break
+#undef push_parse_scope
+#undef push_parse_scope_1
+#undef push_parse_scope_2
+#undef return_after_error
+#undef return_if_eof
+#undef return_if_error
+#undef return_if_error_or_eof
+#undef set_error_and_return
+#undef set_error_and_return_default
+#undef set_error_and_return_if_eof
+#undef utf8_buffered_reader_error_check
+#undef utf8_reader_error
+#undef utf8_reader_error_check
+#undef utf8_reader_return_after_error
 
-				// set the reader back to where we started
-				go_back(advance_count);
+//#---------------------------------------------------------------------------------------------------------------------
+//# PARSER PUBLIC IMPLEMENTATION
+//#---------------------------------------------------------------------------------------------------------------------
 
-				// if after scanning ahead we still only have one value character,
-				// the only valid value type is an integer.
-				if (char_count == 1u)
-				{
-					if (has_any(begins_digit))
-					{
-						val.reset(new value{ static_cast<int64_t>(chars[0] - U'0') });
-						advance(); // skip the digit
-						break;
-					}
+TOML_ANON_NAMESPACE_START
+{
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	parse_result do_parse(utf8_reader_interface && reader)
+	{
+		return impl::parser{ std::move(reader) };
+	}
 
-					// anything else would be ambiguous.
-					else
-						set_error_and_return_default(eof_while_scanning ? "encountered end-of-file"sv
-																		: "could not determine value type"sv);
-				}
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	parse_result do_parse(utf8_reader_interface && reader, const parse_options& options)
+	{
+		return impl::parser{ std::move(reader), nullptr, nullptr, &options };
+	}
 
-				// now things that can be identified from two or more characters
-				return_if_error({});
-				TOML_ASSERT_ASSUME(char_count >= 2u);
+#if TOML_EXCEPTIONS
+	using sax_parse_result = void;
+#else
+	using sax_parse_result = optional<parse_error>;
+#endif
 
-				// do some 'fuzzy matching' where there's no ambiguity, since that allows the specific
-				// typed parse functions to take over and show better diagnostics if there's an issue
-				// (as opposed to the fallback "could not determine type" message)
-				if (has_any(has_p))
-					val.reset(new value{ parse_hex_float() });
-				else if (has_any(has_x | has_o | has_b))
-				{
-					int64_t i;
-					value_flags flags;
-					if (has_any(has_x))
-					{
-						i	  = parse_integer<16>();
-						flags = value_flags::format_as_hexadecimal;
-					}
-					else if (has_any(has_o))
-					{
-						i	  = parse_integer<8>();
-						flags = value_flags::format_as_octal;
-					}
-					else // has_b
-					{
-						i	  = parse_integer<2>();
-						flags = value_flags::format_as_binary;
-					}
-					return_if_error({});
+	TOML_INTERNAL_LINKAGE
+	sax_parse_result do_parse(utf8_reader_interface && reader, sax_handler & handler)
+	{
+#if TOML_EXCEPTIONS
+		impl::parser{ std::move(reader), &handler };
+#else
+		impl::parser parser{ std::move(reader), &handler };
+		return parser.error();
+#endif
+	}
 
-					val.reset(new value{ i });
-					val->ref_cast<int64_t>().flags(flags);
-				}
-				else if (has_any(has_e) || (has_any(begins_digit) && chars[1] == U'.'))
-					val.reset(new value{ parse_float() });
-				else if (has_any(begins_sign))
+	// just enough of the grammar to know where the top-level lines end:
+	// strings and comments (which may contain brackets and line breaks) and the nesting depth of [] and {}
+	class top_level_scanner
+	{
+	  private:
+		enum class scan_mode : unsigned char
+		{
+			normal,
+			comment,
+			basic_string_open, // one or two '"' so far
+			basic_string,
+			basic_string_escape,
+			ml_basic_string,
+			ml_basic_string_escape,
+			literal_string_open, // one or two '\'' so far
+			literal_string,
+			ml_literal_string
+		};
+
+		scan_mode mode_	   = scan_mode::normal;
+		size_t delimiters_ = {}; // consecutive string delimiters
+		size_t depth_	   = {};
+
+		TOML_CONST_INLINE_GETTER
+		static bool is_structural(char ch) noexcept
+		{
+			switch (ch)
+			{
+				case '\n': [[fallthrough]];
+				case '#': [[fallthrough]];
+				case '"': [[fallthrough]];
+				case '\'': [[fallthrough]];
+				case '[': [[fallthrough]];
+				case ']': [[fallthrough]];
+				case '{': [[fallthrough]];
+				case '}': return true;
+				default: return false;
+			}
+		}
+
+	  public:
+		// calls on_line_end with the end of each complete top-level line in [begin, end)
+		// (can be called repeatedly with consecutive parts of the same input)
+		template <typename Func>
+		void scan(const char* begin, const char* end, Func&& on_line_end)
+		{
+			const auto& kernels = impl::simd();
+			for (auto c = begin; c < end; c++)
+			{
+				// skip over anything that can't change the mode in bulk
+				switch (mode_)
 				{
-					// single-digit signed integers
-					if (char_count == 2u && has_any(has_digits))
-					{
-						val.reset(new value{ static_cast<int64_t>(chars[1] - U'0') * (chars[0] == U'-' ? -1LL : 1LL) });
-						advance(); // skip the sign
-						advance(); // skip the digit
+					case scan_mode::normal:
+						while (c < end && !is_structural(*c))
+							c++;
 						break;
-					}
 
-					// simple signed floats (e.g. +1.0)
-					if (is_decimal_digit(chars[1]) && chars[2] == U'.')
-						val.reset(new value{ parse_float() });
+					case scan_mode::comment: c = kernels.find_comment_terminator(c, end); break;
+					case scan_mode::basic_string: c = kernels.find_string_terminator(c, end, '"', '\\'); break;
+					case scan_mode::literal_string: c = kernels.find_string_terminator(c, end, '\'', '\''); break;
 
-					// signed infinity or nan
-					else if (is_match(chars[1], U'i', U'n', U'I', U'N'))
-						val.reset(new value{ parse_inf_or_nan() });
-				}
+					case scan_mode::ml_basic_string:
+						if (!delimiters_)
+							c = kernels.find_string_terminator(c, end, '"', '\\');
+						break;
 
-				return_if_error({});
-				if (val)
+					case scan_mode::ml_literal_string:
+						if (!delimiters_)
+							c = kernels.find_string_terminator(c, end, '\'', '\'');
+						break;
+
+					default: break;
+				}
+				if (c == end)
 					break;
 
-				// match trait masks against what they can match exclusively.
-				// all correct value parses will come out of this list, so doing this as a switch is likely to
-				// be a better friend to the optimizer on the success path (failure path can be slow but that
-				// doesn't matter much).
-				switch (unwrap_enum(traits))
+				const auto ch = *c;
+				switch (mode_)
 				{
-					// binary integers
-					// 0b10
-					case bzero_msk | has_b:
-						val.reset(new value{ parse_integer<2>() });
-						val->ref_cast<int64_t>().flags(value_flags::format_as_binary);
-						break;
+					case scan_mode::normal: break;
 
-					// octal integers
-					// 0o10
-					case bzero_msk | has_o:
-						val.reset(new value{ parse_integer<8>() });
-						val->ref_cast<int64_t>().flags(value_flags::format_as_octal);
-						break;
+					case scan_mode::comment:
+						if (ch == '\n')
+							break;
+						continue;
 
-					// decimal integers
-					// 00
-					// 10
-					// +10
-					// -10
-					case bzero_msk: [[fallthrough]];
-					case bdigit_msk: [[fallthrough]];
-					case begins_sign | has_digits | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_plus:
-					{
-						// if the value was so long we exhausted the history buffer it's reasonable to assume
-						// there was more and the value's actual type is impossible to identify without making the
-						// buffer bigger (since it could have actually been a float), so emit an error.
-						//
-						// (this will likely only come up during fuzzing and similar scenarios)
-						static constexpr size_t max_numeric_value_length =
-							utf8_buffered_reader::max_history_length - 2u;
-						if TOML_UNLIKELY(!eof_while_scanning && advance_count > max_numeric_value_length)
-							set_error_and_return_default("numeric value too long to identify type - cannot exceed "sv,
-														 max_numeric_value_length,
-														 " characters"sv);
+					case scan_mode::basic_string_open:
+						if (ch == '"')
+						{
+							if (++delimiters_ == 3u)
+							{
+								mode_		= scan_mode::ml_basic_string;
+								delimiters_ = {};
+							}
+							continue;
+						}
+						if (delimiters_ == 2u) // ""
+							break;
+						mode_ = scan_mode::basic_string;
+						[[fallthrough]];
+
+					case scan_mode::basic_string:
+						if (ch == '\\')
+							mode_ = scan_mode::basic_string_escape;
+						else if (ch == '"')
+							mode_ = scan_mode::normal;
+						else if (ch == '\n') // unterminated; the parser will complain about it
+							break;
+						continue;
 
-						val.reset(new value{ parse_integer<10>() });
-						break;
-					}
+					case scan_mode::basic_string_escape:
+						mode_ = scan_mode::basic_string;
+						if (ch == '\n')
+							break;
+						continue;
 
-					// hexadecimal integers
-					// 0x10
-					case bzero_msk | has_x:
-						val.reset(new value{ parse_integer<16>() });
-						val->ref_cast<int64_t>().flags(value_flags::format_as_hexadecimal);
-						break;
+					case scan_mode::ml_basic_string:
+						if (ch == '"')
+						{
+							if (++delimiters_ == 5u) // """ + two quotes at the end of the string
+								mode_ = scan_mode::normal;
+							continue;
+						}
+						if (delimiters_ >= 3u)
+							break;
+						delimiters_ = {};
+						if (ch == '\\')
+							mode_ = scan_mode::ml_basic_string_escape;
+						continue;
 
-					// decimal floats
-					// 0e1
-					// 0e-1
-					// 0e+1
-					// 0.0
-					// 0.0e1
-					// 0.0e-1
-					// 0.0e+1
-					case bzero_msk | has_e: [[fallthrough]];
-					case bzero_msk | has_e | has_minus: [[fallthrough]];
-					case bzero_msk | has_e | has_plus: [[fallthrough]];
-					case bzero_msk | has_dot: [[fallthrough]];
-					case bzero_msk | has_dot | has_e: [[fallthrough]];
-					case bzero_msk | has_dot | has_e | has_minus: [[fallthrough]];
-					case bzero_msk | has_dot | has_e | has_plus: [[fallthrough]];
-					// 1e1
-					// 1e-1
-					// 1e+1
-					// 1.0
-					// 1.0e1
-					// 1.0e-1
-					// 1.0e+1
-					case bdigit_msk | has_e: [[fallthrough]];
-					case bdigit_msk | has_e | has_minus: [[fallthrough]];
-					case bdigit_msk | has_e | has_plus: [[fallthrough]];
-					case bdigit_msk | has_dot: [[fallthrough]];
-					case bdigit_msk | has_dot | has_e: [[fallthrough]];
-					case bdigit_msk | has_dot | has_e | has_minus: [[fallthrough]];
-					case bdigit_msk | has_dot | has_e | has_plus: [[fallthrough]];
-					// +1e1
-					// +1.0
-					// +1.0e1
-					// +1.0e+1
-					// +1.0e-1
-					// -1.0e+1
-					case begins_sign | has_digits | has_e | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_e | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_e | signs_msk: [[fallthrough]];
-					// -1e1
-					// -1e+1
-					// +1e-1
-					// -1.0
-					// -1.0e1
-					// -1.0e-1
-					case begins_sign | has_digits | has_e | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_e | signs_msk: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_e | has_minus:
-						val.reset(new value{ parse_float() });
+					case scan_mode::ml_basic_string_escape:
+						mode_ = scan_mode::ml_basic_string;
+						continue;
+
+					case scan_mode::literal_string_open:
+						if (ch == '\'')
+						{
+							if (++delimiters_ == 3u)
+							{
+								mode_		= scan_mode::ml_literal_string;
+								delimiters_ = {};
+							}
+							continue;
+						}
+						if (delimiters_ == 2u) // ''
+							break;
+						mode_ = scan_mode::literal_string;
+						[[fallthrough]];
+
+					case scan_mode::literal_string:
+						if (ch == '\'')
+							mode_ = scan_mode::normal;
+						else if (ch == '\n')
+							break;
+						continue;
+
+					case scan_mode::ml_literal_string:
+						if (ch == '\'')
+						{
+							if (++delimiters_ == 5u)
+								mode_ = scan_mode::normal;
+							continue;
+						}
+						if (delimiters_ >= 3u)
+							break;
+						delimiters_ = {};
+						continue;
+
+					default: TOML_UNREACHABLE;
+				}
+
+				// anything that breaks out of the switch is (back) at the top level
+				mode_		= scan_mode::normal;
+				delimiters_ = {};
+				switch (ch)
+				{
+					case '#': mode_ = scan_mode::comment; break;
+
+					case '"':
+						mode_		= scan_mode::basic_string_open;
+						delimiters_ = 1u;
 						break;
 
-					// hexadecimal floats
-					// 0x10p0
-					// 0x10p-0
-					// 0x10p+0
-					case bzero_msk | has_x | has_p: [[fallthrough]];
-					case bzero_msk | has_x | has_p | has_minus: [[fallthrough]];
-					case bzero_msk | has_x | has_p | has_plus: [[fallthrough]];
-					// -0x10p0
-					// -0x10p-0
-					// +0x10p0
-					// +0x10p+0
-					// -0x10p+0
-					// +0x10p-0
-					case begins_sign | has_digits | has_x | has_p | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_x | has_p | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_x | has_p | signs_msk: [[fallthrough]];
-					// 0x10.1p0
-					// 0x10.1p-0
-					// 0x10.1p+0
-					case bzero_msk | has_x | has_dot | has_p: [[fallthrough]];
-					case bzero_msk | has_x | has_dot | has_p | has_minus: [[fallthrough]];
-					case bzero_msk | has_x | has_dot | has_p | has_plus: [[fallthrough]];
-					// -0x10.1p0
-					// -0x10.1p-0
-					// +0x10.1p0
-					// +0x10.1p+0
-					// -0x10.1p+0
-					// +0x10.1p-0
-					case begins_sign | has_digits | has_x | has_dot | has_p | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_x | has_dot | has_p | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_x | has_dot | has_p | signs_msk:
-						val.reset(new value{ parse_hex_float() });
+					case '\'':
+						mode_		= scan_mode::literal_string_open;
+						delimiters_ = 1u;
 						break;
 
-					// times
-					// HH:MM
-					// HH:MM:SS
-					// HH:MM:SS.FFFFFF
-					case bzero_msk | has_colon: [[fallthrough]];
-					case bzero_msk | has_colon | has_dot: [[fallthrough]];
-					case bdigit_msk | has_colon: [[fallthrough]];
-					case bdigit_msk | has_colon | has_dot: val.reset(new value{ parse_time() }); break;
+					case '[': [[fallthrough]];
+					case '{': depth_++; break;
 
-					// local dates
-					// YYYY-MM-DD
-					case bzero_msk | has_minus: [[fallthrough]];
-					case bdigit_msk | has_minus: val.reset(new value{ parse_date() }); break;
+					case ']': [[fallthrough]];
+					case '}':
+						if (depth_)
+							depth_--;
+						break;
 
-					// date-times
-					// YYYY-MM-DDTHH:MM
-					// YYYY-MM-DDTHH:MM-HH:MM
-					// YYYY-MM-DDTHH:MM+HH:MM
-					// YYYY-MM-DD HH:MM
-					// YYYY-MM-DD HH:MM-HH:MM
-					// YYYY-MM-DD HH:MM+HH:MM
-					// YYYY-MM-DDTHH:MM:SS
-					// YYYY-MM-DDTHH:MM:SS-HH:MM
-					// YYYY-MM-DDTHH:MM:SS+HH:MM
-					// YYYY-MM-DD HH:MM:SS
-					// YYYY-MM-DD HH:MM:SS-HH:MM
-					// YYYY-MM-DD HH:MM:SS+HH:MM
-					case bzero_msk | has_minus | has_colon | has_t: [[fallthrough]];
-					case bzero_msk | signs_msk | has_colon | has_t: [[fallthrough]];
-					case bdigit_msk | has_minus | has_colon | has_t: [[fallthrough]];
-					case bdigit_msk | signs_msk | has_colon | has_t: [[fallthrough]];
-					// YYYY-MM-DDTHH:MM:SS.FFFFFF
-					// YYYY-MM-DDTHH:MM:SS.FFFFFF-HH:MM
-					// YYYY-MM-DDTHH:MM:SS.FFFFFF+HH:MM
-					// YYYY-MM-DD HH:MM:SS.FFFFFF
-					// YYYY-MM-DD HH:MM:SS.FFFFFF-HH:MM
-					// YYYY-MM-DD HH:MM:SS.FFFFFF+HH:MM
-					case bzero_msk | has_minus | has_colon | has_dot | has_t: [[fallthrough]];
-					case bzero_msk | signs_msk | has_colon | has_dot | has_t: [[fallthrough]];
-					case bdigit_msk | has_minus | has_colon | has_dot | has_t: [[fallthrough]];
-					case bdigit_msk | signs_msk | has_colon | has_dot | has_t: [[fallthrough]];
-					// YYYY-MM-DDTHH:MMZ
-					// YYYY-MM-DD HH:MMZ
-					// YYYY-MM-DDTHH:MM:SSZ
-					// YYYY-MM-DD HH:MM:SSZ
-					// YYYY-MM-DDTHH:MM:SS.FFFFFFZ
-					// YYYY-MM-DD HH:MM:SS.FFFFFFZ
-					case bzero_msk | has_minus | has_colon | has_z | has_t: [[fallthrough]];
-					case bzero_msk | has_minus | has_colon | has_dot | has_z | has_t: [[fallthrough]];
-					case bdigit_msk | has_minus | has_colon | has_z | has_t: [[fallthrough]];
-					case bdigit_msk | has_minus | has_colon | has_dot | has_z | has_t:
-						val.reset(new value{ parse_date_time() });
+					case '\n':
+						if (!depth_)
+							on_line_end(c + 1);
 						break;
+
+					default: break;
 				}
 			}
-			while (false);
+		}
+	};
+
+	// the reader behind incremental_parser; a window onto whichever batch of complete lines is being parsed.
+	// batches are never empty so utf8_buffered_reader always reads them in-place (see utf8_buffered_reader::restart()).
+	class utf8_batch_reader final : public utf8_reader_interface
+	{
+	  private:
+		std::string_view batch_;
+		source_path_ptr source_path_;
+
+#if !TOML_EXCEPTIONS
+		optional<parse_error> err_;
+#endif
+
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit utf8_batch_reader(source_path_ptr&& source_path) noexcept //
+			: source_path_{ std::move(source_path) }
+		{}
+
+		void set_batch(std::string_view batch) noexcept
+		{
+			batch_ = batch;
+		}
+
+		void set_source_path(source_path_ptr&& source_path) noexcept
+		{
+			source_path_ = std::move(source_path);
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const source_path_ptr& source_path() const noexcept final
+		{
+			return source_path_;
+		}
 
-			if (!val)
-			{
-				set_error_at(begin_pos, "could not determine value type"sv);
-				return_after_error({});
-			}
+		TOML_NODISCARD
+		const utf8_codepoint* read_next() noexcept final
+		{
+			return nullptr; // never called
+		}
 
-			val->source_ = { begin_pos, current_position(1), reader.source_path() };
-			return val;
+		TOML_NODISCARD
+		bool peek_eof() const noexcept final
+		{
+			return batch_.empty();
 		}
 
-		TOML_NEVER_INLINE
-		bool parse_key()
+		TOML_NODISCARD
+		std::string_view contiguous() const noexcept final
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_bare_key_character(*cp) || is_string_delimiter(*cp));
-			push_parse_scope("key"sv);
+			return batch_;
+		}
 
-			key_buffer.clear();
-			recording_whitespace = false;
+#if !TOML_EXCEPTIONS
 
-			while (!is_error())
-			{
-				std::string_view key_segment;
-				const auto key_begin = current_position();
+		TOML_NODISCARD
+		optional<parse_error>&& error() noexcept final
+		{
+			return std::move(err_);
+		}
 
-				// bare_key_segment
-				if (is_bare_key_character(*cp))
-					key_segment = parse_bare_key_segment();
+#endif
+	};
 
-				// "quoted key segment"
-				else if (is_string_delimiter(*cp))
-				{
-					const auto begin_pos = cp->position;
+#if TOML_ENABLE_MMAP
 
-					recording_whitespace = true;
-					parsed_string str	 = parse_string();
-					recording_whitespace = false;
-					return_if_error({});
+	class mapped_file
+	{
+	  private:
+		void* base_ = {};
+		size_t size_ = {};
+#if TOML_WINDOWS
+		void* mapping_ = {};
+#endif
 
-					if (str.was_multi_line)
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit mapped_file(const std::string& path)
+		{
+#if TOML_WINDOWS
+			// spelled out rather than using the <Windows.h> macros so this compiles the same way with or without it
+			constexpr unsigned long generic_read		  = 0x80000000ul;
+			constexpr unsigned long file_share_read_write = 0x00000001ul | 0x00000002ul;
+			constexpr unsigned long open_existing		  = 3ul;
+			constexpr unsigned long normal_sequential	  = 0x00000080ul | 0x08000000ul;
+			constexpr unsigned long page_readonly		  = 0x02ul;
+			constexpr unsigned long file_map_read		  = 0x0004ul;
+			constexpr unsigned long invalid_file_size	  = 0xFFFFFFFFul;
+
+			void* const file = ::CreateFileW(impl::widen(path).c_str(),
+											 generic_read,
+											 file_share_read_write,
+											 nullptr,
+											 open_existing,
+											 normal_sequential,
+											 nullptr);
+			if (file == reinterpret_cast<void*>(static_cast<intptr_t>(-1))) // INVALID_HANDLE_VALUE
+				return;
+
+			// a low word of INVALID_FILE_SIZE is ambiguous without GetLastError(), so those just aren't mapped
+			unsigned long size_high		  = 0;
+			const unsigned long size_low  = ::GetFileSize(file, &size_high);
+			const auto file_size		  = (static_cast<unsigned long long>(size_high) << 32) | size_low;
+			if (size_low != invalid_file_size && file_size > 0u && file_size <= ~size_t{})
+			{
+				mapping_ = ::CreateFileMappingW(file, nullptr, page_readonly, 0, 0, nullptr);
+				if (mapping_)
+				{
+					base_ = ::MapViewOfFile(mapping_, file_map_read, 0, 0, 0);
+					if (base_)
+						size_ = static_cast<size_t>(file_size);
+					else
 					{
-						set_error_at(begin_pos,
-									 "multi-line strings are prohibited in "sv,
-									 key_buffer.empty() ? ""sv : "dotted "sv,
-									 "keys"sv);
-						return_after_error({});
+						::CloseHandle(mapping_);
+						mapping_ = {};
 					}
-					else
-						key_segment = str.value;
 				}
+			}
+			::CloseHandle(file);
+#else
+			const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd == -1)
+				return;
 
-				// ???
-				else
-					set_error_and_return_default("expected bare key starting character or string delimiter, saw '"sv,
-												 to_sv(*cp),
-												 "'"sv);
+			struct stat file_info;
+			if (::fstat(fd, &file_info) == 0 && S_ISREG(file_info.st_mode) && file_info.st_size > 0
+				&& static_cast<unsigned long long>(file_info.st_size) <= ~size_t{})
+			{
+				const auto file_size = static_cast<size_t>(file_info.st_size);
+				void* const base	 = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (base != MAP_FAILED)
+				{
+					::posix_madvise(base, file_size, POSIX_MADV_SEQUENTIAL);
+					base_ = base;
+					size_ = file_size;
+				}
+			}
+			::close(fd);
+#endif
+		}
 
-				const auto key_end = current_position();
+		~mapped_file() noexcept
+		{
+#if TOML_WINDOWS
+			if (base_)
+				::UnmapViewOfFile(base_);
+			if (mapping_)
+				::CloseHandle(mapping_);
+#else
+			if (base_)
+				::munmap(base_, size_);
+#endif
+		}
 
-				// whitespace following the key segment
-				consume_leading_whitespace();
+		mapped_file(const mapped_file&)			   = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
 
-				// store segment
-				key_buffer.push_back(key_segment, key_begin, key_end);
+		TOML_PURE_INLINE_GETTER
+		explicit operator bool() const noexcept
+		{
+			return base_ != nullptr;
+		}
 
-				if TOML_UNLIKELY(key_buffer.size() > max_dotted_keys_depth)
-					set_error_and_return_default("exceeded maximum dotted keys depth of "sv,
-												 max_dotted_keys_depth,
-												 " (TOML_MAX_DOTTED_KEYS_DEPTH)"sv);
+		TOML_PURE_INLINE_GETTER
+		std::string_view view() const noexcept
+		{
+			return { static_cast<const char*>(base_), size_ };
+		}
+	};
 
-				// eof or no more key to come
-				if (is_eof() || *cp != U'.')
-					break;
+#endif
 
-				// was a dotted key - go around again
-				advance_and_return_if_error_or_eof({});
-				consume_leading_whitespace();
-				set_error_and_return_if_eof({});
-			}
-			return_if_error({});
+	// parse_contents is called with the file's contents (as either a std::string_view or a std::istream&)
+	// and its path, and returns a Result.
+	template <typename Result, typename Func>
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	Result do_parse_file(std::string_view file_path, Func&& parse_contents)
+	{
+#if TOML_EXCEPTIONS
+#define TOML_PARSE_FILE_ERROR(msg, path)                                                                               \
+	throw parse_error(msg, source_position{}, source_path_ptr{ std::move(path) })
+#else
+#define TOML_PARSE_FILE_ERROR(msg, path)                                                                               \
+	return Result(parse_error(msg, source_position{}, source_path_ptr{ std::move(path) }))
+#endif
 
-			return true;
-		}
+		std::string file_path_str(file_path);
 
-		TOML_NODISCARD
-		key make_key(size_t segment_index) const
-		{
-			TOML_ASSERT(key_buffer.size() > segment_index);
+#if TOML_ENABLE_MMAP
 
-			return key{
-				key_buffer[segment_index],
-				source_region{ key_buffer.starts[segment_index], key_buffer.ends[segment_index], root.source().path }
-			};
-		}
+		// map the file straight into memory and parse it in-place, regardless of size
+		// (empty files, pipes, device nodes etc. can't be mapped so they fall through to the stream path below)
+		if (const mapped_file mapping{ file_path_str })
+			return parse_contents(mapping.view(), std::move(file_path_str));
 
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		table* parse_table_header()
-		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(*cp == U'[');
-			push_parse_scope("table header"sv);
+#endif
 
-			const source_position header_begin_pos = cp->position;
-			source_position header_end_pos;
-			bool is_arr = false;
+		// open file with a custom-sized stack buffer
+		std::ifstream file;
+		TOML_OVERALIGNED char file_buffer[sizeof(void*) * 1024u];
+		file.rdbuf()->pubsetbuf(file_buffer, sizeof(file_buffer));
+#if TOML_WINDOWS && !(defined(__MINGW32__) || defined(__MINGW64__))
+		file.open(impl::widen(file_path_str).c_str(), std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+#else
+		file.open(file_path_str, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+#endif
+		if (!file.is_open())
+			TOML_PARSE_FILE_ERROR("File could not be opened for reading", file_path_str);
 
-			// parse header
-			{
-				// skip first '['
-				advance_and_return_if_error_or_eof({});
+		// get size
+		const auto file_size = file.tellg();
+		if (file_size == -1)
+			TOML_PARSE_FILE_ERROR("Could not determine file size", file_path_str);
+		file.seekg(0, std::ifstream::beg);
 
-				// skip past any whitespace that followed the '['
-				const bool had_leading_whitespace = consume_leading_whitespace();
-				set_error_and_return_if_eof({});
+		// read the whole file into memory first if the file isn't too large
+		constexpr auto large_file_threshold = 1024 * 1024 * 2; // 2 MB
+		if (file_size <= large_file_threshold)
+		{
+			std::vector<char> file_data;
+			file_data.resize(static_cast<size_t>(file_size));
+			file.read(file_data.data(), static_cast<std::streamsize>(file_size));
+			return parse_contents(std::string_view{ file_data.data(), file_data.size() }, std::move(file_path_str));
+		}
 
-				// skip second '[' (if present)
-				if (*cp == U'[')
-				{
-					if (had_leading_whitespace)
-						set_error_and_return_default(
-							"[[array-of-table]] brackets must be contiguous (i.e. [ [ this ] ] is prohibited)"sv);
+		// otherwise parse it using the streams
+		else
+			return parse_contents(file, std::move(file_path_str));
 
-					is_arr = true;
-					advance_and_return_if_error_or_eof({});
+#undef TOML_PARSE_FILE_ERROR
+	}
 
-					// skip past any whitespace that followed the '['
-					consume_leading_whitespace();
-					set_error_and_return_if_eof({});
-				}
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	parse_result do_parse_file(std::string_view file_path)
+	{
+		return do_parse_file<parse_result>(file_path,
+										   [](auto&& doc, std::string&& path)
+										   { return parse(static_cast<decltype(doc)&&>(doc), std::move(path)); });
+	}
 
-				// check for a premature closing ']'
-				if (*cp == U']')
-					set_error_and_return_default("tables with blank bare keys are explicitly prohibited"sv);
+	TOML_INTERNAL_LINKAGE
+	sax_parse_result do_parse_file(std::string_view file_path, sax_handler & handler)
+	{
+		return do_parse_file<sax_parse_result>(file_path,
+											   [&](auto&& doc, std::string&& path)
+											   { return parse(static_cast<decltype(doc)&&>(doc), handler, path); });
+	}
 
-				if (!is_bare_key_character(*cp) && !is_string_delimiter(*cp))
-					set_error_and_return_default("expected bare key starting character or string delimiter, saw '"sv,
-												 to_sv(*cp),
-												 "'"sv);
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	parse_result do_parse_file(std::string_view file_path, const parse_options& options)
+	{
+		return do_parse_file<parse_result>(file_path,
+										   [&](auto&& doc, std::string&& path)
+										   { return parse(static_cast<decltype(doc)&&>(doc), options, path); });
+	}
 
-				// get the actual key
-				start_recording();
-				parse_key();
-				stop_recording(1u);
-				return_if_error({});
+	// how many threads parse_options::threads actually means.
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	size_t resolve_threads(size_t threads) noexcept
+	{
+#if TOML_ENABLE_THREADS
+		if (!threads)
+			threads = std::thread::hardware_concurrency();
+		return threads ? threads : 1u;
+#else
+		TOML_UNUSED(threads);
+		return 1u;
+#endif
+	}
 
-				// skip past any whitespace that followed the key
-				consume_leading_whitespace();
-				return_if_error({});
-				set_error_and_return_if_eof({});
+	// calls func(i) for each i in [0, jobs), spread over up to max_threads threads (including the calling one).
+	// func must not throw.
+	template <typename Func>
+	TOML_INTERNAL_LINKAGE
+	void run_in_parallel(size_t jobs, size_t max_threads, Func&& func)
+	{
+		if (!jobs)
+			return;
 
-				// consume the closing ']'
-				if (*cp != U']')
-					set_error_and_return_default("expected ']', saw '"sv, to_sv(*cp), "'"sv);
-				if (is_arr)
-				{
-					advance_and_return_if_error_or_eof({});
-					if (*cp != U']')
-						set_error_and_return_default("expected ']', saw '"sv, to_sv(*cp), "'"sv);
-				}
-				advance_and_return_if_error({});
-				header_end_pos = current_position(1);
+		std::atomic<size_t> next_job{};
+		const auto work = [&]() noexcept
+		{
+			for (auto i = next_job++; i < jobs; i = next_job++)
+				func(i);
+		};
 
-				// handle the rest of the line after the header
-				consume_leading_whitespace();
-				if (!is_eof() && !consume_comment() && !consume_line_break())
-					set_error_and_return_default("expected a comment or whitespace, saw '"sv, to_sv(cp), "'"sv);
+#if TOML_ENABLE_THREADS
+		std::vector<std::thread> threads;
+		const auto extra_threads = (max_threads < jobs ? max_threads : jobs) - 1u;
+		threads.reserve(extra_threads);
+		for (size_t i = 0; i < extra_threads; i++)
+		{
+#if TOML_EXCEPTIONS
+			try
+			{
+				threads.emplace_back(work);
 			}
-			TOML_ASSERT(!key_buffer.empty());
-
-			// check if each parent is a table/table array, or can be created implicitly as a table.
-			table* parent = &root;
-			for (size_t i = 0, e = key_buffer.size() - 1u; i < e; i++)
+			catch (const std::system_error&)
 			{
-				const std::string_view segment = key_buffer[i];
-				auto pit					   = parent->lower_bound(segment);
-
-				// parent already existed
-				if (pit != parent->end() && pit->first == segment)
-				{
-					node& p = pit->second;
+				break; // the threads that did start (and this one) will pick up the slack
+			}
+#else
+			threads.emplace_back(work);
+#endif
+		}
 
-					if (auto tbl = p.as_table())
-					{
-						// adding to closed inline tables is illegal
-						if (tbl->is_inline() && !impl::find(open_inline_tables.begin(), open_inline_tables.end(), tbl))
-							set_error_and_return_default("cannot insert '"sv,
-														 to_sv(recording_buffer),
-														 "' into existing inline table"sv);
+		work();
+		for (auto& thread : threads)
+			thread.join();
+#else
+		TOML_UNUSED(max_threads);
+		work();
+#endif
+	}
 
-						parent = tbl;
-					}
-					else if (auto arr = p.as_array(); arr && impl::find(table_arrays.begin(), table_arrays.end(), arr))
-					{
-						// table arrays are a special case;
-						// the spec dictates we select the most recently declared element in the array.
-						TOML_ASSERT(!arr->empty());
-						TOML_ASSERT(arr->back().is_table());
-						parent = &arr->back().ref_cast<table>();
-					}
-					else
-					{
-						if (!is_arr && p.type() == node_type::table)
-							set_error_and_return_default("cannot redefine existing table '"sv,
-														 to_sv(recording_buffer),
-														 "'"sv);
-						else
-							set_error_and_return_default("cannot redefine existing "sv,
-														 to_sv(p.type()),
-														 " '"sv,
-														 to_sv(recording_buffer),
-														 "' as "sv,
-														 is_arr ? "array-of-tables"sv : "table"sv);
-					}
-				}
+#if TOML_ENABLE_THREADS
 
-				// need to create a new implicit table
-				else
-				{
-					pit		  = parent->emplace_hint<table>(pit, make_key(i));
-					table& p  = pit->second.ref_cast<table>();
-					p.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
+	// splits a document at its top-level table headers and parses the key-value pairs between them concurrently,
+	// then merges them in document order. returns nothing if it wasn't worth it, or if the result might differ from
+	// parsing the document in one go (which includes all errors), in which case the caller should do just that.
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	optional<table> parse_in_parallel(std::string_view doc, std::string_view source_path, const parse_options& options)
+	{
+		const size_t min_bytes = options.min_bytes_per_thread ? options.min_bytes_per_thread : 1u;
+		auto max_threads	   = resolve_threads(options.threads);
+		if (max_threads > doc.length() / min_bytes)
+			max_threads = doc.length() / min_bytes;
+		if (max_threads < 2u)
+			return {};
+
+		if (doc.length() >= 3u && memcmp(utf8_byte_order_mark.data(), doc.data(), 3u) == 0)
+			doc.remove_prefix(3u);
+
+		// chunk 0 is everything before the first table header, the rest each start with one
+		struct chunk
+		{
+			std::string_view header;
+			std::string_view body;
+			source_position header_pos;
+			source_position body_pos;
+		};
+		std::vector<chunk> chunks;
+		{
+			const auto begin = doc.data();
+			const auto end	 = begin + doc.length();
 
-					implicit_tables.push_back(&p);
-					parent = &p;
+			std::vector<const char*> starts{ begin };
+			const auto check_line = [&](const char* line) noexcept
+			{
+				while (line < end && (*line == ' ' || *line == '\t'))
+					line++;
+				return line < end && *line == '[';
+			};
+			if (check_line(begin))
+				starts.push_back(begin);
+			top_level_scanner{}.scan(begin,
+									 end,
+									 [&](const char* line)
+									 {
+										 if (check_line(line))
+											 starts.push_back(line);
+									 });
+			if (starts.size() < 2u)
+				return {};
+			starts.push_back(end);
+
+			chunks.resize(starts.size() - 1u);
+			source_index line = 1;
+			for (size_t i = 0; i < chunks.size(); i++)
+			{
+				auto& c	 = chunks[i];
+				auto pos = starts[i];
+				if (i)
+				{
+					auto header_end = static_cast<const char*>(memchr(pos, '\n', static_cast<size_t>(starts[i + 1] - pos)));
+					header_end		= header_end ? header_end + 1 : starts[i + 1];
+					c.header		= { pos, static_cast<size_t>(header_end - pos) };
+					c.header_pos	= { line, 1 };
+					line += header_end[-1] == '\n' ? 1u : 0u;
+					pos = header_end;
 				}
-			}
+				c.body	   = { pos, static_cast<size_t>(starts[i + 1] - pos) };
+				c.body_pos = { line, 1 };
 
-			const auto last_segment = key_buffer.back();
-			auto it					= parent->lower_bound(last_segment);
+				for (auto lf = pos; (lf = static_cast<const char*>(memchr(lf, '\n', static_cast<size_t>(starts[i + 1] - lf))));
+					 lf++)
+					line++;
+			}
+		}
 
-			// if there was already a matching node some sanity checking is necessary;
-			// this is ok if we're making an array and the existing element is already an array (new element)
-			// or if we're making a table and the existing element is an implicitly-created table (promote it),
-			// otherwise this is a redefinition error.
-			if (it != parent->end() && it->first == last_segment)
+		// parse the chunks, in runs of consecutive ones of roughly equal size so each run only needs one parser
+		std::vector<size_t> runs{ 0u };
+		{
+			const auto run_length = doc.length() / (max_threads * 4u) + 1u;
+			size_t length		  = {};
+			for (size_t i = 0; i < chunks.size(); i++)
 			{
-				node& matching_node = it->second;
-				if (auto arr = matching_node.as_array();
-					is_arr && arr && impl::find(table_arrays.begin(), table_arrays.end(), arr))
+				length += chunks[i].header.length() + chunks[i].body.length();
+				if (length >= run_length)
 				{
-					table& tbl	= arr->emplace_back<table>();
-					tbl.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
-					return &tbl;
+					runs.push_back(i + 1u);
+					length = {};
 				}
+			}
+			if (runs.back() != chunks.size())
+				runs.push_back(chunks.size());
+		}
 
-				else if (auto tbl = matching_node.as_table(); !is_arr && tbl && !implicit_tables.empty())
-				{
-					if (auto found = impl::find(implicit_tables.begin(), implicit_tables.end(), tbl); found)
-					{
-						bool ok = true;
-						if (!tbl->empty())
+		const auto path = source_path.empty() ? source_path_ptr{} : source_path_ptr{ source_path };
+		std::vector<table> bodies(chunks.size());
+		source_position last_body_end{};
+		std::atomic<bool> failed{};
+		run_in_parallel(runs.size() - 1u,
+						max_threads,
+						[&](size_t run) noexcept
 						{
-							for (auto& [_, child] : *tbl)
+#if TOML_EXCEPTIONS
+							try
+#endif
 							{
-								if (!child.is_table() && !child.is_array_of_tables())
+								utf8_batch_reader reader{ source_path_ptr{ path } };
+								impl::parser parser{ reader, nullptr, nullptr, &options };
+								for (size_t i = runs[run]; i < runs[run + 1u] && !failed; i++)
 								{
-									ok = false;
-									break;
+									if (chunks[i].body.empty())
+										continue;
+
+									reader.set_batch(chunks[i].body);
+									parser.parse_batch(chunks[i].body_pos);
+#if !TOML_EXCEPTIONS
+									if (parser.failed())
+									{
+										failed = true;
+										return;
+									}
+#endif
+									if (i + 1u == chunks.size())
+										last_body_end = parser.end_position();
+									bodies[i] = parser.release_root();
 								}
 							}
-						}
-
-						if (ok)
-						{
-							implicit_tables.erase(implicit_tables.cbegin() + (found - implicit_tables.data()));
-							tbl->source_.begin = header_begin_pos;
-							tbl->source_.end   = header_end_pos;
-							return tbl;
-						}
-					}
-				}
-
-				// if we get here it's a redefinition error.
-				if (!is_arr && matching_node.type() == node_type::table)
-				{
-					set_error_at(header_begin_pos,
-								 "cannot redefine existing table '"sv,
-								 to_sv(recording_buffer),
-								 "'"sv);
-					return_after_error({});
-				}
-				else
-				{
-					set_error_at(header_begin_pos,
-								 "cannot redefine existing "sv,
-								 to_sv(matching_node.type()),
-								 " '"sv,
-								 to_sv(recording_buffer),
-								 "' as "sv,
-								 is_arr ? "array-of-tables"sv : "table"sv);
-					return_after_error({});
-				}
-			}
+#if TOML_EXCEPTIONS
+							catch (...)
+							{
+								failed = true;
+							}
+#endif
+						});
+		if (failed)
+			return {};
 
-			// there was no matching node, sweet - we can freely instantiate a new table/table array.
-			else
+		// merge them (the headers are all parsed here so the tables they refer to are checked and created in order)
+		utf8_batch_reader reader{ source_path_ptr{ path } };
+		impl::parser parser{ reader, nullptr, nullptr, &options };
+#if TOML_EXCEPTIONS
+		try
+#endif
+		{
+			for (size_t i = 0; i < chunks.size(); i++)
 			{
-				auto last_key = make_key(key_buffer.size() - 1u);
-
-				// if it's an array we need to make the array and it's first table element,
-				// set the starting regions, and return the table element
-				if (is_arr)
-				{
-					it			   = parent->emplace_hint<array>(it, std::move(last_key));
-					array& tbl_arr = it->second.ref_cast<array>();
-					table_arrays.push_back(&tbl_arr);
-					tbl_arr.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
-
-					table& tbl	= tbl_arr.emplace_back<table>();
-					tbl.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
-					return &tbl;
-				}
-
-				// otherwise we're just making a table
-				else
+				if (i)
 				{
-					it			= parent->emplace_hint<table>(it, std::move(last_key));
-					table& tbl	= it->second.ref_cast<table>();
-					tbl.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
-					return &tbl;
+					reader.set_batch(chunks[i].header);
+					parser.parse_batch(chunks[i].header_pos);
+#if !TOML_EXCEPTIONS
+					if (parser.failed())
+						return {};
+#endif
 				}
+				if (!parser.merge_chunk(bodies[i]))
+					return {};
 			}
 		}
-
-		TOML_NEVER_INLINE
-		bool parse_key_value_pair_and_insert(table* tbl)
+#if TOML_EXCEPTIONS
+		catch (const parse_error&)
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_string_delimiter(*cp) || is_bare_key_character(*cp));
-			push_parse_scope("key-value pair"sv);
-
-			// read the key into the key buffer
-			start_recording();
-			parse_key();
-			stop_recording(1u);
-			return_if_error({});
-			TOML_ASSERT(key_buffer.size() >= 1u);
-
-			// skip past any whitespace that followed the key
-			consume_leading_whitespace();
-			set_error_and_return_if_eof({});
-
-			// '='
-			if (*cp != U'=')
-				set_error_and_return_default("expected '=', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
-
-			// skip past any whitespace that followed the '='
-			consume_leading_whitespace();
-			return_if_error({});
-			set_error_and_return_if_eof({});
+			return {};
+		}
+#endif
 
-			// check that the next character could actually be a value
-			if (is_value_terminator(*cp))
-				set_error_and_return_default("expected value, saw '"sv, to_sv(*cp), "'"sv);
+		parser.finish_document(chunks.back().body.empty() ? parser.end_position() : last_body_end);
+		return parser.release_root();
+	}
 
-			// if it's a dotted kvp we need to spawn the parent sub-tables if necessary,
-			// and set the target table to the second-to-last one in the chain
-			if (key_buffer.size() > 1u)
-			{
-				for (size_t i = 0; i < key_buffer.size() - 1u; i++)
-				{
-					const std::string_view segment = key_buffer[i];
-					auto pit					   = tbl->lower_bound(segment);
+#endif
 
-					// parent already existed
-					if (pit != tbl->end() && pit->first == segment)
-					{
-						table* p = pit->second.as_table();
+	// parses whole documents one after the other with the same parser, so the buffers etc. it needs only get
+	// allocated once per batch instead of once per document.
+	class reusable_parser
+	{
+	  private:
+		const parse_options* options_;
+		utf8_batch_reader reader_{ source_path_ptr{} };
+		std::unique_ptr<impl::parser> parser_;
 
-						// redefinition
-						if TOML_UNLIKELY(!p
-							|| !(impl::find(dotted_key_tables.begin(), dotted_key_tables.end(), p)
-								 || impl::find(implicit_tables.begin(), implicit_tables.end(), p)))
-						{
-							set_error_at(key_buffer.starts[i],
-										 "cannot redefine existing "sv,
-										 to_sv(pit->second.type()),
-										 " as dotted key-value pair"sv);
-							return_after_error({});
-						}
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit reusable_parser(const parse_options& options) noexcept //
+			: options_{ &options }
+		{}
 
-						tbl = p;
-					}
+		TOML_NODISCARD
+		parse_result parse(std::string_view doc, source_path_ptr&& source_path)
+		{
+			if (doc.length() >= 3u && memcmp(utf8_byte_order_mark.data(), doc.data(), 3u) == 0)
+				doc.remove_prefix(3u);
 
-					// need to create a new implicit table
-					else
-					{
-						pit		  = tbl->emplace_hint<table>(pit, make_key(i));
-						table& p  = pit->second.ref_cast<table>();
-						p.source_ = pit->first.source();
+			reader_.set_batch(doc);
+			reader_.set_source_path(std::move(source_path));
+			if (parser_)
+				parser_->reset();
+			else
+				parser_ = std::make_unique<impl::parser>(reader_, nullptr, nullptr, options_);
 
-						dotted_key_tables.push_back(&p);
-						tbl = &p;
-					}
-				}
+#if TOML_EXCEPTIONS
+			try
+			{
+				if (!doc.empty())
+					parser_->parse_batch({ 1, 1 });
 			}
-
-			// ensure this isn't a redefinition
-			const std::string_view last_segment = key_buffer.back();
-			auto it								= tbl->lower_bound(last_segment);
-			if (it != tbl->end() && it->first == last_segment)
+			catch (...)
 			{
-				set_error("cannot redefine existing "sv,
-						  to_sv(it->second.type()),
-						  " '"sv,
-						  to_sv(recording_buffer),
-						  "'"sv);
-				return_after_error({});
+				parser_.reset(); // (not reusable after an error)
+				throw;
 			}
+#else
+			if (!doc.empty())
+				parser_->parse_batch({ 1, 1 });
+			if (parser_->failed())
+			{
+				auto err = *parser_->error();
+				parser_.reset(); // (not reusable after an error)
+				return parse_result{ std::move(err) };
+			}
+#endif
 
-			// create the key first since the key buffer will likely get overwritten during value parsing (inline
-			// tables)
-			auto last_key = make_key(key_buffer.size() - 1u);
-
-			// now we can actually parse the value
-			node_ptr val = parse_value();
-			return_if_error({});
-
-			tbl->emplace_hint<node_ptr>(it, std::move(last_key), std::move(val));
-			return true;
+			parser_->finish_document();
+			return parse_result{ parser_->release_root() };
 		}
+	};
 
-		void parse_document()
+	// parses count documents with parse_one(i, reusable_parser&), spread over parse_options::threads threads.
+	// if errors is given, each document's parse_error is stored in it rather than the first of them being thrown.
+	template <typename Func>
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	std::vector<parse_result> do_parse_many(size_t count,
+											const parse_options& options,
+											std::vector<optional<parse_error>>* errors,
+											Func&& parse_one)
+	{
+		std::vector<parse_result> results(count);
+		if (errors)
 		{
-			assert_not_error();
-			assert_not_eof();
-			push_parse_scope("root table"sv);
-
-			table* current_table = &root;
+			errors->clear();
+			errors->resize(count);
+		}
+#if TOML_EXCEPTIONS
+		std::vector<std::exception_ptr> exceptions(count);
+#endif
 
-			do
-			{
-				return_if_error();
+		// in runs of consecutive documents, one parser per run
+		const auto max_threads = resolve_threads(options.threads);
+		const auto run_length  = count / (max_threads * 4u) + 1u;
+		run_in_parallel((count + run_length - 1u) / run_length,
+						max_threads,
+						[&](size_t run) noexcept
+						{
+							reusable_parser parser{ options };
+							const auto end = run_length * (run + 1u) < count ? run_length * (run + 1u) : count;
+							for (size_t i = run_length * run; i < end; i++)
+							{
+#if TOML_EXCEPTIONS
+								try
+								{
+									results[i] = parse_one(i, parser);
+								}
+								catch (const parse_error& err)
+								{
+									if (errors)
+										(*errors)[i] = err;
+									else
+										exceptions[i] = std::current_exception();
+								}
+								catch (...)
+								{
+									exceptions[i] = std::current_exception();
+								}
+#else
+								results[i] = parse_one(i, parser);
+								if (errors && !results[i])
+									(*errors)[i] = results[i].error();
+#endif
+							}
+						});
 
-				// leading whitespace, line endings, comments
-				if (consume_leading_whitespace() || consume_line_break() || consume_comment())
-					continue;
-				return_if_error();
+#if TOML_EXCEPTIONS
+		for (auto& ex : exceptions)
+			if (ex)
+				std::rethrow_exception(ex);
+#endif
+		return results;
+	}
 
-				// [tables]
-				// [[table array]]
-				if (*cp == U'[')
-					current_table = parse_table_header();
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	std::vector<parse_result> do_parse_many(const std::string_view* docs,
+											size_t count,
+											const parse_options& options,
+											std::vector<optional<parse_error>>* errors)
+	{
+		return do_parse_many(count,
+							 options,
+							 errors,
+							 [&](size_t i, reusable_parser& parser) { return parser.parse(docs[i], source_path_ptr{}); });
+	}
 
-				// bare_keys
-				// dotted.keys
-				// "quoted keys"
-				else if (is_bare_key_character(*cp) || is_string_delimiter(*cp))
-				{
-					push_parse_scope("key-value pair"sv);
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	std::vector<parse_result> do_parse_files(const std::string_view* file_paths,
+											 size_t count,
+											 const parse_options& options,
+											 std::vector<optional<parse_error>>* errors)
+	{
+		return do_parse_many(
+			count,
+			options,
+			errors,
+			[&](size_t i, reusable_parser& parser)
+			{
+				return do_parse_file<parse_result>(file_paths[i],
+												   [&](auto&& doc, std::string&& path)
+												   {
+													   if constexpr (std::is_same_v<impl::remove_cvref<decltype(doc)>, std::string_view>)
+														   return parser.parse(doc, source_path_ptr{ std::move(path) });
+													   else
+														   return parse(doc, options, path); // (big files read via streams)
+												   });
+			});
+	}
+}
+TOML_ANON_NAMESPACE_END;
 
-					parse_key_value_pair_and_insert(current_table);
+TOML_IMPL_NAMESPACE_START
+{
+	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, impl_ex, impl_noex);
 
-					// handle the rest of the line after the kvp
-					// (this is not done in parse_key_value_pair() because that is also used for inline tables)
-					consume_leading_whitespace();
-					return_if_error();
-					if (!is_eof() && !consume_comment() && !consume_line_break())
-						set_error("expected a comment or whitespace, saw '"sv, to_sv(cp), "'"sv);
-				}
+	class incremental_parser_state
+	{
+	  private:
+		source_path_ptr source_path_;
+		utf8_batch_reader reader_;
+		parser parser_;
+		std::string pending_; // the incomplete line(s) at the end of the input so far
+		top_level_scanner scanner_;
+		bool started_ = false;
 
-				else // ??
-					set_error("expected keys, tables, whitespace or comments, saw '"sv, to_sv(cp), "'"sv);
-			}
-			while (!is_eof());
+#if TOML_EXCEPTIONS
+		optional<parse_error> err_;
+#endif
 
-			auto eof_pos	 = current_position(1);
-			root.source_.end = eof_pos;
-			if (current_table && current_table != &root && current_table->source_.end <= current_table->source_.begin)
-				current_table->source_.end = eof_pos;
+		// returns the end of the last complete top-level line in [begin, end), or nullptr if there wasn't one
+		TOML_NODISCARD
+		const char* scan(const char* begin, const char* end) noexcept
+		{
+			const char* last_line_end = {};
+			scanner_.scan(begin, end, [&](const char* line_end) noexcept { last_line_end = line_end; });
+			return last_line_end;
 		}
 
-		static void update_region_ends(node& nde) noexcept
+		void parse_batch(std::string_view batch, bool final_batch)
 		{
-			const auto type = nde.type();
-			if (type > node_type::array)
+			if (!started_)
+			{
+				started_ = true;
+				if (batch.length() >= 3u && memcmp(utf8_byte_order_mark.data(), batch.data(), 3u) == 0)
+					batch.remove_prefix(3u);
+			}
+			if (batch.empty())
 				return;
 
-			if (type == node_type::table)
-			{
-				auto& tbl = nde.ref_cast<table>();
-				if (tbl.is_inline()) // inline tables (and all their inline descendants) are already correctly
-									 // terminated
-					return;
+			reader_.set_batch(batch);
 
-				auto end = nde.source_.end;
-				for (auto&& [k, v] : tbl)
-				{
-					TOML_UNUSED(k);
-					update_region_ends(v);
-					if (end < v.source_.end)
-						end = v.source_.end;
-				}
+#if TOML_EXCEPTIONS
+			try
+			{
+				parser_.parse_batch(final_batch);
 			}
-			else // arrays
+			catch (const parse_error& e)
 			{
-				auto& arr = nde.ref_cast<array>();
-				auto end  = nde.source_.end;
-				for (auto&& v : arr)
-				{
-					update_region_ends(v);
-					if (end < v.source_.end)
-						end = v.source_.end;
-				}
-				nde.source_.end = end;
+				err_.emplace(e);
+				throw;
 			}
+#else
+			parser_.parse_batch(final_batch);
+#endif
 		}
 
 	  public:
-		parser(utf8_reader_interface&& reader_) //
-			: reader{ reader_ }
-		{
-			root.source_ = { prev_pos, prev_pos, reader.source_path() };
-
-			if (!reader.peek_eof())
-			{
-				cp = reader.read_next();
-
-#if !TOML_EXCEPTIONS
-				if (reader.error())
-				{
-					err = std::move(reader.error());
-					return;
-				}
-#endif
-
-				if (cp)
-					parse_document();
-			}
+		TOML_NODISCARD_CTOR
+		explicit incremental_parser_state(source_path_ptr source_path) //
+			: source_path_{ source_path },
+			  reader_{ std::move(source_path) },
+			  parser_{ reader_ }
+		{}
 
-			update_region_ends(root);
+		TOML_NODISCARD
+		const source_path_ptr& source_path() const noexcept
+		{
+			return source_path_;
 		}
 
-		TOML_NODISCARD
-		operator parse_result() && noexcept
+		TOML_PURE_GETTER
+		bool failed() const noexcept
 		{
 #if TOML_EXCEPTIONS
-
-			return { std::move(root) };
-
+			return !!err_;
 #else
-
-			if (err)
-				return parse_result{ *std::move(err) };
-			else
-				return parse_result{ std::move(root) };
-
+			return parser_.failed();
 #endif
 		}
-	};
-
-	TOML_EXTERNAL_LINKAGE
-	node_ptr parser::parse_array()
-	{
-		return_if_error({});
-		assert_not_eof();
-		TOML_ASSERT_ASSUME(*cp == U'[');
-		push_parse_scope("array"sv);
-
-		// skip opening '['
-		advance_and_return_if_error_or_eof({});
-
-		node_ptr arr_ptr{ new array{} };
-		array& arr = arr_ptr->ref_cast<array>();
-		enum class TOML_CLOSED_ENUM parse_type : int
-		{
-			none,
-			comma,
-			val
-		};
-		parse_type prev = parse_type::none;
 
-		while (!is_error())
+		void feed(std::string_view chunk)
 		{
-			while (consume_leading_whitespace() || consume_line_break() || consume_comment())
-				continue;
-			set_error_and_return_if_eof({});
+			if (failed() || chunk.empty())
+				return;
 
-			// commas - only legal after a value
-			if (*cp == U',')
+			// nothing left over from the previous chunk; complete lines can be parsed straight out of this one
+			if (pending_.empty())
 			{
-				if (prev == parse_type::val)
+				const auto line_end = scan(chunk.data(), chunk.data() + chunk.length());
+				if (line_end)
 				{
-					prev = parse_type::comma;
-					advance_and_return_if_error_or_eof({});
-					continue;
+					const auto len = static_cast<size_t>(line_end - chunk.data());
+					parse_batch(chunk.substr(0, len), false);
+					chunk.remove_prefix(len);
 				}
-				set_error_and_return_default("expected value or closing ']', saw comma"sv);
+				pending_.assign(chunk);
+				return;
 			}
 
-			// closing ']'
-			else if (*cp == U']')
+			const auto old_len = pending_.length();
+			pending_.append(chunk);
+			if (const auto line_end = scan(pending_.data() + old_len, pending_.data() + pending_.length()))
 			{
-				advance_and_return_if_error({});
-				break;
+				const auto len = static_cast<size_t>(line_end - pending_.data());
+				parse_batch(std::string_view{ pending_.data(), len }, false);
+				pending_.erase(0, len);
 			}
+		}
 
-			// must be a value
-			else
-			{
-				if (prev == parse_type::val)
-				{
-					set_error_and_return_default("expected comma or closing ']', saw '"sv, to_sv(*cp), "'"sv);
-					continue;
-				}
-				prev = parse_type::val;
-
-				auto val = parse_value();
-				return_if_error({});
+		TOML_NODISCARD
+		parse_result finish()
+		{
+#if TOML_EXCEPTIONS
+			if (err_)
+				throw *err_;
+#endif
 
-				if (!arr.capacity())
-					arr.reserve(4u);
-				arr.emplace_back<node_ptr>(std::move(val));
-			}
+			parse_batch(pending_, true);
+			pending_.clear();
+			parser_.finish_document();
+			return std::move(parser_);
 		}
+	};
 
-		return_if_error({});
-		return arr_ptr;
-	}
-
-	TOML_EXTERNAL_LINKAGE
-	node_ptr parser::parse_inline_table()
+	class lazy_document_state
 	{
-		return_if_error({});
-		assert_not_eof();
-		TOML_ASSERT_ASSUME(*cp == U'{');
-		push_parse_scope("inline table"sv);
+	  private:
+		std::string doc_; // (the values that were skipped over are spans of it, unless the caller's was borrowed)
+		source_path_ptr source_path_;
+		table root_;
+		value_key_set values_{ buffer_allocator{} }; // the values that were skipped over, in document order
+		size_t remaining_ = {};						 // how many of them haven't been parsed yet
 
-		// skip opening '{'
-		advance_and_return_if_error_or_eof({});
+#if TOML_EXCEPTIONS
+		bool failed_ = false;
+#else
+		optional<parse_error> err_;
+#endif
 
-		node_ptr tbl_ptr{ new table{} };
-		table& tbl = tbl_ptr->ref_cast<table>();
-		tbl.is_inline(true);
-		table_vector_scope table_scope{ open_inline_tables, tbl };
+		TOML_PURE_INLINE_GETTER
+		table& parent_of(const value_key_set::entry& val) noexcept
+		{
+			return val.parent ? *val.parent : root_;
+		}
 
-		enum class TOML_CLOSED_ENUM parse_type : int
+		node& insert(value_key_set::entry& val, node_ptr&& nde)
 		{
-			none,
-			comma,
-			kvp
-		};
-		parse_type prev = parse_type::none;
-		while (!is_error())
+			val.source = {};
+			remaining_--;
+
+			auto& parent = parent_of(val);
+			return parent.emplace_hint<node_ptr>(parent.lower_bound(val.k.str()), key{ val.k }, std::move(nde))
+				->second;
+		}
+
+		// parses a value that was skipped over and puts it in the tree, returning nullptr if it was malformed
+		// (without exceptions).
+		TOML_NODISCARD
+		node* parse_skipped(value_key_set::entry& val)
 		{
-			if constexpr (TOML_LANG_UNRELEASED) // toml/issues/516 (newlines/trailing commas in inline tables)
+			TOML_ASSERT_ASSUME(!val.source.empty());
+
+			utf8_batch_reader reader{ source_path_ptr{ source_path_ } };
+			reader.set_batch(val.source);
+			parser value_parser{ reader };
+
+#if TOML_EXCEPTIONS
+			node_ptr nde;
+			try
 			{
-				while (consume_leading_whitespace() || consume_line_break() || consume_comment())
-					continue;
+				nde = value_parser.parse_deferred_value(val.position);
 			}
-			else
+			catch (const parse_error&)
 			{
-				while (consume_leading_whitespace())
-					continue;
+				failed_ = true;
+				throw;
 			}
-			return_if_error({});
-			set_error_and_return_if_eof({});
-
-			// commas - only legal after a key-value pair
-			if (*cp == U',')
+#else
+			node_ptr nde = value_parser.parse_deferred_value(val.position);
+			if (value_parser.failed())
 			{
-				if (prev == parse_type::kvp)
-				{
-					prev = parse_type::comma;
-					advance_and_return_if_error_or_eof({});
-				}
-				else
-					set_error_and_return_default("expected key-value pair or closing '}', saw comma"sv);
+				if (!err_)
+					err_ = std::move(value_parser.error());
+				return nullptr;
 			}
+#endif
 
-			// closing '}'
-			else if (*cp == U'}')
+			return &insert(val, std::move(nde));
+		}
+
+#if !TOML_EXCEPTIONS
+
+		// (see lazy_document::table())
+		void insert_default_value(value_key_set::entry& val)
+		{
+			node_ptr nde;
+			switch (val.type)
 			{
-				if constexpr (!TOML_LANG_UNRELEASED) // toml/issues/516 (newlines/trailing commas in inline tables)
+				case node_type::string: nde.reset(new value<std::string>{}); break;
+				case node_type::integer: nde.reset(new value<int64_t>{}); break;
+				case node_type::floating_point: nde.reset(new value<double>{}); break;
+				case node_type::boolean: nde.reset(new value<bool>{}); break;
+				case node_type::date: nde.reset(new value<toml::date>{}); break;
+				case node_type::time: nde.reset(new value<toml::time>{}); break;
+				case node_type::date_time: nde.reset(new value<toml::date_time>{}); break;
+				case node_type::array: nde.reset(new array{}); break;
+				case node_type::table:
 				{
-					if (prev == parse_type::comma)
-					{
-						set_error_and_return_default("expected key-value pair, saw closing '}' (dangling comma)"sv);
-						continue;
-					}
+					auto tbl = new table{};
+					tbl->is_inline(true);
+					nde.reset(tbl);
+					break;
 				}
-				advance_and_return_if_error({});
-				break;
+				default: TOML_UNREACHABLE;
 			}
+			static_cast<void>(insert(val, std::move(nde)));
+		}
 
-			// key-value pair
-			else if (is_string_delimiter(*cp) || is_bare_key_character(*cp))
+#endif
+
+		// the node at tbl[key], parsing it first if it was skipped over; nullptr if there isn't one
+		// (or it was malformed, without exceptions).
+		TOML_NODISCARD
+		node* find(table& tbl, std::string_view key)
+		{
+			if (const auto it = tbl.find(key); it != tbl.end())
+				return &it->second;
+			if (!remaining_)
+				return nullptr;
+
+			const auto val = values_.find(&tbl == &root_ ? nullptr : &tbl, key);
+			return val ? parse_skipped(*val) : nullptr;
+		}
+
+		// the tables at or beneath a node that values might have been skipped over in
+		static void collect_tables(node& nde, node_set<table>& tables)
+		{
+			// (anything that was parsed as a whole, e.g. inline tables, can't have had anything skipped)
+			if (auto tbl = nde.as_table(); tbl && !tbl->is_inline())
 			{
-				if (prev == parse_type::kvp)
-					set_error_and_return_default("expected comma or closing '}', saw '"sv, to_sv(*cp), "'"sv);
-				else
+				tables.insert(tbl);
+				for (auto&& [k, v] : *tbl)
+					collect_tables(v, tables);
+			}
+			else if (auto arr = nde.as_array())
+			{
+				for (auto&& elem : *arr)
 				{
-					prev = parse_type::kvp;
-					parse_key_value_pair_and_insert(&tbl);
+					if (auto elem_tbl = elem.as_table(); elem_tbl && !elem_tbl->is_inline())
+						collect_tables(*elem_tbl, tables);
 				}
 			}
-
-			/// ???
-			else
-				set_error_and_return_default("expected key or closing '}', saw '"sv, to_sv(*cp), "'"sv);
 		}
 
-		return_if_error({});
-		return tbl_ptr;
-	}
+		// node_views go straight to the tree, so nothing beneath the node they view can be left unparsed.
+		// (without exceptions, malformed values are skipped so everything else still gets parsed)
+		TOML_NODISCARD
+		bool resolve_all(node& nde)
+		{
+			if (!remaining_ || !(nde.is_table() || nde.is_array()))
+				return true;
 
-	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
-}
-TOML_IMPL_NAMESPACE_END;
+			node_set<table> tables{ buffer_allocator{} };
+			collect_tables(nde, tables);
+			if (tables.empty())
+				return true;
 
-#undef TOML_RETURNS_BY_THROWING
-#undef advance_and_return_if_error
-#undef advance_and_return_if_error_or_eof
-#undef assert_not_eof
-#undef assert_not_error
-#undef is_eof
-#undef is_error
-#undef parse_error_break
-#undef push_parse_scope
-#undef push_parse_scope_1
-#undef push_parse_scope_2
-#undef return_after_error
-#undef return_if_eof
-#undef return_if_error
-#undef return_if_error_or_eof
-#undef set_error_and_return
-#undef set_error_and_return_default
-#undef set_error_and_return_if_eof
-#undef utf8_buffered_reader_error_check
-#undef utf8_reader_error
-#undef utf8_reader_error_check
-#undef utf8_reader_return_after_error
+			bool ok = true;
+			for (auto& val : values_)
+			{
+				if (!val.source.empty() && tables.contains(&parent_of(val)))
+					ok = parse_skipped(val) && ok;
+			}
+			return ok;
+		}
 
-//#---------------------------------------------------------------------------------------------------------------------
-//# PARSER PUBLIC IMPLEMENTATION
-//#---------------------------------------------------------------------------------------------------------------------
+	  public:
+		TOML_NODISCARD_CTOR
+		lazy_document_state(std::string_view doc, std::string_view source_path, bool borrow) //
+			: doc_{ borrow ? std::string_view{} : doc }
+		{
+			utf8_reader reader{ borrow ? doc : std::string_view{ doc_ }, source_path };
+			source_path_ = reader.source_path();
 
-TOML_ANON_NAMESPACE_START
-{
-	TOML_NODISCARD
-	TOML_INTERNAL_LINKAGE
-	parse_result do_parse(utf8_reader_interface && reader)
-	{
-		return impl::parser{ std::move(reader) };
-	}
+			parse_result result = parser{ std::move(reader), nullptr, &values_ };
+#if TOML_EXCEPTIONS
+			root_ = std::move(result);
+#else
+			if (!result)
+			{
+				err_.emplace(std::move(result).error());
+				values_.clear();
+				return;
+			}
+			root_ = std::move(result).table();
+#endif
+			remaining_ = values_.size();
+		}
 
-	TOML_NODISCARD
-	TOML_INTERNAL_LINKAGE
-	parse_result do_parse_file(std::string_view file_path)
-	{
+		TOML_PURE_GETTER
+		bool failed() const noexcept
+		{
 #if TOML_EXCEPTIONS
-#define TOML_PARSE_FILE_ERROR(msg, path)                                                                               \
-	throw parse_error(msg, source_position{}, std::make_shared<const std::string>(std::move(path)))
+			return failed_;
 #else
-#define TOML_PARSE_FILE_ERROR(msg, path)                                                                               \
-	return parse_result(parse_error(msg, source_position{}, std::make_shared<const std::string>(std::move(path))))
+			return !!err_;
 #endif
+		}
 
-		std::string file_path_str(file_path);
+#if !TOML_EXCEPTIONS
 
-		// open file with a custom-sized stack buffer
-		std::ifstream file;
-		TOML_OVERALIGNED char file_buffer[sizeof(void*) * 1024u];
-		file.rdbuf()->pubsetbuf(file_buffer, sizeof(file_buffer));
-#if TOML_WINDOWS && !(defined(__MINGW32__) || defined(__MINGW64__))
-		file.open(impl::widen(file_path_str).c_str(), std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+		TOML_PURE_GETTER
+		const parse_error& error() const noexcept
+		{
+			TOML_ASSERT_ASSUME(err_);
+			return *err_;
+		}
+
+#endif
+
+		TOML_NODISCARD
+		toml::table& get_all()
+		{
+			for (auto& val : values_)
+			{
+				if (!remaining_)
+					break;
+				if (val.source.empty())
+					continue;
+
+#if TOML_EXCEPTIONS
+				static_cast<void>(parse_skipped(val));
 #else
-		file.open(file_path_str, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+				if (!parse_skipped(val))
+					insert_default_value(val);
 #endif
-		if (!file.is_open())
-			TOML_PARSE_FILE_ERROR("File could not be opened for reading", file_path_str);
+			}
+			return root_;
+		}
 
-		// get size
-		const auto file_size = file.tellg();
-		if (file_size == -1)
-			TOML_PARSE_FILE_ERROR("Could not determine file size", file_path_str);
-		file.seekg(0, std::ifstream::beg);
+		TOML_NODISCARD
+		node* get(std::string_view key)
+		{
+			const auto val = find(root_, key);
+			return val && resolve_all(*val) ? val : nullptr;
+		}
 
-		// read the whole file into memory first if the file isn't too large
-		constexpr auto large_file_threshold = 1024 * 1024 * 2; // 2 MB
-		if (file_size <= large_file_threshold)
+		// the node at the first `count` components of a path, parsing just what it has to along the way
+		TOML_NODISCARD
+		node* find(const toml::path& path, size_t count)
 		{
-			std::vector<char> file_data;
-			file_data.resize(static_cast<size_t>(file_size));
-			file.read(file_data.data(), static_cast<std::streamsize>(file_size));
-			return parse(std::string_view{ file_data.data(), file_data.size() }, std::move(file_path_str));
+			node* current = &root_;
+			for (size_t i = 0; i < count; i++)
+			{
+				const auto& component = path[i];
+				if (component.type() == path_component_type::key)
+				{
+					const auto tbl = current->as_table();
+					if (!tbl)
+						return nullptr;
+
+					current = find(*tbl, component.key());
+				}
+				else
+				{
+					// (arrays are either arrays-of-tables or have already been parsed in their entirety)
+					const auto arr = current->as_array();
+					current		   = arr ? arr->get(component.index()) : nullptr;
+				}
+
+				if (!current)
+					return nullptr;
+			}
+			return current;
 		}
 
-		// otherwise parse it using the streams
-		else
-			return parse(file, std::move(file_path_str));
+		TOML_NODISCARD
+		node* get(const toml::path& path)
+		{
+			const auto nde = find(path, path.size());
+			return nde && resolve_all(*nde) ? nde : nullptr;
+		}
 
-#undef TOML_PARSE_FILE_ERROR
-	}
+		// the string at a path, viewed straight from the document if it was skipped over and doesn't need parsing
+		// (see plain_string_contents()); nullopt if there isn't a string there (or it was malformed).
+		TOML_NODISCARD
+		optional<std::string_view> get_string(const toml::path& path)
+		{
+			node* nde = nullptr;
+			if (!path.empty() && path[path.size() - 1u].type() == path_component_type::key)
+			{
+				const auto parent = find(path, path.size() - 1u);
+				const auto tbl	  = parent ? parent->as_table() : nullptr;
+				if (!tbl)
+					return {};
+
+				const auto& key = path[path.size() - 1u].key();
+				if (const auto val = remaining_ ? values_.find(tbl == &root_ ? nullptr : tbl, key) : nullptr;
+					val && !val->source.empty())
+				{
+					if (val->type != node_type::string)
+						return {};
+					if (const auto str = plain_string_contents(val->source))
+						return str;
+				}
+				nde = find(*tbl, key);
+			}
+			else
+				nde = find(path, path.size());
+
+			if (const auto str = nde ? nde->as_string() : nullptr)
+				return std::string_view{ str->get() };
+			return {};
+		}
+	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
 }
-TOML_ANON_NAMESPACE_END;
+TOML_IMPL_NAMESPACE_END;
 
 TOML_NAMESPACE_START
 {
@@ -3861,6 +7453,88 @@ TOML_NAMESPACE_START
 		return TOML_ANON_NAMESPACE::do_parse_file(file_path);
 	}
 
+	TOML_EXTERNAL_LINKAGE
+	TOML_ANON_NAMESPACE::sax_parse_result TOML_CALLCONV parse(std::string_view doc,
+															   sax_handler & handler,
+															   std::string_view source_path)
+	{
+		return TOML_ANON_NAMESPACE::do_parse(TOML_ANON_NAMESPACE::utf8_reader{ doc, source_path }, handler);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	TOML_ANON_NAMESPACE::sax_parse_result TOML_CALLCONV parse(std::istream & doc,
+															   sax_handler & handler,
+															   std::string_view source_path)
+	{
+		return TOML_ANON_NAMESPACE::do_parse(TOML_ANON_NAMESPACE::utf8_reader{ doc, source_path }, handler);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	TOML_ANON_NAMESPACE::sax_parse_result TOML_CALLCONV parse_file(std::string_view file_path, sax_handler & handler)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_file(file_path, handler);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	parse_result TOML_CALLCONV parse(std::string_view doc, const parse_options& options, std::string_view source_path)
+	{
+#if TOML_ENABLE_THREADS
+		if (options.threads != 1u && options.keep_paths.empty())
+		{
+			if (auto tbl = TOML_ANON_NAMESPACE::parse_in_parallel(doc, source_path, options))
+				return parse_result{ std::move(*tbl) };
+		}
+#endif
+
+		return TOML_ANON_NAMESPACE::do_parse(TOML_ANON_NAMESPACE::utf8_reader{ doc, source_path }, options);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	parse_result TOML_CALLCONV parse(std::istream & doc, const parse_options& options, std::string_view source_path)
+	{
+		return TOML_ANON_NAMESPACE::do_parse(TOML_ANON_NAMESPACE::utf8_reader{ doc, source_path }, options);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	parse_result TOML_CALLCONV parse_file(std::string_view file_path, const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_file(file_path, options);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::string_view* first,
+													   const std::string_view* last,
+													   const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_many(first, static_cast<size_t>(last - first), options, nullptr);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::string_view* first,
+													   const std::string_view* last,
+													   std::vector<optional<parse_error>>& errors,
+													   const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_many(first, static_cast<size_t>(last - first), options, &errors);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::string_view* first,
+														const std::string_view* last,
+														const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_files(first, static_cast<size_t>(last - first), options, nullptr);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::string_view* first,
+														const std::string_view* last,
+														std::vector<optional<parse_error>>& errors,
+														const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_files(first, static_cast<size_t>(last - first), options, &errors);
+	}
+
 #if TOML_HAS_CHAR8
 
 	TOML_EXTERNAL_LINKAGE
@@ -3918,6 +7592,128 @@ TOML_NAMESPACE_START
 
 #endif // TOML_HAS_CHAR8 && TOML_ENABLE_WINDOWS_COMPAT
 
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser::incremental_parser(std::string_view source_path) //
+		: state_{ std::make_unique<impl::incremental_parser_state>(
+			source_path.empty() ? source_path_ptr{} : source_path_ptr{ source_path }) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser::incremental_parser(std::string && source_path) //
+		: state_{ std::make_unique<impl::incremental_parser_state>(
+			source_path.empty() ? source_path_ptr{} : source_path_ptr{ std::move(source_path) }) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser::incremental_parser(incremental_parser && other) noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser& incremental_parser::operator=(incremental_parser&& rhs) noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser::~incremental_parser() noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	void incremental_parser::feed(std::string_view chunk)
+	{
+		TOML_ASSERT_ASSUME(state_);
+		state_->feed(chunk);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	bool incremental_parser::failed() const noexcept
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->failed();
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	parse_result incremental_parser::finish()
+	{
+		TOML_ASSERT_ASSUME(state_);
+
+		// swap in a fresh state up-front so the parser is reset even if this throws
+		auto state = std::exchange(state_, std::make_unique<impl::incremental_parser_state>(state_->source_path()));
+		return state->finish();
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document::lazy_document(std::string_view doc, std::string_view source_path) //
+		: state_{ std::make_unique<impl::lazy_document_state>(doc, source_path, false) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document::lazy_document(borrow_document_t, std::string_view doc, std::string_view source_path) //
+		: state_{ std::make_unique<impl::lazy_document_state>(doc, source_path, true) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document::lazy_document(lazy_document && other) noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document& lazy_document::operator=(lazy_document&& rhs) noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document::~lazy_document() noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	bool lazy_document::failed() const noexcept
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->failed();
+	}
+
+#if !TOML_EXCEPTIONS
+
+	TOML_EXTERNAL_LINKAGE
+	const parse_error& lazy_document::error() const noexcept
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->error();
+	}
+
+#endif
+
+	TOML_EXTERNAL_LINKAGE
+	node_view<node> lazy_document::operator[](std::string_view key)
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return node_view<node>{ state_->get(key) };
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	node_view<node> lazy_document::at_path(std::string_view path)
+	{
+		return at_path(toml::path{ path });
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	node_view<node> lazy_document::at_path(const toml::path& path)
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return node_view<node>{ state_->get(path) };
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	optional<std::string_view> lazy_document::string_at(std::string_view path)
+	{
+		return string_at(toml::path{ path });
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	optional<std::string_view> lazy_document::string_at(const toml::path& path)
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->get_string(path);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	toml::table& lazy_document::table()
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->get_all();
+	}
+
 	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
 }
 TOML_NAMESPACE_END;
@@ -1068,6 +1068,93 @@
 /// \remarks	If you don't parse any TOML from files or strings, setting `TOML_ENABLE_PARSER`
 ///				to `0` can improve compilation speed and reduce binary size.
 
+// node arenas
+#if (defined(TOML_ENABLE_ARENA) && TOML_ENABLE_ARENA) || TOML_INTELLISENSE
+#undef TOML_ENABLE_ARENA
+#define TOML_ENABLE_ARENA 1
+#endif
+#ifndef TOML_ENABLE_ARENA
+#define TOML_ENABLE_ARENA 0
+#endif
+/// \def		TOML_ENABLE_ARENA
+/// \brief		Sets whether the parser can allocate documents from an arena (see toml::parse_options::use_arena).
+/// \detail		Defaults to `0`.
+/// \remarks	Telling arena allocations apart from regular ones means every allocation of a node (and of the
+///				storage of a table or array) carries an extra 8-byte header and checks for an active arena, so
+///				it's opt-in. When it's `0`, toml::parse_options::use_arena and toml::memory_resource_scope are
+///				ignored, and toml::parse_options::memory_resource isn't available at all.
+///				Tables and arrays from code built with and without it can't be mixed, so set it the same way
+///				everywhere the library is used.
+
+// source regions
+#if !defined(TOML_ENABLE_SOURCES) || (defined(TOML_ENABLE_SOURCES) && TOML_ENABLE_SOURCES) || TOML_INTELLISENSE
+#undef TOML_ENABLE_SOURCES
+#define TOML_ENABLE_SOURCES 1
+#endif
+/// \def		TOML_ENABLE_SOURCES
+/// \brief		Sets whether nodes and keys record the source regions they were parsed from.
+/// \detail		Defaults to `1`.
+/// \remarks	A toml::source_region takes up 32 bytes (on 64-bit platforms) in every node and key. Setting this to
+///				`0` leaves it out of them altogether, and their `source()` is then always empty, as if every document
+///				were parsed with toml::parse_options::omit_sources. Parse errors still report where they occurred.
+///				Nodes and keys from code built with and without it can't be mixed, so set it the same way
+///				everywhere the library is used.
+
+// flat tables
+#if defined(TOML_FLAT_TABLES) && TOML_FLAT_TABLES
+#undef TOML_FLAT_TABLES
+#define TOML_FLAT_TABLES 1
+#endif
+#ifndef TOML_FLAT_TABLES
+#define TOML_FLAT_TABLES 0
+#endif
+/// \def		TOML_FLAT_TABLES
+/// \brief		Sets whether toml::table keeps its key-value pairs in a sorted vector instead of a std::map.
+/// \detail		Defaults to `0`.
+/// \remarks	Lookups and iteration are faster (and tables smaller) with flat storage, since the keys are contiguous
+///				in memory instead of spread across a tree of separately-allocated nodes. In exchange, inserting
+///				anywhere but the end of a table costs O(n), and inserting or erasing invalidates iterators
+///				and key references (but not node references or pointers). Tables built by the parser from documents
+///				with more than a few thousand keys in one table, in random order, will take noticeably longer to
+///				build.
+
+// memory-mapped files
+#if !defined(TOML_ENABLE_MMAP) || (defined(TOML_ENABLE_MMAP) && TOML_ENABLE_MMAP) || TOML_INTELLISENSE
+#undef TOML_ENABLE_MMAP
+#define TOML_ENABLE_MMAP 1
+#endif
+/// \cond
+#if !TOML_UNIX && !TOML_WINDOWS
+#undef TOML_ENABLE_MMAP
+#define TOML_ENABLE_MMAP 0
+#endif
+/// \endcond
+/// \def		TOML_ENABLE_MMAP
+/// \brief		Sets whether toml::parse_file() memory-maps the file instead of reading it through a std::ifstream.
+/// \detail		Defaults to `1` on Unix-like platforms and Windows, `0` otherwise.
+/// \remarks	When a file can't be mapped (e.g. it's empty, or isn't a regular file) the parser silently falls back to
+///				reading it with a std::ifstream.
+/// \warning	A mapped file is read straight from the page cache while it's being parsed, so if another process
+///				truncates it mid-parse the pages past its new end disappear: on Unix-like platforms that raises
+///				`SIGBUS` (and on Windows an access violation) instead of a parse error. Set this to `0` if the files
+///				you parse may be truncated underneath you.
+
+// worker threads
+#if (defined(TOML_ENABLE_THREADS) && TOML_ENABLE_THREADS) || TOML_INTELLISENSE
+#undef TOML_ENABLE_THREADS
+#define TOML_ENABLE_THREADS 1
+#endif
+#ifndef TOML_ENABLE_THREADS
+#define TOML_ENABLE_THREADS 0
+#endif
+/// \def		TOML_ENABLE_THREADS
+/// \brief		Sets whether the parser may spread work over multiple threads (see toml::parse_options::threads).
+/// \detail		Defaults to `0`.
+/// \remarks	Parsing with threads uses `std::thread`, which on some toolchains means linking against the platform's
+///				threading library (e.g. `-pthread`), so it's opt-in. The CMake option `TOMLPLUSPLUS_ENABLE_THREADS`
+///				and the meson option `threads` set it to `1` and link against the threading library for you.
+///				When it's `0`, toml::parse_options::threads is ignored.
+
 // formatters
 #if !defined(TOML_ENABLE_FORMATTERS) || (defined(TOML_ENABLE_FORMATTERS) && TOML_ENABLE_FORMATTERS) || TOML_INTELLISENSE
 #undef TOML_ENABLE_FORMATTERS
@@ -1187,6 +1274,16 @@
 #define TOML_MAX_DOTTED_KEYS_DEPTH 1024
 #endif
 
+#ifndef TOML_PARALLEL_PARSE_MIN_BYTES
+#define TOML_PARALLEL_PARSE_MIN_BYTES 65536
+// the default for parse_options::min_bytes_per_thread.
+#endif
+
+#ifndef TOML_TABLE_INDEX_MIN_KEYS
+#define TOML_TABLE_INDEX_MIN_KEYS 1024
+// tables with at least this many keys build a hash index the first time a key is looked up (0 to never build one).
+#endif
+
 #ifdef TOML_CHAR_8_STRINGS
 #if TOML_CHAR_8_STRINGS
 #error TOML_CHAR_8_STRINGS was removed in toml++ 2.0.0; all value setters and getters now work with char8_t strings implicitly.
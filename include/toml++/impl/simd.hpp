@@ -16,6 +16,12 @@
 #define TOML_HAS_SSE4_1 1
 #endif
 
+// runtime dispatch between the scalar/SSE2/AVX2/AVX-512 kernels (x86 + x64 only)
+#if (TOML_ARCH_AMD64 || TOML_ARCH_X86) && !TOML_CUDA && !TOML_INTELLISENSE                                            \
+	&& (TOML_CLANG >= 8 || TOML_GCC >= 7 || TOML_MSVC >= 1920)
+#define TOML_HAS_SIMD_DISPATCH 1
+#endif
+
 #endif // TOML_ENABLE_SIMD
 
 #ifndef TOML_HAS_SSE2
@@ -24,12 +30,59 @@
 #ifndef TOML_HAS_SSE4_1
 #define TOML_HAS_SSE4_1 0
 #endif
-
-TOML_DISABLE_WARNINGS;
-#if TOML_HAS_SSE4_1
-#include <smmintrin.h>
-#endif
-#if TOML_HAS_SSE2
-#include <emmintrin.h>
+#ifndef TOML_HAS_SIMD_DISPATCH
+#define TOML_HAS_SIMD_DISPATCH 0
 #endif
-TOML_ENABLE_WARNINGS;
+
+#include "header_start.hpp"
+/// \cond
+
+TOML_IMPL_NAMESPACE_START
+{
+	enum class simd_level : unsigned char
+	{
+		scalar,
+		sse2,
+		avx2,
+		avx512bw
+	};
+
+	// the bulk scanning kernels used by the parser.
+	// all of the 'find' kernels take a [begin, end) range and return a pointer to the first matching byte (or end).
+	struct simd_kernels
+	{
+		simd_level level;
+
+		// true if every byte in the range is < 0x80
+		bool (*is_ascii)(const char*, size_t) noexcept;
+
+		// first byte of the first invalid or truncated utf-8 sequence
+		const char* (*find_invalid_utf8)(const char*, const char*) noexcept;
+
+		// first byte that isn't a space or tab
+		const char* (*find_non_whitespace)(const char*, const char*) noexcept;
+
+		// first byte that ends a comment: a control character other than tab (which includes line breaks)
+		const char* (*find_comment_terminator)(const char*, const char*) noexcept;
+
+		// first byte that needs special handling in a string body:
+		// the delimiter, the escape character, or a control character other than tab
+		const char* (*find_string_terminator)(const char*, const char*, char delimiter, char escape) noexcept;
+	};
+
+	// the kernels for a particular level, or nullptr if the build or host machine doesn't support it
+	TOML_NODISCARD
+	const simd_kernels* get_simd_kernels(simd_level level) noexcept;
+
+	// the kernels currently used by the parser (defaults to the best level supported by the host machine)
+	TOML_NODISCARD
+	const simd_kernels& simd() noexcept;
+
+	// changes the kernels used by the parser; returns false if the level isn't supported.
+	// intended for testing and benchmarking.
+	bool set_simd_level(simd_level level) noexcept;
+}
+TOML_IMPL_NAMESPACE_END;
+
+/// \endcond
+#include "header_end.hpp"
@@ -0,0 +1,809 @@
+//# This file is a part of toml++ and is subject to the the terms of the MIT license.
+//# Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+//# See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+//# {{
+#include "preprocessor.hpp"
+#if !TOML_IMPLEMENTATION
+#error This is an implementation-only header.
+#endif
+//# }}
+
+#include "simd.hpp"
+#include "unicode.hpp"
+TOML_DISABLE_WARNINGS;
+#include <atomic>
+#include <cstring>
+#if TOML_HAS_SSE2 || TOML_HAS_SIMD_DISPATCH
+#include <emmintrin.h>
+#endif
+#if TOML_HAS_SIMD_DISPATCH
+#include <immintrin.h>
+#if TOML_MSVC
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+TOML_ENABLE_WARNINGS;
+#include "header_start.hpp"
+
+// the vector kernels are compiled for their target instruction set regardless of the flags used for the
+// rest of the library, and are only ever called once cpuid says the host machine supports them.
+#if TOML_HAS_SIMD_DISPATCH && TOML_GCC_LIKE
+#define TOML_SIMD_TARGET(...) TOML_ATTR(target(__VA_ARGS__))
+#else
+#define TOML_SIMD_TARGET(...)
+#endif
+
+#if TOML_HAS_SSE2 || TOML_HAS_SIMD_DISPATCH
+#define TOML_SIMD_SSE2 1
+#else
+#define TOML_SIMD_SSE2 0
+#endif
+
+#if TOML_HAS_SIMD_DISPATCH && TOML_ARCH_AMD64
+#define TOML_SIMD_AVX512BW 1
+#else
+#define TOML_SIMD_AVX512BW 0
+#endif
+
+TOML_ANON_NAMESPACE_START
+{
+	TOML_CONST_INLINE_GETTER
+	constexpr bool is_simd_control_character(unsigned char c) noexcept
+	{
+		return (c < 0x20u && c != 0x09u) || c == 0x7Fu;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	// scalar
+	//------------------------------------------------------------------------------------------------------------------
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_ascii_scalar(const char* str, size_t len) noexcept
+	{
+		const char* const end = str + len;
+
+		for (; end - str >= 8; str += 8)
+		{
+			uint64_t chunk;
+			std::memcpy(&chunk, str, sizeof(chunk));
+			if (chunk & 0x8080808080808080ull)
+				return false;
+		}
+
+		for (; str < end; str++)
+			if (static_cast<unsigned char>(*str) > 127u)
+				return false;
+
+		return true;
+	}
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_invalid_utf8_scalar(const char* begin, const char* end) noexcept
+	{
+		impl::utf8_decoder decoder;
+		const char* seq = begin;
+		for (const char* c = begin; c < end; c++)
+		{
+			if (decoder.has_code_point())
+			{
+				// skip over runs of ascii eight bytes at a time
+				while (end - c >= 8 && is_ascii_scalar(c, 8u))
+					c += 8;
+				if (c == end)
+					break;
+				seq = c;
+			}
+
+			decoder(*c);
+			if (decoder.error())
+				return seq;
+		}
+		return decoder.has_code_point() ? end : seq;
+	}
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_non_whitespace_scalar(const char* begin, const char* end) noexcept
+	{
+		while (begin < end && (*begin == ' ' || *begin == '\t'))
+			begin++;
+		return begin;
+	}
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_comment_terminator_scalar(const char* begin, const char* end) noexcept
+	{
+		while (begin < end && !is_simd_control_character(static_cast<unsigned char>(*begin)))
+			begin++;
+		return begin;
+	}
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_string_terminator_scalar(const char* begin,
+											  const char* end,
+											  char delimiter,
+											  char escape) noexcept
+	{
+		while (begin < end && *begin != delimiter && *begin != escape
+			   && !is_simd_control_character(static_cast<unsigned char>(*begin)))
+			begin++;
+		return begin;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	// SSE2 (16 bytes at a time)
+	//------------------------------------------------------------------------------------------------------------------
+
+#if TOML_SIMD_SSE2
+
+	TOML_CONST_INLINE_GETTER
+	unsigned simd_first_set_bit(uint32_t mask) noexcept
+	{
+		TOML_ASSERT_ASSUME(mask);
+#if TOML_MSVC
+		unsigned long idx;
+		_BitScanForward(&idx, mask);
+		return static_cast<unsigned>(idx);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+
+	TOML_SIMD_TARGET("sse2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_ascii_sse2(const char* str, size_t len) noexcept
+	{
+		const char* const end = str + len;
+
+		__m128i acc = _mm_setzero_si128();
+		for (; end - str >= 16; str += 16)
+			acc = _mm_or_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(str)));
+		if (_mm_movemask_epi8(acc))
+			return false;
+
+		return is_ascii_scalar(str, static_cast<size_t>(end - str));
+	}
+
+	TOML_SIMD_TARGET("sse2")
+	TOML_ALWAYS_INLINE
+	__m128i control_characters_sse2(__m128i v) noexcept
+	{
+		// unsigned v <= 0x1F, minus tabs, plus DEL
+		const __m128i low = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v);
+		return _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')), low),
+							_mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F)));
+	}
+
+	TOML_SIMD_TARGET("sse2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_non_whitespace_sse2(const char* begin, const char* end) noexcept
+	{
+		const __m128i space = _mm_set1_epi8(' ');
+		const __m128i tab	= _mm_set1_epi8('\t');
+		for (; end - begin >= 16; begin += 16)
+		{
+			const __m128i v	 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			const __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab));
+			if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(ws)) ^ 0xFFFFu)
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_non_whitespace_scalar(begin, end);
+	}
+
+	TOML_SIMD_TARGET("sse2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_comment_terminator_sse2(const char* begin, const char* end) noexcept
+	{
+		for (; end - begin >= 16; begin += 16)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(control_characters_sse2(v))))
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_comment_terminator_scalar(begin, end);
+	}
+
+	TOML_SIMD_TARGET("sse2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_string_terminator_sse2(const char* begin, const char* end, char delimiter, char escape) noexcept
+	{
+		const __m128i delim = _mm_set1_epi8(delimiter);
+		const __m128i esc	= _mm_set1_epi8(escape);
+		for (; end - begin >= 16; begin += 16)
+		{
+			const __m128i v		= _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			const __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, delim), _mm_cmpeq_epi8(v, esc)),
+											   control_characters_sse2(v));
+			if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(found)))
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_string_terminator_scalar(begin, end, delimiter, escape);
+	}
+
+#endif // TOML_SIMD_SSE2
+
+	//------------------------------------------------------------------------------------------------------------------
+	// AVX2 (32 bytes at a time)
+	//------------------------------------------------------------------------------------------------------------------
+
+#if TOML_HAS_SIMD_DISPATCH
+
+	// steps back from a block boundary to the start of the utf-8 sequence straddling it (if any).
+	// the vector validators only know that a block contains an error, so they use this to hand the scalar kernel
+	// a starting point from which it can find exactly where it is.
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* utf8_sequence_start(const char* begin, const char* pos) noexcept
+	{
+		for (size_t i = 0; i < 3u && pos > begin && (static_cast<unsigned char>(pos[-1]) & 0xC0u) == 0x80u; i++)
+			pos--;
+		if (pos > begin && static_cast<unsigned char>(pos[-1]) >= 0xC0u)
+			pos--;
+		return pos;
+	}
+
+	// lookup tables for the vectorized utf-8 validators, per "Validating UTF-8 In Less Than One Instruction Per Byte"
+	// (Keiser & Lemire). each byte is classified three ways (high nibble of the previous byte, low nibble of the
+	// previous byte, high nibble of itself); ANDing the three gives the error(s) that pair of bytes represents.
+	struct utf8_lookup
+	{
+		static constexpr uint8_t too_short		= 1u << 0; // 11______ 0_______, 11______ 11______
+		static constexpr uint8_t too_long		= 1u << 1; // 0_______ 10______
+		static constexpr uint8_t overlong_3		= 1u << 2; // 11100000 100_____
+		static constexpr uint8_t too_large		= 1u << 3; // 11110100 1001____ (and above)
+		static constexpr uint8_t surrogate		= 1u << 4; // 11101101 101_____
+		static constexpr uint8_t overlong_2		= 1u << 5; // 1100000_ 10______
+		static constexpr uint8_t too_large_1000 = 1u << 6; // 11110101 1000____ (and above)
+		static constexpr uint8_t overlong_4		= 1u << 6; // 11110000 1000____
+		static constexpr uint8_t two_conts		= 1u << 7; // 10______ 10______
+		static constexpr uint8_t carry			= too_short | too_long | two_conts;
+
+		alignas(16) static constexpr uint8_t byte_1_high[16]{
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			two_conts,
+			two_conts,
+			two_conts,
+			two_conts,
+			too_short | overlong_2,
+			too_short,
+			too_short | overlong_3 | surrogate,
+			too_short | too_large | too_large_1000 | overlong_4,
+		};
+
+		alignas(16) static constexpr uint8_t byte_1_low[16]{
+			carry | overlong_3 | overlong_2 | overlong_4,
+			carry | overlong_2,
+			carry,
+			carry,
+			carry | too_large,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000 | surrogate,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+		};
+
+		alignas(16) static constexpr uint8_t byte_2_high[16]{
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+			too_long | overlong_2 | two_conts | overlong_3 | too_large,
+			too_long | overlong_2 | two_conts | surrogate | too_large,
+			too_long | overlong_2 | two_conts | surrogate | too_large,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+		};
+	};
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_ascii_avx2(const char* str, size_t len) noexcept
+	{
+		const char* const end = str + len;
+
+		__m256i acc = _mm256_setzero_si256();
+		for (; end - str >= 32; str += 32)
+			acc = _mm256_or_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str)));
+		if (_mm256_movemask_epi8(acc))
+			return false;
+
+		return is_ascii_sse2(str, static_cast<size_t>(end - str));
+	}
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_ALWAYS_INLINE
+	__m256i control_characters_avx2(__m256i v) noexcept
+	{
+		const __m256i low = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v);
+		return _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')), low),
+							   _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7F)));
+	}
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_non_whitespace_avx2(const char* begin, const char* end) noexcept
+	{
+		const __m256i space = _mm256_set1_epi8(' ');
+		const __m256i tab	= _mm256_set1_epi8('\t');
+		for (; end - begin >= 32; begin += 32)
+		{
+			const __m256i v	 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+			const __m256i ws = _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab));
+			if (const auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(ws)))
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_non_whitespace_sse2(begin, end);
+	}
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_comment_terminator_avx2(const char* begin, const char* end) noexcept
+	{
+		for (; end - begin >= 32; begin += 32)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+			if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(control_characters_avx2(v))))
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_comment_terminator_sse2(begin, end);
+	}
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_string_terminator_avx2(const char* begin, const char* end, char delimiter, char escape) noexcept
+	{
+		const __m256i delim = _mm256_set1_epi8(delimiter);
+		const __m256i esc	= _mm256_set1_epi8(escape);
+		for (; end - begin >= 32; begin += 32)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+			const __m256i found =
+				_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, delim), _mm256_cmpeq_epi8(v, esc)),
+								control_characters_avx2(v));
+			if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(found)))
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_string_terminator_sse2(begin, end, delimiter, escape);
+	}
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_ALWAYS_INLINE
+	__m256i utf8_lookup_avx2(const uint8_t (&table)[16], __m256i nibbles) noexcept
+	{
+		return _mm256_shuffle_epi8(
+			_mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table))),
+			nibbles);
+	}
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_ALWAYS_INLINE
+	__m256i utf8_errors_avx2(__m256i input, __m256i prev_input) noexcept
+	{
+		// the last lane of the previous block followed by the first lane of this one
+		const __m256i straddle = _mm256_permute2x128_si256(prev_input, input, 0x21);
+		const __m256i prev1	   = _mm256_alignr_epi8(input, straddle, 15);
+		const __m256i prev2	   = _mm256_alignr_epi8(input, straddle, 14);
+		const __m256i prev3	   = _mm256_alignr_epi8(input, straddle, 13);
+
+		const __m256i nibble  = _mm256_set1_epi8(0x0F);
+		const __m256i special = _mm256_and_si256(
+			_mm256_and_si256(
+				utf8_lookup_avx2(utf8_lookup::byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+				utf8_lookup_avx2(utf8_lookup::byte_1_low, _mm256_and_si256(prev1, nibble))),
+			utf8_lookup_avx2(utf8_lookup::byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+		// the third and fourth bytes of three- and four-byte sequences are the only places two continuations in a
+		// row are allowed
+		const __m256i third_or_fourth =
+			_mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80)),
+							_mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80)));
+		return _mm256_xor_si256(_mm256_and_si256(third_or_fourth, _mm256_set1_epi8(static_cast<char>(0x80u))),
+								special);
+	}
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_invalid_utf8_avx2(const char* begin, const char* end) noexcept
+	{
+		const char* pos	   = begin;
+		__m256i prev_input = _mm256_setzero_si256();
+		bool prev_ascii	   = true;
+		for (; end - pos >= 32; pos += 32)
+		{
+			const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+			const bool ascii	= !_mm256_movemask_epi8(input);
+			if (!ascii || !prev_ascii)
+			{
+				const __m256i errors = utf8_errors_avx2(input, prev_input);
+				if (!_mm256_testz_si256(errors, errors))
+					break;
+			}
+			prev_input = input;
+			prev_ascii = ascii;
+		}
+
+		// the scalar kernel takes care of the tail, and pinpoints the error if there was one
+		return find_invalid_utf8_scalar(utf8_sequence_start(begin, pos), end);
+	}
+
+#endif // TOML_HAS_SIMD_DISPATCH
+
+	//------------------------------------------------------------------------------------------------------------------
+	// AVX-512BW (64 bytes at a time)
+	//------------------------------------------------------------------------------------------------------------------
+
+#if TOML_SIMD_AVX512BW
+
+	TOML_CONST_INLINE_GETTER
+	unsigned simd_first_set_bit(uint64_t mask) noexcept
+	{
+		TOML_ASSERT_ASSUME(mask);
+#if TOML_MSVC
+		unsigned long idx;
+		_BitScanForward64(&idx, mask);
+		return static_cast<unsigned>(idx);
+#else
+		return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+	}
+
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_ascii_avx512bw(const char* str, size_t len) noexcept
+	{
+		const char* const end = str + len;
+
+		__m512i acc = _mm512_setzero_si512();
+		for (; end - str >= 64; str += 64)
+			acc = _mm512_or_si512(acc, _mm512_loadu_si512(str));
+		if (_mm512_movepi8_mask(acc))
+			return false;
+
+		return is_ascii_avx2(str, static_cast<size_t>(end - str));
+	}
+
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_ALWAYS_INLINE
+	uint64_t control_characters_avx512bw(__m512i v) noexcept
+	{
+		const __mmask64 low = _mm512_mask_cmple_epu8_mask(_mm512_cmpneq_epi8_mask(v, _mm512_set1_epi8('\t')),
+														   v,
+														   _mm512_set1_epi8(0x1F));
+		return static_cast<uint64_t>(low | _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(0x7F)));
+	}
+
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_non_whitespace_avx512bw(const char* begin, const char* end) noexcept
+	{
+		const __m512i space = _mm512_set1_epi8(' ');
+		const __m512i tab	= _mm512_set1_epi8('\t');
+		for (; end - begin >= 64; begin += 64)
+		{
+			const __m512i v = _mm512_loadu_si512(begin);
+			const auto mask = _mm512_mask_cmpneq_epi8_mask(_mm512_cmpneq_epi8_mask(v, space), v, tab);
+			if (mask)
+				return begin + simd_first_set_bit(static_cast<uint64_t>(mask));
+		}
+		return find_non_whitespace_avx2(begin, end);
+	}
+
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_comment_terminator_avx512bw(const char* begin, const char* end) noexcept
+	{
+		for (; end - begin >= 64; begin += 64)
+		{
+			if (const auto mask = control_characters_avx512bw(_mm512_loadu_si512(begin)))
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_comment_terminator_avx2(begin, end);
+	}
+
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_string_terminator_avx512bw(const char* begin,
+												const char* end,
+												char delimiter,
+												char escape) noexcept
+	{
+		const __m512i delim = _mm512_set1_epi8(delimiter);
+		const __m512i esc	= _mm512_set1_epi8(escape);
+		for (; end - begin >= 64; begin += 64)
+		{
+			const __m512i v = _mm512_loadu_si512(begin);
+			const auto mask = static_cast<uint64_t>(_mm512_cmpeq_epi8_mask(v, delim) | _mm512_cmpeq_epi8_mask(v, esc))
+							| control_characters_avx512bw(v);
+			if (mask)
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_string_terminator_avx2(begin, end, delimiter, escape);
+	}
+
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_ALWAYS_INLINE
+	__m512i utf8_lookup_avx512bw(const uint8_t (&table)[16], __m512i nibbles) noexcept
+	{
+		return _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_load_si128(reinterpret_cast<const __m128i*>(table))),
+								   nibbles);
+	}
+
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_ALWAYS_INLINE
+	__m512i utf8_errors_avx512bw(__m512i input, __m512i prev_input) noexcept
+	{
+		// each lane of this block shifted up one, with the last lane of the previous block in the bottom
+		const __m512i straddle =
+			_mm512_permutex2var_epi64(input, _mm512_set_epi64(5, 4, 3, 2, 1, 0, 15, 14), prev_input);
+		const __m512i prev1 = _mm512_alignr_epi8(input, straddle, 15);
+		const __m512i prev2 = _mm512_alignr_epi8(input, straddle, 14);
+		const __m512i prev3 = _mm512_alignr_epi8(input, straddle, 13);
+
+		const __m512i nibble  = _mm512_set1_epi8(0x0F);
+		const __m512i special = _mm512_and_si512(
+			_mm512_and_si512(
+				utf8_lookup_avx512bw(utf8_lookup::byte_1_high, _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble)),
+				utf8_lookup_avx512bw(utf8_lookup::byte_1_low, _mm512_and_si512(prev1, nibble))),
+			utf8_lookup_avx512bw(utf8_lookup::byte_2_high, _mm512_and_si512(_mm512_srli_epi16(input, 4), nibble)));
+
+		const __m512i third_or_fourth =
+			_mm512_or_si512(_mm512_subs_epu8(prev2, _mm512_set1_epi8(0xE0 - 0x80)),
+							_mm512_subs_epu8(prev3, _mm512_set1_epi8(0xF0 - 0x80)));
+		return _mm512_xor_si512(_mm512_and_si512(third_or_fourth, _mm512_set1_epi8(static_cast<char>(0x80u))),
+								special);
+	}
+
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_invalid_utf8_avx512bw(const char* begin, const char* end) noexcept
+	{
+		const char* pos	   = begin;
+		__m512i prev_input = _mm512_setzero_si512();
+		bool prev_ascii	   = true;
+		for (; end - pos >= 64; pos += 64)
+		{
+			const __m512i input = _mm512_loadu_si512(pos);
+			const bool ascii	= !_mm512_movepi8_mask(input);
+			if (!ascii || !prev_ascii)
+			{
+				const __m512i errors = utf8_errors_avx512bw(input, prev_input);
+				if (_mm512_test_epi8_mask(errors, errors))
+					break;
+			}
+			prev_input = input;
+			prev_ascii = ascii;
+		}
+
+		return find_invalid_utf8_avx2(utf8_sequence_start(begin, pos), end);
+	}
+
+#endif // TOML_SIMD_AVX512BW
+
+	//------------------------------------------------------------------------------------------------------------------
+	// dispatch
+	//------------------------------------------------------------------------------------------------------------------
+
+	TOML_INTERNAL_LINKAGE
+	constexpr impl::simd_kernels simd_kernels_scalar{ impl::simd_level::scalar,
+													  is_ascii_scalar,
+													  find_invalid_utf8_scalar,
+													  find_non_whitespace_scalar,
+													  find_comment_terminator_scalar,
+													  find_string_terminator_scalar };
+
+#if TOML_SIMD_SSE2
+	TOML_INTERNAL_LINKAGE
+	constexpr impl::simd_kernels simd_kernels_sse2{ impl::simd_level::sse2,
+													is_ascii_sse2,
+													find_invalid_utf8_scalar,
+													find_non_whitespace_sse2,
+													find_comment_terminator_sse2,
+													find_string_terminator_sse2 };
+#endif
+
+#if TOML_HAS_SIMD_DISPATCH
+	TOML_INTERNAL_LINKAGE
+	constexpr impl::simd_kernels simd_kernels_avx2{ impl::simd_level::avx2,
+													is_ascii_avx2,
+													find_invalid_utf8_avx2,
+													find_non_whitespace_avx2,
+													find_comment_terminator_avx2,
+													find_string_terminator_avx2 };
+#endif
+
+#if TOML_SIMD_AVX512BW
+	TOML_INTERNAL_LINKAGE
+	constexpr impl::simd_kernels simd_kernels_avx512bw{ impl::simd_level::avx512bw,
+														is_ascii_avx512bw,
+														find_invalid_utf8_avx512bw,
+														find_non_whitespace_avx512bw,
+														find_comment_terminator_avx512bw,
+														find_string_terminator_avx512bw };
+#endif
+
+#if TOML_HAS_SIMD_DISPATCH
+
+	TOML_INTERNAL_LINKAGE
+	void simd_cpuid(unsigned leaf, unsigned subleaf, unsigned (&regs)[4]) noexcept
+	{
+#if TOML_MSVC
+		int out[4];
+		__cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+		for (size_t i = 0; i < 4u; i++)
+			regs[i] = static_cast<unsigned>(out[i]);
+#else
+		__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+	}
+
+	TOML_INTERNAL_LINKAGE
+	uint64_t simd_xgetbv() noexcept
+	{
+#if TOML_MSVC
+		return static_cast<uint64_t>(_xgetbv(0));
+#else
+		unsigned eax, edx;
+		__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0u));
+		return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+	}
+
+#endif // TOML_HAS_SIMD_DISPATCH
+
+	TOML_INTERNAL_LINKAGE
+	impl::simd_level detect_simd_level() noexcept
+	{
+#if TOML_HAS_SIMD_DISPATCH
+
+		unsigned regs[4]{};
+		simd_cpuid(0u, 0u, regs);
+		const unsigned max_leaf = regs[0];
+		if (max_leaf < 1u)
+			return impl::simd_level::scalar;
+
+		simd_cpuid(1u, 0u, regs);
+		const bool sse2	   = (regs[3] & (1u << 26)) != 0u;
+		const bool osxsave = (regs[2] & (1u << 27)) != 0u;
+		const bool avx	   = (regs[2] & (1u << 28)) != 0u;
+		if (!sse2)
+			return impl::simd_level::scalar;
+		if (!osxsave || !avx || max_leaf < 7u)
+			return impl::simd_level::sse2;
+
+		// the OS has to be saving the wider registers on context switches, too
+		const uint64_t xcr0 = simd_xgetbv();
+		if ((xcr0 & 0x6u) != 0x6u) // XMM + YMM
+			return impl::simd_level::sse2;
+
+		simd_cpuid(7u, 0u, regs);
+		const bool avx2		= (regs[1] & (1u << 5)) != 0u;
+		const bool avx512f	= (regs[1] & (1u << 16)) != 0u;
+		const bool avx512bw = (regs[1] & (1u << 30)) != 0u;
+		if (!avx2)
+			return impl::simd_level::sse2;
+
+#if TOML_SIMD_AVX512BW
+		if (avx512f && avx512bw && (xcr0 & 0xE6u) == 0xE6u) // + opmask, ZMM0-15, ZMM16-31
+			return impl::simd_level::avx512bw;
+#else
+		static_cast<void>(avx512f);
+		static_cast<void>(avx512bw);
+#endif
+
+		return impl::simd_level::avx2;
+
+#elif TOML_SIMD_SSE2
+		return impl::simd_level::sse2;
+#else
+		return impl::simd_level::scalar;
+#endif
+	}
+
+	TOML_INTERNAL_LINKAGE
+	impl::simd_level max_simd_level() noexcept
+	{
+		static const impl::simd_level level = detect_simd_level();
+		return level;
+	}
+
+	TOML_INTERNAL_LINKAGE
+	std::atomic<const impl::simd_kernels*>& active_simd_kernels() noexcept
+	{
+		static std::atomic<const impl::simd_kernels*> kernels{ impl::get_simd_kernels(max_simd_level()) };
+		return kernels;
+	}
+}
+TOML_ANON_NAMESPACE_END;
+
+TOML_IMPL_NAMESPACE_START
+{
+	TOML_EXTERNAL_LINKAGE
+	const simd_kernels* get_simd_kernels(simd_level level) noexcept
+	{
+		if (level > TOML_ANON_NAMESPACE::max_simd_level())
+			return nullptr;
+
+		switch (level)
+		{
+			case simd_level::scalar: return &TOML_ANON_NAMESPACE::simd_kernels_scalar;
+#if TOML_SIMD_SSE2
+			case simd_level::sse2: return &TOML_ANON_NAMESPACE::simd_kernels_sse2;
+#endif
+#if TOML_HAS_SIMD_DISPATCH
+			case simd_level::avx2: return &TOML_ANON_NAMESPACE::simd_kernels_avx2;
+#endif
+#if TOML_SIMD_AVX512BW
+			case simd_level::avx512bw: return &TOML_ANON_NAMESPACE::simd_kernels_avx512bw;
+#endif
+			default: return nullptr;
+		}
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	const simd_kernels& simd() noexcept
+	{
+		return *TOML_ANON_NAMESPACE::active_simd_kernels().load(std::memory_order_relaxed);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	bool set_simd_level(simd_level level) noexcept
+	{
+		const auto kernels = get_simd_kernels(level);
+		if (!kernels)
+			return false;
+
+		TOML_ANON_NAMESPACE::active_simd_kernels().store(kernels, std::memory_order_relaxed);
+		return true;
+	}
+}
+TOML_IMPL_NAMESPACE_END;
+
+#undef TOML_SIMD_TARGET
+#undef TOML_SIMD_SSE2
+#undef TOML_SIMD_AVX512BW
+
+#include "header_end.hpp"
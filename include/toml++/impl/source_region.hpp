@@ -10,13 +10,217 @@
 #include "print_to_stream.hpp"
 #include "header_start.hpp"
 
+/// \cond
+TOML_IMPL_NAMESPACE_START
+{
+	// the path of a parsed document, along with a way for the pointers borrowing it to take a reference to it
+	// (see source_path_ptr)
+	struct source_path_block : std::enable_shared_from_this<source_path_block>
+	{
+		std::string path;
+
+		TOML_NODISCARD_CTOR
+		explicit source_path_block(std::string_view p) //
+			: path{ p }
+		{}
+
+		TOML_NODISCARD_CTOR
+		explicit source_path_block(std::string&& p) noexcept //
+			: path{ std::move(p) }
+		{}
+	};
+
+	struct borrow_source_path_t
+	{};
+}
+TOML_IMPL_NAMESPACE_END;
+/// \endcond
+
 TOML_NAMESPACE_START
 {
 	/// \brief	The integer type used to tally line numbers and columns.
 	using source_index = uint32_t;
 
 	/// \brief	A pointer to a shared string resource containing a source path.
-	using source_path_ptr = std::shared_ptr<const std::string>;
+	///
+	/// \detail Works like a `std::shared_ptr<const std::string>`, and converts to and from one (though converting
+	///			from one copies the string; see the constructor).
+	///
+	/// \remarks A parsed document stores its path once, and the nodes and keys in it point at that without
+	///			touching its reference count. Copying one of those pointers (or moving a node out of its document)
+	///			takes a counted reference again, so a path is always kept alive by anything that can still reach it.
+	class source_path_ptr
+	{
+	  private:
+		// (without a control block when it's borrowed from a document)
+		std::shared_ptr<const impl::source_path_block> ptr_;
+
+		TOML_NODISCARD
+		std::shared_ptr<const impl::source_path_block> acquire() const noexcept
+		{
+			if (!ptr_ || ptr_.use_count())
+				return ptr_;
+			return ptr_->weak_from_this().lock();
+		}
+
+	  public:
+		/// \brief	Creates a null pointer.
+		TOML_NODISCARD_CTOR
+		source_path_ptr() noexcept = default;
+
+		/// \brief	Creates a null pointer.
+		TOML_NODISCARD_CTOR
+		source_path_ptr(std::nullptr_t) noexcept
+		{}
+
+		/// \brief	Creates a pointer to a copy of a path.
+		TOML_NODISCARD_CTOR
+		explicit source_path_ptr(std::string_view path) //
+			: ptr_{ std::make_shared<impl::source_path_block>(path) }
+		{}
+
+		/// \brief	Creates a pointer to a copy of a path.
+		TOML_NODISCARD_CTOR
+		explicit source_path_ptr(const char* path) //
+			: source_path_ptr{ std::string_view{ path } }
+		{}
+
+		/// \brief	Creates a pointer to a path, taking ownership of the string.
+		TOML_NODISCARD_CTOR
+		explicit source_path_ptr(std::string&& path) //
+			: ptr_{ std::make_shared<impl::source_path_block>(std::move(path)) }
+		{}
+
+		/// \brief	Creates a pointer to a copy of the path a `std::shared_ptr` points to (or a null pointer).
+		///
+		/// \warning This allocates a new copy of the string rather than sharing the original, so the result doesn't
+		///			point at the same `std::string` (and converting it back gives a different `std::shared_ptr`).
+		///			Convert a path once and copy the source_path_ptr, rather than converting it over and over.
+		template <typename T,
+				  typename = std::enable_if_t<std::is_convertible_v<T*, const std::string*>>>
+		TOML_NODISCARD_CTOR
+		/*implicit*/ source_path_ptr(const std::shared_ptr<T>& path)
+		{
+			if (path)
+				ptr_ = std::make_shared<impl::source_path_block>(*path);
+		}
+
+		/// \cond
+
+		// a pointer to the same path that doesn't own it; only for things kept alive by something that does
+		TOML_NODISCARD_CTOR
+		source_path_ptr(impl::borrow_source_path_t, const source_path_ptr& owner) noexcept //
+			: ptr_{ std::shared_ptr<const impl::source_path_block>{}, owner.ptr_.get() }
+		{}
+
+		/// \endcond
+
+		/// \brief	Copy constructor.
+		TOML_NODISCARD_CTOR
+		source_path_ptr(const source_path_ptr& other) noexcept //
+			: ptr_{ other.acquire() }
+		{}
+
+		/// \brief	Move constructor.
+		TOML_NODISCARD_CTOR
+		source_path_ptr(source_path_ptr&&) noexcept = default;
+
+		/// \brief	Copy-assignment operator.
+		source_path_ptr& operator=(const source_path_ptr& rhs) noexcept
+		{
+			if (&rhs != this)
+				ptr_ = rhs.acquire();
+			return *this;
+		}
+
+		/// \brief	Move-assignment operator.
+		source_path_ptr& operator=(source_path_ptr&&) noexcept = default;
+
+		/// \brief	Returns a pointer to the path (or nullptr).
+		TOML_PURE_INLINE_GETTER
+		const std::string* get() const noexcept
+		{
+			return ptr_ ? &ptr_->path : nullptr;
+		}
+
+		/// \brief	Returns a reference to the path.
+		TOML_PURE_INLINE_GETTER
+		const std::string& operator*() const noexcept
+		{
+			TOML_ASSERT_ASSUME(ptr_);
+			return ptr_->path;
+		}
+
+		/// \brief	Returns a pointer to the path.
+		TOML_PURE_INLINE_GETTER
+		const std::string* operator->() const noexcept
+		{
+			TOML_ASSERT_ASSUME(ptr_);
+			return &ptr_->path;
+		}
+
+		/// \brief	Returns true if there's a path.
+		TOML_PURE_INLINE_GETTER
+		explicit operator bool() const noexcept
+		{
+			return !!ptr_;
+		}
+
+		/// \brief	Returns the number of pointers keeping the path alive (which doesn't include the ones in the
+		///			nodes and keys of a parsed document).
+		TOML_NODISCARD
+		long use_count() const noexcept
+		{
+			if (!ptr_ || ptr_.use_count())
+				return ptr_.use_count();
+			return ptr_->weak_from_this().use_count();
+		}
+
+		/// \brief	Returns a `std::shared_ptr` to the path (or an empty one).
+		TOML_NODISCARD
+		/*implicit*/ operator std::shared_ptr<const std::string>() const noexcept
+		{
+			auto ptr = acquire();
+			if (!ptr)
+				return {};
+			const auto path = &ptr->path;
+			return { std::move(ptr), path };
+		}
+
+		/// \brief	Resets the pointer to null.
+		void reset() noexcept
+		{
+			ptr_.reset();
+		}
+
+		/// \brief	Returns true if two pointers point at the same path.
+		TOML_PURE_INLINE_GETTER
+		friend bool operator==(const source_path_ptr& lhs, const source_path_ptr& rhs) noexcept
+		{
+			return lhs.ptr_ == rhs.ptr_;
+		}
+
+		/// \brief	Returns true if two pointers don't point at the same path.
+		TOML_PURE_INLINE_GETTER
+		friend bool operator!=(const source_path_ptr& lhs, const source_path_ptr& rhs) noexcept
+		{
+			return lhs.ptr_ != rhs.ptr_;
+		}
+
+		/// \brief	Returns true if a pointer is null.
+		TOML_PURE_INLINE_GETTER
+		friend bool operator==(const source_path_ptr& lhs, std::nullptr_t) noexcept
+		{
+			return !lhs.ptr_;
+		}
+
+		/// \brief	Returns true if a pointer isn't null.
+		TOML_PURE_INLINE_GETTER
+		friend bool operator!=(const source_path_ptr& lhs, std::nullptr_t) noexcept
+		{
+			return !!lhs.ptr_;
+		}
+	};
 
 	/// \brief	A source document line-and-column pair.
 	///
@@ -293,4 +497,22 @@ TOML_NAMESPACE_START
 }
 TOML_NAMESPACE_END;
 
+#if !TOML_ENABLE_SOURCES
+
+/// \cond
+TOML_IMPL_NAMESPACE_START
+{
+	// the source() of every node and key when they don't record one (see TOML_ENABLE_SOURCES)
+	TOML_NODISCARD
+	inline const source_region& empty_source_region() noexcept
+	{
+		static const source_region region{};
+		return region;
+	}
+}
+TOML_IMPL_NAMESPACE_END;
+/// \endcond
+
+#endif
+
 #include "header_end.hpp"
@@ -0,0 +1,18 @@
+//# This file is a part of toml++ and is subject to the the terms of the MIT license.
+//# Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+//# See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "preprocessor.hpp"
+TOML_DISABLE_WARNINGS;
+#if TOML_HAS_INCLUDE(<memory_resource>)
+#include <memory_resource>
+#endif
+TOML_ENABLE_WARNINGS;
+
+#if TOML_DOXYGEN || (defined(__cpp_lib_memory_resource) && __cpp_lib_memory_resource >= 201603)
+#define TOML_HAS_MEMORY_RESOURCE 1
+#else
+#define TOML_HAS_MEMORY_RESOURCE 0
+#endif
@@ -6,6 +6,8 @@
 
 #include "forward_declarations.hpp"
 #include "std_map.hpp"
+#include "std_atomic.hpp"
+#include "flat_map.hpp"
 #include "std_initializer_list.hpp"
 #include "array.hpp"
 #include "make_node.hpp"
@@ -16,6 +18,14 @@
 /// \cond
 TOML_IMPL_NAMESPACE_START
 {
+#if TOML_FLAT_TABLES
+	using table_map = flat_map<toml::key, node_ptr, node_allocator<std::pair<toml::key, node_ptr>>>;
+#else
+	using table_map = std::map<toml::key, node_ptr, std::less<>, node_allocator<std::pair<const toml::key, node_ptr>>>;
+#endif
+
+	class table_index;
+
 	template <bool IsConst>
 	struct table_proxy_pair
 	{
@@ -33,8 +43,8 @@ TOML_IMPL_NAMESPACE_START
 		friend class table_iterator;
 
 		using proxy_type		   = table_proxy_pair<IsConst>;
-		using mutable_map_iterator = std::map<toml::key, node_ptr, std::less<>>::iterator;
-		using const_map_iterator   = std::map<toml::key, node_ptr, std::less<>>::const_iterator;
+		using mutable_map_iterator = table_map::iterator;
+		using const_map_iterator   = table_map::const_iterator;
 		using map_iterator		   = std::conditional_t<IsConst, const_map_iterator, mutable_map_iterator>;
 
 		mutable map_iterator iter_;
@@ -91,7 +101,7 @@ TOML_IMPL_NAMESPACE_START
 		using reference			= value_type&;
 		using pointer			= value_type*;
 		using difference_type	= typename std::iterator_traits<map_iterator>::difference_type;
-		using iterator_category = typename std::iterator_traits<map_iterator>::iterator_category;
+		using iterator_category = std::bidirectional_iterator_tag;
 
 		table_iterator& operator++() noexcept // ++pre
 		{
@@ -185,6 +195,10 @@ TOML_NAMESPACE_START
 	/// \brief A BidirectionalIterator for iterating over const key-value pairs in a toml::table.
 	using const_table_iterator = POXY_IMPLEMENTATION_DETAIL(impl::table_iterator<true>);
 
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+	TOML_ABI_NAMESPACE_BOOL(TOML_FLAT_TABLES, flattbl, stdtbl);
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenatbl, heaptbl);
+
 	/// \brief	A TOML table.
 	///
 	/// \detail The interface of this type is modeled after std::map, with some
@@ -221,13 +235,16 @@ TOML_NAMESPACE_START
 	  private:
 		/// \cond
 
-		using map_type			 = std::map<toml::key, impl::node_ptr, std::less<>>;
-		using map_pair			 = std::pair<const toml::key, impl::node_ptr>;
+		friend class TOML_PARSER_TYPENAME;
+
+		using map_type			 = impl::table_map;
+		using map_pair			 = typename map_type::value_type;
 		using map_iterator		 = typename map_type::iterator;
 		using const_map_iterator = typename map_type::const_iterator;
 		map_type map_;
-
-		bool inline_ = false;
+		// the table's impl::table_index (see TOML_TABLE_INDEX_MIN_KEYS), with the 'inline' flag in the low bit
+		// so the index doesn't cost a table any space
+		mutable std::atomic<uintptr_t> index_{};
 
 		TOML_NODISCARD_CTOR
 		TOML_EXPORTED_MEMBER_FUNCTION
@@ -547,7 +564,7 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		bool is_inline() const noexcept
 		{
-			return inline_;
+			return index_.load(std::memory_order_relaxed) & uintptr_t{ 1 };
 		}
 
 		/// \brief	Sets whether this table is a TOML inline table.
@@ -590,7 +607,8 @@ TOML_NAMESPACE_START
 		/// \param 	val	The new value for 'inline'.
 		void is_inline(bool val) noexcept
 		{
-			inline_ = val;
+			const auto bits = index_.load(std::memory_order_relaxed);
+			index_.store((bits & ~uintptr_t{ 1 }) | uintptr_t{ val }, std::memory_order_relaxed);
 		}
 
 		/// @}
@@ -1136,6 +1154,13 @@ TOML_NAMESPACE_START
 		TOML_EXPORTED_MEMBER_FUNCTION
 		map_iterator get_lower_bound(std::string_view) noexcept;
 
+		TOML_PURE_GETTER
+		TOML_EXPORTED_MEMBER_FUNCTION
+		map_iterator find_in_map(std::string_view) const noexcept;
+
+		TOML_EXPORTED_MEMBER_FUNCTION
+		void drop_index() noexcept;
+
 		/// \endcond
 
 	  public:
@@ -1995,6 +2020,10 @@ TOML_NAMESPACE_START
 
 #endif
 	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_ARENA
+	TOML_ABI_NAMESPACE_END; // TOML_FLAT_TABLES
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
 }
 TOML_NAMESPACE_END;
 
@@ -13,8 +13,168 @@
 
 #include "table.hpp"
 #include "node_view.hpp"
+#include "std_new.hpp"
+#include "linear_probing.inl"
 #include "header_start.hpp"
 
+TOML_IMPL_NAMESPACE_START
+{
+	// an open-addressing hash index over the keys of a wide table, built the first time one of its keys is looked
+	// up (see TOML_TABLE_INDEX_MIN_KEYS) and kept up to date as keys are inserted and erased. nothing here throws;
+	// if memory runs out (or a flat table shifts its elements) the table just drops its index and goes back to
+	// searching the map until the next lookup builds a new one.
+	class table_index
+	{
+	  private:
+		// (entries are referred to by iterator, or by position with flat tables, since those iterators don't last)
+#if TOML_FLAT_TABLES
+		using ref_type = size_t;
+#else
+		using ref_type = table_map::iterator;
+#endif
+
+		struct slot
+		{
+			size_t hash; // 0 == empty
+			ref_type ref;
+		};
+
+		struct slot_traits
+		{
+			TOML_PURE_INLINE_GETTER
+			static bool empty(const slot& s) noexcept
+			{
+				return !s.hash;
+			}
+
+			TOML_PURE_INLINE_GETTER
+			static size_t hash(const slot& s) noexcept
+			{
+				return s.hash;
+			}
+		};
+		using probing = linear_probing<slot, slot_traits>;
+
+		std::unique_ptr<slot[]> slots_;
+		size_t mask_  = {};
+		size_t count_ = {};
+
+		TOML_PURE_GETTER
+		static size_t hash(std::string_view key) noexcept
+		{
+			const auto h = std::hash<std::string_view>{}(key);
+			return h ? h : size_t{ 1 };
+		}
+
+		TOML_NODISCARD
+		static ref_type ref_of(table_map & map, table_map::const_iterator it) noexcept
+		{
+#if TOML_FLAT_TABLES
+			return static_cast<size_t>(it - map.cbegin());
+#else
+			return map.erase(it, it); // (a no-op that gives a mutable iterator)
+#endif
+		}
+
+		TOML_NODISCARD
+		static table_map::iterator iterator_of(table_map & map, ref_type ref) noexcept
+		{
+#if TOML_FLAT_TABLES
+			return map.begin() + static_cast<ptrdiff_t>(ref);
+#else
+			TOML_UNUSED(map);
+			return ref;
+#endif
+		}
+
+		TOML_NODISCARD
+		bool rebuild(table_map & map, size_t capacity) noexcept
+		{
+			slots_.reset(new (std::nothrow) slot[capacity]{});
+			if (!slots_)
+				return false;
+
+			mask_  = capacity - 1u;
+			count_ = map.size();
+			for (auto it = map.begin(); it != map.end(); it++)
+				probing::place(slots_.get(), mask_, slot{ hash(it->first), ref_of(map, it) });
+			return true;
+		}
+
+	  public:
+		TOML_NODISCARD
+		static table_index* create(table_map & map) noexcept
+		{
+			auto idx = new (std::nothrow) table_index;
+			if (idx && !idx->rebuild(map, probing::capacity_for(map.size())))
+			{
+				delete idx;
+				idx = nullptr;
+			}
+			return idx;
+		}
+
+		TOML_PURE_GETTER
+		table_map::iterator find(table_map & map, std::string_view key) const noexcept
+		{
+			const auto h  = hash(key);
+			const auto& s = probing::find(slots_.get(),
+										  mask_,
+										  h,
+										  [&](const slot& candidate) noexcept
+										  { return candidate.hash == h && iterator_of(map, candidate.ref)->first == key; });
+			return slot_traits::empty(s) ? map.end() : iterator_of(map, s.ref);
+		}
+
+		// called after inserting the element at 'pos'. returns false if the index couldn't be updated.
+		TOML_NODISCARD
+		bool insert(table_map & map, table_map::const_iterator pos) noexcept
+		{
+			const auto ref = ref_of(map, pos);
+#if TOML_FLAT_TABLES
+			// (everything after it moved up one; renumbering them all on every insert would make filling a table
+			// quadratic, so unless it went on the end the index is dropped and rebuilt by the next lookup instead)
+			if (ref + 1u < map.size())
+				return false;
+#endif
+			if (probing::needs_growth(count_, mask_ + 1u))
+				return rebuild(map, probing::grown_capacity(mask_ + 1u));
+
+			probing::place(slots_.get(), mask_, slot{ hash(pos->first), ref });
+			count_++;
+			return true;
+		}
+
+		// called before erasing the element at 'pos'. returns false if the index couldn't be updated.
+		TOML_NODISCARD
+		bool erase(table_map & map, table_map::const_iterator pos) noexcept
+		{
+			const auto ref = ref_of(map, pos);
+#if TOML_FLAT_TABLES
+			// (as above; everything after it is about to move down one)
+			if (ref + 1u < map.size())
+				return false;
+#endif
+
+			auto& s = probing::find(slots_.get(),
+									mask_,
+									hash(pos->first),
+									[&](const slot& candidate) noexcept { return candidate.ref == ref; });
+			probing::erase(slots_.get(), mask_, s);
+			count_--;
+			return true;
+		}
+	};
+
+	TOML_CONST_GETTER
+	TOML_INTERNAL_LINKAGE
+	table_index* table_index_of(uintptr_t bits) noexcept
+	{
+		return reinterpret_cast<table_index*>(bits & ~uintptr_t{ 1 }); // (the low bit is table::is_inline())
+	}
+}
+TOML_IMPL_NAMESPACE_END;
+
 TOML_NAMESPACE_START
 {
 	TOML_EXTERNAL_LINKAGE
@@ -28,6 +188,15 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	table::~table() noexcept
 	{
+		drop_index();
+
+#if TOML_ENABLE_ARENA
+		{
+			const impl::node_free_batch batch;
+			const auto contents = std::move(map_);
+		}
+#endif
+
 #if TOML_LIFETIME_HOOKS
 		TOML_TABLE_DESTROYED;
 #endif
@@ -59,7 +228,7 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	table::table(const table& other) //
 		: node(other),
-		  inline_{ other.inline_ }
+		  index_{ other.index_.load(std::memory_order_relaxed) & uintptr_t{ 1 } }
 	{
 		for (auto&& [k, v] : other.map_)
 			map_.emplace_hint(map_.end(), k, impl::make_node(*v));
@@ -73,7 +242,8 @@ TOML_NAMESPACE_START
 	table::table(table && other) noexcept //
 		: node(std::move(other)),
 		  map_{ std::move(other.map_) },
-		  inline_{ other.inline_ }
+		  index_{ other.index_.exchange(other.index_.load(std::memory_order_relaxed) & uintptr_t{ 1 },
+										std::memory_order_relaxed) }
 	{
 #if TOML_LIFETIME_HOOKS
 		TOML_TABLE_CREATED;
@@ -86,10 +256,11 @@ TOML_NAMESPACE_START
 		if (&rhs != this)
 		{
 			node::operator=(rhs);
+			drop_index();
 			map_.clear();
 			for (auto&& [k, v] : rhs.map_)
 				map_.emplace_hint(map_.end(), k, impl::make_node(*v));
-			inline_ = rhs.inline_;
+			is_inline(rhs.is_inline());
 		}
 		return *this;
 	}
@@ -100,8 +271,14 @@ TOML_NAMESPACE_START
 		if (&rhs != this)
 		{
 			node::operator=(std::move(rhs));
-			map_	= std::move(rhs.map_);
-			inline_ = rhs.inline_;
+			drop_index();
+#if TOML_ENABLE_ARENA
+			const impl::node_free_batch batch;
+#endif
+			map_ = std::move(rhs.map_);
+			index_.store(rhs.index_.exchange(rhs.index_.load(std::memory_order_relaxed) & uintptr_t{ 1 },
+											 std::memory_order_relaxed),
+						 std::memory_order_relaxed);
 		}
 		return *this;
 	}
@@ -159,11 +336,54 @@ TOML_NAMESPACE_START
 		return result;
 	}
 
+	TOML_PURE_GETTER
+	TOML_EXTERNAL_LINKAGE
+	table::map_iterator table::find_in_map(std::string_view key) const noexcept
+	{
+		auto& map = const_cast<map_type&>(map_);
+
+#if TOML_TABLE_INDEX_MIN_KEYS > 0
+		if (map.size() >= TOML_TABLE_INDEX_MIN_KEYS)
+		{
+			auto bits = index_.load(std::memory_order_acquire);
+			auto idx  = impl::table_index_of(bits);
+			if (!idx)
+			{
+				// (lookups can happen concurrently, so whoever gets there first gets to keep theirs)
+				idx = impl::table_index::create(map);
+				if (idx
+					&& !index_.compare_exchange_strong(bits,
+													   reinterpret_cast<uintptr_t>(idx) | bits,
+													   std::memory_order_acq_rel))
+				{
+					delete idx;
+					idx = impl::table_index_of(bits);
+				}
+			}
+			if (idx)
+				return idx->find(map, key);
+		}
+#endif
+
+		return map.find(key);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	void table::drop_index() noexcept
+	{
+		const auto bits = index_.load(std::memory_order_relaxed);
+		if (auto idx = impl::table_index_of(bits))
+		{
+			index_.store(bits & uintptr_t{ 1 }, std::memory_order_relaxed);
+			delete idx;
+		}
+	}
+
 	TOML_PURE_GETTER
 	TOML_EXTERNAL_LINKAGE
 	node* table::get(std::string_view key) noexcept
 	{
-		if (auto it = map_.find(key); it != map_.end())
+		if (auto it = find_in_map(key); it != map_.end())
 			return it->second.get();
 		return nullptr;
 	}
@@ -203,34 +423,38 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	table::iterator table::find(std::string_view key) noexcept
 	{
-		return iterator{ map_.find(key) };
+		return iterator{ find_in_map(key) };
 	}
 
 	TOML_PURE_GETTER
 	TOML_EXTERNAL_LINKAGE
 	table::const_iterator table::find(std::string_view key) const noexcept
 	{
-		return const_iterator{ map_.find(key) };
+		return const_iterator{ find_in_map(key) };
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	table::map_iterator table::erase(const_map_iterator pos) noexcept
 	{
+		if (auto idx = impl::table_index_of(index_.load(std::memory_order_relaxed)); idx && !idx->erase(map_, pos))
+			drop_index();
 		return map_.erase(pos);
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	table::map_iterator table::erase(const_map_iterator begin, const_map_iterator end) noexcept
 	{
+		if (begin != end)
+			drop_index();
 		return map_.erase(begin, end);
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	size_t table::erase(std::string_view key) noexcept
 	{
-		if (auto it = map_.find(key); it != map_.end())
+		if (auto it = find_in_map(key); it != map_.end())
 		{
-			map_.erase(it);
+			erase(const_map_iterator{ it });
 			return size_t{ 1 };
 		}
 		return size_t{};
@@ -242,32 +466,49 @@ TOML_NAMESPACE_START
 		if (map_.empty())
 			return *this;
 
-		for (auto it = map_.begin(); it != map_.end();)
+		const auto prunable = [=](node& nde) noexcept
 		{
-			if (auto arr = it->second->as_array())
+			if (auto arr = nde.as_array())
 			{
 				if (recursive)
 					arr->prune(true);
-
-				if (arr->empty())
-				{
-					it = map_.erase(it);
-					continue;
-				}
+				return arr->empty();
 			}
-			else if (auto tbl = it->second->as_table())
+			if (auto tbl = nde.as_table())
 			{
 				if (recursive)
 					tbl->prune(true);
-
-				if (tbl->empty())
-				{
-					it = map_.erase(it);
-					continue;
-				}
+				return tbl->empty();
 			}
-			it++;
+			return false;
+		};
+
+#if TOML_FLAT_TABLES
+
+		// (erasing them one at a time would shift everything after each of them down, so the rest are compacted
+		// in one pass instead)
+		auto kept = map_.begin();
+		for (auto it = map_.begin(); it != map_.end(); it++)
+		{
+			if (prunable(*it->second))
+				continue;
+			if (kept != it)
+				*kept = std::move(*it);
+			kept++;
 		}
+		erase(const_map_iterator{ kept }, map_.cend());
+
+#else
+
+		for (auto it = map_.begin(); it != map_.end();)
+		{
+			if (prunable(*it->second))
+				it = erase(it);
+			else
+				it++;
+		}
+
+#endif
 
 		return *this;
 	}
@@ -275,13 +516,23 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	void table::clear() noexcept
 	{
+		drop_index();
+#if TOML_ENABLE_ARENA
+		const impl::node_free_batch batch;
+#endif
 		map_.clear();
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	table::map_iterator table::insert_with_hint(const_iterator hint, key && k, impl::node_ptr && v)
 	{
-		return map_.emplace_hint(const_map_iterator{ hint }, std::move(k), std::move(v));
+		const auto size = map_.size();
+		const auto it	= map_.emplace_hint(const_map_iterator{ hint }, std::move(k), std::move(v));
+
+		if (auto idx = impl::table_index_of(index_.load(std::memory_order_relaxed));
+			idx && map_.size() != size && !idx->insert(map_, it))
+			drop_index();
+		return it;
 	}
 
 	TOML_PURE_GETTER
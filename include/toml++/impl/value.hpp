@@ -207,6 +207,8 @@ TOML_IMPL_NAMESPACE_END;
 
 TOML_NAMESPACE_START
 {
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+
 	/// \brief	A TOML value.
 	///
 	/// \tparam	ValueType	The value's native TOML data type. Can be one of:
@@ -986,6 +988,8 @@ TOML_NAMESPACE_START
 	template <typename T>
 	value(T, value_flags) -> value<impl::native_type_of<impl::remove_cvref<T>>>;
 
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
+
 	template <typename T>
 	TOML_NODISCARD
 	inline decltype(auto) node::get_value_exact() const noexcept(impl::value_retrieval_is_nothrow<T>)
@@ -35,21 +35,27 @@ TOML_PRAGMA_CLANG(diagnostic ignored "-Wreserved-identifier")
 #include "impl/std_new.hpp"
 #include "impl/std_string.hpp"
 #include "impl/std_optional.hpp"
+#include "impl/std_memory_resource.hpp"
+#include "impl/std_atomic.hpp"
 #include "impl/forward_declarations.hpp"
 #include "impl/print_to_stream.hpp"
 #include "impl/source_region.hpp"
 #include "impl/date_time.hpp"
 #include "impl/at_path.hpp"
 #include "impl/path.hpp"
+#include "impl/node_arena.hpp"
 #include "impl/node.hpp"
 #include "impl/node_view.hpp"
 #include "impl/value.hpp"
 #include "impl/make_node.hpp"
 #include "impl/array.hpp"
 #include "impl/key.hpp"
+#include "impl/key_pool.hpp"
+#include "impl/flat_map.hpp"
 #include "impl/table.hpp"
 #include "impl/unicode_autogenerated.hpp"
 #include "impl/unicode.hpp"
+#include "impl/simd.hpp"
 #include "impl/parse_error.hpp"
 #include "impl/parse_result.hpp"
 #include "impl/parser.hpp"
@@ -63,12 +69,16 @@ TOML_PRAGMA_CLANG(diagnostic ignored "-Wreserved-identifier")
 
 #include "impl/std_string.inl"
 #include "impl/print_to_stream.inl"
+#include "impl/node_arena.inl"
 #include "impl/node.inl"
 #include "impl/at_path.inl"
 #include "impl/path.inl"
 #include "impl/array.inl"
 #include "impl/table.inl"
+#include "impl/key_pool.inl"
+#include "impl/simd.inl"
 #include "impl/unicode.inl"
+#include "impl/decimal_to_double.inl"
 #include "impl/parser.inl"
 #include "impl/formatter.inl"
 #include "impl/toml_formatter.inl"
@@ -150,6 +160,8 @@ TOML_POP_WARNINGS;
 #undef TOML_HAS_CUSTOM_OPTIONAL_TYPE
 #undef TOML_HAS_FEATURE
 #undef TOML_HAS_INCLUDE
+#undef TOML_HAS_MEMORY_RESOURCE
+#undef TOML_HAS_SIMD_DISPATCH
 #undef TOML_HAS_SSE2
 #undef TOML_HAS_SSE4_1
 #undef TOML_HIDDEN_CONSTRAINT
@@ -18,10 +18,12 @@ TEST_CASE("arrays - moving")
 			auto arr1 = tbl["test"].as<array>();
 			REQUIRE(arr1);
 			CHECK(arr1->size() == 1u);
+#if TOML_ENABLE_SOURCES
 			CHECK(arr1->source().begin == source_position{ 1, 8 });
 			CHECK(arr1->source().end == source_position{ 1, 17 });
 			CHECK(arr1->source().path);
 			CHECK(*arr1->source().path == filename);
+#endif
 			REQUIRE(arr1->get_as<std::string>(0u));
 			CHECK(*arr1->get_as<std::string>(0u) == "foo"sv);
 
@@ -72,10 +74,12 @@ TEST_CASE("arrays - moving")
 
 			// check the results of move-assignment
 			arr2 = std::move(*arr1);
+#if TOML_ENABLE_SOURCES
 			CHECK(arr2.source().begin == source_position{ 1, 8 });
 			CHECK(arr2.source().end == source_position{ 1, 17 });
 			CHECK(arr2.source().path);
 			CHECK(*arr2.source().path == filename);
+#endif
 			CHECK(arr2.size() == 1u);
 			REQUIRE(arr2.get_as<std::string>(0u));
 			CHECK(*arr2.get_as<std::string>(0u) == "foo"sv);
@@ -88,10 +92,12 @@ TEST_CASE("arrays - moving")
 
 			// check the results of move-construction
 			array arr3{ std::move(arr2) };
+#if TOML_ENABLE_SOURCES
 			CHECK(arr3.source().begin == source_position{ 1, 8 });
 			CHECK(arr3.source().end == source_position{ 1, 17 });
 			CHECK(arr3.source().path);
 			CHECK(*arr3.source().path == filename);
+#endif
 			CHECK(arr3.size() == 1u);
 			REQUIRE(arr3.get_as<std::string>(0u));
 			CHECK(*arr3.get_as<std::string>(0u) == "foo"sv);
@@ -118,10 +124,12 @@ TEST_CASE("arrays - copying")
 			auto arr1 = tbl["test"].as<array>();
 			REQUIRE(arr1);
 			CHECK(arr1->size() == 1u);
+#if TOML_ENABLE_SOURCES
 			CHECK(arr1->source().begin == source_position{ 1, 8 });
 			CHECK(arr1->source().end == source_position{ 1, 17 });
 			CHECK(arr1->source().path);
 			CHECK(*arr1->source().path == filename);
+#endif
 			REQUIRE(arr1->get_as<std::string>(0u));
 			CHECK(*arr1->get_as<std::string>(0u) == "foo"sv);
 
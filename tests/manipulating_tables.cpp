@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "tests.hpp"
+#include <thread>
 
 TEST_CASE("tables - moving")
 {
@@ -17,8 +18,10 @@ TEST_CASE("tables - moving")
 			// sanity-check initial state of a freshly-parsed table
 			REQUIRE(tbl["test"].as<table>());
 			CHECK(tbl["test"].as<table>()->size() == 1u);
+#if TOML_ENABLE_SOURCES
 			CHECK(tbl["test"].as<table>()->source().begin == source_position{ 1, 8 });
 			CHECK(tbl["test"].as<table>()->source().end == source_position{ 1, 24 });
+#endif
 			CHECK(tbl["test"].node() == tbl.get("test"sv));
 			CHECK(tbl["test"].node() == &tbl.at("test"sv));
 
@@ -26,8 +29,10 @@ TEST_CASE("tables - moving")
 			const table& ctbl = tbl;
 			REQUIRE(ctbl["test"].as<table>());
 			CHECK(ctbl["test"].as<table>()->size() == 1u);
+#if TOML_ENABLE_SOURCES
 			CHECK(ctbl["test"].as<table>()->source().begin == source_position{ 1, 8 });
 			CHECK(ctbl["test"].as<table>()->source().end == source_position{ 1, 24 });
+#endif
 			CHECK(ctbl["test"].node() == ctbl.get("test"sv));
 			CHECK(ctbl["test"].node() == &ctbl.at("test"sv));
 
@@ -77,10 +82,12 @@ TEST_CASE("tables - moving")
 
 			// check the results of move-assignment
 			tbl2 = std::move(tbl);
+#if TOML_ENABLE_SOURCES
 			CHECK(tbl2.source().begin == source_position{ 1, 1 });
 			CHECK(tbl2.source().end == source_position{ 1, 24 });
 			CHECK(tbl2.source().path);
 			CHECK(*tbl2.source().path == filename);
+#endif
 			CHECK(tbl2.size() == 1u);
 			REQUIRE(tbl2["test"].as<table>());
 			CHECK(tbl2["test"].as<table>()->size() == 1u);
@@ -95,10 +102,12 @@ TEST_CASE("tables - moving")
 
 			// check the results of move-construction
 			table tbl3{ std::move(tbl2) };
+#if TOML_ENABLE_SOURCES
 			CHECK(tbl3.source().begin == source_position{ 1, 1 });
 			CHECK(tbl3.source().end == source_position{ 1, 24 });
 			CHECK(tbl3.source().path);
 			CHECK(*tbl3.source().path == filename);
+#endif
 			CHECK(tbl3.size() == 1u);
 			REQUIRE(tbl3["test"].as<table>());
 			CHECK(tbl3["test"].as<table>()->size() == 1u);
@@ -126,8 +135,10 @@ TEST_CASE("tables - copying")
 			// sanity-check initial state of a freshly-parsed table
 			REQUIRE(tbl["test"].as<table>());
 			CHECK(tbl["test"].as<table>()->size() == 1u);
+#if TOML_ENABLE_SOURCES
 			CHECK(tbl["test"].as<table>()->source().begin == source_position{ 1, 8 });
 			CHECK(tbl["test"].as<table>()->source().end == source_position{ 1, 24 });
+#endif
 			CHECK(tbl["test"]["val1"] == "foo");
 
 			// sanity-check initial state of default-constructed table
@@ -422,6 +433,188 @@ TEST_CASE("tables - insertion and erasure")
 	}
 }
 
+TEST_CASE("tables - flat storage")
+{
+	// (the storage used by tables when TOML_FLAT_TABLES is enabled)
+	using map_type = impl::flat_map<toml::key, int, std::allocator<char>>;
+
+	const auto keys_of = [](const map_type& map)
+	{
+		std::string keys;
+		for (auto& [k, v] : map)
+			keys.append(k.str());
+		return keys;
+	};
+
+	map_type map;
+	CHECK(map.empty());
+	CHECK(map.find("a"sv) == map.end());
+	CHECK(map.lower_bound("a"sv) == map.end());
+
+	// correct hints
+	auto it = map.emplace_hint(map.end(), toml::key{ "b" }, 2);
+	CHECK(it == map.begin());
+	it = map.emplace_hint(map.end(), toml::key{ "d" }, 4);
+	CHECK(it == map.begin() + 1);
+	it = map.emplace_hint(map.begin(), toml::key{ "a" }, 1);
+	CHECK(it == map.begin());
+	CHECK(keys_of(map) == "abd"sv);
+
+	// wrong hints
+	it = map.emplace_hint(map.begin(), toml::key{ "c" }, 3);
+	CHECK(it == map.begin() + 2);
+	it = map.emplace_hint(map.begin(), toml::key{ "e" }, 5);
+	CHECK(it == map.begin() + 4);
+	CHECK(keys_of(map) == "abcde"sv);
+
+	// existing keys
+	it = map.emplace_hint(map.end(), toml::key{ "b" }, 42);
+	CHECK(it == map.begin() + 1);
+	CHECK(it->second == 2);
+	CHECK(map.size() == 5u);
+
+	auto res = map.insert_or_assign(toml::key{ "b" }, 42);
+	CHECK(res.first == map.begin() + 1);
+	CHECK(!res.second);
+	CHECK(res.first->second == 42);
+	res = map.insert_or_assign(toml::key{ "bb" }, 22);
+	CHECK(res.first == map.begin() + 2);
+	CHECK(res.second);
+	CHECK(keys_of(map) == "abbbcde"sv);
+
+	// lookups
+	CHECK(map.find("c"sv)->second == 3);
+	CHECK(map.find("bb"sv)->second == 22);
+	CHECK(map.find("ba"sv) == map.end());
+	CHECK(map.find("f"sv) == map.end());
+	CHECK(map.lower_bound("ba"sv) == map.begin() + 2);
+	CHECK(map.lower_bound(""sv) == map.begin());
+	CHECK(std::as_const(map).find("e"sv) == map.cbegin() + 5);
+
+	// erasure
+	it = map.erase(map.cbegin() + 1);
+	CHECK(it->first == "bb"sv);
+	it = map.erase(map.cbegin(), map.cbegin() + 2);
+	CHECK(it->first == "c"sv);
+	CHECK(keys_of(map) == "cde"sv);
+	map.clear();
+	CHECK(map.empty());
+}
+
+#if TOML_TABLE_INDEX_MIN_KEYS > 0
+
+TEST_CASE("tables - hash index")
+{
+	// tables this wide build a hash index on their first lookup, which then has to keep up with changes to them
+	constexpr size_t size = TOML_TABLE_INDEX_MIN_KEYS * 2u;
+	const auto key_of	  = [](size_t i) { return "key"s + std::to_string(i); };
+
+	table tbl;
+	for (size_t i = 0; i < size; i += 2u)
+		tbl.insert(key_of(i), static_cast<int64_t>(i));
+	REQUIRE(tbl.size() == size / 2u);
+
+	const auto check_keys = [&](size_t limit)
+	{
+		size_t mismatches = {};
+		for (size_t i = 0; i < limit; i++)
+		{
+			const auto key	   = key_of(i);
+			const bool present = i % 2u == 0u;
+			const auto nde	   = tbl.get(key);
+			if (present != (nde != nullptr) || (nde && *nde->value<int64_t>() != static_cast<int64_t>(i))
+				|| present != (tbl.find(key) != tbl.end()))
+				mismatches++;
+		}
+		return mismatches;
+	};
+	CHECK(check_keys(size) == 0u);
+
+	// inserting (including enough to grow the index)
+	for (size_t i = size; i < size * 3u; i += 2u)
+		tbl.insert(key_of(i), static_cast<int64_t>(i));
+	CHECK(check_keys(size * 3u) == 0u);
+	CHECK(tbl.size() == size * 3u / 2u);
+
+	// erasing
+	for (size_t i = 0; i < size * 3u; i += 4u)
+		CHECK(tbl.erase(key_of(i)) == 1u);
+	CHECK(tbl.size() == size * 3u / 4u);
+	for (size_t i = 0; i < size * 3u; i += 4u)
+		tbl.insert(key_of(i), static_cast<int64_t>(i));
+	CHECK(check_keys(size * 3u) == 0u);
+
+	tbl.erase(tbl.begin(), std::next(tbl.begin(), 10));
+	CHECK(tbl.size() == size * 3u / 2u - 10u);
+	CHECK(tbl.find(tbl.begin()->first) == tbl.begin());
+	CHECK(tbl.get(key_of(size * 3u - 2u)));
+
+	// pruning (which erases from all over the table)
+	{
+		table wide;
+		for (size_t i = 0; i < size; i++)
+		{
+			if (i % 2u == 0u)
+				wide.insert(key_of(i), static_cast<int64_t>(i));
+			else
+				wide.insert(key_of(i), table{});
+		}
+		REQUIRE(wide.get(key_of(1u)));
+		wide.prune();
+		CHECK(wide.size() == size / 2u);
+		size_t mismatches = {};
+		for (size_t i = 0; i < size; i++)
+			if ((i % 2u == 0u) != (wide.get(key_of(i)) != nullptr))
+				mismatches++;
+		CHECK(mismatches == 0u);
+
+		for (size_t i = 1; i < size; i += 2u)
+			wide.insert(key_of(i), static_cast<int64_t>(i));
+		for (size_t i = 0; i < size; i++)
+			if (auto val = wide.get_as<int64_t>(key_of(i)); !val || **val != static_cast<int64_t>(i))
+				mismatches++;
+		CHECK(mismatches == 0u);
+	}
+
+	// moving and copying (the 'inline' flag shares a word with the index)
+	tbl.is_inline(true);
+	CHECK(tbl.get(key_of(size * 3u - 2u)));
+	CHECK(tbl.is_inline());
+	table moved = std::move(tbl);
+	CHECK(moved.get(key_of(size * 3u - 2u)));
+	CHECK(moved.is_inline());
+	table copied = moved;
+	CHECK(copied.get(key_of(size * 3u - 2u)));
+	CHECK(copied.is_inline());
+	copied.is_inline(false);
+	CHECK(copied.get(key_of(size * 3u - 2u)));
+	CHECK(!copied.is_inline());
+	copied.clear();
+	CHECK(!copied.get(key_of(size * 3u - 2u)));
+	CHECK(moved == table{ moved });
+
+	// concurrent lookups in a const table
+	{
+		const table shared = moved;
+		std::vector<std::thread> threads;
+		std::vector<size_t> found(4u);
+		for (auto& count : found)
+			threads.emplace_back(
+				[&]()
+				{
+					for (size_t i = 0; i < size * 3u; i++)
+						if (shared.get(key_of(i)))
+							count++;
+				});
+		for (auto& thread : threads)
+			thread.join();
+		for (auto count : found)
+			CHECK(count == moved.size());
+	}
+}
+
+#endif
+
 TEST_CASE("tables - toml_formatter")
 {
 	static constexpr auto to_string = [](std::string_view some_toml,
@@ -0,0 +1,270 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+#include "tests.hpp"
+#include <mutex>
+#include <thread>
+
+namespace
+{
+	constexpr auto arena_doc = R"(title = "arena"
+numbers = [ 1, 2, 3 ]
+point = { x = 1.5, y = -2.5 }
+
+[owner]
+name = "a string long enough to need its own allocation"
+dob = 1979-05-27T07:32:00-08:00
+
+[[products]]
+name = "Hammer"
+sku = 738594937
+
+[[products]]
+name = "Nail"
+sku = 284758393
+)"sv;
+
+	table parse_with_arena(std::string_view doc, size_t threads = 1u)
+	{
+		parse_options options;
+		options.use_arena			 = true;
+		options.threads				 = threads;
+		options.min_bytes_per_thread = 1u; // (so the document actually gets split up)
+		return table_of(toml::parse(doc, options, "arena.toml"sv));
+	}
+
+#if defined(__cpp_lib_memory_resource) && __cpp_lib_memory_resource >= 201603
+
+	class counting_resource final : public std::pmr::memory_resource
+	{
+	  public:
+		size_t allocations = {};
+		size_t outstanding = {};
+
+	  private:
+		std::mutex mutex_; // (documents from it get destroyed on other threads)
+
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			void* ptr = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+			allocations++;
+			outstanding += bytes;
+			return ptr;
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+			outstanding -= bytes;
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+	};
+
+#endif
+}
+
+TEST_CASE("parsing - arena")
+{
+	const auto expected_result = toml::parse(arena_doc, "arena.toml"sv);
+	const table& expected	   = expected_result;
+
+	for (size_t threads : { 1u, 4u })
+	{
+		INFO("threads: "sv << threads)
+		CHECK(parse_with_arena(arena_doc, threads) == expected);
+	}
+
+	// nodes can outlive the document they were parsed from
+	{
+		table products;
+		std::optional<array> numbers;
+		{
+			auto tbl = parse_with_arena(arena_doc);
+			products.insert("products", std::move(*tbl["products"].as_array()));
+			numbers = *tbl["numbers"].as_array(); // (a copy, from the global heap)
+			tbl["owner"].as_table()->insert("extra", std::move(*tbl["point"].as_table()));
+		}
+		CHECK(*products["products"].as_array() == *expected["products"].as_array());
+		CHECK(*numbers == *expected["numbers"].as_array());
+
+		// and be mixed with nodes from other arenas, and from the global heap
+		{
+			auto tbl = parse_with_arena(arena_doc);
+			tbl.insert_or_assign("products", std::move(products));
+			tbl["numbers"].as_array()->push_back(4);
+			for (int i = 5; i < 100; i++) // (the array's storage moves to the heap at some point)
+				tbl["numbers"].as_array()->push_back(i);
+			tbl["owner"].as_table()->insert("numbers", std::move(*numbers));
+			tbl.erase("point");
+
+			CHECK(tbl["products"]["products"][1]["sku"] == 284758393);
+			CHECK(tbl["numbers"].as_array()->size() == 99u);
+			CHECK(tbl["numbers"][98] == 99);
+			CHECK(*tbl["owner"]["numbers"].as_array() == *expected["numbers"].as_array());
+
+			products = std::move(*tbl["owner"].as_table());
+		}
+		CHECK(products["name"] == "a string long enough to need its own allocation"sv);
+		CHECK(products["numbers"][2] == 3);
+	}
+
+	// nodes can be released on other threads
+	{
+		std::vector<table> docs;
+		for (size_t i = 0; i < 8u; i++)
+			docs.push_back(parse_with_arena(arena_doc));
+
+		std::vector<std::thread> threads;
+		for (auto& doc : docs)
+			threads.emplace_back([tbl = std::move(doc)]() mutable { tbl.clear(); });
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+#if TOML_ENABLE_ARENA && defined(__cpp_lib_memory_resource) && __cpp_lib_memory_resource >= 201603
+
+	// tearing documents down settles their frees with their arenas all at once, on whichever thread does it
+	{
+		counting_resource resource;
+		parse_options options;
+		options.memory_resource = &resource;
+
+		std::vector<table> docs;
+		for (size_t i = 0; i < 4u; i++)
+			docs.push_back(table_of(toml::parse(arena_doc, options)));
+
+		std::optional<table> kept{ std::move(*docs[0]["owner"].as_table()) };
+
+		std::vector<std::thread> threads;
+		for (auto& doc : docs)
+			threads.emplace_back([tbl = std::make_unique<table>(std::move(doc))]() mutable { tbl.reset(); });
+		for (auto& thread : threads)
+			thread.join();
+		CHECK(resource.outstanding > 0u); // (kept is still alive)
+
+		CHECK(*kept == *expected["owner"].as_table());
+		kept.reset();
+		CHECK(resource.outstanding == 0u);
+	}
+
+#endif
+
+	// batches of documents each get their own arena
+	{
+		parse_options options;
+		options.use_arena = true;
+		options.threads	  = 2u;
+
+		std::optional<table> kept;
+		{
+			auto results = toml::parse_many({ arena_doc, "a = 1"sv, arena_doc }, options);
+			REQUIRE(results.size() == 3u);
+			kept = *results[2]["owner"].as_table();
+			kept->insert_or_assign("dob", std::move(*results[0]["owner"]["dob"].as_date_time()));
+		}
+		CHECK(*kept == *expected["owner"].as_table());
+	}
+}
+
+#if defined(__cpp_lib_memory_resource) && __cpp_lib_memory_resource >= 201603
+
+TEST_CASE("parsing - memory resource")
+{
+	counting_resource resource;
+
+#if TOML_ENABLE_ARENA
+
+	// documents (and the parser's buffers) are allocated from the resource
+	{
+		const auto expected_result = toml::parse(arena_doc, "arena.toml"sv);
+		const table& expected	   = expected_result;
+
+		parse_options options;
+		options.memory_resource		 = &resource;
+		options.min_bytes_per_thread = 1u;
+
+		for (size_t threads : { 1u, 4u })
+		{
+			INFO("threads: "sv << threads)
+			options.threads = threads;
+
+			{
+				const auto result = toml::parse(arena_doc, options, "arena.toml"sv);
+				CHECK(resource.allocations > 0u);
+				CHECK(resource.outstanding > 0u);
+				CHECK(result == expected);
+			}
+			CHECK(resource.outstanding == 0u);
+		}
+
+		// (including when they fail to parse)
+		options.threads = 1u;
+		resource.allocations = {};
+#if TOML_EXCEPTIONS
+		CHECK_THROWS_AS(toml::parse("a = 1\nb = [ 2, 3\n"sv, options), toml::parse_error);
+#else
+		CHECK(!toml::parse("a = 1\nb = [ 2, 3\n"sv, options));
+#endif
+		CHECK(resource.allocations > 0u);
+		CHECK(resource.outstanding == 0u);
+	}
+
+#endif
+
+	// nodes created inside a memory_resource_scope are allocated from the resource too
+	{
+		std::optional<table> tbl;
+		{
+			resource.allocations = {};
+			const memory_resource_scope scope{ &resource };
+
+			tbl.emplace();
+			tbl->insert("a", 1);
+			tbl->insert("b", array{ 2, 3 });
+			tbl->insert("c", parse_with_arena("d = 4"sv)); // (from a different arena)
+#if TOML_ENABLE_ARENA
+			CHECK(resource.allocations > 0u);
+#endif
+		}
+#if TOML_ENABLE_ARENA
+		CHECK(resource.outstanding > 0u);
+#endif
+
+		tbl->insert("e", 5); // (from the global heap)
+		CHECK(tbl->size() == 4u);
+		CHECK((*tbl)["b"][1] == 3);
+		CHECK((*tbl)["c"]["d"] == 4);
+
+		tbl.reset();
+		CHECK(resource.outstanding == 0u);
+	}
+
+	// as are keys long enough to need storage of their own (but not the ones in a key_pool, which outlive scopes)
+	{
+		std::optional<key> k;
+		key_pool pool;
+		{
+			const memory_resource_scope scope{ &resource };
+			k.emplace("a key long enough to need its own storage"sv);
+			CHECK(pool.intern("another key long enough to need its own storage"sv).str().length() > 16u);
+		}
+#if TOML_ENABLE_ARENA
+		CHECK(resource.outstanding > 0u);
+#endif
+		CHECK(k->str() == "a key long enough to need its own storage"sv);
+
+		k.reset();
+		CHECK(resource.outstanding == 0u);
+		CHECK(pool.size() == 1u);
+	}
+}
+
+#endif
@@ -24,6 +24,22 @@ TEST_CASE("parsing - comments")
 						   R"(# this = "looks like a KVP but is commented out)"sv,
 						   [](table&& tbl) { CHECK(tbl.size() == 0); });
 
+	// long runs of whitespace and comments
+	parsing_should_succeed(FILE_LINE_ARGS,
+						   "# ==========================================================================\n"
+						   "#\tcolumn-aligned keys with trailing comments \u00E9\u20AC\n"
+						   "# ==========================================================================\n"
+						   "\t\t    key                          =    1                # \u00E9 \t comment\r\n"
+						   "           another_key             =     \t  \t  2      #\n"
+						   "                                                                               \n"
+						   "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t# comment at eof"sv,
+						   [](table&& tbl)
+						   {
+							   CHECK(tbl.size() == 2);
+							   CHECK(tbl["key"] == 1);
+							   CHECK(tbl["another_key"] == 2);
+						   });
+
 #if TOML_LANG_AT_LEAST(1, 0, 0)
 	{
 		// toml/issues/567 (disallow non-TAB control characters in comments)
@@ -66,6 +82,16 @@ TEST_CASE("parsing - comments")
 		parsing_should_fail(FILE_LINE_ARGS, "# \u001F"sv);
 		// 7F
 		parsing_should_fail(FILE_LINE_ARGS, "# \u007F"sv);
+
+		// control characters a long way into a comment
+		parsing_should_fail(FILE_LINE_ARGS,
+							"key = 1 # the quick brown fox jumps over the lazy dog, the quick brown fox \u0001"sv,
+							1,
+							76);
+		parsing_should_fail(FILE_LINE_ARGS,
+							"# the quick brown fox jumps over the lazy dog\r\n# the quick brown fox \u007F jumps"sv,
+							2,
+							23);
 	}
 #else
 	{
@@ -171,4 +171,44 @@ TEST_CASE("parsing - dates and times")
 	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16 10:"sv);
 	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16 10"sv);
 	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16 1"sv);
+
+	// out-of-range fields, and things that only almost fit the fixed "YYYY-MM-DD", "HH:MM:SS" and "+HH:MM" layouts
+	parse_expected_value(FILE_LINE_ARGS, "2000-02-29"sv, date{ 2000, 2, 29 });
+	parse_expected_value(FILE_LINE_ARGS, "0000-01-01"sv, date{ 0, 1, 1 });
+	parse_expected_value(FILE_LINE_ARGS, "23:59:59"sv, toml::time{ 23, 59, 59 });
+	parse_expected_value(FILE_LINE_ARGS, "00:00:00.12345678"sv, toml::time{ 0, 0, 0, 123456780u });
+	parse_expected_value(FILE_LINE_ARGS, "00:00:00.123456789"sv, toml::time{ 0, 0, 0, 123456789u });
+	parse_expected_value(FILE_LINE_ARGS, "00:00:00.1234567891"sv, toml::time{ 0, 0, 0, 123456789u });
+	parse_expected_value(FILE_LINE_ARGS,
+						 "1987-03-16T10:20:30+23:59"sv,
+						 date_time{ { 1987, 3, 16 }, { 10, 20, 30 }, { 23, 59 } });
+	parse_expected_value(FILE_LINE_ARGS,
+						 "1987-03-16T10:20:30.5-00:00"sv,
+						 date_time{ { 1987, 3, 16 }, { 10, 20, 30, 500000000u }, {} });
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1900-02-29"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-13-16"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-04-31"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-00"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16x"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-1x"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 24:00:00"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 10:60:00"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 10:20:60"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 10:20:30x"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 10:20:30.x"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 10:20:30.123x"sv);
+	parsing_should_fail(
+		FILE_LINE_ARGS,
+		"val = 10:20:30.12345678901234567890123456789012345678901234567890123456789012345"sv); // 65 digits
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16T10:20:30+24:00"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16T10:20:30+09:60"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16T10:20:30+09:30x"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16T10:20:30+09-30"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16TT10:20:30"sv);
+
+	// a date followed by a space and a lone digit isn't a date-time
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16 1 "sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1987-03-16 1 # comment"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = [1987-03-16 1]"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = [1987-03-16 1, 2]"sv);
 }
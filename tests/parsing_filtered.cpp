@@ -0,0 +1,180 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+#include "tests.hpp"
+
+namespace
+{
+	constexpr auto filtered_doc = R"(title = "TOML Example"
+ports = [ 8000, 8001, 8002 ]
+limits = { rate = 1.5, burst = 10 }
+
+[database]
+host = "db.example.com"
+users = [ { name = "admin" }, { name = "guest" } ]
+
+[service]
+name = "frontend"
+
+[service.limits]
+requests = 1000
+
+[service.logging]
+level = "debug"
+
+[[servers]]
+name = "alpha"
+
+[servers.meta]
+rack = 1
+
+[[servers]]
+name = "beta"
+
+[servers.meta]
+rack = 2
+)"sv;
+
+	table parse_filtered(std::string_view doc, std::initializer_list<std::string_view> paths)
+	{
+		parse_options options;
+		for (auto path : paths)
+			options.keep_paths.emplace_back(path);
+		return table_of(toml::parse(doc, options, "filtered.toml"sv));
+	}
+
+	std::optional<parse_error> parse_failure(std::string_view doc, const parse_options& options = {})
+	{
+#if TOML_EXCEPTIONS
+		try
+		{
+			static_cast<void>(toml::parse(doc, options, "filtered.toml"sv));
+		}
+		catch (const parse_error& err)
+		{
+			return err;
+		}
+		return {};
+#else
+		auto result = toml::parse(doc, options, "filtered.toml"sv);
+		if (result)
+			return {};
+		return result.error();
+#endif
+	}
+}
+
+TEST_CASE("parsing - filtered")
+{
+	const auto full_result = toml::parse(filtered_doc, "filtered.toml"sv);
+	const table& full	   = full_result;
+
+	// no paths keeps everything
+	CHECK(parse_filtered(filtered_doc, {}) == full);
+	{
+		parse_options options;
+		options.keep_paths.emplace_back(); // the root
+		CHECK(toml::parse(filtered_doc, options, "filtered.toml"sv) == full);
+	}
+
+	// tables
+	{
+		auto tbl = parse_filtered(filtered_doc, { "database"sv, "service.limits"sv });
+		CHECK(tbl.size() == 2u);
+		CHECK(*tbl["database"].as_table() == *full["database"].as_table());
+		CHECK(tbl["service"].as_table()->size() == 1u);
+		CHECK(*tbl["service"]["limits"].as_table() == *full["service"]["limits"].as_table());
+
+		// kept nodes have their usual source regions
+		REQUIRE(tbl["database"]["host"].node());
+		CHECK(tbl["database"]["host"].node()->source().begin == full["database"]["host"].node()->source().begin);
+		CHECK(tbl["database"]["host"].node()->source().end == full["database"]["host"].node()->source().end);
+
+		// (including the root, even though the document ends in a table that was skipped)
+		CHECK(tbl.source().begin == full.source().begin);
+		CHECK(tbl.source().end == full.source().end);
+	}
+
+	// key-value pairs
+	{
+		auto tbl = parse_filtered(filtered_doc, { "title"sv, "limits.rate"sv, "ports[1]"sv });
+		CHECK(tbl.size() == 3u);
+		CHECK(tbl["title"] == "TOML Example"sv);
+		CHECK(*tbl["limits"].as_table() == *full["limits"].as_table()); // paths into values keep the whole value
+		CHECK(*tbl["ports"].as_array() == *full["ports"].as_array());
+	}
+
+	// arrays-of-tables
+	{
+		auto tbl = parse_filtered(filtered_doc, { "servers"sv });
+		CHECK(tbl.size() == 1u);
+		CHECK(*tbl["servers"].as_array() == *full["servers"].as_array());
+
+		tbl = parse_filtered(filtered_doc, { "servers[1].meta"sv });
+		REQUIRE(tbl["servers"].as_array());
+		CHECK(tbl["servers"].as_array()->size() == 2u);
+		CHECK(tbl["servers"][0].as_table()->empty());
+		CHECK(tbl["servers"][1].as_table()->size() == 1u);
+		CHECK(tbl["servers"][1]["meta"]["rack"] == 2);
+	}
+
+	// nothing matching
+	CHECK(parse_filtered(filtered_doc, { "missing"sv, "service.missing"sv }).at_path("service").as_table()->empty());
+
+	// skipped parts of the document are still checked for syntax errors
+	{
+		parse_options options;
+		options.keep_paths.emplace_back("a"sv);
+
+#if TOML_EXCEPTIONS
+		CHECK_THROWS_AS(toml::parse("a = 1\n[b]\nc = [ 1, 2"sv, options), parse_error);
+		CHECK_THROWS_AS(toml::parse("a = 1\nb = 1.e5"sv, options), parse_error);
+#else
+		CHECK(!toml::parse("a = 1\n[b]\nc = [ 1, 2"sv, options));
+		CHECK(!toml::parse("a = 1\nb = 1.e5"sv, options));
+#endif
+	}
+
+	// as are redefinitions (reported exactly as they would be without keep_paths)
+	{
+		const auto check_redefinition = [](std::string_view doc, std::string_view path)
+		{
+			INFO(doc);
+			const auto expected = parse_failure(doc);
+			REQUIRE(expected);
+
+			parse_options options;
+			options.keep_paths.emplace_back(path);
+			const auto actual = parse_failure(doc, options);
+			REQUIRE(actual);
+			CHECK(actual->description() == expected->description());
+			CHECK(actual->source().begin == expected->source().begin);
+		};
+		check_redefinition("a = 1\na = 2"sv, "b"sv);
+		check_redefinition("[a]\nx = 1\nx = 2"sv, "a.b"sv);
+		check_redefinition("[a]\nx = 1\n[a.x]"sv, "a.b"sv);
+		check_redefinition("a = 1\n[a]"sv, "b"sv);
+		check_redefinition("a = [ 1 ]\n[[a]]"sv, "b"sv);
+		check_redefinition("a.b = 1\na.b = 2"sv, "c"sv);
+		check_redefinition("a.b = 1\na = 2"sv, "c"sv);
+		check_redefinition("a.b = 1\n[a]"sv, "c"sv);
+		check_redefinition("[a]\nx.y = 1\n[a.x]"sv, "a.b"sv);
+		check_redefinition("a = { b = 1 }\na.c = 2"sv, "c"sv);
+		check_redefinition("a = { b = 1 }\n[a.c]"sv, "c"sv);
+		check_redefinition("a = { b = 1 }\n[a]"sv, "c"sv);
+	}
+
+	// (the tables that key-value pairs outside of keep_paths needed for that are taken out again afterwards)
+	{
+		auto tbl = parse_filtered("a.b = 1\na.c = { d = 1 }\ne = { f = 1 }\n[g]\nh = 1"sv, { "g"sv });
+		CHECK(tbl.size() == 1u);
+		CHECK(tbl["g"]["h"] == 1);
+
+		tbl = parse_filtered("a.b = 1\na.c.d = 1\na.e = 2\n[a.f]"sv, { "a.e"sv });
+		CHECK(tbl.size() == 1u);
+		CHECK(tbl["a"].as_table()->size() == 1u);
+		CHECK(tbl["a"]["e"] == 2);
+	}
+}
@@ -140,6 +140,29 @@ TEST_CASE("parsing - floats")
 	parse_expected_value(FILE_LINE_ARGS, "10.010284358729828"sv, 10.010284358729828);
 	parse_expected_value(FILE_LINE_ARGS, "10.0"sv, 10.0);
 
+	// rounding edge cases
+	parse_expected_value(FILE_LINE_ARGS, "9007199254740993.0"sv, 9007199254740992.0);
+	parse_expected_value(FILE_LINE_ARGS, "9007199254740995.0"sv, 9007199254740996.0);
+	parse_expected_value(FILE_LINE_ARGS, "9_007_199_254_740_993.000_000_000_001"sv, 9007199254740994.0);
+	parse_expected_value(FILE_LINE_ARGS, "1e23"sv, 1e23);
+	parse_expected_value(FILE_LINE_ARGS, "8.988465674311580536566680e307"sv, 8.988465674311580536566680e307);
+	parse_expected_value(FILE_LINE_ARGS, "1.7976931348623157e308"sv, 1.7976931348623157e308);
+	parse_expected_value(FILE_LINE_ARGS, "2.2250738585072014e-308"sv, 2.2250738585072014e-308);
+	parse_expected_value(FILE_LINE_ARGS, "4.9406564584124654e-324"sv, 4.9406564584124654e-324);
+	parse_expected_value(FILE_LINE_ARGS, "7.3177701707893310e15"sv, 7.3177701707893310e15);
+	parse_expected_value(FILE_LINE_ARGS, "2.470328229206232720882e-324"sv, 0.0);
+	parse_expected_value(FILE_LINE_ARGS,
+						 "1.00000000000000011102230246251565404236316680908203125"sv,
+						 1.00000000000000011102230246251565404236316680908203125);
+	parse_expected_value(FILE_LINE_ARGS,
+						 "1.00000000000000011102230246251565404236316680908203126"sv,
+						 1.00000000000000011102230246251565404236316680908203126);
+	parse_expected_value(FILE_LINE_ARGS, "123456789012345678901234567890e-10"sv, 123456789012345678901234567890e-10);
+	parse_expected_value(FILE_LINE_ARGS, "0.000000000000000000000000000001e30"sv, 1.0);
+	parse_expected_value(FILE_LINE_ARGS, "0e-999"sv, 0.0);
+	parsing_should_fail(FILE_LINE_ARGS, "flt = 1e309"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "flt = -1.8e308"sv);
+
 // toml/issues/562 (hexfloats)
 #if TOML_LANG_UNRELEASED
 	parse_expected_value(FILE_LINE_ARGS, "       0x1.2p3"sv, 0x1.2p3);
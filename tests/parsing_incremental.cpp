@@ -0,0 +1,219 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+#include "tests.hpp"
+
+#if UNICODE_LITERALS_OK
+
+namespace
+{
+	constexpr auto incremental_doc = BOM_PREFIX R"(# comment with "quotes" and 'apostrophes' and [brackets]
+title = "TOML \"Example\" [not an array]" # trailing { comment
+literal = 'C:\Users\#not a comment'
+
+[owner]
+name = "Tom Preston-Werner"
+dob = 1979-05-27T07:32:00-08:00
+
+[database]
+ports = [
+	8000, # comment ]
+	8001,
+	8002,
+]
+data = [ ["delta", "phi"], [3.14] ]
+inline = { a = 1, b = { c = "}" } }
+ml_basic = """
+line one "" \"""
+line two \
+   still line two""""
+ml_literal = '''
+]]] }}} ''" # not a comment
+'''''
+
+[[products]]
+name = "Hammer"
+sku = 738594937
+
+[[products]]
+name = "Nail"
+text = "Ýôú'ℓℓ λáƭè ₥è áƒƭèř ƭλïƨ"
+)"sv;
+
+	// describes every node's value and source region
+	std::string describe(const table& tbl)
+	{
+		std::stringstream ss;
+		ss << tbl << "\n";
+
+		const auto region = [&](const source_region& src)
+		{
+			ss << src.begin.line << ':' << src.begin.column << '-' << src.end.line << ':' << src.end.column << ';';
+		};
+		const auto walk = [&](const node& n, auto& self) -> void
+		{
+			region(n.source());
+			if (auto t = n.as_table())
+			{
+				for (auto&& [k, v] : *t)
+				{
+					ss << k.str() << '@';
+					region(k.source());
+					self(v, self);
+				}
+			}
+			else if (auto arr = n.as_array())
+			{
+				for (auto&& v : *arr)
+					self(v, self);
+			}
+		};
+		walk(tbl, walk);
+		return ss.str();
+	}
+}
+
+TEST_CASE("parsing - incremental")
+{
+	const auto expected = describe(toml::parse(incremental_doc));
+
+	// every possible split into two chunks (including through the middle of the BOM and multi-byte sequences)
+	{
+		size_t mismatches = {};
+		for (size_t i = 0; i <= incremental_doc.length(); i++)
+		{
+			incremental_parser parser;
+			parser.feed(incremental_doc.substr(0, i));
+			parser.feed(incremental_doc.substr(i));
+			CHECK(!parser.failed());
+
+			if (describe(table_of(parser.finish())) != expected)
+				mismatches++;
+		}
+		CHECK(mismatches == 0u);
+	}
+
+	// chunks of various sizes, reusing the same parser
+	{
+		incremental_parser parser;
+		for (size_t chunk_size : { 1u, 2u, 3u, 7u, 16u, 100u, 1000u })
+		{
+			INFO("chunk size " << chunk_size);
+			for (size_t i = 0; i < incremental_doc.length(); i += chunk_size)
+				parser.feed(incremental_doc.substr(i, chunk_size));
+
+			CHECK(describe(table_of(parser.finish())) == expected);
+		}
+	}
+
+	// empty documents
+	{
+		incremental_parser parser;
+		CHECK(table_of(parser.finish()).empty());
+
+		parser.feed(""sv);
+		parser.feed(BOM_PREFIX ""sv);
+		CHECK(table_of(parser.finish()).empty());
+	}
+
+#if TOML_ENABLE_SOURCES
+	// source paths
+	{
+		incremental_parser parser{ "foo.toml"sv };
+		parser.feed("a = 1\n"sv);
+		auto tbl = table_of(parser.finish());
+		REQUIRE(tbl["a"].node());
+		REQUIRE(tbl["a"].node()->source().path);
+		CHECK(*tbl["a"].node()->source().path == "foo.toml"sv);
+	}
+#endif
+
+	// errors are raised as soon as the offending line is complete
+	{
+		incremental_parser parser;
+		parser.feed("a = 1\n"sv);
+		parser.feed("b = "sv);
+		CHECK(!parser.failed());
+
+#if TOML_EXCEPTIONS
+		CHECK_THROWS_AS(parser.feed("\n"sv), parse_error);
+		CHECK(parser.failed());
+		parser.feed("c = 2\n"sv); // ignored
+		CHECK_THROWS_AS(parser.finish(), parse_error);
+#else
+		parser.feed("\n"sv);
+		CHECK(parser.failed());
+		parser.feed("c = 2\n"sv); // ignored
+		auto result = parser.finish();
+		REQUIRE(!result);
+		CHECK(result.error().source().begin.line == 2u);
+#endif
+
+		// the parser is reset by finish()
+		CHECK(!parser.failed());
+		parser.feed("a = 1\n"sv);
+		CHECK(table_of(parser.finish())["a"] == 1);
+	}
+
+	// errors are reported where toml::parse() reports them, wherever the chunks are split
+	{
+		const auto error_position = [](auto&& parse) -> source_position
+		{
+#if TOML_EXCEPTIONS
+			try
+			{
+				static_cast<void>(parse());
+			}
+			catch (const parse_error& err)
+			{
+				return err.source().begin;
+			}
+			return {};
+#else
+			auto result = parse();
+			return result ? source_position{} : result.error().source().begin;
+#endif
+		};
+		const auto parse_in_chunks = [&](std::string_view doc, size_t split)
+		{
+			return error_position(
+				[&]()
+				{
+					incremental_parser parser;
+					parser.feed(doc.substr(0, split));
+					parser.feed(doc.substr(split));
+					return parser.finish();
+				});
+		};
+
+		for (const auto doc : { "a = 'padding padding padding'\nb = { c = 1 }\n[b.d]\nx = 1\n"sv,
+								"# padding padding padding padding\nbad = '\xC3'\n"sv,
+								"s = '\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9'\n\n\xE2\x82\n"sv,
+								"a = 1\nx = \"\nb = 2\n"sv, // (the batch ends straight after the opening delimiter)
+								"a = 1\nx = '\nb = 2\n"sv })
+		{
+			const auto expected_pos = error_position([&]() { return toml::parse(doc); });
+			REQUIRE(expected_pos != source_position{});
+
+			size_t mismatches = {};
+			for (size_t i = 0; i <= doc.length(); i++)
+			{
+				if (parse_in_chunks(doc, i) != expected_pos)
+					mismatches++;
+			}
+			CHECK(mismatches == 0u);
+		}
+
+		// the exception: toml::parse() validates the encoding of a block of the document before parsing any of it,
+		// so an invalid UTF-8 sequence can be reported ahead of an earlier error in the same block. the incremental
+		// parser only does the same when it has been given the whole block.
+		const auto doc = "a = 1\na = 2\n\x80\n"sv;
+		CHECK(error_position([&]() { return toml::parse(doc); }) == source_position{ 2, 6 });
+		CHECK(parse_in_chunks(doc, doc.length()) == source_position{ 2, 6 });
+		CHECK(parse_in_chunks(doc, 12u) == source_position{ 2, 5 }); // (a redefinition of a)
+	}
+}
+
+#endif // UNICODE_LITERALS_OK
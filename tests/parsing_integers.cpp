@@ -79,6 +79,21 @@ TEST_CASE("parsing - integers (decimal)")
 	parse_expected_value(FILE_LINE_ARGS, "+1_2_3_4"sv, 1234);
 	parse_expected_value(FILE_LINE_ARGS, "-1_2_3_4"sv, -1234);
 	parse_expected_value(FILE_LINE_ARGS, "123_456_789"sv, 123456789);
+
+	// digits are converted eight at a time, so these straddle the boundaries
+	parse_expected_value(FILE_LINE_ARGS, "12345678"sv, 12345678);
+	parse_expected_value(FILE_LINE_ARGS, "123456789"sv, 123456789);
+	parse_expected_value(FILE_LINE_ARGS, "1234567890123456"sv, 1234567890123456);
+	parse_expected_value(FILE_LINE_ARGS, "-12345678901234567"sv, -12345678901234567);
+	parse_expected_value(FILE_LINE_ARGS, "1_234_567_890_123_456_789"sv, 1234567890123456789);
+	parse_expected_value(FILE_LINE_ARGS, "9_2_2_3_3_7_2_0_3_6_8_5_4_7_7_5_8_0_7"sv, INT64_MAX);
+	parse_expected_value(FILE_LINE_ARGS, "-9223_3720_3685_4775_808"sv, INT64_MIN);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 9_223_372_036_854_775_808"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 99999999999999999999"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1234_5678_"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1234_5678__9"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 1234_5678_x"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 12345678x"sv);
 }
 
 TEST_CASE("parsing - integers (hex, bin, oct)")
@@ -174,4 +189,12 @@ TEST_CASE("parsing - integers (hex, bin, oct)")
 	parse_expected_value(FILE_LINE_ARGS, "0b010000"sv, 0b10000);
 	parse_expected_value(FILE_LINE_ARGS, "0b01_00_00"sv, 0b10000);
 	parse_expected_value(FILE_LINE_ARGS, "0b111111"sv, 0b111111);
+	parse_expected_value(FILE_LINE_ARGS, "0x0123456789abcdef"sv, 0x0123456789ABCDEF);
+	parse_expected_value(FILE_LINE_ARGS, "0x1_23456789_ABCDEF"sv, 0x123456789ABCDEF);
+	parse_expected_value(FILE_LINE_ARGS, "0xfedcba98"sv, 0xFEDCBA98);
+	parse_expected_value(FILE_LINE_ARGS, "0o1234567012345670"sv, 01234567012345670);
+	parse_expected_value(FILE_LINE_ARGS, "0b1011_0111_0010_1100_1"sv, 0b10110111001011001);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 0x1_0000_0000_0000_0000"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 0xFFFFFFFFFFFFFFFF"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "val = 0x01234567_g"sv);
 }
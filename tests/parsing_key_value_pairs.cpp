@@ -27,6 +27,18 @@ TEST_CASE("parsing - key-value pairs")
 
 	parsing_should_fail(FILE_LINE_ARGS, R"(key = # INVALID)"sv);
 
+	// bare keys longer than the reader's internal block size
+	parsing_should_succeed(
+		FILE_LINE_ARGS,
+		"a_very_long_bare_key_that_spans_more_than_one_input_block.and-another-one-just-like-it-for-good-measure = 1"sv,
+		[](table&& tbl)
+		{
+			CHECK(tbl["a_very_long_bare_key_that_spans_more_than_one_input_block"]
+					 ["and-another-one-just-like-it-for-good-measure"]
+				  == 1);
+		});
+	parsing_should_fail(FILE_LINE_ARGS, "a_very_long_bare_key_that_spans_more_than_one_input_block\xFF = 1"sv, 1, 57);
+
 #if UNICODE_LITERALS_OK
 	parsing_should_succeed(FILE_LINE_ARGS,
 						   R"(
@@ -397,3 +409,105 @@ TEST_CASE("parsing - key-value pairs (string keys)")
 		"1".2e3 = 5
 	)"sv);
 }
+
+TEST_CASE("parsing - key-value pairs (interned keys)")
+{
+	static constexpr auto doc = R"(
+		[[products]]
+		product_description = "hammer"
+		sku = 738594937
+
+		[[products]]
+		product_description = "nail"
+		sku = 284758393
+	)"sv;
+
+	const auto key_in = [](const table& tbl, std::string_view path) -> const key&
+	{
+		const auto parent = tbl.at_path(path.substr(0u, path.rfind('.'))).as_table();
+		REQUIRE(parent);
+		return parent->lower_bound(path.substr(path.rfind('.') + 1u))->first;
+	};
+
+	// identical keys share their storage within a document
+	{
+		const auto result = toml::parse(doc);
+		const table& tbl  = result;
+		const auto& a	  = key_in(tbl, "products[0].product_description"sv);
+		const auto& b	  = key_in(tbl, "products[1].product_description"sv);
+		CHECK(a == "product_description"sv);
+		CHECK(b == "product_description"sv);
+		CHECK(a.data() == b.data());
+#if TOML_ENABLE_SOURCES
+		CHECK(a.source().begin != b.source().begin);
+#endif
+
+		// (and any copies of them)
+		const auto copy = table{ tbl };
+		CHECK(key_in(copy, "products[0].product_description"sv).data() == a.data());
+		CHECK(copy == tbl);
+	}
+
+	// and between documents parsed with the same pool
+	{
+		key_pool pool;
+		parse_options options;
+		options.interned_keys = &pool;
+
+		const auto result_a = toml::parse(doc, options);
+		const auto result_b = toml::parse(doc, options);
+		const table& a		= result_a;
+		const table& b		= result_b;
+		CHECK(a == b);
+		CHECK(key_in(a, "products[0].product_description"sv).data()
+			  == key_in(b, "products[1].product_description"sv).data());
+		CHECK(pool.size() == 1u); // (short keys are never pooled)
+
+		const auto k = pool.intern("product_description"sv);
+		CHECK(k.data() == key_in(a, "products[0].product_description"sv).data());
+		CHECK(pool.intern("sku"sv) == "sku"sv);
+		CHECK(pool.size() == 1u);
+
+		// keys outlive the pool's references to them
+		pool.clear();
+		CHECK(pool.size() == 0u);
+		CHECK(k == key_in(b, "products[0].product_description"sv));
+		CHECK(pool.intern("product_description"sv).data() != k.data());
+		CHECK(pool.intern("product_description"sv) == k);
+	}
+
+	// (including by several threads at once)
+	{
+		std::string many;
+		for (size_t i = 0; i < 100u; i++)
+			many += "a_rather_long_key_number_" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+
+		key_pool pool;
+		parse_options options;
+		options.interned_keys = &pool;
+		options.threads		  = 4u;
+
+		const auto results = toml::parse_many({ many, many, many, many }, options);
+		REQUIRE(results.size() == 4u);
+		CHECK(pool.size() == 100u);
+
+		const table& first = results[0];
+		const table& last  = results[3];
+		REQUIRE(first.size() == 100u);
+		for (auto&& [k, v] : first)
+			CHECK(last.find(k.str())->first.data() == k.data());
+	}
+
+	// keys made any other way don't
+	{
+		const auto a = key{ "product_description"sv };
+		const auto b = key{ "product_description"sv };
+		CHECK(a == b);
+		CHECK(a.data() != b.data());
+		CHECK(key{ a }.data() == a.data());
+		CHECK(*a.end() == '\0');
+		CHECK(*key{ "sku"sv }.end() == '\0');
+		CHECK(key{ "a_key_of_fifteen"sv.substr(0u, 15u) }.length() == 15u);
+		CHECK(*key{ "a_key_of_fifteen"sv.substr(0u, 15u) }.end() == '\0');
+	}
+}
@@ -0,0 +1,173 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+#include "tests.hpp"
+
+namespace
+{
+	constexpr auto lazy_doc = R"(title = "TOML Example"
+enabled = true
+
+[server]
+host = "example.com"
+ports = [ 8000, 8001, 8002 ]
+limits = { rate = 1.5, burst = 10 }
+started = 1979-05-27T07:32:00Z
+
+[[servers]]
+name = "alpha"
+ip = "10.0.0.1"
+
+[[servers]]
+name = "beta"
+ip = """
+10.0.0.2"""
+
+[broken]
+bad = 1.e5
+)"sv;
+}
+
+TEST_CASE("parsing - lazy")
+{
+	// values are parsed on first lookup, and only the ones that are looked up
+	{
+		lazy_document doc{ lazy_doc, "lazy.toml"sv };
+		CHECK(!doc.failed());
+
+		CHECK(doc["title"] == "TOML Example"sv);
+		CHECK(doc["enabled"] == true);
+		CHECK(doc["server"]["host"] == "example.com"sv);
+		CHECK(doc["server"]["ports"][1] == 8001);
+		CHECK(doc["server"]["limits"]["rate"] == 1.5);
+		CHECK(doc.at_path("server.started").is_date_time());
+		CHECK(doc.at_path("servers[1].ip") == "10.0.0.2"sv);
+		CHECK(doc.at_path(toml::path{ "servers[0].name" }) == "alpha"sv);
+		CHECK(!doc["missing"]);
+		CHECK(!doc.at_path("server.missing.deeper"));
+		CHECK(!doc.failed());
+
+		// materialized values have the same source regions they'd have in a regular parse
+		auto expected = toml::parse(lazy_doc.substr(0, lazy_doc.find("[broken]")), "lazy.toml"sv);
+		const auto check_source = [&](std::string_view path)
+		{
+			INFO(path);
+			auto actual = doc.at_path(path).node();
+			REQUIRE(actual);
+			CHECK(actual->source().begin == expected.at_path(path).node()->source().begin);
+			CHECK(actual->source().end == expected.at_path(path).node()->source().end);
+#if TOML_ENABLE_SOURCES
+			REQUIRE(actual->source().path);
+			CHECK(*actual->source().path == "lazy.toml"sv);
+#endif
+		};
+		check_source("title");
+		check_source("enabled");
+		check_source("server.ports");
+		check_source("server.ports[2]");
+		check_source("server.limits.burst");
+		check_source("server.started");
+
+		// errors inside values are only raised when they're looked up (which includes looking up a table
+		// that contains them)
+#if TOML_EXCEPTIONS
+		CHECK_THROWS_AS(doc["broken"], parse_error);
+		CHECK(doc.failed());
+		CHECK_THROWS_AS(doc.table(), parse_error);
+#else
+		CHECK(!doc["broken"]);
+		CHECK(doc.failed());
+		CHECK(doc.error().source().begin == source_position{ 20, 9 });
+		CHECK(doc.error().source().path);
+
+		// table() leaves malformed values in the tree as default-constructed values
+		CHECK(doc.table().at_path("broken.bad") == 0.0);
+		CHECK(doc.error().source().begin == source_position{ 20, 9 });
+#endif
+	}
+
+	// looking up the whole document gives the same tree as toml::parse()
+	{
+		const auto doc_str = R"(
+			a = [ { b = "}" }, [ 'c' ], """]""" ] # ]
+			d = { e.f = 1979-05-27, g = 07:32:00 }
+			[h]
+			i = -inf
+			j = 0x10
+		)"sv;
+
+		lazy_document doc{ doc_str };
+		CHECK(doc.table() == toml::parse(doc_str));
+		CHECK(doc["a"][0]["b"] == "}"sv);
+		CHECK(!doc.failed());
+	}
+
+	// structural errors are still raised up-front
+	{
+#if TOML_EXCEPTIONS
+		CHECK_THROWS_AS(lazy_document{ "a = 1\na = 2"sv }, parse_error);
+		CHECK_THROWS_AS(lazy_document{ "a = [ 1, 2\nb = 3"sv }, parse_error);
+
+		// (including redefinitions of values that were skipped over, which aren't in the tree)
+		CHECK_THROWS_AS(lazy_document{ "a = 1\na.b = 2"sv }, parse_error);
+		CHECK_THROWS_AS(lazy_document{ "a = true\n[a]"sv }, parse_error);
+		CHECK_THROWS_AS(lazy_document{ "[x]\na.b = 'c'\n[x.a.b]"sv }, parse_error);
+		CHECK_THROWS_AS(lazy_document{ "a.b = 1979-05-27\n[a.b.c]"sv }, parse_error);
+		CHECK_NOTHROW(lazy_document{ "[x]\na = 1\n[y]\na = 1"sv });
+#else
+		lazy_document doc{ "a = 1\na = 2"sv };
+		CHECK(doc.failed());
+		CHECK(doc.error().source().begin.line == 2u);
+		CHECK(!doc["a"]);
+#endif
+	}
+
+	// string_at() reads strings that don't need parsing straight from the document, which can be borrowed
+	{
+		const std::string buffer{ R"(plain = "a b"
+literal = 'c:\d'
+escaped = "e\tf"
+multi = """
+g
+h"""
+multi_literal = '''
+i\j''''
+number = 1
+
+[t]
+inner = 'k'
+arr = [ 'l', "m" ]
+)" };
+
+		lazy_document doc{ borrow_document, buffer };
+		const auto in_buffer = [&](auto str) noexcept
+		{ return str && str->data() >= buffer.data() && str->data() + str->length() <= buffer.data() + buffer.length(); };
+
+		CHECK(doc.string_at("plain") == "a b"sv);
+		CHECK(in_buffer(doc.string_at("plain")));
+		CHECK(doc.string_at("literal") == "c:\\d"sv);
+		CHECK(in_buffer(doc.string_at("literal")));
+		CHECK(doc.string_at("multi") == "g\nh"sv);
+		CHECK(in_buffer(doc.string_at("multi")));
+		CHECK(doc.string_at("multi_literal") == "i\\j'"sv);
+		CHECK(in_buffer(doc.string_at("multi_literal")));
+		CHECK(doc.string_at(toml::path{ "t.inner" }) == "k"sv);
+		CHECK(in_buffer(doc.string_at("t.inner")));
+
+		// (anything else comes from the parsed value)
+		CHECK(doc.string_at("escaped") == "e\tf"sv);
+		CHECK(!in_buffer(doc.string_at("escaped")));
+		CHECK(doc.string_at("t.arr[1]") == "m"sv);
+		CHECK(!in_buffer(doc.string_at("t.arr[1]")));
+		CHECK(!doc.string_at("number"));
+		CHECK(!doc.string_at("missing"));
+		CHECK(!doc.string_at("t"));
+		CHECK(!doc.failed());
+
+		// the strings read straight from the document can still be looked up as usual
+		CHECK(doc["plain"] == "a b"sv);
+		CHECK(doc.table() == toml::parse(buffer));
+	}
+}
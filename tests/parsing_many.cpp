@@ -0,0 +1,126 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+#include "tests.hpp"
+
+namespace
+{
+	constexpr std::string_view many_docs[] = {
+		"a = 1"sv,
+		""sv,
+		"\xEF\xBB\xBF[a.b.c]\nd = 2\n[a]\nb.e = 3"sv, // (reusing a parser mustn't leak its implicit tables)
+		"[[a]]\nb = 1\n[[a]]\nc = { d = [ 1, 2 ] }\n"sv,
+		"a.b = 1\n[c]\nd = \"\"\"\nmulti\nline\"\"\"\n"sv,
+	};
+}
+
+TEST_CASE("parsing - many")
+{
+	std::vector<std::string_view> docs;
+	for (size_t i = 0; i < 20u; i++)
+		for (auto doc : many_docs)
+			docs.push_back(doc);
+
+	for (size_t threads : { 1u, 0u, 3u })
+	{
+		INFO("threads: "sv << threads)
+		parse_options options;
+		options.threads = threads;
+
+		auto results = toml::parse_many(docs, options);
+		REQUIRE(results.size() == docs.size());
+		for (size_t i = 0; i < docs.size(); i++)
+		{
+			INFO("doc "sv << i)
+			auto expected_result = toml::parse(docs[i]);
+			const auto& expected = table_of(expected_result);
+			const auto& tbl		 = table_of(results[i]);
+			CHECK(tbl == expected);
+			CHECK(tbl.source().begin == expected.source().begin);
+			CHECK(tbl.source().end == expected.source().end);
+		}
+	}
+
+	// keep_paths apply to every document
+	{
+		parse_options options;
+		options.threads = 2u;
+		options.keep_paths.emplace_back("a"sv);
+		auto results = toml::parse_many({ "a = 1\nb = 2"sv, "[a]\nc = 3\n[b]\nd = 4"sv }, options);
+		REQUIRE(results.size() == 2u);
+		CHECK(table_of(results[0]) == table_of(toml::parse("a = 1"sv)));
+		CHECK(table_of(results[1]) == table_of(toml::parse("[a]\nc = 3"sv)));
+	}
+
+	// errors (including for files that couldn't be read) are reported in input order
+	{
+		docs.insert(docs.begin() + 42, "a = 1\nb = [\n"sv);
+		docs.insert(docs.begin() + 77, "a = 1\nb = 2\na = 3\n"sv);
+
+		parse_options options;
+		options.threads = 4u;
+
+#if TOML_EXCEPTIONS
+		try
+		{
+			static_cast<void>(toml::parse_many(docs, options));
+			FORCE_FAIL("Expected parsing failure"sv);
+		}
+		catch (const parse_error& err)
+		{
+			CHECK(err.source().begin.line == 2u);
+		}
+
+		CHECK_THROWS_AS(toml::parse_files({ "this_file_does_not_exist.toml"sv }, options), parse_error);
+#else
+		auto results = toml::parse_many(docs, options);
+		REQUIRE(results.size() == docs.size());
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			INFO("doc "sv << i)
+			CHECK(!!results[i] == (i != 42u && i != 77u));
+		}
+		CHECK(results[42].error().source().begin.line == 2u);
+		CHECK(results[77].error().source().begin.line == 3u);
+		CHECK(table_of(results[43]) == table_of(toml::parse(docs[43])));
+
+		auto files = toml::parse_files({ "this_file_does_not_exist.toml"sv }, options);
+		REQUIRE(files.size() == 1u);
+		CHECK(!files[0]);
+		REQUIRE(files[0].error().source().path);
+		CHECK(*files[0].error().source().path == "this_file_does_not_exist.toml"sv);
+#endif
+	}
+
+	// errors can be collected instead, keeping the documents that parsed
+	{
+		parse_options options;
+		options.threads = 4u;
+
+		std::vector<optional<parse_error>> errors{ 3u };
+		auto results = toml::parse_many(docs.data(), docs.data() + docs.size(), errors, options);
+		REQUIRE(results.size() == docs.size());
+		REQUIRE(errors.size() == docs.size());
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			INFO("doc "sv << i)
+			CHECK(!!errors[i] == (i == 42u || i == 77u));
+			if (!errors[i])
+				CHECK(table_of(results[i]) == table_of(toml::parse(docs[i])));
+		}
+		REQUIRE(errors[42]);
+		CHECK(errors[42]->source().begin.line == 2u);
+		REQUIRE(errors[77]);
+		CHECK(errors[77]->source().begin.line == 3u);
+
+		const std::string_view paths[] = { "this_file_does_not_exist.toml"sv, "this_file_does_not_exist.toml"sv };
+		auto files = toml::parse_files(std::begin(paths), std::end(paths), errors, options);
+		REQUIRE(files.size() == 2u);
+		REQUIRE(errors.size() == 2u);
+		REQUIRE(errors[1]);
+		REQUIRE(errors[1]->source().path);
+		CHECK(*errors[1]->source().path == "this_file_does_not_exist.toml"sv);
+	}
+}
@@ -0,0 +1,171 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+#include "tests.hpp"
+
+namespace
+{
+	std::string make_parallel_doc(size_t records)
+	{
+		std::string doc = R"(title = "parallel"
+owner.name = "Tom"
+
+[settings]
+lines = """
+[not.a.header]
+[[nor.this]]
+"""
+matrix = [
+	[ 1, 2 ],
+[ 3, 4 ],
+]
+'literal "key"' = '''
+[still.not.a.header]'''
+)";
+
+		for (size_t i = 0; i < records; i++)
+		{
+			const auto n = std::to_string(i);
+			doc += "\n[[records]]\nid = " + n + "\nname = \"record " + n + "\"\ntags = [ \"a\", \"b\" ]\n";
+			doc += "point = { x = " + n + ", y = -" + n + " }\n";
+			doc += "  [records.meta] # comment [\ncreated = 1979-05-27T07:32:00Z\nratio = 0." + n + "\n";
+		}
+		doc += "\n[tail]\nend = true";
+		return doc;
+	}
+
+	table parse_with_threads(std::string_view doc, size_t threads = 4u)
+	{
+		parse_options options;
+		options.threads				 = threads;
+		options.min_bytes_per_thread = 1u;
+		return table_of(toml::parse(doc, options, "parallel.toml"sv));
+	}
+
+	void check_regions(const node& expected, const node& actual)
+	{
+		CHECK(expected.source().begin == actual.source().begin);
+		CHECK(expected.source().end == actual.source().end);
+#if TOML_ENABLE_SOURCES
+		REQUIRE(actual.source().path);
+		CHECK(*actual.source().path == *expected.source().path);
+#endif
+
+		if (auto tbl = expected.as_table())
+		{
+			for (auto&& [k, v] : *tbl)
+			{
+				auto it = actual.as_table()->find(k.str());
+				REQUIRE(it != actual.as_table()->end());
+				CHECK(it->first.source().begin == k.source().begin);
+				check_regions(v, it->second);
+			}
+		}
+		else if (auto arr = expected.as_array())
+		{
+			for (size_t i = 0; i < arr->size(); i++)
+				check_regions(*arr->get(i), *actual.as_array()->get(i));
+		}
+	}
+}
+
+TEST_CASE("parsing - parallel")
+{
+	// the same tree (and source regions) as parsing on one thread
+	{
+		const auto doc		= make_parallel_doc(100u);
+		const auto expected = toml::parse(doc, "parallel.toml"sv);
+		for (size_t threads : { 0u, 2u, 4u, 16u })
+		{
+			INFO("threads: "sv << threads)
+			const auto tbl = parse_with_threads(doc, threads);
+			CHECK(tbl == expected);
+			check_regions(expected, tbl);
+		}
+		CHECK(parse_with_threads(doc).at_path("records[99].meta.ratio") == 0.99);
+		CHECK(parse_with_threads(doc)["settings"]["lines"] == "[not.a.header]\n[[nor.this]]\n"sv);
+
+		// leading BOM
+		CHECK(parse_with_threads("\xEF\xBB\xBF"s + doc) == expected);
+	}
+
+	// sections that can't be parsed in isolation get the same treatment as they would on one thread
+	{
+		for (auto doc : { "[a.b.c]\nx = 1\n[a]\nb.d = 2\n"sv, // extends an implicit table
+						  "[a]\nb.c = 1\n[a.b.d]\ne = 2\n"sv,
+						  "[a]\nb = 1\n[c]\nd = 2\n[a.e]\n"sv,
+						  "a = { b = 1 }\n[c]\n[[d]]\n[[d]]\ne.f = 1\n[d.e]\n"sv })
+		{
+			INFO(doc)
+			parse_options options;
+			options.threads				 = 4u;
+			options.min_bytes_per_thread = 1u;
+
+#if TOML_EXCEPTIONS
+			std::optional<table> expected;
+			source_position expected_error{};
+			try
+			{
+				expected = toml::parse(doc);
+			}
+			catch (const parse_error& err)
+			{
+				expected_error = err.source().begin;
+			}
+
+			try
+			{
+				auto tbl = toml::parse(doc, options);
+				REQUIRE(expected);
+				CHECK(tbl == *expected);
+			}
+			catch (const parse_error& err)
+			{
+				CHECK(!expected);
+				CHECK(err.source().begin == expected_error);
+			}
+#else
+			auto expected = toml::parse(doc);
+			auto actual	  = toml::parse(doc, options);
+			REQUIRE(!!expected == !!actual);
+			if (expected)
+				CHECK(actual.table() == expected.table());
+			else
+			{
+				CHECK(actual.error().source().begin == expected.error().source().begin);
+				CHECK(actual.error().description() == expected.error().description());
+			}
+#endif
+		}
+	}
+
+	// errors are the same as they would have been on one thread (not just the first one a thread happened to see)
+	{
+		auto doc = make_parallel_doc(50u);
+		doc.insert(doc.find("id = 10\n"), "bad = 1.e5\n");
+		doc.insert(doc.find("id = 40\n"), "[\n");
+
+		parse_options options;
+		options.threads				 = 4u;
+		options.min_bytes_per_thread = 1u;
+
+#if TOML_EXCEPTIONS
+		CHECK_THROWS_AS(toml::parse(doc, options), parse_error);
+		try
+		{
+			static_cast<void>(toml::parse(doc, options));
+		}
+		catch (const parse_error& err)
+		{
+			CHECK(err.source().begin == source_position{ 107, 9 });
+		}
+#else
+		auto result = toml::parse(doc, options);
+		REQUIRE(!result);
+		CHECK(result.error().source().begin == source_position{ 107, 9 });
+		CHECK(result.error().description() == toml::parse(doc).error().description());
+#endif
+	}
+}
@@ -0,0 +1,244 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+#include "tests.hpp"
+
+namespace
+{
+	class event_recorder final : public sax_handler
+	{
+	  private:
+		void keys_to_string(const key* keys, size_t count)
+		{
+			for (size_t i = 0; i < count; i++)
+				events << (i ? "." : "") << keys[i].str();
+		}
+
+	  public:
+		std::stringstream events;
+		std::vector<source_region> key_sources;
+		std::vector<source_region> value_sources;
+
+		void on_table_header(const key* keys, size_t count, bool is_array_of_tables) override
+		{
+			events << (is_array_of_tables ? "[[" : "[");
+			keys_to_string(keys, count);
+			events << (is_array_of_tables ? "]] " : "] ");
+			for (size_t i = 0; i < count; i++)
+				key_sources.push_back(keys[i].source());
+		}
+
+		void on_key(const key* keys, size_t count) override
+		{
+			keys_to_string(keys, count);
+			events << "= ";
+			for (size_t i = 0; i < count; i++)
+				key_sources.push_back(keys[i].source());
+		}
+
+		void on_value(const node& val) override
+		{
+			val.visit([&](const auto& v) { events << v << ':' << v.type() << ' '; });
+			value_sources.push_back(val.source());
+		}
+
+		void on_array_begin() override
+		{
+			events << "< ";
+		}
+
+		void on_array_end() override
+		{
+			events << "> ";
+		}
+
+		void on_inline_table_begin() override
+		{
+			events << "{ ";
+		}
+
+		void on_inline_table_end() override
+		{
+			events << "} ";
+		}
+	};
+}
+
+#if TOML_EXCEPTIONS
+#define PARSE_EVENTS(doc, handler, ...) toml::parse(doc, handler, __VA_ARGS__)
+#else
+#define PARSE_EVENTS(doc, handler, ...) REQUIRE(!toml::parse(doc, handler, __VA_ARGS__))
+#endif
+
+TEST_CASE("parsing - sax")
+{
+	// events
+	{
+		event_recorder recorder;
+		PARSE_EVENTS(R"(
+			a = 1
+			b.c = [ 0x10, "two", [ 3.0 ], { d = true } ]
+			e = { f.g = 1979-05-27, h = [] }
+
+			[table.'quoted key']
+			i = 07:32:00
+
+			[[tables]]
+			j = 1979-05-27T07:32:00Z
+
+			[[tables]]
+		)"sv,
+					 recorder,
+					 "foo.toml"sv);
+
+		CHECK(recorder.events.str()
+			  == "a= 1:integer "
+				 "b.c= < 0x10:integer 'two':string < 3.0:floating-point > { d= true:boolean } > "
+				 "e= { f.g= 1979-05-27:date h= < > } "
+				 "[table.quoted key] i= 07:32:00:time "
+				 "[[tables]] j= 1979-05-27T07:32:00Z:date-time "
+				 "[[tables]] ");
+
+		// keys and values have their sources set just as they would in a tree
+		REQUIRE(recorder.key_sources.size() == 14u);
+#if TOML_ENABLE_SOURCES
+		CHECK(recorder.key_sources[0].begin == source_position{ 2, 4 });
+		CHECK(recorder.key_sources[0].end == source_position{ 2, 5 });
+		CHECK(recorder.key_sources[2].begin == source_position{ 3, 6 });
+		CHECK(recorder.key_sources[2].end == source_position{ 3, 7 });
+		CHECK(recorder.key_sources[8].begin == source_position{ 6, 5 });
+		CHECK(recorder.key_sources[8].end == source_position{ 6, 10 });
+		for (auto& src : recorder.key_sources)
+		{
+			REQUIRE(src.path);
+			CHECK(*src.path == "foo.toml"sv);
+		}
+#else
+		for (auto& src : recorder.key_sources)
+		{
+			CHECK(!src.begin);
+			CHECK(!src.path);
+		}
+#endif
+
+		REQUIRE(recorder.value_sources.size() == 8u);
+#if TOML_ENABLE_SOURCES
+		CHECK(recorder.value_sources[0].begin == source_position{ 2, 8 });
+		CHECK(recorder.value_sources[0].end == source_position{ 2, 9 });
+		CHECK(recorder.value_sources[2].begin == source_position{ 3, 18 });
+		CHECK(recorder.value_sources[2].end == source_position{ 3, 23 });
+		for (auto& src : recorder.value_sources)
+		{
+			REQUIRE(src.path);
+			CHECK(*src.path == "foo.toml"sv);
+		}
+#else
+		for (auto& src : recorder.value_sources)
+		{
+			CHECK(!src.begin);
+			CHECK(!src.path);
+		}
+#endif
+	}
+
+	// streams
+	{
+		std::stringstream ss;
+		ss << "a = [ 1, 2 ]"sv;
+
+		event_recorder recorder;
+		PARSE_EVENTS(ss, recorder, ""sv);
+		CHECK(recorder.events.str() == "a= < 1:integer 2:integer > ");
+	}
+
+	// errors
+	{
+		event_recorder recorder;
+
+#if TOML_EXCEPTIONS
+		try
+		{
+			toml::parse("a = 1\nb = [ 2\nc = 3"sv, recorder);
+			FAIL("Expected parsing failure");
+		}
+		catch (const parse_error& err)
+		{
+			CHECK(err.source().begin == source_position{ 3, 1 });
+		}
+#else
+		auto err = toml::parse("a = 1\nb = [ 2\nc = 3"sv, recorder);
+		REQUIRE(err);
+		CHECK(err->source().begin == source_position{ 3, 1 });
+#endif
+
+		// everything before the error has been seen
+		CHECK(recorder.events.str() == "a= 1:integer b= < 2:integer ");
+	}
+
+	// redefinitions etc. are still diagnosed, exactly as they are when building a tree
+	{
+		sax_handler handler;
+
+		static constexpr auto same_error = [](std::string_view doc)
+		{
+			INFO(doc);
+
+			sax_handler h;
+			std::optional<parse_error> expected, actual;
+#if TOML_EXCEPTIONS
+			try
+			{
+				[[maybe_unused]] auto tbl = toml::parse(doc);
+			}
+			catch (const parse_error& err)
+			{
+				expected = err;
+			}
+			try
+			{
+				toml::parse(doc, h);
+			}
+			catch (const parse_error& err)
+			{
+				actual = err;
+			}
+#else
+			if (auto result = toml::parse(doc); !result)
+				expected = result.error();
+			actual = toml::parse(doc, h);
+#endif
+			REQUIRE(expected);
+			REQUIRE(actual);
+			CHECK(actual->description() == expected->description());
+			CHECK(actual->source().begin == expected->source().begin);
+		};
+
+		same_error("a = 1\na = 'one'"sv);
+		same_error("a = 1\n[a]"sv);
+		same_error("a = 1\n[[a]]"sv);
+		same_error("a = 1\n[a.b]"sv);
+		same_error("a = 1\na.b = 2"sv);
+		same_error("a = [ 1 ]\n[[a]]"sv);
+		same_error("a = { b = 1 }\n[a]"sv);
+		same_error("a = [ { b.c = 1, b.c = 2 } ]"sv);
+		same_error("a = { b = 1, b.c = 2 }"sv);
+		same_error("[a.b.c]\n[a]\nb.d = 1\n[a.b]"sv);
+
+		// (inline tables in arrays are thrown away as soon as they've been parsed, so the next one might well be
+		// allocated in the same place)
+		PARSE_EVENTS("a = [ { b = 1 }, { b = 2 }, { c = { d = 3 } }, { c = { d = 4 } } ]"sv, handler, ""sv);
+	}
+
+	// files
+	{
+		sax_handler handler;
+
+#if TOML_EXCEPTIONS
+		CHECK_THROWS_AS(toml::parse_file("this_file_does_not_exist.toml"sv, handler), parse_error);
+#else
+		CHECK(toml::parse_file("this_file_does_not_exist.toml"sv, handler));
+#endif
+	}
+}
@@ -155,6 +155,52 @@ str = ''''That's still pointless', she said.'''
 
 	parse_expected_value(FILE_LINE_ARGS, R"("\"\u03B1\u03B2\u03B3\"")"sv, "\"\u03B1\u03B2\u03B3\""sv);
 
+	// invalid utf-8 a few input blocks into a string of valid multi-byte sequences (a surrogate after '\u00E9' x20, '\u20AC' x20)
+	parsing_should_fail(FILE_LINE_ARGS,
+						"str = \""
+						"\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9"
+						"\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9"
+						"\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC"
+						"\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC"
+						"\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC"
+						"\xED\xA0\x80\""sv,
+						1,
+						47);
+
+	// long runs of plain characters broken up by escapes, quotes and line endings
+	parsing_should_succeed(
+		FILE_LINE_ARGS,
+		"str1 = \"\"\"\n"
+		"MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAwJ8z9v4s2b5hYq1f3c8e0r6t7u1i2o3p4a5s6d7f8g9h0j1k\n"
+		"SELECT \"id\", 'name' FROM \"\"users\"\" WHERE x = '\\u00E9\\t\u00E9' AND y <> \\\"z\\\"; \\\n"
+		"     \t  continued on the next line \\\\ with a trailing backslash\"\"\"\n"
+		"str2 = '''\n"
+		"C:\\Users\\nobody\\AppData\\Local\\Temp\\some\\very\\long\\path\\that\\spans\\several\\input\\blocks\n"
+		"it's got 'quotes' and ''doubled quotes'' too\t\u00E9'''\n"
+		"str3 = \"the quick brown fox jumps over the lazy dog, the quick brown fox jumps over the \\\"lazy\\\" dog\"\n"sv,
+		[](table&& tbl)
+		{
+			CHECK(tbl["str1"]
+				  == "MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAwJ8z9v4s2b5hYq1f3c8e0r6t7u1i2o3p4a5s6d7f8g9h0j1k\n"
+					 "SELECT \"id\", 'name' FROM \"\"users\"\" WHERE x = '\u00E9\t\u00E9' AND y <> \"z\"; "
+					 "continued on the next line \\ with a trailing backslash"sv);
+			CHECK(tbl["str2"]
+				  == "C:\\Users\\nobody\\AppData\\Local\\Temp\\some\\very\\long\\path\\that\\spans\\several\\input\\blocks\n"
+					 "it's got 'quotes' and ''doubled quotes'' too\t\u00E9"sv);
+			CHECK(tbl["str3"]
+				  == "the quick brown fox jumps over the lazy dog, the quick brown fox jumps over the \"lazy\" dog"sv);
+		});
+
+	// control characters after a long run of plain characters
+	parsing_should_fail(FILE_LINE_ARGS,
+						"str = \"the quick brown fox jumps over the lazy dog, the quick brown fox \x01\""sv,
+						1,
+						73);
+	parsing_should_fail(FILE_LINE_ARGS,
+						"str = '''\nthe quick brown fox jumps over the lazy dog, the quick brown fox \x7F'''"sv,
+						2,
+						66);
+
 // toml/pull/796 (\xHH unicode scalars)
 #if TOML_LANG_UNRELEASED
 	parse_expected_value(FILE_LINE_ARGS,
@@ -208,4 +254,31 @@ str = ''''That's still pointless', she said.'''
 	parsing_should_fail(FILE_LINE_ARGS, R"(v= '''''' '''       )"sv);
 	parse_expected_value(FILE_LINE_ARGS, R"( """""\""""""     )"sv, R"(""""")"sv);
 	parse_expected_value(FILE_LINE_ARGS, R"( """""\"""\"""""" )"sv, R"("""""""")"sv);
+
+	// plain strings and bare keys are taken straight from the source when they can be,
+	// so check the ones that end right at the end of the input or next to other tokens
+	parse_expected_value(FILE_LINE_ARGS, R"("plain")"sv, "plain"sv);
+	parse_expected_value(FILE_LINE_ARGS, R"('plain')"sv, "plain"sv);
+	parse_expected_value(FILE_LINE_ARGS, R"("")"sv, ""sv);
+	parse_expected_value(FILE_LINE_ARGS, R"('')"sv, ""sv);
+	parse_expected_value(FILE_LINE_ARGS, R"("plain then \"escaped\"")"sv, R"(plain then "escaped")"sv);
+	parse_expected_value(FILE_LINE_ARGS, R"("k\u00E9y")"sv, "k\u00E9y"sv);
+	parsing_should_fail(FILE_LINE_ARGS, R"(str = "unterminated)"sv);
+	parsing_should_fail(FILE_LINE_ARGS, R"(str = 'unterminated)"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "str = \"line\nbreak\""sv);
+	parsing_should_succeed(FILE_LINE_ARGS,
+						   R"(a="b"
+'c'='d'#comment
+"e".f={g=""}
+h=["i",'j']
+k.l.m="n")"sv,
+						   [](table&& tbl)
+						   {
+							   CHECK(tbl["a"] == "b"sv);
+							   CHECK(tbl["c"] == "d"sv);
+							   CHECK(tbl["e"]["f"]["g"] == ""sv);
+							   CHECK(tbl["h"][0] == "i"sv);
+							   CHECK(tbl["h"][1] == "j"sv);
+							   CHECK(tbl["k"]["l"]["m"] == "n"sv);
+						   });
 }
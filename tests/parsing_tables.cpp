@@ -301,6 +301,58 @@ TEST_CASE("parsing - tables")
 						   });
 }
 
+TEST_CASE("parsing - many sibling tables")
+{
+	static constexpr size_t count = 2000;
+
+	// implicitly-created tables being defined later, dotted key tables being extended, and table arrays being
+	// appended to, all well after the fact
+	std::string doc;
+	for (size_t i = 0; i < count; i++)
+		doc += "[implicit.t" + std::to_string(i) + ".x]\n";
+	for (size_t i = 0; i < count; i++)
+		doc += "[implicit.t" + std::to_string(i) + "]\ny = 1\n";
+	doc += "[dotted]\n";
+	for (size_t i = 0; i < count; i++)
+		doc += "t" + std::to_string(i) + ".x = 1\n";
+	for (size_t i = 0; i < count; i++)
+		doc += "t" + std::to_string(i) + ".y = 2\n";
+	for (size_t i = 0; i < 2u * count; i++)
+		doc += "[[arrays.t" + std::to_string(i % count) + "]]\n";
+
+	parsing_should_succeed(FILE_LINE_ARGS,
+						   doc,
+						   [](table&& tbl)
+						   {
+							   REQUIRE(tbl["implicit"].as_table());
+							   REQUIRE(tbl["dotted"].as_table());
+							   REQUIRE(tbl["arrays"].as_table());
+							   CHECK(tbl["implicit"].as_table()->size() == count);
+							   CHECK(tbl["dotted"].as_table()->size() == count);
+							   CHECK(tbl["arrays"].as_table()->size() == count);
+							   for (size_t i = 0; i < count; i++)
+							   {
+								   const auto key = "t" + std::to_string(i);
+								   CHECK(tbl["implicit"][key]["x"].as_table());
+								   CHECK(tbl["implicit"][key]["y"] == 1);
+								   CHECK(tbl["dotted"][key]["x"] == 1);
+								   CHECK(tbl["dotted"][key]["y"] == 2);
+								   REQUIRE(tbl["arrays"][key].as_array());
+								   CHECK(tbl["arrays"][key].as_array()->size() == 2u);
+							   }
+						   });
+
+	// (each can only be defined once)
+	parsing_should_fail(FILE_LINE_ARGS, doc + "[implicit.t" + std::to_string(count - 1u) + "]\n");
+	parsing_should_fail(FILE_LINE_ARGS, doc + "[implicit.t0]\n");
+	parsing_should_fail(FILE_LINE_ARGS, doc + "[dotted.t0]\n");
+
+	// dotted key tables in inline tables are forgotten once the inline table ends
+	parsing_should_succeed(FILE_LINE_ARGS, "a = [ { b.c = 1, b.d = 2 }, { b.c = 3 } ]\ne = { f.g = 4 }\n"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "a = { b.c = 1 }\na.b.d = 2\n"sv);
+	parsing_should_fail(FILE_LINE_ARGS, "a = { b = { c.d = 1 }, b.c.e = 2 }\n"sv);
+}
+
 TEST_CASE("parsing - redefinition error messages preserve quoted keys")
 {
 	// https://github.com/marzer/tomlplusplus/issues/300
@@ -611,8 +663,14 @@ e = { f.g = 79.5, h = 72.0 }
 							   {
 								   const toml::key& found_key = t.as_table()->find(k)->first;
 								   CHECK(found_key.str() == k);
+#if TOML_ENABLE_SOURCES
 								   CHECK(found_key.source().begin == b);
 								   CHECK(found_key.source().end == e);
+#else
+								   CHECK(!found_key.source().begin);
+								   static_cast<void>(b);
+								   static_cast<void>(e);
+#endif
 								   CHECK(found_key.source().path == tbl.source().path);
 							   };
 
@@ -626,3 +684,195 @@ e = { f.g = 79.5, h = 72.0 }
 							   check_key(tbl["a"]["b"]["e"], "h", { 5, 19 }, { 5, 20 });
 						   });
 }
+
+namespace
+{
+	void check_no_sources(const node& nde)
+	{
+		CHECK(nde.source().begin == source_position{});
+		CHECK(nde.source().end == source_position{});
+		CHECK(!nde.source().path);
+
+		if (auto tbl = nde.as_table())
+		{
+			for (auto&& [k, v] : *tbl)
+			{
+				CHECK(k.source().begin == source_position{});
+				CHECK(!k.source().path);
+				check_no_sources(v);
+			}
+		}
+		else if (auto arr = nde.as_array())
+		{
+			for (auto&& v : *arr)
+				check_no_sources(v);
+		}
+	}
+}
+
+TEST_CASE("parsing - without source regions")
+{
+	static constexpr auto doc = R"(
+		title = "no sources"
+		a.b.c = 1
+
+		[table]
+		array = [ 1, { x = 2 }, [ 3 ] ]
+		inline = { y = 4 }
+
+		[[tables]]
+		z = 5
+		[[tables]]
+		a_key_long_enough_to_be_interned = 6
+
+		[implicit.child]
+		[implicit]
+		w = 7
+	)"sv;
+
+	const auto expected_result = toml::parse(doc, "sources.toml"sv);
+	const table& expected	   = expected_result;
+#if TOML_ENABLE_SOURCES
+	REQUIRE(expected.source().path);
+#endif
+
+	parse_options options;
+	options.omit_sources = true;
+
+	for (size_t threads : { 1u, 4u })
+	{
+		INFO("threads: "sv << threads)
+		options.threads = threads;
+
+		const auto result = toml::parse(doc, options, "sources.toml"sv);
+		const table& tbl  = result;
+		CHECK(tbl == expected);
+		check_no_sources(tbl);
+	}
+
+	// errors still say where they are
+	options.threads = 1u;
+#if TOML_EXCEPTIONS
+	try
+	{
+		[[maybe_unused]] auto tbl = toml::parse("a = 1\nb = ?"sv, options, "bad.toml"sv);
+		FAIL("expected a parse error");
+	}
+	catch (const parse_error& err)
+	{
+		CHECK(err.source().begin == source_position{ 2, 5 });
+		REQUIRE(err.source().path);
+		CHECK(*err.source().path == "bad.toml"sv);
+	}
+#else
+	const auto result = toml::parse("a = 1\nb = ?"sv, options, "bad.toml"sv);
+	REQUIRE(!result);
+	CHECK(result.error().source().begin == source_position{ 2, 5 });
+	REQUIRE(result.error().source().path);
+	CHECK(*result.error().source().path == "bad.toml"sv);
+#endif
+}
+
+#if TOML_ENABLE_SOURCES
+
+TEST_CASE("parsing - source paths")
+{
+	static constexpr auto doc = "a = 1\n[b]\nc = [ 2 ]"sv;
+
+	// (long enough not to fit in a std::string's inline buffer)
+	static constexpr auto long_path = "a/path/that/is/long/enough/to/need/a/heap/allocation/of/its/own/paths.toml"sv;
+
+	std::weak_ptr<const std::string> weak_path;
+	{
+		auto result		 = toml::parse(doc, "paths.toml"sv);
+		table& tbl		 = result;
+		const auto& path = tbl.source().path;
+		REQUIRE(path);
+		CHECK(*path == "paths.toml"sv);
+
+		// the root table owns the document's path, and everything else in it borrows the same one
+		CHECK(path.use_count() == 1);
+		CHECK(tbl["b"]["c"][0].node()->source().path == path);
+		CHECK(tbl.begin()->first.source().path == path);
+		CHECK(tbl["b"]["c"][0].node()->source().path.use_count() == 1);
+
+		// copying a borrowed path takes a reference to it
+		{
+			const auto copy = tbl.begin()->first.source().path;
+			CHECK(copy == path);
+			CHECK(path.use_count() == 2);
+
+			const std::shared_ptr<const std::string> shared = tbl["b"].node()->source().path;
+			CHECK(shared.get() == path.get());
+			CHECK(path.use_count() == 3);
+		}
+		CHECK(path.use_count() == 1);
+
+		// documents parsed from the same path each get their own copy of it
+		const auto other_result = toml::parse(doc, std::string{ "paths.toml" });
+		CHECK(static_cast<const table&>(other_result).source().path != path);
+		CHECK(*static_cast<const table&>(other_result).source().path == "paths.toml"sv);
+
+		const auto no_path_result = toml::parse(doc);
+		CHECK(!static_cast<const table&>(no_path_result).source().path);
+
+		weak_path = std::shared_ptr<const std::string>{ path };
+		CHECK(!weak_path.expired());
+	}
+
+	// and it's freed along with the document
+	CHECK(weak_path.expired());
+
+	// copies of the document's keys and regions keep the path alive on their own
+	{
+		table copy;
+		source_region region;
+		{
+			auto result = toml::parse(doc, long_path);
+			table& tbl	= result;
+			weak_path	= std::shared_ptr<const std::string>{ tbl.source().path };
+			copy		= tbl;
+			region		= tbl["a"].node()->source();
+		}
+		CHECK(!weak_path.expired());
+		REQUIRE(copy.begin()->first.source().path);
+		CHECK(*copy.begin()->first.source().path == long_path);
+		REQUIRE(region.path);
+		CHECK(*region.path == long_path);
+	}
+	CHECK(weak_path.expired());
+
+	// as do nodes moved out of it (along with everything beneath them)
+	const auto check_moved_out = [&](const parse_options& options)
+	{
+		std::optional<table> b;
+		std::optional<value<int64_t>> a;
+		{
+			auto result = toml::parse(doc, options, long_path);
+			table& tbl	= result;
+			weak_path	= std::shared_ptr<const std::string>{ tbl.source().path };
+			b			= std::move(*tbl["b"].as_table());
+			a			= std::move(*tbl["a"].as_integer());
+		}
+		CHECK(!weak_path.expired());
+		CHECK(*(*b)["c"].node()->source().path == long_path);
+		CHECK(*(*b)["c"][0].node()->source().path == long_path);
+		CHECK(*a->source().path == long_path);
+
+		b.reset();
+		CHECK(!weak_path.expired());
+		a.reset();
+		CHECK(weak_path.expired());
+	};
+	check_moved_out(parse_options{});
+
+#if TOML_ENABLE_ARENA
+	{
+		parse_options options;
+		options.use_arena = true;
+		check_moved_out(options);
+	}
+#endif
+}
+
+#endif // TOML_ENABLE_SOURCES
@@ -21,6 +21,13 @@
 #undef LEAK_TESTS
 #define LEAK_TESTS 0
 #endif
+// (both of these default to 0 in the library itself; tests/meson.build builds a variant that leaves them that way)
+#ifndef TOML_ENABLE_THREADS
+#define TOML_ENABLE_THREADS 1
+#endif
+#ifndef TOML_ENABLE_ARENA
+#define TOML_ENABLE_ARENA 1
+#endif
 #ifdef _MSC_VER
 #define TOML_CALLCONV __stdcall // just to test that TOML_CALLCONV doesn't cause linker failures
 #endif
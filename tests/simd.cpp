@@ -0,0 +1,203 @@
+// This file is a part of toml++ and is subject to the the terms of the MIT license.
+// Copyright (c) Mark Gillard <mark.gillard@outlook.com.au>
+// See https://github.com/marzer/tomlplusplus/blob/master/LICENSE for the full license text.
+// SPDX-License-Identifier: MIT
+
+#include "tests.hpp"
+
+namespace
+{
+	using simd_level = toml::impl::simd_level;
+
+	// every supported level is checked against the scalar kernels, at every length up to a few vectors wide
+	// and with the interesting byte at every position and with a few different (mis)alignments.
+	template <typename Func>
+	void for_each_simd_level(Func&& func)
+	{
+		const auto& scalar = *toml::impl::get_simd_kernels(simd_level::scalar);
+		for (auto level : { simd_level::sse2, simd_level::avx2, simd_level::avx512bw })
+		{
+			if (const auto kernels = toml::impl::get_simd_kernels(level))
+			{
+				INFO("simd level " << static_cast<int>(level));
+				func(*kernels, scalar);
+			}
+		}
+	}
+
+	template <typename Func>
+	void for_each_needle(std::string_view filler, std::string_view needles, Func&& func)
+	{
+		char buf[256 + 8];
+		for (size_t offset = 0; offset < 4u; offset++)
+		{
+			for (size_t len = 0; len <= 200u; len++)
+			{
+				char* const begin = buf + offset;
+				for (size_t i = 0; i < len; i++)
+					begin[i] = filler[i % filler.length()];
+
+				const auto check = [&]() noexcept
+				{ return func(static_cast<const char*>(begin), static_cast<const char*>(begin + len)) ? 0u : 1u; };
+
+				size_t mismatches = check();
+				for (auto needle : needles)
+				{
+					for (size_t pos = 0; pos < len; pos++)
+					{
+						const char prev = begin[pos];
+						begin[pos]		= needle;
+						mismatches += check();
+						begin[pos] = prev;
+					}
+				}
+
+				INFO("offset " << offset << ", length " << len);
+				CHECK(mismatches == 0u);
+			}
+		}
+	}
+}
+
+TEST_CASE("simd - kernel selection")
+{
+	REQUIRE(toml::impl::get_simd_kernels(simd_level::scalar) != nullptr);
+
+	const auto original = toml::impl::simd().level;
+	CHECK(toml::impl::get_simd_kernels(original) == &toml::impl::simd());
+
+	CHECK(toml::impl::set_simd_level(simd_level::scalar));
+	CHECK(toml::impl::simd().level == simd_level::scalar);
+	parsing_should_succeed(FILE_LINE_ARGS, "a = 'b' # c"sv);
+
+	CHECK(toml::impl::set_simd_level(original));
+	CHECK(toml::impl::simd().level == original);
+}
+
+TEST_CASE("simd - is_ascii")
+{
+	for_each_simd_level(
+		[](const toml::impl::simd_kernels& kernels, const toml::impl::simd_kernels& scalar)
+		{
+			for_each_needle("key = \"value\"\t# comment\n"sv,
+							"\x80\xFF"sv,
+							[&](const char* begin, const char* end)
+							{
+								const auto len = static_cast<size_t>(end - begin);
+								return kernels.is_ascii(begin, len) == scalar.is_ascii(begin, len);
+							});
+		});
+}
+
+TEST_CASE("simd - find_invalid_utf8")
+{
+	for_each_simd_level(
+		[](const toml::impl::simd_kernels& kernels, const toml::impl::simd_kernels& scalar)
+		{
+			for_each_needle("k\xC3\xA9y = \xE2\x82\xAC\xF0\x9F\x98\x80"sv,
+							"\x80\xC0\xED\xF4\xFF"sv,
+							[&](const char* begin, const char* end)
+							{ return kernels.find_invalid_utf8(begin, end) == scalar.find_invalid_utf8(begin, end); });
+		});
+
+	// mostly-valid text with a few random bytes scribbled over it
+	for_each_simd_level(
+		[](const toml::impl::simd_kernels& kernels, const toml::impl::simd_kernels& scalar)
+		{
+			constexpr std::string_view pieces[]{ "a"sv,
+												 " "sv,
+												 "\xC3\xA9"sv,
+												 "\xE2\x82\xAC"sv,
+												 "\xED\x9F\xBF"sv,
+												 "\xE0\xA0\x80"sv,
+												 "\xF0\x9F\x98\x80"sv,
+												 "\xF4\x8F\xBF\xBF"sv };
+			uint32_t rng = 12345u;
+			const auto next = [&]() noexcept
+			{
+				rng = rng * 1664525u + 1013904223u;
+				return rng >> 8;
+			};
+
+			size_t mismatches = 0;
+			for (size_t i = 0; i < 5000u; i++)
+			{
+				std::string str;
+				const size_t len = next() % 300u;
+				while (str.length() < len)
+					str.append(pieces[next() % std::size(pieces)]);
+				for (auto corruptions = next() % 3u; corruptions && !str.empty(); corruptions--)
+					str[next() % str.length()] = static_cast<char>(next() & 0xFFu);
+				if (next() % 4u == 0u && !str.empty())
+					str.pop_back();
+
+				const auto begin = str.data();
+				const auto end	 = str.data() + str.length();
+				if (kernels.find_invalid_utf8(begin, end) != scalar.find_invalid_utf8(begin, end))
+					mismatches++;
+			}
+			CHECK(mismatches == 0u);
+		});
+
+	// spot-check the scalar kernel itself
+	const auto& scalar = *toml::impl::get_simd_kernels(simd_level::scalar);
+	const auto check   = [&](std::string_view str, size_t expected)
+	{ CHECK(scalar.find_invalid_utf8(str.data(), str.data() + str.length()) == str.data() + expected); };
+	check(""sv, 0u);
+	check("abc"sv, 3u);
+	check("a\xC3\xA9"sv, 3u);
+	check("a\xC3"sv, 1u);			  // truncated
+	check("ab\xC3\x28"sv, 2u);		  // bad continuation
+	check("abcdefghij\x80"sv, 10u);	  // stray continuation after an ascii run
+	check("\xED\xA0\x80"sv, 0u);	  // surrogate
+	check("\xC0\xAF"sv, 0u);		  // overlong
+	check("\xF4\x90\x80\x80"sv, 0u);  // > U+10FFFF
+}
+
+TEST_CASE("simd - find_non_whitespace")
+{
+	for_each_simd_level(
+		[](const toml::impl::simd_kernels& kernels, const toml::impl::simd_kernels& scalar)
+		{
+			for_each_needle(" \t  "sv,
+							"a\n\r\x0B\x80"sv,
+							[&](const char* begin, const char* end)
+							{
+								return kernels.find_non_whitespace(begin, end)
+									   == scalar.find_non_whitespace(begin, end);
+							});
+		});
+}
+
+TEST_CASE("simd - find_comment_terminator")
+{
+	for_each_simd_level(
+		[](const toml::impl::simd_kernels& kernels, const toml::impl::simd_kernels& scalar)
+		{
+			for_each_needle("a comment\twith tabs \xC3\xA9 "sv,
+							"\n\r\x00\x01\x1F\x7F"sv,
+							[&](const char* begin, const char* end)
+							{
+								return kernels.find_comment_terminator(begin, end)
+									   == scalar.find_comment_terminator(begin, end);
+							});
+		});
+}
+
+TEST_CASE("simd - find_string_terminator")
+{
+	for_each_simd_level(
+		[](const toml::impl::simd_kernels& kernels, const toml::impl::simd_kernels& scalar)
+		{
+			for (auto [delim, escape] : { std::pair{ '"', '\\' }, std::pair{ '\'', '\'' } })
+			{
+				for_each_needle("some string\tcontent \xE2\x82\xAC "sv,
+								"\"'\\\n\x00\x7F"sv,
+								[&](const char* begin, const char* end)
+								{
+									return kernels.find_string_terminator(begin, end, delim, escape)
+										   == scalar.find_string_terminator(begin, end, delim, escape);
+								});
+			}
+		});
+}
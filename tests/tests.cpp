@@ -4,6 +4,183 @@
 // SPDX-License-Identifier: MIT
 
 #include "tests.hpp"
+#include <optional>
+
+namespace
+{
+	// feeds the document to an incremental parser one byte at a time
+	parse_result parse_incrementally(std::string_view toml_str, std::string_view source_path = {})
+	{
+		incremental_parser parser{ source_path };
+		for (size_t i = 0; i < toml_str.length(); i++)
+			parser.feed(toml_str.substr(i, 1u));
+		return parser.finish();
+	}
+
+	// rebuilds a document from the events it produces, for comparing with the tree-building parser
+	class table_builder final : public sax_handler
+	{
+	  private:
+		table* current_ = &root;
+		std::vector<node*> open_; // arrays and inline tables
+		std::vector<key> keys_;
+
+		static table& descend(table& tbl, const key* keys, size_t count)
+		{
+			table* t = &tbl;
+			for (size_t i = 0; i < count; i++)
+			{
+				node& n = t->emplace<table>(keys[i]).first->second;
+				t		= n.is_array() ? n.as_array()->back().as_table() : n.as_table();
+			}
+			return *t;
+		}
+
+		template <typename T>
+		impl::remove_cvref<T>& add(T&& val)
+		{
+			using node_type = impl::remove_cvref<T>;
+
+			if (!open_.empty() && open_.back()->is_array())
+				return open_.back()->as_array()->emplace_back<node_type>(static_cast<T&&>(val));
+
+			table& tbl = descend(open_.empty() ? *current_ : *open_.back()->as_table(),
+								 keys_.data(),
+								 keys_.size() - 1u);
+			return *tbl.emplace<node_type>(keys_.back(), static_cast<T&&>(val)).first->second.template as<node_type>();
+		}
+
+	  public:
+		table root;
+
+		void on_table_header(const key* keys, size_t count, bool is_array_of_tables) override
+		{
+			table& parent = descend(root, keys, count - 1u);
+			if (is_array_of_tables)
+				current_ = &parent.emplace<array>(keys[count - 1u]).first->second.as_array()->emplace_back<table>();
+			else
+				current_ = &descend(parent, keys + (count - 1u), 1u);
+		}
+
+		void on_key(const key* keys, size_t count) override
+		{
+			keys_.assign(keys, keys + count);
+		}
+
+		void on_value(const node& val) override
+		{
+			val.visit([&](const auto& v) { add(v); });
+		}
+
+		void on_array_begin() override
+		{
+			open_.push_back(&add(array{}));
+		}
+
+		void on_array_end() override
+		{
+			open_.pop_back();
+		}
+
+		void on_inline_table_begin() override
+		{
+			table& tbl = add(table{});
+			tbl.is_inline(true);
+			open_.push_back(&tbl);
+		}
+
+		void on_inline_table_end() override
+		{
+			open_.pop_back();
+		}
+	};
+
+	// the parsers that don't return a parse_result, adapted to return one (so with exceptions enabled, errors are
+	// thrown and the result is just a table)
+	parse_result parse_with_handler(std::string_view toml_str, sax_handler& handler, std::string_view source_path = {})
+	{
+#if TOML_EXCEPTIONS
+		toml::parse(toml_str, handler, source_path);
+#else
+		if (auto err = toml::parse(toml_str, handler, source_path))
+			return parse_result{ *std::move(err) };
+#endif
+		return parse_result{ table{} };
+	}
+
+	parse_result parse_lazily(lazy_document& doc)
+	{
+		auto& tbl = doc.table();
+#if TOML_EXCEPTIONS
+		CHECK(!doc.failed());
+#else
+		if (doc.failed())
+			return parse_result{ parse_error{ doc.error() } };
+#endif
+		return parse_result{ std::move(tbl) };
+	}
+
+	// checks lazy_document::string_at() finds every string beneath a node of the expected table
+	void check_string_at(lazy_document& doc, const node& nde, toml::path& path)
+	{
+		if (auto str = nde.as_string())
+		{
+			INFO(path.str())
+			CHECK(doc.string_at(path) == std::string_view{ str->get() });
+		}
+		else if (auto tbl = nde.as_table())
+		{
+			path += "_"sv;
+			for (auto&& [k, v] : *tbl)
+			{
+				path[path.size() - 1u] = k.str();
+				check_string_at(doc, v, path);
+			}
+			path.truncate(1u);
+		}
+		else if (auto arr = nde.as_array())
+		{
+			path += "[0]"sv;
+			for (size_t i = 0; i < arr->size(); i++)
+			{
+				path[path.size() - 1u] = i;
+				check_string_at(doc, (*arr)[i], path);
+			}
+			path.truncate(1u);
+		}
+	}
+
+	// runs one of the parsers, reporting an error as a test failure
+	template <typename Func>
+	std::optional<table> parse_or_fail(Func&& parse)
+	{
+		const auto fail = [](const parse_error& err)
+		{
+			FORCE_FAIL("Parse error on line "sv << err.source().begin.line << ", column "sv << err.source().begin.column
+												<< ":\n"sv << err.description());
+		};
+
+#if TOML_EXCEPTIONS
+		try
+		{
+			return std::optional<table>{ parse() };
+		}
+		catch (const parse_error& err)
+		{
+			fail(err);
+			return {};
+		}
+#else
+		parse_result result = parse();
+		if (!result)
+		{
+			fail(result.error());
+			return {};
+		}
+		return std::optional<table>{ std::move(result).table() };
+#endif
+	}
+}
 
 bool parsing_should_succeed(std::string_view test_file,
 							uint32_t test_line,
@@ -14,92 +191,115 @@ bool parsing_should_succeed(std::string_view test_file,
 	INFO("["sv << test_file << ", line "sv << test_line << "] "sv
 			   << "parsing_should_succeed(\""sv << toml_str << "\")"sv)
 
-	constexpr auto validate_table = [](table&& tabl, std::string_view path) -> table&&
+	const auto validate_table = [&](const table& tabl)
 	{
 		INFO("Validating table source information"sv)
+#if TOML_ENABLE_SOURCES
 		CHECK(tabl.source().begin != source_position{});
 		CHECK(tabl.source().end != source_position{});
-		if (path.empty())
+		if (source_path.empty())
 			CHECK(tabl.source().path == nullptr);
 		else
 		{
 			REQUIRE(tabl.source().path != nullptr);
-			CHECK(*tabl.source().path == path);
+			CHECK(*tabl.source().path == source_path);
 		}
-		return std::move(tabl);
+#else
+		CHECK(tabl.source().begin == source_position{});
+		CHECK(tabl.source().end == source_position{});
+		CHECK(tabl.source().path == nullptr);
+#endif
 	};
 
-#if TOML_EXCEPTIONS
+	const auto expected = parse_or_fail([&]() { return toml::parse(toml_str, source_path); });
+	if (!expected)
+		return false;
 
-	try
+	// every other way of parsing the document should give the same table
+	const auto check = [&](std::string_view description, auto&& parse, bool call_func)
 	{
+		INFO(description)
+		if (auto tbl = parse_or_fail(parse))
 		{
-			INFO("Parsing string directly"sv)
-			if (func)
-				func(validate_table(toml::parse(toml_str, source_path), source_path));
-			else
-				validate_table(toml::parse(toml_str, source_path), source_path);
+			validate_table(*tbl);
+			CHECK(*tbl == *expected);
+			if (call_func && func)
+				func(std::move(*tbl));
 		}
+	};
+
+	check("Parsing string directly"sv, [&]() { return toml::parse(toml_str, source_path); }, true);
+	check(
+		"Parsing from a string stream"sv,
+		[&]()
 		{
-			INFO("Parsing from a string stream"sv)
 			std::stringstream ss;
 			ss.write(toml_str.data(), static_cast<std::streamsize>(toml_str.length()));
-			if (func)
-				func(validate_table(toml::parse(ss, source_path), source_path));
-			else
-				validate_table(toml::parse(ss, source_path), source_path);
-		}
-	}
-	catch (const parse_error& err)
+			return toml::parse(ss, source_path);
+		},
+		true);
+	check("Parsing incrementally"sv, [&]() { return parse_incrementally(toml_str, source_path); }, true);
 	{
-		FORCE_FAIL("Parse error on line "sv << err.source().begin.line << ", column "sv << err.source().begin.column
-											<< ":\n"sv << err.description());
-		return false;
+		INFO("Parsing with a sax_handler"sv)
+		table_builder builder;
+		if (parse_or_fail([&]() { return parse_with_handler(toml_str, builder, source_path); }))
+			CHECK(builder.root == *expected);
 	}
-
-#else
-
+	check(
+		"Parsing lazily"sv,
+		[&]()
+		{
+			lazy_document doc{ toml_str, source_path };
+			return parse_lazily(doc);
+		},
+		false);
 	{
-		INFO("Parsing string directly"sv)
-		parse_result result = toml::parse(toml_str, source_path);
-		if (result)
+		INFO("Reading strings from a borrowed lazy document"sv)
+		lazy_document doc{ borrow_document, toml_str, source_path };
+		toml::path path;
+		check_string_at(doc, *expected, path);
+	}
+	check(
+		"Parsing with threads"sv,
+		[&]()
 		{
-			if (func)
-				func(validate_table(std::move(result), source_path));
-			else
-				validate_table(std::move(result), source_path);
-		}
-		else
+			parse_options options;
+			options.threads				 = 4u;
+			options.min_bytes_per_thread = 1u; // (so even small documents get split up)
+			return toml::parse(toml_str, options, source_path);
+		},
+		false);
+	check(
+		"Parsing with an arena"sv,
+		[&]()
 		{
-			FORCE_FAIL("Parse error on line "sv << result.error().source().begin.line << ", column "sv
-												<< result.error().source().begin.column << ":\n"sv
-												<< result.error().description());
-		}
-	}
+			parse_options options;
+			options.use_arena = true;
+			return toml::parse(toml_str, options, source_path);
+		},
+		false);
 
-	{
-		INFO("Parsing from a string stream"sv)
-		std::stringstream ss;
-		ss.write(toml_str.data(), static_cast<std::streamsize>(toml_str.length()));
-		parse_result result = toml::parse(ss, source_path);
-		if (result)
-		{
-			if (func)
-				func(validate_table(std::move(result), source_path));
-			else
-				validate_table(std::move(result), source_path);
-		}
-		else
-		{
-			FORCE_FAIL("Parse error on line "sv << result.error().source().begin.line << ", column "sv
-												<< result.error().source().begin.column << ":\n"sv
-												<< result.error().description());
-		}
-	}
+	return true;
+}
 
+table table_of(parse_result&& result)
+{
+#if TOML_EXCEPTIONS
+	return std::move(result);
+#else
+	REQUIRE(!!result);
+	return std::move(result).table();
 #endif
+}
 
-	return true;
+const table& table_of(const parse_result& result)
+{
+#if TOML_EXCEPTIONS
+	return result;
+#else
+	REQUIRE(!!result);
+	return result.table();
+#endif
 }
 
 bool parsing_should_fail(std::string_view test_file,
@@ -111,32 +311,19 @@ bool parsing_should_fail(std::string_view test_file,
 	INFO("["sv << test_file << ", line "sv << test_line << "] "sv
 			   << "parsing_should_fail(\""sv << toml_str << "\")"sv)
 
-#if TOML_EXCEPTIONS
-
-	static constexpr auto run_tests = [](source_index ex_line, source_index ex_col, auto&& fn)
+	static constexpr auto run_tests =
+		[](source_index ex_line, source_index ex_col, auto&& fn, source_position* actual = nullptr)
 	{
+		std::optional<parse_error> err;
+
+#if TOML_EXCEPTIONS
 		try
 		{
-			fn();
+			static_cast<void>(fn());
 		}
-		catch (const parse_error& err)
+		catch (const parse_error& e)
 		{
-			if (ex_line != static_cast<source_index>(-1) && err.source().begin.line != ex_line)
-			{
-				FORCE_FAIL("Expected parse_error at line "sv << ex_line << ", actually occured at line "sv
-															 << err.source().begin.line);
-				return false;
-			}
-
-			if (ex_col != static_cast<source_index>(-1) && err.source().begin.column != ex_col)
-			{
-				FORCE_FAIL("Expected parse_error at column "sv << ex_col << ", actually occured at column "sv
-															   << err.source().begin.column);
-				return false;
-			}
-
-			SUCCEED("parse_error thrown OK"sv);
-			return true;
+			err = e;
 		}
 		catch (const std::exception& exc)
 		{
@@ -148,51 +335,46 @@ bool parsing_should_fail(std::string_view test_file,
 			FORCE_FAIL("Expected parsing failure, saw unspecified exception"sv);
 			return false;
 		}
-
-		FORCE_FAIL("Expected parsing failure"sv);
-		return false;
-	};
-
-	auto result = run_tests(expected_failure_line,
-							expected_failure_column,
-							[=]() { [[maybe_unused]] auto res = toml::parse(toml_str); });
-	result		= result
-		  && run_tests(expected_failure_line,
-					   expected_failure_column,
-					   [=]()
-					   {
-						   std::stringstream ss;
-						   ss.write(toml_str.data(), static_cast<std::streamsize>(toml_str.length()));
-						   [[maybe_unused]] auto res = toml::parse(ss);
-					   });
-	return result;
-
 #else
-
-	static constexpr auto run_tests = [](source_index ex_line, source_index ex_col, auto&& fn)
-	{
 		if (parse_result result = fn(); !result)
+			err = result.error();
+#endif
+
+		if (!err)
 		{
-			if (ex_line != static_cast<source_index>(-1) && result.error().source().begin.line != ex_line)
-			{
-				FORCE_FAIL("Expected parse_error at line "sv << ex_line << ", actually occured at line "sv
-															 << result.error().source().begin.line);
-			}
+			FORCE_FAIL("Expected parsing failure"sv);
+			return false;
+		}
 
-			if (ex_col != static_cast<source_index>(-1) && result.error().source().begin.column != ex_col)
-			{
-				FORCE_FAIL("Expected parse_error at column "sv << ex_col << ", actually occured at column "sv
-															   << result.error().source().begin.column);
-			}
+		if (ex_line != static_cast<source_index>(-1) && err->source().begin.line != ex_line)
+		{
+			FORCE_FAIL("Expected parse_error at line "sv << ex_line << ", actually occured at line "sv
+														 << err->source().begin.line);
+			return false;
+		}
 
-			SUCCEED("parse_error generated OK"sv);
-			return true;
+		if (ex_col != static_cast<source_index>(-1) && err->source().begin.column != ex_col)
+		{
+			FORCE_FAIL("Expected parse_error at column "sv << ex_col << ", actually occured at column "sv
+														   << err->source().begin.column);
+			return false;
 		}
 
-		FORCE_FAIL("Expected parsing failure"sv);
+		if (actual)
+			*actual = err->source().begin;
+
+		SUCCEED("parse_error generated OK"sv);
+		return true;
 	};
 
-	return run_tests(expected_failure_line, expected_failure_column, [=]() { return toml::parse(toml_str); })
+	// the incremental parser should report the error exactly where toml::parse() did, even when the test doesn't
+	// specify where that is (see the remarks of toml::incremental_parser for the one case where it can't, which
+	// these tests don't include)
+	source_position parse_pos{};
+	return run_tests(expected_failure_line,
+					 expected_failure_column,
+					 [=]() { return toml::parse(toml_str); },
+					 &parse_pos)
 		&& run_tests(expected_failure_line,
 					 expected_failure_column,
 					 [=]()
@@ -200,9 +382,39 @@ bool parsing_should_fail(std::string_view test_file,
 						 std::stringstream ss;
 						 ss.write(toml_str.data(), static_cast<std::streamsize>(toml_str.length()));
 						 return toml::parse(ss);
+					 })
+		&& run_tests(parse_pos.line, parse_pos.column, [=]() { return parse_incrementally(toml_str); })
+		&& run_tests(expected_failure_line,
+					 expected_failure_column,
+					 [=]()
+					 {
+						 sax_handler handler;
+						 return parse_with_handler(toml_str, handler);
+					 })
+		&& run_tests(expected_failure_line,
+					 expected_failure_column,
+					 [=]()
+					 {
+						 lazy_document doc{ toml_str };
+						 return parse_lazily(doc);
+					 })
+		&& run_tests(expected_failure_line,
+					 expected_failure_column,
+					 [=]()
+					 {
+						 parse_options options;
+						 options.threads			  = 4u;
+						 options.min_bytes_per_thread = 1u;
+						 return toml::parse(toml_str, options);
+					 })
+		&& run_tests(expected_failure_line,
+					 expected_failure_column,
+					 [=]()
+					 {
+						 parse_options options;
+						 options.use_arena = true;
+						 return toml::parse(toml_str, options);
 					 });
-
-#endif
 }
 
 template bool parse_expected_value(std::string_view, uint32_t, std::string_view, const int&);
@@ -121,6 +121,10 @@ class function_view<R(P...)> final
 
 using pss_func = function_view<void(table&&)>;
 
+// parsing_should_succeed() and parsing_should_fail() check that every way of parsing a document agrees with
+// toml::parse(): from a stream, incrementally (one byte at a time), through a sax_handler, with a lazy_document, with
+// threads (with parse_options::min_bytes_per_thread lowered so even tiny documents get split up) and with an arena.
+// the tests of each of those only need to cover the things specific to them.
 bool parsing_should_succeed(std::string_view test_file,
 							uint32_t test_line,
 							std::string_view toml_str,
@@ -133,6 +137,10 @@ bool parsing_should_fail(std::string_view test_file,
 						 source_index expected_failure_line	  = static_cast<source_index>(-1),
 						 source_index expected_failure_column = static_cast<source_index>(-1));
 
+// the table from a parse that was expected to succeed (failing the test if it didn't)
+table table_of(parse_result&& result);
+const table& table_of(const parse_result& result);
+
 TOML_PURE_GETTER
 constexpr std::string_view trim_file_path(std::string_view sv) noexcept
 {
@@ -264,8 +272,13 @@ inline bool parse_expected_value(std::string_view test_file,
 				CHECK_SYMMETRIC_EQUAL(nv, expected);
 
 				// make sure source info is correct
+#if TOML_ENABLE_SOURCES
 				CHECK_SYMMETRIC_EQUAL(nv.node()->source().begin, begin);
 				CHECK_SYMMETRIC_EQUAL(nv.node()->source().end, end);
+#else
+				CHECK(!nv.node()->source().begin);
+				CHECK(!nv.node()->source().end);
+#endif
 
 				// check float identities etc
 				if constexpr (std::is_same_v<value_type, double>)
@@ -29,11 +29,13 @@ TEST_CASE("windows compat")
 #endif
 	table& tbl = res;
 
+#if TOML_ENABLE_SOURCES
 	// source paths
 	REQUIRE(tbl.source().path != nullptr);
 	CHECK(*tbl.source().path == "kek.toml"sv);
 	CHECK(tbl.source().wide_path().has_value());
 	CHECK(tbl.source().wide_path().value() == L"kek.toml"sv);
+#endif
 
 	// direct lookups from tables
 	REQUIRE(tbl.get("library") != nullptr);
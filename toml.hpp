@@ -1023,6 +1023,50 @@
 #define TOML_ENABLE_PARSER 1
 #endif
 
+// node arenas
+#if (defined(TOML_ENABLE_ARENA) && TOML_ENABLE_ARENA) || TOML_INTELLISENSE
+#undef TOML_ENABLE_ARENA
+#define TOML_ENABLE_ARENA 1
+#endif
+#ifndef TOML_ENABLE_ARENA
+#define TOML_ENABLE_ARENA 0
+#endif
+
+// source regions
+#if !defined(TOML_ENABLE_SOURCES) || (defined(TOML_ENABLE_SOURCES) && TOML_ENABLE_SOURCES) || TOML_INTELLISENSE
+#undef TOML_ENABLE_SOURCES
+#define TOML_ENABLE_SOURCES 1
+#endif
+
+// flat tables
+#if defined(TOML_FLAT_TABLES) && TOML_FLAT_TABLES
+#undef TOML_FLAT_TABLES
+#define TOML_FLAT_TABLES 1
+#endif
+#ifndef TOML_FLAT_TABLES
+#define TOML_FLAT_TABLES 0
+#endif
+
+// memory-mapped files
+#if !defined(TOML_ENABLE_MMAP) || (defined(TOML_ENABLE_MMAP) && TOML_ENABLE_MMAP) || TOML_INTELLISENSE
+#undef TOML_ENABLE_MMAP
+#define TOML_ENABLE_MMAP 1
+#endif
+
+#if !TOML_UNIX && !TOML_WINDOWS
+#undef TOML_ENABLE_MMAP
+#define TOML_ENABLE_MMAP 0
+#endif
+
+// worker threads
+#if (defined(TOML_ENABLE_THREADS) && TOML_ENABLE_THREADS) || TOML_INTELLISENSE
+#undef TOML_ENABLE_THREADS
+#define TOML_ENABLE_THREADS 1
+#endif
+#ifndef TOML_ENABLE_THREADS
+#define TOML_ENABLE_THREADS 0
+#endif
+
 // formatters
 #if !defined(TOML_ENABLE_FORMATTERS) || (defined(TOML_ENABLE_FORMATTERS) && TOML_ENABLE_FORMATTERS) || TOML_INTELLISENSE
 #undef TOML_ENABLE_FORMATTERS
@@ -1096,6 +1140,16 @@
 #define TOML_MAX_DOTTED_KEYS_DEPTH 1024
 #endif
 
+#ifndef TOML_PARALLEL_PARSE_MIN_BYTES
+#define TOML_PARALLEL_PARSE_MIN_BYTES 65536
+// the default for parse_options::min_bytes_per_thread.
+#endif
+
+#ifndef TOML_TABLE_INDEX_MIN_KEYS
+#define TOML_TABLE_INDEX_MIN_KEYS 1024
+// tables with at least this many keys build a hash index the first time a key is looked up (0 to never build one).
+#endif
+
 #ifdef TOML_CHAR_8_STRINGS
 #if TOML_CHAR_8_STRINGS
 #error TOML_CHAR_8_STRINGS was removed in toml++ 2.0.0; all value setters and getters now work with char8_t strings implicitly.
@@ -1424,6 +1478,26 @@ TOML_NAMESPACE_START
 }
 TOML_NAMESPACE_END;
 
+//********  impl/std_memory_resource.hpp  ******************************************************************************
+
+TOML_DISABLE_WARNINGS;
+#if TOML_HAS_INCLUDE(<memory_resource>)
+#include <memory_resource>
+#endif
+TOML_ENABLE_WARNINGS;
+
+#if TOML_DOXYGEN || (defined(__cpp_lib_memory_resource) && __cpp_lib_memory_resource >= 201603)
+#define TOML_HAS_MEMORY_RESOURCE 1
+#else
+#define TOML_HAS_MEMORY_RESOURCE 0
+#endif
+
+//********  impl/std_atomic.hpp  ***************************************************************************************
+
+TOML_DISABLE_WARNINGS;
+#include <atomic>
+TOML_ENABLE_WARNINGS;
+
 //********  impl/forward_declarations.hpp  *****************************************************************************
 
 TOML_DISABLE_WARNINGS;
@@ -1506,16 +1580,31 @@ TOML_NAMESPACE_START
 	struct source_position;
 	struct source_region;
 
-	class node;
 	template <typename>
 	class node_view;
 
+	class key_pool;
+
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+
+	class node;
 	class key;
+
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenaarr, heaparr);
 	class array;
+	TOML_ABI_NAMESPACE_END;
+
+	TOML_ABI_NAMESPACE_BOOL(TOML_FLAT_TABLES, flattbl, stdtbl);
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenatbl, heaptbl);
 	class table;
+	TOML_ABI_NAMESPACE_END;
+	TOML_ABI_NAMESPACE_END;
+
 	template <typename>
 	class value;
 
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
+
 	class path;
 
 	class toml_formatter;
@@ -2547,11 +2636,177 @@ TOML_PUSH_WARNINGS;
 #undef max
 #endif
 
+TOML_IMPL_NAMESPACE_START
+{
+	// the path of a parsed document, along with a way for the pointers borrowing it to take a reference to it
+	// (see source_path_ptr)
+	struct source_path_block : std::enable_shared_from_this<source_path_block>
+	{
+		std::string path;
+
+		TOML_NODISCARD_CTOR
+		explicit source_path_block(std::string_view p) //
+			: path{ p }
+		{}
+
+		TOML_NODISCARD_CTOR
+		explicit source_path_block(std::string&& p) noexcept //
+			: path{ std::move(p) }
+		{}
+	};
+
+	struct borrow_source_path_t
+	{};
+}
+TOML_IMPL_NAMESPACE_END;
+
 TOML_NAMESPACE_START
 {
 	using source_index = uint32_t;
 
-	using source_path_ptr = std::shared_ptr<const std::string>;
+	class source_path_ptr
+	{
+	  private:
+		// (without a control block when it's borrowed from a document)
+		std::shared_ptr<const impl::source_path_block> ptr_;
+
+		TOML_NODISCARD
+		std::shared_ptr<const impl::source_path_block> acquire() const noexcept
+		{
+			if (!ptr_ || ptr_.use_count())
+				return ptr_;
+			return ptr_->weak_from_this().lock();
+		}
+
+	  public:
+
+		TOML_NODISCARD_CTOR
+		source_path_ptr() noexcept = default;
+
+		TOML_NODISCARD_CTOR
+		source_path_ptr(std::nullptr_t) noexcept
+		{}
+
+		TOML_NODISCARD_CTOR
+		explicit source_path_ptr(std::string_view path) //
+			: ptr_{ std::make_shared<impl::source_path_block>(path) }
+		{}
+
+		TOML_NODISCARD_CTOR
+		explicit source_path_ptr(const char* path) //
+			: source_path_ptr{ std::string_view{ path } }
+		{}
+
+		TOML_NODISCARD_CTOR
+		explicit source_path_ptr(std::string&& path) //
+			: ptr_{ std::make_shared<impl::source_path_block>(std::move(path)) }
+		{}
+
+		template <typename T,
+				  typename = std::enable_if_t<std::is_convertible_v<T*, const std::string*>>>
+		TOML_NODISCARD_CTOR
+		/*implicit*/ source_path_ptr(const std::shared_ptr<T>& path)
+		{
+			if (path)
+				ptr_ = std::make_shared<impl::source_path_block>(*path);
+		}
+
+		// a pointer to the same path that doesn't own it; only for things kept alive by something that does
+		TOML_NODISCARD_CTOR
+		source_path_ptr(impl::borrow_source_path_t, const source_path_ptr& owner) noexcept //
+			: ptr_{ std::shared_ptr<const impl::source_path_block>{}, owner.ptr_.get() }
+		{}
+
+		TOML_NODISCARD_CTOR
+		source_path_ptr(const source_path_ptr& other) noexcept //
+			: ptr_{ other.acquire() }
+		{}
+
+		TOML_NODISCARD_CTOR
+		source_path_ptr(source_path_ptr&&) noexcept = default;
+
+		source_path_ptr& operator=(const source_path_ptr& rhs) noexcept
+		{
+			if (&rhs != this)
+				ptr_ = rhs.acquire();
+			return *this;
+		}
+
+		source_path_ptr& operator=(source_path_ptr&&) noexcept = default;
+
+		TOML_PURE_INLINE_GETTER
+		const std::string* get() const noexcept
+		{
+			return ptr_ ? &ptr_->path : nullptr;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const std::string& operator*() const noexcept
+		{
+			TOML_ASSERT_ASSUME(ptr_);
+			return ptr_->path;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const std::string* operator->() const noexcept
+		{
+			TOML_ASSERT_ASSUME(ptr_);
+			return &ptr_->path;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		explicit operator bool() const noexcept
+		{
+			return !!ptr_;
+		}
+
+		TOML_NODISCARD
+		long use_count() const noexcept
+		{
+			if (!ptr_ || ptr_.use_count())
+				return ptr_.use_count();
+			return ptr_->weak_from_this().use_count();
+		}
+
+		TOML_NODISCARD
+		/*implicit*/ operator std::shared_ptr<const std::string>() const noexcept
+		{
+			auto ptr = acquire();
+			if (!ptr)
+				return {};
+			const auto path = &ptr->path;
+			return { std::move(ptr), path };
+		}
+
+		void reset() noexcept
+		{
+			ptr_.reset();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		friend bool operator==(const source_path_ptr& lhs, const source_path_ptr& rhs) noexcept
+		{
+			return lhs.ptr_ == rhs.ptr_;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		friend bool operator!=(const source_path_ptr& lhs, const source_path_ptr& rhs) noexcept
+		{
+			return lhs.ptr_ != rhs.ptr_;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		friend bool operator==(const source_path_ptr& lhs, std::nullptr_t) noexcept
+		{
+			return !lhs.ptr_;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		friend bool operator!=(const source_path_ptr& lhs, std::nullptr_t) noexcept
+		{
+			return !!lhs.ptr_;
+		}
+	};
 
 	struct TOML_TRIVIAL_ABI source_position
 	{
@@ -2703,6 +2958,22 @@ TOML_NAMESPACE_START
 }
 TOML_NAMESPACE_END;
 
+#if !TOML_ENABLE_SOURCES
+
+TOML_IMPL_NAMESPACE_START
+{
+	// the source() of every node and key when they don't record one (see TOML_ENABLE_SOURCES)
+	TOML_NODISCARD
+	inline const source_region& empty_source_region() noexcept
+	{
+		static const source_region region{};
+		return region;
+	}
+}
+TOML_IMPL_NAMESPACE_END;
+
+#endif
+
 #ifdef _MSC_VER
 #pragma pop_macro("min")
 #pragma pop_macro("max")
@@ -3695,6 +3966,113 @@ TOML_NAMESPACE_END;
 #endif
 TOML_POP_WARNINGS;
 
+//********  impl/node_arena.hpp  ***************************************************************************************
+
+TOML_PUSH_WARNINGS;
+#ifdef _MSC_VER
+#ifndef __clang__
+#pragma inline_recursion(on)
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#endif
+
+TOML_IMPL_NAMESPACE_START
+{
+	// (nodes allocated with and without arenas can't be freed by each other's node_deallocate)
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenas, noarenas);
+
+	class node_arena;
+
+	// nodes, and the storage of tables and arrays, are allocated with these. while the parser has an arena active on
+	// the current thread (see parse_options::use_arena) they come from that; otherwise from the global heap.
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	void* TOML_CALLCONV node_allocate(size_t size);
+
+	TOML_EXPORTED_FREE_FUNCTION
+	void TOML_CALLCONV node_deallocate(void* ptr, size_t size) noexcept;
+
+	template <typename T>
+	struct node_allocator
+	{
+		static_assert(alignof(T) <= 8u, "node_allocator can only allocate types with an alignment of 8 or less");
+
+		using value_type = T;
+
+		node_allocator() noexcept = default;
+
+		template <typename U>
+		constexpr node_allocator(const node_allocator<U>&) noexcept
+		{}
+
+		TOML_NODISCARD
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(node_allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T* ptr, size_t n) noexcept
+		{
+			node_deallocate(ptr, n * sizeof(T));
+		}
+
+		template <typename U>
+		TOML_CONST_INLINE_GETTER
+		friend constexpr bool operator==(node_allocator, node_allocator<U>) noexcept
+		{
+			return true;
+		}
+
+		template <typename U>
+		TOML_CONST_INLINE_GETTER
+		friend constexpr bool operator!=(node_allocator, node_allocator<U>) noexcept
+		{
+			return false;
+		}
+	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_ARENA
+}
+TOML_IMPL_NAMESPACE_END;
+
+#if TOML_HAS_MEMORY_RESOURCE
+
+TOML_NAMESPACE_START
+{
+	class TOML_EXPORTED_CLASS memory_resource_scope
+	{
+	  private:
+		impl::node_arena* arena_;
+		impl::node_arena* prev_;
+
+	  public:
+
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		explicit memory_resource_scope(std::pmr::memory_resource* resource);
+
+		TOML_EXPORTED_MEMBER_FUNCTION
+		~memory_resource_scope() noexcept;
+
+		TOML_DELETE_DEFAULTS(memory_resource_scope);
+	};
+}
+TOML_NAMESPACE_END;
+
+#endif // TOML_HAS_MEMORY_RESOURCE
+
+#ifdef _MSC_VER
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+#ifndef __clang__
+#pragma inline_recursion(off)
+#endif
+#endif
+TOML_POP_WARNINGS;
+
 //********  impl/std_utility.hpp  **************************************************************************************
 
 TOML_DISABLE_WARNINGS;
@@ -3726,12 +4104,16 @@ TOML_PUSH_WARNINGS;
 
 TOML_NAMESPACE_START
 {
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+
 	class TOML_ABSTRACT_INTERFACE TOML_EXPORTED_CLASS node
 	{
 	  private:
 
 		friend class TOML_PARSER_TYPENAME;
+#if TOML_ENABLE_SOURCES
 		source_region source_{};
+#endif
 
 		template <typename T>
 		TOML_NODISCARD
@@ -3844,6 +4226,27 @@ TOML_NAMESPACE_START
 		TOML_EXPORTED_MEMBER_FUNCTION
 		virtual ~node() noexcept;
 
+		// (see parse_options::use_arena)
+		TOML_NODISCARD
+		static void* operator new(size_t size)
+		{
+			return impl::node_allocate(size);
+		}
+
+		static void operator delete(void* ptr, size_t size) noexcept
+		{
+			impl::node_deallocate(ptr, size);
+		}
+
+		TOML_NODISCARD
+		static void* operator new(size_t, void* ptr) noexcept
+		{
+			return ptr;
+		}
+
+		static void operator delete(void*, void*) noexcept
+		{}
+
 		TOML_NODISCARD
 		virtual bool is_homogeneous(node_type ntype, node*& first_nonmatch) noexcept = 0;
 
@@ -4091,7 +4494,11 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		const source_region& source() const noexcept
 		{
+#if TOML_ENABLE_SOURCES
 			return source_;
+#else
+			return impl::empty_source_region();
+#endif
 		}
 
 	  private:
@@ -4312,6 +4719,8 @@ TOML_NAMESPACE_START
 		TOML_EXPORTED_MEMBER_FUNCTION
 		node_view<const node> operator[](const toml::path& path) const noexcept;
 	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
 }
 TOML_NAMESPACE_END;
 
@@ -5063,6 +5472,8 @@ TOML_IMPL_NAMESPACE_END;
 
 TOML_NAMESPACE_START
 {
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+
 	template <typename ValueType>
 	class value : public node
 	{
@@ -5662,6 +6073,8 @@ TOML_NAMESPACE_START
 	template <typename T>
 	value(T, value_flags) -> value<impl::native_type_of<impl::remove_cvref<T>>>;
 
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
+
 	template <typename T>
 	TOML_NODISCARD
 	inline decltype(auto) node::get_value_exact() const noexcept(impl::value_retrieval_is_nothrow<T>)
@@ -6168,6 +6581,8 @@ TOML_PUSH_WARNINGS;
 
 TOML_IMPL_NAMESPACE_START
 {
+	using array_vector = std::vector<node_ptr, node_allocator<node_ptr>>;
+
 	template <bool IsConst>
 	class TOML_TRIVIAL_ABI array_iterator
 	{
@@ -6175,8 +6590,8 @@ TOML_IMPL_NAMESPACE_START
 		template <bool>
 		friend class array_iterator;
 
-		using mutable_vector_iterator = std::vector<node_ptr>::iterator;
-		using const_vector_iterator	  = std::vector<node_ptr>::const_iterator;
+		using mutable_vector_iterator = array_vector::iterator;
+		using const_vector_iterator	  = array_vector::const_iterator;
 		using vector_iterator		  = std::conditional_t<IsConst, const_vector_iterator, mutable_vector_iterator>;
 
 		mutable vector_iterator iter_;
@@ -6362,11 +6777,14 @@ TOML_NAMESPACE_START
 
 	using const_array_iterator = POXY_IMPLEMENTATION_DETAIL(impl::array_iterator<true>);
 
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenaarr, heaparr);
+
 	class TOML_EXPORTED_CLASS array : public node
 	{
 	  private:
 
-		using vector_type			= std::vector<impl::node_ptr>;
+		using vector_type			= impl::array_vector;
 		using vector_iterator		= typename vector_type::iterator;
 		using const_vector_iterator = typename vector_type::const_iterator;
 		vector_type elems_;
@@ -7283,6 +7701,9 @@ TOML_NAMESPACE_START
 
 #endif
 	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_ARENA
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
 }
 TOML_NAMESPACE_END;
 
@@ -7308,14 +7729,267 @@ TOML_PUSH_WARNINGS;
 #undef max
 #endif
 
-TOML_NAMESPACE_START
+TOML_IMPL_NAMESPACE_START
 {
-	class key
+	// the characters of a key too long to be stored inline, shared by all the copies of that key (and, if it was
+	// interned, by every other key with the same text; see toml::key_pool).
+	// they're allocated like nodes are, so they come from the parser's arena (or a memory_resource_scope's) if one
+	// is active on the thread that creates them.
+	struct shared_key_chars
+	{
+		std::atomic<size_t> refs;
+		size_t length;
+
+		TOML_NODISCARD_CTOR
+		explicit shared_key_chars(size_t len) noexcept //
+			: refs{ 1u },
+			  length{ len }
+		{}
+
+		TOML_PURE_INLINE_GETTER
+		char* data() noexcept
+		{
+			return reinterpret_cast<char*>(this + 1);
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const char* data() const noexcept
+		{
+			return reinterpret_cast<const char*>(this + 1);
+		}
+
+		TOML_PURE_INLINE_GETTER
+		std::string_view view() const noexcept
+		{
+			return std::string_view{ data(), length };
+		}
+
+		TOML_CONST_INLINE_GETTER
+		static constexpr size_t allocation_size(size_t len) noexcept
+		{
+			return sizeof(shared_key_chars) + len + 1u;
+		}
+
+		TOML_NODISCARD
+		static shared_key_chars* create(std::string_view str)
+		{
+			const auto chars = ::new (node_allocate(allocation_size(str.length()))) shared_key_chars{ str.length() };
+			std::memcpy(chars->data(), str.data(), str.length());
+			chars->data()[str.length()] = '\0';
+			return chars;
+		}
+
+		void add_ref() noexcept
+		{
+			refs.fetch_add(1u, std::memory_order_relaxed);
+		}
+
+		void release() noexcept
+		{
+			if (refs.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+			{
+				const auto size = allocation_size(length);
+				this->~shared_key_chars();
+				node_deallocate(this, size);
+			}
+		}
+	};
+
+	// the string of a toml::key. short strings are stored inline, and longer ones in a shared_key_chars, so copying
+	// a key never allocates and every key is only 16 bytes. either way the string is null-terminated.
+	class key_string
 	{
+	  public:
+		static constexpr size_t max_inline_length = 15u;
+
 	  private:
-		std::string key_;
+		static constexpr unsigned char shared_tag = 0xFFu;
+
+		// the last byte is max_inline_length minus the length of an inline string (so it doubles as the terminator of
+		// one that fills the whole buffer), or shared_tag if the buffer starts with a shared_key_chars*.
+		// unused bytes are always zero so two key_strings can be compared bytewise.
+		alignas(void*) unsigned char bytes_[max_inline_length + 1u];
+
+		TOML_PURE_INLINE_GETTER
+		unsigned char tag() const noexcept
+		{
+			return bytes_[max_inline_length];
+		}
+
+		TOML_PURE_INLINE_GETTER
+		shared_key_chars* shared() const noexcept
+		{
+			TOML_ASSERT_ASSUME(tag() == shared_tag);
+
+			shared_key_chars* chars;
+			std::memcpy(&chars, bytes_, sizeof(chars));
+			return chars;
+		}
+
+		void reset() noexcept
+		{
+			std::memset(bytes_, 0, sizeof(bytes_));
+			bytes_[max_inline_length] = static_cast<unsigned char>(max_inline_length);
+		}
+
+		void release() noexcept
+		{
+			if (tag() == shared_tag)
+				shared()->release();
+		}
+
+	  public:
+		TOML_NODISCARD_CTOR
+		key_string() noexcept
+		{
+			reset();
+		}
+
+		TOML_NODISCARD_CTOR
+		explicit key_string(std::string_view str)
+		{
+			reset();
+			if (str.length() <= max_inline_length)
+			{
+				if (!str.empty())
+					std::memcpy(bytes_, str.data(), str.length());
+				bytes_[max_inline_length] = static_cast<unsigned char>(max_inline_length - str.length());
+			}
+			else
+				*this = key_string{ shared_key_chars::create(str) };
+		}
+
+		// takes over a reference to the chars
+		TOML_NODISCARD_CTOR
+		explicit key_string(shared_key_chars* chars) noexcept
+		{
+			TOML_ASSERT_ASSUME(chars);
+			TOML_ASSERT(chars->length > max_inline_length);
+
+			reset();
+			std::memcpy(bytes_, &chars, sizeof(chars));
+			bytes_[max_inline_length] = shared_tag;
+		}
+
+		TOML_NODISCARD_CTOR
+		key_string(const key_string& other) noexcept
+		{
+			std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+			if (tag() == shared_tag)
+				shared()->add_ref();
+		}
+
+		TOML_NODISCARD_CTOR
+		key_string(key_string&& other) noexcept
+		{
+			std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+			other.reset();
+		}
+
+		key_string& operator=(const key_string& rhs) noexcept
+		{
+			if (&rhs != this)
+			{
+				if (rhs.tag() == shared_tag)
+					rhs.shared()->add_ref();
+				release();
+				std::memcpy(bytes_, rhs.bytes_, sizeof(bytes_));
+			}
+			return *this;
+		}
+
+		key_string& operator=(key_string&& rhs) noexcept
+		{
+			if (&rhs != this)
+			{
+				release();
+				std::memcpy(bytes_, rhs.bytes_, sizeof(bytes_));
+				rhs.reset();
+			}
+			return *this;
+		}
+
+		~key_string() noexcept
+		{
+			release();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		std::string_view view() const noexcept
+		{
+			if (tag() == shared_tag)
+				return shared()->view();
+			return std::string_view{ reinterpret_cast<const char*>(bytes_), max_inline_length - tag() };
+		}
+
+		TOML_PURE_INLINE_GETTER
+		bool empty() const noexcept
+		{
+			return tag() == max_inline_length;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		friend bool operator==(const key_string& lhs, const key_string& rhs) noexcept
+		{
+			// identical bytes are either identical inline strings or the same shared chars (e.g. two keys interned from
+			// the same pool); otherwise they can only be equal if they're both shared, since short strings never are
+			if (std::memcmp(lhs.bytes_, rhs.bytes_, sizeof(bytes_)) == 0)
+				return true;
+			return lhs.tag() == shared_tag && rhs.tag() == shared_tag && lhs.view() == rhs.view();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		friend bool operator!=(const key_string& lhs, const key_string& rhs) noexcept
+		{
+			return !(lhs == rhs);
+		}
+	};
+	static_assert(sizeof(key_string) == 16u);
+
+	// where a key was defined. keys inherit it so that it takes up no space at all when they don't record one
+	// (see TOML_ENABLE_SOURCES).
+	struct key_source
+	{
+#if TOML_ENABLE_SOURCES
+
 		source_region source_;
 
+		TOML_NODISCARD_CTOR
+		key_source() noexcept = default;
+
+		TOML_NODISCARD_CTOR
+		key_source(source_region&& src) noexcept //
+			: source_{ std::move(src) }
+		{}
+
+		TOML_NODISCARD_CTOR
+		key_source(const source_region& src) noexcept //
+			: source_{ src }
+		{}
+
+#else
+
+		TOML_NODISCARD_CTOR
+		key_source() noexcept = default;
+
+		TOML_NODISCARD_CTOR
+		key_source(const source_region&) noexcept
+		{}
+
+#endif
+	};
+}
+TOML_IMPL_NAMESPACE_END;
+
+TOML_NAMESPACE_START
+{
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+
+	class TOML_EMPTY_BASES key : impl::key_source
+	{
+	  private:
+		impl::key_string key_;
+
 	  public:
 
 		TOML_NODISCARD_CTOR
@@ -7323,60 +7997,70 @@ TOML_NAMESPACE_START
 
 		TOML_NODISCARD_CTOR
 		explicit key(std::string_view k, source_region&& src = {}) //
-			: key_{ k },
-			  source_{ std::move(src) }
+			: impl::key_source{ std::move(src) },
+			  key_{ k }
 		{}
 
 		TOML_NODISCARD_CTOR
 		explicit key(std::string_view k, const source_region& src) //
-			: key_{ k },
-			  source_{ src }
+			: impl::key_source{ src },
+			  key_{ k }
 		{}
 
 		TOML_NODISCARD_CTOR
-		explicit key(std::string&& k, source_region&& src = {}) noexcept //
-			: key_{ std::move(k) },
-			  source_{ std::move(src) }
-		{}
+		explicit key(std::string&& k, source_region&& src = {}) //
+			: impl::key_source{ std::move(src) },
+			  key_{ std::string_view{ k } }
+		{
+			k.clear(); // (as if it had been moved from)
+		}
 
 		TOML_NODISCARD_CTOR
-		explicit key(std::string&& k, const source_region& src) noexcept //
-			: key_{ std::move(k) },
-			  source_{ src }
-		{}
+		explicit key(std::string&& k, const source_region& src) //
+			: impl::key_source{ src },
+			  key_{ std::string_view{ k } }
+		{
+			k.clear(); // (as if it had been moved from)
+		}
 
 		TOML_NODISCARD_CTOR
 		explicit key(const char* k, source_region&& src = {}) //
-			: key_{ k },
-			  source_{ std::move(src) }
+			: impl::key_source{ std::move(src) },
+			  key_{ std::string_view{ k } }
 		{}
 
 		TOML_NODISCARD_CTOR
 		explicit key(const char* k, const source_region& src) //
-			: key_{ k },
-			  source_{ src }
+			: impl::key_source{ src },
+			  key_{ std::string_view{ k } }
 		{}
 
 #if TOML_ENABLE_WINDOWS_COMPAT
 
 		TOML_NODISCARD_CTOR
 		explicit key(std::wstring_view k, source_region&& src = {}) //
-			: key_{ impl::narrow(k) },
-			  source_{ std::move(src) }
+			: impl::key_source{ std::move(src) },
+			  key_{ std::string_view{ impl::narrow(k) } }
 		{}
 
 		TOML_NODISCARD_CTOR
 		explicit key(std::wstring_view k, const source_region& src) //
-			: key_{ impl::narrow(k) },
-			  source_{ src }
+			: impl::key_source{ src },
+			  key_{ std::string_view{ impl::narrow(k) } }
 		{}
 
 #endif
 
+		TOML_NODISCARD_CTOR
+		explicit key(impl::key_string&& k, source_region&& src) noexcept //
+			: impl::key_source{ std::move(src) },
+			  key_{ std::move(k) }
+		{}
+
 		TOML_PURE_INLINE_GETTER
 		std::string_view str() const noexcept
 		{
-			return std::string_view{ key_ };
+			return key_.view();
 		}
 
 		TOML_PURE_INLINE_GETTER
@@ -7394,19 +8078,23 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		const char* data() const noexcept
 		{
-			return key_.data();
+			return key_.view().data();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		size_t length() const noexcept
 		{
-			return key_.length();
+			return key_.view().length();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		const source_region& source() const noexcept
 		{
+#if TOML_ENABLE_SOURCES
 			return source_;
+#else
+			return impl::empty_source_region();
+#endif
 		}
 
 		TOML_PURE_INLINE_GETTER
@@ -7424,97 +8112,97 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<(const key& lhs, const key& rhs) noexcept
 		{
-			return lhs.key_ < rhs.key_;
+			return lhs.str() < rhs.str();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<=(const key& lhs, const key& rhs) noexcept
 		{
-			return lhs.key_ <= rhs.key_;
+			return lhs.str() <= rhs.str();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>(const key& lhs, const key& rhs) noexcept
 		{
-			return lhs.key_ > rhs.key_;
+			return lhs.str() > rhs.str();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>=(const key& lhs, const key& rhs) noexcept
 		{
-			return lhs.key_ >= rhs.key_;
+			return lhs.str() >= rhs.str();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator==(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ == rhs;
+			return lhs.str() == rhs;
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator!=(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ != rhs;
+			return lhs.str() != rhs;
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ < rhs;
+			return lhs.str() < rhs;
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<=(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ <= rhs;
+			return lhs.str() <= rhs;
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ > rhs;
+			return lhs.str() > rhs;
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>=(const key& lhs, std::string_view rhs) noexcept
 		{
-			return lhs.key_ >= rhs;
+			return lhs.str() >= rhs;
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator==(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs == rhs.key_;
+			return lhs == rhs.str();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator!=(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs != rhs.key_;
+			return lhs != rhs.str();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs < rhs.key_;
+			return lhs < rhs.str();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator<=(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs <= rhs.key_;
+			return lhs <= rhs.str();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs > rhs.key_;
+			return lhs > rhs.str();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		friend bool operator>=(std::string_view lhs, const key& rhs) noexcept
 		{
-			return lhs >= rhs.key_;
+			return lhs >= rhs.str();
 		}
 
 		using const_iterator = const char*;
@@ -7524,22 +8212,24 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		const_iterator begin() const noexcept
 		{
-			return key_.data();
+			return data();
 		}
 
 		TOML_PURE_INLINE_GETTER
 		const_iterator end() const noexcept
 		{
-			return key_.data() + key_.length();
+			return data() + length();
 		}
 
 		friend std::ostream& operator<<(std::ostream& lhs, const key& rhs)
 		{
-			impl::print_to_stream(lhs, rhs.key_);
+			impl::print_to_stream(lhs, rhs.str());
 			return lhs;
 		}
 	};
 
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
+
 	template <typename T>
 	inline constexpr bool is_key = std::is_same_v<impl::remove_cvref<T>, toml::key>;
 
@@ -7558,14 +8248,7 @@ TOML_NAMESPACE_END;
 #endif
 TOML_POP_WARNINGS;
 
-//********  impl/std_map.hpp  ******************************************************************************************
-
-TOML_DISABLE_WARNINGS;
-#include <map>
-#include <iterator>
-TOML_ENABLE_WARNINGS;
-
-//********  impl/table.hpp  ********************************************************************************************
+//********  impl/key_pool.hpp  *****************************************************************************************
 
 TOML_PUSH_WARNINGS;
 #ifdef _MSC_VER
@@ -7580,94 +8263,359 @@ TOML_PUSH_WARNINGS;
 
 TOML_IMPL_NAMESPACE_START
 {
-	template <bool IsConst>
-	struct table_proxy_pair
-	{
-		using value_type = std::conditional_t<IsConst, const node, node>;
-
-		const toml::key& first;
-		value_type& second;
-	};
+	struct key_pool_state;
+}
+TOML_IMPL_NAMESPACE_END;
 
-	template <bool IsConst>
-	class table_iterator
+TOML_NAMESPACE_START
+{
+	class TOML_EXPORTED_CLASS key_pool
 	{
 	  private:
-		template <bool>
-		friend class table_iterator;
-
-		using proxy_type		   = table_proxy_pair<IsConst>;
-		using mutable_map_iterator = std::map<toml::key, node_ptr, std::less<>>::iterator;
-		using const_map_iterator   = std::map<toml::key, node_ptr, std::less<>>::const_iterator;
-		using map_iterator		   = std::conditional_t<IsConst, const_map_iterator, mutable_map_iterator>;
 
-		mutable map_iterator iter_;
-		alignas(proxy_type) mutable unsigned char proxy_[sizeof(proxy_type)];
-		mutable bool proxy_instantiated_ = false;
+		friend class TOML_PARSER_TYPENAME;
 
-		TOML_NODISCARD
-		proxy_type* get_proxy() const noexcept
-		{
-			if (!proxy_instantiated_)
-			{
-				auto p = ::new (static_cast<void*>(proxy_)) proxy_type{ iter_->first, *iter_->second.get() };
-				proxy_instantiated_ = true;
-				return p;
-			}
-			else
-				return TOML_LAUNDER(reinterpret_cast<proxy_type*>(proxy_));
-		}
+		impl::key_pool_state* state_;
 
 	  public:
-		TOML_NODISCARD_CTOR
-		table_iterator() noexcept = default;
-
-		TOML_NODISCARD_CTOR
-		explicit table_iterator(mutable_map_iterator iter) noexcept //
-			: iter_{ iter }
-		{}
 
-		TOML_CONSTRAINED_TEMPLATE(C, bool C = IsConst)
 		TOML_NODISCARD_CTOR
-		explicit table_iterator(const_map_iterator iter) noexcept //
-			: iter_{ iter }
-		{}
+		TOML_EXPORTED_MEMBER_FUNCTION
+		key_pool();
 
-		TOML_CONSTRAINED_TEMPLATE(C, bool C = IsConst)
-		TOML_NODISCARD_CTOR
-		table_iterator(const table_iterator<false>& other) noexcept //
-			: iter_{ other.iter_ }
-		{}
+		TOML_EXPORTED_MEMBER_FUNCTION
+		~key_pool() noexcept;
 
-		TOML_NODISCARD_CTOR
-		table_iterator(const table_iterator& other) noexcept //
-			: iter_{ other.iter_ }
-		{}
+		TOML_DELETE_DEFAULTS(key_pool);
 
-		table_iterator& operator=(const table_iterator& rhs) noexcept
-		{
-			iter_				= rhs.iter_;
-			proxy_instantiated_ = false;
-			return *this;
-		}
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		key intern(std::string_view k, source_region&& src = {});
 
-		using value_type		= table_proxy_pair<IsConst>;
-		using reference			= value_type&;
-		using pointer			= value_type*;
-		using difference_type	= typename std::iterator_traits<map_iterator>::difference_type;
-		using iterator_category = typename std::iterator_traits<map_iterator>::iterator_category;
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		size_t size() const noexcept;
 
-		table_iterator& operator++() noexcept // ++pre
-		{
-			++iter_;
-			proxy_instantiated_ = false;
-			return *this;
-		}
+		TOML_EXPORTED_MEMBER_FUNCTION
+		void clear() noexcept;
+	};
+}
+TOML_NAMESPACE_END;
 
-		table_iterator operator++(int) noexcept // post++
-		{
-			table_iterator out{ iter_ };
-			++iter_;
+#ifdef _MSC_VER
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+#ifndef __clang__
+#pragma inline_recursion(off)
+#endif
+#endif
+TOML_POP_WARNINGS;
+
+//********  impl/flat_map.hpp  *****************************************************************************************
+
+TOML_PUSH_WARNINGS;
+#ifdef _MSC_VER
+#ifndef __clang__
+#pragma inline_recursion(on)
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#endif
+
+TOML_IMPL_NAMESPACE_START
+{
+	// a std::map lookalike that keeps its entries sorted in one contiguous block (see TOML_FLAT_TABLES).
+	// it only implements what toml::table needs, and keys are anything that converts to a std::string_view.
+	//
+	// unlike std::map, inserting and erasing invalidates iterators and references to the entries that follow
+	// (and all of them if the storage has to grow). inserting anywhere but the end costs O(n).
+	template <typename Key, typename T, typename Allocator>
+	class flat_map
+	{
+	  public:
+		using key_type		 = Key;
+		using mapped_type	 = T;
+		using value_type	 = std::pair<Key, T>;
+		using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+
+	  private:
+		using storage_type = std::vector<value_type, allocator_type>;
+		storage_type entries_;
+
+	  public:
+		using size_type		 = typename storage_type::size_type;
+		using iterator		 = typename storage_type::iterator;
+		using const_iterator = typename storage_type::const_iterator;
+
+		TOML_PURE_INLINE_GETTER
+		iterator begin() noexcept
+		{
+			return entries_.begin();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const_iterator begin() const noexcept
+		{
+			return entries_.begin();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const_iterator cbegin() const noexcept
+		{
+			return entries_.cbegin();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		iterator end() noexcept
+		{
+			return entries_.end();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const_iterator end() const noexcept
+		{
+			return entries_.end();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const_iterator cend() const noexcept
+		{
+			return entries_.cend();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		bool empty() const noexcept
+		{
+			return entries_.empty();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		size_type size() const noexcept
+		{
+			return entries_.size();
+		}
+
+		void clear() noexcept
+		{
+			entries_.clear();
+		}
+
+		TOML_PURE_GETTER
+		iterator lower_bound(std::string_view key) noexcept
+		{
+			// (a binary search with three-way comparisons, so it can stop as soon as it finds the key)
+			size_type first = {};
+			size_type count = entries_.size();
+			while (count)
+			{
+				const size_type half = count / 2u;
+				const int cmp		 = std::string_view{ entries_[first + half].first }.compare(key);
+				if (cmp < 0)
+				{
+					first += half + 1u;
+					count -= half + 1u;
+				}
+				else if (cmp > 0)
+					count = half;
+				else
+				{
+					first += half;
+					break;
+				}
+			}
+			return entries_.begin() + static_cast<typename storage_type::difference_type>(first);
+		}
+
+		TOML_PURE_GETTER
+		const_iterator lower_bound(std::string_view key) const noexcept
+		{
+			return const_cast<flat_map&>(*this).lower_bound(key);
+		}
+
+		TOML_PURE_GETTER
+		iterator find(std::string_view key) noexcept
+		{
+			const auto it = lower_bound(key);
+			return it != entries_.end() && std::string_view{ it->first } == key ? it : entries_.end();
+		}
+
+		TOML_PURE_GETTER
+		const_iterator find(std::string_view key) const noexcept
+		{
+			return const_cast<flat_map&>(*this).find(key);
+		}
+
+		// inserts the entry at the hint if that's where it belongs, otherwise wherever it does belong (if the key
+		// isn't already there; if it is, nothing is inserted and the existing entry is returned).
+		template <typename K>
+		iterator emplace_hint(const_iterator hint, K&& key, T&& value)
+		{
+			const auto key_view = std::string_view{ key };
+			if ((hint == entries_.cbegin() || std::string_view{ (hint - 1)->first } < key_view)
+				&& (hint == entries_.cend() || key_view < std::string_view{ hint->first }))
+				return entries_.emplace(hint, static_cast<K&&>(key), std::move(value));
+
+			const auto it = lower_bound(key_view);
+			if (it != entries_.end() && std::string_view{ it->first } == key_view)
+				return it;
+			return entries_.emplace(it, static_cast<K&&>(key), std::move(value));
+		}
+
+		template <typename K>
+		std::pair<iterator, bool> insert_or_assign(K&& key, T&& value)
+		{
+			const auto key_view = std::string_view{ key };
+			const auto it		= lower_bound(key_view);
+			if (it != entries_.end() && std::string_view{ it->first } == key_view)
+			{
+				it->second = std::move(value);
+				return { it, false };
+			}
+			return { entries_.emplace(it, static_cast<K&&>(key), std::move(value)), true };
+		}
+
+		iterator erase(const_iterator pos) noexcept
+		{
+			return entries_.erase(pos);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) noexcept
+		{
+			return entries_.erase(first, last);
+		}
+	};
+}
+TOML_IMPL_NAMESPACE_END;
+
+#ifdef _MSC_VER
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+#ifndef __clang__
+#pragma inline_recursion(off)
+#endif
+#endif
+TOML_POP_WARNINGS;
+
+//********  impl/std_map.hpp  ******************************************************************************************
+
+TOML_DISABLE_WARNINGS;
+#include <map>
+#include <iterator>
+TOML_ENABLE_WARNINGS;
+
+//********  impl/table.hpp  ********************************************************************************************
+
+TOML_PUSH_WARNINGS;
+#ifdef _MSC_VER
+#ifndef __clang__
+#pragma inline_recursion(on)
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#endif
+
+TOML_IMPL_NAMESPACE_START
+{
+#if TOML_FLAT_TABLES
+	using table_map = flat_map<toml::key, node_ptr, node_allocator<std::pair<toml::key, node_ptr>>>;
+#else
+	using table_map = std::map<toml::key, node_ptr, std::less<>, node_allocator<std::pair<const toml::key, node_ptr>>>;
+#endif
+
+	class table_index;
+
+	template <bool IsConst>
+	struct table_proxy_pair
+	{
+		using value_type = std::conditional_t<IsConst, const node, node>;
+
+		const toml::key& first;
+		value_type& second;
+	};
+
+	template <bool IsConst>
+	class table_iterator
+	{
+	  private:
+		template <bool>
+		friend class table_iterator;
+
+		using proxy_type		   = table_proxy_pair<IsConst>;
+		using mutable_map_iterator = table_map::iterator;
+		using const_map_iterator   = table_map::const_iterator;
+		using map_iterator		   = std::conditional_t<IsConst, const_map_iterator, mutable_map_iterator>;
+
+		mutable map_iterator iter_;
+		alignas(proxy_type) mutable unsigned char proxy_[sizeof(proxy_type)];
+		mutable bool proxy_instantiated_ = false;
+
+		TOML_NODISCARD
+		proxy_type* get_proxy() const noexcept
+		{
+			if (!proxy_instantiated_)
+			{
+				auto p = ::new (static_cast<void*>(proxy_)) proxy_type{ iter_->first, *iter_->second.get() };
+				proxy_instantiated_ = true;
+				return p;
+			}
+			else
+				return TOML_LAUNDER(reinterpret_cast<proxy_type*>(proxy_));
+		}
+
+	  public:
+		TOML_NODISCARD_CTOR
+		table_iterator() noexcept = default;
+
+		TOML_NODISCARD_CTOR
+		explicit table_iterator(mutable_map_iterator iter) noexcept //
+			: iter_{ iter }
+		{}
+
+		TOML_CONSTRAINED_TEMPLATE(C, bool C = IsConst)
+		TOML_NODISCARD_CTOR
+		explicit table_iterator(const_map_iterator iter) noexcept //
+			: iter_{ iter }
+		{}
+
+		TOML_CONSTRAINED_TEMPLATE(C, bool C = IsConst)
+		TOML_NODISCARD_CTOR
+		table_iterator(const table_iterator<false>& other) noexcept //
+			: iter_{ other.iter_ }
+		{}
+
+		TOML_NODISCARD_CTOR
+		table_iterator(const table_iterator& other) noexcept //
+			: iter_{ other.iter_ }
+		{}
+
+		table_iterator& operator=(const table_iterator& rhs) noexcept
+		{
+			iter_				= rhs.iter_;
+			proxy_instantiated_ = false;
+			return *this;
+		}
+
+		using value_type		= table_proxy_pair<IsConst>;
+		using reference			= value_type&;
+		using pointer			= value_type*;
+		using difference_type	= typename std::iterator_traits<map_iterator>::difference_type;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		table_iterator& operator++() noexcept // ++pre
+		{
+			++iter_;
+			proxy_instantiated_ = false;
+			return *this;
+		}
+
+		table_iterator operator++(int) noexcept // post++
+		{
+			table_iterator out{ iter_ };
+			++iter_;
 			proxy_instantiated_ = false;
 			return out;
 		}
@@ -7746,17 +8694,24 @@ TOML_NAMESPACE_START
 
 	using const_table_iterator = POXY_IMPLEMENTATION_DETAIL(impl::table_iterator<true>);
 
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_SOURCES, srcs, nosrcs);
+	TOML_ABI_NAMESPACE_BOOL(TOML_FLAT_TABLES, flattbl, stdtbl);
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenatbl, heaptbl);
+
 	class TOML_EXPORTED_CLASS table : public node
 	{
 	  private:
 
-		using map_type			 = std::map<toml::key, impl::node_ptr, std::less<>>;
-		using map_pair			 = std::pair<const toml::key, impl::node_ptr>;
+		friend class TOML_PARSER_TYPENAME;
+
+		using map_type			 = impl::table_map;
+		using map_pair			 = typename map_type::value_type;
 		using map_iterator		 = typename map_type::iterator;
 		using const_map_iterator = typename map_type::const_iterator;
 		map_type map_;
-
-		bool inline_ = false;
+		// the table's impl::table_index (see TOML_TABLE_INDEX_MIN_KEYS), with the 'inline' flag in the low bit
+		// so the index doesn't cost a table any space
+		mutable std::atomic<uintptr_t> index_{};
 
 		TOML_NODISCARD_CTOR
 		TOML_EXPORTED_MEMBER_FUNCTION
@@ -8003,12 +8958,13 @@ TOML_NAMESPACE_START
 		TOML_PURE_INLINE_GETTER
 		bool is_inline() const noexcept
 		{
-			return inline_;
+			return index_.load(std::memory_order_relaxed) & uintptr_t{ 1 };
 		}
 
 		void is_inline(bool val) noexcept
 		{
-			inline_ = val;
+			const auto bits = index_.load(std::memory_order_relaxed);
+			index_.store((bits & ~uintptr_t{ 1 }) | uintptr_t{ val }, std::memory_order_relaxed);
 		}
 
 		TOML_PURE_GETTER
@@ -8345,6 +9301,13 @@ TOML_NAMESPACE_START
 		TOML_EXPORTED_MEMBER_FUNCTION
 		map_iterator get_lower_bound(std::string_view) noexcept;
 
+		TOML_PURE_GETTER
+		TOML_EXPORTED_MEMBER_FUNCTION
+		map_iterator find_in_map(std::string_view) const noexcept;
+
+		TOML_EXPORTED_MEMBER_FUNCTION
+		void drop_index() noexcept;
+
 	  public:
 
 		TOML_PURE_GETTER
@@ -8751,6 +9714,10 @@ TOML_NAMESPACE_START
 
 #endif
 	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_ARENA
+	TOML_ABI_NAMESPACE_END; // TOML_FLAT_TABLES
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_SOURCES
 }
 TOML_NAMESPACE_END;
 
@@ -9159,14 +10126,112 @@ TOML_IMPL_NAMESPACE_END;
 #endif
 TOML_POP_WARNINGS;
 
-//********  impl/parse_error.hpp  **************************************************************************************
-
-#if TOML_ENABLE_PARSER
+//********  impl/simd.hpp  *********************************************************************************************
 
-//********  impl/std_except.hpp  ***************************************************************************************
+#if TOML_ENABLE_SIMD
 
-TOML_DISABLE_WARNINGS;
-#if TOML_EXCEPTIONS
+#if defined(__SSE2__)                                                                                                  \
+	|| (defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define TOML_HAS_SSE2 1
+#endif
+
+#if defined(__SSE4_1__) || (defined(_MSC_VER) && (defined(__AVX__) || defined(__AVX2__)))
+#define TOML_HAS_SSE4_1 1
+#endif
+
+// runtime dispatch between the scalar/SSE2/AVX2/AVX-512 kernels (x86 + x64 only)
+#if (TOML_ARCH_AMD64 || TOML_ARCH_X86) && !TOML_CUDA && !TOML_INTELLISENSE                                            \
+	&& (TOML_CLANG >= 8 || TOML_GCC >= 7 || TOML_MSVC >= 1920)
+#define TOML_HAS_SIMD_DISPATCH 1
+#endif
+
+#endif // TOML_ENABLE_SIMD
+
+#ifndef TOML_HAS_SSE2
+#define TOML_HAS_SSE2 0
+#endif
+#ifndef TOML_HAS_SSE4_1
+#define TOML_HAS_SSE4_1 0
+#endif
+#ifndef TOML_HAS_SIMD_DISPATCH
+#define TOML_HAS_SIMD_DISPATCH 0
+#endif
+
+TOML_PUSH_WARNINGS;
+#ifdef _MSC_VER
+#ifndef __clang__
+#pragma inline_recursion(on)
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#endif
+
+TOML_IMPL_NAMESPACE_START
+{
+	enum class simd_level : unsigned char
+	{
+		scalar,
+		sse2,
+		avx2,
+		avx512bw
+	};
+
+	// the bulk scanning kernels used by the parser.
+	// all of the 'find' kernels take a [begin, end) range and return a pointer to the first matching byte (or end).
+	struct simd_kernels
+	{
+		simd_level level;
+
+		// true if every byte in the range is < 0x80
+		bool (*is_ascii)(const char*, size_t) noexcept;
+
+		// first byte of the first invalid or truncated utf-8 sequence
+		const char* (*find_invalid_utf8)(const char*, const char*) noexcept;
+
+		// first byte that isn't a space or tab
+		const char* (*find_non_whitespace)(const char*, const char*) noexcept;
+
+		// first byte that ends a comment: a control character other than tab (which includes line breaks)
+		const char* (*find_comment_terminator)(const char*, const char*) noexcept;
+
+		// first byte that needs special handling in a string body:
+		// the delimiter, the escape character, or a control character other than tab
+		const char* (*find_string_terminator)(const char*, const char*, char delimiter, char escape) noexcept;
+	};
+
+	// the kernels for a particular level, or nullptr if the build or host machine doesn't support it
+	TOML_NODISCARD
+	const simd_kernels* get_simd_kernels(simd_level level) noexcept;
+
+	// the kernels currently used by the parser (defaults to the best level supported by the host machine)
+	TOML_NODISCARD
+	const simd_kernels& simd() noexcept;
+
+	// changes the kernels used by the parser; returns false if the level isn't supported.
+	// intended for testing and benchmarking.
+	bool set_simd_level(simd_level level) noexcept;
+}
+TOML_IMPL_NAMESPACE_END;
+
+#ifdef _MSC_VER
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+#ifndef __clang__
+#pragma inline_recursion(off)
+#endif
+#endif
+TOML_POP_WARNINGS;
+
+//********  impl/parse_error.hpp  **************************************************************************************
+
+#if TOML_ENABLE_PARSER
+
+//********  impl/std_except.hpp  ***************************************************************************************
+
+TOML_DISABLE_WARNINGS;
+#if TOML_EXCEPTIONS
 #include <stdexcept>
 #endif
 TOML_ENABLE_WARNINGS;
@@ -9653,8 +10718,77 @@ TOML_PUSH_WARNINGS;
 #undef max
 #endif
 
+TOML_IMPL_NAMESPACE_START
+{
+	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, impl_ex, impl_noex);
+
+	class incremental_parser_state;
+	class lazy_document_state;
+
+	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
+}
+TOML_IMPL_NAMESPACE_END;
+
 TOML_NAMESPACE_START
 {
+	class sax_handler
+	{
+	  public:
+
+		virtual ~sax_handler() noexcept = default;
+
+		virtual void on_table_header([[maybe_unused]] const key* keys,
+									 [[maybe_unused]] size_t count,
+									 [[maybe_unused]] bool is_array_of_tables)
+		{}
+
+		virtual void on_key([[maybe_unused]] const key* keys, [[maybe_unused]] size_t count)
+		{}
+
+		virtual void on_value([[maybe_unused]] const node& val)
+		{}
+
+		virtual void on_array_begin()
+		{}
+
+		virtual void on_array_end()
+		{}
+
+		virtual void on_inline_table_begin()
+		{}
+
+		virtual void on_inline_table_end()
+		{}
+	};
+
+	struct parse_options
+	{
+		std::vector<toml::path> keep_paths;
+
+		size_t threads = 1;
+
+		size_t min_bytes_per_thread = TOML_PARALLEL_PARSE_MIN_BYTES;
+
+		bool use_arena = false;
+
+		key_pool* interned_keys = nullptr;
+
+		bool omit_sources = false;
+
+#if TOML_HAS_MEMORY_RESOURCE && TOML_ENABLE_ARENA
+
+		std::pmr::memory_resource* memory_resource = nullptr;
+
+#endif
+	};
+
+	struct borrow_document_t
+	{
+		explicit borrow_document_t() = default;
+	};
+
+	inline constexpr borrow_document_t borrow_document{};
+
 	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, ex, noex);
 
 	TOML_NODISCARD
@@ -9717,6 +10851,214 @@ TOML_NAMESPACE_START
 	TOML_EXPORTED_FREE_FUNCTION
 	parse_result TOML_CALLCONV parse(std::istream & doc, std::string && source_path);
 
+	class TOML_EXPORTED_CLASS incremental_parser
+	{
+	  private:
+
+		std::unique_ptr<impl::incremental_parser_state> state_;
+
+	  public:
+
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		explicit incremental_parser(std::string_view source_path = {});
+
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		explicit incremental_parser(std::string && source_path);
+
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		incremental_parser(incremental_parser && other) noexcept;
+
+		TOML_EXPORTED_MEMBER_FUNCTION
+		incremental_parser& operator=(incremental_parser&& rhs) noexcept;
+
+		TOML_EXPORTED_MEMBER_FUNCTION
+		~incremental_parser() noexcept;
+
+		TOML_EXPORTED_MEMBER_FUNCTION
+		void feed(std::string_view chunk);
+
+		TOML_PURE_GETTER
+		TOML_EXPORTED_MEMBER_FUNCTION
+		bool failed() const noexcept;
+
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		parse_result finish();
+	};
+
+	class TOML_EXPORTED_CLASS lazy_document
+	{
+	  private:
+
+		std::unique_ptr<impl::lazy_document_state> state_;
+
+	  public:
+
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		explicit lazy_document(std::string_view doc, std::string_view source_path = {});
+
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		lazy_document(borrow_document_t, std::string_view doc, std::string_view source_path = {});
+
+		TOML_NODISCARD_CTOR
+		TOML_EXPORTED_MEMBER_FUNCTION
+		lazy_document(lazy_document && other) noexcept;
+
+		TOML_EXPORTED_MEMBER_FUNCTION
+		lazy_document& operator=(lazy_document&& rhs) noexcept;
+
+		TOML_EXPORTED_MEMBER_FUNCTION
+		~lazy_document() noexcept;
+
+		TOML_PURE_GETTER
+		TOML_EXPORTED_MEMBER_FUNCTION
+		bool failed() const noexcept;
+
+#if !TOML_EXCEPTIONS
+
+		TOML_PURE_GETTER
+		TOML_EXPORTED_MEMBER_FUNCTION
+		const parse_error& error() const noexcept;
+
+#endif
+
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		node_view<node> operator[](std::string_view key);
+
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		node_view<node> at_path(std::string_view path);
+
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		node_view<node> at_path(const toml::path& path);
+
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		optional<std::string_view> string_at(std::string_view path);
+
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		optional<std::string_view> string_at(const toml::path& path);
+
+		TOML_NODISCARD
+		TOML_EXPORTED_MEMBER_FUNCTION
+		toml::table& table();
+	};
+
+#if TOML_EXCEPTIONS
+
+	TOML_EXPORTED_FREE_FUNCTION
+	void TOML_CALLCONV parse(std::string_view doc, sax_handler & handler, std::string_view source_path = {});
+
+	TOML_EXPORTED_FREE_FUNCTION
+	void TOML_CALLCONV parse(std::istream & doc, sax_handler & handler, std::string_view source_path = {});
+
+	TOML_EXPORTED_FREE_FUNCTION
+	void TOML_CALLCONV parse_file(std::string_view file_path, sax_handler & handler);
+
+#else
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	optional<parse_error> TOML_CALLCONV parse(std::string_view doc,
+											  sax_handler & handler,
+											  std::string_view source_path = {});
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	optional<parse_error> TOML_CALLCONV parse(std::istream & doc,
+											  sax_handler & handler,
+											  std::string_view source_path = {});
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	optional<parse_error> TOML_CALLCONV parse_file(std::string_view file_path, sax_handler & handler);
+
+#endif
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	parse_result TOML_CALLCONV parse(std::string_view doc,
+									 const parse_options& options,
+									 std::string_view source_path = {});
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	parse_result TOML_CALLCONV parse(std::istream & doc,
+									 const parse_options& options,
+									 std::string_view source_path = {});
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	parse_result TOML_CALLCONV parse_file(std::string_view file_path, const parse_options& options);
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::string_view* first,
+													   const std::string_view* last,
+													   const parse_options& options = {});
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::string_view* first,
+													   const std::string_view* last,
+													   std::vector<optional<parse_error>>& errors,
+													   const parse_options& options = {});
+
+	TOML_NODISCARD
+	TOML_ALWAYS_INLINE
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::vector<std::string_view>& docs,
+													   const parse_options& options = {})
+	{
+		return parse_many(docs.data(), docs.data() + docs.size(), options);
+	}
+
+	TOML_NODISCARD
+	TOML_ALWAYS_INLINE
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::vector<std::string_view>& docs,
+													   std::vector<optional<parse_error>>& errors,
+													   const parse_options& options = {})
+	{
+		return parse_many(docs.data(), docs.data() + docs.size(), errors, options);
+	}
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::string_view* first,
+														const std::string_view* last,
+														const parse_options& options = {});
+
+	TOML_NODISCARD
+	TOML_EXPORTED_FREE_FUNCTION
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::string_view* first,
+														const std::string_view* last,
+														std::vector<optional<parse_error>>& errors,
+														const parse_options& options = {});
+
+	TOML_NODISCARD
+	TOML_ALWAYS_INLINE
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::vector<std::string_view>& file_paths,
+														const parse_options& options = {})
+	{
+		return parse_files(file_paths.data(), file_paths.data() + file_paths.size(), options);
+	}
+
+	TOML_NODISCARD
+	TOML_ALWAYS_INLINE
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::vector<std::string_view>& file_paths,
+														std::vector<optional<parse_error>>& errors,
+														const parse_options& options = {})
+	{
+		return parse_files(file_paths.data(), file_paths.data() + file_paths.size(), errors, options);
+	}
+
 	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
 
 	inline namespace literals
@@ -10859,8 +12201,11 @@ TOML_IMPL_NAMESPACE_END;
 #endif
 TOML_POP_WARNINGS;
 
-//********  impl/node.inl  *********************************************************************************************
+//********  impl/node_arena.inl  ***************************************************************************************
 
+TOML_DISABLE_WARNINGS;
+#include <atomic>
+TOML_ENABLE_WARNINGS;
 TOML_PUSH_WARNINGS;
 #ifdef _MSC_VER
 #ifndef __clang__
@@ -10872,7 +12217,383 @@ TOML_PUSH_WARNINGS;
 #undef max
 #endif
 
-TOML_NAMESPACE_START
+TOML_ANON_NAMESPACE_START
+{
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	impl::node_arena*& active_node_arena() noexcept
+	{
+		static thread_local impl::node_arena* arena = {};
+		return arena;
+	}
+
+	// frees counted by a node_free_batch on the current thread that haven't been settled with their arena yet
+	struct pending_node_frees
+	{
+		impl::node_arena* arena;
+		size_t count;
+		size_t batches;
+	};
+
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	pending_node_frees& pending_frees() noexcept
+	{
+		static thread_local pending_node_frees frees = {};
+		return frees;
+	}
+}
+TOML_ANON_NAMESPACE_END;
+
+TOML_IMPL_NAMESPACE_START
+{
+	TOML_ABI_NAMESPACE_BOOL(TOML_ENABLE_ARENA, arenas, noarenas);
+
+	// a monotonic arena owned by a parser (or a memory_resource_scope). allocations are pointer-bumps out of large
+	// blocks, and rather than being freed one at a time the blocks are all released together once the owner is done
+	// with the arena and everything allocated from it has been freed (by whichever thread gets there last).
+	//
+	// every allocation (including those from the global heap) starts with a header holding a pointer to the arena it
+	// came from, or null if it didn't come from one. that way it can all be freed without knowing where it came from,
+	// which means nodes can be moved freely between documents (or out of them entirely).
+	class node_arena
+	{
+	  private:
+		struct block
+		{
+			block* next;
+			size_t size;
+		};
+
+		// (a pointer, padded to keep allocations 8-byte aligned on 32-bit targets)
+		static constexpr size_t header_size		 = 8u;
+		static constexpr size_t first_block_size = 16u * 1024u;
+		static constexpr size_t max_block_size	 = 1024u * 1024u;
+		static_assert(sizeof(node_arena*) <= header_size);
+		static_assert(sizeof(block) % 8u == 0u);
+
+		// the owner's allocations aren't counted atomically; instead this is added to the balance up front, and
+		// swapped for the real count once the owner is done allocating.
+		static constexpr ptrdiff_t owner_bias = (std::numeric_limits<ptrdiff_t>::max)() / 2;
+
+		block* blocks_			= {};
+		char* pos_				= {};
+		char* end_				= {};
+		size_t next_block_size_ = first_block_size;
+		size_t allocations_		= {};
+		std::atomic<ptrdiff_t> balance_{ owner_bias };
+#if TOML_HAS_MEMORY_RESOURCE
+		std::pmr::memory_resource* upstream_ = {};
+#endif
+
+		node_arena() noexcept = default;
+
+		TOML_NODISCARD
+		void* allocate_upstream(size_t size)
+		{
+#if TOML_HAS_MEMORY_RESOURCE
+			if (upstream_)
+				return upstream_->allocate(size, alignof(std::max_align_t));
+#endif
+			return ::operator new(size);
+		}
+
+		void deallocate_upstream(void* ptr, size_t size) noexcept
+		{
+#if TOML_HAS_MEMORY_RESOURCE
+			if (upstream_)
+				return upstream_->deallocate(ptr, size, alignof(std::max_align_t));
+#endif
+			TOML_UNUSED(size);
+			::operator delete(ptr);
+		}
+
+		void destroy() noexcept
+		{
+			while (blocks_)
+			{
+				const auto blk = std::exchange(blocks_, blocks_->next);
+				deallocate_upstream(blk, blk->size);
+			}
+
+#if TOML_HAS_MEMORY_RESOURCE
+			if (const auto upstream = upstream_)
+			{
+				this->~node_arena();
+				upstream->deallocate(this, sizeof(node_arena), alignof(node_arena));
+				return;
+			}
+#endif
+			delete this;
+		}
+
+		TOML_NEVER_INLINE
+		char* allocate_block(size_t size)
+		{
+			// big allocations get a block of their own so the rest of the current one isn't wasted
+			const bool dedicated	= size > next_block_size_ / 4u;
+			const size_t block_size = dedicated ? sizeof(block) + size : next_block_size_;
+
+			blocks_		= ::new (allocate_upstream(block_size)) block{ blocks_, block_size };
+			const auto data = reinterpret_cast<char*>(blocks_ + 1);
+			if (dedicated)
+				return data;
+
+			pos_ = data + size;
+			end_ = reinterpret_cast<char*>(blocks_) + block_size;
+			if (next_block_size_ < max_block_size)
+				next_block_size_ *= 2u;
+			return data;
+		}
+
+	  public:
+		TOML_DELETE_DEFAULTS(node_arena);
+
+		TOML_NODISCARD
+		static node_arena* create()
+		{
+			return new node_arena;
+		}
+
+#if TOML_HAS_MEMORY_RESOURCE
+
+		// (the arena itself comes from the resource too)
+		TOML_NODISCARD
+		static node_arena* create(std::pmr::memory_resource* upstream)
+		{
+			if (!upstream)
+				return create();
+
+			const auto arena = ::new (upstream->allocate(sizeof(node_arena), alignof(node_arena))) node_arena;
+			arena->upstream_ = upstream;
+			return arena;
+		}
+
+#endif
+
+		// a new arena getting its memory from the same place as this one
+		TOML_NODISCARD
+		node_arena* create_next() const
+		{
+#if TOML_HAS_MEMORY_RESOURCE
+			return create(upstream_);
+#else
+			return create();
+#endif
+		}
+
+		// takes count frees off the balance (destroying the arena if that was the last of its allocations)
+		void settle(size_t count) noexcept
+		{
+			const auto frees = static_cast<ptrdiff_t>(count);
+			if (balance_.fetch_sub(frees, std::memory_order_acq_rel) == frees)
+				destroy();
+		}
+
+		// called by the owner once it's done allocating
+		void release() noexcept
+		{
+			const auto delta = static_cast<ptrdiff_t>(allocations_) - owner_bias;
+			if (balance_.fetch_add(delta, std::memory_order_acq_rel) + delta == 0)
+				destroy();
+		}
+
+		TOML_NODISCARD
+		void* allocate(size_t size)
+		{
+			size = (header_size + size + 7u) & ~size_t{ 7u };
+
+			char* ptr;
+			if (size <= static_cast<size_t>(end_ - pos_))
+			{
+				ptr = pos_;
+				pos_ += size;
+			}
+			else
+				ptr = allocate_block(size);
+
+			allocations_++;
+			::new (static_cast<void*>(ptr)) node_arena*{ this };
+			return ptr + header_size;
+		}
+
+		TOML_NODISCARD
+		static void* allocate_heap(size_t size)
+		{
+			const auto ptr = static_cast<char*>(::operator new(header_size + size));
+			::new (static_cast<void*>(ptr)) node_arena*{ nullptr };
+			return ptr + header_size;
+		}
+
+		// frees something from allocate() or allocate_heap()
+		static void deallocate(void* ptr) noexcept
+		{
+			const auto base	 = static_cast<char*>(ptr) - header_size;
+			const auto arena = *static_cast<node_arena**>(static_cast<void*>(base));
+			if (!arena)
+			{
+				::operator delete(base);
+				return;
+			}
+
+			// inside a node_free_batch the free is just counted, and settled with the arena once the batch ends
+			// (or another arena's allocation is freed in it)
+			auto& pending = TOML_ANON_NAMESPACE::pending_frees();
+			if (pending.batches)
+			{
+				if (pending.arena != arena)
+				{
+					if (pending.arena)
+						pending.arena->settle(pending.count);
+					pending.arena = arena;
+					pending.count = {};
+				}
+				pending.count++;
+				return;
+			}
+
+			arena->settle(1u);
+		}
+	};
+
+	// while one of these is alive, frees of arena allocations on the current thread don't touch the arena's atomic
+	// balance one at a time; they're settled together when the outermost batch ends. tables and arrays free their
+	// contents inside one, so tearing down a document costs a single atomic operation rather than one per node.
+	class node_free_batch
+	{
+	  public:
+		TOML_NODISCARD_CTOR
+		node_free_batch() noexcept
+		{
+			TOML_ANON_NAMESPACE::pending_frees().batches++;
+		}
+
+		~node_free_batch() noexcept
+		{
+			auto& pending = TOML_ANON_NAMESPACE::pending_frees();
+			if (--pending.batches || !pending.arena)
+				return;
+
+			std::exchange(pending.arena, nullptr)->settle(std::exchange(pending.count, size_t{}));
+		}
+
+		TOML_DELETE_DEFAULTS(node_free_batch);
+	};
+
+	// makes an arena the source of new nodes on the current thread (or leaves things as they are if it's null)
+	class node_arena_scope
+	{
+	  private:
+		node_arena* prev_;
+
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit node_arena_scope(node_arena* arena) noexcept //
+			: prev_{ TOML_ANON_NAMESPACE::active_node_arena() }
+		{
+			if (arena)
+				TOML_ANON_NAMESPACE::active_node_arena() = arena;
+		}
+
+		~node_arena_scope() noexcept
+		{
+			TOML_ANON_NAMESPACE::active_node_arena() = prev_;
+		}
+
+		TOML_DELETE_DEFAULTS(node_arena_scope);
+	};
+
+	// makes the global heap the source of new nodes on the current thread, whether or not an arena was active
+	// (e.g. for the keys of a key_pool, which outlive the documents that intern them)
+	class node_heap_scope
+	{
+	  private:
+		node_arena* prev_;
+
+	  public:
+		TOML_NODISCARD_CTOR
+		node_heap_scope() noexcept //
+			: prev_{ std::exchange(TOML_ANON_NAMESPACE::active_node_arena(), nullptr) }
+		{}
+
+		~node_heap_scope() noexcept
+		{
+			TOML_ANON_NAMESPACE::active_node_arena() = prev_;
+		}
+
+		TOML_DELETE_DEFAULTS(node_heap_scope);
+	};
+
+	TOML_EXTERNAL_LINKAGE
+	void* TOML_CALLCONV node_allocate(size_t size)
+	{
+#if TOML_ENABLE_ARENA
+		if (const auto arena = TOML_ANON_NAMESPACE::active_node_arena())
+			return arena->allocate(size);
+		return node_arena::allocate_heap(size);
+#else
+		return ::operator new(size);
+#endif
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	void TOML_CALLCONV node_deallocate(void* ptr, size_t /*size*/) noexcept
+	{
+#if TOML_ENABLE_ARENA
+		node_arena::deallocate(ptr);
+#else
+		::operator delete(ptr);
+#endif
+	}
+
+	TOML_ABI_NAMESPACE_END; // TOML_ENABLE_ARENA
+}
+TOML_IMPL_NAMESPACE_END;
+
+#if TOML_HAS_MEMORY_RESOURCE
+
+TOML_NAMESPACE_START
+{
+	TOML_EXTERNAL_LINKAGE
+	memory_resource_scope::memory_resource_scope(std::pmr::memory_resource* resource) //
+		: arena_{ impl::node_arena::create(resource) },
+		  prev_{ std::exchange(TOML_ANON_NAMESPACE::active_node_arena(), arena_) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	memory_resource_scope::~memory_resource_scope() noexcept
+	{
+		TOML_ANON_NAMESPACE::active_node_arena() = prev_;
+		arena_->release();
+	}
+}
+TOML_NAMESPACE_END;
+
+#endif // TOML_HAS_MEMORY_RESOURCE
+
+#ifdef _MSC_VER
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+#ifndef __clang__
+#pragma inline_recursion(off)
+#endif
+#endif
+TOML_POP_WARNINGS;
+
+//********  impl/node.inl  *********************************************************************************************
+
+TOML_PUSH_WARNINGS;
+#ifdef _MSC_VER
+#ifndef __clang__
+#pragma inline_recursion(on)
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#endif
+
+TOML_NAMESPACE_START
 {
 	TOML_EXTERNAL_LINKAGE
 	node::node() noexcept = default;
@@ -10882,8 +12603,15 @@ TOML_NAMESPACE_START
 
 	TOML_EXTERNAL_LINKAGE
 	node::node(node && other) noexcept //
-		: source_{ std::exchange(other.source_, {}) }
-	{}
+	{
+#if TOML_ENABLE_SOURCES
+		// (copied rather than moved so the path is owned again if it was borrowed from the document other was in)
+		source_		  = other.source_;
+		other.source_ = {};
+#else
+		TOML_UNUSED(other);
+#endif
+	}
 
 	TOML_EXTERNAL_LINKAGE
 	node::node(const node& /*other*/) noexcept
@@ -10900,15 +12628,25 @@ TOML_NAMESPACE_START
 		//
 		// see https://github.com/marzer/tomlplusplus/issues/49#issuecomment-665089577
 
+#if TOML_ENABLE_SOURCES
 		source_ = {};
+#endif
 		return *this;
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	node& node::operator=(node&& rhs) noexcept
 	{
+#if TOML_ENABLE_SOURCES
 		if (&rhs != this)
-			source_ = std::exchange(rhs.source_, {});
+		{
+			// (see the move constructor)
+			source_		= rhs.source_;
+			rhs.source_ = {};
+		}
+#else
+		TOML_UNUSED(rhs);
+#endif
 		return *this;
 	}
 
@@ -11821,6 +13559,13 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	array::~array() noexcept
 	{
+#if TOML_ENABLE_ARENA
+		{
+			const impl::node_free_batch batch;
+			const auto contents = std::move(elems_);
+		}
+#endif
+
 #if TOML_LIFETIME_HOOKS
 		TOML_ARRAY_DESTROYED;
 #endif
@@ -11900,6 +13645,9 @@ TOML_NAMESPACE_START
 		if (&rhs != this)
 		{
 			node::operator=(std::move(rhs));
+#if TOML_ENABLE_ARENA
+			const impl::node_free_batch batch;
+#endif
 			elems_ = std::move(rhs.elems_);
 		}
 		return *this;
@@ -12144,6 +13892,9 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	void array::clear() noexcept
 	{
+#if TOML_ENABLE_ARENA
+		const impl::node_free_batch batch;
+#endif
 		elems_.clear();
 	}
 
@@ -12182,7 +13933,7 @@ TOML_NAMESPACE_END;
 #endif
 TOML_POP_WARNINGS;
 
-//********  impl/table.inl  ********************************************************************************************
+//********  impl/linear_probing.inl  ***********************************************************************************
 
 TOML_PUSH_WARNINGS;
 #ifdef _MSC_VER
@@ -12195,39 +13946,315 @@ TOML_PUSH_WARNINGS;
 #undef max
 #endif
 
-TOML_NAMESPACE_START
+TOML_IMPL_NAMESPACE_START
 {
-	TOML_EXTERNAL_LINKAGE
-	table::table() noexcept
-	{
-#if TOML_LIFETIME_HOOKS
-		TOML_TABLE_CREATED;
-#endif
-	}
-
-	TOML_EXTERNAL_LINKAGE
-	table::~table() noexcept
-	{
-#if TOML_LIFETIME_HOOKS
-		TOML_TABLE_DESTROYED;
-#endif
-	}
-
-	TOML_EXTERNAL_LINKAGE
-	table::table(const impl::table_init_pair* b, const impl::table_init_pair* e)
-	{
-#if TOML_LIFETIME_HOOKS
-		TOML_TABLE_CREATED;
-#endif
+	// the probing, growth and deletion logic of the library's open-addressing hash sets (impl::key_set,
+	// impl::table_index and the parser's node_set and value_key_set). each of them owns its own power-of-two array of
+	// slots (allocated however suits it), and describes those slots with a Traits type:
+	//
+	//	static bool empty(const Slot&) noexcept;	// whether the slot is unused (a value-initialized Slot must be)
+	//	static size_t hash(const Slot&) noexcept;	// the hash the slot's contents were placed with
+	template <typename Slot, typename Traits>
+	struct linear_probing
+	{
+		static constexpr size_t min_capacity = 16u;
+
+		// (sets are kept at most half full)
+		TOML_CONST_INLINE_GETTER
+		static constexpr bool needs_growth(size_t count, size_t capacity) noexcept
+		{
+			return (count + 1u) * 2u > capacity;
+		}
 
-		TOML_ASSERT_ASSUME(b);
-		TOML_ASSERT_ASSUME(e);
-		TOML_ASSERT_ASSUME(b <= e);
+		TOML_CONST_INLINE_GETTER
+		static constexpr size_t grown_capacity(size_t capacity) noexcept
+		{
+			return capacity ? capacity * 2u : min_capacity;
+		}
 
-		if TOML_UNLIKELY(b == e)
-			return;
+		// the capacity needed to hold count slots without growing
+		TOML_CONST_GETTER
+		static constexpr size_t capacity_for(size_t count) noexcept
+		{
+			size_t capacity = min_capacity;
+			while (capacity < count * 2u)
+				capacity *= 2u;
+			return capacity;
+		}
 
-		for (; b != e; b++)
+		// the first slot along the probe sequence of hash h for which is_match returns true, or the empty slot that
+		// ends the sequence if it never does
+		template <typename Match>
+		TOML_NODISCARD
+		static Slot& find(Slot* slots, size_t mask, size_t h, Match&& is_match) noexcept
+		{
+			for (size_t i = h & mask;; i = (i + 1u) & mask)
+				if (Traits::empty(slots[i]) || static_cast<Match&&>(is_match)(static_cast<const Slot&>(slots[i])))
+					return slots[i];
+		}
+
+		// puts something that isn't in the set yet into the first empty slot along its probe sequence
+		static Slot& place(Slot* slots, size_t mask, Slot&& s) noexcept
+		{
+			size_t i = Traits::hash(s) & mask;
+			while (!Traits::empty(slots[i]))
+				i = (i + 1u) & mask;
+			slots[i] = static_cast<Slot&&>(s);
+			return slots[i];
+		}
+
+		// moves everything from one array of slots into another (empty) one
+		static void rehash(Slot* from, size_t from_capacity, Slot* to, size_t to_mask) noexcept
+		{
+			for (size_t i = 0; i < from_capacity; i++)
+				if (!Traits::empty(from[i]))
+					place(to, to_mask, static_cast<Slot&&>(from[i]));
+		}
+
+		// empties an occupied slot. rather than leaving a tombstone, anything after it that could no longer be found
+		// is shifted back, so lookups always stop at the first empty slot.
+		static void erase(Slot* slots, size_t mask, Slot& erased) noexcept
+		{
+			TOML_ASSERT_ASSUME(!Traits::empty(erased));
+
+			auto i = static_cast<size_t>(&erased - slots);
+			for (size_t j = (i + 1u) & mask; !Traits::empty(slots[j]); j = (j + 1u) & mask)
+			{
+				// (slots[j] can fill the gap unless its home slot lies (cyclically) after the gap)
+				if (((j - (Traits::hash(slots[j]) & mask)) & mask) >= ((j - i) & mask))
+				{
+					slots[i] = static_cast<Slot&&>(slots[j]);
+					i		 = j;
+				}
+			}
+			slots[i] = Slot{};
+		}
+	};
+}
+TOML_IMPL_NAMESPACE_END;
+
+#ifdef _MSC_VER
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+#ifndef __clang__
+#pragma inline_recursion(off)
+#endif
+#endif
+TOML_POP_WARNINGS;
+
+//********  impl/table.inl  ********************************************************************************************
+
+TOML_PUSH_WARNINGS;
+#ifdef _MSC_VER
+#ifndef __clang__
+#pragma inline_recursion(on)
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#endif
+
+TOML_IMPL_NAMESPACE_START
+{
+	// an open-addressing hash index over the keys of a wide table, built the first time one of its keys is looked
+	// up (see TOML_TABLE_INDEX_MIN_KEYS) and kept up to date as keys are inserted and erased. nothing here throws;
+	// if memory runs out (or a flat table shifts its elements) the table just drops its index and goes back to
+	// searching the map until the next lookup builds a new one.
+	class table_index
+	{
+	  private:
+		// (entries are referred to by iterator, or by position with flat tables, since those iterators don't last)
+#if TOML_FLAT_TABLES
+		using ref_type = size_t;
+#else
+		using ref_type = table_map::iterator;
+#endif
+
+		struct slot
+		{
+			size_t hash; // 0 == empty
+			ref_type ref;
+		};
+
+		struct slot_traits
+		{
+			TOML_PURE_INLINE_GETTER
+			static bool empty(const slot& s) noexcept
+			{
+				return !s.hash;
+			}
+
+			TOML_PURE_INLINE_GETTER
+			static size_t hash(const slot& s) noexcept
+			{
+				return s.hash;
+			}
+		};
+		using probing = linear_probing<slot, slot_traits>;
+
+		std::unique_ptr<slot[]> slots_;
+		size_t mask_  = {};
+		size_t count_ = {};
+
+		TOML_PURE_GETTER
+		static size_t hash(std::string_view key) noexcept
+		{
+			const auto h = std::hash<std::string_view>{}(key);
+			return h ? h : size_t{ 1 };
+		}
+
+		TOML_NODISCARD
+		static ref_type ref_of(table_map & map, table_map::const_iterator it) noexcept
+		{
+#if TOML_FLAT_TABLES
+			return static_cast<size_t>(it - map.cbegin());
+#else
+			return map.erase(it, it); // (a no-op that gives a mutable iterator)
+#endif
+		}
+
+		TOML_NODISCARD
+		static table_map::iterator iterator_of(table_map & map, ref_type ref) noexcept
+		{
+#if TOML_FLAT_TABLES
+			return map.begin() + static_cast<ptrdiff_t>(ref);
+#else
+			TOML_UNUSED(map);
+			return ref;
+#endif
+		}
+
+		TOML_NODISCARD
+		bool rebuild(table_map & map, size_t capacity) noexcept
+		{
+			slots_.reset(new (std::nothrow) slot[capacity]{});
+			if (!slots_)
+				return false;
+
+			mask_  = capacity - 1u;
+			count_ = map.size();
+			for (auto it = map.begin(); it != map.end(); it++)
+				probing::place(slots_.get(), mask_, slot{ hash(it->first), ref_of(map, it) });
+			return true;
+		}
+
+	  public:
+		TOML_NODISCARD
+		static table_index* create(table_map & map) noexcept
+		{
+			auto idx = new (std::nothrow) table_index;
+			if (idx && !idx->rebuild(map, probing::capacity_for(map.size())))
+			{
+				delete idx;
+				idx = nullptr;
+			}
+			return idx;
+		}
+
+		TOML_PURE_GETTER
+		table_map::iterator find(table_map & map, std::string_view key) const noexcept
+		{
+			const auto h  = hash(key);
+			const auto& s = probing::find(slots_.get(),
+										  mask_,
+										  h,
+										  [&](const slot& candidate) noexcept
+										  { return candidate.hash == h && iterator_of(map, candidate.ref)->first == key; });
+			return slot_traits::empty(s) ? map.end() : iterator_of(map, s.ref);
+		}
+
+		// called after inserting the element at 'pos'. returns false if the index couldn't be updated.
+		TOML_NODISCARD
+		bool insert(table_map & map, table_map::const_iterator pos) noexcept
+		{
+			const auto ref = ref_of(map, pos);
+#if TOML_FLAT_TABLES
+			// (everything after it moved up one; renumbering them all on every insert would make filling a table
+			// quadratic, so unless it went on the end the index is dropped and rebuilt by the next lookup instead)
+			if (ref + 1u < map.size())
+				return false;
+#endif
+			if (probing::needs_growth(count_, mask_ + 1u))
+				return rebuild(map, probing::grown_capacity(mask_ + 1u));
+
+			probing::place(slots_.get(), mask_, slot{ hash(pos->first), ref });
+			count_++;
+			return true;
+		}
+
+		// called before erasing the element at 'pos'. returns false if the index couldn't be updated.
+		TOML_NODISCARD
+		bool erase(table_map & map, table_map::const_iterator pos) noexcept
+		{
+			const auto ref = ref_of(map, pos);
+#if TOML_FLAT_TABLES
+			// (as above; everything after it is about to move down one)
+			if (ref + 1u < map.size())
+				return false;
+#endif
+
+			auto& s = probing::find(slots_.get(),
+									mask_,
+									hash(pos->first),
+									[&](const slot& candidate) noexcept { return candidate.ref == ref; });
+			probing::erase(slots_.get(), mask_, s);
+			count_--;
+			return true;
+		}
+	};
+
+	TOML_CONST_GETTER
+	TOML_INTERNAL_LINKAGE
+	table_index* table_index_of(uintptr_t bits) noexcept
+	{
+		return reinterpret_cast<table_index*>(bits & ~uintptr_t{ 1 }); // (the low bit is table::is_inline())
+	}
+}
+TOML_IMPL_NAMESPACE_END;
+
+TOML_NAMESPACE_START
+{
+	TOML_EXTERNAL_LINKAGE
+	table::table() noexcept
+	{
+#if TOML_LIFETIME_HOOKS
+		TOML_TABLE_CREATED;
+#endif
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	table::~table() noexcept
+	{
+		drop_index();
+
+#if TOML_ENABLE_ARENA
+		{
+			const impl::node_free_batch batch;
+			const auto contents = std::move(map_);
+		}
+#endif
+
+#if TOML_LIFETIME_HOOKS
+		TOML_TABLE_DESTROYED;
+#endif
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	table::table(const impl::table_init_pair* b, const impl::table_init_pair* e)
+	{
+#if TOML_LIFETIME_HOOKS
+		TOML_TABLE_CREATED;
+#endif
+
+		TOML_ASSERT_ASSUME(b);
+		TOML_ASSERT_ASSUME(e);
+		TOML_ASSERT_ASSUME(b <= e);
+
+		if TOML_UNLIKELY(b == e)
+			return;
+
+		for (; b != e; b++)
 		{
 			if (!b->value) // empty node_views
 				continue;
@@ -12239,7 +14266,7 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	table::table(const table& other) //
 		: node(other),
-		  inline_{ other.inline_ }
+		  index_{ other.index_.load(std::memory_order_relaxed) & uintptr_t{ 1 } }
 	{
 		for (auto&& [k, v] : other.map_)
 			map_.emplace_hint(map_.end(), k, impl::make_node(*v));
@@ -12253,7 +14280,8 @@ TOML_NAMESPACE_START
 	table::table(table && other) noexcept //
 		: node(std::move(other)),
 		  map_{ std::move(other.map_) },
-		  inline_{ other.inline_ }
+		  index_{ other.index_.exchange(other.index_.load(std::memory_order_relaxed) & uintptr_t{ 1 },
+										std::memory_order_relaxed) }
 	{
 #if TOML_LIFETIME_HOOKS
 		TOML_TABLE_CREATED;
@@ -12266,10 +14294,11 @@ TOML_NAMESPACE_START
 		if (&rhs != this)
 		{
 			node::operator=(rhs);
+			drop_index();
 			map_.clear();
 			for (auto&& [k, v] : rhs.map_)
 				map_.emplace_hint(map_.end(), k, impl::make_node(*v));
-			inline_ = rhs.inline_;
+			is_inline(rhs.is_inline());
 		}
 		return *this;
 	}
@@ -12280,8 +14309,14 @@ TOML_NAMESPACE_START
 		if (&rhs != this)
 		{
 			node::operator=(std::move(rhs));
-			map_	= std::move(rhs.map_);
-			inline_ = rhs.inline_;
+			drop_index();
+#if TOML_ENABLE_ARENA
+			const impl::node_free_batch batch;
+#endif
+			map_ = std::move(rhs.map_);
+			index_.store(rhs.index_.exchange(rhs.index_.load(std::memory_order_relaxed) & uintptr_t{ 1 },
+											 std::memory_order_relaxed),
+						 std::memory_order_relaxed);
 		}
 		return *this;
 	}
@@ -12339,11 +14374,54 @@ TOML_NAMESPACE_START
 		return result;
 	}
 
+	TOML_PURE_GETTER
+	TOML_EXTERNAL_LINKAGE
+	table::map_iterator table::find_in_map(std::string_view key) const noexcept
+	{
+		auto& map = const_cast<map_type&>(map_);
+
+#if TOML_TABLE_INDEX_MIN_KEYS > 0
+		if (map.size() >= TOML_TABLE_INDEX_MIN_KEYS)
+		{
+			auto bits = index_.load(std::memory_order_acquire);
+			auto idx  = impl::table_index_of(bits);
+			if (!idx)
+			{
+				// (lookups can happen concurrently, so whoever gets there first gets to keep theirs)
+				idx = impl::table_index::create(map);
+				if (idx
+					&& !index_.compare_exchange_strong(bits,
+													   reinterpret_cast<uintptr_t>(idx) | bits,
+													   std::memory_order_acq_rel))
+				{
+					delete idx;
+					idx = impl::table_index_of(bits);
+				}
+			}
+			if (idx)
+				return idx->find(map, key);
+		}
+#endif
+
+		return map.find(key);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	void table::drop_index() noexcept
+	{
+		const auto bits = index_.load(std::memory_order_relaxed);
+		if (auto idx = impl::table_index_of(bits))
+		{
+			index_.store(bits & uintptr_t{ 1 }, std::memory_order_relaxed);
+			delete idx;
+		}
+	}
+
 	TOML_PURE_GETTER
 	TOML_EXTERNAL_LINKAGE
 	node* table::get(std::string_view key) noexcept
 	{
-		if (auto it = map_.find(key); it != map_.end())
+		if (auto it = find_in_map(key); it != map_.end())
 			return it->second.get();
 		return nullptr;
 	}
@@ -12383,34 +14461,38 @@ TOML_NAMESPACE_START
 	TOML_EXTERNAL_LINKAGE
 	table::iterator table::find(std::string_view key) noexcept
 	{
-		return iterator{ map_.find(key) };
+		return iterator{ find_in_map(key) };
 	}
 
 	TOML_PURE_GETTER
 	TOML_EXTERNAL_LINKAGE
 	table::const_iterator table::find(std::string_view key) const noexcept
 	{
-		return const_iterator{ map_.find(key) };
+		return const_iterator{ find_in_map(key) };
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	table::map_iterator table::erase(const_map_iterator pos) noexcept
 	{
+		if (auto idx = impl::table_index_of(index_.load(std::memory_order_relaxed)); idx && !idx->erase(map_, pos))
+			drop_index();
 		return map_.erase(pos);
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	table::map_iterator table::erase(const_map_iterator begin, const_map_iterator end) noexcept
 	{
+		if (begin != end)
+			drop_index();
 		return map_.erase(begin, end);
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	size_t table::erase(std::string_view key) noexcept
 	{
-		if (auto it = map_.find(key); it != map_.end())
+		if (auto it = find_in_map(key); it != map_.end())
 		{
-			map_.erase(it);
+			erase(const_map_iterator{ it });
 			return size_t{ 1 };
 		}
 		return size_t{};
@@ -12422,46 +14504,73 @@ TOML_NAMESPACE_START
 		if (map_.empty())
 			return *this;
 
-		for (auto it = map_.begin(); it != map_.end();)
+		const auto prunable = [=](node& nde) noexcept
 		{
-			if (auto arr = it->second->as_array())
+			if (auto arr = nde.as_array())
 			{
 				if (recursive)
 					arr->prune(true);
-
-				if (arr->empty())
-				{
-					it = map_.erase(it);
-					continue;
-				}
+				return arr->empty();
 			}
-			else if (auto tbl = it->second->as_table())
+			if (auto tbl = nde.as_table())
 			{
 				if (recursive)
 					tbl->prune(true);
-
-				if (tbl->empty())
-				{
-					it = map_.erase(it);
-					continue;
-				}
+				return tbl->empty();
 			}
-			it++;
+			return false;
+		};
+
+#if TOML_FLAT_TABLES
+
+		// (erasing them one at a time would shift everything after each of them down, so the rest are compacted
+		// in one pass instead)
+		auto kept = map_.begin();
+		for (auto it = map_.begin(); it != map_.end(); it++)
+		{
+			if (prunable(*it->second))
+				continue;
+			if (kept != it)
+				*kept = std::move(*it);
+			kept++;
+		}
+		erase(const_map_iterator{ kept }, map_.cend());
+
+#else
+
+		for (auto it = map_.begin(); it != map_.end();)
+		{
+			if (prunable(*it->second))
+				it = erase(it);
+			else
+				it++;
 		}
 
+#endif
+
 		return *this;
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	void table::clear() noexcept
 	{
+		drop_index();
+#if TOML_ENABLE_ARENA
+		const impl::node_free_batch batch;
+#endif
 		map_.clear();
 	}
 
 	TOML_EXTERNAL_LINKAGE
 	table::map_iterator table::insert_with_hint(const_iterator hint, key && k, impl::node_ptr && v)
 	{
-		return map_.emplace_hint(const_map_iterator{ hint }, std::move(k), std::move(v));
+		const auto size = map_.size();
+		const auto it	= map_.emplace_hint(const_map_iterator{ hint }, std::move(k), std::move(v));
+
+		if (auto idx = impl::table_index_of(index_.load(std::memory_order_relaxed));
+			idx && map_.size() != size && !idx->insert(map_, it))
+			drop_index();
+		return it;
 	}
 
 	TOML_PURE_GETTER
@@ -12504,39 +14613,12 @@ TOML_NAMESPACE_END;
 #endif
 TOML_POP_WARNINGS;
 
-//********  impl/simd.hpp  *********************************************************************************************
-
-#if TOML_ENABLE_SIMD
-
-#if defined(__SSE2__)                                                                                                  \
-	|| (defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
-#define TOML_HAS_SSE2 1
-#endif
-
-#if defined(__SSE4_1__) || (defined(_MSC_VER) && (defined(__AVX__) || defined(__AVX2__)))
-#define TOML_HAS_SSE4_1 1
-#endif
-
-#endif // TOML_ENABLE_SIMD
-
-#ifndef TOML_HAS_SSE2
-#define TOML_HAS_SSE2 0
-#endif
-#ifndef TOML_HAS_SSE4_1
-#define TOML_HAS_SSE4_1 0
-#endif
+//********  impl/key_pool.inl  *****************************************************************************************
 
 TOML_DISABLE_WARNINGS;
-#if TOML_HAS_SSE4_1
-#include <smmintrin.h>
-#endif
-#if TOML_HAS_SSE2
-#include <emmintrin.h>
-#endif
+#include <climits>
+#include <mutex>
 TOML_ENABLE_WARNINGS;
-
-//********  impl/unicode.inl  ******************************************************************************************
-
 TOML_PUSH_WARNINGS;
 #ifdef _MSC_VER
 #ifndef __clang__
@@ -12550,46 +14632,191 @@ TOML_PUSH_WARNINGS;
 
 TOML_IMPL_NAMESPACE_START
 {
-	TOML_PURE_GETTER
-	TOML_EXTERNAL_LINKAGE
-	bool is_ascii(const char* str, size_t len) noexcept
+	// a set of shared_key_chars (each holding a reference), with open addressing and linear probing.
+	// used directly by the parser to intern the keys of a document (with its buffer_allocator), and by toml::key_pool.
+	template <typename Allocator>
+	class key_set
 	{
-		const char* const end = str + len;
+	  private:
+		using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<shared_key_chars*>;
 
-#if TOML_HAS_SSE2 && (128 % CHAR_BIT) == 0
+		struct slot_traits
 		{
-			constexpr size_t chars_per_vector = 128u / CHAR_BIT;
-
-			if (const size_t simdable = len - (len % chars_per_vector))
+			TOML_PURE_INLINE_GETTER
+			static bool empty(const shared_key_chars* chars) noexcept
 			{
-				__m128i mask = _mm_setzero_si128();
-				for (const char* const e = str + simdable; str < e; str += chars_per_vector)
-				{
-					const __m128i current_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str));
-					mask						= _mm_or_si128(mask, current_bytes);
-				}
-				const __m128i has_error = _mm_cmpgt_epi8(_mm_setzero_si128(), mask);
+				return !chars;
+			}
 
-#if TOML_HAS_SSE4_1
-				if (!_mm_testz_si128(has_error, has_error))
-					return false;
-#else
-				if (_mm_movemask_epi8(_mm_cmpeq_epi8(has_error, _mm_setzero_si128())) != 0xFFFF)
-					return false;
-#endif
+			TOML_PURE_INLINE_GETTER
+			static size_t hash(const shared_key_chars* chars) noexcept
+			{
+				return key_set::hash(chars->view());
 			}
-		}
-#endif
+		};
+		using probing = linear_probing<shared_key_chars*, slot_traits>;
 
-		for (; str < end; str++)
-			if (static_cast<unsigned char>(*str) > 127u)
-				return false;
+		std::vector<shared_key_chars*, slot_allocator> slots_;
+		size_t size_ = {};
 
-		return true;
-	}
+		void grow()
+		{
+			std::vector<shared_key_chars*, slot_allocator> slots(probing::grown_capacity(slots_.size()),
+																 nullptr,
+																 slots_.get_allocator());
+			probing::rehash(slots_.data(), slots_.size(), slots.data(), slots.size() - 1u);
+			slots_ = std::move(slots);
+		}
+
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit key_set(const Allocator& alloc = {}) noexcept //
+			: slots_(slot_allocator{ alloc })
+		{}
+
+		~key_set() noexcept
+		{
+			clear();
+		}
+
+		TOML_DELETE_DEFAULTS(key_set);
+
+		TOML_PURE_INLINE_GETTER
+		static size_t hash(std::string_view str) noexcept
+		{
+			return std::hash<std::string_view>{}(str);
+		}
+
+		// returns the string's shared_key_chars (with a new reference), calling create(str) to make one (with a
+		// reference for the set) if it isn't in the set yet. str must be too long to be stored inline.
+		template <typename Create>
+		TOML_NODISCARD
+		shared_key_chars* intern(std::string_view str, size_t str_hash, Create&& create)
+		{
+			TOML_ASSERT_ASSUME(str.length() > key_string::max_inline_length);
+
+			if (probing::needs_growth(size_, slots_.size()))
+				grow();
+
+			auto& slot = probing::find(slots_.data(),
+									   slots_.size() - 1u,
+									   str_hash,
+									   [=](const shared_key_chars* chars) noexcept { return chars->view() == str; });
+			if (!slot)
+			{
+				slot = static_cast<Create&&>(create)(str);
+				size_++;
+			}
+
+			slot->add_ref();
+			return slot;
+		}
+
+		TOML_NODISCARD
+		key_string intern(std::string_view str)
+		{
+			if (str.length() <= key_string::max_inline_length)
+				return key_string{ str };
+
+			return key_string{ intern(str, hash(str), shared_key_chars::create) };
+		}
+
+		TOML_PURE_INLINE_GETTER
+		size_t size() const noexcept
+		{
+			return size_;
+		}
+
+		void clear() noexcept
+		{
+			for (const auto chars : slots_)
+				if (chars)
+					chars->release();
+			slots_.clear();
+			size_ = {};
+		}
+	};
+
+	// a key_pool's strings are spread over a number of separately-locked sets, so threads parsing different documents
+	// with the same pool don't all queue up behind one mutex.
+	struct key_pool_state
+	{
+		static constexpr size_t shard_count = 16u;
+
+		struct shard
+		{
+			mutable std::mutex mutex;
+			key_set<std::allocator<char>> keys;
+		};
+		shard shards[shard_count];
+
+		// (the sets use the low bits of the hash, so the shard is picked with the high ones)
+		TOML_PURE_INLINE_GETTER
+		shard& shard_for(size_t hash) noexcept
+		{
+			return shards[(hash >> (sizeof(size_t) * CHAR_BIT - 4u)) % shard_count];
+		}
+
+		// see key_set::intern()
+		// (the pool's strings outlive the documents that intern them, so they never come from a document's arena)
+		TOML_NODISCARD
+		shared_key_chars* intern(std::string_view str, size_t hash)
+		{
+			auto& s = shard_for(hash);
+			std::lock_guard<std::mutex> lock{ s.mutex };
+			const node_heap_scope heap;
+			return s.keys.intern(str, hash, shared_key_chars::create);
+		}
+	};
 }
 TOML_IMPL_NAMESPACE_END;
 
+TOML_NAMESPACE_START
+{
+	TOML_EXTERNAL_LINKAGE
+	key_pool::key_pool() //
+		: state_{ new impl::key_pool_state }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	key_pool::~key_pool() noexcept
+	{
+		delete state_;
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	key key_pool::intern(std::string_view k, source_region&& src)
+	{
+		if (k.length() <= impl::key_string::max_inline_length)
+			return key{ k, std::move(src) };
+
+		return key{ impl::key_string{ state_->intern(k, impl::key_set<std::allocator<char>>::hash(k)) }, std::move(src) };
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	size_t key_pool::size() const noexcept
+	{
+		size_t total = {};
+		for (auto& s : state_->shards)
+		{
+			std::lock_guard<std::mutex> lock{ s.mutex };
+			total += s.keys.size();
+		}
+		return total;
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	void key_pool::clear() noexcept
+	{
+		for (auto& s : state_->shards)
+		{
+			std::lock_guard<std::mutex> lock{ s.mutex };
+			s.keys.clear();
+		}
+	}
+}
+TOML_NAMESPACE_END;
+
 #ifdef _MSC_VER
 #pragma pop_macro("min")
 #pragma pop_macro("max")
@@ -12599,21 +14826,21 @@ TOML_IMPL_NAMESPACE_END;
 #endif
 TOML_POP_WARNINGS;
 
-//********  impl/parser.inl  *******************************************************************************************
-
-#if TOML_ENABLE_PARSER
+//********  impl/simd.inl  *********************************************************************************************
 
 TOML_DISABLE_WARNINGS;
-#include <istream>
-#include <fstream>
-#if TOML_INT_CHARCONV || TOML_FLOAT_CHARCONV
-#include <charconv>
+#include <atomic>
+#include <cstring>
+#if TOML_HAS_SSE2 || TOML_HAS_SIMD_DISPATCH
+#include <emmintrin.h>
 #endif
-#if !TOML_INT_CHARCONV || !TOML_FLOAT_CHARCONV
-#include <sstream>
+#if TOML_HAS_SIMD_DISPATCH
+#include <immintrin.h>
+#if TOML_MSVC
+#include <intrin.h>
+#else
+#include <cpuid.h>
 #endif
-#if !TOML_INT_CHARCONV
-#include <iomanip>
 #endif
 TOML_ENABLE_WARNINGS;
 TOML_PUSH_WARNINGS;
@@ -12627,3782 +14854,9104 @@ TOML_PUSH_WARNINGS;
 #undef max
 #endif
 
+// the vector kernels are compiled for their target instruction set regardless of the flags used for the
+// rest of the library, and are only ever called once cpuid says the host machine supports them.
+#if TOML_HAS_SIMD_DISPATCH && TOML_GCC_LIKE
+#define TOML_SIMD_TARGET(...) TOML_ATTR(target(__VA_ARGS__))
+#else
+#define TOML_SIMD_TARGET(...)
+#endif
+
+#if TOML_HAS_SSE2 || TOML_HAS_SIMD_DISPATCH
+#define TOML_SIMD_SSE2 1
+#else
+#define TOML_SIMD_SSE2 0
+#endif
+
+#if TOML_HAS_SIMD_DISPATCH && TOML_ARCH_AMD64
+#define TOML_SIMD_AVX512BW 1
+#else
+#define TOML_SIMD_AVX512BW 0
+#endif
+
 TOML_ANON_NAMESPACE_START
 {
-	template <typename T>
-	class utf8_byte_stream;
+	TOML_CONST_INLINE_GETTER
+	constexpr bool is_simd_control_character(unsigned char c) noexcept
+	{
+		return (c < 0x20u && c != 0x09u) || c == 0x7Fu;
+	}
 
-	TOML_INTERNAL_LINKAGE
-	constexpr auto utf8_byte_order_mark = "\xEF\xBB\xBF"sv;
+	// scalar
 
-	template <typename Char>
-	class utf8_byte_stream<std::basic_string_view<Char>>
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_ascii_scalar(const char* str, size_t len) noexcept
 	{
-		static_assert(sizeof(Char) == 1);
-
-	  private:
-		std::basic_string_view<Char> source_;
-		size_t position_ = {};
+		const char* const end = str + len;
 
-	  public:
-		TOML_NODISCARD_CTOR
-		explicit constexpr utf8_byte_stream(std::basic_string_view<Char> sv) noexcept //
-			: source_{ sv }
+		for (; end - str >= 8; str += 8)
 		{
-			// skip bom
-			if (source_.length() >= 3u && memcmp(utf8_byte_order_mark.data(), source_.data(), 3u) == 0)
-				position_ += 3u;
+			uint64_t chunk;
+			std::memcpy(&chunk, str, sizeof(chunk));
+			if (chunk & 0x8080808080808080ull)
+				return false;
 		}
 
-		TOML_CONST_INLINE_GETTER
-		constexpr bool error() const noexcept
-		{
-			return false;
-		}
+		for (; str < end; str++)
+			if (static_cast<unsigned char>(*str) > 127u)
+				return false;
 
-		TOML_PURE_INLINE_GETTER
-		constexpr bool eof() const noexcept
-		{
-			return position_ >= source_.length();
-		}
+		return true;
+	}
 
-		TOML_PURE_INLINE_GETTER
-		explicit constexpr operator bool() const noexcept
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_invalid_utf8_scalar(const char* begin, const char* end) noexcept
+	{
+		impl::utf8_decoder decoder;
+		const char* seq = begin;
+		for (const char* c = begin; c < end; c++)
 		{
-			return !eof();
-		}
+			if (decoder.has_code_point())
+			{
+				// skip over runs of ascii eight bytes at a time
+				while (end - c >= 8 && is_ascii_scalar(c, 8u))
+					c += 8;
+				if (c == end)
+					break;
+				seq = c;
+			}
 
-		TOML_PURE_INLINE_GETTER
-		constexpr bool peek_eof() const noexcept
-		{
-			return eof();
+			decoder(*c);
+			if (decoder.error())
+				return seq;
 		}
+		return decoder.has_code_point() ? end : seq;
+	}
 
-		TOML_NODISCARD
-		TOML_ATTR(nonnull)
-		size_t operator()(void* dest, size_t num) noexcept
-		{
-			TOML_ASSERT_ASSUME(!eof());
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_non_whitespace_scalar(const char* begin, const char* end) noexcept
+	{
+		while (begin < end && (*begin == ' ' || *begin == '\t'))
+			begin++;
+		return begin;
+	}
 
-			num = impl::min(position_ + num, source_.length()) - position_;
-			std::memcpy(dest, source_.data() + position_, num);
-			position_ += num;
-			return num;
-		}
-	};
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_comment_terminator_scalar(const char* begin, const char* end) noexcept
+	{
+		while (begin < end && !is_simd_control_character(static_cast<unsigned char>(*begin)))
+			begin++;
+		return begin;
+	}
 
-	template <>
-	class utf8_byte_stream<std::istream>
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_string_terminator_scalar(const char* begin,
+											  const char* end,
+											  char delimiter,
+											  char escape) noexcept
+	{
+		while (begin < end && *begin != delimiter && *begin != escape
+			   && !is_simd_control_character(static_cast<unsigned char>(*begin)))
+			begin++;
+		return begin;
+	}
+
+	// SSE2 (16 bytes at a time)
+
+#if TOML_SIMD_SSE2
+
+	TOML_CONST_INLINE_GETTER
+	unsigned simd_first_set_bit(uint32_t mask) noexcept
 	{
-	  private:
-		std::istream* source_;
+		TOML_ASSERT_ASSUME(mask);
+#if TOML_MSVC
+		unsigned long idx;
+		_BitScanForward(&idx, mask);
+		return static_cast<unsigned>(idx);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
 
-	  public:
-		TOML_NODISCARD_CTOR
-		explicit utf8_byte_stream(std::istream& stream) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) //
-			: source_{ &stream }
-		{
-			if (!*this) // eof, bad
-				return;
+	TOML_SIMD_TARGET("sse2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_ascii_sse2(const char* str, size_t len) noexcept
+	{
+		const char* const end = str + len;
 
-			const auto initial_pos = source_->tellg();
-			char bom[3];
-			source_->read(bom, 3);
-			if (source_->bad() || (source_->gcount() == 3 && memcmp(utf8_byte_order_mark.data(), bom, 3u) == 0))
-				return;
+		__m128i acc = _mm_setzero_si128();
+		for (; end - str >= 16; str += 16)
+			acc = _mm_or_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(str)));
+		if (_mm_movemask_epi8(acc))
+			return false;
 
-			source_->clear();
-			source_->seekg(initial_pos, std::istream::beg);
-		}
+		return is_ascii_scalar(str, static_cast<size_t>(end - str));
+	}
 
-		TOML_PURE_INLINE_GETTER
-		bool error() const noexcept
-		{
-			return !!(source_->rdstate() & std::istream::badbit);
-		}
+	TOML_SIMD_TARGET("sse2")
+	TOML_ALWAYS_INLINE
+	__m128i control_characters_sse2(__m128i v) noexcept
+	{
+		// unsigned v <= 0x1F, minus tabs, plus DEL
+		const __m128i low = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v);
+		return _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')), low),
+							_mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F)));
+	}
 
-		TOML_PURE_INLINE_GETTER
-		bool eof() const noexcept
+	TOML_SIMD_TARGET("sse2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_non_whitespace_sse2(const char* begin, const char* end) noexcept
+	{
+		const __m128i space = _mm_set1_epi8(' ');
+		const __m128i tab	= _mm_set1_epi8('\t');
+		for (; end - begin >= 16; begin += 16)
 		{
-			return !!(source_->rdstate() & std::istream::eofbit);
+			const __m128i v	 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			const __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab));
+			if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(ws)) ^ 0xFFFFu)
+				return begin + simd_first_set_bit(mask);
 		}
+		return find_non_whitespace_scalar(begin, end);
+	}
 
-		TOML_PURE_INLINE_GETTER
-		explicit operator bool() const noexcept
+	TOML_SIMD_TARGET("sse2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_comment_terminator_sse2(const char* begin, const char* end) noexcept
+	{
+		for (; end - begin >= 16; begin += 16)
 		{
-			return !(source_->rdstate() & (std::istream::badbit | std::istream::eofbit));
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(control_characters_sse2(v))))
+				return begin + simd_first_set_bit(mask);
 		}
+		return find_comment_terminator_scalar(begin, end);
+	}
 
-		TOML_NODISCARD
-		bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+	TOML_SIMD_TARGET("sse2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_string_terminator_sse2(const char* begin, const char* end, char delimiter, char escape) noexcept
+	{
+		const __m128i delim = _mm_set1_epi8(delimiter);
+		const __m128i esc	= _mm_set1_epi8(escape);
+		for (; end - begin >= 16; begin += 16)
 		{
-			return eof() || source_->peek() == std::istream::traits_type::eof();
+			const __m128i v		= _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			const __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, delim), _mm_cmpeq_epi8(v, esc)),
+											   control_characters_sse2(v));
+			if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(found)))
+				return begin + simd_first_set_bit(mask);
 		}
+		return find_string_terminator_scalar(begin, end, delimiter, escape);
+	}
 
-		TOML_NODISCARD
-		TOML_ATTR(nonnull)
-		size_t operator()(void* dest, size_t num) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
-		{
-			TOML_ASSERT(*this);
+#endif // TOML_SIMD_SSE2
 
-			source_->read(static_cast<char*>(dest), static_cast<std::streamsize>(num));
-			return static_cast<size_t>(source_->gcount());
-		}
-	};
+	// AVX2 (32 bytes at a time)
 
-	struct utf8_codepoint
+#if TOML_HAS_SIMD_DISPATCH
+
+	// steps back from a block boundary to the start of the utf-8 sequence straddling it (if any).
+	// the vector validators only know that a block contains an error, so they use this to hand the scalar kernel
+	// a starting point from which it can find exactly where it is.
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* utf8_sequence_start(const char* begin, const char* pos) noexcept
 	{
-		char32_t value;
-		char bytes[4];
-		size_t count;
-		source_position position;
+		for (size_t i = 0; i < 3u && pos > begin && (static_cast<unsigned char>(pos[-1]) & 0xC0u) == 0x80u; i++)
+			pos--;
+		if (pos > begin && static_cast<unsigned char>(pos[-1]) >= 0xC0u)
+			pos--;
+		return pos;
+	}
 
-		TOML_PURE_INLINE_GETTER
-		constexpr operator const char32_t&() const noexcept
+	// lookup tables for the vectorized utf-8 validators, per "Validating UTF-8 In Less Than One Instruction Per Byte"
+	// (Keiser & Lemire). each byte is classified three ways (high nibble of the previous byte, low nibble of the
+	// previous byte, high nibble of itself); ANDing the three gives the error(s) that pair of bytes represents.
+	struct utf8_lookup
+	{
+		static constexpr uint8_t too_short		= 1u << 0; // 11______ 0_______, 11______ 11______
+		static constexpr uint8_t too_long		= 1u << 1; // 0_______ 10______
+		static constexpr uint8_t overlong_3		= 1u << 2; // 11100000 100_____
+		static constexpr uint8_t too_large		= 1u << 3; // 11110100 1001____ (and above)
+		static constexpr uint8_t surrogate		= 1u << 4; // 11101101 101_____
+		static constexpr uint8_t overlong_2		= 1u << 5; // 1100000_ 10______
+		static constexpr uint8_t too_large_1000 = 1u << 6; // 11110101 1000____ (and above)
+		static constexpr uint8_t overlong_4		= 1u << 6; // 11110000 1000____
+		static constexpr uint8_t two_conts		= 1u << 7; // 10______ 10______
+		static constexpr uint8_t carry			= too_short | too_long | two_conts;
+
+		alignas(16) static constexpr uint8_t byte_1_high[16]{
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			too_long,
+			two_conts,
+			two_conts,
+			two_conts,
+			two_conts,
+			too_short | overlong_2,
+			too_short,
+			too_short | overlong_3 | surrogate,
+			too_short | too_large | too_large_1000 | overlong_4,
+		};
+
+		alignas(16) static constexpr uint8_t byte_1_low[16]{
+			carry | overlong_3 | overlong_2 | overlong_4,
+			carry | overlong_2,
+			carry,
+			carry,
+			carry | too_large,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000 | surrogate,
+			carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000,
+		};
+
+		alignas(16) static constexpr uint8_t byte_2_high[16]{
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+			too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+			too_long | overlong_2 | two_conts | overlong_3 | too_large,
+			too_long | overlong_2 | two_conts | surrogate | too_large,
+			too_long | overlong_2 | two_conts | surrogate | too_large,
+			too_short,
+			too_short,
+			too_short,
+			too_short,
+		};
+	};
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_ascii_avx2(const char* str, size_t len) noexcept
+	{
+		const char* const end = str + len;
+
+		__m256i acc = _mm256_setzero_si256();
+		for (; end - str >= 32; str += 32)
+			acc = _mm256_or_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str)));
+		if (_mm256_movemask_epi8(acc))
+			return false;
+
+		return is_ascii_sse2(str, static_cast<size_t>(end - str));
+	}
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_ALWAYS_INLINE
+	__m256i control_characters_avx2(__m256i v) noexcept
+	{
+		const __m256i low = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v);
+		return _mm256_or_si256(_mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')), low),
+							   _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7F)));
+	}
+
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_non_whitespace_avx2(const char* begin, const char* end) noexcept
+	{
+		const __m256i space = _mm256_set1_epi8(' ');
+		const __m256i tab	= _mm256_set1_epi8('\t');
+		for (; end - begin >= 32; begin += 32)
 		{
-			return value;
+			const __m256i v	 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+			const __m256i ws = _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab));
+			if (const auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(ws)))
+				return begin + simd_first_set_bit(mask);
 		}
+		return find_non_whitespace_sse2(begin, end);
+	}
 
-		TOML_PURE_INLINE_GETTER
-		constexpr const char32_t& operator*() const noexcept
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_comment_terminator_avx2(const char* begin, const char* end) noexcept
+	{
+		for (; end - begin >= 32; begin += 32)
 		{
-			return value;
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+			if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(control_characters_avx2(v))))
+				return begin + simd_first_set_bit(mask);
 		}
-	};
-	static_assert(std::is_trivially_default_constructible_v<utf8_codepoint> && std::is_trivially_copyable_v<utf8_codepoint>);
-	static_assert(std::is_standard_layout_v<utf8_codepoint>);
+		return find_comment_terminator_sse2(begin, end);
+	}
 
-	struct TOML_ABSTRACT_INTERFACE utf8_reader_interface
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_string_terminator_avx2(const char* begin, const char* end, char delimiter, char escape) noexcept
 	{
-		TOML_NODISCARD
-		virtual const source_path_ptr& source_path() const noexcept = 0;
-
-		TOML_NODISCARD
-		virtual const utf8_codepoint* read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) = 0;
+		const __m256i delim = _mm256_set1_epi8(delimiter);
+		const __m256i esc	= _mm256_set1_epi8(escape);
+		for (; end - begin >= 32; begin += 32)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+			const __m256i found =
+				_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, delim), _mm256_cmpeq_epi8(v, esc)),
+								control_characters_avx2(v));
+			if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(found)))
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_string_terminator_sse2(begin, end, delimiter, escape);
+	}
 
-		TOML_NODISCARD
-		virtual bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) = 0;
+	TOML_SIMD_TARGET("avx2")
+	TOML_ALWAYS_INLINE
+	__m256i utf8_lookup_avx2(const uint8_t (&table)[16], __m256i nibbles) noexcept
+	{
+		return _mm256_shuffle_epi8(
+			_mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table))),
+			nibbles);
+	}
 
-#if !TOML_EXCEPTIONS
+	TOML_SIMD_TARGET("avx2")
+	TOML_ALWAYS_INLINE
+	__m256i utf8_errors_avx2(__m256i input, __m256i prev_input) noexcept
+	{
+		// the last lane of the previous block followed by the first lane of this one
+		const __m256i straddle = _mm256_permute2x128_si256(prev_input, input, 0x21);
+		const __m256i prev1	   = _mm256_alignr_epi8(input, straddle, 15);
+		const __m256i prev2	   = _mm256_alignr_epi8(input, straddle, 14);
+		const __m256i prev3	   = _mm256_alignr_epi8(input, straddle, 13);
+
+		const __m256i nibble  = _mm256_set1_epi8(0x0F);
+		const __m256i special = _mm256_and_si256(
+			_mm256_and_si256(
+				utf8_lookup_avx2(utf8_lookup::byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+				utf8_lookup_avx2(utf8_lookup::byte_1_low, _mm256_and_si256(prev1, nibble))),
+			utf8_lookup_avx2(utf8_lookup::byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+		// the third and fourth bytes of three- and four-byte sequences are the only places two continuations in a
+		// row are allowed
+		const __m256i third_or_fourth =
+			_mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80)),
+							_mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80)));
+		return _mm256_xor_si256(_mm256_and_si256(third_or_fourth, _mm256_set1_epi8(static_cast<char>(0x80u))),
+								special);
+	}
 
-		TOML_NODISCARD
-		virtual optional<parse_error>&& error() noexcept = 0;
+	TOML_SIMD_TARGET("avx2")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_invalid_utf8_avx2(const char* begin, const char* end) noexcept
+	{
+		const char* pos	   = begin;
+		__m256i prev_input = _mm256_setzero_si256();
+		bool prev_ascii	   = true;
+		for (; end - pos >= 32; pos += 32)
+		{
+			const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+			const bool ascii	= !_mm256_movemask_epi8(input);
+			if (!ascii || !prev_ascii)
+			{
+				const __m256i errors = utf8_errors_avx2(input, prev_input);
+				if (!_mm256_testz_si256(errors, errors))
+					break;
+			}
+			prev_input = input;
+			prev_ascii = ascii;
+		}
 
-#endif
+		// the scalar kernel takes care of the tail, and pinpoints the error if there was one
+		return find_invalid_utf8_scalar(utf8_sequence_start(begin, pos), end);
+	}
 
-		virtual ~utf8_reader_interface() noexcept = default;
-	};
+#endif // TOML_HAS_SIMD_DISPATCH
 
-#if TOML_EXCEPTIONS
-#define utf8_reader_error(...)				throw parse_error(__VA_ARGS__)
-#define utf8_reader_return_after_error(...) static_assert(true)
-#define utf8_reader_error_check(...)		static_assert(true)
-#else
-#define utf8_reader_error(...)				err_.emplace(__VA_ARGS__)
-#define utf8_reader_return_after_error(...) return __VA_ARGS__
-#define utf8_reader_error_check(...)                                                                                   \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if TOML_UNLIKELY(err_)                                                                                         \
-			return __VA_ARGS__;                                                                                        \
-	}                                                                                                                  \
-	while (false)
+	// AVX-512BW (64 bytes at a time)
 
-#endif
+#if TOML_SIMD_AVX512BW
 
-#if defined(__APPLE__) || defined(__MINGW32__) || defined(__MINGW64__)
-#define TOML_OVERALIGNED
+	TOML_CONST_INLINE_GETTER
+	unsigned simd_first_set_bit(uint64_t mask) noexcept
+	{
+		TOML_ASSERT_ASSUME(mask);
+#if TOML_MSVC
+		unsigned long idx;
+		_BitScanForward64(&idx, mask);
+		return static_cast<unsigned>(idx);
 #else
-#define TOML_OVERALIGNED alignas(32)
+		return static_cast<unsigned>(__builtin_ctzll(mask));
 #endif
+	}
 
-	template <typename T>
-	class TOML_EMPTY_BASES utf8_reader final : public utf8_reader_interface
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_ascii_avx512bw(const char* str, size_t len) noexcept
 	{
-	  private:
-		static constexpr size_t block_capacity = 32;
-		utf8_byte_stream<T> stream_;
-		source_position next_pos_ = { 1, 1 };
+		const char* const end = str + len;
 
-		impl::utf8_decoder decoder_;
-		struct currently_decoding_t
-		{
-			char bytes[4];
-			size_t count;
-		} currently_decoding_;
+		__m512i acc = _mm512_setzero_si512();
+		for (; end - str >= 64; str += 64)
+			acc = _mm512_or_si512(acc, _mm512_loadu_si512(str));
+		if (_mm512_movepi8_mask(acc))
+			return false;
 
-		struct codepoints_t
-		{
-			TOML_OVERALIGNED utf8_codepoint buffer[block_capacity];
-			size_t current;
-			size_t count;
-		} codepoints_;
+		return is_ascii_avx2(str, static_cast<size_t>(end - str));
+	}
 
-		source_path_ptr source_path_;
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_ALWAYS_INLINE
+	uint64_t control_characters_avx512bw(__m512i v) noexcept
+	{
+		const __mmask64 low = _mm512_mask_cmple_epu8_mask(_mm512_cmpneq_epi8_mask(v, _mm512_set1_epi8('\t')),
+														   v,
+														   _mm512_set1_epi8(0x1F));
+		return static_cast<uint64_t>(low | _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(0x7F)));
+	}
 
-#if !TOML_EXCEPTIONS
-		optional<parse_error> err_;
-#endif
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_non_whitespace_avx512bw(const char* begin, const char* end) noexcept
+	{
+		const __m512i space = _mm512_set1_epi8(' ');
+		const __m512i tab	= _mm512_set1_epi8('\t');
+		for (; end - begin >= 64; begin += 64)
+		{
+			const __m512i v = _mm512_loadu_si512(begin);
+			const auto mask = _mm512_mask_cmpneq_epi8_mask(_mm512_cmpneq_epi8_mask(v, space), v, tab);
+			if (mask)
+				return begin + simd_first_set_bit(static_cast<uint64_t>(mask));
+		}
+		return find_non_whitespace_avx2(begin, end);
+	}
 
-		bool read_next_block() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_comment_terminator_avx512bw(const char* begin, const char* end) noexcept
+	{
+		for (; end - begin >= 64; begin += 64)
 		{
-			TOML_ASSERT(stream_);
+			if (const auto mask = control_characters_avx512bw(_mm512_loadu_si512(begin)))
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_comment_terminator_avx2(begin, end);
+	}
 
-			TOML_OVERALIGNED char raw_bytes[block_capacity];
-			size_t raw_bytes_read;
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_string_terminator_avx512bw(const char* begin,
+												const char* end,
+												char delimiter,
+												char escape) noexcept
+	{
+		const __m512i delim = _mm512_set1_epi8(delimiter);
+		const __m512i esc	= _mm512_set1_epi8(escape);
+		for (; end - begin >= 64; begin += 64)
+		{
+			const __m512i v = _mm512_loadu_si512(begin);
+			const auto mask = static_cast<uint64_t>(_mm512_cmpeq_epi8_mask(v, delim) | _mm512_cmpeq_epi8_mask(v, esc))
+							| control_characters_avx512bw(v);
+			if (mask)
+				return begin + simd_first_set_bit(mask);
+		}
+		return find_string_terminator_avx2(begin, end, delimiter, escape);
+	}
 
-			// read the next raw (encoded) block in from the stream
-			if constexpr (noexcept(stream_(raw_bytes, block_capacity)) || !TOML_EXCEPTIONS)
-			{
-				raw_bytes_read = stream_(raw_bytes, block_capacity);
-			}
-#if TOML_EXCEPTIONS
-			else
-			{
-				try
-				{
-					raw_bytes_read = stream_(raw_bytes, block_capacity);
-				}
-				catch (const std::exception& exc)
-				{
-					throw parse_error{ exc.what(), next_pos_, source_path_ };
-				}
-				catch (...)
-				{
-					throw parse_error{ "An unspecified error occurred", next_pos_, source_path_ };
-				}
-			}
-#endif // TOML_EXCEPTIONS
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_ALWAYS_INLINE
+	__m512i utf8_lookup_avx512bw(const uint8_t (&table)[16], __m512i nibbles) noexcept
+	{
+		return _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_load_si128(reinterpret_cast<const __m128i*>(table))),
+								   nibbles);
+	}
 
-			// handle a zero-byte read
-			if TOML_UNLIKELY(!raw_bytes_read)
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_ALWAYS_INLINE
+	__m512i utf8_errors_avx512bw(__m512i input, __m512i prev_input) noexcept
+	{
+		// each lane of this block shifted up one, with the last lane of the previous block in the bottom
+		const __m512i straddle =
+			_mm512_permutex2var_epi64(input, _mm512_set_epi64(5, 4, 3, 2, 1, 0, 15, 14), prev_input);
+		const __m512i prev1 = _mm512_alignr_epi8(input, straddle, 15);
+		const __m512i prev2 = _mm512_alignr_epi8(input, straddle, 14);
+		const __m512i prev3 = _mm512_alignr_epi8(input, straddle, 13);
+
+		const __m512i nibble  = _mm512_set1_epi8(0x0F);
+		const __m512i special = _mm512_and_si512(
+			_mm512_and_si512(
+				utf8_lookup_avx512bw(utf8_lookup::byte_1_high, _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble)),
+				utf8_lookup_avx512bw(utf8_lookup::byte_1_low, _mm512_and_si512(prev1, nibble))),
+			utf8_lookup_avx512bw(utf8_lookup::byte_2_high, _mm512_and_si512(_mm512_srli_epi16(input, 4), nibble)));
+
+		const __m512i third_or_fourth =
+			_mm512_or_si512(_mm512_subs_epu8(prev2, _mm512_set1_epi8(0xE0 - 0x80)),
+							_mm512_subs_epu8(prev3, _mm512_set1_epi8(0xF0 - 0x80)));
+		return _mm512_xor_si512(_mm512_and_si512(third_or_fourth, _mm512_set1_epi8(static_cast<char>(0x80u))),
+								special);
+	}
+
+	TOML_SIMD_TARGET("avx512f,avx512bw")
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	const char* find_invalid_utf8_avx512bw(const char* begin, const char* end) noexcept
+	{
+		const char* pos	   = begin;
+		__m512i prev_input = _mm512_setzero_si512();
+		bool prev_ascii	   = true;
+		for (; end - pos >= 64; pos += 64)
+		{
+			const __m512i input = _mm512_loadu_si512(pos);
+			const bool ascii	= !_mm512_movepi8_mask(input);
+			if (!ascii || !prev_ascii)
 			{
-				if (stream_.eof())
-				{
-					// EOF only sets the error state if the decoder wants more input, otherwise
-					// a zero-byte read might have just caused the underlying stream to realize it's exhaused and set
-					// the EOF flag, and that's totally fine
-					if (decoder_.needs_more_input())
-						utf8_reader_error("Encountered EOF during incomplete utf-8 code point sequence",
-										  next_pos_,
-										  source_path_);
-				}
-				else
-				{
-					utf8_reader_error("Reading from the underlying stream failed - zero bytes read",
-									  next_pos_,
-									  source_path_);
-				}
-				return false;
+				const __m512i errors = utf8_errors_avx512bw(input, prev_input);
+				if (_mm512_test_epi8_mask(errors, errors))
+					break;
 			}
+			prev_input = input;
+			prev_ascii = ascii;
+		}
 
-			TOML_ASSERT_ASSUME(raw_bytes_read);
-			std::memset(&codepoints_, 0, sizeof(codepoints_));
+		return find_invalid_utf8_avx2(utf8_sequence_start(begin, pos), end);
+	}
 
-			// helper for calculating decoded codepoint line+cols
-			const auto calc_positions = [&]() noexcept
-			{
-				for (size_t i = 0; i < codepoints_.count; i++)
-				{
-					auto& cp	= codepoints_.buffer[i];
-					cp.position = next_pos_;
+#endif // TOML_SIMD_AVX512BW
 
-					if (cp == U'\n')
-					{
-						next_pos_.line++;
-						next_pos_.column = source_index{ 1 };
-					}
-					else
-						next_pos_.column++;
-				}
-			};
+	// dispatch
 
-			// decide whether we need to use the UTF-8 decoder or if we can treat this block as plain ASCII
-			const auto ascii_fast_path = !decoder_.needs_more_input() && impl::is_ascii(raw_bytes, raw_bytes_read);
+	TOML_INTERNAL_LINKAGE
+	constexpr impl::simd_kernels simd_kernels_scalar{ impl::simd_level::scalar,
+													  is_ascii_scalar,
+													  find_invalid_utf8_scalar,
+													  find_non_whitespace_scalar,
+													  find_comment_terminator_scalar,
+													  find_string_terminator_scalar };
+
+#if TOML_SIMD_SSE2
+	TOML_INTERNAL_LINKAGE
+	constexpr impl::simd_kernels simd_kernels_sse2{ impl::simd_level::sse2,
+													is_ascii_sse2,
+													find_invalid_utf8_scalar,
+													find_non_whitespace_sse2,
+													find_comment_terminator_sse2,
+													find_string_terminator_sse2 };
+#endif
 
-			// ASCII fast-path
-			if (ascii_fast_path)
-			{
-				decoder_.reset();
-				currently_decoding_.count = {};
+#if TOML_HAS_SIMD_DISPATCH
+	TOML_INTERNAL_LINKAGE
+	constexpr impl::simd_kernels simd_kernels_avx2{ impl::simd_level::avx2,
+													is_ascii_avx2,
+													find_invalid_utf8_avx2,
+													find_non_whitespace_avx2,
+													find_comment_terminator_avx2,
+													find_string_terminator_avx2 };
+#endif
 
-				codepoints_.count = raw_bytes_read;
-				for (size_t i = 0; i < codepoints_.count; i++)
-				{
-					auto& cp	= codepoints_.buffer[i];
-					cp.value	= static_cast<char32_t>(raw_bytes[i]);
-					cp.bytes[0] = raw_bytes[i];
-					cp.count	= 1u;
-				}
-			}
+#if TOML_SIMD_AVX512BW
+	TOML_INTERNAL_LINKAGE
+	constexpr impl::simd_kernels simd_kernels_avx512bw{ impl::simd_level::avx512bw,
+														is_ascii_avx512bw,
+														find_invalid_utf8_avx512bw,
+														find_non_whitespace_avx512bw,
+														find_comment_terminator_avx512bw,
+														find_string_terminator_avx512bw };
+#endif
 
-			// UTF-8 slow-path
-			else
-			{
-				// helper for getting precise error location
-				const auto error_pos = [&]() noexcept -> const source_position&
-				{ //
-					return codepoints_.count ? codepoints_.buffer[codepoints_.count - 1u].position : next_pos_;
-				};
+#if TOML_HAS_SIMD_DISPATCH
 
-				for (size_t i = 0; i < raw_bytes_read; i++)
-				{
-					decoder_(static_cast<uint8_t>(raw_bytes[i]));
-					if TOML_UNLIKELY(decoder_.error())
-					{
-						calc_positions();
-						utf8_reader_error("Encountered invalid utf-8 sequence", error_pos(), source_path_);
-						utf8_reader_return_after_error(false);
-					}
-
-					currently_decoding_.bytes[currently_decoding_.count++] = raw_bytes[i];
+	TOML_INTERNAL_LINKAGE
+	void simd_cpuid(unsigned leaf, unsigned subleaf, unsigned (&regs)[4]) noexcept
+	{
+#if TOML_MSVC
+		int out[4];
+		__cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+		for (size_t i = 0; i < 4u; i++)
+			regs[i] = static_cast<unsigned>(out[i]);
+#else
+		__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+	}
 
-					if (decoder_.has_code_point())
-					{
-						auto& cp = codepoints_.buffer[codepoints_.count++];
+	TOML_INTERNAL_LINKAGE
+	uint64_t simd_xgetbv() noexcept
+	{
+#if TOML_MSVC
+		return static_cast<uint64_t>(_xgetbv(0));
+#else
+		unsigned eax, edx;
+		__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0u));
+		return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+	}
 
-						cp.value = decoder_.codepoint;
-						cp.count = currently_decoding_.count;
-						std::memcpy(cp.bytes, currently_decoding_.bytes, currently_decoding_.count);
-						currently_decoding_.count = {};
-					}
-					else if TOML_UNLIKELY(currently_decoding_.count == 4u)
-					{
-						calc_positions();
-						utf8_reader_error("Encountered overlong utf-8 sequence", error_pos(), source_path_);
-						utf8_reader_return_after_error(false);
-					}
-				}
-				if TOML_UNLIKELY(decoder_.needs_more_input() && stream_.eof())
-				{
-					calc_positions();
-					utf8_reader_error("Encountered EOF during incomplete utf-8 code point sequence",
-									  error_pos(),
-									  source_path_);
-					utf8_reader_return_after_error(false);
-				}
-			}
+#endif // TOML_HAS_SIMD_DISPATCH
 
-			TOML_ASSERT_ASSUME(codepoints_.count);
-			calc_positions();
+	TOML_INTERNAL_LINKAGE
+	impl::simd_level detect_simd_level() noexcept
+	{
+#if TOML_HAS_SIMD_DISPATCH
+
+		unsigned regs[4]{};
+		simd_cpuid(0u, 0u, regs);
+		const unsigned max_leaf = regs[0];
+		if (max_leaf < 1u)
+			return impl::simd_level::scalar;
+
+		simd_cpuid(1u, 0u, regs);
+		const bool sse2	   = (regs[3] & (1u << 26)) != 0u;
+		const bool osxsave = (regs[2] & (1u << 27)) != 0u;
+		const bool avx	   = (regs[2] & (1u << 28)) != 0u;
+		if (!sse2)
+			return impl::simd_level::scalar;
+		if (!osxsave || !avx || max_leaf < 7u)
+			return impl::simd_level::sse2;
+
+		// the OS has to be saving the wider registers on context switches, too
+		const uint64_t xcr0 = simd_xgetbv();
+		if ((xcr0 & 0x6u) != 0x6u) // XMM + YMM
+			return impl::simd_level::sse2;
+
+		simd_cpuid(7u, 0u, regs);
+		const bool avx2		= (regs[1] & (1u << 5)) != 0u;
+		const bool avx512f	= (regs[1] & (1u << 16)) != 0u;
+		const bool avx512bw = (regs[1] & (1u << 30)) != 0u;
+		if (!avx2)
+			return impl::simd_level::sse2;
+
+#if TOML_SIMD_AVX512BW
+		if (avx512f && avx512bw && (xcr0 & 0xE6u) == 0xE6u) // + opmask, ZMM0-15, ZMM16-31
+			return impl::simd_level::avx512bw;
+#else
+		static_cast<void>(avx512f);
+		static_cast<void>(avx512bw);
+#endif
 
-			// handle general I/O errors
-			// (down here so the next_pos_ benefits from calc_positions())
-			if TOML_UNLIKELY(stream_.error())
-			{
-				utf8_reader_error("An I/O error occurred while reading from the underlying stream",
-								  next_pos_,
-								  source_path_);
-				utf8_reader_return_after_error(false);
-			}
+		return impl::simd_level::avx2;
 
-			return true;
-		}
+#elif TOML_SIMD_SSE2
+		return impl::simd_level::sse2;
+#else
+		return impl::simd_level::scalar;
+#endif
+	}
 
-	  public:
-		template <typename U, typename String = std::string_view>
-		TOML_NODISCARD_CTOR
-		explicit utf8_reader(U&& source, String&& source_path = {}) noexcept(
-			std::is_nothrow_constructible_v<utf8_byte_stream<T>, U&&>)
-			: stream_{ static_cast<U&&>(source) }
-		{
-			currently_decoding_.count = {};
+	TOML_INTERNAL_LINKAGE
+	impl::simd_level max_simd_level() noexcept
+	{
+		static const impl::simd_level level = detect_simd_level();
+		return level;
+	}
 
-			codepoints_.current = {};
-			codepoints_.count	= {};
+	TOML_INTERNAL_LINKAGE
+	std::atomic<const impl::simd_kernels*>& active_simd_kernels() noexcept
+	{
+		static std::atomic<const impl::simd_kernels*> kernels{ impl::get_simd_kernels(max_simd_level()) };
+		return kernels;
+	}
+}
+TOML_ANON_NAMESPACE_END;
 
-			if (!source_path.empty())
-				source_path_ = std::make_shared<const std::string>(static_cast<String&&>(source_path));
-		}
+TOML_IMPL_NAMESPACE_START
+{
+	TOML_EXTERNAL_LINKAGE
+	const simd_kernels* get_simd_kernels(simd_level level) noexcept
+	{
+		if (level > TOML_ANON_NAMESPACE::max_simd_level())
+			return nullptr;
 
-		TOML_PURE_INLINE_GETTER
-		const source_path_ptr& source_path() const noexcept final
+		switch (level)
 		{
-			return source_path_;
+			case simd_level::scalar: return &TOML_ANON_NAMESPACE::simd_kernels_scalar;
+#if TOML_SIMD_SSE2
+			case simd_level::sse2: return &TOML_ANON_NAMESPACE::simd_kernels_sse2;
+#endif
+#if TOML_HAS_SIMD_DISPATCH
+			case simd_level::avx2: return &TOML_ANON_NAMESPACE::simd_kernels_avx2;
+#endif
+#if TOML_SIMD_AVX512BW
+			case simd_level::avx512bw: return &TOML_ANON_NAMESPACE::simd_kernels_avx512bw;
+#endif
+			default: return nullptr;
 		}
+	}
 
-		TOML_NODISCARD
-		const utf8_codepoint* read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) final
-		{
-			utf8_reader_error_check({});
+	TOML_EXTERNAL_LINKAGE
+	const simd_kernels& simd() noexcept
+	{
+		return *TOML_ANON_NAMESPACE::active_simd_kernels().load(std::memory_order_relaxed);
+	}
 
-			if (codepoints_.current == codepoints_.count)
-			{
-				if TOML_UNLIKELY(!stream_ || !read_next_block())
-					return nullptr;
+	TOML_EXTERNAL_LINKAGE
+	bool set_simd_level(simd_level level) noexcept
+	{
+		const auto kernels = get_simd_kernels(level);
+		if (!kernels)
+			return false;
 
-				TOML_ASSERT_ASSUME(!codepoints_.current);
-			}
-			TOML_ASSERT_ASSUME(codepoints_.count);
-			TOML_ASSERT_ASSUME(codepoints_.count <= block_capacity);
-			TOML_ASSERT_ASSUME(codepoints_.current < codepoints_.count);
+		TOML_ANON_NAMESPACE::active_simd_kernels().store(kernels, std::memory_order_relaxed);
+		return true;
+	}
+}
+TOML_IMPL_NAMESPACE_END;
 
-			return &codepoints_.buffer[codepoints_.current++];
-		}
+#undef TOML_SIMD_TARGET
+#undef TOML_SIMD_SSE2
+#undef TOML_SIMD_AVX512BW
 
-		TOML_NODISCARD
-		bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) final
-		{
-			return stream_.peek_eof();
-		}
+#ifdef _MSC_VER
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+#ifndef __clang__
+#pragma inline_recursion(off)
+#endif
+#endif
+TOML_POP_WARNINGS;
 
-#if !TOML_EXCEPTIONS
+//********  impl/unicode.inl  ******************************************************************************************
 
-		TOML_NODISCARD
-		optional<parse_error>&& error() noexcept final
-		{
-			return std::move(err_);
-		}
+TOML_PUSH_WARNINGS;
+#ifdef _MSC_VER
+#ifndef __clang__
+#pragma inline_recursion(on)
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#endif
+
+TOML_IMPL_NAMESPACE_START
+{
+	TOML_PURE_GETTER
+	TOML_EXTERNAL_LINKAGE
+	bool is_ascii(const char* str, size_t len) noexcept
+	{
+		return simd().is_ascii(str, len);
+	}
+}
+TOML_IMPL_NAMESPACE_END;
+
+#ifdef _MSC_VER
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+#ifndef __clang__
+#pragma inline_recursion(off)
+#endif
+#endif
+TOML_POP_WARNINGS;
+
+//********  impl/decimal_to_double.inl  ********************************************************************************
 
+#if TOML_ENABLE_PARSER
+
+TOML_DISABLE_WARNINGS;
+#include <cfloat>
+#include <cstring>
+#if TOML_MSVC && TOML_ARCH_AMD64
+#include <intrin.h>
+#endif
+TOML_ENABLE_WARNINGS;
+TOML_PUSH_WARNINGS;
+#ifdef _MSC_VER
+#ifndef __clang__
+#pragma inline_recursion(on)
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
 #endif
+
+// decimal -> double conversion using the Eisel-Lemire algorithm (https://arxiv.org/abs/2101.11408), as popularized by
+// fast_float. it's exact for everything with 19 or fewer significant digits, save for a handful of inputs it can't
+// decide (halfway cases outside the exactly-representable range, subnormals, overflow), which are handed back to the
+// caller to convert the slow way.
+
+TOML_ANON_NAMESPACE_START
+{
+	// the 128 most significant bits of 5^q for q in [-342, 308], normalized so the top bit is set (and rounded up for
+	// negative q). generated with:
+	//
+	//	for q in range(-342, 0):
+	//		z = (5 ** -q).bit_length()
+	//		c = 2 ** ((z + 127) if q >= -27 else (2 * z + 128)) // 5 ** -q + 1
+	//		while c >= 1 << 128: c //= 2
+	//	for q in range(0, 309):
+	//		c = 5 ** q
+	//		while c < 1 << 127: c *= 2
+	//		while c >= 1 << 128: c //= 2
+	TOML_INTERNAL_LINKAGE
+	constexpr uint64_t powers_of_five[651][2] = {
+		{ 0xEEF453D6923BD65Au, 0x113FAA2906A13B3Fu },
+		{ 0x9558B4661B6565F8u, 0x4AC7CA59A424C507u },
+		{ 0xBAAEE17FA23EBF76u, 0x5D79BCF00D2DF649u },
+		{ 0xE95A99DF8ACE6F53u, 0xF4D82C2C107973DCu },
+		{ 0x91D8A02BB6C10594u, 0x79071B9B8A4BE869u },
+		{ 0xB64EC836A47146F9u, 0x9748E2826CDEE284u },
+		{ 0xE3E27A444D8D98B7u, 0xFD1B1B2308169B25u },
+		{ 0x8E6D8C6AB0787F72u, 0xFE30F0F5E50E20F7u },
+		{ 0xB208EF855C969F4Fu, 0xBDBD2D335E51A935u },
+		{ 0xDE8B2B66B3BC4723u, 0xAD2C788035E61382u },
+		{ 0x8B16FB203055AC76u, 0x4C3BCB5021AFCC31u },
+		{ 0xADDCB9E83C6B1793u, 0xDF4ABE242A1BBF3Du },
+		{ 0xD953E8624B85DD78u, 0xD71D6DAD34A2AF0Du },
+		{ 0x87D4713D6F33AA6Bu, 0x8672648C40E5AD68u },
+		{ 0xA9C98D8CCB009506u, 0x680EFDAF511F18C2u },
+		{ 0xD43BF0EFFDC0BA48u, 0x0212BD1B2566DEF2u },
+		{ 0x84A57695FE98746Du, 0x014BB630F7604B57u },
+		{ 0xA5CED43B7E3E9188u, 0x419EA3BD35385E2Du },
+		{ 0xCF42894A5DCE35EAu, 0x52064CAC828675B9u },
+		{ 0x818995CE7AA0E1B2u, 0x7343EFEBD1940993u },
+		{ 0xA1EBFB4219491A1Fu, 0x1014EBE6C5F90BF8u },
+		{ 0xCA66FA129F9B60A6u, 0xD41A26E077774EF6u },
+		{ 0xFD00B897478238D0u, 0x8920B098955522B4u },
+		{ 0x9E20735E8CB16382u, 0x55B46E5F5D5535B0u },
+		{ 0xC5A890362FDDBC62u, 0xEB2189F734AA831Du },
+		{ 0xF712B443BBD52B7Bu, 0xA5E9EC7501D523E4u },
+		{ 0x9A6BB0AA55653B2Du, 0x47B233C92125366Eu },
+		{ 0xC1069CD4EABE89F8u, 0x999EC0BB696E840Au },
+		{ 0xF148440A256E2C76u, 0xC00670EA43CA250Du },
+		{ 0x96CD2A865764DBCAu, 0x380406926A5E5728u },
+		{ 0xBC807527ED3E12BCu, 0xC605083704F5ECF2u },
+		{ 0xEBA09271E88D976Bu, 0xF7864A44C633682Eu },
+		{ 0x93445B8731587EA3u, 0x7AB3EE6AFBE0211Du },
+		{ 0xB8157268FDAE9E4Cu, 0x5960EA05BAD82964u },
+		{ 0xE61ACF033D1A45DFu, 0x6FB92487298E33BDu },
+		{ 0x8FD0C16206306BABu, 0xA5D3B6D479F8E056u },
+		{ 0xB3C4F1BA87BC8696u, 0x8F48A4899877186Cu },
+		{ 0xE0B62E2929ABA83Cu, 0x331ACDABFE94DE87u },
+		{ 0x8C71DCD9BA0B4925u, 0x9FF0C08B7F1D0B14u },
+		{ 0xAF8E5410288E1B6Fu, 0x07ECF0AE5EE44DD9u },
+		{ 0xDB71E91432B1A24Au, 0xC9E82CD9F69D6150u },
+		{ 0x892731AC9FAF056Eu, 0xBE311C083A225CD2u },
+		{ 0xAB70FE17C79AC6CAu, 0x6DBD630A48AAF406u },
+		{ 0xD64D3D9DB981787Du, 0x092CBBCCDAD5B108u },
+		{ 0x85F0468293F0EB4Eu, 0x25BBF56008C58EA5u },
+		{ 0xA76C582338ED2621u, 0xAF2AF2B80AF6F24Eu },
+		{ 0xD1476E2C07286FAAu, 0x1AF5AF660DB4AEE1u },
+		{ 0x82CCA4DB847945CAu, 0x50D98D9FC890ED4Du },
+		{ 0xA37FCE126597973Cu, 0xE50FF107BAB528A0u },
+		{ 0xCC5FC196FEFD7D0Cu, 0x1E53ED49A96272C8u },
+		{ 0xFF77B1FCBEBCDC4Fu, 0x25E8E89C13BB0F7Au },
+		{ 0x9FAACF3DF73609B1u, 0x77B191618C54E9ACu },
+		{ 0xC795830D75038C1Du, 0xD59DF5B9EF6A2417u },
+		{ 0xF97AE3D0D2446F25u, 0x4B0573286B44AD1Du },
+		{ 0x9BECCE62836AC577u, 0x4EE367F9430AEC32u },
+		{ 0xC2E801FB244576D5u, 0x229C41F793CDA73Fu },
+		{ 0xF3A20279ED56D48Au, 0x6B43527578C1110Fu },
+		{ 0x9845418C345644D6u, 0x830A13896B78AAA9u },
+		{ 0xBE5691EF416BD60Cu, 0x23CC986BC656D553u },
+		{ 0xEDEC366B11C6CB8Fu, 0x2CBFBE86B7EC8AA8u },
+		{ 0x94B3A202EB1C3F39u, 0x7BF7D71432F3D6A9u },
+		{ 0xB9E08A83A5E34F07u, 0xDAF5CCD93FB0CC53u },
+		{ 0xE858AD248F5C22C9u, 0xD1B3400F8F9CFF68u },
+		{ 0x91376C36D99995BEu, 0x23100809B9C21FA1u },
+		{ 0xB58547448FFFFB2Du, 0xABD40A0C2832A78Au },
+		{ 0xE2E69915B3FFF9F9u, 0x16C90C8F323F516Cu },
+		{ 0x8DD01FAD907FFC3Bu, 0xAE3DA7D97F6792E3u },
+		{ 0xB1442798F49FFB4Au, 0x99CD11CFDF41779Cu },
+		{ 0xDD95317F31C7FA1Du, 0x40405643D711D583u },
+		{ 0x8A7D3EEF7F1CFC52u, 0x482835EA666B2572u },
+		{ 0xAD1C8EAB5EE43B66u, 0xDA3243650005EECFu },
+		{ 0xD863B256369D4A40u, 0x90BED43E40076A82u },
+		{ 0x873E4F75E2224E68u, 0x5A7744A6E804A291u },
+		{ 0xA90DE3535AAAE202u, 0x711515D0A205CB36u },
+		{ 0xD3515C2831559A83u, 0x0D5A5B44CA873E03u },
+		{ 0x8412D9991ED58091u, 0xE858790AFE9486C2u },
+		{ 0xA5178FFF668AE0B6u, 0x626E974DBE39A872u },
+		{ 0xCE5D73FF402D98E3u, 0xFB0A3D212DC8128Fu },
+		{ 0x80FA687F881C7F8Eu, 0x7CE66634BC9D0B99u },
+		{ 0xA139029F6A239F72u, 0x1C1FFFC1EBC44E80u },
+		{ 0xC987434744AC874Eu, 0xA327FFB266B56220u },
+		{ 0xFBE9141915D7A922u, 0x4BF1FF9F0062BAA8u },
+		{ 0x9D71AC8FADA6C9B5u, 0x6F773FC3603DB4A9u },
+		{ 0xC4CE17B399107C22u, 0xCB550FB4384D21D3u },
+		{ 0xF6019DA07F549B2Bu, 0x7E2A53A146606A48u },
+		{ 0x99C102844F94E0FBu, 0x2EDA7444CBFC426Du },
+		{ 0xC0314325637A1939u, 0xFA911155FEFB5308u },
+		{ 0xF03D93EEBC589F88u, 0x793555AB7EBA27CAu },
+		{ 0x96267C7535B763B5u, 0x4BC1558B2F3458DEu },
+		{ 0xBBB01B9283253CA2u, 0x9EB1AAEDFB016F16u },
+		{ 0xEA9C227723EE8BCBu, 0x465E15A979C1CADCu },
+		{ 0x92A1958A7675175Fu, 0x0BFACD89EC191EC9u },
+		{ 0xB749FAED14125D36u, 0xCEF980EC671F667Bu },
+		{ 0xE51C79A85916F484u, 0x82B7E12780E7401Au },
+		{ 0x8F31CC0937AE58D2u, 0xD1B2ECB8B0908810u },
+		{ 0xB2FE3F0B8599EF07u, 0x861FA7E6DCB4AA15u },
+		{ 0xDFBDCECE67006AC9u, 0x67A791E093E1D49Au },
+		{ 0x8BD6A141006042BDu, 0xE0C8BB2C5C6D24E0u },
+		{ 0xAECC49914078536Du, 0x58FAE9F773886E18u },
+		{ 0xDA7F5BF590966848u, 0xAF39A475506A899Eu },
+		{ 0x888F99797A5E012Du, 0x6D8406C952429603u },
+		{ 0xAAB37FD7D8F58178u, 0xC8E5087BA6D33B83u },
+		{ 0xD5605FCDCF32E1D6u, 0xFB1E4A9A90880A64u },
+		{ 0x855C3BE0A17FCD26u, 0x5CF2EEA09A55067Fu },
+		{ 0xA6B34AD8C9DFC06Fu, 0xF42FAA48C0EA481Eu },
+		{ 0xD0601D8EFC57B08Bu, 0xF13B94DAF124DA26u },
+		{ 0x823C12795DB6CE57u, 0x76C53D08D6B70858u },
+		{ 0xA2CB1717B52481EDu, 0x54768C4B0C64CA6Eu },
+		{ 0xCB7DDCDDA26DA268u, 0xA9942F5DCF7DFD09u },
+		{ 0xFE5D54150B090B02u, 0xD3F93B35435D7C4Cu },
+		{ 0x9EFA548D26E5A6E1u, 0xC47BC5014A1A6DAFu },
+		{ 0xC6B8E9B0709F109Au, 0x359AB6419CA1091Bu },
+		{ 0xF867241C8CC6D4C0u, 0xC30163D203C94B62u },
+		{ 0x9B407691D7FC44F8u, 0x79E0DE63425DCF1Du },
+		{ 0xC21094364DFB5636u, 0x985915FC12F542E4u },
+		{ 0xF294B943E17A2BC4u, 0x3E6F5B7B17B2939Du },
+		{ 0x979CF3CA6CEC5B5Au, 0xA705992CEECF9C42u },
+		{ 0xBD8430BD08277231u, 0x50C6FF782A838353u },
+		{ 0xECE53CEC4A314EBDu, 0xA4F8BF5635246428u },
+		{ 0x940F4613AE5ED136u, 0x871B7795E136BE99u },
+		{ 0xB913179899F68584u, 0x28E2557B59846E3Fu },
+		{ 0xE757DD7EC07426E5u, 0x331AEADA2FE589CFu },
+		{ 0x9096EA6F3848984Fu, 0x3FF0D2C85DEF7621u },
+		{ 0xB4BCA50B065ABE63u, 0x0FED077A756B53A9u },
+		{ 0xE1EBCE4DC7F16DFBu, 0xD3E8495912C62894u },
+		{ 0x8D3360F09CF6E4BDu, 0x64712DD7ABBBD95Cu },
+		{ 0xB080392CC4349DECu, 0xBD8D794D96AACFB3u },
+		{ 0xDCA04777F541C567u, 0xECF0D7A0FC5583A0u },
+		{ 0x89E42CAAF9491B60u, 0xF41686C49DB57244u },
+		{ 0xAC5D37D5B79B6239u, 0x311C2875C522CED5u },
+		{ 0xD77485CB25823AC7u, 0x7D633293366B828Bu },
+		{ 0x86A8D39EF77164BCu, 0xAE5DFF9C02033197u },
+		{ 0xA8530886B54DBDEBu, 0xD9F57F830283FDFCu },
+		{ 0xD267CAA862A12D66u, 0xD072DF63C324FD7Bu },
+		{ 0x8380DEA93DA4BC60u, 0x4247CB9E59F71E6Du },
+		{ 0xA46116538D0DEB78u, 0x52D9BE85F074E608u },
+		{ 0xCD795BE870516656u, 0x67902E276C921F8Bu },
+		{ 0x806BD9714632DFF6u, 0x00BA1CD8A3DB53B6u },
+		{ 0xA086CFCD97BF97F3u, 0x80E8A40ECCD228A4u },
+		{ 0xC8A883C0FDAF7DF0u, 0x6122CD128006B2CDu },
+		{ 0xFAD2A4B13D1B5D6Cu, 0x796B805720085F81u },
+		{ 0x9CC3A6EEC6311A63u, 0xCBE3303674053BB0u },
+		{ 0xC3F490AA77BD60FCu, 0xBEDBFC4411068A9Cu },
+		{ 0xF4F1B4D515ACB93Bu, 0xEE92FB5515482D44u },
+		{ 0x991711052D8BF3C5u, 0x751BDD152D4D1C4Au },
+		{ 0xBF5CD54678EEF0B6u, 0xD262D45A78A0635Du },
+		{ 0xEF340A98172AACE4u, 0x86FB897116C87C34u },
+		{ 0x9580869F0E7AAC0Eu, 0xD45D35E6AE3D4DA0u },
+		{ 0xBAE0A846D2195712u, 0x8974836059CCA109u },
+		{ 0xE998D258869FACD7u, 0x2BD1A438703FC94Bu },
+		{ 0x91FF83775423CC06u, 0x7B6306A34627DDCFu },
+		{ 0xB67F6455292CBF08u, 0x1A3BC84C17B1D542u },
+		{ 0xE41F3D6A7377EECAu, 0x20CABA5F1D9E4A93u },
+		{ 0x8E938662882AF53Eu, 0x547EB47B7282EE9Cu },
+		{ 0xB23867FB2A35B28Du, 0xE99E619A4F23AA43u },
+		{ 0xDEC681F9F4C31F31u, 0x6405FA00E2EC94D4u },
+		{ 0x8B3C113C38F9F37Eu, 0xDE83BC408DD3DD04u },
+		{ 0xAE0B158B4738705Eu, 0x9624AB50B148D445u },
+		{ 0xD98DDAEE19068C76u, 0x3BADD624DD9B0957u },
+		{ 0x87F8A8D4CFA417C9u, 0xE54CA5D70A80E5D6u },
+		{ 0xA9F6D30A038D1DBCu, 0x5E9FCF4CCD211F4Cu },
+		{ 0xD47487CC8470652Bu, 0x7647C3200069671Fu },
+		{ 0x84C8D4DFD2C63F3Bu, 0x29ECD9F40041E073u },
+		{ 0xA5FB0A17C777CF09u, 0xF468107100525890u },
+		{ 0xCF79CC9DB955C2CCu, 0x7182148D4066EEB4u },
+		{ 0x81AC1FE293D599BFu, 0xC6F14CD848405530u },
+		{ 0xA21727DB38CB002Fu, 0xB8ADA00E5A506A7Cu },
+		{ 0xCA9CF1D206FDC03Bu, 0xA6D90811F0E4851Cu },
+		{ 0xFD442E4688BD304Au, 0x908F4A166D1DA663u },
+		{ 0x9E4A9CEC15763E2Eu, 0x9A598E4E043287FEu },
+		{ 0xC5DD44271AD3CDBAu, 0x40EFF1E1853F29FDu },
+		{ 0xF7549530E188C128u, 0xD12BEE59E68EF47Cu },
+		{ 0x9A94DD3E8CF578B9u, 0x82BB74F8301958CEu },
+		{ 0xC13A148E3032D6E7u, 0xE36A52363C1FAF01u },
+		{ 0xF18899B1BC3F8CA1u, 0xDC44E6C3CB279AC1u },
+		{ 0x96F5600F15A7B7E5u, 0x29AB103A5EF8C0B9u },
+		{ 0xBCB2B812DB11A5DEu, 0x7415D448F6B6F0E7u },
+		{ 0xEBDF661791D60F56u, 0x111B495B3464AD21u },
+		{ 0x936B9FCEBB25C995u, 0xCAB10DD900BEEC34u },
+		{ 0xB84687C269EF3BFBu, 0x3D5D514F40EEA742u },
+		{ 0xE65829B3046B0AFAu, 0x0CB4A5A3112A5112u },
+		{ 0x8FF71A0FE2C2E6DCu, 0x47F0E785EABA72ABu },
+		{ 0xB3F4E093DB73A093u, 0x59ED216765690F56u },
+		{ 0xE0F218B8D25088B8u, 0x306869C13EC3532Cu },
+		{ 0x8C974F7383725573u, 0x1E414218C73A13FBu },
+		{ 0xAFBD2350644EEACFu, 0xE5D1929EF90898FAu },
+		{ 0xDBAC6C247D62A583u, 0xDF45F746B74ABF39u },
+		{ 0x894BC396CE5DA772u, 0x6B8BBA8C328EB783u },
+		{ 0xAB9EB47C81F5114Fu, 0x066EA92F3F326564u },
+		{ 0xD686619BA27255A2u, 0xC80A537B0EFEFEBDu },
+		{ 0x8613FD0145877585u, 0xBD06742CE95F5F36u },
+		{ 0xA798FC4196E952E7u, 0x2C48113823B73704u },
+		{ 0xD17F3B51FCA3A7A0u, 0xF75A15862CA504C5u },
+		{ 0x82EF85133DE648C4u, 0x9A984D73DBE722FBu },
+		{ 0xA3AB66580D5FDAF5u, 0xC13E60D0D2E0EBBAu },
+		{ 0xCC963FEE10B7D1B3u, 0x318DF905079926A8u },
+		{ 0xFFBBCFE994E5C61Fu, 0xFDF17746497F7052u },
+		{ 0x9FD561F1FD0F9BD3u, 0xFEB6EA8BEDEFA633u },
+		{ 0xC7CABA6E7C5382C8u, 0xFE64A52EE96B8FC0u },
+		{ 0xF9BD690A1B68637Bu, 0x3DFDCE7AA3C673B0u },
+		{ 0x9C1661A651213E2Du, 0x06BEA10CA65C084Eu },
+		{ 0xC31BFA0FE5698DB8u, 0x486E494FCFF30A62u },
+		{ 0xF3E2F893DEC3F126u, 0x5A89DBA3C3EFCCFAu },
+		{ 0x986DDB5C6B3A76B7u, 0xF89629465A75E01Cu },
+		{ 0xBE89523386091465u, 0xF6BBB397F1135823u },
+		{ 0xEE2BA6C0678B597Fu, 0x746AA07DED582E2Cu },
+		{ 0x94DB483840B717EFu, 0xA8C2A44EB4571CDCu },
+		{ 0xBA121A4650E4DDEBu, 0x92F34D62616CE413u },
+		{ 0xE896A0D7E51E1566u, 0x77B020BAF9C81D17u },
+		{ 0x915E2486EF32CD60u, 0x0ACE1474DC1D122Eu },
+		{ 0xB5B5ADA8AAFF80B8u, 0x0D819992132456BAu },
+		{ 0xE3231912D5BF60E6u, 0x10E1FFF697ED6C69u },
+		{ 0x8DF5EFABC5979C8Fu, 0xCA8D3FFA1EF463C1u },
+		{ 0xB1736B96B6FD83B3u, 0xBD308FF8A6B17CB2u },
+		{ 0xDDD0467C64BCE4A0u, 0xAC7CB3F6D05DDBDEu },
+		{ 0x8AA22C0DBEF60EE4u, 0x6BCDF07A423AA96Bu },
+		{ 0xAD4AB7112EB3929Du, 0x86C16C98D2C953C6u },
+		{ 0xD89D64D57A607744u, 0xE871C7BF077BA8B7u },
+		{ 0x87625F056C7C4A8Bu, 0x11471CD764AD4972u },
+		{ 0xA93AF6C6C79B5D2Du, 0xD598E40D3DD89BCFu },
+		{ 0xD389B47879823479u, 0x4AFF1D108D4EC2C3u },
+		{ 0x843610CB4BF160CBu, 0xCEDF722A585139BAu },
+		{ 0xA54394FE1EEDB8FEu, 0xC2974EB4EE658828u },
+		{ 0xCE947A3DA6A9273Eu, 0x733D226229FEEA32u },
+		{ 0x811CCC668829B887u, 0x0806357D5A3F525Fu },
+		{ 0xA163FF802A3426A8u, 0xCA07C2DCB0CF26F7u },
+		{ 0xC9BCFF6034C13052u, 0xFC89B393DD02F0B5u },
+		{ 0xFC2C3F3841F17C67u, 0xBBAC2078D443ACE2u },
+		{ 0x9D9BA7832936EDC0u, 0xD54B944B84AA4C0Du },
+		{ 0xC5029163F384A931u, 0x0A9E795E65D4DF11u },
+		{ 0xF64335BCF065D37Du, 0x4D4617B5FF4A16D5u },
+		{ 0x99EA0196163FA42Eu, 0x504BCED1BF8E4E45u },
+		{ 0xC06481FB9BCF8D39u, 0xE45EC2862F71E1D6u },
+		{ 0xF07DA27A82C37088u, 0x5D767327BB4E5A4Cu },
+		{ 0x964E858C91BA2655u, 0x3A6A07F8D510F86Fu },
+		{ 0xBBE226EFB628AFEAu, 0x890489F70A55368Bu },
+		{ 0xEADAB0ABA3B2DBE5u, 0x2B45AC74CCEA842Eu },
+		{ 0x92C8AE6B464FC96Fu, 0x3B0B8BC90012929Du },
+		{ 0xB77ADA0617E3BBCBu, 0x09CE6EBB40173744u },
+		{ 0xE55990879DDCAABDu, 0xCC420A6A101D0515u },
+		{ 0x8F57FA54C2A9EAB6u, 0x9FA946824A12232Du },
+		{ 0xB32DF8E9F3546564u, 0x47939822DC96ABF9u },
+		{ 0xDFF9772470297EBDu, 0x59787E2B93BC56F7u },
+		{ 0x8BFBEA76C619EF36u, 0x57EB4EDB3C55B65Au },
+		{ 0xAEFAE51477A06B03u, 0xEDE622920B6B23F1u },
+		{ 0xDAB99E59958885C4u, 0xE95FAB368E45ECEDu },
+		{ 0x88B402F7FD75539Bu, 0x11DBCB0218EBB414u },
+		{ 0xAAE103B5FCD2A881u, 0xD652BDC29F26A119u },
+		{ 0xD59944A37C0752A2u, 0x4BE76D3346F0495Fu },
+		{ 0x857FCAE62D8493A5u, 0x6F70A4400C562DDBu },
+		{ 0xA6DFBD9FB8E5B88Eu, 0xCB4CCD500F6BB952u },
+		{ 0xD097AD07A71F26B2u, 0x7E2000A41346A7A7u },
+		{ 0x825ECC24C873782Fu, 0x8ED400668C0C28C8u },
+		{ 0xA2F67F2DFA90563Bu, 0x728900802F0F32FAu },
+		{ 0xCBB41EF979346BCAu, 0x4F2B40A03AD2FFB9u },
+		{ 0xFEA126B7D78186BCu, 0xE2F610C84987BFA8u },
+		{ 0x9F24B832E6B0F436u, 0x0DD9CA7D2DF4D7C9u },
+		{ 0xC6EDE63FA05D3143u, 0x91503D1C79720DBBu },
+		{ 0xF8A95FCF88747D94u, 0x75A44C6397CE912Au },
+		{ 0x9B69DBE1B548CE7Cu, 0xC986AFBE3EE11ABAu },
+		{ 0xC24452DA229B021Bu, 0xFBE85BADCE996168u },
+		{ 0xF2D56790AB41C2A2u, 0xFAE27299423FB9C3u },
+		{ 0x97C560BA6B0919A5u, 0xDCCD879FC967D41Au },
+		{ 0xBDB6B8E905CB600Fu, 0x5400E987BBC1C920u },
+		{ 0xED246723473E3813u, 0x290123E9AAB23B68u },
+		{ 0x9436C0760C86E30Bu, 0xF9A0B6720AAF6521u },
+		{ 0xB94470938FA89BCEu, 0xF808E40E8D5B3E69u },
+		{ 0xE7958CB87392C2C2u, 0xB60B1D1230B20E04u },
+		{ 0x90BD77F3483BB9B9u, 0xB1C6F22B5E6F48C2u },
+		{ 0xB4ECD5F01A4AA828u, 0x1E38AEB6360B1AF3u },
+		{ 0xE2280B6C20DD5232u, 0x25C6DA63C38DE1B0u },
+		{ 0x8D590723948A535Fu, 0x579C487E5A38AD0Eu },
+		{ 0xB0AF48EC79ACE837u, 0x2D835A9DF0C6D851u },
+		{ 0xDCDB1B2798182244u, 0xF8E431456CF88E65u },
+		{ 0x8A08F0F8BF0F156Bu, 0x1B8E9ECB641B58FFu },
+		{ 0xAC8B2D36EED2DAC5u, 0xE272467E3D222F3Fu },
+		{ 0xD7ADF884AA879177u, 0x5B0ED81DCC6ABB0Fu },
+		{ 0x86CCBB52EA94BAEAu, 0x98E947129FC2B4E9u },
+		{ 0xA87FEA27A539E9A5u, 0x3F2398D747B36224u },
+		{ 0xD29FE4B18E88640Eu, 0x8EEC7F0D19A03AADu },
+		{ 0x83A3EEEEF9153E89u, 0x1953CF68300424ACu },
+		{ 0xA48CEAAAB75A8E2Bu, 0x5FA8C3423C052DD7u },
+		{ 0xCDB02555653131B6u, 0x3792F412CB06794Du },
+		{ 0x808E17555F3EBF11u, 0xE2BBD88BBEE40BD0u },
+		{ 0xA0B19D2AB70E6ED6u, 0x5B6ACEAEAE9D0EC4u },
+		{ 0xC8DE047564D20A8Bu, 0xF245825A5A445275u },
+		{ 0xFB158592BE068D2Eu, 0xEED6E2F0F0D56712u },
+		{ 0x9CED737BB6C4183Du, 0x55464DD69685606Bu },
+		{ 0xC428D05AA4751E4Cu, 0xAA97E14C3C26B886u },
+		{ 0xF53304714D9265DFu, 0xD53DD99F4B3066A8u },
+		{ 0x993FE2C6D07B7FABu, 0xE546A8038EFE4029u },
+		{ 0xBF8FDB78849A5F96u, 0xDE98520472BDD033u },
+		{ 0xEF73D256A5C0F77Cu, 0x963E66858F6D4440u },
+		{ 0x95A8637627989AADu, 0xDDE7001379A44AA8u },
+		{ 0xBB127C53B17EC159u, 0x5560C018580D5D52u },
+		{ 0xE9D71B689DDE71AFu, 0xAAB8F01E6E10B4A6u },
+		{ 0x9226712162AB070Du, 0xCAB3961304CA70E8u },
+		{ 0xB6B00D69BB55C8D1u, 0x3D607B97C5FD0D22u },
+		{ 0xE45C10C42A2B3B05u, 0x8CB89A7DB77C506Au },
+		{ 0x8EB98A7A9A5B04E3u, 0x77F3608E92ADB242u },
+		{ 0xB267ED1940F1C61Cu, 0x55F038B237591ED3u },
+		{ 0xDF01E85F912E37A3u, 0x6B6C46DEC52F6688u },
+		{ 0x8B61313BBABCE2C6u, 0x2323AC4B3B3DA015u },
+		{ 0xAE397D8AA96C1B77u, 0xABEC975E0A0D081Au },
+		{ 0xD9C7DCED53C72255u, 0x96E7BD358C904A21u },
+		{ 0x881CEA14545C7575u, 0x7E50D64177DA2E54u },
+		{ 0xAA242499697392D2u, 0xDDE50BD1D5D0B9E9u },
+		{ 0xD4AD2DBFC3D07787u, 0x955E4EC64B44E864u },
+		{ 0x84EC3C97DA624AB4u, 0xBD5AF13BEF0B113Eu },
+		{ 0xA6274BBDD0FADD61u, 0xECB1AD8AEACDD58Eu },
+		{ 0xCFB11EAD453994BAu, 0x67DE18EDA5814AF2u },
+		{ 0x81CEB32C4B43FCF4u, 0x80EACF948770CED7u },
+		{ 0xA2425FF75E14FC31u, 0xA1258379A94D028Du },
+		{ 0xCAD2F7F5359A3B3Eu, 0x096EE45813A04330u },
+		{ 0xFD87B5F28300CA0Du, 0x8BCA9D6E188853FCu },
+		{ 0x9E74D1B791E07E48u, 0x775EA264CF55347Eu },
+		{ 0xC612062576589DDAu, 0x95364AFE032A819Eu },
+		{ 0xF79687AED3EEC551u, 0x3A83DDBD83F52205u },
+		{ 0x9ABE14CD44753B52u, 0xC4926A9672793543u },
+		{ 0xC16D9A0095928A27u, 0x75B7053C0F178294u },
+		{ 0xF1C90080BAF72CB1u, 0x5324C68B12DD6339u },
+		{ 0x971DA05074DA7BEEu, 0xD3F6FC16EBCA5E04u },
+		{ 0xBCE5086492111AEAu, 0x88F4BB1CA6BCF585u },
+		{ 0xEC1E4A7DB69561A5u, 0x2B31E9E3D06C32E6u },
+		{ 0x9392EE8E921D5D07u, 0x3AFF322E62439FD0u },
+		{ 0xB877AA3236A4B449u, 0x09BEFEB9FAD487C3u },
+		{ 0xE69594BEC44DE15Bu, 0x4C2EBE687989A9B4u },
+		{ 0x901D7CF73AB0ACD9u, 0x0F9D37014BF60A11u },
+		{ 0xB424DC35095CD80Fu, 0x538484C19EF38C95u },
+		{ 0xE12E13424BB40E13u, 0x2865A5F206B06FBAu },
+		{ 0x8CBCCC096F5088CBu, 0xF93F87B7442E45D4u },
+		{ 0xAFEBFF0BCB24AAFEu, 0xF78F69A51539D749u },
+		{ 0xDBE6FECEBDEDD5BEu, 0xB573440E5A884D1Cu },
+		{ 0x89705F4136B4A597u, 0x31680A88F8953031u },
+		{ 0xABCC77118461CEFCu, 0xFDC20D2B36BA7C3Eu },
+		{ 0xD6BF94D5E57A42BCu, 0x3D32907604691B4Du },
+		{ 0x8637BD05AF6C69B5u, 0xA63F9A49C2C1B110u },
+		{ 0xA7C5AC471B478423u, 0x0FCF80DC33721D54u },
+		{ 0xD1B71758E219652Bu, 0xD3C36113404EA4A9u },
+		{ 0x83126E978D4FDF3Bu, 0x645A1CAC083126EAu },
+		{ 0xA3D70A3D70A3D70Au, 0x3D70A3D70A3D70A4u },
+		{ 0xCCCCCCCCCCCCCCCCu, 0xCCCCCCCCCCCCCCCDu },
+		{ 0x8000000000000000u, 0x0000000000000000u },
+		{ 0xA000000000000000u, 0x0000000000000000u },
+		{ 0xC800000000000000u, 0x0000000000000000u },
+		{ 0xFA00000000000000u, 0x0000000000000000u },
+		{ 0x9C40000000000000u, 0x0000000000000000u },
+		{ 0xC350000000000000u, 0x0000000000000000u },
+		{ 0xF424000000000000u, 0x0000000000000000u },
+		{ 0x9896800000000000u, 0x0000000000000000u },
+		{ 0xBEBC200000000000u, 0x0000000000000000u },
+		{ 0xEE6B280000000000u, 0x0000000000000000u },
+		{ 0x9502F90000000000u, 0x0000000000000000u },
+		{ 0xBA43B74000000000u, 0x0000000000000000u },
+		{ 0xE8D4A51000000000u, 0x0000000000000000u },
+		{ 0x9184E72A00000000u, 0x0000000000000000u },
+		{ 0xB5E620F480000000u, 0x0000000000000000u },
+		{ 0xE35FA931A0000000u, 0x0000000000000000u },
+		{ 0x8E1BC9BF04000000u, 0x0000000000000000u },
+		{ 0xB1A2BC2EC5000000u, 0x0000000000000000u },
+		{ 0xDE0B6B3A76400000u, 0x0000000000000000u },
+		{ 0x8AC7230489E80000u, 0x0000000000000000u },
+		{ 0xAD78EBC5AC620000u, 0x0000000000000000u },
+		{ 0xD8D726B7177A8000u, 0x0000000000000000u },
+		{ 0x878678326EAC9000u, 0x0000000000000000u },
+		{ 0xA968163F0A57B400u, 0x0000000000000000u },
+		{ 0xD3C21BCECCEDA100u, 0x0000000000000000u },
+		{ 0x84595161401484A0u, 0x0000000000000000u },
+		{ 0xA56FA5B99019A5C8u, 0x0000000000000000u },
+		{ 0xCECB8F27F4200F3Au, 0x0000000000000000u },
+		{ 0x813F3978F8940984u, 0x4000000000000000u },
+		{ 0xA18F07D736B90BE5u, 0x5000000000000000u },
+		{ 0xC9F2C9CD04674EDEu, 0xA400000000000000u },
+		{ 0xFC6F7C4045812296u, 0x4D00000000000000u },
+		{ 0x9DC5ADA82B70B59Du, 0xF020000000000000u },
+		{ 0xC5371912364CE305u, 0x6C28000000000000u },
+		{ 0xF684DF56C3E01BC6u, 0xC732000000000000u },
+		{ 0x9A130B963A6C115Cu, 0x3C7F400000000000u },
+		{ 0xC097CE7BC90715B3u, 0x4B9F100000000000u },
+		{ 0xF0BDC21ABB48DB20u, 0x1E86D40000000000u },
+		{ 0x96769950B50D88F4u, 0x1314448000000000u },
+		{ 0xBC143FA4E250EB31u, 0x17D955A000000000u },
+		{ 0xEB194F8E1AE525FDu, 0x5DCFAB0800000000u },
+		{ 0x92EFD1B8D0CF37BEu, 0x5AA1CAE500000000u },
+		{ 0xB7ABC627050305ADu, 0xF14A3D9E40000000u },
+		{ 0xE596B7B0C643C719u, 0x6D9CCD05D0000000u },
+		{ 0x8F7E32CE7BEA5C6Fu, 0xE4820023A2000000u },
+		{ 0xB35DBF821AE4F38Bu, 0xDDA2802C8A800000u },
+		{ 0xE0352F62A19E306Eu, 0xD50B2037AD200000u },
+		{ 0x8C213D9DA502DE45u, 0x4526F422CC340000u },
+		{ 0xAF298D050E4395D6u, 0x9670B12B7F410000u },
+		{ 0xDAF3F04651D47B4Cu, 0x3C0CDD765F114000u },
+		{ 0x88D8762BF324CD0Fu, 0xA5880A69FB6AC800u },
+		{ 0xAB0E93B6EFEE0053u, 0x8EEA0D047A457A00u },
+		{ 0xD5D238A4ABE98068u, 0x72A4904598D6D880u },
+		{ 0x85A36366EB71F041u, 0x47A6DA2B7F864750u },
+		{ 0xA70C3C40A64E6C51u, 0x999090B65F67D924u },
+		{ 0xD0CF4B50CFE20765u, 0xFFF4B4E3F741CF6Du },
+		{ 0x82818F1281ED449Fu, 0xBFF8F10E7A8921A4u },
+		{ 0xA321F2D7226895C7u, 0xAFF72D52192B6A0Du },
+		{ 0xCBEA6F8CEB02BB39u, 0x9BF4F8A69F764490u },
+		{ 0xFEE50B7025C36A08u, 0x02F236D04753D5B4u },
+		{ 0x9F4F2726179A2245u, 0x01D762422C946590u },
+		{ 0xC722F0EF9D80AAD6u, 0x424D3AD2B7B97EF5u },
+		{ 0xF8EBAD2B84E0D58Bu, 0xD2E0898765A7DEB2u },
+		{ 0x9B934C3B330C8577u, 0x63CC55F49F88EB2Fu },
+		{ 0xC2781F49FFCFA6D5u, 0x3CBF6B71C76B25FBu },
+		{ 0xF316271C7FC3908Au, 0x8BEF464E3945EF7Au },
+		{ 0x97EDD871CFDA3A56u, 0x97758BF0E3CBB5ACu },
+		{ 0xBDE94E8E43D0C8ECu, 0x3D52EEED1CBEA317u },
+		{ 0xED63A231D4C4FB27u, 0x4CA7AAA863EE4BDDu },
+		{ 0x945E455F24FB1CF8u, 0x8FE8CAA93E74EF6Au },
+		{ 0xB975D6B6EE39E436u, 0xB3E2FD538E122B44u },
+		{ 0xE7D34C64A9C85D44u, 0x60DBBCA87196B616u },
+		{ 0x90E40FBEEA1D3A4Au, 0xBC8955E946FE31CDu },
+		{ 0xB51D13AEA4A488DDu, 0x6BABAB6398BDBE41u },
+		{ 0xE264589A4DCDAB14u, 0xC696963C7EED2DD1u },
+		{ 0x8D7EB76070A08AECu, 0xFC1E1DE5CF543CA2u },
+		{ 0xB0DE65388CC8ADA8u, 0x3B25A55F43294BCBu },
+		{ 0xDD15FE86AFFAD912u, 0x49EF0EB713F39EBEu },
+		{ 0x8A2DBF142DFCC7ABu, 0x6E3569326C784337u },
+		{ 0xACB92ED9397BF996u, 0x49C2C37F07965404u },
+		{ 0xD7E77A8F87DAF7FBu, 0xDC33745EC97BE906u },
+		{ 0x86F0AC99B4E8DAFDu, 0x69A028BB3DED71A3u },
+		{ 0xA8ACD7C0222311BCu, 0xC40832EA0D68CE0Cu },
+		{ 0xD2D80DB02AABD62Bu, 0xF50A3FA490C30190u },
+		{ 0x83C7088E1AAB65DBu, 0x792667C6DA79E0FAu },
+		{ 0xA4B8CAB1A1563F52u, 0x577001B891185938u },
+		{ 0xCDE6FD5E09ABCF26u, 0xED4C0226B55E6F86u },
+		{ 0x80B05E5AC60B6178u, 0x544F8158315B05B4u },
+		{ 0xA0DC75F1778E39D6u, 0x696361AE3DB1C721u },
+		{ 0xC913936DD571C84Cu, 0x03BC3A19CD1E38E9u },
+		{ 0xFB5878494ACE3A5Fu, 0x04AB48A04065C723u },
+		{ 0x9D174B2DCEC0E47Bu, 0x62EB0D64283F9C76u },
+		{ 0xC45D1DF942711D9Au, 0x3BA5D0BD324F8394u },
+		{ 0xF5746577930D6500u, 0xCA8F44EC7EE36479u },
+		{ 0x9968BF6ABBE85F20u, 0x7E998B13CF4E1ECBu },
+		{ 0xBFC2EF456AE276E8u, 0x9E3FEDD8C321A67Eu },
+		{ 0xEFB3AB16C59B14A2u, 0xC5CFE94EF3EA101Eu },
+		{ 0x95D04AEE3B80ECE5u, 0xBBA1F1D158724A12u },
+		{ 0xBB445DA9CA61281Fu, 0x2A8A6E45AE8EDC97u },
+		{ 0xEA1575143CF97226u, 0xF52D09D71A3293BDu },
+		{ 0x924D692CA61BE758u, 0x593C2626705F9C56u },
+		{ 0xB6E0C377CFA2E12Eu, 0x6F8B2FB00C77836Cu },
+		{ 0xE498F455C38B997Au, 0x0B6DFB9C0F956447u },
+		{ 0x8EDF98B59A373FECu, 0x4724BD4189BD5EACu },
+		{ 0xB2977EE300C50FE7u, 0x58EDEC91EC2CB657u },
+		{ 0xDF3D5E9BC0F653E1u, 0x2F2967B66737E3EDu },
+		{ 0x8B865B215899F46Cu, 0xBD79E0D20082EE74u },
+		{ 0xAE67F1E9AEC07187u, 0xECD8590680A3AA11u },
+		{ 0xDA01EE641A708DE9u, 0xE80E6F4820CC9495u },
+		{ 0x884134FE908658B2u, 0x3109058D147FDCDDu },
+		{ 0xAA51823E34A7EEDEu, 0xBD4B46F0599FD415u },
+		{ 0xD4E5E2CDC1D1EA96u, 0x6C9E18AC7007C91Au },
+		{ 0x850FADC09923329Eu, 0x03E2CF6BC604DDB0u },
+		{ 0xA6539930BF6BFF45u, 0x84DB8346B786151Cu },
+		{ 0xCFE87F7CEF46FF16u, 0xE612641865679A63u },
+		{ 0x81F14FAE158C5F6Eu, 0x4FCB7E8F3F60C07Eu },
+		{ 0xA26DA3999AEF7749u, 0xE3BE5E330F38F09Du },
+		{ 0xCB090C8001AB551Cu, 0x5CADF5BFD3072CC5u },
+		{ 0xFDCB4FA002162A63u, 0x73D9732FC7C8F7F6u },
+		{ 0x9E9F11C4014DDA7Eu, 0x2867E7FDDCDD9AFAu },
+		{ 0xC646D63501A1511Du, 0xB281E1FD541501B8u },
+		{ 0xF7D88BC24209A565u, 0x1F225A7CA91A4226u },
+		{ 0x9AE757596946075Fu, 0x3375788DE9B06958u },
+		{ 0xC1A12D2FC3978937u, 0x0052D6B1641C83AEu },
+		{ 0xF209787BB47D6B84u, 0xC0678C5DBD23A49Au },
+		{ 0x9745EB4D50CE6332u, 0xF840B7BA963646E0u },
+		{ 0xBD176620A501FBFFu, 0xB650E5A93BC3D898u },
+		{ 0xEC5D3FA8CE427AFFu, 0xA3E51F138AB4CEBEu },
+		{ 0x93BA47C980E98CDFu, 0xC66F336C36B10137u },
+		{ 0xB8A8D9BBE123F017u, 0xB80B0047445D4184u },
+		{ 0xE6D3102AD96CEC1Du, 0xA60DC059157491E5u },
+		{ 0x9043EA1AC7E41392u, 0x87C89837AD68DB2Fu },
+		{ 0xB454E4A179DD1877u, 0x29BABE4598C311FBu },
+		{ 0xE16A1DC9D8545E94u, 0xF4296DD6FEF3D67Au },
+		{ 0x8CE2529E2734BB1Du, 0x1899E4A65F58660Cu },
+		{ 0xB01AE745B101E9E4u, 0x5EC05DCFF72E7F8Fu },
+		{ 0xDC21A1171D42645Du, 0x76707543F4FA1F73u },
+		{ 0x899504AE72497EBAu, 0x6A06494A791C53A8u },
+		{ 0xABFA45DA0EDBDE69u, 0x0487DB9D17636892u },
+		{ 0xD6F8D7509292D603u, 0x45A9D2845D3C42B6u },
+		{ 0x865B86925B9BC5C2u, 0x0B8A2392BA45A9B2u },
+		{ 0xA7F26836F282B732u, 0x8E6CAC7768D7141Eu },
+		{ 0xD1EF0244AF2364FFu, 0x3207D795430CD926u },
+		{ 0x8335616AED761F1Fu, 0x7F44E6BD49E807B8u },
+		{ 0xA402B9C5A8D3A6E7u, 0x5F16206C9C6209A6u },
+		{ 0xCD036837130890A1u, 0x36DBA887C37A8C0Fu },
+		{ 0x802221226BE55A64u, 0xC2494954DA2C9789u },
+		{ 0xA02AA96B06DEB0FDu, 0xF2DB9BAA10B7BD6Cu },
+		{ 0xC83553C5C8965D3Du, 0x6F92829494E5ACC7u },
+		{ 0xFA42A8B73ABBF48Cu, 0xCB772339BA1F17F9u },
+		{ 0x9C69A97284B578D7u, 0xFF2A760414536EFBu },
+		{ 0xC38413CF25E2D70Du, 0xFEF5138519684ABAu },
+		{ 0xF46518C2EF5B8CD1u, 0x7EB258665FC25D69u },
+		{ 0x98BF2F79D5993802u, 0xEF2F773FFBD97A61u },
+		{ 0xBEEEFB584AFF8603u, 0xAAFB550FFACFD8FAu },
+		{ 0xEEAABA2E5DBF6784u, 0x95BA2A53F983CF38u },
+		{ 0x952AB45CFA97A0B2u, 0xDD945A747BF26183u },
+		{ 0xBA756174393D88DFu, 0x94F971119AEEF9E4u },
+		{ 0xE912B9D1478CEB17u, 0x7A37CD5601AAB85Du },
+		{ 0x91ABB422CCB812EEu, 0xAC62E055C10AB33Au },
+		{ 0xB616A12B7FE617AAu, 0x577B986B314D6009u },
+		{ 0xE39C49765FDF9D94u, 0xED5A7E85FDA0B80Bu },
+		{ 0x8E41ADE9FBEBC27Du, 0x14588F13BE847307u },
+		{ 0xB1D219647AE6B31Cu, 0x596EB2D8AE258FC8u },
+		{ 0xDE469FBD99A05FE3u, 0x6FCA5F8ED9AEF3BBu },
+		{ 0x8AEC23D680043BEEu, 0x25DE7BB9480D5854u },
+		{ 0xADA72CCC20054AE9u, 0xAF561AA79A10AE6Au },
+		{ 0xD910F7FF28069DA4u, 0x1B2BA1518094DA04u },
+		{ 0x87AA9AFF79042286u, 0x90FB44D2F05D0842u },
+		{ 0xA99541BF57452B28u, 0x353A1607AC744A53u },
+		{ 0xD3FA922F2D1675F2u, 0x42889B8997915CE8u },
+		{ 0x847C9B5D7C2E09B7u, 0x69956135FEBADA11u },
+		{ 0xA59BC234DB398C25u, 0x43FAB9837E699095u },
+		{ 0xCF02B2C21207EF2Eu, 0x94F967E45E03F4BBu },
+		{ 0x8161AFB94B44F57Du, 0x1D1BE0EEBAC278F5u },
+		{ 0xA1BA1BA79E1632DCu, 0x6462D92A69731732u },
+		{ 0xCA28A291859BBF93u, 0x7D7B8F7503CFDCFEu },
+		{ 0xFCB2CB35E702AF78u, 0x5CDA735244C3D43Eu },
+		{ 0x9DEFBF01B061ADABu, 0x3A0888136AFA64A7u },
+		{ 0xC56BAEC21C7A1916u, 0x088AAA1845B8FDD0u },
+		{ 0xF6C69A72A3989F5Bu, 0x8AAD549E57273D45u },
+		{ 0x9A3C2087A63F6399u, 0x36AC54E2F678864Bu },
+		{ 0xC0CB28A98FCF3C7Fu, 0x84576A1BB416A7DDu },
+		{ 0xF0FDF2D3F3C30B9Fu, 0x656D44A2A11C51D5u },
+		{ 0x969EB7C47859E743u, 0x9F644AE5A4B1B325u },
+		{ 0xBC4665B596706114u, 0x873D5D9F0DDE1FEEu },
+		{ 0xEB57FF22FC0C7959u, 0xA90CB506D155A7EAu },
+		{ 0x9316FF75DD87CBD8u, 0x09A7F12442D588F2u },
+		{ 0xB7DCBF5354E9BECEu, 0x0C11ED6D538AEB2Fu },
+		{ 0xE5D3EF282A242E81u, 0x8F1668C8A86DA5FAu },
+		{ 0x8FA475791A569D10u, 0xF96E017D694487BCu },
+		{ 0xB38D92D760EC4455u, 0x37C981DCC395A9ACu },
+		{ 0xE070F78D3927556Au, 0x85BBE253F47B1417u },
+		{ 0x8C469AB843B89562u, 0x93956D7478CCEC8Eu },
+		{ 0xAF58416654A6BABBu, 0x387AC8D1970027B2u },
+		{ 0xDB2E51BFE9D0696Au, 0x06997B05FCC0319Eu },
+		{ 0x88FCF317F22241E2u, 0x441FECE3BDF81F03u },
+		{ 0xAB3C2FDDEEAAD25Au, 0xD527E81CAD7626C3u },
+		{ 0xD60B3BD56A5586F1u, 0x8A71E223D8D3B074u },
+		{ 0x85C7056562757456u, 0xF6872D5667844E49u },
+		{ 0xA738C6BEBB12D16Cu, 0xB428F8AC016561DBu },
+		{ 0xD106F86E69D785C7u, 0xE13336D701BEBA52u },
+		{ 0x82A45B450226B39Cu, 0xECC0024661173473u },
+		{ 0xA34D721642B06084u, 0x27F002D7F95D0190u },
+		{ 0xCC20CE9BD35C78A5u, 0x31EC038DF7B441F4u },
+		{ 0xFF290242C83396CEu, 0x7E67047175A15271u },
+		{ 0x9F79A169BD203E41u, 0x0F0062C6E984D386u },
+		{ 0xC75809C42C684DD1u, 0x52C07B78A3E60868u },
+		{ 0xF92E0C3537826145u, 0xA7709A56CCDF8A82u },
+		{ 0x9BBCC7A142B17CCBu, 0x88A66076400BB691u },
+		{ 0xC2ABF989935DDBFEu, 0x6ACFF893D00EA435u },
+		{ 0xF356F7EBF83552FEu, 0x0583F6B8C4124D43u },
+		{ 0x98165AF37B2153DEu, 0xC3727A337A8B704Au },
+		{ 0xBE1BF1B059E9A8D6u, 0x744F18C0592E4C5Cu },
+		{ 0xEDA2EE1C7064130Cu, 0x1162DEF06F79DF73u },
+		{ 0x9485D4D1C63E8BE7u, 0x8ADDCB5645AC2BA8u },
+		{ 0xB9A74A0637CE2EE1u, 0x6D953E2BD7173692u },
+		{ 0xE8111C87C5C1BA99u, 0xC8FA8DB6CCDD0437u },
+		{ 0x910AB1D4DB9914A0u, 0x1D9C9892400A22A2u },
+		{ 0xB54D5E4A127F59C8u, 0x2503BEB6D00CAB4Bu },
+		{ 0xE2A0B5DC971F303Au, 0x2E44AE64840FD61Du },
+		{ 0x8DA471A9DE737E24u, 0x5CEAECFED289E5D2u },
+		{ 0xB10D8E1456105DADu, 0x7425A83E872C5F47u },
+		{ 0xDD50F1996B947518u, 0xD12F124E28F77719u },
+		{ 0x8A5296FFE33CC92Fu, 0x82BD6B70D99AAA6Fu },
+		{ 0xACE73CBFDC0BFB7Bu, 0x636CC64D1001550Bu },
+		{ 0xD8210BEFD30EFA5Au, 0x3C47F7E05401AA4Eu },
+		{ 0x8714A775E3E95C78u, 0x65ACFAEC34810A71u },
+		{ 0xA8D9D1535CE3B396u, 0x7F1839A741A14D0Du },
+		{ 0xD31045A8341CA07Cu, 0x1EDE48111209A050u },
+		{ 0x83EA2B892091E44Du, 0x934AED0AAB460432u },
+		{ 0xA4E4B66B68B65D60u, 0xF81DA84D5617853Fu },
+		{ 0xCE1DE40642E3F4B9u, 0x36251260AB9D668Eu },
+		{ 0x80D2AE83E9CE78F3u, 0xC1D72B7C6B426019u },
+		{ 0xA1075A24E4421730u, 0xB24CF65B8612F81Fu },
+		{ 0xC94930AE1D529CFCu, 0xDEE033F26797B627u },
+		{ 0xFB9B7CD9A4A7443Cu, 0x169840EF017DA3B1u },
+		{ 0x9D412E0806E88AA5u, 0x8E1F289560EE864Eu },
+		{ 0xC491798A08A2AD4Eu, 0xF1A6F2BAB92A27E2u },
+		{ 0xF5B5D7EC8ACB58A2u, 0xAE10AF696774B1DBu },
+		{ 0x9991A6F3D6BF1765u, 0xACCA6DA1E0A8EF29u },
+		{ 0xBFF610B0CC6EDD3Fu, 0x17FD090A58D32AF3u },
+		{ 0xEFF394DCFF8A948Eu, 0xDDFC4B4CEF07F5B0u },
+		{ 0x95F83D0A1FB69CD9u, 0x4ABDAF101564F98Eu },
+		{ 0xBB764C4CA7A4440Fu, 0x9D6D1AD41ABE37F1u },
+		{ 0xEA53DF5FD18D5513u, 0x84C86189216DC5EDu },
+		{ 0x92746B9BE2F8552Cu, 0x32FD3CF5B4E49BB4u },
+		{ 0xB7118682DBB66A77u, 0x3FBC8C33221DC2A1u },
+		{ 0xE4D5E82392A40515u, 0x0FABAF3FEAA5334Au },
+		{ 0x8F05B1163BA6832Du, 0x29CB4D87F2A7400Eu },
+		{ 0xB2C71D5BCA9023F8u, 0x743E20E9EF511012u },
+		{ 0xDF78E4B2BD342CF6u, 0x914DA9246B255416u },
+		{ 0x8BAB8EEFB6409C1Au, 0x1AD089B6C2F7548Eu },
+		{ 0xAE9672ABA3D0C320u, 0xA184AC2473B529B1u },
+		{ 0xDA3C0F568CC4F3E8u, 0xC9E5D72D90A2741Eu },
+		{ 0x8865899617FB1871u, 0x7E2FA67C7A658892u },
+		{ 0xAA7EEBFB9DF9DE8Du, 0xDDBB901B98FEEAB7u },
+		{ 0xD51EA6FA85785631u, 0x552A74227F3EA565u },
+		{ 0x8533285C936B35DEu, 0xD53A88958F87275Fu },
+		{ 0xA67FF273B8460356u, 0x8A892ABAF368F137u },
+		{ 0xD01FEF10A657842Cu, 0x2D2B7569B0432D85u },
+		{ 0x8213F56A67F6B29Bu, 0x9C3B29620E29FC73u },
+		{ 0xA298F2C501F45F42u, 0x8349F3BA91B47B8Fu },
+		{ 0xCB3F2F7642717713u, 0x241C70A936219A73u },
+		{ 0xFE0EFB53D30DD4D7u, 0xED238CD383AA0110u },
+		{ 0x9EC95D1463E8A506u, 0xF4363804324A40AAu },
+		{ 0xC67BB4597CE2CE48u, 0xB143C6053EDCD0D5u },
+		{ 0xF81AA16FDC1B81DAu, 0xDD94B7868E94050Au },
+		{ 0x9B10A4E5E9913128u, 0xCA7CF2B4191C8326u },
+		{ 0xC1D4CE1F63F57D72u, 0xFD1C2F611F63A3F0u },
+		{ 0xF24A01A73CF2DCCFu, 0xBC633B39673C8CECu },
+		{ 0x976E41088617CA01u, 0xD5BE0503E085D813u },
+		{ 0xBD49D14AA79DBC82u, 0x4B2D8644D8A74E18u },
+		{ 0xEC9C459D51852BA2u, 0xDDF8E7D60ED1219Eu },
+		{ 0x93E1AB8252F33B45u, 0xCABB90E5C942B503u },
+		{ 0xB8DA1662E7B00A17u, 0x3D6A751F3B936243u },
+		{ 0xE7109BFBA19C0C9Du, 0x0CC512670A783AD4u },
+		{ 0x906A617D450187E2u, 0x27FB2B80668B24C5u },
+		{ 0xB484F9DC9641E9DAu, 0xB1F9F660802DEDF6u },
+		{ 0xE1A63853BBD26451u, 0x5E7873F8A0396973u },
+		{ 0x8D07E33455637EB2u, 0xDB0B487B6423E1E8u },
+		{ 0xB049DC016ABC5E5Fu, 0x91CE1A9A3D2CDA62u },
+		{ 0xDC5C5301C56B75F7u, 0x7641A140CC7810FBu },
+		{ 0x89B9B3E11B6329BAu, 0xA9E904C87FCB0A9Du },
+		{ 0xAC2820D9623BF429u, 0x546345FA9FBDCD44u },
+		{ 0xD732290FBACAF133u, 0xA97C177947AD4095u },
+		{ 0x867F59A9D4BED6C0u, 0x49ED8EABCCCC485Du },
+		{ 0xA81F301449EE8C70u, 0x5C68F256BFFF5A74u },
+		{ 0xD226FC195C6A2F8Cu, 0x73832EEC6FFF3111u },
+		{ 0x83585D8FD9C25DB7u, 0xC831FD53C5FF7EABu },
+		{ 0xA42E74F3D032F525u, 0xBA3E7CA8B77F5E55u },
+		{ 0xCD3A1230C43FB26Fu, 0x28CE1BD2E55F35EBu },
+		{ 0x80444B5E7AA7CF85u, 0x7980D163CF5B81B3u },
+		{ 0xA0555E361951C366u, 0xD7E105BCC332621Fu },
+		{ 0xC86AB5C39FA63440u, 0x8DD9472BF3FEFAA7u },
+		{ 0xFA856334878FC150u, 0xB14F98F6F0FEB951u },
+		{ 0x9C935E00D4B9D8D2u, 0x6ED1BF9A569F33D3u },
+		{ 0xC3B8358109E84F07u, 0x0A862F80EC4700C8u },
+		{ 0xF4A642E14C6262C8u, 0xCD27BB612758C0FAu },
+		{ 0x98E7E9CCCFBD7DBDu, 0x8038D51CB897789Cu },
+		{ 0xBF21E44003ACDD2Cu, 0xE0470A63E6BD56C3u },
+		{ 0xEEEA5D5004981478u, 0x1858CCFCE06CAC74u },
+		{ 0x95527A5202DF0CCBu, 0x0F37801E0C43EBC8u },
+		{ 0xBAA718E68396CFFDu, 0xD30560258F54E6BAu },
+		{ 0xE950DF20247C83FDu, 0x47C6B82EF32A2069u },
+		{ 0x91D28B7416CDD27Eu, 0x4CDC331D57FA5441u },
+		{ 0xB6472E511C81471Du, 0xE0133FE4ADF8E952u },
+		{ 0xE3D8F9E563A198E5u, 0x58180FDDD97723A6u },
+		{ 0x8E679C2F5E44FF8Fu, 0x570F09EAA7EA7648u },
 	};
 
-	template <typename Char>
-	utf8_reader(std::basic_string_view<Char>, std::string_view) -> utf8_reader<std::basic_string_view<Char>>;
-	template <typename Char>
-	utf8_reader(std::basic_string_view<Char>, std::string&&) -> utf8_reader<std::basic_string_view<Char>>;
-	template <typename Char>
-	utf8_reader(std::basic_istream<Char>&, std::string_view) -> utf8_reader<std::basic_istream<Char>>;
-	template <typename Char>
-	utf8_reader(std::basic_istream<Char>&, std::string&&) -> utf8_reader<std::basic_istream<Char>>;
+	struct uint128_parts
+	{
+		uint64_t low;
+		uint64_t high;
+	};
 
-#if TOML_EXCEPTIONS
-#define utf8_buffered_reader_error_check(...) static_assert(true)
+	TOML_CONST_INLINE_GETTER
+	uint128_parts multiply_full(uint64_t a, uint64_t b) noexcept
+	{
+#ifdef TOML_UINT128
+		const auto product = static_cast<TOML_UINT128>(a) * b;
+		return { static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64) };
+#elif TOML_MSVC && TOML_ARCH_AMD64
+		uint128_parts result;
+		result.low = _umul128(a, b, &result.high);
+		return result;
 #else
-#define utf8_buffered_reader_error_check(...)                                                                          \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if TOML_UNLIKELY(reader_.error())                                                                              \
-			return __VA_ARGS__;                                                                                        \
-	}                                                                                                                  \
-	while (false)
+		const uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+		const uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+		const uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+		const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+		return { (cross << 32) | (lo_lo & 0xFFFFFFFFu), (hi_lo >> 32) + (cross >> 32) + hi_hi };
+#endif
+	}
 
+	TOML_CONST_INLINE_GETTER
+	int leading_zeroes(uint64_t val) noexcept
+	{
+		TOML_ASSERT_ASSUME(val);
+#if TOML_MSVC && TOML_ARCH_AMD64
+		unsigned long idx;
+		_BitScanReverse64(&idx, val);
+		return 63 - static_cast<int>(idx);
+#elif TOML_MSVC
+		int count = 0;
+		while (!(val & 0x8000000000000000u))
+		{
+			val <<= 1;
+			count++;
+		}
+		return count;
+#else
+		return __builtin_clzll(val);
 #endif
+	}
 
-	class TOML_EMPTY_BASES utf8_buffered_reader
+	// w * 10^q, or false if it can't be computed exactly this way.
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	bool eisel_lemire(uint64_t w, int64_t q, double& result) noexcept
 	{
-	  public:
-		static constexpr size_t max_history_length = 128;
+		constexpr int mantissa_bits = 52;
 
-	  private:
-		static constexpr size_t history_buffer_size = max_history_length - 1; //'head' is stored in the reader
-		utf8_reader_interface& reader_;
-		struct
+		if (!w)
 		{
-			utf8_codepoint buffer[history_buffer_size];
-			size_t count, first;
-		} history_					= {};
-		const utf8_codepoint* head_ = {};
-		size_t negative_offset_		= {};
+			result = 0.0;
+			return true;
+		}
+		if (q < -342 || q > 308)
+			return false;
 
-	  public:
-		TOML_NODISCARD_CTOR
-		explicit utf8_buffered_reader(utf8_reader_interface& reader) noexcept //
-			: reader_{ reader }
-		{}
+		const int lz = leading_zeroes(w);
+		w <<= lz;
 
-		TOML_PURE_INLINE_GETTER
-		const source_path_ptr& source_path() const noexcept
+		// only the top 55 bits of the product matter; the second half of the power of five is only needed if the
+		// bits below them are all set (and a carry out of them is possible)
+		const auto& power			 = powers_of_five[q + 342];
+		auto product				 = multiply_full(w, power[0]);
+		constexpr uint64_t low_bits = 0xFFFFFFFFFFFFFFFFu >> (mantissa_bits + 3);
+		if ((product.high & low_bits) == low_bits)
 		{
-			return reader_.source_path();
+			const auto second = multiply_full(w, power[1]);
+			product.low += second.high;
+			if (second.high > product.low)
+				product.high++;
+
+			if (product.low == 0xFFFFFFFFFFFFFFFFu && (q < -27 || q > 55))
+				return false;
 		}
 
-		TOML_NODISCARD
-		const utf8_codepoint* read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
-		{
-			utf8_buffered_reader_error_check({});
+		const int upper_bit = static_cast<int>(product.high >> 63);
+		const int shift		= upper_bit + 64 - mantissa_bits - 3;
+		uint64_t mantissa	= product.high >> shift;
 
-			if (negative_offset_)
-			{
-				negative_offset_--;
+		// floor(log2(10^q)) + 63, give or take the normalization above
+		int64_t exponent = ((((152170 + 65536) * q) >> 16) + 63) + upper_bit - lz + 1023;
+		if (exponent <= 0) // subnormal
+			return false;
 
-				// an entry negative offset of 1 just means "replay the current head"
-				if (!negative_offset_)
-					return head_;
+		// exact halfway cases are only possible when 10^q is exactly representable; those round to even
+		if (product.low <= 1 && q >= -4 && q <= 23 && (mantissa & 3u) == 1u && (mantissa << shift) == product.high)
+			mantissa &= ~uint64_t{ 1 };
 
-				// otherwise step back into the history buffer
-				else
-					return history_.buffer
-						 + ((history_.first + history_.count - negative_offset_) % history_buffer_size);
-			}
-			else
-			{
-				// first character read from stream
-				if TOML_UNLIKELY(!history_.count && !head_)
-					head_ = reader_.read_next();
+		mantissa += mantissa & 1u;
+		mantissa >>= 1;
+		if (mantissa >= (uint64_t{ 2 } << mantissa_bits))
+		{
+			mantissa = uint64_t{ 1 } << mantissa_bits;
+			exponent++;
+		}
+		mantissa &= ~(uint64_t{ 1 } << mantissa_bits);
+		if (exponent >= 0x7FF) // overflow
+			return false;
 
-				// subsequent characters and not eof
-				else if (head_)
-				{
-					if TOML_UNLIKELY(history_.count < history_buffer_size)
-						history_.buffer[history_.count++] = *head_;
-					else
-						history_.buffer[(history_.first++ + history_buffer_size) % history_buffer_size] = *head_;
+		const uint64_t bits = mantissa | (static_cast<uint64_t>(exponent) << mantissa_bits);
+		static_assert(sizeof(bits) == sizeof(result));
+		std::memcpy(&result, &bits, sizeof(result));
+		return true;
+	}
 
-					head_ = reader_.read_next();
-				}
+	// converts the digits of a TOML float (already validated, sign and underscores removed) to a double, or returns
+	// false if the caller needs to do it some other way.
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	bool decimal_to_double(const char* str, const char* end, double& result) noexcept
+	{
+		uint64_t w			= {};
+		int64_t q			= {};
+		int digits			= {}; // significant digits accumulated in w
+		bool truncated		= false;
+		bool seen_decimal	= false;
+		for (; str != end && *str != 'e' && *str != 'E'; str++)
+		{
+			if (*str == '.')
+			{
+				seen_decimal = true;
+				continue;
+			}
 
-				return head_;
+			const auto digit = static_cast<unsigned>(*str - '0');
+			if (digits < 19)
+			{
+				w = w * 10u + digit;
+				if (w)
+					digits++;
+				if (seen_decimal)
+					q--;
+			}
+			else
+			{
+				truncated = truncated || digit;
+				if (!seen_decimal)
+					q++;
 			}
 		}
 
-		TOML_NODISCARD
-		const utf8_codepoint* step_back(size_t count) noexcept
+		if (str != end)
 		{
-			utf8_buffered_reader_error_check({});
-
-			TOML_ASSERT_ASSUME(history_.count);
-			TOML_ASSERT_ASSUME(negative_offset_ + count <= history_.count);
-
-			negative_offset_ += count;
+			str++;
+			const bool negative = *str == '-';
+			if (*str == '+' || *str == '-')
+				str++;
 
-			return negative_offset_
-					 ? history_.buffer + ((history_.first + history_.count - negative_offset_) % history_buffer_size)
-					 : head_;
+			int64_t exponent = {};
+			for (; str != end; str++)
+				if (exponent < 100000)
+					exponent = exponent * 10 + (*str - '0');
+			q += negative ? -exponent : exponent;
 		}
 
-		TOML_NODISCARD
-		bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		// clinger's fast path: when both w and 10^q are exactly representable, so is the result of one IEEE operation
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+		if (!truncated && w <= (uint64_t{ 1 } << 53) && q >= -22 && q <= 22)
 		{
-			return reader_.peek_eof();
+			constexpr double exact_powers[] = { 1e0,  1e1,	1e2,  1e3,	1e4,  1e5,	1e6,  1e7,	1e8,  1e9,	1e10, 1e11,
+												1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+			result = static_cast<double>(w);
+			if (q < 0)
+				result /= exact_powers[-q];
+			else
+				result *= exact_powers[q];
+			return true;
 		}
+#endif
 
-#if !TOML_EXCEPTIONS
+		if (!eisel_lemire(w, q, result))
+			return false;
 
-		TOML_NODISCARD
-		optional<parse_error>&& error() noexcept
+		// the real value lies somewhere in [w, w + 1) * 10^q; if both ends round the same way, so does it
+		if (truncated)
 		{
-			return reader_.error();
+			double upper;
+			return eisel_lemire(w + 1u, q, upper) && upper == result;
 		}
-
-#endif
-	};
+		return true;
+	}
 }
 TOML_ANON_NAMESPACE_END;
 
-#if TOML_EXCEPTIONS
-#define TOML_RETURNS_BY_THROWING [[noreturn]]
-#else
-#define TOML_RETURNS_BY_THROWING
+#ifdef _MSC_VER
+#pragma pop_macro("min")
+#pragma pop_macro("max")
+#ifndef __clang__
+#pragma inline_recursion(off)
 #endif
+#endif
+TOML_POP_WARNINGS;
 
-TOML_ANON_NAMESPACE_START
-{
-	template <typename... T>
-	TOML_CONST_GETTER
-	TOML_INTERNAL_LINKAGE
-	constexpr bool is_match(char32_t codepoint, T... vals) noexcept
-	{
-		static_assert((std::is_same_v<char32_t, T> && ...));
-		return ((codepoint == vals) || ...);
-	}
+#endif // TOML_ENABLE_PARSER
 
-	template <uint64_t>
-	struct parse_integer_traits;
-	template <>
-	struct parse_integer_traits<2>
-	{
-		static constexpr auto scope_qualifier  = "binary integer"sv;
-		static constexpr auto is_digit		   = impl::is_binary_digit;
-		static constexpr auto is_signed		   = false;
-		static constexpr auto max_digits	   = 63;
-		static constexpr auto prefix_codepoint = U'b';
-		static constexpr auto prefix		   = "b"sv;
-		static constexpr auto full_prefix	   = "0b"sv;
-	};
-	template <>
-	struct parse_integer_traits<8>
-	{
-		static constexpr auto scope_qualifier  = "octal integer"sv;
-		static constexpr auto is_digit		   = impl::is_octal_digit;
-		static constexpr auto is_signed		   = false;
-		static constexpr auto max_digits	   = 21; // strlen("777777777777777777777")
-		static constexpr auto prefix_codepoint = U'o';
-		static constexpr auto prefix		   = "o"sv;
-		static constexpr auto full_prefix	   = "0o"sv;
-	};
-	template <>
-	struct parse_integer_traits<10>
-	{
-		static constexpr auto scope_qualifier = "decimal integer"sv;
-		static constexpr auto is_digit		  = impl::is_decimal_digit;
-		static constexpr auto is_signed		  = true;
-		static constexpr auto max_digits	  = 19; // strlen("9223372036854775807")
-		static constexpr auto full_prefix	  = ""sv;
-	};
-	template <>
-	struct parse_integer_traits<16>
-	{
-		static constexpr auto scope_qualifier  = "hexadecimal integer"sv;
-		static constexpr auto is_digit		   = impl::is_hexadecimal_digit;
-		static constexpr auto is_signed		   = false;
-		static constexpr auto max_digits	   = 16; // strlen("7FFFFFFFFFFFFFFF")
-		static constexpr auto prefix_codepoint = U'x';
-		static constexpr auto prefix		   = "x"sv;
-		static constexpr auto full_prefix	   = "0x"sv;
-	};
+//********  impl/parser.inl  *******************************************************************************************
 
-	TOML_PURE_GETTER
-	TOML_INTERNAL_LINKAGE
-	std::string_view to_sv(node_type val) noexcept
-	{
-		return impl::node_type_friendly_names[impl::unwrap_enum(val)];
-	}
+#if TOML_ENABLE_PARSER
 
-	TOML_PURE_GETTER
-	TOML_INTERNAL_LINKAGE
-	std::string_view to_sv(const std::string& str) noexcept
-	{
-		return std::string_view{ str };
-	}
+TOML_DISABLE_WARNINGS;
+#include <istream>
+#include <fstream>
+#if TOML_INT_CHARCONV || TOML_FLOAT_CHARCONV
+#include <charconv>
+#endif
+#if !TOML_INT_CHARCONV || !TOML_FLOAT_CHARCONV
+#include <sstream>
+#endif
+#if !TOML_INT_CHARCONV
+#include <iomanip>
+#endif
+#if TOML_ENABLE_MMAP && !TOML_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <atomic>
+#if TOML_ENABLE_THREADS
+#include <thread>
+#endif
+TOML_ENABLE_WARNINGS;
 
-	TOML_CONST_GETTER
-	TOML_INTERNAL_LINKAGE
-	std::string_view to_sv(bool val) noexcept
-	{
-		using namespace std::string_view_literals;
+#if TOML_ENABLE_MMAP && TOML_WINDOWS
+#ifndef _WINDOWS_
+#if TOML_INCLUDE_WINDOWS_H
+#include <Windows.h>
+#else
 
-		return val ? "true"sv : "false"sv;
-	}
+struct _SECURITY_ATTRIBUTES;
 
-	TOML_PURE_GETTER
-	TOML_INTERNAL_LINKAGE
-	std::string_view to_sv(const utf8_codepoint& cp) noexcept
-	{
-		if (cp.value <= U'\x1F')
-			return impl::control_char_escapes[cp.value];
-		else if (cp.value == U'\x7F')
-			return "\\u007F"sv;
-		else
-			return std::string_view{ cp.bytes, cp.count };
-	}
+extern "C" __declspec(dllimport) void* __stdcall CreateFileW(const wchar_t* lpFileName,
+															  unsigned long dwDesiredAccess,
+															  unsigned long dwShareMode,
+															  _SECURITY_ATTRIBUTES* lpSecurityAttributes,
+															  unsigned long dwCreationDisposition,
+															  unsigned long dwFlagsAndAttributes,
+															  void* hTemplateFile);
 
-	TOML_PURE_GETTER
-	TOML_INTERNAL_LINKAGE
-	std::string_view to_sv(const utf8_codepoint* cp) noexcept
-	{
-		if (cp)
-			return to_sv(*cp);
-		return ""sv;
-	}
+extern "C" __declspec(dllimport) unsigned long __stdcall GetFileSize(void* hFile, unsigned long* lpFileSizeHigh);
 
-	struct escaped_codepoint
-	{
-		const utf8_codepoint& cp;
-	};
+extern "C" __declspec(dllimport) void* __stdcall CreateFileMappingW(void* hFile,
+																	 _SECURITY_ATTRIBUTES* lpFileMappingAttributes,
+																	 unsigned long flProtect,
+																	 unsigned long dwMaximumSizeHigh,
+																	 unsigned long dwMaximumSizeLow,
+																	 const wchar_t* lpName);
+
+extern "C" __declspec(dllimport) void* __stdcall MapViewOfFile(void* hFileMappingObject,
+																unsigned long dwDesiredAccess,
+																unsigned long dwFileOffsetHigh,
+																unsigned long dwFileOffsetLow,
+																size_t dwNumberOfBytesToMap);
+
+extern "C" __declspec(dllimport) int __stdcall UnmapViewOfFile(const void* lpBaseAddress);
+
+extern "C" __declspec(dllimport) int __stdcall CloseHandle(void* hObject);
+
+#endif // TOML_INCLUDE_WINDOWS_H
+#endif // _WINDOWS_
+#endif // TOML_ENABLE_MMAP && TOML_WINDOWS
+
+TOML_PUSH_WARNINGS;
+#ifdef _MSC_VER
+#ifndef __clang__
+#pragma inline_recursion(on)
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#endif
 
+TOML_ANON_NAMESPACE_START
+{
 	template <typename T>
-	TOML_ATTR(nonnull)
+	class utf8_byte_stream;
+
 	TOML_INTERNAL_LINKAGE
-	void concatenate(char*& write_pos, char* const buf_end, const T& arg) noexcept
+	constexpr auto utf8_byte_order_mark = "\xEF\xBB\xBF"sv;
+
+	template <typename Char>
+	class utf8_byte_stream<std::basic_string_view<Char>>
 	{
-		if TOML_UNLIKELY(write_pos >= buf_end)
-			return;
+		static_assert(sizeof(Char) == 1);
 
-		using arg_type = impl::remove_cvref<T>;
+	  private:
+		std::basic_string_view<Char> source_;
+		size_t position_ = {};
 
-		// string views
-		if constexpr (std::is_same_v<arg_type, std::string_view>)
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit constexpr utf8_byte_stream(std::basic_string_view<Char> sv) noexcept //
+			: source_{ sv }
 		{
-			const auto max_chars = static_cast<size_t>(buf_end - write_pos);
-			const auto len		 = max_chars < arg.length() ? max_chars : arg.length();
-			std::memcpy(write_pos, arg.data(), len);
-			write_pos += len;
+			// skip bom
+			if (source_.length() >= 3u && memcmp(utf8_byte_order_mark.data(), source_.data(), 3u) == 0)
+				position_ += 3u;
 		}
 
-		// doubles
-		else if constexpr (std::is_same_v<arg_type, double>)
+		TOML_CONST_INLINE_GETTER
+		constexpr bool error() const noexcept
 		{
-#if TOML_FLOAT_CHARCONV
-			const auto result = std::to_chars(write_pos, buf_end, arg);
-			write_pos		  = result.ptr;
-#else
-			std::ostringstream ss;
-			ss.imbue(std::locale::classic());
-			ss.precision(std::numeric_limits<arg_type>::max_digits10);
-			ss << arg;
-			concatenate(write_pos, buf_end, to_sv(std::move(ss).str()));
-#endif
+			return false;
 		}
 
-		// 64-bit integers
-		else if constexpr (impl::is_one_of<arg_type, int64_t, uint64_t>)
+		TOML_PURE_INLINE_GETTER
+		constexpr bool eof() const noexcept
 		{
-#if TOML_INT_CHARCONV
-			const auto result = std::to_chars(write_pos, buf_end, arg);
-			write_pos		  = result.ptr;
-#else
-			std::ostringstream ss;
-			ss.imbue(std::locale::classic());
-			using cast_type = std::conditional_t<std::is_signed_v<arg_type>, int64_t, uint64_t>;
-			ss << static_cast<cast_type>(arg);
-			concatenate(write_pos, buf_end, to_sv(std::move(ss).str()));
-#endif
-		}
-
-		// escaped_codepoint
-		else if constexpr (std::is_same_v<arg_type, escaped_codepoint>)
-		{
-			if (arg.cp.value <= U'\x7F')
-				concatenate(write_pos, buf_end, to_sv(arg.cp));
-			else
-			{
-				auto val			= static_cast<uint_least32_t>(arg.cp.value);
-				const auto digits	= val > 0xFFFFu ? 8u : 4u;
-				constexpr auto mask = uint_least32_t{ 0xFu };
-				char buf[10]		= { '\\', digits > 4 ? 'U' : 'u' };
-				for (auto i = 2u + digits; i-- > 2u;)
-				{
-					const auto hexdig = val & mask;
-					buf[i]			  = static_cast<char>(hexdig >= 0xAu ? ('A' + (hexdig - 0xAu)) : ('0' + hexdig));
-					val >>= 4;
-				}
-				concatenate(write_pos, buf_end, std::string_view{ buf, digits + 2u });
-			}
+			return position_ >= source_.length();
 		}
 
-		// all other floats (fallback - coerce to double)
-		else if constexpr (std::is_floating_point_v<arg_type>)
-			concatenate(write_pos, buf_end, static_cast<double>(arg));
-
-		// all other integers (fallback - coerce to (u)int64_t)
-		else if constexpr (std::is_arithmetic_v<arg_type> && std::is_integral_v<arg_type>)
+		TOML_PURE_INLINE_GETTER
+		explicit constexpr operator bool() const noexcept
 		{
-			using cast_type = std::conditional_t<std::is_unsigned_v<arg_type>, uint64_t, int64_t>;
-			concatenate(write_pos, buf_end, static_cast<cast_type>(arg));
+			return !eof();
 		}
 
-		else
+		TOML_PURE_INLINE_GETTER
+		constexpr bool peek_eof() const noexcept
 		{
-			static_assert(
-				impl::always_false<T>,
-				"concatenate() inputs are limited to std::string_views, integers, floats, and escaped_codepoint");
+			return eof();
 		}
-	}
-
-	struct error_builder
-	{
-		static constexpr std::size_t buf_size = 512;
-		char buf[buf_size];
-		char* write_pos			  = buf;
-		char* const max_write_pos = buf + (buf_size - std::size_t{ 1 }); // allow for null terminator
 
-		TOML_NODISCARD_CTOR
-		error_builder(std::string_view scope) noexcept
+		TOML_NODISCARD
+		TOML_ATTR(nonnull)
+		size_t operator()(void* dest, size_t num) noexcept
 		{
-			concatenate(write_pos, max_write_pos, "Error while parsing "sv);
-			concatenate(write_pos, max_write_pos, scope);
-			concatenate(write_pos, max_write_pos, ": "sv);
-		}
+			TOML_ASSERT_ASSUME(!eof());
 
-		template <typename T>
-		void append(const T& arg) noexcept
-		{
-			concatenate(write_pos, max_write_pos, arg);
+			num = impl::min(position_ + num, source_.length()) - position_;
+			std::memcpy(dest, source_.data() + position_, num);
+			position_ += num;
+			return num;
 		}
 
-		TOML_RETURNS_BY_THROWING
-		auto finish(const source_position& pos, const source_path_ptr& source_path) const
+		TOML_PURE_INLINE_GETTER
+		std::string_view contiguous() const noexcept
 		{
-			*write_pos = '\0';
-
-#if TOML_EXCEPTIONS
-			throw parse_error{ buf, pos, source_path };
-#else
-			return parse_error{ std::string(buf, static_cast<size_t>(write_pos - buf)), pos, source_path };
-#endif
+			return { reinterpret_cast<const char*>(source_.data()) + position_, source_.length() - position_ };
 		}
-
-		TOML_DELETE_DEFAULTS(error_builder);
 	};
 
-	struct parse_scope
+	template <>
+	class utf8_byte_stream<std::istream>
 	{
-		std::string_view& storage_;
-		std::string_view parent_;
+	  private:
+		std::istream* source_;
 
+	  public:
 		TOML_NODISCARD_CTOR
-		explicit parse_scope(std::string_view& current_scope, std::string_view new_scope) noexcept
-			: storage_{ current_scope },
-			  parent_{ current_scope }
-		{
-			storage_ = new_scope;
-		}
-
-		~parse_scope() noexcept
+		explicit utf8_byte_stream(std::istream& stream) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) //
+			: source_{ &stream }
 		{
-			storage_ = parent_;
-		}
+			if (!*this) // eof, bad
+				return;
 
-		TOML_DELETE_DEFAULTS(parse_scope);
-	};
-#define push_parse_scope_2(scope, line) parse_scope ps_##line(current_scope, scope)
-#define push_parse_scope_1(scope, line) push_parse_scope_2(scope, line)
-#define push_parse_scope(scope)			push_parse_scope_1(scope, __LINE__)
+			const auto initial_pos = source_->tellg();
+			char bom[3];
+			source_->read(bom, 3);
+			if (source_->bad() || (source_->gcount() == 3 && memcmp(utf8_byte_order_mark.data(), bom, 3u) == 0))
+				return;
 
-	struct parse_key_buffer
-	{
-		std::string buffer;
-		std::vector<std::pair<size_t, size_t>> segments;
-		std::vector<source_position> starts;
-		std::vector<source_position> ends;
+			source_->clear();
+			source_->seekg(initial_pos, std::istream::beg);
+		}
 
-		void clear() noexcept
+		TOML_PURE_INLINE_GETTER
+		bool error() const noexcept
 		{
-			buffer.clear();
-			segments.clear();
-			starts.clear();
-			ends.clear();
+			return !!(source_->rdstate() & std::istream::badbit);
 		}
 
-		void push_back(std::string_view segment, source_position b, source_position e)
+		TOML_PURE_INLINE_GETTER
+		bool eof() const noexcept
 		{
-			segments.push_back({ buffer.length(), segment.length() });
-			buffer.append(segment);
-			starts.push_back(b);
-			ends.push_back(e);
+			return !!(source_->rdstate() & std::istream::eofbit);
 		}
 
 		TOML_PURE_INLINE_GETTER
-		std::string_view operator[](size_t i) const noexcept
+		explicit operator bool() const noexcept
 		{
-			return std::string_view{ buffer.c_str() + segments[i].first, segments[i].second };
+			return !(source_->rdstate() & (std::istream::badbit | std::istream::eofbit));
 		}
 
-		TOML_PURE_INLINE_GETTER
-		std::string_view back() const noexcept
+		TOML_NODISCARD
+		bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
 		{
-			return (*this)[segments.size() - 1u];
+			return eof() || source_->peek() == std::istream::traits_type::eof();
 		}
 
-		TOML_PURE_INLINE_GETTER
-		bool empty() const noexcept
+		TOML_NODISCARD
+		TOML_ATTR(nonnull)
+		size_t operator()(void* dest, size_t num) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
 		{
-			return segments.empty();
+			TOML_ASSERT(*this);
+
+			source_->read(static_cast<char*>(dest), static_cast<std::streamsize>(num));
+			return static_cast<size_t>(source_->gcount());
 		}
 
-		TOML_PURE_INLINE_GETTER
-		size_t size() const noexcept
+		TOML_CONST_INLINE_GETTER
+		constexpr std::string_view contiguous() const noexcept
 		{
-			return segments.size();
+			return {};
 		}
 	};
 
-	struct depth_counter_scope
+	struct utf8_codepoint
 	{
-		size_t& depth_;
+		char32_t value;
+		char bytes[4];
+		size_t count;
+		source_position position;
 
-		TOML_NODISCARD_CTOR
-		explicit depth_counter_scope(size_t& depth) noexcept //
-			: depth_{ depth }
+		TOML_PURE_INLINE_GETTER
+		constexpr operator const char32_t&() const noexcept
 		{
-			depth_++;
+			return value;
 		}
 
-		~depth_counter_scope() noexcept
+		TOML_PURE_INLINE_GETTER
+		constexpr const char32_t& operator*() const noexcept
 		{
-			depth_--;
+			return value;
 		}
-
-		TOML_DELETE_DEFAULTS(depth_counter_scope);
 	};
+	static_assert(std::is_trivially_default_constructible_v<utf8_codepoint> && std::is_trivially_copyable_v<utf8_codepoint>);
+	static_assert(std::is_standard_layout_v<utf8_codepoint>);
 
-	struct parsed_string
+	// decodes a utf-8 sequence that's already known to be valid and complete, without going through the state machine
+	TOML_ATTR(nonnull)
+	TOML_ALWAYS_INLINE
+	void decode_validated_utf8(utf8_codepoint& cp, const char* src) noexcept
 	{
-		std::string_view value;
-		bool was_multi_line;
-	};
+		const auto lead = static_cast<unsigned char>(*src);
+		if TOML_LIKELY(lead < 0x80u)
+		{
+			cp.value	= static_cast<char32_t>(lead);
+			cp.bytes[0] = *src;
+			cp.count	= 1u;
+			return;
+		}
 
-	struct table_vector_scope
+		cp.count = lead >= 0xF0u ? 4u : (lead >= 0xE0u ? 3u : 2u);
+		std::memcpy(cp.bytes, src, cp.count);
+
+		auto value = static_cast<uint_least32_t>(lead & (0x7Fu >> cp.count));
+		for (size_t i = 1; i < cp.count; i++)
+			value = (value << 6) | (static_cast<unsigned char>(src[i]) & 0x3Fu);
+		cp.value = static_cast<char32_t>(value);
+	}
+
+	struct TOML_ABSTRACT_INTERFACE utf8_reader_interface
 	{
-		std::vector<table*>& tables;
+		TOML_NODISCARD
+		virtual const source_path_ptr& source_path() const noexcept = 0;
 
-		TOML_NODISCARD_CTOR
-		explicit table_vector_scope(std::vector<table*>& tables_, table& tbl) //
-			: tables{ tables_ }
-		{
-			tables.push_back(&tbl);
-		}
+		TOML_NODISCARD
+		virtual const utf8_codepoint* read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) = 0;
 
-		~table_vector_scope() noexcept
-		{
-			tables.pop_back();
-		}
+		TOML_NODISCARD
+		virtual bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) = 0;
 
-		TOML_DELETE_DEFAULTS(table_vector_scope);
-	};
-}
-TOML_ANON_NAMESPACE_END;
+		TOML_NODISCARD
+		virtual std::string_view contiguous() const noexcept = 0;
 
-#if 1 // parser helper macros
+#if !TOML_EXCEPTIONS
 
-// Q: "what the fuck is this? MACROS????"
-// A: The parser needs to work in exceptionless mode (returning error objects directly)
-//    and exception mode (reporting parse failures by throwing). Two totally different control flows.
-//    These macros encapsulate the differences between the two modes so I can write code code
-//    as though I was only targeting one mode and not want yeet myself into the sun.
-//    They're all #undef'd at the bottom of the parser's implementation so they should be harmless outside
-//    of toml++.
+		TOML_NODISCARD
+		virtual optional<parse_error>&& error() noexcept = 0;
 
-#define is_eof()		 !cp
-#define assert_not_eof() TOML_ASSERT_ASSUME(cp != nullptr)
-#define return_if_eof(...)                                                                                             \
+#endif
+
+		virtual ~utf8_reader_interface() noexcept = default;
+	};
+
+#if TOML_EXCEPTIONS
+#define utf8_reader_error(...)				throw parse_error(__VA_ARGS__)
+#define utf8_reader_return_after_error(...) static_assert(true)
+#define utf8_reader_error_check(...)		static_assert(true)
+#else
+#define utf8_reader_error(...)				err_.emplace(__VA_ARGS__)
+#define utf8_reader_return_after_error(...) return __VA_ARGS__
+#define utf8_reader_error_check(...)                                                                                   \
 	do                                                                                                                 \
 	{                                                                                                                  \
-		if TOML_UNLIKELY(is_eof())                                                                                     \
+		if TOML_UNLIKELY(err_)                                                                                         \
 			return __VA_ARGS__;                                                                                        \
 	}                                                                                                                  \
 	while (false)
 
-#if TOML_EXCEPTIONS
-#define is_error()					false
-#define return_after_error(...)		TOML_UNREACHABLE
-#define assert_not_error()			static_assert(true)
-#define return_if_error(...)		static_assert(true)
-#define return_if_error_or_eof(...) return_if_eof(__VA_ARGS__)
-#else
-#define is_error()				!!err
-#define return_after_error(...) return __VA_ARGS__
-#define assert_not_error()		TOML_ASSERT(!is_error())
-#define return_if_error(...)                                                                                           \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if TOML_UNLIKELY(is_error())                                                                                   \
-			return __VA_ARGS__;                                                                                        \
-	}                                                                                                                  \
-	while (false)
-#define return_if_error_or_eof(...)                                                                                    \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if TOML_UNLIKELY(is_eof() || is_error())                                                                       \
-			return __VA_ARGS__;                                                                                        \
-	}                                                                                                                  \
-	while (false)
 #endif
 
-#if defined(TOML_BREAK_AT_PARSE_ERRORS) && TOML_BREAK_AT_PARSE_ERRORS
-#if defined(__has_builtin)
-#if __has_builtin(__builtin_debugtrap)
-#define parse_error_break() __builtin_debugtrap()
-#elif __has_builtin(__debugbreak)
-#define parse_error_break() __debugbreak()
-#endif
-#endif
-#ifndef parse_error_break
-#if TOML_MSVC || TOML_ICC
-#define parse_error_break() __debugbreak()
-#else
-#define parse_error_break() TOML_ASSERT(false)
-#endif
-#endif
+#if defined(__APPLE__) || defined(__MINGW32__) || defined(__MINGW64__)
+#define TOML_OVERALIGNED
 #else
-#define parse_error_break() static_assert(true)
+#define TOML_OVERALIGNED alignas(32)
 #endif
 
-#define set_error_and_return(ret, ...)                                                                                 \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if (!is_error())                                                                                               \
-			set_error(__VA_ARGS__);                                                                                    \
-		return_after_error(ret);                                                                                       \
-	}                                                                                                                  \
-	while (false)
-
-#define set_error_and_return_default(...) set_error_and_return({}, __VA_ARGS__)
-
-#define set_error_and_return_if_eof(...)                                                                               \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		if TOML_UNLIKELY(is_eof())                                                                                     \
-			set_error_and_return(__VA_ARGS__, "encountered end-of-file"sv);                                            \
-	}                                                                                                                  \
-	while (false)
-
-#define advance_and_return_if_error(...)                                                                               \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		assert_not_eof();                                                                                              \
-		advance();                                                                                                     \
-		return_if_error(__VA_ARGS__);                                                                                  \
-	}                                                                                                                  \
-	while (false)
-
-#define advance_and_return_if_error_or_eof(...)                                                                        \
-	do                                                                                                                 \
-	{                                                                                                                  \
-		assert_not_eof();                                                                                              \
-		advance();                                                                                                     \
-		return_if_error(__VA_ARGS__);                                                                                  \
-		set_error_and_return_if_eof(__VA_ARGS__);                                                                      \
-	}                                                                                                                  \
-	while (false)
-
-#endif // parser helper macros
-
-TOML_IMPL_NAMESPACE_START
-{
-	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, impl_ex, impl_noex);
-
-	class parser
+	template <typename T>
+	class TOML_EMPTY_BASES utf8_reader final : public utf8_reader_interface
 	{
 	  private:
-		static constexpr size_t max_nested_values	  = TOML_MAX_NESTED_VALUES;
-		static constexpr size_t max_dotted_keys_depth = TOML_MAX_DOTTED_KEYS_DEPTH;
-
-		utf8_buffered_reader reader;
-		table root;
-		source_position prev_pos = { 1, 1 };
-		const utf8_codepoint* cp = {};
-		std::vector<table*> implicit_tables;
-		std::vector<table*> dotted_key_tables;
-		std::vector<table*> open_inline_tables;
-		std::vector<array*> table_arrays;
-		parse_key_buffer key_buffer;
-		std::string string_buffer;
-		std::string recording_buffer; // for diagnostics
-		bool recording = false, recording_whitespace = true;
-		std::string_view current_scope;
-		size_t nested_values = {};
-#if !TOML_EXCEPTIONS
-		mutable optional<parse_error> err;
-#endif
+		static constexpr size_t block_capacity = 32;
+		utf8_byte_stream<T> stream_;
+		source_position next_pos_ = { 1, 1 };
 
-		TOML_NODISCARD
-		source_position current_position(source_index fallback_offset = 0) const noexcept
+		impl::utf8_decoder decoder_;
+		struct currently_decoding_t
 		{
-			if (!is_eof())
-				return cp->position;
-			return { prev_pos.line, static_cast<source_index>(prev_pos.column + fallback_offset) };
-		}
+			char bytes[4];
+			size_t count;
+		} currently_decoding_;
 
-		template <typename... T>
-		TOML_RETURNS_BY_THROWING
-		TOML_NEVER_INLINE
-		void set_error_at(source_position pos, const T&... reason) const
+		struct codepoints_t
 		{
-			static_assert(sizeof...(T) > 0);
-			return_if_error();
-
-			error_builder builder{ current_scope };
-			(builder.append(reason), ...);
+			TOML_OVERALIGNED utf8_codepoint buffer[block_capacity];
+			size_t current;
+			size_t count;
+		} codepoints_;
 
-			parse_error_break();
+		source_path_ptr source_path_;
 
-#if TOML_EXCEPTIONS
-			builder.finish(pos, reader.source_path());
-#else
-			err.emplace(builder.finish(pos, reader.source_path()));
+#if !TOML_EXCEPTIONS
+		optional<parse_error> err_;
 #endif
-		}
-
-		template <typename... T>
-		TOML_RETURNS_BY_THROWING
-		void set_error(const T&... reason) const
-		{
-			set_error_at(current_position(1), reason...);
-		}
-
-		void go_back(size_t count = 1) noexcept
-		{
-			return_if_error();
-			TOML_ASSERT_ASSUME(count);
-
-			cp		 = reader.step_back(count);
-			prev_pos = cp->position;
-		}
 
-		void advance()
+		bool read_next_block() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
 		{
-			return_if_error();
-			assert_not_eof();
+			TOML_ASSERT(stream_);
 
-			prev_pos = cp->position;
-			cp		 = reader.read_next();
+			TOML_OVERALIGNED char raw_bytes[block_capacity];
+			size_t raw_bytes_read;
 
-#if !TOML_EXCEPTIONS
-			if (reader.error())
+			// read the next raw (encoded) block in from the stream
+			if constexpr (noexcept(stream_(raw_bytes, block_capacity)) || !TOML_EXCEPTIONS)
 			{
-				err = std::move(reader.error());
-				return;
+				raw_bytes_read = stream_(raw_bytes, block_capacity);
 			}
-#endif
-
-			if (recording && !is_eof())
+#if TOML_EXCEPTIONS
+			else
 			{
-				if (recording_whitespace || !is_whitespace(*cp))
-					recording_buffer.append(cp->bytes, cp->count);
+				try
+				{
+					raw_bytes_read = stream_(raw_bytes, block_capacity);
+				}
+				catch (const std::exception& exc)
+				{
+					throw parse_error{ exc.what(), next_pos_, source_path_ };
+				}
+				catch (...)
+				{
+					throw parse_error{ "An unspecified error occurred", next_pos_, source_path_ };
+				}
 			}
-		}
-
-		void start_recording(bool include_current = true) noexcept
-		{
-			return_if_error();
-
-			recording			 = true;
-			recording_whitespace = true;
-			recording_buffer.clear();
-			if (include_current && !is_eof())
-				recording_buffer.append(cp->bytes, cp->count);
-		}
-
-		void stop_recording(size_t pop_bytes = 0) noexcept
-		{
-			return_if_error();
+#endif // TOML_EXCEPTIONS
 
-			recording = false;
-			if (pop_bytes)
+			// handle a zero-byte read
+			if TOML_UNLIKELY(!raw_bytes_read)
 			{
-				if (pop_bytes >= recording_buffer.length())
-					recording_buffer.clear();
-				else if (pop_bytes == 1u)
-					recording_buffer.pop_back();
+				if (stream_.eof())
+				{
+					// EOF only sets the error state if the decoder wants more input, otherwise
+					// a zero-byte read might have just caused the underlying stream to realize it's exhaused and set
+					// the EOF flag, and that's totally fine
+					if (decoder_.needs_more_input())
+						utf8_reader_error("Encountered EOF during incomplete utf-8 code point sequence",
+										  next_pos_,
+										  source_path_);
+				}
 				else
-					recording_buffer.erase(recording_buffer.begin()
-											   + static_cast<ptrdiff_t>(recording_buffer.length() - pop_bytes),
-										   recording_buffer.end());
+				{
+					utf8_reader_error("Reading from the underlying stream failed - zero bytes read",
+									  next_pos_,
+									  source_path_);
+				}
+				return false;
 			}
-		}
 
-		bool consume_leading_whitespace()
-		{
-			return_if_error_or_eof({});
+			TOML_ASSERT_ASSUME(raw_bytes_read);
+			std::memset(&codepoints_, 0, sizeof(codepoints_));
 
-			bool consumed = false;
-			while (!is_eof() && is_horizontal_whitespace(*cp))
+			// helper for calculating decoded codepoint line+cols
+			const auto calc_positions = [&]() noexcept
 			{
-				if TOML_UNLIKELY(!is_ascii_horizontal_whitespace(*cp))
-					set_error_and_return_default("expected space or tab, saw '"sv, escaped_codepoint{ *cp }, "'"sv);
-
-				consumed = true;
-				advance_and_return_if_error({});
-			}
-			return consumed;
-		}
-
-		bool consume_line_break()
-		{
-			return_if_error_or_eof({});
+				for (size_t i = 0; i < codepoints_.count; i++)
+				{
+					auto& cp	= codepoints_.buffer[i];
+					cp.position = next_pos_;
 
-			if TOML_UNLIKELY(is_match(*cp, U'\v', U'\f'))
-				set_error_and_return_default(
-					R"(vertical tabs '\v' and form-feeds '\f' are not legal line breaks in TOML)"sv);
+					if (cp == U'\n')
+					{
+						next_pos_.line++;
+						next_pos_.column = source_index{ 1 };
+					}
+					else
+						next_pos_.column++;
+				}
+			};
 
-			if (*cp == U'\r')
-			{
-				advance_and_return_if_error({}); // skip \r
+			// decide whether we need to use the UTF-8 decoder or if we can treat this block as plain ASCII
+			const auto ascii_fast_path = !decoder_.needs_more_input() && impl::is_ascii(raw_bytes, raw_bytes_read);
 
-				if TOML_UNLIKELY(is_eof())
-					set_error_and_return_default("expected '\\n' after '\\r', saw EOF"sv);
+			// ASCII fast-path
+			if (ascii_fast_path)
+			{
+				decoder_.reset();
+				currently_decoding_.count = {};
 
-				if TOML_UNLIKELY(*cp != U'\n')
-					set_error_and_return_default("expected '\\n' after '\\r', saw '"sv,
-												 escaped_codepoint{ *cp },
-												 "'"sv);
+				codepoints_.count = raw_bytes_read;
+				for (size_t i = 0; i < codepoints_.count; i++)
+				{
+					auto& cp	= codepoints_.buffer[i];
+					cp.value	= static_cast<char32_t>(raw_bytes[i]);
+					cp.bytes[0] = raw_bytes[i];
+					cp.count	= 1u;
+				}
 			}
-			else if (*cp != U'\n')
-				return false;
-
-			advance_and_return_if_error({}); // skip \n
-			return true;
-		}
-
-		bool consume_rest_of_line()
-		{
-			return_if_error_or_eof({});
 
-			do
+			// UTF-8 slow-path
+			else
 			{
-				if (is_ascii_vertical_whitespace(*cp))
-					return consume_line_break();
-				else
-					advance();
-				return_if_error({});
-			}
-			while (!is_eof());
-
-			return true;
-		}
-
-		bool consume_comment()
-		{
-			return_if_error_or_eof({});
-
-			if (*cp != U'#')
-				return false;
+				// helper for getting precise error location
+				const auto error_pos = [&]() noexcept -> const source_position&
+				{ //
+					return codepoints_.count ? codepoints_.buffer[codepoints_.count - 1u].position : next_pos_;
+				};
 
-			push_parse_scope("comment"sv);
+				// validate the block in bulk first; the complete sequences at the front of it (usually all of it)
+				// can then be decoded directly, leaving only the tail of the block for the state machine
+				size_t i = 0;
+				if (!decoder_.needs_more_input())
+				{
+					const auto valid_end = impl::simd().find_invalid_utf8(raw_bytes, raw_bytes + raw_bytes_read);
+					while (raw_bytes + i < valid_end)
+					{
+						auto& cp = codepoints_.buffer[codepoints_.count++];
+						decode_validated_utf8(cp, raw_bytes + i);
+						i += cp.count;
+					}
+				}
 
-			advance_and_return_if_error({}); // skip the '#'
+				for (; i < raw_bytes_read; i++)
+				{
+					decoder_(static_cast<uint8_t>(raw_bytes[i]));
+					if TOML_UNLIKELY(decoder_.error())
+					{
+						calc_positions();
+						utf8_reader_error("Encountered invalid utf-8 sequence", error_pos(), source_path_);
+						utf8_reader_return_after_error(false);
+					}
 
-			while (!is_eof())
-			{
-				if (consume_line_break())
-					return true;
-				return_if_error({});
+					currently_decoding_.bytes[currently_decoding_.count++] = raw_bytes[i];
 
-#if TOML_LANG_AT_LEAST(1, 0, 0)
+					if (decoder_.has_code_point())
+					{
+						auto& cp = codepoints_.buffer[codepoints_.count++];
 
-				// toml/issues/567 (disallow non-TAB control characters in comments)
-				if TOML_UNLIKELY(is_nontab_control_character(*cp))
-					set_error_and_return_default(
-						"control characters other than TAB (U+0009) are explicitly prohibited in comments"sv);
+						cp.value = decoder_.codepoint;
+						cp.count = currently_decoding_.count;
+						std::memcpy(cp.bytes, currently_decoding_.bytes, currently_decoding_.count);
+						currently_decoding_.count = {};
+					}
+					else if TOML_UNLIKELY(currently_decoding_.count == 4u)
+					{
+						calc_positions();
+						utf8_reader_error("Encountered overlong utf-8 sequence", error_pos(), source_path_);
+						utf8_reader_return_after_error(false);
+					}
+				}
+				if TOML_UNLIKELY(decoder_.needs_more_input() && stream_.eof())
+				{
+					calc_positions();
+					utf8_reader_error("Encountered EOF during incomplete utf-8 code point sequence",
+									  error_pos(),
+									  source_path_);
+					utf8_reader_return_after_error(false);
+				}
+			}
 
-				// toml/pull/720 (disallow surrogates in comments)
-				else if TOML_UNLIKELY(is_unicode_surrogate(*cp))
-					set_error_and_return_default(
-						"unicode surrogates (U+D800 to U+DFFF) are explicitly prohibited in comments"sv);
-#endif
+			TOML_ASSERT_ASSUME(codepoints_.count);
+			calc_positions();
 
-				advance_and_return_if_error({});
+			// handle general I/O errors
+			// (down here so the next_pos_ benefits from calc_positions())
+			if TOML_UNLIKELY(stream_.error())
+			{
+				utf8_reader_error("An I/O error occurred while reading from the underlying stream",
+								  next_pos_,
+								  source_path_);
+				utf8_reader_return_after_error(false);
 			}
 
 			return true;
 		}
 
-		TOML_NODISCARD
-		bool consume_expected_sequence(std::u32string_view seq)
+	  public:
+		template <typename U, typename String = std::string_view>
+		TOML_NODISCARD_CTOR
+		explicit utf8_reader(U&& source, String&& source_path = {}) noexcept(
+			std::is_nothrow_constructible_v<utf8_byte_stream<T>, U&&>)
+			: stream_{ static_cast<U&&>(source) }
 		{
-			return_if_error({});
-			TOML_ASSERT(!seq.empty());
+			currently_decoding_.count = {};
 
-			for (auto c : seq)
-			{
-				set_error_and_return_if_eof({});
-				if (*cp != c)
-					return false;
-				advance_and_return_if_error({});
-			}
-			return true;
+			codepoints_.current = {};
+			codepoints_.count	= {};
+
+			if (!source_path.empty())
+				source_path_ = source_path_ptr{ static_cast<String&&>(source_path) };
 		}
 
-		template <typename T>
-		TOML_NODISCARD
-		bool consume_digit_sequence(T* digits, size_t len)
+		TOML_PURE_INLINE_GETTER
+		const source_path_ptr& source_path() const noexcept final
 		{
-			return_if_error({});
-			TOML_ASSERT_ASSUME(digits);
-			TOML_ASSERT_ASSUME(len);
-
-			for (size_t i = 0; i < len; i++)
-			{
-				set_error_and_return_if_eof({});
-				if (!is_decimal_digit(*cp))
-					return false;
-
-				digits[i] = static_cast<T>(*cp - U'0');
-				advance_and_return_if_error({});
-			}
-			return true;
+			return source_path_;
 		}
 
-		template <typename T>
 		TOML_NODISCARD
-		size_t consume_variable_length_digit_sequence(T* buffer, size_t max_len)
+		const utf8_codepoint* read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) final
 		{
-			return_if_error({});
-			TOML_ASSERT_ASSUME(buffer);
-			TOML_ASSERT_ASSUME(max_len);
+			utf8_reader_error_check({});
 
-			size_t i = {};
-			for (; i < max_len; i++)
+			if (codepoints_.current == codepoints_.count)
 			{
-				if (is_eof() || !is_decimal_digit(*cp))
-					break;
+				if TOML_UNLIKELY(!stream_ || !read_next_block())
+					return nullptr;
 
-				buffer[i] = static_cast<T>(*cp - U'0');
-				advance_and_return_if_error({});
+				TOML_ASSERT_ASSUME(!codepoints_.current);
 			}
-			return i;
+			TOML_ASSERT_ASSUME(codepoints_.count);
+			TOML_ASSERT_ASSUME(codepoints_.count <= block_capacity);
+			TOML_ASSERT_ASSUME(codepoints_.current < codepoints_.count);
+
+			return &codepoints_.buffer[codepoints_.current++];
 		}
 
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		std::string_view parse_basic_string(bool multi_line)
+		bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS) final
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(*cp == U'"');
-			push_parse_scope("string"sv);
+			return stream_.peek_eof();
+		}
 
-			// skip the '"'
-			advance_and_return_if_error_or_eof({});
+		TOML_NODISCARD
+		std::string_view contiguous() const noexcept final
+		{
+			return stream_.contiguous();
+		}
 
-			// multi-line strings ignore a single line ending right at the beginning
-			if (multi_line)
-			{
-				consume_line_break();
-				return_if_error({});
-				set_error_and_return_if_eof({});
-			}
+#if !TOML_EXCEPTIONS
 
-			auto& str = string_buffer;
-			str.clear();
-			bool escaped			 = false;
-			bool skipping_whitespace = false;
-			do
-			{
-				if (escaped)
-				{
-					escaped = false;
+		TOML_NODISCARD
+		optional<parse_error>&& error() noexcept final
+		{
+			return std::move(err_);
+		}
 
-					// handle 'line ending slashes' in multi-line mode
-					if (multi_line && is_whitespace(*cp))
-					{
-						consume_leading_whitespace();
+#endif
+	};
 
-						if TOML_UNLIKELY(!consume_line_break())
-							set_error_and_return_default(
-								"line-ending backslashes must be the last non-whitespace character on the line"sv);
+	template <typename Char>
+	utf8_reader(std::basic_string_view<Char>, std::string_view) -> utf8_reader<std::basic_string_view<Char>>;
+	template <typename Char>
+	utf8_reader(std::basic_string_view<Char>, std::string&&) -> utf8_reader<std::basic_string_view<Char>>;
+	template <typename Char>
+	utf8_reader(std::basic_istream<Char>&, std::string_view) -> utf8_reader<std::basic_istream<Char>>;
+	template <typename Char>
+	utf8_reader(std::basic_istream<Char>&, std::string&&) -> utf8_reader<std::basic_istream<Char>>;
 
-						skipping_whitespace = true;
-						return_if_error({});
-						continue;
-					}
-
-					bool skip_escaped_codepoint = true;
-					assert_not_eof();
-					switch (const auto escaped_codepoint = *cp)
-					{
-						// 'regular' escape codes
-						case U'b': str += '\b'; break;
-						case U'f': str += '\f'; break;
-						case U'n': str += '\n'; break;
-						case U'r': str += '\r'; break;
-						case U't': str += '\t'; break;
-						case U'"': str += '"'; break;
-						case U'\\': str += '\\'; break;
-
-#if TOML_LANG_UNRELEASED // toml/pull/790 (\e shorthand for \x1B)
-						case U'e': str += '\x1B'; break;
+#if TOML_EXCEPTIONS
+#define utf8_buffered_reader_error_check(...) static_assert(true)
 #else
-						case U'e':
-							set_error_and_return_default(
-								"escape sequence '\\e' is not supported in TOML 1.0.0 and earlier"sv);
-#endif
+#define utf8_buffered_reader_error_check(...)                                                                          \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if TOML_UNLIKELY(error())                                                                                      \
+			return __VA_ARGS__;                                                                                        \
+	}                                                                                                                  \
+	while (false)
 
-#if TOML_LANG_UNRELEASED // toml/pull/796 (\xHH unicode scalar sequences)
-						case U'x': [[fallthrough]];
-#else
-						case U'x':
-							set_error_and_return_default(
-								"escape sequence '\\x' is not supported in TOML 1.0.0 and earlier"sv);
 #endif
 
-						// unicode scalar sequences
-						case U'u': [[fallthrough]];
-						case U'U':
-						{
-							push_parse_scope("unicode scalar sequence"sv);
-							advance_and_return_if_error_or_eof({});
-							skip_escaped_codepoint = false;
-
-							uint32_t place_value =
-								escaped_codepoint == U'U' ? 0x10000000u : (escaped_codepoint == U'u' ? 0x1000u : 0x10u);
-							uint32_t sequence_value{};
-							while (place_value)
-							{
-								set_error_and_return_if_eof({});
-
-								if TOML_UNLIKELY(!is_hexadecimal_digit(*cp))
-									set_error_and_return_default("expected hex digit, saw '"sv, to_sv(*cp), "'"sv);
+	class TOML_EMPTY_BASES utf8_buffered_reader
+	{
+	  public:
+		static constexpr size_t max_history_length = 128;
 
-								sequence_value += place_value * hex_to_dec(*cp);
-								place_value /= 16u;
-								advance_and_return_if_error({});
-							}
+	  private:
+		static constexpr size_t history_buffer_size = max_history_length - 1; //'head' is stored in the reader
+		static constexpr size_t block_capacity		= 32;					  // must match utf8_reader
+		utf8_reader_interface& reader_;
+		struct
+		{
+			utf8_codepoint buffer[history_buffer_size];
+			size_t count, first;
+		} history_					= {};
+		const utf8_codepoint* head_ = {};
+		size_t negative_offset_		= {};
 
-							if TOML_UNLIKELY(is_unicode_surrogate(sequence_value))
-								set_error_and_return_default(
-									"unicode surrogates (U+D800 - U+DFFF) are explicitly prohibited"sv);
-							else if TOML_UNLIKELY(sequence_value > 0x10FFFFu)
-								set_error_and_return_default("values greater than U+10FFFF are invalid"sv);
+		// contiguous inputs skip the reader and the history buffer entirely; codepoints are decoded in-place
+		// straight out of the source buffer, and stepping back just moves the read pointer.
+		//
+		// validation still happens in blocks of the same size (and from the same offsets) as utf8_reader
+		// so encoding errors are reported in exactly the same way they would be for a stream.
+		struct
+		{
+			const char* begin;
+			const char* end;
+			const char* pos;		  // first byte of the head codepoint (end at EOF)
+			const char* block_end;	  // end of the last validated block
+			const char* complete_end; // end of the last complete codepoint in the validated blocks
+			const char* valid_end;	  // end of the leading span that was validated in bulk up-front
+			source_position position; // position of the head codepoint (one-past-the-end at EOF)
+			impl::utf8_decoder decoder;
+			utf8_codepoint heads[4]; // callers may hold on to the previous codepoint for a little while
+			size_t next_head;
+			size_t block_phase;			   // how far into one of the document's blocks `begin` is (see restart())
+			source_position lead_position; // position of the codepoint before `begin` (if block_phase isn't zero)
+		} direct_ = {};
+		bool is_direct_;
 
-							if (sequence_value < 0x80)
-							{
-								str += static_cast<char>(sequence_value);
-							}
-							else if (sequence_value < 0x800u)
-							{
-								str += static_cast<char>((sequence_value >> 6) | 0xC0u);
-								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
-							}
-							else if (sequence_value < 0x10000u)
-							{
-								str += static_cast<char>((sequence_value >> 12) | 0xE0u);
-								str += static_cast<char>(((sequence_value >> 6) & 0x3Fu) | 0x80u);
-								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
-							}
-							else if (sequence_value < 0x110000u)
-							{
-								str += static_cast<char>((sequence_value >> 18) | 0xF0u);
-								str += static_cast<char>(((sequence_value >> 12) & 0x3Fu) | 0x80u);
-								str += static_cast<char>(((sequence_value >> 6) & 0x3Fu) | 0x80u);
-								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
-							}
-							break;
-						}
+#if !TOML_EXCEPTIONS
+		optional<parse_error> err_;
+#endif
 
-							// ???
-							TOML_UNLIKELY_CASE
-						default: set_error_and_return_default("unknown escape sequence '\\"sv, to_sv(*cp), "'"sv);
-					}
+		TOML_NODISCARD
+		source_position direct_position_of(const char* target) const noexcept
+		{
+			TOML_ASSERT_ASSUME(target >= direct_.pos);
 
-					if (skip_escaped_codepoint)
-						advance_and_return_if_error_or_eof({});
-				}
-				else
+			auto pos = direct_.position;
+			for (auto c = direct_.pos; c < target; c++)
+			{
+				if (*c == '\n')
 				{
-					// handle closing delimiters
-					if (*cp == U'"')
-					{
-						if (multi_line)
-						{
-							size_t lookaheads			  = {};
-							size_t consecutive_delimiters = 1;
-							do
-							{
-								advance_and_return_if_error({});
-								lookaheads++;
-								if (!is_eof() && *cp == U'"')
-									consecutive_delimiters++;
-								else
-									break;
-							}
-							while (lookaheads < 4u);
-
-							switch (consecutive_delimiters)
-							{
-								// """ " (one quote somewhere in a ML string)
-								case 1:
-									str += '"';
-									skipping_whitespace = false;
-									continue;
-
-								// """ "" (two quotes somewhere in a ML string)
-								case 2:
-									str.append("\"\""sv);
-									skipping_whitespace = false;
-									continue;
-
-								// """ """ (the end of the string)
-								case 3: return str;
+					pos.line++;
+					pos.column = source_index{ 1 };
+				}
+				else if ((static_cast<unsigned char>(*c) & 0xC0u) != 0x80u)
+					pos.column++;
+			}
+			return pos;
+		}
 
-								// """ """" (one at the end of the string)
-								case 4: str += '"'; return str;
+		TOML_NEVER_INLINE
+		bool direct_validate_next_block() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			auto& d = direct_;
+			TOML_ASSERT_ASSUME(d.block_end < d.end);
 
-								// """ """"" (two quotes at the end of the string)
-								case 5:
-									str.append("\"\""sv);
-									advance_and_return_if_error({}); // skip the last '"'
-									return str;
+			// the input is almost always entirely valid, in which case there's nothing left to do
+			if TOML_LIKELY(d.valid_end == d.end)
+			{
+				d.block_end	   = d.end;
+				d.complete_end = d.end;
+				return true;
+			}
 
-								default: TOML_UNREACHABLE;
-							}
-						}
-						else
-						{
-							advance_and_return_if_error({}); // skip the closing delimiter
-							return str;
-						}
-					}
+			// otherwise the blocks before the one containing the first error can be skipped over, as long as the
+			// decoder is left in the same state it would have been in had they been validated one at a time
+			const auto valid_block = (static_cast<size_t>(d.valid_end - d.begin) + d.block_phase) / block_capacity;
+			if (valid_block * block_capacity > d.block_phase
+				&& d.begin + (valid_block * block_capacity - d.block_phase) > d.block_end)
+			{
+				d.block_end = d.begin + (valid_block * block_capacity - d.block_phase);
 
-					// handle escapes
-					else if (*cp == U'\\')
-					{
-						advance_and_return_if_error_or_eof({}); // skip the '\'
-						skipping_whitespace = false;
-						escaped				= true;
-						continue;
-					}
+				auto seq = d.block_end;
+				while (seq > d.begin && (static_cast<unsigned char>(seq[-1]) & 0xC0u) == 0x80u)
+					seq--;
+				if (seq > d.begin && static_cast<unsigned char>(seq[-1]) >= 0xC0u)
+					seq--;
 
-					// handle line endings in multi-line mode
-					if (multi_line && is_ascii_vertical_whitespace(*cp))
-					{
-						consume_line_break();
-						return_if_error({});
-						if (!skipping_whitespace)
-							str += '\n';
-						continue;
-					}
+				d.complete_end = seq;
+				d.decoder.reset();
+				for (; seq < d.block_end; seq++)
+				{
+					d.decoder(*seq);
+					if (d.decoder.has_code_point())
+						d.complete_end = seq + 1;
+				}
+				return true;
+			}
 
-					// handle control characters
-					if TOML_UNLIKELY(is_nontab_control_character(*cp))
-						set_error_and_return_default(
-							"unescaped control characters other than TAB (U+0009) are explicitly prohibited"sv);
+			// (the first block is cut short if the input began part-way through one)
+			const auto block_begin = d.block_end;
+			const auto block_size  = block_begin == d.begin ? block_capacity - d.block_phase : block_capacity;
+			d.block_end			   = block_begin + impl::min(block_size, static_cast<size_t>(d.end - block_begin));
 
-#if TOML_LANG_AT_LEAST(1, 0, 0)
+			if (!d.decoder.needs_more_input()
+				&& impl::is_ascii(block_begin, static_cast<size_t>(d.block_end - block_begin)))
+			{
+				d.complete_end = d.block_end;
+				return true;
+			}
 
-					// handle surrogates in strings
-					if TOML_UNLIKELY(is_unicode_surrogate(*cp))
-						set_error_and_return_default(
-							"unescaped unicode surrogates (U+D800 to U+DFFF) are explicitly prohibited"sv);
-#endif
+			// mirrors the error locations of utf8_reader::read_next_block()
+			const char* last_complete = {};
+			const auto error_pos	  = [&]() noexcept
+			{
+				if (!last_complete && block_begin == d.begin && d.block_phase)
+					return d.lead_position; // (the block's last complete codepoint came before the input)
+				return direct_position_of(last_complete ? last_complete : d.complete_end);
+			};
 
-					if (multi_line)
-					{
-						if (!skipping_whitespace || !is_horizontal_whitespace(*cp))
-						{
-							skipping_whitespace = false;
-							str.append(cp->bytes, cp->count);
-						}
-					}
-					else
-						str.append(cp->bytes, cp->count);
+			for (auto c = block_begin; c < d.block_end; c++)
+			{
+				d.decoder(*c);
+				if TOML_UNLIKELY(d.decoder.error())
+				{
+					utf8_reader_error("Encountered invalid utf-8 sequence", error_pos(), reader_.source_path());
+					utf8_reader_return_after_error(false);
+				}
 
-					advance_and_return_if_error({});
+				if (d.decoder.has_code_point())
+				{
+					last_complete  = d.complete_end;
+					d.complete_end = c + 1;
 				}
 			}
-			while (!is_eof());
 
-			set_error_and_return_default("encountered end-of-file"sv);
+			if TOML_UNLIKELY(d.decoder.needs_more_input() && d.block_end == d.end)
+			{
+				utf8_reader_error("Encountered EOF during incomplete utf-8 code point sequence",
+								  error_pos(),
+								  reader_.source_path());
+				utf8_reader_return_after_error(false);
+			}
+
+			return true;
 		}
 
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		std::string_view parse_literal_string(bool multi_line)
+		const utf8_codepoint* direct_decode() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(*cp == U'\'');
-			push_parse_scope("literal string"sv);
+			auto& d = direct_;
 
-			// skip the delimiter
-			advance_and_return_if_error_or_eof({});
+			if (d.pos == d.end)
+				return head_ = nullptr;
 
-			// multi-line strings ignore a single line ending right at the beginning
-			if (multi_line)
+			while (d.pos >= d.complete_end)
 			{
-				consume_line_break();
-				return_if_error({});
-				set_error_and_return_if_eof({});
+				if TOML_UNLIKELY(!direct_validate_next_block())
+					return head_ = nullptr;
 			}
 
-			auto& str = string_buffer;
-			str.clear();
-			do
-			{
-				return_if_error({});
+			auto& cp	= d.heads[d.next_head++ % 4u];
+			cp.position = d.position;
+			decode_validated_utf8(cp, d.pos);
 
-				// handle closing delimiters
-				if (*cp == U'\'')
-				{
-					if (multi_line)
-					{
-						size_t lookaheads			  = {};
-						size_t consecutive_delimiters = 1;
-						do
-						{
-							advance_and_return_if_error({});
-							lookaheads++;
-							if (!is_eof() && *cp == U'\'')
-								consecutive_delimiters++;
-							else
-								break;
-						}
-						while (lookaheads < 4u);
+			return head_ = &cp;
+		}
 
-						switch (consecutive_delimiters)
-						{
-							// ''' ' (one quote somewhere in a ML string)
-							case 1: str += '\''; continue;
+		TOML_NODISCARD
+		TOML_ALWAYS_INLINE
+		const utf8_codepoint* direct_read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			auto& d = direct_;
 
-							// ''' '' (two quotes somewhere in a ML string)
-							case 2: str.append("''"sv); continue;
+			if (head_)
+			{
+				d.pos += head_->count;
+				if (head_->value == U'\n')
+				{
+					d.position.line++;
+					d.position.column = source_index{ 1 };
+				}
+				else
+					d.position.column++;
+			}
+			else if (d.pos == d.end)
+				return nullptr;
 
-							// ''' ''' (the end of the string)
-							case 3: return str;
+			return direct_decode();
+		}
 
-							// ''' '''' (one at the end of the string)
-							case 4: str += '\''; return str;
+		TOML_NODISCARD
+		const utf8_codepoint* direct_step_back(size_t count) noexcept
+		{
+			auto& d = direct_;
 
-							// ''' ''''' (two quotes at the end of the string)
-							case 5:
-								str.append("''"sv);
-								advance_and_return_if_error({}); // skip the last '
-								return str;
+			for (; count; count--)
+			{
+				TOML_ASSERT_ASSUME(d.pos > d.begin);
 
-							default: TOML_UNREACHABLE;
-						}
-					}
-					else
-					{
-						advance_and_return_if_error({}); // skip the closing delimiter
-						return str;
-					}
-				}
+				do
+					d.pos--;
+				while ((static_cast<unsigned char>(*d.pos) & 0xC0u) == 0x80u);
 
-				// handle line endings in multi-line mode
-				if (multi_line && is_ascii_vertical_whitespace(*cp))
+				if (*d.pos != '\n')
 				{
-					consume_line_break();
-					return_if_error({});
-					str += '\n';
+					d.position.column--;
 					continue;
 				}
 
-				// handle control characters
-				if TOML_UNLIKELY(is_nontab_control_character(*cp))
-					set_error_and_return_default(
-						"control characters other than TAB (U+0009) are explicitly prohibited"sv);
-
-#if TOML_LANG_AT_LEAST(1, 0, 0)
-
-				// handle surrogates in strings
-				if TOML_UNLIKELY(is_unicode_surrogate(*cp))
-					set_error_and_return_default("unicode surrogates (U+D800 - U+DFFF) are explicitly prohibited"sv);
-#endif
-
-				str.append(cp->bytes, cp->count);
-				advance_and_return_if_error({});
+				// stepped back over a line break; the column has to be recounted from the start of the line
+				d.position.line--;
+				d.position.column = source_index{ 1 };
+				for (auto c = d.pos; c > d.begin && c[-1] != '\n'; c--)
+				{
+					if ((static_cast<unsigned char>(c[-1]) & 0xC0u) != 0x80u)
+						d.position.column++;
+				}
 			}
-			while (!is_eof());
 
-			set_error_and_return_default("encountered end-of-file"sv);
+			// everything behind the read pointer has already been validated, so this can't fail
+			return direct_decode();
 		}
 
 		TOML_NODISCARD
 		TOML_NEVER_INLINE
-		parsed_string parse_string()
+		const utf8_codepoint* buffered_read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_string_delimiter(*cp));
-			push_parse_scope("string"sv);
-
-			// snapshot length so the recording buffer can be rewound alongside go_back(2u) below
-			const auto recording_buffer_rollback_size = recording_buffer.length();
+			if (negative_offset_)
+			{
+				negative_offset_--;
 
-			// get the first three characters to determine the string type
-			const auto first = cp->value;
-			advance_and_return_if_error_or_eof({});
-			const auto second = cp->value;
-			advance_and_return_if_error({});
-			const auto third = cp ? cp->value : U'\0';
+				// an entry negative offset of 1 just means "replay the current head"
+				if (!negative_offset_)
+					return head_;
 
-			// if we were eof at the third character then first and second need to be
-			// the same string character (otherwise it's an unterminated string)
-			if (is_eof())
+				// otherwise step back into the history buffer
+				else
+					return history_.buffer
+						 + ((history_.first + history_.count - negative_offset_) % history_buffer_size);
+			}
+			else
 			{
-				if (second == first)
-					return {};
+				// first character read from stream
+				if TOML_UNLIKELY(!history_.count && !head_)
+					head_ = reader_.read_next();
 
-				set_error_and_return_default("encountered end-of-file"sv);
+				// subsequent characters and not eof
+				else if (head_)
+				{
+					if TOML_UNLIKELY(history_.count < history_buffer_size)
+						history_.buffer[history_.count++] = *head_;
+					else
+						history_.buffer[(history_.first++ + history_buffer_size) % history_buffer_size] = *head_;
+
+					head_ = reader_.read_next();
+				}
+
+				return head_;
 			}
+		}
 
-			// if the first three characters are all the same string delimiter then
-			// it's a multi-line string.
-			else if (first == second && first == third)
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit utf8_buffered_reader(utf8_reader_interface& reader) noexcept //
+			: reader_{ reader }
+		{
+			const auto source = reader_.contiguous();
+			is_direct_		  = !source.empty();
+			if (is_direct_)
 			{
-				return { first == U'\'' ? parse_literal_string(true) : parse_basic_string(true), true };
+				direct_.begin		 = source.data();
+				direct_.end			 = source.data() + source.length();
+				direct_.pos			 = direct_.begin;
+				direct_.block_end	 = direct_.begin;
+				direct_.complete_end = direct_.begin;
+				direct_.valid_end	 = impl::simd().find_invalid_utf8(direct_.begin, direct_.end);
+				direct_.position	 = { 1, 1 };
 			}
+		}
 
-			// otherwise it's just a regular string.
-			else
+		// starts reading the (new) contents of a contiguous source from the beginning, carrying on from the position
+		// the previous contents ended at. used by the incremental parser to move on to the next batch of lines.
+		//
+		// the blocks it's validated in stay aligned with the ones the whole document would have been validated in,
+		// so encoding errors are reported at the same positions as they would be if it had been read all at once.
+		void restart() noexcept
+		{
+			if (!is_direct_)
 			{
-				// step back two characters so that the current
-				// character is the string delimiter
-				go_back(2u);
-				if (recording)
-					recording_buffer.resize(recording_buffer_rollback_size);
-
-				return { first == U'\'' ? parse_literal_string(false) : parse_basic_string(false), false };
+				restart(source_position{ 1, 1 });
+				return;
 			}
+
+			// (the previous contents are gone by now, so only the pointers themselves and the codepoints that were
+			// copied out of them can be used)
+			const auto length = static_cast<size_t>(direct_.end - direct_.begin);
+			const auto phase  = (direct_.block_phase + length) % block_capacity;
+			const auto lead	  = direct_.heads[(direct_.next_head + 3u) % 4u].position;
+			restart(direct_.position);
+			direct_.block_phase	  = phase;
+			direct_.lead_position = lead;
 		}
 
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		std::string_view parse_bare_key_segment()
+		// as above, but starting from a specific position (and with blocks aligned to the start of the contents).
+		// used by lazy documents to parse values in isolation.
+		void restart(source_position position) noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_bare_key_character(*cp));
+			const auto source = reader_.contiguous();
+			TOML_ASSERT_ASSUME(!source.empty());
 
-			string_buffer.clear();
+			direct_				 = {};
+			direct_.begin		 = source.data();
+			direct_.end			 = source.data() + source.length();
+			direct_.pos			 = direct_.begin;
+			direct_.block_end	 = direct_.begin;
+			direct_.complete_end = direct_.begin;
+			direct_.valid_end	 = impl::simd().find_invalid_utf8(direct_.begin, direct_.end);
+			direct_.position	 = position;
+			is_direct_			 = true;
+			head_				 = nullptr;
+		}
 
-			while (!is_eof())
-			{
-				if (!is_bare_key_character(*cp))
-					break;
+		TOML_PURE_INLINE_GETTER
+		const source_path_ptr& source_path() const noexcept
+		{
+			return reader_.source_path();
+		}
 
-				string_buffer.append(cp->bytes, cp->count);
-				advance_and_return_if_error({});
-			}
+		TOML_NODISCARD
+		TOML_ALWAYS_INLINE
+		const utf8_codepoint* read_next() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			utf8_buffered_reader_error_check({});
 
-			return string_buffer;
+			if (is_direct_)
+				return direct_read_next();
+			return buffered_read_next();
 		}
 
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		bool parse_boolean()
+		const utf8_codepoint* step_back(size_t count) noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_match(*cp, U't', U'f', U'T', U'F'));
-			push_parse_scope("boolean"sv);
+			utf8_buffered_reader_error_check({});
 
-			start_recording(true);
-			auto result = is_match(*cp, U't', U'T');
-			if (!consume_expected_sequence(result ? U"true"sv : U"false"sv))
-				set_error_and_return_default("expected '"sv,
-											 to_sv(result),
-											 "', saw '"sv,
-											 to_sv(recording_buffer),
-											 "'"sv);
-			stop_recording();
+			if (is_direct_)
+				return direct_step_back(count);
 
-			if (cp && !is_value_terminator(*cp))
-				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+			TOML_ASSERT_ASSUME(history_.count);
+			TOML_ASSERT_ASSUME(negative_offset_ + count <= history_.count);
 
-			return result;
+			negative_offset_ += count;
+
+			return negative_offset_
+					 ? history_.buffer + ((history_.first + history_.count - negative_offset_) % history_buffer_size)
+					 : head_;
+		}
+
+		// the raw source bytes from the head codepoint onwards; empty unless the input is contiguous.
+		// anything beyond the head hasn't necessarily been validated yet.
+		TOML_PURE_INLINE_GETTER
+		std::string_view raw_span() const noexcept
+		{
+			if (!is_direct_ || !head_)
+				return {};
+			return { direct_.pos, static_cast<size_t>(direct_.end - direct_.pos) };
 		}
 
+		// validates the first `count` bytes of raw_span() without moving the head, so any encoding error amongst them
+		// is reported just as it would have been had they been read.
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		double parse_inf_or_nan()
+		bool validate_ahead(size_t count) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_match(*cp, U'i', U'n', U'I', U'N', U'+', U'-'));
-			push_parse_scope("floating-point"sv);
+			utf8_buffered_reader_error_check(false);
+			TOML_ASSERT_ASSUME(is_direct_);
+			TOML_ASSERT_ASSUME(count <= static_cast<size_t>(direct_.end - direct_.pos));
 
-			start_recording(true);
-			const bool negative = *cp == U'-';
-			if (negative || *cp == U'+')
-				advance_and_return_if_error_or_eof({});
+			auto& d			  = direct_;
+			const auto target = d.pos + count;
+			while (target > d.complete_end && d.block_end < d.end)
+			{
+				if TOML_UNLIKELY(!direct_validate_next_block())
+					return false;
+			}
+			return true;
+		}
 
-			const bool inf = is_match(*cp, U'i', U'I');
-			if (!consume_expected_sequence(inf ? U"inf"sv : U"nan"sv))
-				set_error_and_return_default("expected '"sv,
-											 inf ? "inf"sv : "nan"sv,
-											 "', saw '"sv,
-											 to_sv(recording_buffer),
-											 "'"sv);
-			stop_recording();
+		// steps over the first `count` bytes of raw_span() in one go.
+		// the bytes must be complete utf-8 sequences with no line breaks.
+		TOML_NODISCARD
+		const utf8_codepoint* skip(size_t count) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			utf8_buffered_reader_error_check({});
+			TOML_ASSERT_ASSUME(is_direct_);
+			TOML_ASSERT_ASSUME(head_);
+			TOML_ASSERT_ASSUME(count && count <= static_cast<size_t>(direct_.end - direct_.pos));
 
-			if (cp && !is_value_terminator(*cp))
-				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+			// validate everything up to the target first so error locations are calculated from the current head
+			if TOML_UNLIKELY(!validate_ahead(count))
+				return head_ = nullptr;
 
-			return inf ? (negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity())
-					   : std::numeric_limits<double>::quiet_NaN();
+			auto& d			  = direct_;
+			const auto target = d.pos + count;
+			for (; d.pos < target; d.pos++)
+			{
+				TOML_ASSERT(*d.pos != '\n');
+				if ((static_cast<unsigned char>(*d.pos) & 0xC0u) != 0x80u)
+					d.position.column++;
+			}
+
+			return direct_decode();
 		}
 
+		// as skip(), but the bytes may also contain line breaks.
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		double parse_float()
+		const utf8_codepoint* skip_lines(size_t count) noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_match(*cp, U'+', U'-', U'.') || is_decimal_digit(*cp));
-			push_parse_scope("floating-point"sv);
+			utf8_buffered_reader_error_check({});
+			TOML_ASSERT_ASSUME(is_direct_);
+			TOML_ASSERT_ASSUME(head_);
+			TOML_ASSERT_ASSUME(count && count <= static_cast<size_t>(direct_.end - direct_.pos));
 
-			// sign
-			const int sign = *cp == U'-' ? -1 : 1;
-			if (is_match(*cp, U'+', U'-'))
-				advance_and_return_if_error_or_eof({});
+			auto& d			  = direct_;
+			const auto target = d.pos + count;
 
-			// consume value chars
-			char chars[utf8_buffered_reader::max_history_length];
-			size_t length			   = {};
-			const utf8_codepoint* prev = {};
-			bool seen_decimal = false, seen_exponent = false;
-			char first_integer_part = '\0';
-			while (!is_eof() && !is_value_terminator(*cp))
+			while (target > d.complete_end && d.block_end < d.end)
 			{
-				if (*cp == U'_')
+				if TOML_UNLIKELY(!direct_validate_next_block())
+					return head_ = nullptr;
+			}
+
+			d.position = direct_position_of(target);
+			d.pos	   = target;
+			return direct_decode();
+		}
+
+		// position of the head codepoint (or one-past-the-end at EOF); only meaningful for contiguous inputs.
+		TOML_PURE_INLINE_GETTER
+		const source_position& position() const noexcept
+		{
+			return direct_.position;
+		}
+
+		TOML_NODISCARD
+		bool peek_eof() const noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+		{
+			if (is_direct_)
+				return direct_.pos == direct_.end;
+			return reader_.peek_eof();
+		}
+
+#if !TOML_EXCEPTIONS
+
+		TOML_NODISCARD
+		optional<parse_error>&& error() noexcept
+		{
+			if (is_direct_)
+				return std::move(err_);
+			return reader_.error();
+		}
+
+#endif
+	};
+}
+TOML_ANON_NAMESPACE_END;
+
+#if TOML_EXCEPTIONS
+#define TOML_RETURNS_BY_THROWING [[noreturn]]
+#else
+#define TOML_RETURNS_BY_THROWING
+#endif
+
+TOML_ANON_NAMESPACE_START
+{
+	template <typename... T>
+	TOML_CONST_GETTER
+	TOML_INTERNAL_LINKAGE
+	constexpr bool is_match(char32_t codepoint, T... vals) noexcept
+	{
+		static_assert((std::is_same_v<char32_t, T> && ...));
+		return ((codepoint == vals) || ...);
+	}
+
+	template <uint64_t>
+	struct parse_integer_traits;
+	template <>
+	struct parse_integer_traits<2>
+	{
+		static constexpr auto scope_qualifier  = "binary integer"sv;
+		static constexpr auto is_digit		   = impl::is_binary_digit;
+		static constexpr auto is_signed		   = false;
+		static constexpr auto max_digits	   = 63;
+		static constexpr auto prefix_codepoint = U'b';
+		static constexpr auto prefix		   = "b"sv;
+		static constexpr auto full_prefix	   = "0b"sv;
+	};
+	template <>
+	struct parse_integer_traits<8>
+	{
+		static constexpr auto scope_qualifier  = "octal integer"sv;
+		static constexpr auto is_digit		   = impl::is_octal_digit;
+		static constexpr auto is_signed		   = false;
+		static constexpr auto max_digits	   = 21; // strlen("777777777777777777777")
+		static constexpr auto prefix_codepoint = U'o';
+		static constexpr auto prefix		   = "o"sv;
+		static constexpr auto full_prefix	   = "0o"sv;
+	};
+	template <>
+	struct parse_integer_traits<10>
+	{
+		static constexpr auto scope_qualifier = "decimal integer"sv;
+		static constexpr auto is_digit		  = impl::is_decimal_digit;
+		static constexpr auto is_signed		  = true;
+		static constexpr auto max_digits	  = 19; // strlen("9223372036854775807")
+		static constexpr auto full_prefix	  = ""sv;
+	};
+	template <>
+	struct parse_integer_traits<16>
+	{
+		static constexpr auto scope_qualifier  = "hexadecimal integer"sv;
+		static constexpr auto is_digit		   = impl::is_hexadecimal_digit;
+		static constexpr auto is_signed		   = false;
+		static constexpr auto max_digits	   = 16; // strlen("7FFFFFFFFFFFFFFF")
+		static constexpr auto prefix_codepoint = U'x';
+		static constexpr auto prefix		   = "x"sv;
+		static constexpr auto full_prefix	   = "0x"sv;
+	};
+
+	// the eight bytes starting at str, first byte lowest (i.e. a little-endian load regardless of platform;
+	// compilers turn this into a single load where they can)
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	uint64_t load_eight_bytes(const char* str) noexcept
+	{
+		const auto byte = [=](unsigned i) noexcept
+		{ return static_cast<uint64_t>(static_cast<unsigned char>(str[i])) << (i * 8u); };
+		return byte(0) | byte(1) | byte(2) | byte(3) | byte(4) | byte(5) | byte(6) | byte(7);
+	}
+
+	// the value of the eight (already validated) digits starting at str, computed all at once: the digits are
+	// combined into pairs, the pairs into quads and the quads into the result with one multiply each.
+	template <uint64_t base>
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	uint64_t parse_eight_digits(const char* str) noexcept
+	{
+		uint64_t val = load_eight_bytes(str);
+		if constexpr (base == 16)
+			val = (val & 0x0F0F0F0F0F0F0F0Fu) + ((val >> 6) & 0x0101010101010101u) * 9u; // 'a'-'f' and 'A'-'F'
+		else
+			val &= 0x0F0F0F0F0F0F0F0Fu;
+
+		val = ((val * (base * 0x100u + 1u)) >> 8) & 0x00FF00FF00FF00FFu;
+		val = ((val * (base * base * 0x10000u + 1u)) >> 16) & 0x0000FFFF0000FFFFu;
+		return (val * ((base * base * base * base << 32) + 1u)) >> 32;
+	}
+
+	// whether the eight bytes in val (see load_eight_bytes()) are all decimal digits, save for the ones selected by
+	// punct_mask, which must match those in punct exactly. used to check fixed-width date and time fields in one go.
+	TOML_CONST_INLINE_GETTER
+	bool matches_digit_pattern(uint64_t val, uint64_t punct, uint64_t punct_mask) noexcept
+	{
+		// (a byte is a digit if its high nibble is 3, and still is after adding 6 to it)
+		constexpr uint64_t zeroes	   = 0x3030303030303030u;
+		const uint64_t digit_nibbles = 0xF0F0F0F0F0F0F0F0u & ~punct_mask;
+		return (val & punct_mask) == punct												//
+			&& (val & digit_nibbles) == (zeroes & digit_nibbles)						//
+			&& ((val + 0x0606060606060606u) & digit_nibbles) == (zeroes & digit_nibbles);
+	}
+
+	// whether str starts with a valid "+HH:MM" or "-HH:MM" time offset
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	bool is_fixed_width_offset(std::string_view str) noexcept
+	{
+		if (str.length() < 6u || (str[0] != '+' && str[0] != '-') || str[3] != ':')
+			return false;
+		for (size_t i : { 1u, 2u, 4u, 5u })
+			if (!impl::is_decimal_digit(static_cast<unsigned char>(str[i])))
+				return false;
+		return (str[1] < '2' || (str[1] == '2' && str[2] <= '3')) && str[4] <= '5';
+	}
+
+	TOML_CONST_INLINE_GETTER
+	uint32_t max_days_in_month(uint32_t year, uint32_t month) noexcept
+	{
+		if (month == 2u)
+			return (year % 4u == 0u) && ((year % 100u != 0u) || (year % 400u == 0u)) ? 29u : 28u;
+		return month == 4u || month == 6u || month == 9u || month == 11u ? 30u : 31u;
+	}
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	std::string_view to_sv(node_type val) noexcept
+	{
+		return impl::node_type_friendly_names[impl::unwrap_enum(val)];
+	}
+
+	// the parser's working buffers (see parse_options::memory_resource)
+#if TOML_HAS_MEMORY_RESOURCE
+	using buffer_allocator = std::pmr::polymorphic_allocator<char>;
+	using buffer_string	   = std::pmr::string;
+	template <typename T>
+	using buffer_vector = std::pmr::vector<T>;
+#else
+	using buffer_allocator = std::allocator<char>;
+	using buffer_string	   = std::string;
+	template <typename T>
+	using buffer_vector = std::vector<T>;
+#endif
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	std::string_view to_sv(const std::string& str) noexcept
+	{
+		return std::string_view{ str };
+	}
+
+#if TOML_HAS_MEMORY_RESOURCE
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	std::string_view to_sv(const buffer_string& str) noexcept
+	{
+		return std::string_view{ str };
+	}
+
+#endif
+
+	TOML_CONST_GETTER
+	TOML_INTERNAL_LINKAGE
+	std::string_view to_sv(bool val) noexcept
+	{
+		using namespace std::string_view_literals;
+
+		return val ? "true"sv : "false"sv;
+	}
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	std::string_view to_sv(const utf8_codepoint& cp) noexcept
+	{
+		if (cp.value <= U'\x1F')
+			return impl::control_char_escapes[cp.value];
+		else if (cp.value == U'\x7F')
+			return "\\u007F"sv;
+		else
+			return std::string_view{ cp.bytes, cp.count };
+	}
+
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	std::string_view to_sv(const utf8_codepoint* cp) noexcept
+	{
+		if (cp)
+			return to_sv(*cp);
+		return ""sv;
+	}
+
+	struct escaped_codepoint
+	{
+		const utf8_codepoint& cp;
+	};
+
+	template <typename T>
+	TOML_ATTR(nonnull)
+	TOML_INTERNAL_LINKAGE
+	void concatenate(char*& write_pos, char* const buf_end, const T& arg) noexcept
+	{
+		if TOML_UNLIKELY(write_pos >= buf_end)
+			return;
+
+		using arg_type = impl::remove_cvref<T>;
+
+		// string views
+		if constexpr (std::is_same_v<arg_type, std::string_view>)
+		{
+			const auto max_chars = static_cast<size_t>(buf_end - write_pos);
+			const auto len		 = max_chars < arg.length() ? max_chars : arg.length();
+			std::memcpy(write_pos, arg.data(), len);
+			write_pos += len;
+		}
+
+		// doubles
+		else if constexpr (std::is_same_v<arg_type, double>)
+		{
+#if TOML_FLOAT_CHARCONV
+			const auto result = std::to_chars(write_pos, buf_end, arg);
+			write_pos		  = result.ptr;
+#else
+			std::ostringstream ss;
+			ss.imbue(std::locale::classic());
+			ss.precision(std::numeric_limits<arg_type>::max_digits10);
+			ss << arg;
+			concatenate(write_pos, buf_end, to_sv(std::move(ss).str()));
+#endif
+		}
+
+		// 64-bit integers
+		else if constexpr (impl::is_one_of<arg_type, int64_t, uint64_t>)
+		{
+#if TOML_INT_CHARCONV
+			const auto result = std::to_chars(write_pos, buf_end, arg);
+			write_pos		  = result.ptr;
+#else
+			std::ostringstream ss;
+			ss.imbue(std::locale::classic());
+			using cast_type = std::conditional_t<std::is_signed_v<arg_type>, int64_t, uint64_t>;
+			ss << static_cast<cast_type>(arg);
+			concatenate(write_pos, buf_end, to_sv(std::move(ss).str()));
+#endif
+		}
+
+		// escaped_codepoint
+		else if constexpr (std::is_same_v<arg_type, escaped_codepoint>)
+		{
+			if (arg.cp.value <= U'\x7F')
+				concatenate(write_pos, buf_end, to_sv(arg.cp));
+			else
+			{
+				auto val			= static_cast<uint_least32_t>(arg.cp.value);
+				const auto digits	= val > 0xFFFFu ? 8u : 4u;
+				constexpr auto mask = uint_least32_t{ 0xFu };
+				char buf[10]		= { '\\', digits > 4 ? 'U' : 'u' };
+				for (auto i = 2u + digits; i-- > 2u;)
+				{
+					const auto hexdig = val & mask;
+					buf[i]			  = static_cast<char>(hexdig >= 0xAu ? ('A' + (hexdig - 0xAu)) : ('0' + hexdig));
+					val >>= 4;
+				}
+				concatenate(write_pos, buf_end, std::string_view{ buf, digits + 2u });
+			}
+		}
+
+		// all other floats (fallback - coerce to double)
+		else if constexpr (std::is_floating_point_v<arg_type>)
+			concatenate(write_pos, buf_end, static_cast<double>(arg));
+
+		// all other integers (fallback - coerce to (u)int64_t)
+		else if constexpr (std::is_arithmetic_v<arg_type> && std::is_integral_v<arg_type>)
+		{
+			using cast_type = std::conditional_t<std::is_unsigned_v<arg_type>, uint64_t, int64_t>;
+			concatenate(write_pos, buf_end, static_cast<cast_type>(arg));
+		}
+
+		else
+		{
+			static_assert(
+				impl::always_false<T>,
+				"concatenate() inputs are limited to std::string_views, integers, floats, and escaped_codepoint");
+		}
+	}
+
+	struct error_builder
+	{
+		static constexpr std::size_t buf_size = 512;
+		char buf[buf_size];
+		char* write_pos			  = buf;
+		char* const max_write_pos = buf + (buf_size - std::size_t{ 1 }); // allow for null terminator
+
+		TOML_NODISCARD_CTOR
+		error_builder(std::string_view scope) noexcept
+		{
+			concatenate(write_pos, max_write_pos, "Error while parsing "sv);
+			concatenate(write_pos, max_write_pos, scope);
+			concatenate(write_pos, max_write_pos, ": "sv);
+		}
+
+		template <typename T>
+		void append(const T& arg) noexcept
+		{
+			concatenate(write_pos, max_write_pos, arg);
+		}
+
+		TOML_RETURNS_BY_THROWING
+		auto finish(const source_position& pos, const source_path_ptr& source_path) const
+		{
+			*write_pos = '\0';
+
+#if TOML_EXCEPTIONS
+			throw parse_error{ buf, pos, source_path };
+#else
+			return parse_error{ std::string(buf, static_cast<size_t>(write_pos - buf)), pos, source_path };
+#endif
+		}
+
+		TOML_DELETE_DEFAULTS(error_builder);
+	};
+
+	struct parse_scope
+	{
+		std::string_view& storage_;
+		std::string_view parent_;
+
+		TOML_NODISCARD_CTOR
+		explicit parse_scope(std::string_view& current_scope, std::string_view new_scope) noexcept
+			: storage_{ current_scope },
+			  parent_{ current_scope }
+		{
+			storage_ = new_scope;
+		}
+
+		~parse_scope() noexcept
+		{
+			storage_ = parent_;
+		}
+
+		TOML_DELETE_DEFAULTS(parse_scope);
+	};
+#define push_parse_scope_2(scope, line) parse_scope ps_##line(current_scope, scope)
+#define push_parse_scope_1(scope, line) push_parse_scope_2(scope, line)
+#define push_parse_scope(scope)			push_parse_scope_1(scope, __LINE__)
+
+	struct parse_key_buffer
+	{
+		buffer_string buffer;
+		buffer_vector<std::pair<size_t, size_t>> segments;
+		buffer_vector<source_position> starts;
+		buffer_vector<source_position> ends;
+
+		TOML_NODISCARD_CTOR
+		explicit parse_key_buffer(const buffer_allocator& alloc) //
+			: buffer(alloc),
+			  segments(alloc),
+			  starts(alloc),
+			  ends(alloc)
+		{}
+
+		void clear() noexcept
+		{
+			buffer.clear();
+			segments.clear();
+			starts.clear();
+			ends.clear();
+		}
+
+		void push_back(std::string_view segment, source_position b, source_position e)
+		{
+			segments.push_back({ buffer.length(), segment.length() });
+			buffer.append(segment);
+			starts.push_back(b);
+			ends.push_back(e);
+		}
+
+		TOML_PURE_INLINE_GETTER
+		std::string_view operator[](size_t i) const noexcept
+		{
+			return std::string_view{ buffer.c_str() + segments[i].first, segments[i].second };
+		}
+
+		TOML_PURE_INLINE_GETTER
+		std::string_view back() const noexcept
+		{
+			return (*this)[segments.size() - 1u];
+		}
+
+		TOML_PURE_INLINE_GETTER
+		bool empty() const noexcept
+		{
+			return segments.empty();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		size_t size() const noexcept
+		{
+			return segments.size();
+		}
+	};
+
+	struct depth_counter_scope
+	{
+		size_t& depth_;
+
+		TOML_NODISCARD_CTOR
+		explicit depth_counter_scope(size_t& depth) noexcept //
+			: depth_{ depth }
+		{
+			depth_++;
+		}
+
+		~depth_counter_scope() noexcept
+		{
+			depth_--;
+		}
+
+		TOML_DELETE_DEFAULTS(depth_counter_scope);
+	};
+
+	struct parsed_string
+	{
+		std::string_view value;
+		bool was_multi_line;
+	};
+
+	// the result of parser::parse_value(): a new node when building a tree, or (when emitting events to a
+	// sax_handler) usually one of the parser's scratch_values.
+	struct parsed_value
+	{
+		impl::node_ptr owned;
+		node* ptr = {};
+
+		TOML_NODISCARD_CTOR
+		parsed_value() noexcept = default;
+
+		TOML_NODISCARD_CTOR
+		explicit parsed_value(impl::node_ptr&& nde) noexcept //
+			: owned{ std::move(nde) },
+			  ptr{ owned.get() }
+		{}
+
+		TOML_NODISCARD_CTOR
+		explicit parsed_value(node& nde) noexcept //
+			: ptr{ &nde }
+		{}
+
+		TOML_PURE_INLINE_GETTER
+		explicit operator bool() const noexcept
+		{
+			return ptr != nullptr;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		node* operator->() const noexcept
+		{
+			return ptr;
+		}
+	};
+
+	// values are parsed into these instead of new nodes when emitting events, so they never touch the heap
+	struct scratch_values
+	{
+		value<std::string> strings;
+		value<int64_t> integers;
+		value<double> floats;
+		value<bool> booleans;
+		value<toml::date> dates;
+		value<toml::time> times;
+		value<toml::date_time> date_times;
+		array arrays; // only ever empty; the elements are emitted as they're parsed
+
+		template <typename T>
+		TOML_PURE_INLINE_GETTER
+		value<T>& get() noexcept
+		{
+			if constexpr (std::is_same_v<T, std::string>)
+				return strings;
+			else if constexpr (std::is_same_v<T, int64_t>)
+				return integers;
+			else if constexpr (std::is_same_v<T, double>)
+				return floats;
+			else if constexpr (std::is_same_v<T, bool>)
+				return booleans;
+			else if constexpr (std::is_same_v<T, toml::date>)
+				return dates;
+			else if constexpr (std::is_same_v<T, toml::time>)
+				return times;
+			else
+			{
+				static_assert(std::is_same_v<T, toml::date_time>);
+				return date_times;
+			}
+		}
+	};
+
+	// lazy documents: the length of the string beginning at `begin` (including the delimiters),
+	// or zero if it isn't terminated properly.
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	size_t skim_string(const char* begin, const char* end) noexcept
+	{
+		TOML_ASSERT_ASSUME(begin < end);
+		TOML_ASSERT_ASSUME(*begin == '"' || *begin == '\'');
+
+		const auto delimiter = *begin;
+		const auto escape	 = delimiter == '"' ? '\\' : delimiter; // (literal strings don't have escapes)
+		const auto& kernels	 = impl::simd();
+
+		// single-line
+		if (end - begin < 3 || begin[1] != delimiter || begin[2] != delimiter)
+		{
+			for (auto c = begin + 1;;)
+			{
+				c = kernels.find_string_terminator(c, end, delimiter, escape);
+				if (c == end || *c == '\n')
+					return {};
+				if (*c == delimiter)
+					return static_cast<size_t>(c + 1 - begin);
+				if (*c == escape)
+				{
+					if (c + 1 == end || c[1] == '\n')
+						return {};
+					c += 2;
+				}
+				else
+					c++; // some other control character; the value's parser will complain about it
+			}
+		}
+
+		// multi-line
+		for (auto c = begin + 3;;)
+		{
+			c = kernels.find_string_terminator(c, end, delimiter, escape);
+			if (c == end)
+				return {};
+			if (*c == delimiter)
+			{
+				auto run_end = c;
+				while (run_end < end && *run_end == delimiter)
+					run_end++;
+				if (run_end - c >= 3) // the closing delimiter (possibly preceded by one or two quotes)
+					return run_end - c <= 5 ? static_cast<size_t>(run_end - begin) : 0u;
+				c = run_end;
+			}
+			else if (*c == escape)
+			{
+				if (c + 1 == end)
+					return {};
+				c += 2;
+			}
+			else
+				c++; // line breaks etc.
+		}
+	}
+
+	// lazy documents: the contents of a string skimmed by skim_string(), if they're exactly what it would be parsed
+	// as (i.e. there are no escape sequences, line endings that need normalizing or characters that aren't allowed).
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	optional<std::string_view> plain_string_contents(std::string_view str) noexcept
+	{
+		TOML_ASSERT_ASSUME(str.length() >= 2u);
+
+		const auto delimiter  = str[0];
+		const bool multi_line = str.length() > 2u && str[1] == delimiter; // (the empty single-line string is just "")
+
+		auto contents = multi_line ? str.substr(3u, str.length() - 6u) : str.substr(1u, str.length() - 2u);
+		if (multi_line && !contents.empty() && contents[0] == '\n')
+			contents.remove_prefix(1u); // (a line break right after the opening delimiter is trimmed)
+
+		for (const char c : contents)
+		{
+			const auto u = static_cast<unsigned char>(c);
+			if ((u < 0x20u && c != '\t' && (c != '\n' || !multi_line)) || u == 0x7Fu)
+				return {};
+			if (c == '\\' && delimiter == '"')
+				return {};
+		}
+		return contents;
+	}
+
+	// lazy documents: the length of the array or inline table beginning at `begin` (including the brackets),
+	// or zero if it isn't closed properly.
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	size_t skim_container(const char* begin, const char* end) noexcept
+	{
+		TOML_ASSERT_ASSUME(begin < end);
+		TOML_ASSERT_ASSUME(*begin == '[' || *begin == '{');
+
+		size_t depth = {};
+		for (auto c = begin; c < end; c++)
+		{
+			switch (*c)
+			{
+				case '[': [[fallthrough]];
+				case '{': depth++; break;
+
+				case ']': [[fallthrough]];
+				case '}':
+					if (!--depth)
+						return static_cast<size_t>(c + 1 - begin);
+					break;
+
+				case '"': [[fallthrough]];
+				case '\'':
+				{
+					const auto len = skim_string(c, end);
+					if (!len)
+						return {};
+					c += len - 1u;
+					break;
+				}
+
+				case '#':
+					do
+						c = impl::simd().find_comment_terminator(c + 1, end);
+					while (c < end && *c != '\n');
+					if (c == end)
+						return {};
+					break;
+
+				default: break;
+			}
+		}
+		return {};
+	}
+
+	struct deferred_extent
+	{
+		size_t length;
+		node_type type;
+	};
+
+	// lazy documents: the length and type of the value beginning at `begin` if it can be deferred, or a length of
+	// zero if it should just be parsed as normal. that's anything malformed enough that its extent or type is unclear
+	// (so the usual error is reported), and integers that are malformed or might not fit in an int64_t.
+	TOML_PURE_GETTER
+	TOML_INTERNAL_LINKAGE
+	deferred_extent skim_value(const char* begin, const char* end) noexcept
+	{
+		TOML_ASSERT_ASSUME(begin < end);
+
+		switch (*begin)
+		{
+			case '"': [[fallthrough]];
+			case '\'': return { skim_string(begin, end), node_type::string };
+			case '[': return { skim_container(begin, end), node_type::array };
+			case '{': return { skim_container(begin, end), node_type::table };
+			default: break;
+		}
+
+		const auto is_digit = [](char c) noexcept { return c >= '0' && c <= '9'; };
+		if (!is_digit(*begin) && *begin != '+' && *begin != '-' && *begin != 't' && *begin != 'f')
+			return {};
+
+		// the rest of a bare value; nullptr if it runs into anything that isn't a value-terminator or plain ASCII
+		const auto find_token_end = [=](const char* c) noexcept -> const char*
+		{
+			for (; c < end; c++)
+			{
+				switch (*c)
+				{
+					case ' ': [[fallthrough]];
+					case '\t': [[fallthrough]];
+					case '\n': [[fallthrough]];
+					case '\r': [[fallthrough]];
+					case ',': [[fallthrough]];
+					case ']': [[fallthrough]];
+					case '}': [[fallthrough]];
+					case '#': return c;
+
+					default:
+						if (static_cast<unsigned char>(*c) <= 0x20u || static_cast<unsigned char>(*c) >= 0x7Fu)
+							return nullptr;
+				}
+			}
+			return c;
+		};
+		const auto token_end = find_token_end(begin);
+		if (!token_end)
+			return {};
+		const auto len = static_cast<size_t>(token_end - begin);
+
+		// booleans
+		if (*begin == 't' || *begin == 'f')
+		{
+			const auto token = std::string_view{ begin, len };
+			return { token == "true"sv || token == "false"sv ? len : 0u, node_type::boolean };
+		}
+
+		// dates and date-times
+		if (len >= 10u && is_digit(*begin) && begin[4] == '-' && begin[7] == '-')
+		{
+			if (len > 10u)
+				return { len, node_type::date_time };
+
+			// date-times with a space instead of a 'T'
+			if (end - token_end >= 3 && token_end[0] == ' ' && is_digit(token_end[1])
+				&& is_digit(token_end[2]))
+			{
+				if (const auto time_end = find_token_end(token_end + 1))
+					return { static_cast<size_t>(time_end - begin), node_type::date_time };
+				return {};
+			}
+
+			return { len, node_type::date };
+		}
+
+		// times
+		if (std::memchr(begin, ':', len))
+			return { is_digit(*begin) ? len : 0u, node_type::time };
+
+		// floats
+		const auto digits = begin + (*begin == '+' || *begin == '-' ? 1 : 0);
+		if (digits == token_end)
+			return {};
+		for (auto c = digits; c < token_end; c++)
+		{
+			if (*c == '.' || *c == 'e' || *c == 'E')
+				return { len, node_type::floating_point };
+		}
+
+		// integers (digits with single underscores between them, and at most as many as are sure to fit)
+		const auto skim_integer = [=](const char* c, auto&& is_valid_digit, size_t max_digits) noexcept -> bool
+		{
+			size_t count = {};
+			for (bool prev_digit = false; c < token_end; c++)
+			{
+				if (*c == '_')
+				{
+					if (!prev_digit)
+						return false;
+					prev_digit = false;
+					continue;
+				}
+				if (!is_valid_digit(*c) || ++count > max_digits)
+					return false;
+				prev_digit = true;
+			}
+			return count && token_end[-1] != '_';
+		};
+		bool valid;
+		if (token_end - digits >= 2 && *digits == '0' && (digits[1] == 'x' || digits[1] == 'o' || digits[1] == 'b'))
+		{
+			// (no sign allowed)
+			if (digits != begin)
+				return {};
+			switch (digits[1])
+			{
+				case 'x':
+					valid = skim_integer(
+						digits + 2,
+						[](char c) noexcept
+						{ return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); },
+						15u);
+					break;
+				case 'o': valid = skim_integer(digits + 2, [](char c) noexcept { return c >= '0' && c <= '7'; }, 21u); break;
+				default: valid = skim_integer(digits + 2, [](char c) noexcept { return c == '0' || c == '1'; }, 63u); break;
+			}
+		}
+		else
+			valid = (*digits != '0' || token_end - digits == 1) && skim_integer(digits, is_digit, 18u);
+		return { valid ? len : 0u, node_type::integer };
+	}
+
+	struct table_vector_scope
+	{
+		buffer_vector<table*>& tables;
+
+		TOML_NODISCARD_CTOR
+		explicit table_vector_scope(buffer_vector<table*>& tables_, table& tbl) //
+			: tables{ tables_ }
+		{
+			tables.push_back(&tbl);
+		}
+
+		~table_vector_scope() noexcept
+		{
+			tables.pop_back();
+		}
+
+		TOML_DELETE_DEFAULTS(table_vector_scope);
+	};
+
+	// nodes (and tables) are heap-allocated so the low bits of their addresses are mostly zeroes; this mixes them
+	// with the rest so they can be hashed.
+	TOML_CONST_GETTER
+	TOML_INTERNAL_LINKAGE
+	size_t hash_pointer(const void* ptr) noexcept
+	{
+		auto h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDull;
+		h ^= h >> 33;
+		return static_cast<size_t>(h);
+	}
+
+	// a set of node pointers, with open addressing and linear probing.
+	// used by the parser to keep track of which tables and arrays it created implicitly or as table arrays.
+	template <typename T>
+	class node_set
+	{
+	  private:
+		struct slot_traits
+		{
+			TOML_CONST_INLINE_GETTER
+			static bool empty(const T* ptr) noexcept
+			{
+				return !ptr;
+			}
+
+			TOML_CONST_INLINE_GETTER
+			static size_t hash(const T* ptr) noexcept
+			{
+				return hash_pointer(ptr);
+			}
+		};
+		using probing = impl::linear_probing<T*, slot_traits>;
+
+		buffer_vector<T*> slots_;
+		size_t size_ = {};
+
+		TOML_NODISCARD
+		T*& find(const T* ptr) noexcept
+		{
+			return probing::find(slots_.data(),
+								 slots_.size() - 1u,
+								 slot_traits::hash(ptr),
+								 [=](const T* slot) noexcept { return slot == ptr; });
+		}
+
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit node_set(const buffer_allocator& alloc) noexcept //
+			: slots_(alloc)
+		{}
+
+		TOML_PURE_GETTER
+		bool contains(const T* ptr) const noexcept
+		{
+			return size_ && const_cast<node_set&>(*this).find(ptr);
+		}
+
+		void insert(T* ptr)
+		{
+			if (probing::needs_growth(size_, slots_.size()))
+			{
+				buffer_vector<T*> slots(probing::grown_capacity(slots_.size()), nullptr, slots_.get_allocator());
+				probing::rehash(slots_.data(), slots_.size(), slots.data(), slots.size() - 1u);
+				slots_ = std::move(slots);
+			}
+
+			if (auto& slot = find(ptr); !slot)
+			{
+				slot = ptr;
+				size_++;
+			}
+		}
+
+		bool erase(const T* ptr) noexcept
+		{
+			if (!size_)
+				return false;
+
+			auto& slot = find(ptr);
+			if (!slot)
+				return false;
+
+			probing::erase(slots_.data(), slots_.size() - 1u, slot);
+			size_--;
+			return true;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		size_t size() const noexcept
+		{
+			return size_;
+		}
+
+		TOML_PURE_INLINE_GETTER
+		bool empty() const noexcept
+		{
+			return !size_;
+		}
+
+		void clear() noexcept
+		{
+			if (!size_)
+				return;
+			for (auto& ptr : slots_)
+				ptr = nullptr;
+			size_ = {};
+		}
+	};
+
+	// the keys of the values in each table, along with their types. used by the parser in place of the values
+	// themselves when emitting events, so redefinitions can still be diagnosed (see parser::insert_parsed_value()),
+	// and by lazy documents as an index of the values they skipped over (see parser::skip_value()).
+	// entries are kept in the order they were added so the most recent ones can be forgotten again.
+	//
+	// the root table is moved out of the parser once it's done, so values in it have a null parent.
+	class value_key_set
+	{
+	  public:
+		struct entry
+		{
+			table* parent;
+			key k;
+			node_type type;
+			std::string_view source; // lazy documents: the value's text (empty once it's been parsed)
+			source_position position;
+		};
+
+	  private:
+		struct slot
+		{
+			size_t hash;
+			size_t index; // (into entries_, plus one; zero if the slot is empty)
+		};
+
+		struct slot_traits
+		{
+			TOML_CONST_INLINE_GETTER
+			static bool empty(const slot& s) noexcept
+			{
+				return !s.index;
+			}
+
+			TOML_CONST_INLINE_GETTER
+			static size_t hash(const slot& s) noexcept
+			{
+				return s.hash;
+			}
+		};
+		using probing = impl::linear_probing<slot, slot_traits>;
+
+		buffer_vector<entry> entries_;
+		buffer_vector<slot> slots_;
+
+		TOML_PURE_GETTER
+		static size_t hash(const table* parent, std::string_view k) noexcept
+		{
+			return hash_pointer(parent) ^ std::hash<std::string_view>{}(k);
+		}
+
+		TOML_NODISCARD
+		slot& find_slot(size_t h, const table* parent, std::string_view k) noexcept
+		{
+			return probing::find(slots_.data(),
+								 slots_.size() - 1u,
+								 h,
+								 [&](const slot& s) noexcept
+								 {
+									 const auto& e = entries_[s.index - 1u];
+									 return s.hash == h && e.parent == parent && e.k.str() == k;
+								 });
+		}
+
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit value_key_set(const buffer_allocator& alloc) noexcept //
+			: entries_(alloc),
+			  slots_(alloc)
+		{}
+
+		// the entry for the value with the given key in a table, or nullptr if there isn't one
+		TOML_PURE_GETTER
+		entry* find(const table* parent, std::string_view k) noexcept
+		{
+			if (entries_.empty())
+				return nullptr;
+
+			const auto& s = find_slot(hash(parent, k), parent, k);
+			return slot_traits::empty(s) ? nullptr : &entries_[s.index - 1u];
+		}
+
+		// (the key mustn't already be in the table)
+		void insert(table* parent, key&& k, node_type type, std::string_view source = {}, source_position position = {})
+		{
+			if (probing::needs_growth(entries_.size(), slots_.size()))
+			{
+				buffer_vector<slot> slots(probing::grown_capacity(slots_.size()), slot{}, slots_.get_allocator());
+				probing::rehash(slots_.data(), slots_.size(), slots.data(), slots.size() - 1u);
+				slots_ = std::move(slots);
+			}
+
+			const auto h = hash(parent, k.str());
+			entries_.push_back(entry{ parent, std::move(k), type, source, position });
+			probing::place(slots_.data(), slots_.size() - 1u, slot{ h, entries_.size() });
+		}
+
+		TOML_PURE_INLINE_GETTER
+		size_t size() const noexcept
+		{
+			return entries_.size();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		entry* begin() noexcept
+		{
+			return entries_.data();
+		}
+
+		TOML_PURE_INLINE_GETTER
+		entry* end() noexcept
+		{
+			return entries_.data() + entries_.size();
+		}
+
+		// forgets everything added since there were `count` entries
+		void truncate(size_t count) noexcept
+		{
+			while (entries_.size() > count)
+			{
+				const auto& last = entries_.back();
+				const auto index = entries_.size();
+
+				auto& s = probing::find(slots_.data(),
+										slots_.size() - 1u,
+										hash(last.parent, last.k.str()),
+										[=](const slot& candidate) noexcept { return candidate.index == index; });
+				probing::erase(slots_.data(), slots_.size() - 1u, s);
+				entries_.pop_back();
+			}
+		}
+
+		void clear() noexcept
+		{
+			if (entries_.empty())
+				return;
+			entries_.clear();
+			for (auto& s : slots_)
+				s = slot{};
+		}
+	};
+}
+TOML_ANON_NAMESPACE_END;
+
+#if 1 // parser helper macros
+
+// Q: "what the fuck is this? MACROS????"
+// A: The parser needs to work in exceptionless mode (returning error objects directly)
+//    and exception mode (reporting parse failures by throwing). Two totally different control flows.
+//    These macros encapsulate the differences between the two modes so I can write code code
+//    as though I was only targeting one mode and not want yeet myself into the sun.
+//    They're all #undef'd at the bottom of the parser's implementation so they should be harmless outside
+//    of toml++.
+
+#define is_eof()		 !cp
+#define assert_not_eof() TOML_ASSERT_ASSUME(cp != nullptr)
+#define return_if_eof(...)                                                                                             \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if TOML_UNLIKELY(is_eof())                                                                                     \
+			return __VA_ARGS__;                                                                                        \
+	}                                                                                                                  \
+	while (false)
+
+#if TOML_EXCEPTIONS
+#define is_error()					false
+#define return_after_error(...)		TOML_UNREACHABLE
+#define assert_not_error()			static_assert(true)
+#define return_if_error(...)		static_assert(true)
+#define return_if_error_or_eof(...) return_if_eof(__VA_ARGS__)
+#else
+#define is_error()				!!err
+#define return_after_error(...) return __VA_ARGS__
+#define assert_not_error()		TOML_ASSERT(!is_error())
+#define return_if_error(...)                                                                                           \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if TOML_UNLIKELY(is_error())                                                                                   \
+			return __VA_ARGS__;                                                                                        \
+	}                                                                                                                  \
+	while (false)
+#define return_if_error_or_eof(...)                                                                                    \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if TOML_UNLIKELY(is_eof() || is_error())                                                                       \
+			return __VA_ARGS__;                                                                                        \
+	}                                                                                                                  \
+	while (false)
+#endif
+
+#if defined(TOML_BREAK_AT_PARSE_ERRORS) && TOML_BREAK_AT_PARSE_ERRORS
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_debugtrap)
+#define parse_error_break() __builtin_debugtrap()
+#elif __has_builtin(__debugbreak)
+#define parse_error_break() __debugbreak()
+#endif
+#endif
+#ifndef parse_error_break
+#if TOML_MSVC || TOML_ICC
+#define parse_error_break() __debugbreak()
+#else
+#define parse_error_break() TOML_ASSERT(false)
+#endif
+#endif
+#else
+#define parse_error_break() static_assert(true)
+#endif
+
+#define set_error_and_return(ret, ...)                                                                                 \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if (!is_error())                                                                                               \
+			set_error(__VA_ARGS__);                                                                                    \
+		return_after_error(ret);                                                                                       \
+	}                                                                                                                  \
+	while (false)
+
+#define set_error_and_return_default(...) set_error_and_return({}, __VA_ARGS__)
+
+#define set_error_and_return_if_eof(...)                                                                               \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if TOML_UNLIKELY(is_eof())                                                                                     \
+			set_error_and_return(__VA_ARGS__, "encountered end-of-file"sv);                                            \
+	}                                                                                                                  \
+	while (false)
+
+#define advance_and_return_if_error(...)                                                                               \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		assert_not_eof();                                                                                              \
+		advance();                                                                                                     \
+		return_if_error(__VA_ARGS__);                                                                                  \
+	}                                                                                                                  \
+	while (false)
+
+#define advance_and_return_if_error_or_eof(...)                                                                        \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		assert_not_eof();                                                                                              \
+		advance();                                                                                                     \
+		return_if_error(__VA_ARGS__);                                                                                  \
+		set_error_and_return_if_eof(__VA_ARGS__);                                                                      \
+	}                                                                                                                  \
+	while (false)
+
+#endif // parser helper macros
+
+TOML_IMPL_NAMESPACE_START
+{
+	// path-filtered parsing: a table put in the tree by a key-value pair outside of keep_paths
+	// (see parser::prune_discarded_tables()).
+	struct discarded_table
+	{
+		table* parent;
+		key k;
+	};
+
+	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, impl_ex, impl_noex);
+
+	class parser
+	{
+	  private:
+		static constexpr size_t max_nested_values	  = TOML_MAX_NESTED_VALUES;
+		static constexpr size_t max_dotted_keys_depth = TOML_MAX_DOTTED_KEYS_DEPTH;
+
+		utf8_buffered_reader reader;
+		table root;
+		table* current_table = {};
+		sax_handler* events = {};
+		bool discarding_values = false; // when emitting events, or skipping values outside of keep_paths
+		scratch_values scratch;
+		buffer_vector<key> event_keys;
+		value_key_set discarded_value_keys;
+		value_key_set* value_keys;	  // the values that aren't in the tree (see add_value_key())
+		bool skipping_values = false; // loading a lazy document (see skip_value())
+		const std::vector<toml::path>* keep_paths = {};
+		buffer_vector<size_t> filter_depths; // how much of each of keep_paths the current table has matched
+		bool filter_keep_all = true;	   // the current table is at or beneath one of keep_paths
+		source_position prev_pos = { 1, 1 };
+		const utf8_codepoint* cp = {};
+		bool more_batches		 = false; // incremental parsing: the document carries on past the current batch
+		node_set<table> implicit_tables;
+		node_set<table> dotted_key_tables;
+		buffer_vector<discarded_table> discarded_tables; // see prune_discarded_tables()
+		buffer_vector<table*> open_inline_tables;
+		node_set<array> table_arrays;
+		parse_key_buffer key_buffer;
+		buffer_string string_buffer;
+		buffer_string recording_buffer; // for diagnostics
+		bool recording = false, recording_whitespace = true;
+		std::string_view current_scope;
+		size_t nested_values = {};
+		node_arena* arena	 = {}; // see parse_options::use_arena
+#if TOML_ENABLE_SOURCES
+		bool track_sources = true; // see parse_options::omit_sources
+#else
+		static constexpr bool track_sources = false; // see TOML_ENABLE_SOURCES
+#endif
+		source_path_ptr region_path;	 // see init_source_path()
+		key_set<buffer_allocator> document_keys;
+		key_pool* interned_keys = {}; // see parse_options::interned_keys
+#if !TOML_EXCEPTIONS
+		mutable optional<parse_error> err;
+#endif
+
+		TOML_NODISCARD
+		source_position current_position(source_index fallback_offset = 0) const noexcept
+		{
+			if (!is_eof())
+				return cp->position;
+			if (more_batches)
+				return reader.position(); // (where the next batch begins, i.e. where cp would be in one big batch)
+			return { prev_pos.line, static_cast<source_index>(prev_pos.column + fallback_offset) };
+		}
+
+		template <typename... T>
+		TOML_RETURNS_BY_THROWING
+		TOML_NEVER_INLINE
+		void set_error_at(source_position pos, const T&... reason) const
+		{
+			static_assert(sizeof...(T) > 0);
+			return_if_error();
+
+			error_builder builder{ current_scope };
+			(builder.append(reason), ...);
+
+			parse_error_break();
+
+#if TOML_EXCEPTIONS
+			builder.finish(pos, reader.source_path());
+#else
+			err.emplace(builder.finish(pos, reader.source_path()));
+#endif
+		}
+
+		template <typename... T>
+		TOML_RETURNS_BY_THROWING
+		void set_error(const T&... reason) const
+		{
+			set_error_at(current_position(1), reason...);
+		}
+
+		void go_back(size_t count = 1) noexcept
+		{
+			return_if_error();
+			TOML_ASSERT_ASSUME(count);
+
+			cp		 = reader.step_back(count);
+			prev_pos = cp->position;
+		}
+
+		void advance()
+		{
+			return_if_error();
+			assert_not_eof();
+
+			prev_pos = cp->position;
+			cp		 = reader.read_next();
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
+			{
+				err = std::move(reader.error());
+				return;
+			}
+#endif
+
+			if (recording && !is_eof())
+			{
+				if (recording_whitespace || !is_whitespace(*cp))
+					recording_buffer.append(cp->bytes, cp->count);
+			}
+		}
+
+		// consumes the first `count` bytes of reader.raw_span() as if advance() had been called once per codepoint.
+		// the bytes must be complete utf-8 sequences with no line breaks (see utf8_buffered_reader::skip()).
+		void advance_raw(size_t count)
+		{
+			return_if_error();
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(count);
+
+			const auto span		  = reader.raw_span();
+			const auto head_count = cp->count;
+			TOML_ASSERT_ASSUME(count <= span.length());
+
+			// whitespace needs to be filtered out of the recording one codepoint at a time
+			if (recording && !recording_whitespace)
+			{
+				for (size_t i = head_count; i < count; i++)
+				{
+					const auto c = static_cast<unsigned char>(span[i]);
+					if (c <= 0x20u || c >= 0x80u)
+					{
+						while (!is_eof() && !is_error() && reader.raw_span().data() < span.data() + count)
+							advance();
+						return;
+					}
+				}
+			}
+
+			cp = reader.skip(count);
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
+			{
+				err = std::move(reader.error());
+				return;
+			}
+#endif
+
+			prev_pos = reader.position();
+			prev_pos.column--;
+
+			if (recording)
+			{
+				recording_buffer.append(span.data() + head_count, count - head_count);
+				if (!is_eof() && (recording_whitespace || !is_whitespace(*cp)))
+					recording_buffer.append(cp->bytes, cp->count);
+			}
+		}
+
+		void start_recording(bool include_current = true) noexcept
+		{
+			return_if_error();
+
+			recording			 = true;
+			recording_whitespace = true;
+			recording_buffer.clear();
+			if (include_current && !is_eof())
+				recording_buffer.append(cp->bytes, cp->count);
+		}
+
+		void stop_recording(size_t pop_bytes = 0) noexcept
+		{
+			return_if_error();
+
+			recording = false;
+			if (pop_bytes)
+			{
+				if (pop_bytes >= recording_buffer.length())
+					recording_buffer.clear();
+				else if (pop_bytes == 1u)
+					recording_buffer.pop_back();
+				else
+					recording_buffer.erase(recording_buffer.begin()
+											   + static_cast<ptrdiff_t>(recording_buffer.length() - pop_bytes),
+										   recording_buffer.end());
+			}
+		}
+
+		bool consume_leading_whitespace()
+		{
+			return_if_error_or_eof({});
+
+			bool consumed = false;
+
+			// contiguous input: take the run of spaces and tabs in one go
+			if (const auto raw = reader.raw_span(); !raw.empty())
+			{
+				const auto len = static_cast<size_t>(
+					impl::simd().find_non_whitespace(raw.data(), raw.data() + raw.length()) - raw.data());
+				if (len)
+				{
+					consumed = true;
+					advance_raw(len);
+					return_if_error({});
+				}
+			}
+
+			while (!is_eof() && is_horizontal_whitespace(*cp))
+			{
+				if TOML_UNLIKELY(!is_ascii_horizontal_whitespace(*cp))
+					set_error_and_return_default("expected space or tab, saw '"sv, escaped_codepoint{ *cp }, "'"sv);
+
+				consumed = true;
+				advance_and_return_if_error({});
+			}
+			return consumed;
+		}
+
+		bool consume_line_break()
+		{
+			return_if_error_or_eof({});
+
+			if TOML_UNLIKELY(is_match(*cp, U'\v', U'\f'))
+				set_error_and_return_default(
+					R"(vertical tabs '\v' and form-feeds '\f' are not legal line breaks in TOML)"sv);
+
+			if (*cp == U'\r')
+			{
+				advance_and_return_if_error({}); // skip \r
+
+				if TOML_UNLIKELY(is_eof())
+					set_error_and_return_default("expected '\\n' after '\\r', saw EOF"sv);
+
+				if TOML_UNLIKELY(*cp != U'\n')
+					set_error_and_return_default("expected '\\n' after '\\r', saw '"sv,
+												 escaped_codepoint{ *cp },
+												 "'"sv);
+			}
+			else if (*cp != U'\n')
+				return false;
+
+			advance_and_return_if_error({}); // skip \n
+			return true;
+		}
+
+		bool consume_rest_of_line()
+		{
+			return_if_error_or_eof({});
+
+			do
+			{
+				if (is_ascii_vertical_whitespace(*cp))
+					return consume_line_break();
+				else
+					advance();
+				return_if_error({});
+			}
+			while (!is_eof());
+
+			return true;
+		}
+
+		bool consume_comment()
+		{
+			return_if_error_or_eof({});
+
+			if (*cp != U'#')
+				return false;
+
+			push_parse_scope("comment"sv);
+
+			advance_and_return_if_error({}); // skip the '#'
+
+			while (!is_eof())
+			{
+				// contiguous input: take everything up to the next line break or control character in one go
+				if (const auto raw = reader.raw_span(); !raw.empty())
+				{
+					const auto len = static_cast<size_t>(
+						impl::simd().find_comment_terminator(raw.data(), raw.data() + raw.length()) - raw.data());
+					if (len)
+					{
+						advance_raw(len);
+						return_if_error({});
+						if (is_eof())
+							break;
+					}
+				}
+
+				if (consume_line_break())
+					return true;
+				return_if_error({});
+
+#if TOML_LANG_AT_LEAST(1, 0, 0)
+
+				// toml/issues/567 (disallow non-TAB control characters in comments)
+				if TOML_UNLIKELY(is_nontab_control_character(*cp))
+					set_error_and_return_default(
+						"control characters other than TAB (U+0009) are explicitly prohibited in comments"sv);
+
+				// toml/pull/720 (disallow surrogates in comments)
+				else if TOML_UNLIKELY(is_unicode_surrogate(*cp))
+					set_error_and_return_default(
+						"unicode surrogates (U+D800 to U+DFFF) are explicitly prohibited in comments"sv);
+#endif
+
+				advance_and_return_if_error({});
+			}
+
+			return true;
+		}
+
+		TOML_NODISCARD
+		bool consume_expected_sequence(std::u32string_view seq)
+		{
+			return_if_error({});
+			TOML_ASSERT(!seq.empty());
+
+			for (auto c : seq)
+			{
+				set_error_and_return_if_eof({});
+				if (*cp != c)
+					return false;
+				advance_and_return_if_error({});
+			}
+			return true;
+		}
+
+		template <typename T>
+		TOML_NODISCARD
+		bool consume_digit_sequence(T* digits, size_t len)
+		{
+			return_if_error({});
+			TOML_ASSERT_ASSUME(digits);
+			TOML_ASSERT_ASSUME(len);
+
+			for (size_t i = 0; i < len; i++)
+			{
+				set_error_and_return_if_eof({});
+				if (!is_decimal_digit(*cp))
+					return false;
+
+				digits[i] = static_cast<T>(*cp - U'0');
+				advance_and_return_if_error({});
+			}
+			return true;
+		}
+
+		template <typename T>
+		TOML_NODISCARD
+		size_t consume_variable_length_digit_sequence(T* buffer, size_t max_len)
+		{
+			return_if_error({});
+			TOML_ASSERT_ASSUME(buffer);
+			TOML_ASSERT_ASSUME(max_len);
+
+			size_t i = {};
+			for (; i < max_len; i++)
+			{
+				if (is_eof() || !is_decimal_digit(*cp))
+					break;
+
+				buffer[i] = static_cast<T>(*cp - U'0');
+				advance_and_return_if_error({});
+			}
+			return i;
+		}
+
+		// contiguous input: appends the run of plain string characters at the head to the string buffer in one go,
+		// stopping at the first delimiter, escape character, line break or other control character.
+		// returns false if there wasn't one to append (including when the input isn't contiguous).
+		TOML_NODISCARD
+		bool append_string_run(char delimiter, char escape)
+		{
+			const auto raw = reader.raw_span();
+			if (raw.empty())
+				return false;
+
+			const auto len = static_cast<size_t>(
+				impl::simd().find_string_terminator(raw.data(), raw.data() + raw.length(), delimiter, escape)
+				- raw.data());
+			if (!len)
+				return false;
+
+			string_buffer.append(raw.data(), len);
+			advance_raw(len);
+			return true;
+		}
+
+		// contiguous input: if the string at the head is a single-line one with nothing in it that needs special
+		// handling (i.e. most of them), consumes it (up to and including the closing delimiter) and sets str to a view
+		// of it in the source, so it doesn't have to be copied into the string buffer first.
+		// returns false without consuming anything otherwise.
+		TOML_NODISCARD
+		bool read_plain_string(char delimiter, char escape, std::string_view& str)
+		{
+			const auto raw = reader.raw_span();
+			if (raw.empty())
+				return false;
+
+			const auto len = static_cast<size_t>(
+				impl::simd().find_string_terminator(raw.data(), raw.data() + raw.length(), delimiter, escape)
+				- raw.data());
+			if (len == raw.length() || raw[len] != delimiter)
+				return false;
+
+			if (len)
+			{
+				advance_raw(len);
+				return_if_error(true);
+			}
+			advance_and_return_if_error(true); // skip the closing delimiter
+
+			str = raw.substr(0u, len);
+			return true;
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		std::string_view parse_basic_string(bool multi_line)
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(*cp == U'"');
+			push_parse_scope("string"sv);
+
+			// skip the '"'
+			advance_and_return_if_error_or_eof({});
+
+			// multi-line strings ignore a single line ending right at the beginning
+			if (multi_line)
+			{
+				consume_line_break();
+				return_if_error({});
+				set_error_and_return_if_eof({});
+			}
+			else if (std::string_view plain; read_plain_string('"', '\\', plain))
+				return plain;
+
+			auto& str = string_buffer;
+			str.clear();
+			bool escaped			 = false;
+			bool skipping_whitespace = false;
+			do
+			{
+				if (escaped)
+				{
+					escaped = false;
+
+					// handle 'line ending slashes' in multi-line mode
+					if (multi_line && is_whitespace(*cp))
+					{
+						consume_leading_whitespace();
+
+						if TOML_UNLIKELY(!consume_line_break())
+							set_error_and_return_default(
+								"line-ending backslashes must be the last non-whitespace character on the line"sv);
+
+						skipping_whitespace = true;
+						return_if_error({});
+						continue;
+					}
+
+					bool skip_escaped_codepoint = true;
+					assert_not_eof();
+					switch (const auto escaped_codepoint = *cp)
+					{
+						// 'regular' escape codes
+						case U'b': str += '\b'; break;
+						case U'f': str += '\f'; break;
+						case U'n': str += '\n'; break;
+						case U'r': str += '\r'; break;
+						case U't': str += '\t'; break;
+						case U'"': str += '"'; break;
+						case U'\\': str += '\\'; break;
+
+#if TOML_LANG_UNRELEASED // toml/pull/790 (\e shorthand for \x1B)
+						case U'e': str += '\x1B'; break;
+#else
+						case U'e':
+							set_error_and_return_default(
+								"escape sequence '\\e' is not supported in TOML 1.0.0 and earlier"sv);
+#endif
+
+#if TOML_LANG_UNRELEASED // toml/pull/796 (\xHH unicode scalar sequences)
+						case U'x': [[fallthrough]];
+#else
+						case U'x':
+							set_error_and_return_default(
+								"escape sequence '\\x' is not supported in TOML 1.0.0 and earlier"sv);
+#endif
+
+						// unicode scalar sequences
+						case U'u': [[fallthrough]];
+						case U'U':
+						{
+							push_parse_scope("unicode scalar sequence"sv);
+							advance_and_return_if_error_or_eof({});
+							skip_escaped_codepoint = false;
+
+							uint32_t place_value =
+								escaped_codepoint == U'U' ? 0x10000000u : (escaped_codepoint == U'u' ? 0x1000u : 0x10u);
+							uint32_t sequence_value{};
+							while (place_value)
+							{
+								set_error_and_return_if_eof({});
+
+								if TOML_UNLIKELY(!is_hexadecimal_digit(*cp))
+									set_error_and_return_default("expected hex digit, saw '"sv, to_sv(*cp), "'"sv);
+
+								sequence_value += place_value * hex_to_dec(*cp);
+								place_value /= 16u;
+								advance_and_return_if_error({});
+							}
+
+							if TOML_UNLIKELY(is_unicode_surrogate(sequence_value))
+								set_error_and_return_default(
+									"unicode surrogates (U+D800 - U+DFFF) are explicitly prohibited"sv);
+							else if TOML_UNLIKELY(sequence_value > 0x10FFFFu)
+								set_error_and_return_default("values greater than U+10FFFF are invalid"sv);
+
+							if (sequence_value < 0x80)
+							{
+								str += static_cast<char>(sequence_value);
+							}
+							else if (sequence_value < 0x800u)
+							{
+								str += static_cast<char>((sequence_value >> 6) | 0xC0u);
+								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
+							}
+							else if (sequence_value < 0x10000u)
+							{
+								str += static_cast<char>((sequence_value >> 12) | 0xE0u);
+								str += static_cast<char>(((sequence_value >> 6) & 0x3Fu) | 0x80u);
+								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
+							}
+							else if (sequence_value < 0x110000u)
+							{
+								str += static_cast<char>((sequence_value >> 18) | 0xF0u);
+								str += static_cast<char>(((sequence_value >> 12) & 0x3Fu) | 0x80u);
+								str += static_cast<char>(((sequence_value >> 6) & 0x3Fu) | 0x80u);
+								str += static_cast<char>((sequence_value & 0x3Fu) | 0x80u);
+							}
+							break;
+						}
+
+							// ???
+							TOML_UNLIKELY_CASE
+						default: set_error_and_return_default("unknown escape sequence '\\"sv, to_sv(*cp), "'"sv);
+					}
+
+					if (skip_escaped_codepoint)
+						advance_and_return_if_error_or_eof({});
+				}
+				else
+				{
+					// take runs of plain characters in bulk
+					if ((!multi_line || !skipping_whitespace) && append_string_run('"', '\\'))
+					{
+						return_if_error({});
+						continue;
+					}
+
+					// handle closing delimiters
+					if (*cp == U'"')
+					{
+						if (multi_line)
+						{
+							size_t lookaheads			  = {};
+							size_t consecutive_delimiters = 1;
+							do
+							{
+								advance_and_return_if_error({});
+								lookaheads++;
+								if (!is_eof() && *cp == U'"')
+									consecutive_delimiters++;
+								else
+									break;
+							}
+							while (lookaheads < 4u);
+
+							switch (consecutive_delimiters)
+							{
+								// """ " (one quote somewhere in a ML string)
+								case 1:
+									str += '"';
+									skipping_whitespace = false;
+									continue;
+
+								// """ "" (two quotes somewhere in a ML string)
+								case 2:
+									str.append("\"\""sv);
+									skipping_whitespace = false;
+									continue;
+
+								// """ """ (the end of the string)
+								case 3: return str;
+
+								// """ """" (one at the end of the string)
+								case 4: str += '"'; return str;
+
+								// """ """"" (two quotes at the end of the string)
+								case 5:
+									str.append("\"\""sv);
+									advance_and_return_if_error({}); // skip the last '"'
+									return str;
+
+								default: TOML_UNREACHABLE;
+							}
+						}
+						else
+						{
+							advance_and_return_if_error({}); // skip the closing delimiter
+							return str;
+						}
+					}
+
+					// handle escapes
+					else if (*cp == U'\\')
+					{
+						advance_and_return_if_error_or_eof({}); // skip the '\'
+						skipping_whitespace = false;
+						escaped				= true;
+						continue;
+					}
+
+					// handle line endings in multi-line mode
+					if (multi_line && is_ascii_vertical_whitespace(*cp))
+					{
+						consume_line_break();
+						return_if_error({});
+						if (!skipping_whitespace)
+							str += '\n';
+						continue;
+					}
+
+					// handle control characters
+					if TOML_UNLIKELY(is_nontab_control_character(*cp))
+						set_error_and_return_default(
+							"unescaped control characters other than TAB (U+0009) are explicitly prohibited"sv);
+
+#if TOML_LANG_AT_LEAST(1, 0, 0)
+
+					// handle surrogates in strings
+					if TOML_UNLIKELY(is_unicode_surrogate(*cp))
+						set_error_and_return_default(
+							"unescaped unicode surrogates (U+D800 to U+DFFF) are explicitly prohibited"sv);
+#endif
+
+					if (multi_line)
+					{
+						if (!skipping_whitespace || !is_horizontal_whitespace(*cp))
+						{
+							skipping_whitespace = false;
+							str.append(cp->bytes, cp->count);
+						}
+					}
+					else
+						str.append(cp->bytes, cp->count);
+
+					advance_and_return_if_error({});
+				}
+			}
+			while (!is_eof());
+
+			set_error_and_return_default("encountered end-of-file"sv);
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		std::string_view parse_literal_string(bool multi_line)
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(*cp == U'\'');
+			push_parse_scope("literal string"sv);
+
+			// skip the delimiter
+			advance_and_return_if_error_or_eof({});
+
+			// multi-line strings ignore a single line ending right at the beginning
+			if (multi_line)
+			{
+				consume_line_break();
+				return_if_error({});
+				set_error_and_return_if_eof({});
+			}
+			else if (std::string_view plain; read_plain_string('\'', '\'', plain))
+				return plain;
+
+			auto& str = string_buffer;
+			str.clear();
+			do
+			{
+				return_if_error({});
+
+				// take runs of plain characters in bulk
+				if (append_string_run('\'', '\''))
+				{
+					return_if_error({});
+					continue;
+				}
+
+				// handle closing delimiters
+				if (*cp == U'\'')
+				{
+					if (multi_line)
+					{
+						size_t lookaheads			  = {};
+						size_t consecutive_delimiters = 1;
+						do
+						{
+							advance_and_return_if_error({});
+							lookaheads++;
+							if (!is_eof() && *cp == U'\'')
+								consecutive_delimiters++;
+							else
+								break;
+						}
+						while (lookaheads < 4u);
+
+						switch (consecutive_delimiters)
+						{
+							// ''' ' (one quote somewhere in a ML string)
+							case 1: str += '\''; continue;
+
+							// ''' '' (two quotes somewhere in a ML string)
+							case 2: str.append("''"sv); continue;
+
+							// ''' ''' (the end of the string)
+							case 3: return str;
+
+							// ''' '''' (one at the end of the string)
+							case 4: str += '\''; return str;
+
+							// ''' ''''' (two quotes at the end of the string)
+							case 5:
+								str.append("''"sv);
+								advance_and_return_if_error({}); // skip the last '
+								return str;
+
+							default: TOML_UNREACHABLE;
+						}
+					}
+					else
+					{
+						advance_and_return_if_error({}); // skip the closing delimiter
+						return str;
+					}
+				}
+
+				// handle line endings in multi-line mode
+				if (multi_line && is_ascii_vertical_whitespace(*cp))
+				{
+					consume_line_break();
+					return_if_error({});
+					str += '\n';
+					continue;
+				}
+
+				// handle control characters
+				if TOML_UNLIKELY(is_nontab_control_character(*cp))
+					set_error_and_return_default(
+						"control characters other than TAB (U+0009) are explicitly prohibited"sv);
+
+#if TOML_LANG_AT_LEAST(1, 0, 0)
+
+				// handle surrogates in strings
+				if TOML_UNLIKELY(is_unicode_surrogate(*cp))
+					set_error_and_return_default("unicode surrogates (U+D800 - U+DFFF) are explicitly prohibited"sv);
+#endif
+
+				str.append(cp->bytes, cp->count);
+				advance_and_return_if_error({});
+			}
+			while (!is_eof());
+
+			set_error_and_return_default("encountered end-of-file"sv);
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		parsed_string parse_string()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_string_delimiter(*cp));
+			push_parse_scope("string"sv);
+
+			// snapshot length so the recording buffer can be rewound alongside go_back(2u) below
+			const auto recording_buffer_rollback_size = recording_buffer.length();
+
+			// get the first three characters to determine the string type
+			const auto first = cp->value;
+			advance_and_return_if_error_or_eof({});
+			const auto second = cp->value;
+			advance_and_return_if_error({});
+			const auto third = cp ? cp->value : U'\0';
+
+			// if we were eof at the third character then first and second need to be
+			// the same string character (otherwise it's an unterminated string).
+			// (when that's just the end of a batch the document carries on, so it's a regular string like any other)
+			if (is_eof() && (second == first || !more_batches))
+			{
+				if (second == first)
+					return {};
+
+				set_error_and_return_default("encountered end-of-file"sv);
+			}
+
+			// if the first three characters are all the same string delimiter then
+			// it's a multi-line string.
+			else if (first == second && first == third)
+			{
+				return { first == U'\'' ? parse_literal_string(true) : parse_basic_string(true), true };
+			}
+
+			// otherwise it's just a regular string.
+			else
+			{
+				// step back two characters so that the current
+				// character is the string delimiter
+				go_back(2u);
+				if (recording)
+					recording_buffer.resize(recording_buffer_rollback_size);
+
+				return { first == U'\'' ? parse_literal_string(false) : parse_basic_string(false), false };
+			}
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		std::string_view parse_bare_key_segment()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_bare_key_character(*cp));
+
+			string_buffer.clear();
+
+			// contiguous input: take the ascii run in one go
+			if (const auto raw = reader.raw_span(); !raw.empty())
+			{
+				size_t len = {};
+				while (len < raw.length() && is_ascii_bare_key_character(static_cast<unsigned char>(raw[len])))
+					len++;
+
+				if (len)
+				{
+					advance_raw(len);
+					return_if_error({});
+
+					// (if that was the whole segment it can be used straight from the source)
+					if (len == raw.length() || static_cast<unsigned char>(raw[len]) < 0x80u)
+						return raw.substr(0u, len);
+					string_buffer.append(raw.data(), len);
+				}
+			}
+
+			while (!is_eof())
+			{
+				if (!is_bare_key_character(*cp))
+					break;
+
+				string_buffer.append(cp->bytes, cp->count);
+				advance_and_return_if_error({});
+			}
+
+			return string_buffer;
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		bool parse_boolean()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_match(*cp, U't', U'f', U'T', U'F'));
+			push_parse_scope("boolean"sv);
+
+			start_recording(true);
+			auto result = is_match(*cp, U't', U'T');
+			if (!consume_expected_sequence(result ? U"true"sv : U"false"sv))
+				set_error_and_return_default("expected '"sv,
+											 to_sv(result),
+											 "', saw '"sv,
+											 to_sv(recording_buffer),
+											 "'"sv);
+			stop_recording();
+
+			if (cp && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			return result;
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		double parse_inf_or_nan()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_match(*cp, U'i', U'n', U'I', U'N', U'+', U'-'));
+			push_parse_scope("floating-point"sv);
+
+			start_recording(true);
+			const bool negative = *cp == U'-';
+			if (negative || *cp == U'+')
+				advance_and_return_if_error_or_eof({});
+
+			const bool inf = is_match(*cp, U'i', U'I');
+			if (!consume_expected_sequence(inf ? U"inf"sv : U"nan"sv))
+				set_error_and_return_default("expected '"sv,
+											 inf ? "inf"sv : "nan"sv,
+											 "', saw '"sv,
+											 to_sv(recording_buffer),
+											 "'"sv);
+			stop_recording();
+
+			if (cp && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			return inf ? (negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity())
+					   : std::numeric_limits<double>::quiet_NaN();
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		double parse_float()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_match(*cp, U'+', U'-', U'.') || is_decimal_digit(*cp));
+			push_parse_scope("floating-point"sv);
+
+			// sign
+			const int sign = *cp == U'-' ? -1 : 1;
+			if (is_match(*cp, U'+', U'-'))
+				advance_and_return_if_error_or_eof({});
+
+			// consume value chars
+			char chars[utf8_buffered_reader::max_history_length];
+			size_t length			   = {};
+			const utf8_codepoint* prev = {};
+			bool seen_decimal = false, seen_exponent = false;
+			char first_integer_part = '\0';
+			while (!is_eof() && !is_value_terminator(*cp))
+			{
+				if (*cp == U'_')
+				{
+					if (!prev || !is_decimal_digit(*prev))
+						set_error_and_return_default("underscores may only follow digits"sv);
+
+					prev = cp;
+					advance_and_return_if_error_or_eof({});
+					continue;
+				}
+				else if TOML_UNLIKELY(prev && *prev == U'_' && !is_decimal_digit(*cp))
+					set_error_and_return_default("underscores must be followed by digits"sv);
+				else if TOML_UNLIKELY(length == sizeof(chars))
+					set_error_and_return_default("exceeds length limit of "sv,
+												 sizeof(chars),
+												 " digits"sv,
+												 (seen_exponent ? ""sv : " (consider using exponent notation)"sv));
+				else if (*cp == U'.')
+				{
+					// .1
+					// -.1
+					// +.1 (no integer part)
+					if (!first_integer_part)
+						set_error_and_return_default("expected decimal digit, saw '.'"sv);
+
+					// 1.0e+.10 (exponent cannot have '.')
+					else if (seen_exponent)
+						set_error_and_return_default("expected exponent decimal digit or sign, saw '.'"sv);
+
+					// 1.0.e+.10
+					// 1..0
+					// (multiple '.')
+					else if (seen_decimal)
+						set_error_and_return_default("expected decimal digit or exponent, saw '.'"sv);
+
+					seen_decimal = true;
+				}
+				else if (is_match(*cp, U'e', U'E'))
+				{
+					if (prev && !is_decimal_digit(*prev))
+						set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+
+					// 1.0ee+10 (multiple 'e')
+					else if (seen_exponent)
+						set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+
+					seen_decimal  = true; // implied
+					seen_exponent = true;
+				}
+				else if (is_match(*cp, U'+', U'-'))
+				{
+					// 1.-0 (sign in mantissa)
+					if (!seen_exponent)
+						set_error_and_return_default("expected decimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
+
+					// 1.0e1-0 (misplaced exponent sign)
+					else if (!is_match(*prev, U'e', U'E'))
+						set_error_and_return_default("expected exponent digit, saw '"sv, to_sv(*cp), "'"sv);
+				}
+				else if (is_decimal_digit(*cp))
+				{
+					if (!seen_decimal)
+					{
+						if (!first_integer_part)
+							first_integer_part = static_cast<char>(cp->bytes[0]);
+						else if (first_integer_part == '0')
+							set_error_and_return_default("leading zeroes are prohibited"sv);
+					}
+				}
+				else
+					set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+
+				chars[length++] = static_cast<char>(cp->bytes[0]);
+				prev			= cp;
+				advance_and_return_if_error({});
+			}
+
+			// sanity-check ending state
+			if (prev)
+			{
+				if (*prev == U'_')
+				{
+					set_error_and_return_if_eof({});
+					set_error_and_return_default("underscores must be followed by digits"sv);
+				}
+				else if (is_match(*prev, U'e', U'E', U'+', U'-', U'.'))
+				{
+					set_error_and_return_if_eof({});
+					set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+				}
+			}
+
+			// convert to double
+			double result;
+			if TOML_LIKELY(decimal_to_double(chars, chars + length, result))
+				return result * sign;
+
+			// (only the rare inputs the fast path can't decide get this far, as do the ones that over/underflow)
+#if TOML_FLOAT_CHARCONV
+			{
+				auto fc_result = std::from_chars(chars, chars + length, result);
+				switch (fc_result.ec)
+				{
+					TOML_LIKELY_CASE
+					case std::errc{}: // ok
+						return result * sign;
+
+					case std::errc::invalid_argument:
+						set_error_and_return_default("'"sv,
+													 std::string_view{ chars, length },
+													 "' could not be interpreted as a value"sv);
+						break;
+
+					case std::errc::result_out_of_range:
+						set_error_and_return_default("'"sv,
+													 std::string_view{ chars, length },
+													 "' is not representable in 64 bits"sv);
+						break;
+
+					default: //??
+						set_error_and_return_default("an unspecified error occurred while trying to interpret '"sv,
+													 std::string_view{ chars, length },
+													 "' as a value"sv);
+				}
+			}
+#else
+			{
+				std::stringstream ss;
+				ss.imbue(std::locale::classic());
+				ss.write(chars, static_cast<std::streamsize>(length));
+				if ((ss >> result))
+					return result * sign;
+				else
+					set_error_and_return_default("'"sv,
+												 std::string_view{ chars, length },
+												 "' could not be interpreted as a value"sv);
+			}
+#endif
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		double parse_hex_float()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_match(*cp, U'0', U'+', U'-'));
+			push_parse_scope("hexadecimal floating-point"sv);
+
+#if TOML_LANG_UNRELEASED // toml/issues/562 (hexfloats)
+
+			// sign
+			const int sign = *cp == U'-' ? -1 : 1;
+			if (is_match(*cp, U'+', U'-'))
+				advance_and_return_if_error_or_eof({});
+
+			// '0'
+			if (*cp != U'0')
+				set_error_and_return_default(" expected '0', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// 'x' or 'X'
+			if (!is_match(*cp, U'x', U'X'))
+				set_error_and_return_default("expected 'x' or 'X', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// <HEX DIGITS> ([.]<HEX DIGITS>)? [pP] [+-]? <DEC DIGITS>
+
+			// consume value fragments
+			struct fragment
+			{
+				char chars[24];
+				size_t length;
+				double value;
+			};
+			fragment fragments[] = {
+				{}, // mantissa, whole part
+				{}, // mantissa, fractional part
+				{}	// exponent
+			};
+			fragment* current_fragment = fragments;
+			const utf8_codepoint* prev = {};
+			int exponent_sign		   = 1;
+			while (!is_eof() && !is_value_terminator(*cp))
+			{
+				if (*cp == U'_')
+				{
+					if (!prev || !is_hexadecimal_digit(*prev))
+						set_error_and_return_default("underscores may only follow digits"sv);
+
+					prev = cp;
+					advance_and_return_if_error_or_eof({});
+					continue;
+				}
+				else if (prev && *prev == U'_' && !is_hexadecimal_digit(*cp))
+					set_error_and_return_default("underscores must be followed by digits"sv);
+				else if (*cp == U'.')
+				{
+					// 0x10.0p-.0 (exponent cannot have '.')
+					if (current_fragment == fragments + 2)
+						set_error_and_return_default("expected exponent digit or sign, saw '.'"sv);
+
+					// 0x10.0.p-0 (multiple '.')
+					else if (current_fragment == fragments + 1)
+						set_error_and_return_default("expected hexadecimal digit or exponent, saw '.'"sv);
+
+					else
+						current_fragment++;
+				}
+				else if (is_match(*cp, U'p', U'P'))
+				{
+					// 0x10.0pp-0 (multiple 'p')
+					if (current_fragment == fragments + 2)
+						set_error_and_return_default("expected exponent digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+
+					// 0x.p-0 (mantissa is just '.')
+					else if (fragments[0].length == 0u && fragments[1].length == 0u)
+						set_error_and_return_default("expected hexadecimal digit, saw '"sv, to_sv(*cp), "'"sv);
+
+					else
+						current_fragment = fragments + 2;
+				}
+				else if (is_match(*cp, U'+', U'-'))
+				{
+					// 0x-10.0p-0 (sign in mantissa)
+					if (current_fragment != fragments + 2)
+						set_error_and_return_default("expected hexadecimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
+
+					// 0x10.0p0- (misplaced exponent sign)
+					else if (!is_match(*prev, U'p', U'P'))
+						set_error_and_return_default("expected exponent digit, saw '"sv, to_sv(*cp), "'"sv);
+
+					else
+						exponent_sign = *cp == U'-' ? -1 : 1;
+				}
+				else if (current_fragment < fragments + 2 && !is_hexadecimal_digit(*cp))
+					set_error_and_return_default("expected hexadecimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
+				else if (current_fragment == fragments + 2 && !is_decimal_digit(*cp))
+					set_error_and_return_default("expected exponent digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+				else if (current_fragment->length == sizeof(fragment::chars))
+					set_error_and_return_default("fragment exceeeds maximum length of "sv,
+												 sizeof(fragment::chars),
+												 " characters"sv);
+				else
+					current_fragment->chars[current_fragment->length++] = static_cast<char>(cp->bytes[0]);
+
+				prev = cp;
+				advance_and_return_if_error({});
+			}
+
+			// sanity-check ending state
+			if (current_fragment != fragments + 2 || current_fragment->length == 0u)
+			{
+				set_error_and_return_if_eof({});
+				set_error_and_return_default("missing exponent"sv);
+			}
+			else if (prev && *prev == U'_')
+			{
+				set_error_and_return_if_eof({});
+				set_error_and_return_default("underscores must be followed by digits"sv);
+			}
+
+			// calculate values for the three fragments
+			for (int fragment_idx = 0; fragment_idx < 3; fragment_idx++)
+			{
+				auto& f				= fragments[fragment_idx];
+				const uint32_t base = fragment_idx == 2 ? 10u : 16u;
+
+				// left-trim zeroes
+				const char* c = f.chars;
+				size_t sig	  = {};
+				while (f.length && *c == '0')
+				{
+					f.length--;
+					c++;
+					sig++;
+				}
+				if (!f.length)
+					continue;
+
+				// calculate value
+				auto place = 1u;
+				for (size_t i = 0; i < f.length - 1u; i++)
+					place *= base;
+				uint32_t val{};
+				while (place)
+				{
+					if (base == 16)
+						val += place * hex_to_dec(*c);
+					else
+						val += place * static_cast<uint32_t>(*c - '0');
+					if (fragment_idx == 1)
+						sig++;
+					c++;
+					place /= base;
+				}
+				f.value = static_cast<double>(val);
+
+				// shift the fractional part
+				if (fragment_idx == 1)
+				{
+					while (sig--)
+						f.value /= base;
+				}
+			}
+
+			return (fragments[0].value + fragments[1].value) * pow(2.0, fragments[2].value * exponent_sign) * sign;
+
+#else // !TOML_LANG_UNRELEASED
+
+			set_error_and_return_default("hexadecimal floating-point values are not supported "
+										 "in TOML 1.0.0 and earlier"sv);
+
+#endif // !TOML_LANG_UNRELEASED
+		}
+
+		template <uint64_t base>
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		int64_t parse_integer()
+		{
+			return_if_error({});
+			assert_not_eof();
+			using traits = parse_integer_traits<base>;
+			push_parse_scope(traits::scope_qualifier);
+
+			[[maybe_unused]] int64_t sign = 1;
+			if constexpr (traits::is_signed)
+			{
+				sign = *cp == U'-' ? -1 : 1;
+				if (is_match(*cp, U'+', U'-'))
+					advance_and_return_if_error_or_eof({});
+			}
+
+			if constexpr (base == 10)
+			{
+				if (!traits::is_digit(*cp))
+					set_error_and_return_default("expected expected digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+			}
+			else
+			{
+				// '0'
+				if (*cp != U'0')
+					set_error_and_return_default("expected '0', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				// 'b', 'o', 'x'
+				if (*cp != traits::prefix_codepoint)
+					set_error_and_return_default("expected '"sv, traits::prefix, "', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				if (!traits::is_digit(*cp))
+					set_error_and_return_default("expected digit, saw '"sv, to_sv(*cp), "'"sv);
+			}
+
+			// consume digits
+			char digits[utf8_buffered_reader::max_history_length];
+			const char* digit_chars = digits;
+			size_t length			= {};
+			char32_t prev			= {};
+
+			// contiguous input: take the run of digits (and any underscores between them) in one go, using the
+			// digits straight from the source if there weren't any underscores
+			if (const auto raw = reader.raw_span(); !raw.empty())
+			{
+				const auto digit_at = [&](size_t i) noexcept
+				{ return i < raw.length() && traits::is_digit(static_cast<unsigned char>(raw[i])); };
+
+				size_t len		 = {};
+				bool underscores = false;
+				while (len < sizeof(digits))
+				{
+					while (digit_at(len))
+						len++;
+					if (!digit_at(len + 1u) || raw[len] != '_')
+						break;
+					underscores = true;
+					len++;
+				}
+
+				// (longer runs are left to the loop below to report)
+				if (len <= sizeof(digits))
+				{
+					if (underscores)
+					{
+						for (size_t i = 0; i < len; i++)
+							if (raw[i] != '_')
+								digits[length++] = raw[i];
+					}
+					else
+					{
+						digit_chars = raw.data();
+						length		= len;
+					}
+
+					advance_raw(len);
+					return_if_error({});
+					prev = static_cast<unsigned char>(raw[len - 1u]);
+				}
+			}
+
+			while (!is_eof() && !is_value_terminator(*cp))
+			{
+				if (*cp == U'_')
+				{
+					if (!traits::is_digit(prev))
+						set_error_and_return_default("underscores may only follow digits"sv);
+
+					prev = *cp;
+					advance_and_return_if_error_or_eof({});
+					continue;
+				}
+				else if TOML_UNLIKELY(prev == U'_' && !traits::is_digit(*cp))
+					set_error_and_return_default("underscores must be followed by digits"sv);
+				else if TOML_UNLIKELY(!traits::is_digit(*cp))
+					set_error_and_return_default("expected digit, saw '"sv, to_sv(*cp), "'"sv);
+				else if TOML_UNLIKELY(length == sizeof(digits))
+					set_error_and_return_default("exceeds length limit of "sv, sizeof(digits), " digits"sv);
+				else
+				{
+					// (the contiguous path above takes every digit it can see, so anything here is a fresh run)
+					TOML_ASSERT_ASSUME(digit_chars == digits);
+					digits[length++] = static_cast<char>(cp->bytes[0]);
+				}
+
+				prev = *cp;
+				advance_and_return_if_error({});
+			}
+
+			// sanity check ending state
+			if (prev == U'_')
+			{
+				set_error_and_return_if_eof({});
+				set_error_and_return_default("underscores must be followed by digits"sv);
+			}
+
+			// single digits can be converted trivially
+			if (length == 1u)
+			{
+				int64_t result;
+
+				if constexpr (base == 16)
+					result = static_cast<int64_t>(hex_to_dec(digit_chars[0]));
+				else
+					result = static_cast<int64_t>(digit_chars[0] - '0');
+
+				if constexpr (traits::is_signed)
+					result *= sign;
+
+				return result;
+			}
+
+			// bin, oct and hex allow leading zeroes so trim them first
+			const char* end = digit_chars + length;
+			const char* msd = digit_chars;
+			if constexpr (base != 10)
+			{
+				while (msd < end && *msd == '0')
+					msd++;
+				if (msd == end)
+					return 0ll;
+			}
+
+			// decimal integers do not allow leading zeroes
+			else
+			{
+				if TOML_UNLIKELY(digit_chars[0] == '0')
+					set_error_and_return_default("leading zeroes are prohibited"sv);
+			}
+
+			// range check
+			if TOML_UNLIKELY(static_cast<size_t>(end - msd) > traits::max_digits)
+				set_error_and_return_default("'"sv,
+											 traits::full_prefix,
+											 std::string_view{ digit_chars, length },
+											 "' is not representable as a signed 64-bit integer"sv);
+
+			// do the thing
+			{
+				// (max_digits is low enough that none of this can wrap around)
+				uint64_t result = {};
+				for (auto count = static_cast<size_t>(end - msd) % 8u; count; count--, msd++)
+				{
+					if constexpr (base == 16)
+						result = result * base + hex_to_dec(*msd);
+					else
+						result = result * base + static_cast<uint64_t>(*msd - '0');
+				}
+				for (; msd < end; msd += 8)
+					result = result * (base * base * base * base * base * base * base * base)
+						   + parse_eight_digits<base>(msd);
+
+				// range check
+				static constexpr auto i64_max = static_cast<uint64_t>((std::numeric_limits<int64_t>::max)());
+				if TOML_UNLIKELY(result > i64_max + (sign < 0 ? 1u : 0u))
+					set_error_and_return_default("'"sv,
+												 traits::full_prefix,
+												 std::string_view{ digit_chars, length },
+												 "' is not representable as a signed 64-bit integer"sv);
+
+				if constexpr (traits::is_signed)
+				{
+					// avoid signed multiply UB when parsing INT64_MIN
+					if TOML_UNLIKELY(sign < 0 && result == i64_max + 1u)
+						return (std::numeric_limits<int64_t>::min)();
+
+					return static_cast<int64_t>(result) * sign;
+				}
+				else
+					return static_cast<int64_t>(result);
+			}
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		date parse_date(bool part_of_datetime = false)
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
+			push_parse_scope("date"sv);
+
+			// contiguous input: "YYYY-MM-DD" all at once
+			// (anything out of the ordinary is left to the field-by-field version below so it can be reported)
+			if (const auto raw = reader.raw_span(); raw.length() >= 10u
+				&& matches_digit_pattern(load_eight_bytes(raw.data()), 0x2D00002D00000000u, 0xFF0000FF00000000u)
+				&& is_decimal_digit(static_cast<unsigned char>(raw[8]))
+				&& is_decimal_digit(static_cast<unsigned char>(raw[9])))
+			{
+				const auto digit = [&](size_t i) noexcept { return static_cast<uint32_t>(raw[i] - '0'); };
+				const auto year	 = digit(0) * 1000u + digit(1) * 100u + digit(2) * 10u + digit(3);
+				const auto month = digit(5) * 10u + digit(6);
+				const auto day	 = digit(8) * 10u + digit(9);
+				if (month && month <= 12u && day && day <= max_days_in_month(year, month))
+				{
+					advance_raw(10u);
+					return_if_error({});
+
+					if (!part_of_datetime && !is_eof() && !is_value_terminator(*cp))
+						set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+					return { year, month, day };
+				}
+			}
+
+			// "YYYY"
+			uint32_t digits[4];
+			if (!consume_digit_sequence(digits, 4u))
+				set_error_and_return_default("expected 4-digit year, saw '"sv, to_sv(cp), "'"sv);
+			const auto year = digits[3] + digits[2] * 10u + digits[1] * 100u + digits[0] * 1000u;
+			set_error_and_return_if_eof({});
+
+			// '-'
+			if (*cp != U'-')
+				set_error_and_return_default("expected '-', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// "MM"
+			if (!consume_digit_sequence(digits, 2u))
+				set_error_and_return_default("expected 2-digit month, saw '"sv, to_sv(cp), "'"sv);
+			const auto month = digits[1] + digits[0] * 10u;
+			if (month == 0u || month > 12u)
+				set_error_and_return_default("expected month between 1 and 12 (inclusive), saw "sv, month);
+			const auto max_days = max_days_in_month(year, month);
+			set_error_and_return_if_eof({});
+
+			// '-'
+			if (*cp != U'-')
+				set_error_and_return_default("expected '-', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// "DD"
+			if (!consume_digit_sequence(digits, 2u))
+				set_error_and_return_default("expected 2-digit day, saw '"sv, to_sv(cp), "'"sv);
+			const auto day = digits[1] + digits[0] * 10u;
+			if (day == 0u || day > max_days)
+				set_error_and_return_default("expected day between 1 and "sv, max_days, " (inclusive), saw "sv, day);
+
+			if (!part_of_datetime && !is_eof() && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			return { year, month, day };
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		time parse_time(bool part_of_datetime = false)
+		{
+			return_if_error({});
+			assert_not_eof();
+			push_parse_scope("time"sv); // (not necessarily a digit here; date-times only check the date part up front)
+
+			static constexpr size_t max_digits = 64; // far more than necessary but needed to allow fractional
+													 // millisecond truncation per the spec
+			uint32_t digits[max_digits];
+			auto time = toml::time{};
+
+			// contiguous input: "HH:MM:SS" all at once
+			// (anything out of the ordinary is left to the field-by-field version below so it can be reported)
+			bool read_fixed_fields = false;
+			if (const auto raw = reader.raw_span(); raw.length() >= 8u
+				&& matches_digit_pattern(load_eight_bytes(raw.data()), 0x00003A00003A0000u, 0x0000FF0000FF0000u))
+			{
+				const auto digit  = [&](size_t i) noexcept { return static_cast<uint32_t>(raw[i] - '0'); };
+				const auto hour	  = digit(0) * 10u + digit(1);
+				const auto minute = digit(3) * 10u + digit(4);
+				const auto second = digit(6) * 10u + digit(7);
+				if (hour <= 23u && minute <= 59u && second <= 59u)
+				{
+					advance_raw(8u);
+					return_if_error({});
+					time			  = toml::time{ hour, minute, second };
+					read_fixed_fields = true;
+				}
+			}
+
+			if (!read_fixed_fields)
+			{
+				// "HH"
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit hour, saw '"sv, to_sv(cp), "'"sv);
+				const auto hour = digits[1] + digits[0] * 10u;
+				if (hour > 23u)
+					set_error_and_return_default("expected hour between 0 to 59 (inclusive), saw "sv, hour);
+				set_error_and_return_if_eof({});
+
+				// ':'
+				if (*cp != U':')
+					set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				// "MM"
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit minute, saw '"sv, to_sv(cp), "'"sv);
+				const auto minute = digits[1] + digits[0] * 10u;
+				if (minute > 59u)
+					set_error_and_return_default("expected minute between 0 and 59 (inclusive), saw "sv, minute);
+				time = toml::time{ hour, minute };
+
+				// ':'
+				if constexpr (TOML_LANG_UNRELEASED) // toml/issues/671 (allow omission of seconds)
+				{
+					if (is_eof() || is_value_terminator(*cp)
+						|| (part_of_datetime && is_match(*cp, U'+', U'-', U'Z', U'z')))
+						return time;
+				}
+				else
+					set_error_and_return_if_eof({});
+				if (*cp != U':')
+					set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				// "SS"
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit second, saw '"sv, to_sv(cp), "'"sv);
+				const auto second = digits[1] + digits[0] * 10u;
+				if (second > 59u)
+					set_error_and_return_default("expected second between 0 and 59 (inclusive), saw "sv, second);
+				time.second = static_cast<decltype(time.second)>(second);
+			}
+
+			// '.' (early-exiting is allowed; fractional is optional)
+			if (is_eof() || is_value_terminator(*cp) || (part_of_datetime && is_match(*cp, U'+', U'-', U'Z', U'z')))
+				return time;
+			if (*cp != U'.')
+				set_error_and_return_default("expected '.', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// "FFFFFFFFF"
+			size_t digit_count = {};
+			uint32_t value	   = {};
+
+			// contiguous input: the digits all at once (only the first nine matter)
+			if (const auto raw = reader.raw_span(); !raw.empty())
+			{
+				while (digit_count < raw.length() && digit_count <= max_digits
+					   && is_decimal_digit(static_cast<unsigned char>(raw[digit_count])))
+					digit_count++;
+
+				if (digit_count && digit_count <= max_digits)
+				{
+					size_t i = {};
+					if (digit_count >= 8u)
+					{
+						value = static_cast<uint32_t>(parse_eight_digits<10>(raw.data()));
+						i	  = 8u;
+					}
+					for (; i < digit_count && i < 9u; i++)
+						value = value * 10u + static_cast<uint32_t>(raw[i] - '0');
+					for (; i < 9u; i++) // implicit zeros
+						value *= 10u;
+
+					advance_raw(digit_count);
+					return_if_error({});
+				}
+				else
+					digit_count = {};
+			}
+
+			if (!digit_count)
+			{
+				digit_count = consume_variable_length_digit_sequence(digits, max_digits);
+				if (!digit_count)
+				{
+					set_error_and_return_if_eof({});
+					set_error_and_return_default("expected fractional digits, saw '"sv, to_sv(*cp), "'"sv);
+				}
+				else if (!is_eof() && digit_count == max_digits && is_decimal_digit(*cp))
+					set_error_and_return_default("fractional component exceeds maximum precision of "sv, max_digits);
+
+				uint32_t place = 1u;
+				for (auto i = impl::min<size_t>(digit_count, 9u); i-- > 0u;)
+				{
+					value += digits[i] * place;
+					place *= 10u;
+				}
+				for (auto i = digit_count; i < 9u; i++) // implicit zeros
+					value *= 10u;
+			}
+
+			if (!part_of_datetime && !is_eof() && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			time.nanosecond = value;
+			return time;
+		}
+
+		TOML_NODISCARD
+		TOML_NEVER_INLINE
+		date_time parse_date_time()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
+			push_parse_scope("date-time"sv);
+
+			// "YYYY-MM-DD"
+			auto date = parse_date(true);
+			set_error_and_return_if_eof({});
+
+			// ' ', 'T' or 't'
+			if (!is_match(*cp, U' ', U'T', U't'))
+				set_error_and_return_default("expected space, 'T' or 't', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// "HH:MM:SS.FFFFFFFFF"
+			auto time = parse_time(true);
+			return_if_error({});
+
+			// no offset
+			if (is_eof() || is_value_terminator(*cp))
+				return { date, time };
+
+			// zero offset ('Z' or 'z')
+			time_offset offset{};
+			if (is_match(*cp, U'Z', U'z'))
+				advance_and_return_if_error({});
+
+			// explicit offset ("+/-HH:MM"), all at once from contiguous input
+			// (anything out of the ordinary is left to the field-by-field version below so it can be reported)
+			else if (const auto raw = reader.raw_span(); is_fixed_width_offset(raw))
+			{
+				const auto digit = [&](size_t i) noexcept { return raw[i] - '0'; };
+				const int sign	 = raw[0] == '-' ? -1 : 1;
+				offset.minutes	 = static_cast<decltype(offset.minutes)>(
+					  ((digit(1) * 10 + digit(2)) * 60 + digit(4) * 10 + digit(5)) * sign);
+				advance_raw(6u);
+				return_if_error({});
+			}
+
+			// explicit offset ("+/-HH:MM")
+			else if (is_match(*cp, U'+', U'-'))
+			{
+				push_parse_scope("date-time offset"sv);
+
+				// sign
+				int sign = *cp == U'-' ? -1 : 1;
+				advance_and_return_if_error_or_eof({});
+
+				// "HH"
+				int digits[2];
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit hour, saw '"sv, to_sv(cp), "'"sv);
+				const auto hour = digits[1] + digits[0] * 10;
+				if (hour > 23)
+					set_error_and_return_default("expected hour between 0 and 23 (inclusive), saw "sv, hour);
+				set_error_and_return_if_eof({});
+
+				// ':'
+				if (*cp != U':')
+					set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
+				advance_and_return_if_error_or_eof({});
+
+				// "MM"
+				if (!consume_digit_sequence(digits, 2u))
+					set_error_and_return_default("expected 2-digit minute, saw '"sv, to_sv(cp), "'"sv);
+				const auto minute = digits[1] + digits[0] * 10;
+				if (minute > 59)
+					set_error_and_return_default("expected minute between 0 and 59 (inclusive), saw "sv, minute);
+				offset.minutes = static_cast<decltype(offset.minutes)>((hour * 60 + minute) * sign);
+			}
+
+			if (!is_eof() && !is_value_terminator(*cp))
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+
+			return { date, time, offset };
+		}
+
+		template <typename T>
+		TOML_NODISCARD
+		parsed_value make_value(T&& val)
+		{
+			if (!discarding_values)
+				return parsed_value{ node_ptr{ new value{ static_cast<T&&>(val) } } };
+
+			auto& scratch_val = scratch.get<native_type_of<T>>();
+			scratch_val		  = static_cast<T&&>(val);
+			scratch_val.flags(value_flags::none);
+			return parsed_value{ scratch_val };
+		}
+
+		TOML_NODISCARD
+		parsed_value parse_array();
+
+		TOML_NODISCARD
+		parsed_value parse_inline_table();
+
+		// forgets the dotted key tables in a table (and beneath them), e.g. once the inline table they were in ends.
+		void forget_dotted_key_tables(const table& tbl) noexcept
+		{
+			for (auto&& [_, child] : tbl)
+			{
+				if (auto child_tbl = child.as_table(); child_tbl && dotted_key_tables.erase(child_tbl))
+					forget_dotted_key_tables(*child_tbl);
+			}
+		}
+
+		// lazy documents: skips over the value if it can be deferred (see skim_value()), adding its key and the span
+		// of its text to value_keys instead of putting it in the tree. returns false if it should be parsed as normal.
+		bool skip_value(table& tbl, key& k)
+		{
+			return_if_error(true);
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(skipping_values);
+			TOML_ASSERT_ASSUME(!recording);
+
+			const auto raw	  = reader.raw_span();
+			const auto extent = raw.empty() ? deferred_extent{} : skim_value(raw.data(), raw.data() + raw.length());
+			if (!extent.length)
+				return false;
+
+			const auto begin_pos = cp->position;
+			cp					 = reader.skip_lines(extent.length);
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
+			{
+				err = std::move(reader.error());
+				return true;
+			}
+#endif
+
+			prev_pos = reader.position();
+			prev_pos.column--;
+
+			add_value_key(tbl, std::move(k), extent.type, raw.substr(0, extent.length), begin_pos);
+			return true;
+		}
+
+		TOML_NODISCARD
+		parsed_value parse_value_known_prefixes()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(!is_control_character(*cp));
+			TOML_ASSERT_ASSUME(*cp != U'_');
+
+			switch (cp->value)
+			{
+				// arrays
+				case U'[': return parse_array();
+
+				// inline tables
+				case U'{': return parse_inline_table();
+
+				// floats beginning with '.'
+				case U'.': return make_value(parse_float());
+
+				// strings
+				case U'"': [[fallthrough]];
+				case U'\'': return make_value(parse_string().value);
+
+				default:
+				{
+					const auto cp_upper = static_cast<uint_least32_t>(cp->value) & ~0x20u;
+
+					// bools
+					if (cp_upper == 70u || cp_upper == 84u) // F or T
+						return make_value(parse_boolean());
+
+					// inf/nan
+					else if (cp_upper == 73u || cp_upper == 78u) // I or N
+						return make_value(parse_inf_or_nan());
+
+					else
+						return {};
+				}
+			}
+			TOML_UNREACHABLE;
+		}
+
+		TOML_NODISCARD
+		parsed_value parse_value()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(!is_value_terminator(*cp));
+			push_parse_scope("value"sv);
+
+			const depth_counter_scope depth_counter{ nested_values };
+			if TOML_UNLIKELY(nested_values > max_nested_values)
+				set_error_and_return_default("exceeded maximum nested value depth of "sv,
+											 max_nested_values,
+											 " (TOML_MAX_NESTED_VALUES)"sv);
+
+			// check if it begins with some control character
+			// (note that this will also fail for whitespace but we're assuming we've
+			// called consume_leading_whitespace() before calling parse_value())
+			if TOML_UNLIKELY(is_control_character(*cp))
+				set_error_and_return_default("unexpected control character"sv);
+
+			// underscores at the beginning
+			else if (*cp == U'_')
+				set_error_and_return_default("values may not begin with underscores"sv);
+
+			const auto begin_pos = cp->position;
+			parsed_value val;
+
+			do
+			{
+				TOML_ASSERT_ASSUME(!is_control_character(*cp));
+				TOML_ASSERT_ASSUME(*cp != U'_');
+
+				// detect the value type and parse accordingly,
+				// starting with value types that can be detected
+				// unambiguously from just one character.
+
+				val = parse_value_known_prefixes();
+				return_if_error({});
+				if (val)
+					break;
+
+				// value types from here down require more than one character to unambiguously identify
+				// so scan ahead and collect a set of value 'traits'.
+				enum TOML_CLOSED_FLAGS_ENUM value_traits : int
+				{
+					has_nothing	 = 0,
+					has_digits	 = 1,
+					has_b		 = 1 << 1, // as second char only (0b)
+					has_e		 = 1 << 2, // only float exponents
+					has_o		 = 1 << 3, // as second char only (0o)
+					has_p		 = 1 << 4, // only hexfloat exponents
+					has_t		 = 1 << 5,
+					has_x		 = 1 << 6, // as second or third char only (0x, -0x, +0x)
+					has_z		 = 1 << 7,
+					has_colon	 = 1 << 8,
+					has_plus	 = 1 << 9,
+					has_minus	 = 1 << 10,
+					has_dot		 = 1 << 11,
+					begins_sign	 = 1 << 12,
+					begins_digit = 1 << 13,
+					begins_zero	 = 1 << 14,
+					signs_msk  = has_plus | has_minus,
+					bdigit_msk = has_digits | begins_digit,
+					bzero_msk  = bdigit_msk | begins_zero,
+				};
+				value_traits traits	 = has_nothing;
+				const auto has_any	 = [&](auto t) noexcept { return (traits & t) != has_nothing; };
+				const auto has_none	 = [&](auto t) noexcept { return (traits & t) == has_nothing; };
+				const auto add_trait = [&](auto t) noexcept { traits = static_cast<value_traits>(traits | t); };
+
+				// examine the first character to get the 'begins with' traits
+				// (good fail-fast opportunity; all the remaining types begin with numeric digits or signs)
+				if (is_decimal_digit(*cp))
+				{
+					add_trait(begins_digit);
+					if (*cp == U'0')
+						add_trait(begins_zero);
+				}
+				else if (is_match(*cp, U'+', U'-'))
+					add_trait(begins_sign);
+				else
+					break;
+
+				// scan the rest of the value to determine the remaining traits
+				// (only the first few characters are needed verbatim; the rest just contribute traits)
+				char32_t chars[16];
+				size_t char_count = {}, advance_count = {};
+				bool eof_while_scanning = false;
+				const auto examine		= [&](char32_t c) noexcept
+				{
+					if (c == U'_')
+						return;
+
+					if (char_count < sizeof(chars) / sizeof(chars[0]))
+						chars[char_count] = c;
+					char_count++;
+
+					if (is_decimal_digit(c))
+						add_trait(has_digits);
+					else if (is_ascii_letter(c))
+					{
+						TOML_ASSERT_ASSUME((c >= U'a' && c <= U'z') || (c >= U'A' && c <= U'Z'));
+						switch (static_cast<char32_t>(c | 32u))
+						{
+							case U'b':
+								if (char_count == 2u && has_any(begins_zero))
+									add_trait(has_b);
+								break;
+
+							case U'e':
+								if (char_count > 1u && has_none(has_b | has_o | has_p | has_t | has_x | has_z | has_colon)
+									&& (has_none(has_plus | has_minus) || has_any(begins_sign)))
+									add_trait(has_e);
+								break;
+
+							case U'o':
+								if (char_count == 2u && has_any(begins_zero))
+									add_trait(has_o);
+								break;
+
+							case U'p':
+								if (has_any(has_x))
+									add_trait(has_p);
+								break;
+
+							case U'x':
+								if ((char_count == 2u && has_any(begins_zero))
+									|| (char_count == 3u && has_any(begins_sign) && chars[1] == U'0'))
+									add_trait(has_x);
+								break;
+
+							case U't': add_trait(has_t); break;
+							case U'z': add_trait(has_z); break;
+						}
+					}
+					else if (c <= U':')
+					{
+						TOML_ASSERT_ASSUME(c < U'0' || c > U'9');
+						switch (c)
+						{
+							case U'+': add_trait(has_plus); break;
+							case U'-': add_trait(has_minus); break;
+							case U'.': add_trait(has_dot); break;
+							case U':': add_trait(has_colon); break;
+						}
+					}
+				};
+
+				// a date followed by a space could be a date-time with a space instead of a T.
+				const auto could_be_spaced_date_time = [&]() noexcept
 				{
-					if (!prev || !is_decimal_digit(*prev))
-						set_error_and_return_default("underscores may only follow digits"sv);
+					return char_count == 10u								 //
+						&& (traits | begins_zero) == (bzero_msk | has_minus) //
+						&& chars[4] == U'-'									 //
+						&& chars[7] == U'-';
+				};
+
+				// when the whole document is in memory the value can be classified straight from the source without
+				// moving the reader, so there's nothing to rewind afterwards (and no limit on how far ahead we can look).
+				// anything that isn't plain ascii is left to the codepoint-by-codepoint scan below.
+				const auto begin_traits = traits;
+				const auto raw			= reader.raw_span();
+				const auto scan_raw		= [&](size_t& pos) noexcept
+				{
+					for (; pos < raw.length(); pos++)
+					{
+						const auto c = static_cast<unsigned char>(raw[pos]);
+						if (c >= 0x80u)
+							return false;
+						if (is_value_terminator(static_cast<char32_t>(c)))
+							break;
+						examine(static_cast<char32_t>(c));
+					}
+					return true;
+				};
+				bool classified = false;
+				if (size_t pos = {}; !raw.empty() && scan_raw(pos))
+				{
+					classified		   = true;
+					eof_while_scanning = pos == raw.length();
+
+					// (how far the scan below would have read, terminator included)
+					size_t read_end = impl::min(pos + 1u, raw.length());
+
+					// force further scanning if this could have been a date-time with a space instead of a T
+					if (could_be_spaced_date_time() && pos < raw.length() && raw[pos] == ' ')
+					{
+						read_end = impl::min(pos + 2u, raw.length());
+						if (read_end - pos == 2u && raw[pos + 1u] >= '0' && raw[pos + 1u] <= '9')
+						{
+							const auto pre_scan_traits = traits;
+							chars[char_count++]		   = U' ';
+							chars[char_count++]		   = static_cast<char32_t>(raw[pos + 1u]);
+							add_trait(has_t);
+
+							pos += 2u;
+							classified = scan_raw(pos);
+							read_end   = impl::min(pos + 1u, raw.length());
+							if (classified && char_count == 12u)
+							{
+								traits	   = pre_scan_traits;
+								char_count = 10u;
+							}
+							else if (classified)
+								eof_while_scanning = pos == raw.length();
+						}
+					}
+
+					if (!classified)
+					{
+						traits	   = begin_traits;
+						char_count = {};
+					}
+
+					// nothing's been read, but an encoding error in what would have been still needs reporting first
+					else if TOML_UNLIKELY(!reader.validate_ahead(read_end))
+					{
+#if !TOML_EXCEPTIONS
+						err = std::move(reader.error());
+#endif
+						return {};
+					}
+				}
+
+				if (!classified)
+				{
+					const auto scan = [&]() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+					{
+						while (advance_count < (utf8_buffered_reader::max_history_length - 1u) && !is_eof()
+							   && !is_value_terminator(*cp))
+						{
+							examine(**cp);
+
+							advance_and_return_if_error();
+							advance_count++;
+							eof_while_scanning = is_eof();
+						}
+					};
+					scan();
+					return_if_error({});
+
+					// force further scanning if this could have been a date-time with a space instead of a T
+					if (could_be_spaced_date_time() && !is_eof() && *cp == U' ')
+					{
+						const auto pre_advance_count = advance_count;
+						const auto pre_scan_traits	 = traits;
+						chars[char_count++]			 = *cp;
+						add_trait(has_t);
+
+						const auto backpedal = [&]() noexcept
+						{
+							go_back(advance_count - pre_advance_count);
+							advance_count = pre_advance_count;
+							traits		  = pre_scan_traits;
+							char_count	  = 10u;
+						};
+
+						advance_and_return_if_error({});
+						advance_count++;
+
+						if (is_eof() || !is_decimal_digit(*cp))
+							backpedal();
+						else
+						{
+							chars[char_count++] = *cp;
+
+							advance_and_return_if_error({});
+							advance_count++;
+
+							scan();
+							return_if_error({});
+
+							if (char_count == 12u)
+								backpedal();
+						}
+					}
+
+					// set the reader back to where we started
+					go_back(advance_count);
+				}
+
+				// if after scanning ahead we still only have one value character,
+				// the only valid value type is an integer.
+				if (char_count == 1u)
+				{
+					if (has_any(begins_digit))
+					{
+						val = make_value(static_cast<int64_t>(chars[0] - U'0'));
+						advance(); // skip the digit
+						break;
+					}
+
+					// anything else would be ambiguous.
+					else
+						set_error_and_return_default(eof_while_scanning ? "encountered end-of-file"sv
+																		: "could not determine value type"sv);
+				}
+
+				// now things that can be identified from two or more characters
+				return_if_error({});
+				TOML_ASSERT_ASSUME(char_count >= 2u);
+
+				// do some 'fuzzy matching' where there's no ambiguity, since that allows the specific
+				// typed parse functions to take over and show better diagnostics if there's an issue
+				// (as opposed to the fallback "could not determine type" message)
+				if (has_any(has_p))
+					val = make_value(parse_hex_float());
+				else if (has_any(has_x | has_o | has_b))
+				{
+					int64_t i;
+					value_flags flags;
+					if (has_any(has_x))
+					{
+						i	  = parse_integer<16>();
+						flags = value_flags::format_as_hexadecimal;
+					}
+					else if (has_any(has_o))
+					{
+						i	  = parse_integer<8>();
+						flags = value_flags::format_as_octal;
+					}
+					else // has_b
+					{
+						i	  = parse_integer<2>();
+						flags = value_flags::format_as_binary;
+					}
+					return_if_error({});
+
+					val = make_value(i);
+					val->ref_cast<int64_t>().flags(flags);
+				}
+				else if (has_any(has_e) || (has_any(begins_digit) && chars[1] == U'.'))
+					val = make_value(parse_float());
+				else if (has_any(begins_sign))
+				{
+					// single-digit signed integers
+					if (char_count == 2u && has_any(has_digits))
+					{
+						val = make_value(static_cast<int64_t>(chars[1] - U'0') * (chars[0] == U'-' ? -1LL : 1LL));
+						advance(); // skip the sign
+						advance(); // skip the digit
+						break;
+					}
+
+					// simple signed floats (e.g. +1.0)
+					if (is_decimal_digit(chars[1]) && chars[2] == U'.')
+						val = make_value(parse_float());
+
+					// signed infinity or nan
+					else if (is_match(chars[1], U'i', U'n', U'I', U'N'))
+						val = make_value(parse_inf_or_nan());
+				}
+
+				return_if_error({});
+				if (val)
+					break;
+
+				// match trait masks against what they can match exclusively.
+				// all correct value parses will come out of this list, so doing this as a switch is likely to
+				// be a better friend to the optimizer on the success path (failure path can be slow but that
+				// doesn't matter much).
+				switch (unwrap_enum(traits))
+				{
+					// binary integers
+					// 0b10
+					case bzero_msk | has_b:
+						val = make_value(parse_integer<2>());
+						val->ref_cast<int64_t>().flags(value_flags::format_as_binary);
+						break;
+
+					// octal integers
+					// 0o10
+					case bzero_msk | has_o:
+						val = make_value(parse_integer<8>());
+						val->ref_cast<int64_t>().flags(value_flags::format_as_octal);
+						break;
+
+					// decimal integers
+					// 00
+					// 10
+					// +10
+					// -10
+					case bzero_msk: [[fallthrough]];
+					case bdigit_msk: [[fallthrough]];
+					case begins_sign | has_digits | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_plus:
+					{
+						// if the value was so long we exhausted the history buffer it's reasonable to assume
+						// there was more and the value's actual type is impossible to identify without making the
+						// buffer bigger (since it could have actually been a float), so emit an error.
+						//
+						// (this will likely only come up during fuzzing and similar scenarios)
+						static constexpr size_t max_numeric_value_length =
+							utf8_buffered_reader::max_history_length - 2u;
+						if TOML_UNLIKELY(!eof_while_scanning && advance_count > max_numeric_value_length)
+							set_error_and_return_default("numeric value too long to identify type - cannot exceed "sv,
+														 max_numeric_value_length,
+														 " characters"sv);
+
+						val = make_value(parse_integer<10>());
+						break;
+					}
+
+					// hexadecimal integers
+					// 0x10
+					case bzero_msk | has_x:
+						val = make_value(parse_integer<16>());
+						val->ref_cast<int64_t>().flags(value_flags::format_as_hexadecimal);
+						break;
+
+					// decimal floats
+					// 0e1
+					// 0e-1
+					// 0e+1
+					// 0.0
+					// 0.0e1
+					// 0.0e-1
+					// 0.0e+1
+					case bzero_msk | has_e: [[fallthrough]];
+					case bzero_msk | has_e | has_minus: [[fallthrough]];
+					case bzero_msk | has_e | has_plus: [[fallthrough]];
+					case bzero_msk | has_dot: [[fallthrough]];
+					case bzero_msk | has_dot | has_e: [[fallthrough]];
+					case bzero_msk | has_dot | has_e | has_minus: [[fallthrough]];
+					case bzero_msk | has_dot | has_e | has_plus: [[fallthrough]];
+					// 1e1
+					// 1e-1
+					// 1e+1
+					// 1.0
+					// 1.0e1
+					// 1.0e-1
+					// 1.0e+1
+					case bdigit_msk | has_e: [[fallthrough]];
+					case bdigit_msk | has_e | has_minus: [[fallthrough]];
+					case bdigit_msk | has_e | has_plus: [[fallthrough]];
+					case bdigit_msk | has_dot: [[fallthrough]];
+					case bdigit_msk | has_dot | has_e: [[fallthrough]];
+					case bdigit_msk | has_dot | has_e | has_minus: [[fallthrough]];
+					case bdigit_msk | has_dot | has_e | has_plus: [[fallthrough]];
+					// +1e1
+					// +1.0
+					// +1.0e1
+					// +1.0e+1
+					// +1.0e-1
+					// -1.0e+1
+					case begins_sign | has_digits | has_e | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_e | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_e | signs_msk: [[fallthrough]];
+					// -1e1
+					// -1e+1
+					// +1e-1
+					// -1.0
+					// -1.0e1
+					// -1.0e-1
+					case begins_sign | has_digits | has_e | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_e | signs_msk: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_dot | has_e | has_minus:
+						val = make_value(parse_float());
+						break;
+
+					// hexadecimal floats
+					// 0x10p0
+					// 0x10p-0
+					// 0x10p+0
+					case bzero_msk | has_x | has_p: [[fallthrough]];
+					case bzero_msk | has_x | has_p | has_minus: [[fallthrough]];
+					case bzero_msk | has_x | has_p | has_plus: [[fallthrough]];
+					// -0x10p0
+					// -0x10p-0
+					// +0x10p0
+					// +0x10p+0
+					// -0x10p+0
+					// +0x10p-0
+					case begins_sign | has_digits | has_x | has_p | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_x | has_p | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_x | has_p | signs_msk: [[fallthrough]];
+					// 0x10.1p0
+					// 0x10.1p-0
+					// 0x10.1p+0
+					case bzero_msk | has_x | has_dot | has_p: [[fallthrough]];
+					case bzero_msk | has_x | has_dot | has_p | has_minus: [[fallthrough]];
+					case bzero_msk | has_x | has_dot | has_p | has_plus: [[fallthrough]];
+					// -0x10.1p0
+					// -0x10.1p-0
+					// +0x10.1p0
+					// +0x10.1p+0
+					// -0x10.1p+0
+					// +0x10.1p-0
+					case begins_sign | has_digits | has_x | has_dot | has_p | has_minus: [[fallthrough]];
+					case begins_sign | has_digits | has_x | has_dot | has_p | has_plus: [[fallthrough]];
+					case begins_sign | has_digits | has_x | has_dot | has_p | signs_msk:
+						val = make_value(parse_hex_float());
+						break;
 
-					prev = cp;
-					advance_and_return_if_error_or_eof({});
-					continue;
+					// times
+					// HH:MM
+					// HH:MM:SS
+					// HH:MM:SS.FFFFFF
+					case bzero_msk | has_colon: [[fallthrough]];
+					case bzero_msk | has_colon | has_dot: [[fallthrough]];
+					case bdigit_msk | has_colon: [[fallthrough]];
+					case bdigit_msk | has_colon | has_dot: val = make_value(parse_time()); break;
+
+					// local dates
+					// YYYY-MM-DD
+					case bzero_msk | has_minus: [[fallthrough]];
+					case bdigit_msk | has_minus: val = make_value(parse_date()); break;
+
+					// date-times
+					// YYYY-MM-DDTHH:MM
+					// YYYY-MM-DDTHH:MM-HH:MM
+					// YYYY-MM-DDTHH:MM+HH:MM
+					// YYYY-MM-DD HH:MM
+					// YYYY-MM-DD HH:MM-HH:MM
+					// YYYY-MM-DD HH:MM+HH:MM
+					// YYYY-MM-DDTHH:MM:SS
+					// YYYY-MM-DDTHH:MM:SS-HH:MM
+					// YYYY-MM-DDTHH:MM:SS+HH:MM
+					// YYYY-MM-DD HH:MM:SS
+					// YYYY-MM-DD HH:MM:SS-HH:MM
+					// YYYY-MM-DD HH:MM:SS+HH:MM
+					case bzero_msk | has_minus | has_colon | has_t: [[fallthrough]];
+					case bzero_msk | signs_msk | has_colon | has_t: [[fallthrough]];
+					case bdigit_msk | has_minus | has_colon | has_t: [[fallthrough]];
+					case bdigit_msk | signs_msk | has_colon | has_t: [[fallthrough]];
+					// YYYY-MM-DDTHH:MM:SS.FFFFFF
+					// YYYY-MM-DDTHH:MM:SS.FFFFFF-HH:MM
+					// YYYY-MM-DDTHH:MM:SS.FFFFFF+HH:MM
+					// YYYY-MM-DD HH:MM:SS.FFFFFF
+					// YYYY-MM-DD HH:MM:SS.FFFFFF-HH:MM
+					// YYYY-MM-DD HH:MM:SS.FFFFFF+HH:MM
+					case bzero_msk | has_minus | has_colon | has_dot | has_t: [[fallthrough]];
+					case bzero_msk | signs_msk | has_colon | has_dot | has_t: [[fallthrough]];
+					case bdigit_msk | has_minus | has_colon | has_dot | has_t: [[fallthrough]];
+					case bdigit_msk | signs_msk | has_colon | has_dot | has_t: [[fallthrough]];
+					// YYYY-MM-DDTHH:MMZ
+					// YYYY-MM-DD HH:MMZ
+					// YYYY-MM-DDTHH:MM:SSZ
+					// YYYY-MM-DD HH:MM:SSZ
+					// YYYY-MM-DDTHH:MM:SS.FFFFFFZ
+					// YYYY-MM-DD HH:MM:SS.FFFFFFZ
+					case bzero_msk | has_minus | has_colon | has_z | has_t: [[fallthrough]];
+					case bzero_msk | has_minus | has_colon | has_dot | has_z | has_t: [[fallthrough]];
+					case bdigit_msk | has_minus | has_colon | has_z | has_t: [[fallthrough]];
+					case bdigit_msk | has_minus | has_colon | has_dot | has_z | has_t:
+						val = make_value(parse_date_time());
+						break;
 				}
-				else if TOML_UNLIKELY(prev && *prev == U'_' && !is_decimal_digit(*cp))
-					set_error_and_return_default("underscores must be followed by digits"sv);
-				else if TOML_UNLIKELY(length == sizeof(chars))
-					set_error_and_return_default("exceeds length limit of "sv,
-												 sizeof(chars),
-												 " digits"sv,
-												 (seen_exponent ? ""sv : " (consider using exponent notation)"sv));
-				else if (*cp == U'.')
-				{
-					// .1
-					// -.1
-					// +.1 (no integer part)
-					if (!first_integer_part)
-						set_error_and_return_default("expected decimal digit, saw '.'"sv);
+			}
+			while (false);
 
-					// 1.0e+.10 (exponent cannot have '.')
-					else if (seen_exponent)
-						set_error_and_return_default("expected exponent decimal digit or sign, saw '.'"sv);
+			if (!val)
+			{
+				set_error_at(begin_pos, "could not determine value type"sv);
+				return_after_error({});
+			}
 
-					// 1.0.e+.10
-					// 1..0
-					// (multiple '.')
-					else if (seen_decimal)
-						set_error_and_return_default("expected decimal digit or exponent, saw '.'"sv);
+			set_region(*val.ptr, begin_pos, current_position(1));
 
-					seen_decimal = true;
-				}
-				else if (is_match(*cp, U'e', U'E'))
-				{
-					if (prev && !is_decimal_digit(*prev))
-						set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+			// (arrays and inline tables emit their own events as they're parsed)
+			if (events && val->is_value())
+				events->on_value(*val.ptr);
 
-					// 1.0ee+10 (multiple 'e')
-					else if (seen_exponent)
-						set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+			return val;
+		}
 
-					seen_decimal  = true; // implied
-					seen_exponent = true;
-				}
-				else if (is_match(*cp, U'+', U'-'))
-				{
-					// 1.-0 (sign in mantissa)
-					if (!seen_exponent)
-						set_error_and_return_default("expected decimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
+		TOML_NEVER_INLINE
+		bool parse_key()
+		{
+			return_if_error({});
+			assert_not_eof();
+			TOML_ASSERT_ASSUME(is_bare_key_character(*cp) || is_string_delimiter(*cp));
+			push_parse_scope("key"sv);
 
-					// 1.0e1-0 (misplaced exponent sign)
-					else if (!is_match(*prev, U'e', U'E'))
-						set_error_and_return_default("expected exponent digit, saw '"sv, to_sv(*cp), "'"sv);
-				}
-				else if (is_decimal_digit(*cp))
+			key_buffer.clear();
+			recording_whitespace = false;
+
+			while (!is_error())
+			{
+				std::string_view key_segment;
+				const auto key_begin = current_position();
+
+				// bare_key_segment
+				if (is_bare_key_character(*cp))
+					key_segment = parse_bare_key_segment();
+
+				// "quoted key segment"
+				else if (is_string_delimiter(*cp))
 				{
-					if (!seen_decimal)
+					const auto begin_pos = cp->position;
+
+					recording_whitespace = true;
+					parsed_string str	 = parse_string();
+					recording_whitespace = false;
+					return_if_error({});
+
+					if (str.was_multi_line)
 					{
-						if (!first_integer_part)
-							first_integer_part = static_cast<char>(cp->bytes[0]);
-						else if (first_integer_part == '0')
-							set_error_and_return_default("leading zeroes are prohibited"sv);
+						set_error_at(begin_pos,
+									 "multi-line strings are prohibited in "sv,
+									 key_buffer.empty() ? ""sv : "dotted "sv,
+									 "keys"sv);
+						return_after_error({});
 					}
+					else
+						key_segment = str.value;
+				}
+
+				// ???
+				else
+					set_error_and_return_default("expected bare key starting character or string delimiter, saw '"sv,
+												 to_sv(*cp),
+												 "'"sv);
+
+				const auto key_end = current_position();
+
+				// whitespace following the key segment
+				consume_leading_whitespace();
+
+				// store segment
+				key_buffer.push_back(key_segment, key_begin, key_end);
+
+				if TOML_UNLIKELY(key_buffer.size() > max_dotted_keys_depth)
+					set_error_and_return_default("exceeded maximum dotted keys depth of "sv,
+												 max_dotted_keys_depth,
+												 " (TOML_MAX_DOTTED_KEYS_DEPTH)"sv);
+
+				// eof or no more key to come
+				if (is_eof() || *cp != U'.')
+					break;
+
+				// was a dotted key - go around again
+				advance_and_return_if_error_or_eof({});
+				consume_leading_whitespace();
+				set_error_and_return_if_eof({});
+			}
+			return_if_error({});
+
+			return true;
+		}
+
+		// the source path is owned by the root table; everything else in the document borrows it, so nodes and keys
+		// can be created and destroyed without touching its reference count (see source_path_ptr). sax_handlers may
+		// hang on to the keys and values they're given, so they get regions that own it.
+		void init_source_path()
+		{
+			const auto& path = reader.source_path();
+			region_path		 = path;
+
+#if TOML_ENABLE_SOURCES
+			root.source_ = {};
+			if (track_sources)
+				root.source_ = { prev_pos, prev_pos, path };
+#endif
+		}
+
+		// the source region of a node or key (or an empty one if they aren't being tracked)
+		TOML_NODISCARD
+		source_region make_region(source_position begin, source_position end) const
+		{
+			if (!track_sources)
+				return {};
+			if (events)
+				return { begin, end, region_path };
+			return { begin, end, source_path_ptr{ impl::borrow_source_path_t{}, region_path } };
+		}
+
+		void set_region(node& nde, source_position begin, source_position end) const
+		{
+#if TOML_ENABLE_SOURCES
+			nde.source_ = make_region(begin, end);
+#else
+			TOML_UNUSED(nde);
+			TOML_UNUSED(begin);
+			TOML_UNUSED(end);
+#endif
+		}
+
+		TOML_NODISCARD
+		key make_key(size_t segment_index)
+		{
+			TOML_ASSERT(key_buffer.size() > segment_index);
+
+			const auto str = key_buffer[segment_index];
+			auto src	   = make_region(key_buffer.starts[segment_index], key_buffer.ends[segment_index]);
+
+			// keys too long to be stored inline are interned, so tables with the same keys share their storage
+			if (str.length() <= key_string::max_inline_length)
+				return key{ str, std::move(src) };
+
+			// (a key_pool is shared with other threads, so it's only asked for keys the document hasn't seen yet)
+			const auto hash = decltype(document_keys)::hash(str);
+			if (interned_keys)
+			{
+				return key{ key_string{ document_keys.intern(str,
+															 hash,
+															 [&](std::string_view s)
+															 { return interned_keys->state_->intern(s, hash); }) },
+							std::move(src) };
+			}
+			return key{ key_string{ document_keys.intern(str, hash, shared_key_chars::create) }, std::move(src) };
+		}
+
+		// the key buffer as a list of keys for sax_handler::on_key() and sax_handler::on_table_header()
+		TOML_NODISCARD
+		buffer_vector<key>& make_event_keys()
+		{
+			event_keys.clear();
+			for (size_t i = 0; i < key_buffer.size(); i++)
+				event_keys.push_back(make_key(i));
+			return event_keys;
+		}
+
+		// records a value that isn't going in the tree (see insert_parsed_value() and skip_value())
+		void add_value_key(table& tbl,
+						   key&& k,
+						   node_type type,
+						   std::string_view source = {},
+						   source_position position = {})
+		{
+			// (an implicit table given a value can't be defined by a header any more, which leaves it no different
+			// to a dotted key table; see parse_table_header())
+			if (!implicit_tables.empty() && implicit_tables.erase(&tbl))
+				dotted_key_tables.insert(&tbl);
+
+			value_keys->insert(&tbl == &root ? nullptr : &tbl, std::move(k), type, source, position);
+		}
+
+		// the tree is still needed when emitting events (or discarding values outside of keep_paths) so redefinitions
+		// etc. are diagnosed exactly as they would be otherwise, but only the tables go in it; everything else is
+		// parsed into a scratch value and just has its key and type added to value_keys.
+		void insert_parsed_value(table& tbl, table::const_iterator hint, key&& k, parsed_value&& val)
+		{
+			if (!discarding_values || val.owned)
+			{
+				tbl.emplace_hint<node_ptr>(hint, std::move(k), std::move(val.owned));
+				return;
+			}
+
+			add_value_key(tbl, std::move(k), val->type());
+		}
+
+		// the type of the value with the given key in a table if it isn't in the tree (see add_value_key()),
+		// or node_type::none if there isn't one
+		TOML_PURE_GETTER
+		node_type find_value_key(const table& tbl, std::string_view k) noexcept
+		{
+			const auto val = value_keys->find(&tbl == &root ? nullptr : &tbl, k);
+			return val ? val->type : node_type::none;
+		}
+
+		// emits sax_handler::on_key() and returns the last segment (already copied for the handler)
+		TOML_NODISCARD
+		key key_parsed()
+		{
+			auto& keys = make_event_keys();
+			events->on_key(keys.data(), keys.size());
+			return std::move(keys.back());
+		}
+
+		static constexpr size_t filter_diverged = static_cast<size_t>(-1);
+
+		// path-filtered parsing: advances filter_depths past the next component of a table header's path
+		// (a key, or the index of an element in an array-of-tables).
+		// returns true if the table there (and everything beneath it) is to be kept regardless.
+		template <typename T>
+		bool filter_advance(const T& component) noexcept
+		{
+			TOML_ASSERT(keep_paths);
+
+			for (size_t i = 0; i < keep_paths->size(); i++)
+			{
+				auto& depth = filter_depths[i];
+				if (depth == filter_diverged)
+					continue;
+
+				const auto& path = (*keep_paths)[i];
+				TOML_ASSERT(depth < path.size());
+				if constexpr (std::is_same_v<T, size_t>)
+				{
+					if (path[depth].type() != path_component_type::array_index || path[depth].index() != component)
+						depth = filter_diverged;
 				}
 				else
-					set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+				{
+					if (path[depth].type() != path_component_type::key || path[depth].key() != component)
+						depth = filter_diverged;
+				}
 
-				chars[length++] = static_cast<char>(cp->bytes[0]);
-				prev			= cp;
-				advance_and_return_if_error({});
+				if (depth != filter_diverged && ++depth == path.size())
+					filter_keep_all = true;
 			}
+			return filter_keep_all;
+		}
 
-			// sanity-check ending state
-			if (prev)
+		// path-filtered parsing: goes back to matching keep_paths from the root.
+		void reset_filter() noexcept
+		{
+			TOML_ASSERT(keep_paths);
+
+			filter_keep_all = false;
+			for (size_t i = 0; i < keep_paths->size(); i++)
 			{
-				if (*prev == U'_')
-				{
-					set_error_and_return_if_eof({});
-					set_error_and_return_default("underscores must be followed by digits"sv);
-				}
-				else if (is_match(*prev, U'e', U'E', U'+', U'-', U'.'))
+				filter_depths[i] = 0u;
+				filter_keep_all	 = filter_keep_all || (*keep_paths)[i].empty();
+			}
+		}
+
+		// path-filtered parsing: true if none of keep_paths lead through the current table header any more.
+		TOML_PURE_GETTER
+		bool filter_diverged_everywhere() const noexcept
+		{
+			for (auto depth : filter_depths)
+				if (depth != filter_diverged)
+					return false;
+			return true;
+		}
+
+		enum class header_filter : unsigned char
+		{
+			keep,
+			skip_contents, // (the array-of-tables element still gets created so the others keep their indices)
+			skip
+		};
+
+		// path-filtered parsing: matches the table header in the key buffer against keep_paths.
+		// this happens before anything is created so skipped tables are never added to the tree.
+		TOML_NODISCARD
+		header_filter filter_table_header(bool is_arr) noexcept
+		{
+			TOML_ASSERT(keep_paths);
+			TOML_ASSERT(!key_buffer.empty());
+
+			reset_filter();
+			if (filter_keep_all)
+				return header_filter::keep;
+
+			const table* parent = &root;
+			for (size_t i = 0, e = key_buffer.size(); i < e; i++)
+			{
+				const bool last = i + 1u == e;
+				if (filter_advance(key_buffer[i]))
+					return header_filter::keep;
+				if (filter_diverged_everywhere())
+					return header_filter::skip;
+
+				// (anything that doesn't exist yet will be an implicit table, or the header's table itself)
+				const node* child = parent ? parent->get(key_buffer[i]) : nullptr;
+				const array* arr  = child ? child->as_array() : nullptr;
+				if (arr && !table_arrays.contains(arr))
+					arr = nullptr;
+
+				if (arr || (last && is_arr))
 				{
-					set_error_and_return_if_eof({});
-					set_error_and_return_default("expected decimal digit, saw '"sv, to_sv(*cp), "'"sv);
+					const size_t count = arr ? arr->size() : 0u;
+					if (filter_advance(last && is_arr ? count : count - 1u))
+						return header_filter::keep;
+					if (filter_diverged_everywhere())
+						return last ? header_filter::skip_contents : header_filter::skip;
 				}
+
+				parent = arr && !last ? arr->back().as_table() : (child ? child->as_table() : nullptr);
 			}
 
-			// convert to double
-			double result;
-#if TOML_FLOAT_CHARCONV
+			// the header leads to one or more of the kept paths, so it's only their subtrees that get kept
+			return header_filter::keep;
+		}
+
+		// path-filtered parsing: true if the key-value pair in the key buffer is at, above or beneath one of
+		// keep_paths (relative to the current table).
+		TOML_PURE_GETTER
+		bool filter_keeps_key() const noexcept
+		{
+			TOML_ASSERT(keep_paths);
+
+			if (filter_keep_all)
+				return true;
+
+			for (size_t i = 0; i < keep_paths->size(); i++)
 			{
-				auto fc_result = std::from_chars(chars, chars + length, result);
-				switch (fc_result.ec)
-				{
-					TOML_LIKELY_CASE
-					case std::errc{}: // ok
-						return result * sign;
+				auto depth = filter_depths[i];
+				if (depth == filter_diverged)
+					continue;
 
-					case std::errc::invalid_argument:
-						set_error_and_return_default("'"sv,
-													 std::string_view{ chars, length },
-													 "' could not be interpreted as a value"sv);
-						break;
+				const auto& path = (*keep_paths)[i];
+				bool matched	 = true;
+				for (size_t k = 0; matched && k < key_buffer.size() && depth < path.size(); k++, depth++)
+					matched = path[depth].type() == path_component_type::key && path[depth].key() == key_buffer[k];
+				if (matched)
+					return true;
+			}
+			return false;
+		}
 
-					case std::errc::result_out_of_range:
-						set_error_and_return_default("'"sv,
-													 std::string_view{ chars, length },
-													 "' is not representable in 64 bits"sv);
-						break;
+		// path-filtered parsing: a skipped table header doesn't add anything to the tree, but it still can't redefine
+		// anything that's already there (or a value that was discarded), so its path is checked for as far as it goes.
+		void check_skipped_table_header(bool is_arr, source_position header_begin_pos)
+		{
+			const table* parent = &root;
+			for (size_t i = 0, e = key_buffer.size(); i < e; i++)
+			{
+				const bool last				   = i + 1u == e;
+				const std::string_view segment = key_buffer[i];
+				const node* child			   = parent->get(segment);
+				const auto type				   = child ? child->type() : find_value_key(*parent, segment);
 
-					default: //??
-						set_error_and_return_default("an unspecified error occurred while trying to interpret '"sv,
-													 std::string_view{ chars, length },
-													 "' as a value"sv);
+				// (nothing beneath a table that doesn't exist yet can be a redefinition)
+				if (type == node_type::none)
+					return;
+
+				if (auto tbl = child ? child->as_table() : nullptr)
+				{
+					if (!last)
+					{
+						if (tbl->is_inline())
+						{
+							set_error("cannot insert '"sv, to_sv(recording_buffer), "' into existing inline table"sv);
+							return;
+						}
+						parent = tbl;
+						continue;
+					}
+
+					// (see the promotion of implicit tables in parse_table_header())
+					if (!is_arr && implicit_tables.contains(tbl))
+					{
+						bool ok = true;
+						for (auto& [_, grandchild] : *tbl)
+							ok = ok && (grandchild.is_table() || grandchild.is_array_of_tables());
+						if (ok)
+							return;
+					}
+				}
+				else if (auto arr = child ? child->as_array() : nullptr; arr && table_arrays.contains(arr))
+				{
+					if (!last)
+					{
+						parent = &arr->back().ref_cast<table>();
+						continue;
+					}
+					if (is_arr)
+						return;
 				}
+
+				const auto pos = last ? header_begin_pos : current_position(1);
+				if (last && !is_arr && type == node_type::table && child)
+					set_error_at(pos, "cannot redefine existing table '"sv, to_sv(recording_buffer), "'"sv);
+				else
+					set_error_at(pos,
+								 "cannot redefine existing "sv,
+								 to_sv(type),
+								 " '"sv,
+								 to_sv(recording_buffer),
+								 "' as "sv,
+								 is_arr ? "array-of-tables"sv : "table"sv);
+				return;
 			}
-#else
+		}
+
+		TOML_NODISCARD
+		table* table_header_parsed(table* tbl, bool is_arr)
+		{
+			if (events)
 			{
-				std::stringstream ss;
-				ss.imbue(std::locale::classic());
-				ss.write(chars, static_cast<std::streamsize>(length));
-				if ((ss >> result))
-					return result * sign;
-				else
-					set_error_and_return_default("'"sv,
-												 std::string_view{ chars, length },
-												 "' could not be interpreted as a value"sv);
+				const auto& keys = make_event_keys();
+				events->on_table_header(keys.data(), keys.size(), is_arr);
 			}
-#endif
+			return tbl;
 		}
 
 		TOML_NODISCARD
 		TOML_NEVER_INLINE
-		double parse_hex_float()
+		table* parse_table_header()
 		{
 			return_if_error({});
 			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_match(*cp, U'0', U'+', U'-'));
-			push_parse_scope("hexadecimal floating-point"sv);
+			TOML_ASSERT_ASSUME(*cp == U'[');
+			push_parse_scope("table header"sv);
 
-#if TOML_LANG_UNRELEASED // toml/issues/562 (hexfloats)
+			const source_position header_begin_pos = cp->position;
+			source_position header_end_pos;
+			bool is_arr = false;
 
-			// sign
-			const int sign = *cp == U'-' ? -1 : 1;
-			if (is_match(*cp, U'+', U'-'))
+			// parse header
+			{
+				// skip first '['
 				advance_and_return_if_error_or_eof({});
 
-			// '0'
-			if (*cp != U'0')
-				set_error_and_return_default(" expected '0', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+				// skip past any whitespace that followed the '['
+				const bool had_leading_whitespace = consume_leading_whitespace();
+				set_error_and_return_if_eof({});
 
-			// 'x' or 'X'
-			if (!is_match(*cp, U'x', U'X'))
-				set_error_and_return_default("expected 'x' or 'X', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+				// skip second '[' (if present)
+				if (*cp == U'[')
+				{
+					if (had_leading_whitespace)
+						set_error_and_return_default(
+							"[[array-of-table]] brackets must be contiguous (i.e. [ [ this ] ] is prohibited)"sv);
 
-			// <HEX DIGITS> ([.]<HEX DIGITS>)? [pP] [+-]? <DEC DIGITS>
+					is_arr = true;
+					advance_and_return_if_error_or_eof({});
 
-			// consume value fragments
-			struct fragment
+					// skip past any whitespace that followed the '['
+					consume_leading_whitespace();
+					set_error_and_return_if_eof({});
+				}
+
+				// check for a premature closing ']'
+				if (*cp == U']')
+					set_error_and_return_default("tables with blank bare keys are explicitly prohibited"sv);
+
+				if (!is_bare_key_character(*cp) && !is_string_delimiter(*cp))
+					set_error_and_return_default("expected bare key starting character or string delimiter, saw '"sv,
+												 to_sv(*cp),
+												 "'"sv);
+
+				// get the actual key
+				start_recording();
+				parse_key();
+				stop_recording(1u);
+				return_if_error({});
+
+				// skip past any whitespace that followed the key
+				consume_leading_whitespace();
+				return_if_error({});
+				set_error_and_return_if_eof({});
+
+				// consume the closing ']'
+				if (*cp != U']')
+					set_error_and_return_default("expected ']', saw '"sv, to_sv(*cp), "'"sv);
+				if (is_arr)
+				{
+					advance_and_return_if_error_or_eof({});
+					if (*cp != U']')
+						set_error_and_return_default("expected ']', saw '"sv, to_sv(*cp), "'"sv);
+				}
+				advance_and_return_if_error({});
+				header_end_pos = current_position(1);
+
+				// handle the rest of the line after the header
+				consume_leading_whitespace();
+				if (!is_eof() && !consume_comment() && !consume_line_break())
+					set_error_and_return_default("expected a comment or whitespace, saw '"sv, to_sv(cp), "'"sv);
+			}
+			TOML_ASSERT(!key_buffer.empty());
+
+			// path-filtered parsing: tables outside of keep_paths aren't created at all
+			// (their contents are still parsed, just not kept)
+			bool keep_contents = true;
+			if (keep_paths)
 			{
-				char chars[24];
-				size_t length;
-				double value;
-			};
-			fragment fragments[] = {
-				{}, // mantissa, whole part
-				{}, // mantissa, fractional part
-				{}	// exponent
-			};
-			fragment* current_fragment = fragments;
-			const utf8_codepoint* prev = {};
-			int exponent_sign		   = 1;
-			while (!is_eof() && !is_value_terminator(*cp))
+				const auto filtered = filter_table_header(is_arr);
+				if (filtered == header_filter::skip)
+				{
+					check_skipped_table_header(is_arr, header_begin_pos);
+					return nullptr;
+				}
+				keep_contents = filtered == header_filter::keep;
+			}
+
+			// check if each parent is a table/table array, or can be created implicitly as a table.
+			table* parent = &root;
+			for (size_t i = 0, e = key_buffer.size() - 1u; i < e; i++)
 			{
-				if (*cp == U'_')
+				const std::string_view segment = key_buffer[i];
+				auto pit					   = parent->lower_bound(segment);
+
+				// parent already existed
+				if (pit != parent->end() && pit->first == segment)
 				{
-					if (!prev || !is_hexadecimal_digit(*prev))
-						set_error_and_return_default("underscores may only follow digits"sv);
+					node& p = pit->second;
 
-					prev = cp;
-					advance_and_return_if_error_or_eof({});
-					continue;
+					if (auto tbl = p.as_table())
+					{
+						// adding to closed inline tables is illegal
+						if (tbl->is_inline() && !impl::find(open_inline_tables.begin(), open_inline_tables.end(), tbl))
+							set_error_and_return_default("cannot insert '"sv,
+														 to_sv(recording_buffer),
+														 "' into existing inline table"sv);
+
+						parent = tbl;
+					}
+					else if (auto arr = p.as_array(); arr && table_arrays.contains(arr))
+					{
+						// table arrays are a special case;
+						// the spec dictates we select the most recently declared element in the array.
+						TOML_ASSERT(!arr->empty());
+						TOML_ASSERT(arr->back().is_table());
+						parent = &arr->back().ref_cast<table>();
+					}
+					else
+					{
+						if (!is_arr && p.type() == node_type::table)
+							set_error_and_return_default("cannot redefine existing table '"sv,
+														 to_sv(recording_buffer),
+														 "'"sv);
+						else
+							set_error_and_return_default("cannot redefine existing "sv,
+														 to_sv(p.type()),
+														 " '"sv,
+														 to_sv(recording_buffer),
+														 "' as "sv,
+														 is_arr ? "array-of-tables"sv : "table"sv);
+					}
 				}
-				else if (prev && *prev == U'_' && !is_hexadecimal_digit(*cp))
-					set_error_and_return_default("underscores must be followed by digits"sv);
-				else if (*cp == U'.')
+
+				// parent was a value (when emitting events)
+				else if (const auto type = find_value_key(*parent, segment); type != node_type::none)
 				{
-					// 0x10.0p-.0 (exponent cannot have '.')
-					if (current_fragment == fragments + 2)
-						set_error_and_return_default("expected exponent digit or sign, saw '.'"sv);
+					set_error_and_return_default("cannot redefine existing "sv,
+												 to_sv(type),
+												 " '"sv,
+												 to_sv(recording_buffer),
+												 "' as "sv,
+												 is_arr ? "array-of-tables"sv : "table"sv);
+				}
 
-					// 0x10.0.p-0 (multiple '.')
-					else if (current_fragment == fragments + 1)
-						set_error_and_return_default("expected hexadecimal digit or exponent, saw '.'"sv);
+				// need to create a new implicit table
+				else
+				{
+					pit		  = parent->emplace_hint<table>(pit, make_key(i));
+					table& p = pit->second.ref_cast<table>();
+					set_region(p, header_begin_pos, header_end_pos);
 
-					else
-						current_fragment++;
+					implicit_tables.insert(&p);
+					parent = &p;
 				}
-				else if (is_match(*cp, U'p', U'P'))
-				{
-					// 0x10.0pp-0 (multiple 'p')
-					if (current_fragment == fragments + 2)
-						set_error_and_return_default("expected exponent digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+			}
 
-					// 0x.p-0 (mantissa is just '.')
-					else if (fragments[0].length == 0u && fragments[1].length == 0u)
-						set_error_and_return_default("expected hexadecimal digit, saw '"sv, to_sv(*cp), "'"sv);
+			const auto last_segment = key_buffer.back();
+			auto it					= parent->lower_bound(last_segment);
 
-					else
-						current_fragment = fragments + 2;
+			// if there was already a matching node some sanity checking is necessary;
+			// this is ok if we're making an array and the existing element is already an array (new element)
+			// or if we're making a table and the existing element is an implicitly-created table (promote it),
+			// otherwise this is a redefinition error.
+			if (it != parent->end() && it->first == last_segment)
+			{
+				node& matching_node = it->second;
+				if (auto arr = matching_node.as_array(); is_arr && arr && table_arrays.contains(arr))
+				{
+					table& tbl = arr->emplace_back<table>();
+					set_region(tbl, header_begin_pos, header_end_pos);
+					return table_header_parsed(keep_contents ? &tbl : nullptr, is_arr);
 				}
-				else if (is_match(*cp, U'+', U'-'))
+
+				else if (auto tbl = matching_node.as_table(); !is_arr && tbl && !implicit_tables.empty())
 				{
-					// 0x-10.0p-0 (sign in mantissa)
-					if (current_fragment != fragments + 2)
-						set_error_and_return_default("expected hexadecimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
+					if (implicit_tables.contains(tbl))
+					{
+						bool ok = true;
+						if (!tbl->empty())
+						{
+							for (auto& [_, child] : *tbl)
+							{
+								if (!child.is_table() && !child.is_array_of_tables())
+								{
+									ok = false;
+									break;
+								}
+							}
+						}
 
-					// 0x10.0p0- (misplaced exponent sign)
-					else if (!is_match(*prev, U'p', U'P'))
-						set_error_and_return_default("expected exponent digit, saw '"sv, to_sv(*cp), "'"sv);
+						if (ok)
+						{
+							implicit_tables.erase(tbl);
+#if TOML_ENABLE_SOURCES
+							if (track_sources)
+							{
+								tbl->source_.begin = header_begin_pos;
+								tbl->source_.end   = header_end_pos;
+							}
+#endif
+							return table_header_parsed(tbl, is_arr);
+						}
+					}
+				}
 
-					else
-						exponent_sign = *cp == U'-' ? -1 : 1;
+				// if we get here it's a redefinition error.
+				if (!is_arr && matching_node.type() == node_type::table)
+				{
+					set_error_at(header_begin_pos,
+								 "cannot redefine existing table '"sv,
+								 to_sv(recording_buffer),
+								 "'"sv);
+					return_after_error({});
 				}
-				else if (current_fragment < fragments + 2 && !is_hexadecimal_digit(*cp))
-					set_error_and_return_default("expected hexadecimal digit or '.', saw '"sv, to_sv(*cp), "'"sv);
-				else if (current_fragment == fragments + 2 && !is_decimal_digit(*cp))
-					set_error_and_return_default("expected exponent digit or sign, saw '"sv, to_sv(*cp), "'"sv);
-				else if (current_fragment->length == sizeof(fragment::chars))
-					set_error_and_return_default("fragment exceeeds maximum length of "sv,
-												 sizeof(fragment::chars),
-												 " characters"sv);
 				else
-					current_fragment->chars[current_fragment->length++] = static_cast<char>(cp->bytes[0]);
-
-				prev = cp;
-				advance_and_return_if_error({});
+				{
+					set_error_at(header_begin_pos,
+								 "cannot redefine existing "sv,
+								 to_sv(matching_node.type()),
+								 " '"sv,
+								 to_sv(recording_buffer),
+								 "' as "sv,
+								 is_arr ? "array-of-tables"sv : "table"sv);
+					return_after_error({});
+				}
 			}
 
-			// sanity-check ending state
-			if (current_fragment != fragments + 2 || current_fragment->length == 0u)
-			{
-				set_error_and_return_if_eof({});
-				set_error_and_return_default("missing exponent"sv);
-			}
-			else if (prev && *prev == U'_')
+			// likewise if there was a matching value (when emitting events)
+			else if (const auto type = find_value_key(*parent, last_segment); type != node_type::none)
 			{
-				set_error_and_return_if_eof({});
-				set_error_and_return_default("underscores must be followed by digits"sv);
+				set_error_at(header_begin_pos,
+							 "cannot redefine existing "sv,
+							 to_sv(type),
+							 " '"sv,
+							 to_sv(recording_buffer),
+							 "' as "sv,
+							 is_arr ? "array-of-tables"sv : "table"sv);
+				return_after_error({});
 			}
 
-			// calculate values for the three fragments
-			for (int fragment_idx = 0; fragment_idx < 3; fragment_idx++)
+			// there was no matching node, sweet - we can freely instantiate a new table/table array.
+			else
 			{
-				auto& f				= fragments[fragment_idx];
-				const uint32_t base = fragment_idx == 2 ? 10u : 16u;
+				auto last_key = make_key(key_buffer.size() - 1u);
 
-				// left-trim zeroes
-				const char* c = f.chars;
-				size_t sig	  = {};
-				while (f.length && *c == '0')
+				// if it's an array we need to make the array and it's first table element,
+				// set the starting regions, and return the table element
+				if (is_arr)
 				{
-					f.length--;
-					c++;
-					sig++;
-				}
-				if (!f.length)
-					continue;
+					it			   = parent->emplace_hint<array>(it, std::move(last_key));
+					array& tbl_arr = it->second.ref_cast<array>();
+					table_arrays.insert(&tbl_arr);
+					set_region(tbl_arr, header_begin_pos, header_end_pos);
 
-				// calculate value
-				auto place = 1u;
-				for (size_t i = 0; i < f.length - 1u; i++)
-					place *= base;
-				uint32_t val{};
-				while (place)
-				{
-					if (base == 16)
-						val += place * hex_to_dec(*c);
-					else
-						val += place * static_cast<uint32_t>(*c - '0');
-					if (fragment_idx == 1)
-						sig++;
-					c++;
-					place /= base;
+					table& tbl = tbl_arr.emplace_back<table>();
+					set_region(tbl, header_begin_pos, header_end_pos);
+					return table_header_parsed(keep_contents ? &tbl : nullptr, is_arr);
 				}
-				f.value = static_cast<double>(val);
 
-				// shift the fractional part
-				if (fragment_idx == 1)
+				// otherwise we're just making a table
+				else
 				{
-					while (sig--)
-						f.value /= base;
+					it		   = parent->emplace_hint<table>(it, std::move(last_key));
+					table& tbl = it->second.ref_cast<table>();
+					set_region(tbl, header_begin_pos, header_end_pos);
+					return table_header_parsed(&tbl, is_arr);
 				}
 			}
+		}
 
-			return (fragments[0].value + fragments[1].value) * pow(2.0, fragments[2].value * exponent_sign) * sign;
-
-#else // !TOML_LANG_UNRELEASED
-
-			set_error_and_return_default("hexadecimal floating-point values are not supported "
-										 "in TOML 1.0.0 and earlier"sv);
+		// path-filtered parsing: parses a value just to check it for errors, without keeping it.
+		bool discard_value()
+		{
+			TOML_ASSERT(!events);
 
-#endif // !TOML_LANG_UNRELEASED
+			discarding_values = true;
+			static_cast<void>(parse_value());
+			discarding_values = false;
+			return_if_error({});
+			return true;
 		}
 
-		template <uint64_t base>
-		TOML_NODISCARD
 		TOML_NEVER_INLINE
-		int64_t parse_integer()
+		bool parse_key_value_pair_and_insert(table* tbl)
 		{
 			return_if_error({});
 			assert_not_eof();
-			using traits = parse_integer_traits<base>;
-			push_parse_scope(traits::scope_qualifier);
+			TOML_ASSERT_ASSUME(is_string_delimiter(*cp) || is_bare_key_character(*cp));
+			push_parse_scope("key-value pair"sv);
 
-			[[maybe_unused]] int64_t sign = 1;
-			if constexpr (traits::is_signed)
+			// read the key into the key buffer
+			start_recording();
+			parse_key();
+			stop_recording(1u);
+			return_if_error({});
+			TOML_ASSERT(key_buffer.size() >= 1u);
+
+			// skip past any whitespace that followed the key
+			consume_leading_whitespace();
+			set_error_and_return_if_eof({});
+
+			// '='
+			if (*cp != U'=')
+				set_error_and_return_default("expected '=', saw '"sv, to_sv(*cp), "'"sv);
+			advance_and_return_if_error_or_eof({});
+
+			// skip past any whitespace that followed the '='
+			consume_leading_whitespace();
+			return_if_error({});
+			set_error_and_return_if_eof({});
+
+			// check that the next character could actually be a value
+			if (is_value_terminator(*cp))
+				set_error_and_return_default("expected value, saw '"sv, to_sv(*cp), "'"sv);
+
+			// path-filtered parsing: key-value pairs in tables that were skipped are just checked for errors.
+			// those outside of keep_paths in tables that weren't go through the same checks as everything else,
+			// but their values are discarded like when emitting events (see insert_parsed_value())
+			if (!tbl)
+				return discard_value();
+			const bool discard = keep_paths && open_inline_tables.empty() && !filter_keeps_key();
+
+			// if it's a dotted kvp we need to spawn the parent sub-tables if necessary,
+			// and set the target table to the second-to-last one in the chain
+			if (key_buffer.size() > 1u)
+			{
+				for (size_t i = 0; i < key_buffer.size() - 1u; i++)
+				{
+					const std::string_view segment = key_buffer[i];
+					auto pit					   = tbl->lower_bound(segment);
+
+					// parent already existed
+					if (pit != tbl->end() && pit->first == segment)
+					{
+						table* p = pit->second.as_table();
+
+						// redefinition
+						if TOML_UNLIKELY(!p || !(dotted_key_tables.contains(p) || implicit_tables.contains(p)))
+						{
+							set_error_at(key_buffer.starts[i],
+										 "cannot redefine existing "sv,
+										 to_sv(pit->second.type()),
+										 " as dotted key-value pair"sv);
+							return_after_error({});
+						}
+
+						tbl = p;
+					}
+
+					// parent was a value (when emitting events)
+					else if (const auto type = find_value_key(*tbl, segment); type != node_type::none)
+					{
+						set_error_at(key_buffer.starts[i],
+									 "cannot redefine existing "sv,
+									 to_sv(type),
+									 " as dotted key-value pair"sv);
+						return_after_error({});
+					}
+
+					// need to create a new implicit table
+					else
+					{
+						pit		  = tbl->emplace_hint<table>(pit, make_key(i));
+						table& p = pit->second.ref_cast<table>();
+						set_region(p, pit->first.source().begin, pit->first.source().end);
+
+						dotted_key_tables.insert(&p);
+						if (discard)
+							discarded_tables.push_back({ tbl, pit->first });
+						tbl = &p;
+					}
+				}
+			}
+
+			// ensure this isn't a redefinition
+			const std::string_view last_segment = key_buffer.back();
+			auto it								= tbl->lower_bound(last_segment);
+			auto existing_type = it != tbl->end() && it->first == last_segment ? it->second.type() : node_type::none;
+			if (existing_type == node_type::none)
+				existing_type = find_value_key(*tbl, last_segment);
+			if (existing_type != node_type::none)
 			{
-				sign = *cp == U'-' ? -1 : 1;
-				if (is_match(*cp, U'+', U'-'))
-					advance_and_return_if_error_or_eof({});
+				set_error("cannot redefine existing "sv, to_sv(existing_type), " '"sv, to_sv(recording_buffer), "'"sv);
+				return_after_error({});
 			}
 
-			if constexpr (base == 10)
+			// create the key first since the key buffer will likely get overwritten during value parsing (inline
+			// tables)
+			auto last_key = events ? key_parsed() : make_key(key_buffer.size() - 1u);
+
+			// now we can actually parse the value
+			// (or not, for lazy documents; the inline tables they do parse are parsed in their entirety)
+			if (skipping_values && open_inline_tables.empty() && skip_value(*tbl, last_key))
 			{
-				if (!traits::is_digit(*cp))
-					set_error_and_return_default("expected expected digit or sign, saw '"sv, to_sv(*cp), "'"sv);
+				return_if_error({});
+				return true;
 			}
-			else
-			{
-				// '0'
-				if (*cp != U'0')
-					set_error_and_return_default("expected '0', saw '"sv, to_sv(*cp), "'"sv);
-				advance_and_return_if_error_or_eof({});
 
-				// 'b', 'o', 'x'
-				if (*cp != traits::prefix_codepoint)
-					set_error_and_return_default("expected '"sv, traits::prefix, "', saw '"sv, to_sv(*cp), "'"sv);
-				advance_and_return_if_error_or_eof({});
+			const bool was_discarding = discarding_values;
+			discarding_values		  = was_discarding || discard;
+			parsed_value val		  = parse_value();
+			return_if_error({});
 
-				if (!traits::is_digit(*cp))
-					set_error_and_return_default("expected digit, saw '"sv, to_sv(*cp), "'"sv);
-			}
+			// (discarded inline tables still go in the tree; see discarded_tables)
+			if (discard && val.owned)
+				discarded_tables.push_back({ tbl, last_key });
 
-			// consume digits
-			char digits[utf8_buffered_reader::max_history_length];
-			size_t length			   = {};
-			const utf8_codepoint* prev = {};
-			while (!is_eof() && !is_value_terminator(*cp))
-			{
-				if (*cp == U'_')
-				{
-					if (!prev || !traits::is_digit(*prev))
-						set_error_and_return_default("underscores may only follow digits"sv);
+			insert_parsed_value(*tbl, it, std::move(last_key), std::move(val));
+			discarding_values = was_discarding;
+			return true;
+		}
 
-					prev = cp;
-					advance_and_return_if_error_or_eof({});
-					continue;
-				}
-				else if TOML_UNLIKELY(prev && *prev == U'_' && !traits::is_digit(*cp))
-					set_error_and_return_default("underscores must be followed by digits"sv);
-				else if TOML_UNLIKELY(!traits::is_digit(*cp))
-					set_error_and_return_default("expected digit, saw '"sv, to_sv(*cp), "'"sv);
-				else if TOML_UNLIKELY(length == sizeof(digits))
-					set_error_and_return_default("exceeds length limit of "sv, sizeof(digits), " digits"sv);
-				else
-					digits[length++] = static_cast<char>(cp->bytes[0]);
+		void parse_document()
+		{
+			assert_not_error();
+			assert_not_eof();
+			push_parse_scope("root table"sv);
 
-				prev = cp;
-				advance_and_return_if_error({});
-			}
+			if (!current_table)
+				current_table = &root;
 
-			// sanity check ending state
-			if (prev && *prev == U'_')
+			do
 			{
-				set_error_and_return_if_eof({});
-				set_error_and_return_default("underscores must be followed by digits"sv);
-			}
+				return_if_error();
 
-			// single digits can be converted trivially
-			if (length == 1u)
-			{
-				int64_t result;
+				// leading whitespace, line endings, comments
+				if (consume_leading_whitespace() || consume_line_break() || consume_comment())
+					continue;
+				return_if_error();
 
-				if constexpr (base == 16)
-					result = static_cast<int64_t>(hex_to_dec(digits[0]));
-				else
-					result = static_cast<int64_t>(digits[0] - '0');
+				// [tables]
+				// [[table array]]
+				if (*cp == U'[')
+					current_table = parse_table_header();
 
-				if constexpr (traits::is_signed)
-					result *= sign;
+				// bare_keys
+				// dotted.keys
+				// "quoted keys"
+				else if (is_bare_key_character(*cp) || is_string_delimiter(*cp))
+				{
+					push_parse_scope("key-value pair"sv);
 
-				return result;
-			}
+					parse_key_value_pair_and_insert(current_table);
 
-			// bin, oct and hex allow leading zeroes so trim them first
-			const char* end = digits + length;
-			const char* msd = digits;
-			if constexpr (base != 10)
-			{
-				while (msd < end && *msd == '0')
-					msd++;
-				if (msd == end)
-					return 0ll;
-			}
+					// handle the rest of the line after the kvp
+					// (this is not done in parse_key_value_pair() because that is also used for inline tables)
+					consume_leading_whitespace();
+					return_if_error();
+					if (!is_eof() && !consume_comment() && !consume_line_break())
+						set_error("expected a comment or whitespace, saw '"sv, to_sv(cp), "'"sv);
+				}
 
-			// decimal integers do not allow leading zeroes
-			else
-			{
-				if TOML_UNLIKELY(digits[0] == '0')
-					set_error_and_return_default("leading zeroes are prohibited"sv);
+				else // ??
+					set_error("expected keys, tables, whitespace or comments, saw '"sv, to_sv(cp), "'"sv);
 			}
+			while (!is_eof());
+		}
 
-			// range check
-			if TOML_UNLIKELY(static_cast<size_t>(end - msd) > traits::max_digits)
-				set_error_and_return_default("'"sv,
-											 traits::full_prefix,
-											 std::string_view{ digits, length },
-											 "' is not representable as a signed 64-bit integer"sv);
+		static void update_region_ends(node& nde) noexcept
+		{
+#if TOML_ENABLE_SOURCES
+			const auto type = nde.type();
+			if (type > node_type::array)
+				return;
 
-			// do the thing
+			if (type == node_type::table)
 			{
-				uint64_t result = {};
-				{
-					uint64_t power = 1;
-					while (--end >= msd)
-					{
-						if constexpr (base == 16)
-							result += power * hex_to_dec(*end);
-						else
-							result += power * static_cast<uint64_t>(*end - '0');
+				auto& tbl = nde.ref_cast<table>();
+				if (tbl.is_inline()) // inline tables (and all their inline descendants) are already correctly
+									 // terminated
+					return;
 
-						power *= base;
-					}
+				auto end = nde.source_.end;
+				for (auto&& [k, v] : tbl)
+				{
+					TOML_UNUSED(k);
+					update_region_ends(v);
+					if (end < v.source_.end)
+						end = v.source_.end;
 				}
-
-				// range check
-				static constexpr auto i64_max = static_cast<uint64_t>((std::numeric_limits<int64_t>::max)());
-				if TOML_UNLIKELY(result > i64_max + (sign < 0 ? 1u : 0u))
-					set_error_and_return_default("'"sv,
-												 traits::full_prefix,
-												 std::string_view{ digits, length },
-												 "' is not representable as a signed 64-bit integer"sv);
-
-				if constexpr (traits::is_signed)
+			}
+			else // arrays
+			{
+				auto& arr = nde.ref_cast<array>();
+				auto end  = nde.source_.end;
+				for (auto&& v : arr)
 				{
-					// avoid signed multiply UB when parsing INT64_MIN
-					if TOML_UNLIKELY(sign < 0 && result == i64_max + 1u)
-						return (std::numeric_limits<int64_t>::min)();
-
-					return static_cast<int64_t>(result) * sign;
+					update_region_ends(v);
+					if (end < v.source_.end)
+						end = v.source_.end;
 				}
-				else
-					return static_cast<int64_t>(result);
+				nde.source_.end = end;
 			}
+#else
+			TOML_UNUSED(nde);
+#endif
 		}
 
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		date parse_date(bool part_of_datetime = false)
+		static buffer_allocator get_buffer_allocator(const parse_options* options) noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
-			push_parse_scope("date"sv);
+#if TOML_HAS_MEMORY_RESOURCE && TOML_ENABLE_ARENA
+			if (options && options->memory_resource)
+				return buffer_allocator{ options->memory_resource };
+#else
+			TOML_UNUSED(options);
+#endif
+			return buffer_allocator{};
+		}
 
-			// "YYYY"
-			uint32_t digits[4];
-			if (!consume_digit_sequence(digits, 4u))
-				set_error_and_return_default("expected 4-digit year, saw '"sv, to_sv(cp), "'"sv);
-			const auto year			= digits[3] + digits[2] * 10u + digits[1] * 100u + digits[0] * 1000u;
-			const auto is_leap_year = (year % 4u == 0u) && ((year % 100u != 0u) || (year % 400u == 0u));
-			set_error_and_return_if_eof({});
+	  public:
+		// incremental parsing: nothing is read until parse_batch() is called
+		explicit parser(utf8_reader_interface& reader_,
+						sax_handler* handler					= nullptr,
+						value_key_set* skipped_values			= nullptr,
+						const parse_options* options			= nullptr) //
+			: reader{ reader_ },
+			  events{ handler },
+			  discarding_values{ handler != nullptr },
+			  event_keys(get_buffer_allocator(options)),
+			  discarded_value_keys(get_buffer_allocator(options)),
+			  value_keys{ skipped_values ? skipped_values : &discarded_value_keys },
+			  skipping_values{ skipped_values != nullptr },
+			  filter_depths(get_buffer_allocator(options)),
+			  implicit_tables(get_buffer_allocator(options)),
+			  dotted_key_tables(get_buffer_allocator(options)),
+			  discarded_tables(get_buffer_allocator(options)),
+			  open_inline_tables(get_buffer_allocator(options)),
+			  table_arrays(get_buffer_allocator(options)),
+			  key_buffer(get_buffer_allocator(options)),
+			  string_buffer(get_buffer_allocator(options)),
+			  recording_buffer(get_buffer_allocator(options)),
+			  document_keys(get_buffer_allocator(options))
+		{
+			if (options)
+			{
+				interned_keys = options->interned_keys;
+#if TOML_ENABLE_SOURCES
+				track_sources = !options->omit_sources;
+#endif
+			}
 
-			// '-'
-			if (*cp != U'-')
-				set_error_and_return_default("expected '-', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+			if (options && !options->keep_paths.empty())
+			{
+				keep_paths = &options->keep_paths;
+				filter_depths.resize(keep_paths->size());
+				reset_filter();
+			}
 
-			// "MM"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit month, saw '"sv, to_sv(cp), "'"sv);
-			const auto month = digits[1] + digits[0] * 10u;
-			if (month == 0u || month > 12u)
-				set_error_and_return_default("expected month between 1 and 12 (inclusive), saw "sv, month);
-			const auto max_days_in_month = month == 2u
-											 ? (is_leap_year ? 29u : 28u)
-											 : (month == 4u || month == 6u || month == 9u || month == 11u ? 30u : 31u);
-			set_error_and_return_if_eof({});
+#if TOML_ENABLE_ARENA && TOML_HAS_MEMORY_RESOURCE
+			if (options && (options->use_arena || options->memory_resource) && !handler)
+				arena = node_arena::create(options->memory_resource);
+#elif TOML_ENABLE_ARENA
+			if (options && options->use_arena && !handler)
+				arena = node_arena::create();
+#endif
 
-			// '-'
-			if (*cp != U'-')
-				set_error_and_return_default("expected '-', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+			init_source_path();
+		}
 
-			// "DD"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit day, saw '"sv, to_sv(cp), "'"sv);
-			const auto day = digits[1] + digits[0] * 10u;
-			if (day == 0u || day > max_days_in_month)
-				set_error_and_return_default("expected day between 1 and "sv,
-											 max_days_in_month,
-											 " (inclusive), saw "sv,
-											 day);
+		parser(utf8_reader_interface&& reader_,
+			   sax_handler* handler					   = nullptr,
+			   value_key_set* skipped_values		   = nullptr,
+			   const parse_options* options			   = nullptr) //
+			: parser{ reader_, handler, skipped_values, options }
+		{
+			const node_arena_scope arena_scope{ arena };
 
-			if (!part_of_datetime && !is_eof() && !is_value_terminator(*cp))
-				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+			if (!reader.peek_eof())
+			{
+				cp = reader.read_next();
 
-			return { year, month, day };
+#if !TOML_EXCEPTIONS
+				if (reader.error())
+				{
+					err = std::move(reader.error());
+					return;
+				}
+#endif
+
+				if (cp)
+					parse_document();
+			}
+
+			finish_document();
 		}
 
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		time parse_time(bool part_of_datetime = false)
+		~parser() noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
-			push_parse_scope("time"sv);
+			if (arena)
+				arena->release();
+		}
 
-			static constexpr size_t max_digits = 64; // far more than necessary but needed to allow fractional
-													 // millisecond truncation per the spec
-			uint32_t digits[max_digits];
+		// incremental parsing: parses the reader's current contents (one or more complete top-level lines)
+		// as a continuation of the previous batch.
+		void parse_batch(bool final_batch)
+		{
+			return_if_error();
 
-			// "HH"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit hour, saw '"sv, to_sv(cp), "'"sv);
-			const auto hour = digits[1] + digits[0] * 10u;
-			if (hour > 23u)
-				set_error_and_return_default("expected hour between 0 to 59 (inclusive), saw "sv, hour);
-			set_error_and_return_if_eof({});
+			more_batches = !final_batch;
+			const node_arena_scope arena_scope{ arena };
+			reader.restart();
+			cp = reader.read_next();
 
-			// ':'
-			if (*cp != U':')
-				set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+#if !TOML_EXCEPTIONS
+			if (reader.error())
+			{
+				err = std::move(reader.error());
+				return;
+			}
+#endif
 
-			// "MM"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit minute, saw '"sv, to_sv(cp), "'"sv);
-			const auto minute = digits[1] + digits[0] * 10u;
-			if (minute > 59u)
-				set_error_and_return_default("expected minute between 0 and 59 (inclusive), saw "sv, minute);
-			auto time = toml::time{ hour, minute };
+			if (cp)
+				parse_document();
+		}
+
+		// parallel parsing: as above, but for batches parsed out of order (independent chunks of a document, or the
+		// table headers between them), so the position of the batch within the document needs to be given.
+		void parse_batch(source_position position)
+		{
+			return_if_error();
 
-			// ':'
-			if constexpr (TOML_LANG_UNRELEASED) // toml/issues/671 (allow omission of seconds)
+			const node_arena_scope arena_scope{ arena };
+			reader.restart(position);
+			cp = reader.read_next();
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
 			{
-				if (is_eof() || is_value_terminator(*cp) || (part_of_datetime && is_match(*cp, U'+', U'-', U'Z', U'z')))
-					return time;
+				err = std::move(reader.error());
+				return;
 			}
-			else
-				set_error_and_return_if_eof({});
-			if (*cp != U':')
-				set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+#endif
 
-			// "SS"
-			if (!consume_digit_sequence(digits, 2u))
-				set_error_and_return_default("expected 2-digit second, saw '"sv, to_sv(cp), "'"sv);
-			const auto second = digits[1] + digits[0] * 10u;
-			if (second > 59u)
-				set_error_and_return_default("expected second between 0 and 59 (inclusive), saw "sv, second);
-			time.second = static_cast<decltype(time.second)>(second);
+			if (cp)
+				parse_document();
+		}
 
-			// '.' (early-exiting is allowed; fractional is optional)
-			if (is_eof() || is_value_terminator(*cp) || (part_of_datetime && is_match(*cp, U'+', U'-', U'Z', U'z')))
-				return time;
-			if (*cp != U'.')
-				set_error_and_return_default("expected '.', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+		// parallel parsing: moves the key-value pairs parsed from a chunk into the current table.
+		// returns false if any of them collide with what's already there, since the chunk then might not have been
+		// valid in context (e.g. a dotted key-value pair extending an implicitly-created table).
+		TOML_NODISCARD
+		bool merge_chunk(table& chunk)
+		{
+			if (!current_table)
+				current_table = &root;
 
-			// "FFFFFFFFF"
-			size_t digit_count = consume_variable_length_digit_sequence(digits, max_digits);
-			if (!digit_count)
-			{
-				set_error_and_return_if_eof({});
-				set_error_and_return_default("expected fractional digits, saw '"sv, to_sv(*cp), "'"sv);
-			}
-			else if (!is_eof())
+			current_table->drop_index();
+			chunk.drop_index();
+
+			auto& map = current_table->map_;
+#if TOML_FLAT_TABLES
+			for (auto& [k, v] : chunk.map_)
 			{
-				if (digit_count == max_digits && is_decimal_digit(*cp))
-					set_error_and_return_default("fractional component exceeds maximum precision of "sv, max_digits);
-				else if (!part_of_datetime && !is_value_terminator(*cp))
-					set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+				const auto it = map.lower_bound(k);
+				if (it != map.end() && it->first == k)
+					return false;
+				map.emplace_hint(it, std::move(k), std::move(v));
 			}
-			uint32_t value = 0u;
-			uint32_t place = 1u;
-			for (auto i = impl::min<size_t>(digit_count, 9u); i-- > 0u;)
+			chunk.map_.clear();
+#else
+			while (!chunk.map_.empty())
 			{
-				value += digits[i] * place;
-				place *= 10u;
+				auto kvp	  = chunk.map_.extract(chunk.map_.begin());
+				const auto it = map.lower_bound(kvp.key());
+				if (it != map.end() && it->first == kvp.key())
+					return false;
+				map.insert(it, std::move(kvp));
 			}
-			for (auto i = digit_count; i < 9u; i++) // implicit zeros
-				value *= 10u;
-			time.nanosecond = value;
-			return time;
+#endif
+			return true;
 		}
 
+		// parallel parsing: where the input ended (see finish_document()).
 		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		date_time parse_date_time()
+		source_position end_position() const noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_decimal_digit(*cp));
-			push_parse_scope("date-time"sv);
+			return current_position(1);
+		}
 
-			// "YYYY-MM-DD"
-			auto date = parse_date(true);
-			set_error_and_return_if_eof({});
+		// parallel parsing: hands over the parsed chunk (or the finished document), leaving the parser ready for
+		// another chunk.
+		TOML_NODISCARD
+		table release_root() noexcept
+		{
+			table tbl{ std::move(root) };
+			root.clear();
+			current_table = {};
+			dotted_key_tables.clear();
+			value_keys->clear();
+			return tbl;
+		}
 
-			// ' ', 'T' or 't'
-			if (!is_match(*cp, U' ', U'T', U't'))
-				set_error_and_return_default("expected space, 'T' or 't', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
+		// batch parsing: gets ready to parse a whole new document from the reader (which may have a different
+		// source path now), holding on to everything that's been allocated so far (other than the arena, since
+		// each document gets its own). not valid after an error.
+		void reset()
+		{
+			assert_not_error();
 
-			// "HH:MM:SS.FFFFFFFFF"
-			auto time = parse_time(true);
+			if (arena)
+			{
+				const auto next = arena->create_next();
+				arena->release();
+				arena = next;
+			}
+
+			prev_pos	  = { 1, 1 };
+			cp			  = {};
+			current_table = {};
+			root.clear();
+			init_source_path();
+			dotted_key_tables.clear();
+			implicit_tables.clear();
+			discarded_tables.clear();
+			table_arrays.clear();
+			value_keys->clear();
+			if (keep_paths)
+				reset_filter();
+		}
+
+		// lazy documents: parses a value skipped over by skip_value(), which must be the whole of the reader's contents.
+		TOML_NODISCARD
+		node_ptr parse_deferred_value(source_position position)
+		{
+			const node_arena_scope arena_scope{ arena };
+			reader.restart(position);
+			cp = reader.read_next();
+
+#if !TOML_EXCEPTIONS
+			if (reader.error())
+			{
+				err = std::move(reader.error());
+				return {};
+			}
+#endif
+
+			parsed_value val = parse_value();
 			return_if_error({});
+			if (!is_eof())
+				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
 
-			// no offset
-			if (is_eof() || is_value_terminator(*cp))
-				return { date, time };
+			update_region_ends(*val.ptr);
+			return std::move(val.owned);
+		}
 
-			// zero offset ('Z' or 'z')
-			time_offset offset{};
-			if (is_match(*cp, U'Z', U'z'))
-				advance_and_return_if_error({});
+		// closes off the source regions once all of the input has been parsed.
+		void finish_document() noexcept
+		{
+			more_batches = false; // (whatever the last batch was, there's nothing after it)
+			finish_document(current_position(1));
+		}
 
-			// explicit offset ("+/-HH:MM")
-			else if (is_match(*cp, U'+', U'-'))
+		// path-filtered parsing: takes the tables put in the tree by key-value pairs outside of keep_paths back out
+		// again, i.e. their inline tables and any dotted key tables that nothing that was kept went in.
+		// (they're only there so redefinitions are diagnosed the same way they would be without keep_paths)
+		void prune_discarded_tables() noexcept
+		{
+			for (auto i = discarded_tables.size(); i-- > 0u;)
 			{
-				push_parse_scope("date-time offset"sv);
+				auto& discarded = discarded_tables[i];
+				auto it			= discarded.parent->find(discarded.k.str());
+				TOML_ASSERT(it != discarded.parent->end());
 
-				// sign
-				int sign = *cp == U'-' ? -1 : 1;
-				advance_and_return_if_error_or_eof({});
+				auto& tbl = it->second.ref_cast<table>();
+				if (tbl.is_inline() || tbl.empty())
+				{
+					dotted_key_tables.erase(&tbl);
+					discarded.parent->erase(it);
+				}
+			}
+			discarded_tables.clear();
+		}
 
-				// "HH"
-				int digits[2];
-				if (!consume_digit_sequence(digits, 2u))
-					set_error_and_return_default("expected 2-digit hour, saw '"sv, to_sv(cp), "'"sv);
-				const auto hour = digits[1] + digits[0] * 10;
-				if (hour > 23)
-					set_error_and_return_default("expected hour between 0 and 23 (inclusive), saw "sv, hour);
-				set_error_and_return_if_eof({});
+		void finish_document(source_position eof_pos) noexcept
+		{
+			if (!is_error() && !discarded_tables.empty())
+				prune_discarded_tables();
 
-				// ':'
-				if (*cp != U':')
-					set_error_and_return_default("expected ':', saw '"sv, to_sv(*cp), "'"sv);
-				advance_and_return_if_error_or_eof({});
+#if TOML_ENABLE_SOURCES
+			if (!is_error() && track_sources)
+			{
+				root.source_.end = eof_pos;
 
-				// "MM"
-				if (!consume_digit_sequence(digits, 2u))
-					set_error_and_return_default("expected 2-digit minute, saw '"sv, to_sv(cp), "'"sv);
-				const auto minute = digits[1] + digits[0] * 10;
-				if (minute > 59)
-					set_error_and_return_default("expected minute between 0 and 59 (inclusive), saw "sv, minute);
-				offset.minutes = static_cast<decltype(offset.minutes)>((hour * 60 + minute) * sign);
+				// (current_table is only set once parse_document() has been reached, and is cleared again by
+				// headers the path filter skips)
+				if (current_table && current_table != &root
+					&& current_table->source_.end <= current_table->source_.begin)
+					current_table->source_.end = eof_pos;
 			}
 
-			if (!is_eof() && !is_value_terminator(*cp))
-				set_error_and_return_default("expected value-terminator, saw '"sv, to_sv(*cp), "'"sv);
+#else
+			TOML_UNUSED(eof_pos);
+#endif
 
-			return { date, time, offset };
+			// (nobody gets to see the tree when emitting events)
+			if (!events && track_sources)
+				update_region_ends(root);
 		}
 
-		TOML_NODISCARD
-		node_ptr parse_array();
+#if !TOML_EXCEPTIONS
+
+		TOML_PURE_INLINE_GETTER
+		bool failed() const noexcept
+		{
+			return !!err;
+		}
 
 		TOML_NODISCARD
-		node_ptr parse_inline_table();
+		optional<parse_error>&& error() noexcept
+		{
+			return std::move(err);
+		}
+
+#endif
 
 		TOML_NODISCARD
-		node_ptr parse_value_known_prefixes()
+		operator parse_result() && noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(!is_control_character(*cp));
-			TOML_ASSERT_ASSUME(*cp != U'_');
+#if TOML_EXCEPTIONS
 
-			switch (cp->value)
-			{
-				// arrays
-				case U'[': return parse_array();
+			return { std::move(root) };
 
-				// inline tables
-				case U'{': return parse_inline_table();
+#else
 
-				// floats beginning with '.'
-				case U'.': return node_ptr{ new value{ parse_float() } };
+			if (err)
+				return parse_result{ *std::move(err) };
+			else
+				return parse_result{ std::move(root) };
 
-				// strings
-				case U'"': [[fallthrough]];
-				case U'\'': return node_ptr{ new value{ parse_string().value } };
+#endif
+		}
+	};
 
-				default:
-				{
-					const auto cp_upper = static_cast<uint_least32_t>(cp->value) & ~0x20u;
+	TOML_EXTERNAL_LINKAGE
+	parsed_value parser::parse_array()
+	{
+		return_if_error({});
+		assert_not_eof();
+		TOML_ASSERT_ASSUME(*cp == U'[');
+		push_parse_scope("array"sv);
 
-					// bools
-					if (cp_upper == 70u || cp_upper == 84u) // F or T
-						return node_ptr{ new value{ parse_boolean() } };
+		// skip opening '['
+		advance_and_return_if_error_or_eof({});
 
-					// inf/nan
-					else if (cp_upper == 73u || cp_upper == 78u) // I or N
-						return node_ptr{ new value{ parse_inf_or_nan() } };
+		// when emitting events (or skipping the value) the elements aren't kept, so there's nothing to allocate
+		parsed_value arr_val =
+			discarding_values ? parsed_value{ scratch.arrays } : parsed_value{ node_ptr{ new array{} } };
+		array& arr			 = arr_val->ref_cast<array>();
+		if (events)
+			events->on_array_begin();
+		enum class TOML_CLOSED_ENUM parse_type : int
+		{
+			none,
+			comma,
+			val
+		};
+		parse_type prev = parse_type::none;
 
-					else
-						return nullptr;
+		while (!is_error())
+		{
+			while (consume_leading_whitespace() || consume_line_break() || consume_comment())
+				continue;
+			set_error_and_return_if_eof({});
+
+			// commas - only legal after a value
+			if (*cp == U',')
+			{
+				if (prev == parse_type::val)
+				{
+					prev = parse_type::comma;
+					advance_and_return_if_error_or_eof({});
+					continue;
 				}
+				set_error_and_return_default("expected value or closing ']', saw comma"sv);
 			}
-			TOML_UNREACHABLE;
-		}
 
-		TOML_NODISCARD
-		node_ptr parse_value()
-		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(!is_value_terminator(*cp));
-			push_parse_scope("value"sv);
+			// closing ']'
+			else if (*cp == U']')
+			{
+				advance_and_return_if_error({});
+				break;
+			}
 
-			const depth_counter_scope depth_counter{ nested_values };
-			if TOML_UNLIKELY(nested_values > max_nested_values)
-				set_error_and_return_default("exceeded maximum nested value depth of "sv,
-											 max_nested_values,
-											 " (TOML_MAX_NESTED_VALUES)"sv);
+			// must be a value
+			else
+			{
+				if (prev == parse_type::val)
+				{
+					set_error_and_return_default("expected comma or closing ']', saw '"sv, to_sv(*cp), "'"sv);
+					continue;
+				}
+				prev = parse_type::val;
 
-			// check if it begins with some control character
-			// (note that this will also fail for whitespace but we're assuming we've
-			// called consume_leading_whitespace() before calling parse_value())
-			if TOML_UNLIKELY(is_control_character(*cp))
-				set_error_and_return_default("unexpected control character"sv);
+				auto val = parse_value();
+				return_if_error({});
 
-			// underscores at the beginning
-			else if (*cp == U'_')
-				set_error_and_return_default("values may not begin with underscores"sv);
+				if (discarding_values)
+					continue;
 
-			const auto begin_pos = cp->position;
-			node_ptr val;
+				if (!arr.capacity())
+					arr.reserve(4u);
+				arr.emplace_back<node_ptr>(std::move(val.owned));
+			}
+		}
 
-			do
-			{
-				TOML_ASSERT_ASSUME(!is_control_character(*cp));
-				TOML_ASSERT_ASSUME(*cp != U'_');
+		return_if_error({});
+		if (events)
+			events->on_array_end();
+		return arr_val;
+	}
 
-				// detect the value type and parse accordingly,
-				// starting with value types that can be detected
-				// unambiguously from just one character.
+	TOML_EXTERNAL_LINKAGE
+	parsed_value parser::parse_inline_table()
+	{
+		return_if_error({});
+		assert_not_eof();
+		TOML_ASSERT_ASSUME(*cp == U'{');
+		push_parse_scope("inline table"sv);
+
+		// skip opening '{'
+		advance_and_return_if_error_or_eof({});
+
+		node_ptr tbl_ptr{ new table{} };
+		table& tbl = tbl_ptr->ref_cast<table>();
+		tbl.is_inline(true);
+		table_vector_scope table_scope{ open_inline_tables, tbl };
+		const auto dotted_key_tables_count = dotted_key_tables.size();
+		const auto value_keys_count		   = value_keys->size();
+		if (events)
+			events->on_inline_table_begin();
 
-				val = parse_value_known_prefixes();
-				return_if_error({});
-				if (val)
-					break;
+		enum class TOML_CLOSED_ENUM parse_type : int
+		{
+			none,
+			comma,
+			kvp
+		};
+		parse_type prev = parse_type::none;
+		while (!is_error())
+		{
+			if constexpr (TOML_LANG_UNRELEASED) // toml/issues/516 (newlines/trailing commas in inline tables)
+			{
+				while (consume_leading_whitespace() || consume_line_break() || consume_comment())
+					continue;
+			}
+			else
+			{
+				while (consume_leading_whitespace())
+					continue;
+			}
+			return_if_error({});
+			set_error_and_return_if_eof({});
 
-				// value types from here down require more than one character to unambiguously identify
-				// so scan ahead and collect a set of value 'traits'.
-				enum TOML_CLOSED_FLAGS_ENUM value_traits : int
+			// commas - only legal after a key-value pair
+			if (*cp == U',')
+			{
+				if (prev == parse_type::kvp)
 				{
-					has_nothing	 = 0,
-					has_digits	 = 1,
-					has_b		 = 1 << 1, // as second char only (0b)
-					has_e		 = 1 << 2, // only float exponents
-					has_o		 = 1 << 3, // as second char only (0o)
-					has_p		 = 1 << 4, // only hexfloat exponents
-					has_t		 = 1 << 5,
-					has_x		 = 1 << 6, // as second or third char only (0x, -0x, +0x)
-					has_z		 = 1 << 7,
-					has_colon	 = 1 << 8,
-					has_plus	 = 1 << 9,
-					has_minus	 = 1 << 10,
-					has_dot		 = 1 << 11,
-					begins_sign	 = 1 << 12,
-					begins_digit = 1 << 13,
-					begins_zero	 = 1 << 14,
-					signs_msk  = has_plus | has_minus,
-					bdigit_msk = has_digits | begins_digit,
-					bzero_msk  = bdigit_msk | begins_zero,
-				};
-				value_traits traits	 = has_nothing;
-				const auto has_any	 = [&](auto t) noexcept { return (traits & t) != has_nothing; };
-				const auto has_none	 = [&](auto t) noexcept { return (traits & t) == has_nothing; };
-				const auto add_trait = [&](auto t) noexcept { traits = static_cast<value_traits>(traits | t); };
+					prev = parse_type::comma;
+					advance_and_return_if_error_or_eof({});
+				}
+				else
+					set_error_and_return_default("expected key-value pair or closing '}', saw comma"sv);
+			}
 
-				// examine the first character to get the 'begins with' traits
-				// (good fail-fast opportunity; all the remaining types begin with numeric digits or signs)
-				if (is_decimal_digit(*cp))
+			// closing '}'
+			else if (*cp == U'}')
+			{
+				if constexpr (!TOML_LANG_UNRELEASED) // toml/issues/516 (newlines/trailing commas in inline tables)
 				{
-					add_trait(begins_digit);
-					if (*cp == U'0')
-						add_trait(begins_zero);
+					if (prev == parse_type::comma)
+					{
+						set_error_and_return_default("expected key-value pair, saw closing '}' (dangling comma)"sv);
+						continue;
+					}
 				}
-				else if (is_match(*cp, U'+', U'-'))
-					add_trait(begins_sign);
-				else
-					break;
+				advance_and_return_if_error({});
+				break;
+			}
 
-				// scan the rest of the value to determine the remaining traits
-				char32_t chars[utf8_buffered_reader::max_history_length];
-				size_t char_count = {}, advance_count = {};
-				bool eof_while_scanning = false;
-				const auto scan			= [&]() noexcept(!TOML_COMPILER_HAS_EXCEPTIONS)
+			// key-value pair
+			else if (is_string_delimiter(*cp) || is_bare_key_character(*cp))
+			{
+				if (prev == parse_type::kvp)
+					set_error_and_return_default("expected comma or closing '}', saw '"sv, to_sv(*cp), "'"sv);
+				else
 				{
-					if (is_eof())
-						return;
-					TOML_ASSERT_ASSUME(!is_value_terminator(*cp));
+					prev = parse_type::kvp;
+					parse_key_value_pair_and_insert(&tbl);
+				}
+			}
 
-					do
-					{
-						if (const auto c = **cp; c != U'_')
-						{
-							chars[char_count++] = c;
+			else
+				set_error_and_return_default("expected key or closing '}', saw '"sv, to_sv(*cp), "'"sv);
+		}
 
-							if (is_decimal_digit(c))
-								add_trait(has_digits);
-							else if (is_ascii_letter(c))
-							{
-								TOML_ASSERT_ASSUME((c >= U'a' && c <= U'z') || (c >= U'A' && c <= U'Z'));
-								switch (static_cast<char32_t>(c | 32u))
-								{
-									case U'b':
-										if (char_count == 2u && has_any(begins_zero))
-											add_trait(has_b);
-										break;
-
-									case U'e':
-										if (char_count > 1u
-											&& has_none(has_b | has_o | has_p | has_t | has_x | has_z | has_colon)
-											&& (has_none(has_plus | has_minus) || has_any(begins_sign)))
-											add_trait(has_e);
-										break;
-
-									case U'o':
-										if (char_count == 2u && has_any(begins_zero))
-											add_trait(has_o);
-										break;
-
-									case U'p':
-										if (has_any(has_x))
-											add_trait(has_p);
-										break;
-
-									case U'x':
-										if ((char_count == 2u && has_any(begins_zero))
-											|| (char_count == 3u && has_any(begins_sign) && chars[1] == U'0'))
-											add_trait(has_x);
-										break;
-
-									case U't': add_trait(has_t); break;
-									case U'z': add_trait(has_z); break;
-								}
-							}
-							else if (c <= U':')
-							{
-								TOML_ASSERT_ASSUME(c < U'0' || c > U'9');
-								switch (c)
-								{
-									case U'+': add_trait(has_plus); break;
-									case U'-': add_trait(has_minus); break;
-									case U'.': add_trait(has_dot); break;
-									case U':': add_trait(has_colon); break;
-								}
-							}
-						}
+		return_if_error({});
 
-						advance_and_return_if_error();
-						advance_count++;
-						eof_while_scanning = is_eof();
-					}
-					while (advance_count < (utf8_buffered_reader::max_history_length - 1u) && !is_eof()
-						   && !is_value_terminator(*cp));
-				};
-				scan();
-				return_if_error({});
+		// inline tables are closed once they end, so any dotted key tables created in this one can be forgotten, as
+		// can the keys of its values when emitting events (it may even be thrown away, e.g. if it was in an array).
+		if (dotted_key_tables.size() != dotted_key_tables_count)
+			forget_dotted_key_tables(tbl);
+		value_keys->truncate(value_keys_count);
 
-				// force further scanning if this could have been a date-time with a space instead of a T
-				if (char_count == 10u									 //
-					&& (traits | begins_zero) == (bzero_msk | has_minus) //
-					&& chars[4] == U'-'									 //
-					&& chars[7] == U'-'									 //
-					&& !is_eof()										 //
-					&& *cp == U' ')
-				{
-					const auto pre_advance_count = advance_count;
-					const auto pre_scan_traits	 = traits;
-					chars[char_count++]			 = *cp;
-					add_trait(has_t);
+		if (events)
+			events->on_inline_table_end();
+		return parsed_value{ std::move(tbl_ptr) };
+	}
 
-					const auto backpedal = [&]() noexcept
-					{
-						go_back(advance_count - pre_advance_count);
-						advance_count = pre_advance_count;
-						traits		  = pre_scan_traits;
-						char_count	  = 10u;
-					};
+	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
+}
+TOML_IMPL_NAMESPACE_END;
 
-					advance_and_return_if_error({});
-					advance_count++;
+#undef TOML_RETURNS_BY_THROWING
+#undef advance_and_return_if_error
+#undef advance_and_return_if_error_or_eof
+#undef assert_not_eof
+#undef assert_not_error
+#undef is_eof
+#undef is_error
+#undef parse_error_break
+#undef push_parse_scope
+#undef push_parse_scope_1
+#undef push_parse_scope_2
+#undef return_after_error
+#undef return_if_eof
+#undef return_if_error
+#undef return_if_error_or_eof
+#undef set_error_and_return
+#undef set_error_and_return_default
+#undef set_error_and_return_if_eof
+#undef utf8_buffered_reader_error_check
+#undef utf8_reader_error
+#undef utf8_reader_error_check
+#undef utf8_reader_return_after_error
 
-					if (is_eof() || !is_decimal_digit(*cp))
-						backpedal();
-					else
-					{
-						chars[char_count++] = *cp;
+TOML_ANON_NAMESPACE_START
+{
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	parse_result do_parse(utf8_reader_interface && reader)
+	{
+		return impl::parser{ std::move(reader) };
+	}
 
-						advance_and_return_if_error({});
-						advance_count++;
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	parse_result do_parse(utf8_reader_interface && reader, const parse_options& options)
+	{
+		return impl::parser{ std::move(reader), nullptr, nullptr, &options };
+	}
 
-						scan();
-						return_if_error({});
+#if TOML_EXCEPTIONS
+	using sax_parse_result = void;
+#else
+	using sax_parse_result = optional<parse_error>;
+#endif
 
-						if (char_count == 12u)
-							backpedal();
-					}
-				}
+	TOML_INTERNAL_LINKAGE
+	sax_parse_result do_parse(utf8_reader_interface && reader, sax_handler & handler)
+	{
+#if TOML_EXCEPTIONS
+		impl::parser{ std::move(reader), &handler };
+#else
+		impl::parser parser{ std::move(reader), &handler };
+		return parser.error();
+#endif
+	}
+
+	// just enough of the grammar to know where the top-level lines end:
+	// strings and comments (which may contain brackets and line breaks) and the nesting depth of [] and {}
+	class top_level_scanner
+	{
+	  private:
+		enum class scan_mode : unsigned char
+		{
+			normal,
+			comment,
+			basic_string_open, // one or two '"' so far
+			basic_string,
+			basic_string_escape,
+			ml_basic_string,
+			ml_basic_string_escape,
+			literal_string_open, // one or two '\'' so far
+			literal_string,
+			ml_literal_string
+		};
 
-				// set the reader back to where we started
-				go_back(advance_count);
+		scan_mode mode_	   = scan_mode::normal;
+		size_t delimiters_ = {}; // consecutive string delimiters
+		size_t depth_	   = {};
 
-				// if after scanning ahead we still only have one value character,
-				// the only valid value type is an integer.
-				if (char_count == 1u)
+		TOML_CONST_INLINE_GETTER
+		static bool is_structural(char ch) noexcept
+		{
+			switch (ch)
+			{
+				case '\n': [[fallthrough]];
+				case '#': [[fallthrough]];
+				case '"': [[fallthrough]];
+				case '\'': [[fallthrough]];
+				case '[': [[fallthrough]];
+				case ']': [[fallthrough]];
+				case '{': [[fallthrough]];
+				case '}': return true;
+				default: return false;
+			}
+		}
+
+	  public:
+		// calls on_line_end with the end of each complete top-level line in [begin, end)
+		// (can be called repeatedly with consecutive parts of the same input)
+		template <typename Func>
+		void scan(const char* begin, const char* end, Func&& on_line_end)
+		{
+			const auto& kernels = impl::simd();
+			for (auto c = begin; c < end; c++)
+			{
+				// skip over anything that can't change the mode in bulk
+				switch (mode_)
 				{
-					if (has_any(begins_digit))
-					{
-						val.reset(new value{ static_cast<int64_t>(chars[0] - U'0') });
-						advance(); // skip the digit
+					case scan_mode::normal:
+						while (c < end && !is_structural(*c))
+							c++;
 						break;
-					}
 
-					// anything else would be ambiguous.
-					else
-						set_error_and_return_default(eof_while_scanning ? "encountered end-of-file"sv
-																		: "could not determine value type"sv);
-				}
+					case scan_mode::comment: c = kernels.find_comment_terminator(c, end); break;
+					case scan_mode::basic_string: c = kernels.find_string_terminator(c, end, '"', '\\'); break;
+					case scan_mode::literal_string: c = kernels.find_string_terminator(c, end, '\'', '\''); break;
 
-				// now things that can be identified from two or more characters
-				return_if_error({});
-				TOML_ASSERT_ASSUME(char_count >= 2u);
+					case scan_mode::ml_basic_string:
+						if (!delimiters_)
+							c = kernels.find_string_terminator(c, end, '"', '\\');
+						break;
 
-				// do some 'fuzzy matching' where there's no ambiguity, since that allows the specific
-				// typed parse functions to take over and show better diagnostics if there's an issue
-				// (as opposed to the fallback "could not determine type" message)
-				if (has_any(has_p))
-					val.reset(new value{ parse_hex_float() });
-				else if (has_any(has_x | has_o | has_b))
-				{
-					int64_t i;
-					value_flags flags;
-					if (has_any(has_x))
-					{
-						i	  = parse_integer<16>();
-						flags = value_flags::format_as_hexadecimal;
-					}
-					else if (has_any(has_o))
-					{
-						i	  = parse_integer<8>();
-						flags = value_flags::format_as_octal;
-					}
-					else // has_b
-					{
-						i	  = parse_integer<2>();
-						flags = value_flags::format_as_binary;
-					}
-					return_if_error({});
+					case scan_mode::ml_literal_string:
+						if (!delimiters_)
+							c = kernels.find_string_terminator(c, end, '\'', '\'');
+						break;
 
-					val.reset(new value{ i });
-					val->ref_cast<int64_t>().flags(flags);
+					default: break;
 				}
-				else if (has_any(has_e) || (has_any(begins_digit) && chars[1] == U'.'))
-					val.reset(new value{ parse_float() });
-				else if (has_any(begins_sign))
+				if (c == end)
+					break;
+
+				const auto ch = *c;
+				switch (mode_)
 				{
-					// single-digit signed integers
-					if (char_count == 2u && has_any(has_digits))
-					{
-						val.reset(new value{ static_cast<int64_t>(chars[1] - U'0') * (chars[0] == U'-' ? -1LL : 1LL) });
-						advance(); // skip the sign
-						advance(); // skip the digit
-						break;
-					}
+					case scan_mode::normal: break;
+
+					case scan_mode::comment:
+						if (ch == '\n')
+							break;
+						continue;
+
+					case scan_mode::basic_string_open:
+						if (ch == '"')
+						{
+							if (++delimiters_ == 3u)
+							{
+								mode_		= scan_mode::ml_basic_string;
+								delimiters_ = {};
+							}
+							continue;
+						}
+						if (delimiters_ == 2u) // ""
+							break;
+						mode_ = scan_mode::basic_string;
+						[[fallthrough]];
+
+					case scan_mode::basic_string:
+						if (ch == '\\')
+							mode_ = scan_mode::basic_string_escape;
+						else if (ch == '"')
+							mode_ = scan_mode::normal;
+						else if (ch == '\n') // unterminated; the parser will complain about it
+							break;
+						continue;
 
-					// simple signed floats (e.g. +1.0)
-					if (is_decimal_digit(chars[1]) && chars[2] == U'.')
-						val.reset(new value{ parse_float() });
+					case scan_mode::basic_string_escape:
+						mode_ = scan_mode::basic_string;
+						if (ch == '\n')
+							break;
+						continue;
 
-					// signed infinity or nan
-					else if (is_match(chars[1], U'i', U'n', U'I', U'N'))
-						val.reset(new value{ parse_inf_or_nan() });
-				}
+					case scan_mode::ml_basic_string:
+						if (ch == '"')
+						{
+							if (++delimiters_ == 5u) // """ + two quotes at the end of the string
+								mode_ = scan_mode::normal;
+							continue;
+						}
+						if (delimiters_ >= 3u)
+							break;
+						delimiters_ = {};
+						if (ch == '\\')
+							mode_ = scan_mode::ml_basic_string_escape;
+						continue;
 
-				return_if_error({});
-				if (val)
-					break;
+					case scan_mode::ml_basic_string_escape:
+						mode_ = scan_mode::ml_basic_string;
+						continue;
 
-				// match trait masks against what they can match exclusively.
-				// all correct value parses will come out of this list, so doing this as a switch is likely to
-				// be a better friend to the optimizer on the success path (failure path can be slow but that
-				// doesn't matter much).
-				switch (unwrap_enum(traits))
-				{
-					// binary integers
-					// 0b10
-					case bzero_msk | has_b:
-						val.reset(new value{ parse_integer<2>() });
-						val->ref_cast<int64_t>().flags(value_flags::format_as_binary);
-						break;
+					case scan_mode::literal_string_open:
+						if (ch == '\'')
+						{
+							if (++delimiters_ == 3u)
+							{
+								mode_		= scan_mode::ml_literal_string;
+								delimiters_ = {};
+							}
+							continue;
+						}
+						if (delimiters_ == 2u) // ''
+							break;
+						mode_ = scan_mode::literal_string;
+						[[fallthrough]];
 
-					// octal integers
-					// 0o10
-					case bzero_msk | has_o:
-						val.reset(new value{ parse_integer<8>() });
-						val->ref_cast<int64_t>().flags(value_flags::format_as_octal);
-						break;
+					case scan_mode::literal_string:
+						if (ch == '\'')
+							mode_ = scan_mode::normal;
+						else if (ch == '\n')
+							break;
+						continue;
 
-					// decimal integers
-					// 00
-					// 10
-					// +10
-					// -10
-					case bzero_msk: [[fallthrough]];
-					case bdigit_msk: [[fallthrough]];
-					case begins_sign | has_digits | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_plus:
-					{
-						// if the value was so long we exhausted the history buffer it's reasonable to assume
-						// there was more and the value's actual type is impossible to identify without making the
-						// buffer bigger (since it could have actually been a float), so emit an error.
-						//
-						// (this will likely only come up during fuzzing and similar scenarios)
-						static constexpr size_t max_numeric_value_length =
-							utf8_buffered_reader::max_history_length - 2u;
-						if TOML_UNLIKELY(!eof_while_scanning && advance_count > max_numeric_value_length)
-							set_error_and_return_default("numeric value too long to identify type - cannot exceed "sv,
-														 max_numeric_value_length,
-														 " characters"sv);
+					case scan_mode::ml_literal_string:
+						if (ch == '\'')
+						{
+							if (++delimiters_ == 5u)
+								mode_ = scan_mode::normal;
+							continue;
+						}
+						if (delimiters_ >= 3u)
+							break;
+						delimiters_ = {};
+						continue;
 
-						val.reset(new value{ parse_integer<10>() });
-						break;
-					}
+					default: TOML_UNREACHABLE;
+				}
 
-					// hexadecimal integers
-					// 0x10
-					case bzero_msk | has_x:
-						val.reset(new value{ parse_integer<16>() });
-						val->ref_cast<int64_t>().flags(value_flags::format_as_hexadecimal);
-						break;
+				// anything that breaks out of the switch is (back) at the top level
+				mode_		= scan_mode::normal;
+				delimiters_ = {};
+				switch (ch)
+				{
+					case '#': mode_ = scan_mode::comment; break;
 
-					// decimal floats
-					// 0e1
-					// 0e-1
-					// 0e+1
-					// 0.0
-					// 0.0e1
-					// 0.0e-1
-					// 0.0e+1
-					case bzero_msk | has_e: [[fallthrough]];
-					case bzero_msk | has_e | has_minus: [[fallthrough]];
-					case bzero_msk | has_e | has_plus: [[fallthrough]];
-					case bzero_msk | has_dot: [[fallthrough]];
-					case bzero_msk | has_dot | has_e: [[fallthrough]];
-					case bzero_msk | has_dot | has_e | has_minus: [[fallthrough]];
-					case bzero_msk | has_dot | has_e | has_plus: [[fallthrough]];
-					// 1e1
-					// 1e-1
-					// 1e+1
-					// 1.0
-					// 1.0e1
-					// 1.0e-1
-					// 1.0e+1
-					case bdigit_msk | has_e: [[fallthrough]];
-					case bdigit_msk | has_e | has_minus: [[fallthrough]];
-					case bdigit_msk | has_e | has_plus: [[fallthrough]];
-					case bdigit_msk | has_dot: [[fallthrough]];
-					case bdigit_msk | has_dot | has_e: [[fallthrough]];
-					case bdigit_msk | has_dot | has_e | has_minus: [[fallthrough]];
-					case bdigit_msk | has_dot | has_e | has_plus: [[fallthrough]];
-					// +1e1
-					// +1.0
-					// +1.0e1
-					// +1.0e+1
-					// +1.0e-1
-					// -1.0e+1
-					case begins_sign | has_digits | has_e | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_e | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_e | signs_msk: [[fallthrough]];
-					// -1e1
-					// -1e+1
-					// +1e-1
-					// -1.0
-					// -1.0e1
-					// -1.0e-1
-					case begins_sign | has_digits | has_e | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_e | signs_msk: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_dot | has_e | has_minus:
-						val.reset(new value{ parse_float() });
+					case '"':
+						mode_		= scan_mode::basic_string_open;
+						delimiters_ = 1u;
 						break;
 
-					// hexadecimal floats
-					// 0x10p0
-					// 0x10p-0
-					// 0x10p+0
-					case bzero_msk | has_x | has_p: [[fallthrough]];
-					case bzero_msk | has_x | has_p | has_minus: [[fallthrough]];
-					case bzero_msk | has_x | has_p | has_plus: [[fallthrough]];
-					// -0x10p0
-					// -0x10p-0
-					// +0x10p0
-					// +0x10p+0
-					// -0x10p+0
-					// +0x10p-0
-					case begins_sign | has_digits | has_x | has_p | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_x | has_p | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_x | has_p | signs_msk: [[fallthrough]];
-					// 0x10.1p0
-					// 0x10.1p-0
-					// 0x10.1p+0
-					case bzero_msk | has_x | has_dot | has_p: [[fallthrough]];
-					case bzero_msk | has_x | has_dot | has_p | has_minus: [[fallthrough]];
-					case bzero_msk | has_x | has_dot | has_p | has_plus: [[fallthrough]];
-					// -0x10.1p0
-					// -0x10.1p-0
-					// +0x10.1p0
-					// +0x10.1p+0
-					// -0x10.1p+0
-					// +0x10.1p-0
-					case begins_sign | has_digits | has_x | has_dot | has_p | has_minus: [[fallthrough]];
-					case begins_sign | has_digits | has_x | has_dot | has_p | has_plus: [[fallthrough]];
-					case begins_sign | has_digits | has_x | has_dot | has_p | signs_msk:
-						val.reset(new value{ parse_hex_float() });
+					case '\'':
+						mode_		= scan_mode::literal_string_open;
+						delimiters_ = 1u;
 						break;
 
-					// times
-					// HH:MM
-					// HH:MM:SS
-					// HH:MM:SS.FFFFFF
-					case bzero_msk | has_colon: [[fallthrough]];
-					case bzero_msk | has_colon | has_dot: [[fallthrough]];
-					case bdigit_msk | has_colon: [[fallthrough]];
-					case bdigit_msk | has_colon | has_dot: val.reset(new value{ parse_time() }); break;
+					case '[': [[fallthrough]];
+					case '{': depth_++; break;
 
-					// local dates
-					// YYYY-MM-DD
-					case bzero_msk | has_minus: [[fallthrough]];
-					case bdigit_msk | has_minus: val.reset(new value{ parse_date() }); break;
+					case ']': [[fallthrough]];
+					case '}':
+						if (depth_)
+							depth_--;
+						break;
 
-					// date-times
-					// YYYY-MM-DDTHH:MM
-					// YYYY-MM-DDTHH:MM-HH:MM
-					// YYYY-MM-DDTHH:MM+HH:MM
-					// YYYY-MM-DD HH:MM
-					// YYYY-MM-DD HH:MM-HH:MM
-					// YYYY-MM-DD HH:MM+HH:MM
-					// YYYY-MM-DDTHH:MM:SS
-					// YYYY-MM-DDTHH:MM:SS-HH:MM
-					// YYYY-MM-DDTHH:MM:SS+HH:MM
-					// YYYY-MM-DD HH:MM:SS
-					// YYYY-MM-DD HH:MM:SS-HH:MM
-					// YYYY-MM-DD HH:MM:SS+HH:MM
-					case bzero_msk | has_minus | has_colon | has_t: [[fallthrough]];
-					case bzero_msk | signs_msk | has_colon | has_t: [[fallthrough]];
-					case bdigit_msk | has_minus | has_colon | has_t: [[fallthrough]];
-					case bdigit_msk | signs_msk | has_colon | has_t: [[fallthrough]];
-					// YYYY-MM-DDTHH:MM:SS.FFFFFF
-					// YYYY-MM-DDTHH:MM:SS.FFFFFF-HH:MM
-					// YYYY-MM-DDTHH:MM:SS.FFFFFF+HH:MM
-					// YYYY-MM-DD HH:MM:SS.FFFFFF
-					// YYYY-MM-DD HH:MM:SS.FFFFFF-HH:MM
-					// YYYY-MM-DD HH:MM:SS.FFFFFF+HH:MM
-					case bzero_msk | has_minus | has_colon | has_dot | has_t: [[fallthrough]];
-					case bzero_msk | signs_msk | has_colon | has_dot | has_t: [[fallthrough]];
-					case bdigit_msk | has_minus | has_colon | has_dot | has_t: [[fallthrough]];
-					case bdigit_msk | signs_msk | has_colon | has_dot | has_t: [[fallthrough]];
-					// YYYY-MM-DDTHH:MMZ
-					// YYYY-MM-DD HH:MMZ
-					// YYYY-MM-DDTHH:MM:SSZ
-					// YYYY-MM-DD HH:MM:SSZ
-					// YYYY-MM-DDTHH:MM:SS.FFFFFFZ
-					// YYYY-MM-DD HH:MM:SS.FFFFFFZ
-					case bzero_msk | has_minus | has_colon | has_z | has_t: [[fallthrough]];
-					case bzero_msk | has_minus | has_colon | has_dot | has_z | has_t: [[fallthrough]];
-					case bdigit_msk | has_minus | has_colon | has_z | has_t: [[fallthrough]];
-					case bdigit_msk | has_minus | has_colon | has_dot | has_z | has_t:
-						val.reset(new value{ parse_date_time() });
+					case '\n':
+						if (!depth_)
+							on_line_end(c + 1);
 						break;
-				}
-			}
-			while (false);
 
-			if (!val)
-			{
-				set_error_at(begin_pos, "could not determine value type"sv);
-				return_after_error({});
+					default: break;
+				}
 			}
-
-			val->source_ = { begin_pos, current_position(1), reader.source_path() };
-			return val;
 		}
+	};
 
-		TOML_NEVER_INLINE
-		bool parse_key()
-		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_bare_key_character(*cp) || is_string_delimiter(*cp));
-			push_parse_scope("key"sv);
+	// the reader behind incremental_parser; a window onto whichever batch of complete lines is being parsed.
+	// batches are never empty so utf8_buffered_reader always reads them in-place (see utf8_buffered_reader::restart()).
+	class utf8_batch_reader final : public utf8_reader_interface
+	{
+	  private:
+		std::string_view batch_;
+		source_path_ptr source_path_;
 
-			key_buffer.clear();
-			recording_whitespace = false;
+#if !TOML_EXCEPTIONS
+		optional<parse_error> err_;
+#endif
 
-			while (!is_error())
-			{
-				std::string_view key_segment;
-				const auto key_begin = current_position();
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit utf8_batch_reader(source_path_ptr&& source_path) noexcept //
+			: source_path_{ std::move(source_path) }
+		{}
 
-				// bare_key_segment
-				if (is_bare_key_character(*cp))
-					key_segment = parse_bare_key_segment();
+		void set_batch(std::string_view batch) noexcept
+		{
+			batch_ = batch;
+		}
 
-				// "quoted key segment"
-				else if (is_string_delimiter(*cp))
-				{
-					const auto begin_pos = cp->position;
+		void set_source_path(source_path_ptr&& source_path) noexcept
+		{
+			source_path_ = std::move(source_path);
+		}
+
+		TOML_PURE_INLINE_GETTER
+		const source_path_ptr& source_path() const noexcept final
+		{
+			return source_path_;
+		}
 
-					recording_whitespace = true;
-					parsed_string str	 = parse_string();
-					recording_whitespace = false;
-					return_if_error({});
+		TOML_NODISCARD
+		const utf8_codepoint* read_next() noexcept final
+		{
+			return nullptr; // never called
+		}
 
-					if (str.was_multi_line)
-					{
-						set_error_at(begin_pos,
-									 "multi-line strings are prohibited in "sv,
-									 key_buffer.empty() ? ""sv : "dotted "sv,
-									 "keys"sv);
-						return_after_error({});
-					}
-					else
-						key_segment = str.value;
-				}
+		TOML_NODISCARD
+		bool peek_eof() const noexcept final
+		{
+			return batch_.empty();
+		}
 
-				// ???
-				else
-					set_error_and_return_default("expected bare key starting character or string delimiter, saw '"sv,
-												 to_sv(*cp),
-												 "'"sv);
+		TOML_NODISCARD
+		std::string_view contiguous() const noexcept final
+		{
+			return batch_;
+		}
 
-				const auto key_end = current_position();
+#if !TOML_EXCEPTIONS
 
-				// whitespace following the key segment
-				consume_leading_whitespace();
+		TOML_NODISCARD
+		optional<parse_error>&& error() noexcept final
+		{
+			return std::move(err_);
+		}
 
-				// store segment
-				key_buffer.push_back(key_segment, key_begin, key_end);
+#endif
+	};
 
-				if TOML_UNLIKELY(key_buffer.size() > max_dotted_keys_depth)
-					set_error_and_return_default("exceeded maximum dotted keys depth of "sv,
-												 max_dotted_keys_depth,
-												 " (TOML_MAX_DOTTED_KEYS_DEPTH)"sv);
+#if TOML_ENABLE_MMAP
 
-				// eof or no more key to come
-				if (is_eof() || *cp != U'.')
-					break;
+	class mapped_file
+	{
+	  private:
+		void* base_ = {};
+		size_t size_ = {};
+#if TOML_WINDOWS
+		void* mapping_ = {};
+#endif
 
-				// was a dotted key - go around again
-				advance_and_return_if_error_or_eof({});
-				consume_leading_whitespace();
-				set_error_and_return_if_eof({});
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit mapped_file(const std::string& path)
+		{
+#if TOML_WINDOWS
+			// spelled out rather than using the <Windows.h> macros so this compiles the same way with or without it
+			constexpr unsigned long generic_read		  = 0x80000000ul;
+			constexpr unsigned long file_share_read_write = 0x00000001ul | 0x00000002ul;
+			constexpr unsigned long open_existing		  = 3ul;
+			constexpr unsigned long normal_sequential	  = 0x00000080ul | 0x08000000ul;
+			constexpr unsigned long page_readonly		  = 0x02ul;
+			constexpr unsigned long file_map_read		  = 0x0004ul;
+			constexpr unsigned long invalid_file_size	  = 0xFFFFFFFFul;
+
+			void* const file = ::CreateFileW(impl::widen(path).c_str(),
+											 generic_read,
+											 file_share_read_write,
+											 nullptr,
+											 open_existing,
+											 normal_sequential,
+											 nullptr);
+			if (file == reinterpret_cast<void*>(static_cast<intptr_t>(-1))) // INVALID_HANDLE_VALUE
+				return;
+
+			// a low word of INVALID_FILE_SIZE is ambiguous without GetLastError(), so those just aren't mapped
+			unsigned long size_high		  = 0;
+			const unsigned long size_low  = ::GetFileSize(file, &size_high);
+			const auto file_size		  = (static_cast<unsigned long long>(size_high) << 32) | size_low;
+			if (size_low != invalid_file_size && file_size > 0u && file_size <= ~size_t{})
+			{
+				mapping_ = ::CreateFileMappingW(file, nullptr, page_readonly, 0, 0, nullptr);
+				if (mapping_)
+				{
+					base_ = ::MapViewOfFile(mapping_, file_map_read, 0, 0, 0);
+					if (base_)
+						size_ = static_cast<size_t>(file_size);
+					else
+					{
+						::CloseHandle(mapping_);
+						mapping_ = {};
+					}
+				}
 			}
-			return_if_error({});
+			::CloseHandle(file);
+#else
+			const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd == -1)
+				return;
 
-			return true;
+			struct stat file_info;
+			if (::fstat(fd, &file_info) == 0 && S_ISREG(file_info.st_mode) && file_info.st_size > 0
+				&& static_cast<unsigned long long>(file_info.st_size) <= ~size_t{})
+			{
+				const auto file_size = static_cast<size_t>(file_info.st_size);
+				void* const base	 = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (base != MAP_FAILED)
+				{
+					::posix_madvise(base, file_size, POSIX_MADV_SEQUENTIAL);
+					base_ = base;
+					size_ = file_size;
+				}
+			}
+			::close(fd);
+#endif
 		}
 
-		TOML_NODISCARD
-		key make_key(size_t segment_index) const
+		~mapped_file() noexcept
 		{
-			TOML_ASSERT(key_buffer.size() > segment_index);
+#if TOML_WINDOWS
+			if (base_)
+				::UnmapViewOfFile(base_);
+			if (mapping_)
+				::CloseHandle(mapping_);
+#else
+			if (base_)
+				::munmap(base_, size_);
+#endif
+		}
 
-			return key{
-				key_buffer[segment_index],
-				source_region{ key_buffer.starts[segment_index], key_buffer.ends[segment_index], root.source().path }
-			};
+		mapped_file(const mapped_file&)			   = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		TOML_PURE_INLINE_GETTER
+		explicit operator bool() const noexcept
+		{
+			return base_ != nullptr;
 		}
 
-		TOML_NODISCARD
-		TOML_NEVER_INLINE
-		table* parse_table_header()
+		TOML_PURE_INLINE_GETTER
+		std::string_view view() const noexcept
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(*cp == U'[');
-			push_parse_scope("table header"sv);
+			return { static_cast<const char*>(base_), size_ };
+		}
+	};
 
-			const source_position header_begin_pos = cp->position;
-			source_position header_end_pos;
-			bool is_arr = false;
+#endif
 
-			// parse header
-			{
-				// skip first '['
-				advance_and_return_if_error_or_eof({});
+	// parse_contents is called with the file's contents (as either a std::string_view or a std::istream&)
+	// and its path, and returns a Result.
+	template <typename Result, typename Func>
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	Result do_parse_file(std::string_view file_path, Func&& parse_contents)
+	{
+#if TOML_EXCEPTIONS
+#define TOML_PARSE_FILE_ERROR(msg, path)                                                                               \
+	throw parse_error(msg, source_position{}, source_path_ptr{ std::move(path) })
+#else
+#define TOML_PARSE_FILE_ERROR(msg, path)                                                                               \
+	return Result(parse_error(msg, source_position{}, source_path_ptr{ std::move(path) }))
+#endif
 
-				// skip past any whitespace that followed the '['
-				const bool had_leading_whitespace = consume_leading_whitespace();
-				set_error_and_return_if_eof({});
+		std::string file_path_str(file_path);
 
-				// skip second '[' (if present)
-				if (*cp == U'[')
-				{
-					if (had_leading_whitespace)
-						set_error_and_return_default(
-							"[[array-of-table]] brackets must be contiguous (i.e. [ [ this ] ] is prohibited)"sv);
+#if TOML_ENABLE_MMAP
 
-					is_arr = true;
-					advance_and_return_if_error_or_eof({});
+		// map the file straight into memory and parse it in-place, regardless of size
+		// (empty files, pipes, device nodes etc. can't be mapped so they fall through to the stream path below)
+		if (const mapped_file mapping{ file_path_str })
+			return parse_contents(mapping.view(), std::move(file_path_str));
 
-					// skip past any whitespace that followed the '['
-					consume_leading_whitespace();
-					set_error_and_return_if_eof({});
-				}
+#endif
 
-				// check for a premature closing ']'
-				if (*cp == U']')
-					set_error_and_return_default("tables with blank bare keys are explicitly prohibited"sv);
+		// open file with a custom-sized stack buffer
+		std::ifstream file;
+		TOML_OVERALIGNED char file_buffer[sizeof(void*) * 1024u];
+		file.rdbuf()->pubsetbuf(file_buffer, sizeof(file_buffer));
+#if TOML_WINDOWS && !(defined(__MINGW32__) || defined(__MINGW64__))
+		file.open(impl::widen(file_path_str).c_str(), std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+#else
+		file.open(file_path_str, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+#endif
+		if (!file.is_open())
+			TOML_PARSE_FILE_ERROR("File could not be opened for reading", file_path_str);
 
-				if (!is_bare_key_character(*cp) && !is_string_delimiter(*cp))
-					set_error_and_return_default("expected bare key starting character or string delimiter, saw '"sv,
-												 to_sv(*cp),
-												 "'"sv);
+		// get size
+		const auto file_size = file.tellg();
+		if (file_size == -1)
+			TOML_PARSE_FILE_ERROR("Could not determine file size", file_path_str);
+		file.seekg(0, std::ifstream::beg);
 
-				// get the actual key
-				start_recording();
-				parse_key();
-				stop_recording(1u);
-				return_if_error({});
+		// read the whole file into memory first if the file isn't too large
+		constexpr auto large_file_threshold = 1024 * 1024 * 2; // 2 MB
+		if (file_size <= large_file_threshold)
+		{
+			std::vector<char> file_data;
+			file_data.resize(static_cast<size_t>(file_size));
+			file.read(file_data.data(), static_cast<std::streamsize>(file_size));
+			return parse_contents(std::string_view{ file_data.data(), file_data.size() }, std::move(file_path_str));
+		}
 
-				// skip past any whitespace that followed the key
-				consume_leading_whitespace();
-				return_if_error({});
-				set_error_and_return_if_eof({});
+		// otherwise parse it using the streams
+		else
+			return parse_contents(file, std::move(file_path_str));
 
-				// consume the closing ']'
-				if (*cp != U']')
-					set_error_and_return_default("expected ']', saw '"sv, to_sv(*cp), "'"sv);
-				if (is_arr)
-				{
-					advance_and_return_if_error_or_eof({});
-					if (*cp != U']')
-						set_error_and_return_default("expected ']', saw '"sv, to_sv(*cp), "'"sv);
-				}
-				advance_and_return_if_error({});
-				header_end_pos = current_position(1);
+#undef TOML_PARSE_FILE_ERROR
+	}
 
-				// handle the rest of the line after the header
-				consume_leading_whitespace();
-				if (!is_eof() && !consume_comment() && !consume_line_break())
-					set_error_and_return_default("expected a comment or whitespace, saw '"sv, to_sv(cp), "'"sv);
-			}
-			TOML_ASSERT(!key_buffer.empty());
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	parse_result do_parse_file(std::string_view file_path)
+	{
+		return do_parse_file<parse_result>(file_path,
+										   [](auto&& doc, std::string&& path)
+										   { return parse(static_cast<decltype(doc)&&>(doc), std::move(path)); });
+	}
 
-			// check if each parent is a table/table array, or can be created implicitly as a table.
-			table* parent = &root;
-			for (size_t i = 0, e = key_buffer.size() - 1u; i < e; i++)
-			{
-				const std::string_view segment = key_buffer[i];
-				auto pit					   = parent->lower_bound(segment);
+	TOML_INTERNAL_LINKAGE
+	sax_parse_result do_parse_file(std::string_view file_path, sax_handler & handler)
+	{
+		return do_parse_file<sax_parse_result>(file_path,
+											   [&](auto&& doc, std::string&& path)
+											   { return parse(static_cast<decltype(doc)&&>(doc), handler, path); });
+	}
 
-				// parent already existed
-				if (pit != parent->end() && pit->first == segment)
-				{
-					node& p = pit->second;
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	parse_result do_parse_file(std::string_view file_path, const parse_options& options)
+	{
+		return do_parse_file<parse_result>(file_path,
+										   [&](auto&& doc, std::string&& path)
+										   { return parse(static_cast<decltype(doc)&&>(doc), options, path); });
+	}
 
-					if (auto tbl = p.as_table())
-					{
-						// adding to closed inline tables is illegal
-						if (tbl->is_inline() && !impl::find(open_inline_tables.begin(), open_inline_tables.end(), tbl))
-							set_error_and_return_default("cannot insert '"sv,
-														 to_sv(recording_buffer),
-														 "' into existing inline table"sv);
+	// how many threads parse_options::threads actually means.
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	size_t resolve_threads(size_t threads) noexcept
+	{
+#if TOML_ENABLE_THREADS
+		if (!threads)
+			threads = std::thread::hardware_concurrency();
+		return threads ? threads : 1u;
+#else
+		TOML_UNUSED(threads);
+		return 1u;
+#endif
+	}
 
-						parent = tbl;
-					}
-					else if (auto arr = p.as_array(); arr && impl::find(table_arrays.begin(), table_arrays.end(), arr))
-					{
-						// table arrays are a special case;
-						// the spec dictates we select the most recently declared element in the array.
-						TOML_ASSERT(!arr->empty());
-						TOML_ASSERT(arr->back().is_table());
-						parent = &arr->back().ref_cast<table>();
-					}
-					else
-					{
-						if (!is_arr && p.type() == node_type::table)
-							set_error_and_return_default("cannot redefine existing table '"sv,
-														 to_sv(recording_buffer),
-														 "'"sv);
-						else
-							set_error_and_return_default("cannot redefine existing "sv,
-														 to_sv(p.type()),
-														 " '"sv,
-														 to_sv(recording_buffer),
-														 "' as "sv,
-														 is_arr ? "array-of-tables"sv : "table"sv);
-					}
-				}
+	// calls func(i) for each i in [0, jobs), spread over up to max_threads threads (including the calling one).
+	// func must not throw.
+	template <typename Func>
+	TOML_INTERNAL_LINKAGE
+	void run_in_parallel(size_t jobs, size_t max_threads, Func&& func)
+	{
+		if (!jobs)
+			return;
 
-				// need to create a new implicit table
-				else
-				{
-					pit		  = parent->emplace_hint<table>(pit, make_key(i));
-					table& p  = pit->second.ref_cast<table>();
-					p.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
+		std::atomic<size_t> next_job{};
+		const auto work = [&]() noexcept
+		{
+			for (auto i = next_job++; i < jobs; i = next_job++)
+				func(i);
+		};
 
-					implicit_tables.push_back(&p);
-					parent = &p;
-				}
+#if TOML_ENABLE_THREADS
+		std::vector<std::thread> threads;
+		const auto extra_threads = (max_threads < jobs ? max_threads : jobs) - 1u;
+		threads.reserve(extra_threads);
+		for (size_t i = 0; i < extra_threads; i++)
+		{
+#if TOML_EXCEPTIONS
+			try
+			{
+				threads.emplace_back(work);
+			}
+			catch (const std::system_error&)
+			{
+				break; // the threads that did start (and this one) will pick up the slack
 			}
+#else
+			threads.emplace_back(work);
+#endif
+		}
 
-			const auto last_segment = key_buffer.back();
-			auto it					= parent->lower_bound(last_segment);
+		work();
+		for (auto& thread : threads)
+			thread.join();
+#else
+		TOML_UNUSED(max_threads);
+		work();
+#endif
+	}
 
-			// if there was already a matching node some sanity checking is necessary;
-			// this is ok if we're making an array and the existing element is already an array (new element)
-			// or if we're making a table and the existing element is an implicitly-created table (promote it),
-			// otherwise this is a redefinition error.
-			if (it != parent->end() && it->first == last_segment)
+#if TOML_ENABLE_THREADS
+
+	// splits a document at its top-level table headers and parses the key-value pairs between them concurrently,
+	// then merges them in document order. returns nothing if it wasn't worth it, or if the result might differ from
+	// parsing the document in one go (which includes all errors), in which case the caller should do just that.
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	optional<table> parse_in_parallel(std::string_view doc, std::string_view source_path, const parse_options& options)
+	{
+		const size_t min_bytes = options.min_bytes_per_thread ? options.min_bytes_per_thread : 1u;
+		auto max_threads	   = resolve_threads(options.threads);
+		if (max_threads > doc.length() / min_bytes)
+			max_threads = doc.length() / min_bytes;
+		if (max_threads < 2u)
+			return {};
+
+		if (doc.length() >= 3u && memcmp(utf8_byte_order_mark.data(), doc.data(), 3u) == 0)
+			doc.remove_prefix(3u);
+
+		// chunk 0 is everything before the first table header, the rest each start with one
+		struct chunk
+		{
+			std::string_view header;
+			std::string_view body;
+			source_position header_pos;
+			source_position body_pos;
+		};
+		std::vector<chunk> chunks;
+		{
+			const auto begin = doc.data();
+			const auto end	 = begin + doc.length();
+
+			std::vector<const char*> starts{ begin };
+			const auto check_line = [&](const char* line) noexcept
 			{
-				node& matching_node = it->second;
-				if (auto arr = matching_node.as_array();
-					is_arr && arr && impl::find(table_arrays.begin(), table_arrays.end(), arr))
+				while (line < end && (*line == ' ' || *line == '\t'))
+					line++;
+				return line < end && *line == '[';
+			};
+			if (check_line(begin))
+				starts.push_back(begin);
+			top_level_scanner{}.scan(begin,
+									 end,
+									 [&](const char* line)
+									 {
+										 if (check_line(line))
+											 starts.push_back(line);
+									 });
+			if (starts.size() < 2u)
+				return {};
+			starts.push_back(end);
+
+			chunks.resize(starts.size() - 1u);
+			source_index line = 1;
+			for (size_t i = 0; i < chunks.size(); i++)
+			{
+				auto& c	 = chunks[i];
+				auto pos = starts[i];
+				if (i)
 				{
-					table& tbl	= arr->emplace_back<table>();
-					tbl.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
-					return &tbl;
+					auto header_end = static_cast<const char*>(memchr(pos, '\n', static_cast<size_t>(starts[i + 1] - pos)));
+					header_end		= header_end ? header_end + 1 : starts[i + 1];
+					c.header		= { pos, static_cast<size_t>(header_end - pos) };
+					c.header_pos	= { line, 1 };
+					line += header_end[-1] == '\n' ? 1u : 0u;
+					pos = header_end;
 				}
+				c.body	   = { pos, static_cast<size_t>(starts[i + 1] - pos) };
+				c.body_pos = { line, 1 };
 
-				else if (auto tbl = matching_node.as_table(); !is_arr && tbl && !implicit_tables.empty())
+				for (auto lf = pos; (lf = static_cast<const char*>(memchr(lf, '\n', static_cast<size_t>(starts[i + 1] - lf))));
+					 lf++)
+					line++;
+			}
+		}
+
+		// parse the chunks, in runs of consecutive ones of roughly equal size so each run only needs one parser
+		std::vector<size_t> runs{ 0u };
+		{
+			const auto run_length = doc.length() / (max_threads * 4u) + 1u;
+			size_t length		  = {};
+			for (size_t i = 0; i < chunks.size(); i++)
+			{
+				length += chunks[i].header.length() + chunks[i].body.length();
+				if (length >= run_length)
 				{
-					if (auto found = impl::find(implicit_tables.begin(), implicit_tables.end(), tbl); found)
-					{
-						bool ok = true;
-						if (!tbl->empty())
+					runs.push_back(i + 1u);
+					length = {};
+				}
+			}
+			if (runs.back() != chunks.size())
+				runs.push_back(chunks.size());
+		}
+
+		const auto path = source_path.empty() ? source_path_ptr{} : source_path_ptr{ source_path };
+		std::vector<table> bodies(chunks.size());
+		source_position last_body_end{};
+		std::atomic<bool> failed{};
+		run_in_parallel(runs.size() - 1u,
+						max_threads,
+						[&](size_t run) noexcept
 						{
-							for (auto& [_, child] : *tbl)
+#if TOML_EXCEPTIONS
+							try
+#endif
 							{
-								if (!child.is_table() && !child.is_array_of_tables())
+								utf8_batch_reader reader{ source_path_ptr{ path } };
+								impl::parser parser{ reader, nullptr, nullptr, &options };
+								for (size_t i = runs[run]; i < runs[run + 1u] && !failed; i++)
 								{
-									ok = false;
-									break;
+									if (chunks[i].body.empty())
+										continue;
+
+									reader.set_batch(chunks[i].body);
+									parser.parse_batch(chunks[i].body_pos);
+#if !TOML_EXCEPTIONS
+									if (parser.failed())
+									{
+										failed = true;
+										return;
+									}
+#endif
+									if (i + 1u == chunks.size())
+										last_body_end = parser.end_position();
+									bodies[i] = parser.release_root();
 								}
 							}
-						}
-
-						if (ok)
-						{
-							implicit_tables.erase(implicit_tables.cbegin() + (found - implicit_tables.data()));
-							tbl->source_.begin = header_begin_pos;
-							tbl->source_.end   = header_end_pos;
-							return tbl;
-						}
-					}
-				}
-
-				// if we get here it's a redefinition error.
-				if (!is_arr && matching_node.type() == node_type::table)
-				{
-					set_error_at(header_begin_pos,
-								 "cannot redefine existing table '"sv,
-								 to_sv(recording_buffer),
-								 "'"sv);
-					return_after_error({});
-				}
-				else
-				{
-					set_error_at(header_begin_pos,
-								 "cannot redefine existing "sv,
-								 to_sv(matching_node.type()),
-								 " '"sv,
-								 to_sv(recording_buffer),
-								 "' as "sv,
-								 is_arr ? "array-of-tables"sv : "table"sv);
-					return_after_error({});
-				}
-			}
+#if TOML_EXCEPTIONS
+							catch (...)
+							{
+								failed = true;
+							}
+#endif
+						});
+		if (failed)
+			return {};
 
-			// there was no matching node, sweet - we can freely instantiate a new table/table array.
-			else
+		// merge them (the headers are all parsed here so the tables they refer to are checked and created in order)
+		utf8_batch_reader reader{ source_path_ptr{ path } };
+		impl::parser parser{ reader, nullptr, nullptr, &options };
+#if TOML_EXCEPTIONS
+		try
+#endif
+		{
+			for (size_t i = 0; i < chunks.size(); i++)
 			{
-				auto last_key = make_key(key_buffer.size() - 1u);
-
-				// if it's an array we need to make the array and it's first table element,
-				// set the starting regions, and return the table element
-				if (is_arr)
-				{
-					it			   = parent->emplace_hint<array>(it, std::move(last_key));
-					array& tbl_arr = it->second.ref_cast<array>();
-					table_arrays.push_back(&tbl_arr);
-					tbl_arr.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
-
-					table& tbl	= tbl_arr.emplace_back<table>();
-					tbl.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
-					return &tbl;
-				}
-
-				// otherwise we're just making a table
-				else
+				if (i)
 				{
-					it			= parent->emplace_hint<table>(it, std::move(last_key));
-					table& tbl	= it->second.ref_cast<table>();
-					tbl.source_ = { header_begin_pos, header_end_pos, reader.source_path() };
-					return &tbl;
+					reader.set_batch(chunks[i].header);
+					parser.parse_batch(chunks[i].header_pos);
+#if !TOML_EXCEPTIONS
+					if (parser.failed())
+						return {};
+#endif
 				}
+				if (!parser.merge_chunk(bodies[i]))
+					return {};
 			}
 		}
-
-		TOML_NEVER_INLINE
-		bool parse_key_value_pair_and_insert(table* tbl)
+#if TOML_EXCEPTIONS
+		catch (const parse_error&)
 		{
-			return_if_error({});
-			assert_not_eof();
-			TOML_ASSERT_ASSUME(is_string_delimiter(*cp) || is_bare_key_character(*cp));
-			push_parse_scope("key-value pair"sv);
-
-			// read the key into the key buffer
-			start_recording();
-			parse_key();
-			stop_recording(1u);
-			return_if_error({});
-			TOML_ASSERT(key_buffer.size() >= 1u);
-
-			// skip past any whitespace that followed the key
-			consume_leading_whitespace();
-			set_error_and_return_if_eof({});
-
-			// '='
-			if (*cp != U'=')
-				set_error_and_return_default("expected '=', saw '"sv, to_sv(*cp), "'"sv);
-			advance_and_return_if_error_or_eof({});
-
-			// skip past any whitespace that followed the '='
-			consume_leading_whitespace();
-			return_if_error({});
-			set_error_and_return_if_eof({});
+			return {};
+		}
+#endif
 
-			// check that the next character could actually be a value
-			if (is_value_terminator(*cp))
-				set_error_and_return_default("expected value, saw '"sv, to_sv(*cp), "'"sv);
+		parser.finish_document(chunks.back().body.empty() ? parser.end_position() : last_body_end);
+		return parser.release_root();
+	}
 
-			// if it's a dotted kvp we need to spawn the parent sub-tables if necessary,
-			// and set the target table to the second-to-last one in the chain
-			if (key_buffer.size() > 1u)
-			{
-				for (size_t i = 0; i < key_buffer.size() - 1u; i++)
-				{
-					const std::string_view segment = key_buffer[i];
-					auto pit					   = tbl->lower_bound(segment);
+#endif
 
-					// parent already existed
-					if (pit != tbl->end() && pit->first == segment)
-					{
-						table* p = pit->second.as_table();
+	// parses whole documents one after the other with the same parser, so the buffers etc. it needs only get
+	// allocated once per batch instead of once per document.
+	class reusable_parser
+	{
+	  private:
+		const parse_options* options_;
+		utf8_batch_reader reader_{ source_path_ptr{} };
+		std::unique_ptr<impl::parser> parser_;
 
-						// redefinition
-						if TOML_UNLIKELY(!p
-							|| !(impl::find(dotted_key_tables.begin(), dotted_key_tables.end(), p)
-								 || impl::find(implicit_tables.begin(), implicit_tables.end(), p)))
-						{
-							set_error_at(key_buffer.starts[i],
-										 "cannot redefine existing "sv,
-										 to_sv(pit->second.type()),
-										 " as dotted key-value pair"sv);
-							return_after_error({});
-						}
+	  public:
+		TOML_NODISCARD_CTOR
+		explicit reusable_parser(const parse_options& options) noexcept //
+			: options_{ &options }
+		{}
 
-						tbl = p;
-					}
+		TOML_NODISCARD
+		parse_result parse(std::string_view doc, source_path_ptr&& source_path)
+		{
+			if (doc.length() >= 3u && memcmp(utf8_byte_order_mark.data(), doc.data(), 3u) == 0)
+				doc.remove_prefix(3u);
 
-					// need to create a new implicit table
-					else
-					{
-						pit		  = tbl->emplace_hint<table>(pit, make_key(i));
-						table& p  = pit->second.ref_cast<table>();
-						p.source_ = pit->first.source();
+			reader_.set_batch(doc);
+			reader_.set_source_path(std::move(source_path));
+			if (parser_)
+				parser_->reset();
+			else
+				parser_ = std::make_unique<impl::parser>(reader_, nullptr, nullptr, options_);
 
-						dotted_key_tables.push_back(&p);
-						tbl = &p;
-					}
-				}
+#if TOML_EXCEPTIONS
+			try
+			{
+				if (!doc.empty())
+					parser_->parse_batch({ 1, 1 });
 			}
-
-			// ensure this isn't a redefinition
-			const std::string_view last_segment = key_buffer.back();
-			auto it								= tbl->lower_bound(last_segment);
-			if (it != tbl->end() && it->first == last_segment)
+			catch (...)
 			{
-				set_error("cannot redefine existing "sv,
-						  to_sv(it->second.type()),
-						  " '"sv,
-						  to_sv(recording_buffer),
-						  "'"sv);
-				return_after_error({});
+				parser_.reset(); // (not reusable after an error)
+				throw;
 			}
+#else
+			if (!doc.empty())
+				parser_->parse_batch({ 1, 1 });
+			if (parser_->failed())
+			{
+				auto err = *parser_->error();
+				parser_.reset(); // (not reusable after an error)
+				return parse_result{ std::move(err) };
+			}
+#endif
 
-			// create the key first since the key buffer will likely get overwritten during value parsing (inline
-			// tables)
-			auto last_key = make_key(key_buffer.size() - 1u);
-
-			// now we can actually parse the value
-			node_ptr val = parse_value();
-			return_if_error({});
-
-			tbl->emplace_hint<node_ptr>(it, std::move(last_key), std::move(val));
-			return true;
+			parser_->finish_document();
+			return parse_result{ parser_->release_root() };
 		}
+	};
 
-		void parse_document()
+	// parses count documents with parse_one(i, reusable_parser&), spread over parse_options::threads threads.
+	// if errors is given, each document's parse_error is stored in it rather than the first of them being thrown.
+	template <typename Func>
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	std::vector<parse_result> do_parse_many(size_t count,
+											const parse_options& options,
+											std::vector<optional<parse_error>>* errors,
+											Func&& parse_one)
+	{
+		std::vector<parse_result> results(count);
+		if (errors)
 		{
-			assert_not_error();
-			assert_not_eof();
-			push_parse_scope("root table"sv);
-
-			table* current_table = &root;
+			errors->clear();
+			errors->resize(count);
+		}
+#if TOML_EXCEPTIONS
+		std::vector<std::exception_ptr> exceptions(count);
+#endif
 
-			do
-			{
-				return_if_error();
+		// in runs of consecutive documents, one parser per run
+		const auto max_threads = resolve_threads(options.threads);
+		const auto run_length  = count / (max_threads * 4u) + 1u;
+		run_in_parallel((count + run_length - 1u) / run_length,
+						max_threads,
+						[&](size_t run) noexcept
+						{
+							reusable_parser parser{ options };
+							const auto end = run_length * (run + 1u) < count ? run_length * (run + 1u) : count;
+							for (size_t i = run_length * run; i < end; i++)
+							{
+#if TOML_EXCEPTIONS
+								try
+								{
+									results[i] = parse_one(i, parser);
+								}
+								catch (const parse_error& err)
+								{
+									if (errors)
+										(*errors)[i] = err;
+									else
+										exceptions[i] = std::current_exception();
+								}
+								catch (...)
+								{
+									exceptions[i] = std::current_exception();
+								}
+#else
+								results[i] = parse_one(i, parser);
+								if (errors && !results[i])
+									(*errors)[i] = results[i].error();
+#endif
+							}
+						});
 
-				// leading whitespace, line endings, comments
-				if (consume_leading_whitespace() || consume_line_break() || consume_comment())
-					continue;
-				return_if_error();
+#if TOML_EXCEPTIONS
+		for (auto& ex : exceptions)
+			if (ex)
+				std::rethrow_exception(ex);
+#endif
+		return results;
+	}
 
-				// [tables]
-				// [[table array]]
-				if (*cp == U'[')
-					current_table = parse_table_header();
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	std::vector<parse_result> do_parse_many(const std::string_view* docs,
+											size_t count,
+											const parse_options& options,
+											std::vector<optional<parse_error>>* errors)
+	{
+		return do_parse_many(count,
+							 options,
+							 errors,
+							 [&](size_t i, reusable_parser& parser) { return parser.parse(docs[i], source_path_ptr{}); });
+	}
 
-				// bare_keys
-				// dotted.keys
-				// "quoted keys"
-				else if (is_bare_key_character(*cp) || is_string_delimiter(*cp))
-				{
-					push_parse_scope("key-value pair"sv);
+	TOML_NODISCARD
+	TOML_INTERNAL_LINKAGE
+	std::vector<parse_result> do_parse_files(const std::string_view* file_paths,
+											 size_t count,
+											 const parse_options& options,
+											 std::vector<optional<parse_error>>* errors)
+	{
+		return do_parse_many(
+			count,
+			options,
+			errors,
+			[&](size_t i, reusable_parser& parser)
+			{
+				return do_parse_file<parse_result>(file_paths[i],
+												   [&](auto&& doc, std::string&& path)
+												   {
+													   if constexpr (std::is_same_v<impl::remove_cvref<decltype(doc)>, std::string_view>)
+														   return parser.parse(doc, source_path_ptr{ std::move(path) });
+													   else
+														   return parse(doc, options, path); // (big files read via streams)
+												   });
+			});
+	}
+}
+TOML_ANON_NAMESPACE_END;
 
-					parse_key_value_pair_and_insert(current_table);
+TOML_IMPL_NAMESPACE_START
+{
+	TOML_ABI_NAMESPACE_BOOL(TOML_EXCEPTIONS, impl_ex, impl_noex);
 
-					// handle the rest of the line after the kvp
-					// (this is not done in parse_key_value_pair() because that is also used for inline tables)
-					consume_leading_whitespace();
-					return_if_error();
-					if (!is_eof() && !consume_comment() && !consume_line_break())
-						set_error("expected a comment or whitespace, saw '"sv, to_sv(cp), "'"sv);
-				}
+	class incremental_parser_state
+	{
+	  private:
+		source_path_ptr source_path_;
+		utf8_batch_reader reader_;
+		parser parser_;
+		std::string pending_; // the incomplete line(s) at the end of the input so far
+		top_level_scanner scanner_;
+		bool started_ = false;
 
-				else // ??
-					set_error("expected keys, tables, whitespace or comments, saw '"sv, to_sv(cp), "'"sv);
-			}
-			while (!is_eof());
+#if TOML_EXCEPTIONS
+		optional<parse_error> err_;
+#endif
 
-			auto eof_pos	 = current_position(1);
-			root.source_.end = eof_pos;
-			if (current_table && current_table != &root && current_table->source_.end <= current_table->source_.begin)
-				current_table->source_.end = eof_pos;
+		// returns the end of the last complete top-level line in [begin, end), or nullptr if there wasn't one
+		TOML_NODISCARD
+		const char* scan(const char* begin, const char* end) noexcept
+		{
+			const char* last_line_end = {};
+			scanner_.scan(begin, end, [&](const char* line_end) noexcept { last_line_end = line_end; });
+			return last_line_end;
 		}
 
-		static void update_region_ends(node& nde) noexcept
+		void parse_batch(std::string_view batch, bool final_batch)
 		{
-			const auto type = nde.type();
-			if (type > node_type::array)
+			if (!started_)
+			{
+				started_ = true;
+				if (batch.length() >= 3u && memcmp(utf8_byte_order_mark.data(), batch.data(), 3u) == 0)
+					batch.remove_prefix(3u);
+			}
+			if (batch.empty())
 				return;
 
-			if (type == node_type::table)
-			{
-				auto& tbl = nde.ref_cast<table>();
-				if (tbl.is_inline()) // inline tables (and all their inline descendants) are already correctly
-									 // terminated
-					return;
+			reader_.set_batch(batch);
 
-				auto end = nde.source_.end;
-				for (auto&& [k, v] : tbl)
-				{
-					TOML_UNUSED(k);
-					update_region_ends(v);
-					if (end < v.source_.end)
-						end = v.source_.end;
-				}
+#if TOML_EXCEPTIONS
+			try
+			{
+				parser_.parse_batch(final_batch);
 			}
-			else // arrays
+			catch (const parse_error& e)
 			{
-				auto& arr = nde.ref_cast<array>();
-				auto end  = nde.source_.end;
-				for (auto&& v : arr)
-				{
-					update_region_ends(v);
-					if (end < v.source_.end)
-						end = v.source_.end;
-				}
-				nde.source_.end = end;
+				err_.emplace(e);
+				throw;
 			}
+#else
+			parser_.parse_batch(final_batch);
+#endif
 		}
 
 	  public:
-		parser(utf8_reader_interface&& reader_) //
-			: reader{ reader_ }
+		TOML_NODISCARD_CTOR
+		explicit incremental_parser_state(source_path_ptr source_path) //
+			: source_path_{ source_path },
+			  reader_{ std::move(source_path) },
+			  parser_{ reader_ }
+		{}
+
+		TOML_NODISCARD
+		const source_path_ptr& source_path() const noexcept
 		{
-			root.source_ = { prev_pos, prev_pos, reader.source_path() };
+			return source_path_;
+		}
 
-			if (!reader.peek_eof())
-			{
-				cp = reader.read_next();
+		TOML_PURE_GETTER
+		bool failed() const noexcept
+		{
+#if TOML_EXCEPTIONS
+			return !!err_;
+#else
+			return parser_.failed();
+#endif
+		}
 
-#if !TOML_EXCEPTIONS
-				if (reader.error())
+		void feed(std::string_view chunk)
+		{
+			if (failed() || chunk.empty())
+				return;
+
+			// nothing left over from the previous chunk; complete lines can be parsed straight out of this one
+			if (pending_.empty())
+			{
+				const auto line_end = scan(chunk.data(), chunk.data() + chunk.length());
+				if (line_end)
 				{
-					err = std::move(reader.error());
-					return;
+					const auto len = static_cast<size_t>(line_end - chunk.data());
+					parse_batch(chunk.substr(0, len), false);
+					chunk.remove_prefix(len);
 				}
-#endif
-
-				if (cp)
-					parse_document();
+				pending_.assign(chunk);
+				return;
 			}
 
-			update_region_ends(root);
+			const auto old_len = pending_.length();
+			pending_.append(chunk);
+			if (const auto line_end = scan(pending_.data() + old_len, pending_.data() + pending_.length()))
+			{
+				const auto len = static_cast<size_t>(line_end - pending_.data());
+				parse_batch(std::string_view{ pending_.data(), len }, false);
+				pending_.erase(0, len);
+			}
 		}
 
 		TOML_NODISCARD
-		operator parse_result() && noexcept
+		parse_result finish()
 		{
 #if TOML_EXCEPTIONS
-
-			return { std::move(root) };
-
-#else
-
-			if (err)
-				return parse_result{ *std::move(err) };
-			else
-				return parse_result{ std::move(root) };
-
+			if (err_)
+				throw *err_;
 #endif
+
+			parse_batch(pending_, true);
+			pending_.clear();
+			parser_.finish_document();
+			return std::move(parser_);
 		}
 	};
 
-	TOML_EXTERNAL_LINKAGE
-	node_ptr parser::parse_array()
+	class lazy_document_state
 	{
-		return_if_error({});
-		assert_not_eof();
-		TOML_ASSERT_ASSUME(*cp == U'[');
-		push_parse_scope("array"sv);
+	  private:
+		std::string doc_; // (the values that were skipped over are spans of it, unless the caller's was borrowed)
+		source_path_ptr source_path_;
+		table root_;
+		value_key_set values_{ buffer_allocator{} }; // the values that were skipped over, in document order
+		size_t remaining_ = {};						 // how many of them haven't been parsed yet
 
-		// skip opening '['
-		advance_and_return_if_error_or_eof({});
+#if TOML_EXCEPTIONS
+		bool failed_ = false;
+#else
+		optional<parse_error> err_;
+#endif
 
-		node_ptr arr_ptr{ new array{} };
-		array& arr = arr_ptr->ref_cast<array>();
-		enum class TOML_CLOSED_ENUM parse_type : int
+		TOML_PURE_INLINE_GETTER
+		table& parent_of(const value_key_set::entry& val) noexcept
 		{
-			none,
-			comma,
-			val
-		};
-		parse_type prev = parse_type::none;
+			return val.parent ? *val.parent : root_;
+		}
 
-		while (!is_error())
+		node& insert(value_key_set::entry& val, node_ptr&& nde)
 		{
-			while (consume_leading_whitespace() || consume_line_break() || consume_comment())
-				continue;
-			set_error_and_return_if_eof({});
+			val.source = {};
+			remaining_--;
 
-			// commas - only legal after a value
-			if (*cp == U',')
+			auto& parent = parent_of(val);
+			return parent.emplace_hint<node_ptr>(parent.lower_bound(val.k.str()), key{ val.k }, std::move(nde))
+				->second;
+		}
+
+		// parses a value that was skipped over and puts it in the tree, returning nullptr if it was malformed
+		// (without exceptions).
+		TOML_NODISCARD
+		node* parse_skipped(value_key_set::entry& val)
+		{
+			TOML_ASSERT_ASSUME(!val.source.empty());
+
+			utf8_batch_reader reader{ source_path_ptr{ source_path_ } };
+			reader.set_batch(val.source);
+			parser value_parser{ reader };
+
+#if TOML_EXCEPTIONS
+			node_ptr nde;
+			try
 			{
-				if (prev == parse_type::val)
-				{
-					prev = parse_type::comma;
-					advance_and_return_if_error_or_eof({});
-					continue;
-				}
-				set_error_and_return_default("expected value or closing ']', saw comma"sv);
+				nde = value_parser.parse_deferred_value(val.position);
 			}
-
-			// closing ']'
-			else if (*cp == U']')
+			catch (const parse_error&)
 			{
-				advance_and_return_if_error({});
-				break;
+				failed_ = true;
+				throw;
+			}
+#else
+			node_ptr nde = value_parser.parse_deferred_value(val.position);
+			if (value_parser.failed())
+			{
+				if (!err_)
+					err_ = std::move(value_parser.error());
+				return nullptr;
 			}
+#endif
 
-			// must be a value
-			else
+			return &insert(val, std::move(nde));
+		}
+
+#if !TOML_EXCEPTIONS
+
+		// (see lazy_document::table())
+		void insert_default_value(value_key_set::entry& val)
+		{
+			node_ptr nde;
+			switch (val.type)
 			{
-				if (prev == parse_type::val)
+				case node_type::string: nde.reset(new value<std::string>{}); break;
+				case node_type::integer: nde.reset(new value<int64_t>{}); break;
+				case node_type::floating_point: nde.reset(new value<double>{}); break;
+				case node_type::boolean: nde.reset(new value<bool>{}); break;
+				case node_type::date: nde.reset(new value<toml::date>{}); break;
+				case node_type::time: nde.reset(new value<toml::time>{}); break;
+				case node_type::date_time: nde.reset(new value<toml::date_time>{}); break;
+				case node_type::array: nde.reset(new array{}); break;
+				case node_type::table:
 				{
-					set_error_and_return_default("expected comma or closing ']', saw '"sv, to_sv(*cp), "'"sv);
-					continue;
+					auto tbl = new table{};
+					tbl->is_inline(true);
+					nde.reset(tbl);
+					break;
 				}
-				prev = parse_type::val;
-
-				auto val = parse_value();
-				return_if_error({});
-
-				if (!arr.capacity())
-					arr.reserve(4u);
-				arr.emplace_back<node_ptr>(std::move(val));
+				default: TOML_UNREACHABLE;
 			}
+			static_cast<void>(insert(val, std::move(nde)));
 		}
 
-		return_if_error({});
-		return arr_ptr;
-	}
-
-	TOML_EXTERNAL_LINKAGE
-	node_ptr parser::parse_inline_table()
-	{
-		return_if_error({});
-		assert_not_eof();
-		TOML_ASSERT_ASSUME(*cp == U'{');
-		push_parse_scope("inline table"sv);
+#endif
 
-		// skip opening '{'
-		advance_and_return_if_error_or_eof({});
+		// the node at tbl[key], parsing it first if it was skipped over; nullptr if there isn't one
+		// (or it was malformed, without exceptions).
+		TOML_NODISCARD
+		node* find(table& tbl, std::string_view key)
+		{
+			if (const auto it = tbl.find(key); it != tbl.end())
+				return &it->second;
+			if (!remaining_)
+				return nullptr;
 
-		node_ptr tbl_ptr{ new table{} };
-		table& tbl = tbl_ptr->ref_cast<table>();
-		tbl.is_inline(true);
-		table_vector_scope table_scope{ open_inline_tables, tbl };
+			const auto val = values_.find(&tbl == &root_ ? nullptr : &tbl, key);
+			return val ? parse_skipped(*val) : nullptr;
+		}
 
-		enum class TOML_CLOSED_ENUM parse_type : int
+		// the tables at or beneath a node that values might have been skipped over in
+		static void collect_tables(node& nde, node_set<table>& tables)
 		{
-			none,
-			comma,
-			kvp
-		};
-		parse_type prev = parse_type::none;
-		while (!is_error())
-		{
-			if constexpr (TOML_LANG_UNRELEASED) // toml/issues/516 (newlines/trailing commas in inline tables)
+			// (anything that was parsed as a whole, e.g. inline tables, can't have had anything skipped)
+			if (auto tbl = nde.as_table(); tbl && !tbl->is_inline())
 			{
-				while (consume_leading_whitespace() || consume_line_break() || consume_comment())
-					continue;
-			}
-			else
-			{
-				while (consume_leading_whitespace())
-					continue;
+				tables.insert(tbl);
+				for (auto&& [k, v] : *tbl)
+					collect_tables(v, tables);
 			}
-			return_if_error({});
-			set_error_and_return_if_eof({});
-
-			// commas - only legal after a key-value pair
-			if (*cp == U',')
+			else if (auto arr = nde.as_array())
 			{
-				if (prev == parse_type::kvp)
+				for (auto&& elem : *arr)
 				{
-					prev = parse_type::comma;
-					advance_and_return_if_error_or_eof({});
+					if (auto elem_tbl = elem.as_table(); elem_tbl && !elem_tbl->is_inline())
+						collect_tables(*elem_tbl, tables);
 				}
-				else
-					set_error_and_return_default("expected key-value pair or closing '}', saw comma"sv);
 			}
+		}
 
-			// closing '}'
-			else if (*cp == U'}')
+		// node_views go straight to the tree, so nothing beneath the node they view can be left unparsed.
+		// (without exceptions, malformed values are skipped so everything else still gets parsed)
+		TOML_NODISCARD
+		bool resolve_all(node& nde)
+		{
+			if (!remaining_ || !(nde.is_table() || nde.is_array()))
+				return true;
+
+			node_set<table> tables{ buffer_allocator{} };
+			collect_tables(nde, tables);
+			if (tables.empty())
+				return true;
+
+			bool ok = true;
+			for (auto& val : values_)
 			{
-				if constexpr (!TOML_LANG_UNRELEASED) // toml/issues/516 (newlines/trailing commas in inline tables)
-				{
-					if (prev == parse_type::comma)
-					{
-						set_error_and_return_default("expected key-value pair, saw closing '}' (dangling comma)"sv);
-						continue;
-					}
-				}
-				advance_and_return_if_error({});
-				break;
+				if (!val.source.empty() && tables.contains(&parent_of(val)))
+					ok = parse_skipped(val) && ok;
 			}
+			return ok;
+		}
+
+	  public:
+		TOML_NODISCARD_CTOR
+		lazy_document_state(std::string_view doc, std::string_view source_path, bool borrow) //
+			: doc_{ borrow ? std::string_view{} : doc }
+		{
+			utf8_reader reader{ borrow ? doc : std::string_view{ doc_ }, source_path };
+			source_path_ = reader.source_path();
 
-			// key-value pair
-			else if (is_string_delimiter(*cp) || is_bare_key_character(*cp))
+			parse_result result = parser{ std::move(reader), nullptr, &values_ };
+#if TOML_EXCEPTIONS
+			root_ = std::move(result);
+#else
+			if (!result)
 			{
-				if (prev == parse_type::kvp)
-					set_error_and_return_default("expected comma or closing '}', saw '"sv, to_sv(*cp), "'"sv);
-				else
-				{
-					prev = parse_type::kvp;
-					parse_key_value_pair_and_insert(&tbl);
-				}
+				err_.emplace(std::move(result).error());
+				values_.clear();
+				return;
 			}
+			root_ = std::move(result).table();
+#endif
+			remaining_ = values_.size();
+		}
 
-			else
-				set_error_and_return_default("expected key or closing '}', saw '"sv, to_sv(*cp), "'"sv);
+		TOML_PURE_GETTER
+		bool failed() const noexcept
+		{
+#if TOML_EXCEPTIONS
+			return failed_;
+#else
+			return !!err_;
+#endif
 		}
 
-		return_if_error({});
-		return tbl_ptr;
-	}
+#if !TOML_EXCEPTIONS
 
-	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
-}
-TOML_IMPL_NAMESPACE_END;
+		TOML_PURE_GETTER
+		const parse_error& error() const noexcept
+		{
+			TOML_ASSERT_ASSUME(err_);
+			return *err_;
+		}
 
-#undef TOML_RETURNS_BY_THROWING
-#undef advance_and_return_if_error
-#undef advance_and_return_if_error_or_eof
-#undef assert_not_eof
-#undef assert_not_error
-#undef is_eof
-#undef is_error
-#undef parse_error_break
-#undef push_parse_scope
-#undef push_parse_scope_1
-#undef push_parse_scope_2
-#undef return_after_error
-#undef return_if_eof
-#undef return_if_error
-#undef return_if_error_or_eof
-#undef set_error_and_return
-#undef set_error_and_return_default
-#undef set_error_and_return_if_eof
-#undef utf8_buffered_reader_error_check
-#undef utf8_reader_error
-#undef utf8_reader_error_check
-#undef utf8_reader_return_after_error
+#endif
 
-TOML_ANON_NAMESPACE_START
-{
-	TOML_NODISCARD
-	TOML_INTERNAL_LINKAGE
-	parse_result do_parse(utf8_reader_interface && reader)
-	{
-		return impl::parser{ std::move(reader) };
-	}
+		TOML_NODISCARD
+		toml::table& get_all()
+		{
+			for (auto& val : values_)
+			{
+				if (!remaining_)
+					break;
+				if (val.source.empty())
+					continue;
 
-	TOML_NODISCARD
-	TOML_INTERNAL_LINKAGE
-	parse_result do_parse_file(std::string_view file_path)
-	{
 #if TOML_EXCEPTIONS
-#define TOML_PARSE_FILE_ERROR(msg, path)                                                                               \
-	throw parse_error(msg, source_position{}, std::make_shared<const std::string>(std::move(path)))
+				static_cast<void>(parse_skipped(val));
 #else
-#define TOML_PARSE_FILE_ERROR(msg, path)                                                                               \
-	return parse_result(parse_error(msg, source_position{}, std::make_shared<const std::string>(std::move(path))))
+				if (!parse_skipped(val))
+					insert_default_value(val);
 #endif
+			}
+			return root_;
+		}
 
-		std::string file_path_str(file_path);
+		TOML_NODISCARD
+		node* get(std::string_view key)
+		{
+			const auto val = find(root_, key);
+			return val && resolve_all(*val) ? val : nullptr;
+		}
 
-		// open file with a custom-sized stack buffer
-		std::ifstream file;
-		TOML_OVERALIGNED char file_buffer[sizeof(void*) * 1024u];
-		file.rdbuf()->pubsetbuf(file_buffer, sizeof(file_buffer));
-#if TOML_WINDOWS && !(defined(__MINGW32__) || defined(__MINGW64__))
-		file.open(impl::widen(file_path_str).c_str(), std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
-#else
-		file.open(file_path_str, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
-#endif
-		if (!file.is_open())
-			TOML_PARSE_FILE_ERROR("File could not be opened for reading", file_path_str);
+		// the node at the first `count` components of a path, parsing just what it has to along the way
+		TOML_NODISCARD
+		node* find(const toml::path& path, size_t count)
+		{
+			node* current = &root_;
+			for (size_t i = 0; i < count; i++)
+			{
+				const auto& component = path[i];
+				if (component.type() == path_component_type::key)
+				{
+					const auto tbl = current->as_table();
+					if (!tbl)
+						return nullptr;
 
-		// get size
-		const auto file_size = file.tellg();
-		if (file_size == -1)
-			TOML_PARSE_FILE_ERROR("Could not determine file size", file_path_str);
-		file.seekg(0, std::ifstream::beg);
+					current = find(*tbl, component.key());
+				}
+				else
+				{
+					// (arrays are either arrays-of-tables or have already been parsed in their entirety)
+					const auto arr = current->as_array();
+					current		   = arr ? arr->get(component.index()) : nullptr;
+				}
 
-		// read the whole file into memory first if the file isn't too large
-		constexpr auto large_file_threshold = 1024 * 1024 * 2; // 2 MB
-		if (file_size <= large_file_threshold)
+				if (!current)
+					return nullptr;
+			}
+			return current;
+		}
+
+		TOML_NODISCARD
+		node* get(const toml::path& path)
 		{
-			std::vector<char> file_data;
-			file_data.resize(static_cast<size_t>(file_size));
-			file.read(file_data.data(), static_cast<std::streamsize>(file_size));
-			return parse(std::string_view{ file_data.data(), file_data.size() }, std::move(file_path_str));
+			const auto nde = find(path, path.size());
+			return nde && resolve_all(*nde) ? nde : nullptr;
 		}
 
-		// otherwise parse it using the streams
-		else
-			return parse(file, std::move(file_path_str));
+		// the string at a path, viewed straight from the document if it was skipped over and doesn't need parsing
+		// (see plain_string_contents()); nullopt if there isn't a string there (or it was malformed).
+		TOML_NODISCARD
+		optional<std::string_view> get_string(const toml::path& path)
+		{
+			node* nde = nullptr;
+			if (!path.empty() && path[path.size() - 1u].type() == path_component_type::key)
+			{
+				const auto parent = find(path, path.size() - 1u);
+				const auto tbl	  = parent ? parent->as_table() : nullptr;
+				if (!tbl)
+					return {};
 
-#undef TOML_PARSE_FILE_ERROR
-	}
+				const auto& key = path[path.size() - 1u].key();
+				if (const auto val = remaining_ ? values_.find(tbl == &root_ ? nullptr : tbl, key) : nullptr;
+					val && !val->source.empty())
+				{
+					if (val->type != node_type::string)
+						return {};
+					if (const auto str = plain_string_contents(val->source))
+						return str;
+				}
+				nde = find(*tbl, key);
+			}
+			else
+				nde = find(path, path.size());
+
+			if (const auto str = nde ? nde->as_string() : nullptr)
+				return std::string_view{ str->get() };
+			return {};
+		}
+	};
+
+	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
 }
-TOML_ANON_NAMESPACE_END;
+TOML_IMPL_NAMESPACE_END;
 
 TOML_NAMESPACE_START
 {
@@ -16438,6 +23987,88 @@ TOML_NAMESPACE_START
 		return TOML_ANON_NAMESPACE::do_parse_file(file_path);
 	}
 
+	TOML_EXTERNAL_LINKAGE
+	TOML_ANON_NAMESPACE::sax_parse_result TOML_CALLCONV parse(std::string_view doc,
+															   sax_handler & handler,
+															   std::string_view source_path)
+	{
+		return TOML_ANON_NAMESPACE::do_parse(TOML_ANON_NAMESPACE::utf8_reader{ doc, source_path }, handler);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	TOML_ANON_NAMESPACE::sax_parse_result TOML_CALLCONV parse(std::istream & doc,
+															   sax_handler & handler,
+															   std::string_view source_path)
+	{
+		return TOML_ANON_NAMESPACE::do_parse(TOML_ANON_NAMESPACE::utf8_reader{ doc, source_path }, handler);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	TOML_ANON_NAMESPACE::sax_parse_result TOML_CALLCONV parse_file(std::string_view file_path, sax_handler & handler)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_file(file_path, handler);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	parse_result TOML_CALLCONV parse(std::string_view doc, const parse_options& options, std::string_view source_path)
+	{
+#if TOML_ENABLE_THREADS
+		if (options.threads != 1u && options.keep_paths.empty())
+		{
+			if (auto tbl = TOML_ANON_NAMESPACE::parse_in_parallel(doc, source_path, options))
+				return parse_result{ std::move(*tbl) };
+		}
+#endif
+
+		return TOML_ANON_NAMESPACE::do_parse(TOML_ANON_NAMESPACE::utf8_reader{ doc, source_path }, options);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	parse_result TOML_CALLCONV parse(std::istream & doc, const parse_options& options, std::string_view source_path)
+	{
+		return TOML_ANON_NAMESPACE::do_parse(TOML_ANON_NAMESPACE::utf8_reader{ doc, source_path }, options);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	parse_result TOML_CALLCONV parse_file(std::string_view file_path, const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_file(file_path, options);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::string_view* first,
+													   const std::string_view* last,
+													   const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_many(first, static_cast<size_t>(last - first), options, nullptr);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	std::vector<parse_result> TOML_CALLCONV parse_many(const std::string_view* first,
+													   const std::string_view* last,
+													   std::vector<optional<parse_error>>& errors,
+													   const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_many(first, static_cast<size_t>(last - first), options, &errors);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::string_view* first,
+														const std::string_view* last,
+														const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_files(first, static_cast<size_t>(last - first), options, nullptr);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	std::vector<parse_result> TOML_CALLCONV parse_files(const std::string_view* first,
+														const std::string_view* last,
+														std::vector<optional<parse_error>>& errors,
+														const parse_options& options)
+	{
+		return TOML_ANON_NAMESPACE::do_parse_files(first, static_cast<size_t>(last - first), options, &errors);
+	}
+
 #if TOML_HAS_CHAR8
 
 	TOML_EXTERNAL_LINKAGE
@@ -16495,6 +24126,128 @@ TOML_NAMESPACE_START
 
 #endif // TOML_HAS_CHAR8 && TOML_ENABLE_WINDOWS_COMPAT
 
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser::incremental_parser(std::string_view source_path) //
+		: state_{ std::make_unique<impl::incremental_parser_state>(
+			source_path.empty() ? source_path_ptr{} : source_path_ptr{ source_path }) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser::incremental_parser(std::string && source_path) //
+		: state_{ std::make_unique<impl::incremental_parser_state>(
+			source_path.empty() ? source_path_ptr{} : source_path_ptr{ std::move(source_path) }) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser::incremental_parser(incremental_parser && other) noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser& incremental_parser::operator=(incremental_parser&& rhs) noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	incremental_parser::~incremental_parser() noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	void incremental_parser::feed(std::string_view chunk)
+	{
+		TOML_ASSERT_ASSUME(state_);
+		state_->feed(chunk);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	bool incremental_parser::failed() const noexcept
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->failed();
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	parse_result incremental_parser::finish()
+	{
+		TOML_ASSERT_ASSUME(state_);
+
+		// swap in a fresh state up-front so the parser is reset even if this throws
+		auto state = std::exchange(state_, std::make_unique<impl::incremental_parser_state>(state_->source_path()));
+		return state->finish();
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document::lazy_document(std::string_view doc, std::string_view source_path) //
+		: state_{ std::make_unique<impl::lazy_document_state>(doc, source_path, false) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document::lazy_document(borrow_document_t, std::string_view doc, std::string_view source_path) //
+		: state_{ std::make_unique<impl::lazy_document_state>(doc, source_path, true) }
+	{}
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document::lazy_document(lazy_document && other) noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document& lazy_document::operator=(lazy_document&& rhs) noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	lazy_document::~lazy_document() noexcept = default;
+
+	TOML_EXTERNAL_LINKAGE
+	bool lazy_document::failed() const noexcept
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->failed();
+	}
+
+#if !TOML_EXCEPTIONS
+
+	TOML_EXTERNAL_LINKAGE
+	const parse_error& lazy_document::error() const noexcept
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->error();
+	}
+
+#endif
+
+	TOML_EXTERNAL_LINKAGE
+	node_view<node> lazy_document::operator[](std::string_view key)
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return node_view<node>{ state_->get(key) };
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	node_view<node> lazy_document::at_path(std::string_view path)
+	{
+		return at_path(toml::path{ path });
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	node_view<node> lazy_document::at_path(const toml::path& path)
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return node_view<node>{ state_->get(path) };
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	optional<std::string_view> lazy_document::string_at(std::string_view path)
+	{
+		return string_at(toml::path{ path });
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	optional<std::string_view> lazy_document::string_at(const toml::path& path)
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->get_string(path);
+	}
+
+	TOML_EXTERNAL_LINKAGE
+	toml::table& lazy_document::table()
+	{
+		TOML_ASSERT_ASSUME(state_);
+		return state_->get_all();
+	}
+
 	TOML_ABI_NAMESPACE_END; // TOML_EXCEPTIONS
 }
 TOML_NAMESPACE_END;
@@ -17813,6 +25566,8 @@ TOML_POP_WARNINGS;
 #undef TOML_HAS_CUSTOM_OPTIONAL_TYPE
 #undef TOML_HAS_FEATURE
 #undef TOML_HAS_INCLUDE
+#undef TOML_HAS_MEMORY_RESOURCE
+#undef TOML_HAS_SIMD_DISPATCH
 #undef TOML_HAS_SSE2
 #undef TOML_HAS_SSE4_1
 #undef TOML_HIDDEN_CONSTRAINT
@@ -213,9 +213,13 @@ def main():
 				r'TOML_CONCAT_1',
 				r'TOML_CONFIG_HEADER',
 				r'TOML_CUDA',
+				r'TOML_ENABLE_ARENA',
 				r'TOML_ENABLE_FORMATTERS',
+				r'TOML_ENABLE_MMAP',
 				r'TOML_ENABLE_PARSER',
 				r'TOML_ENABLE_SIMD',
+				r'TOML_ENABLE_SOURCES',
+				r'TOML_ENABLE_THREADS',
 				r'TOML_ENABLE_UNRELEASED_FEATURES',
 				r'TOML_ENABLE_WINDOWS_COMPAT',
 				r'TOML_ENABLE_FLOAT16',
@@ -224,6 +228,7 @@ def main():
 				r'TOML_EXPORTED_FREE_FUNCTION',
 				r'TOML_EXPORTED_MEMBER_FUNCTION',
 				r'TOML_EXPORTED_STATIC_FUNCTION',
+				r'TOML_FLAT_TABLES',
 				r'TOML_HEADER_ONLY',
 				r'TOML_LANG_MAJOR',
 				r'TOML_LANG_MINOR',
@@ -236,9 +241,11 @@ def main():
 				r'TOML_MAX_DOTTED_KEYS_DEPTH',
 				r'TOML_NAMESPACE_END',
 				r'TOML_NAMESPACE_START',
+				r'TOML_PARALLEL_PARSE_MIN_BYTES',
 				r'TOML_OPTIONAL_TYPE',
 				r'TOML_SMALL_FLOAT_TYPE',
 				r'TOML_SMALL_INT_TYPE',
+				r'TOML_TABLE_INDEX_MIN_KEYS',
 				r'TOML_UNDEF_MACROS',
 				r'TOMLPLUSPLUS_H',
 				r'TOMLPLUSPLUS_HPP',